@@ -11,6 +11,7 @@
 #include "audio/ChannelCPUMonitor.h"
 #include <cstring>
 #include <algorithm>
+#include <iterator>
 
 namespace Console {
 
@@ -40,8 +41,6 @@ ConsoleChannelDSP::ConsoleChannelDSP()
     , solo_(false)
     , compEnvelope_(1.0f)
     , limiterEnvelope_(1.0f)
-    , outputLevelL_(0.0f)
-    , outputLevelR_(0.0f)
     , gainReduction_(0.0f)
     , paramSmoothing_(0.999f)
     , meterDecay_(0.999f)
@@ -51,6 +50,9 @@ ConsoleChannelDSP::ConsoleChannelDSP()
 {
     // Initialize channel state
     channelState_.forceActive = solo_;  // Solo forces channel active
+
+    std::fill(std::begin(outputLevels_), std::end(outputLevels_), 0.0f);
+    updatePanGains();
 }
 
 //==============================================================================
@@ -62,10 +64,8 @@ void ConsoleChannelDSP::setChannelId(int channelId) {
 // Destructor
 ConsoleChannelDSP::~ConsoleChannelDSP() {
     // Clean up pre-allocated buffers
-    delete[] tempBufferLeft_;
-    delete[] tempBufferRight_;
-    tempBufferLeft_ = nullptr;
-    tempBufferRight_ = nullptr;
+    delete[] tempBuffer_;
+    tempBuffer_ = nullptr;
 }
 
 //==============================================================================
@@ -79,10 +79,8 @@ bool ConsoleChannelDSP::prepare(double sampleRate, int blockSize) {
 
     // Allocate or reallocate temp buffers if needed (no heap alloc in process!)
     if (tempBufferSize_ < blockSize) {
-        delete[] tempBufferLeft_;
-        delete[] tempBufferRight_;
-        tempBufferLeft_ = new float[blockSize];
-        tempBufferRight_ = new float[blockSize];
+        delete[] tempBuffer_;
+        tempBuffer_ = new float[static_cast<size_t>(maxChannels) * blockSize];
         tempBufferSize_ = blockSize;
     }
 
@@ -102,8 +100,7 @@ void ConsoleChannelDSP::reset() {
     // Reset all state to defaults
     compEnvelope_ = 1.0f;
     limiterEnvelope_ = 1.0f;
-    outputLevelL_ = 0.0f;
-    outputLevelR_ = 0.0f;
+    std::fill(std::begin(outputLevels_), std::end(outputLevels_), 0.0f);
     gainReduction_ = 0.0f;
 
     // Reset silence detection
@@ -115,13 +112,21 @@ void ConsoleChannelDSP::reset() {
     compControlCounter_ = 0;
 }
 
+//==============================================================================
+void ConsoleChannelDSP::setChannelLayout(const DSP::ChannelLayout& layout) {
+    layout_ = layout;
+    updatePanGains();
+}
+
 //==============================================================================
 void ConsoleChannelDSP::process(float** inputs, float** outputs,
                                  int numChannels, int numSamples) {
-    if (numSamples <= 0 || numChannels < 2) {
+    if (numSamples <= 0 || numChannels < 1) {
         return;
     }
 
+    numChannels = std::min(numChannels, maxChannels);
+
     //==========================================================================
     // TASK 5: CPU Monitoring (begin)
     //==========================================================================
@@ -152,12 +157,12 @@ void ConsoleChannelDSP::process(float** inputs, float** outputs,
     // Early exit if channel is idle (entire channel bypass)
     if (channelIdle) {
         // Clear outputs
-        std::memset(outputs[0], 0, numSamples * sizeof(float));
-        std::memset(outputs[1], 0, numSamples * sizeof(float));
+        for (int ch = 0; ch < numChannels; ++ch) {
+            std::memset(outputs[ch], 0, numSamples * sizeof(float));
+        }
 
         // Reset meters to indicate silence
-        outputLevelL_ = silenceThreshold_;
-        outputLevelR_ = silenceThreshold_;
+        std::fill(outputLevels_, outputLevels_ + numChannels, silenceThreshold_);
 
         //==========================================================================
         // TASK 5: CPU Monitoring (idle case - still process samples)
@@ -179,29 +184,26 @@ void ConsoleChannelDSP::process(float** inputs, float** outputs,
     // Normal Channel Processing (active channel)
     //==========================================================================
 
-    // Get channel pointers
-    float* leftIn = inputs[0];
-    float* rightIn = inputs[1];
-    float* leftOut = outputs[0];
-    float* rightOut = outputs[1];
-
     // Process in-place if input == output
-    bool isInPlace = (leftIn == leftOut) && (rightIn == rightOut);
+    bool isInPlace = true;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        isInPlace = isInPlace && (inputs[ch] == outputs[ch]);
+    }
 
     // Use pre-allocated buffers (no heap alloc in audio thread!)
-    float* processLeft = isInPlace ? leftOut : tempBufferLeft_;
-    float* processRight = isInPlace ? rightOut : tempBufferRight_;
+    float* process[maxChannels];
+    for (int ch = 0; ch < numChannels; ++ch) {
+        process[ch] = isInPlace ? outputs[ch] : tempBuffer_ + static_cast<size_t>(ch) * tempBufferSize_;
 
-    // Copy input if not in-place
-    if (!isInPlace) {
-        std::memcpy(processLeft, leftIn, numSamples * sizeof(float));
-        std::memcpy(processRight, rightIn, numSamples * sizeof(float));
-    }
+        // Copy input if not in-place
+        if (!isInPlace) {
+            std::memcpy(process[ch], inputs[ch], numSamples * sizeof(float));
+        }
 
-    // Mute handling
-    if (mute_) {
-        std::memset(processLeft, 0, numSamples * sizeof(float));
-        std::memset(processRight, 0, numSamples * sizeof(float));
+        // Mute handling
+        if (mute_) {
+            std::memset(process[ch], 0, numSamples * sizeof(float));
+        }
     }
 
     // Signal flow:
@@ -216,56 +218,60 @@ void ConsoleChannelDSP::process(float** inputs, float** outputs,
     // 9. Output trim
     // 10. Metering
 
-    for (int i = 0; i < numSamples; ++i) {
-        // Input trim
-        float sampleL = processLeft[i] * inputTrim_;
-        float sampleR = processRight[i] * inputTrim_;
-
-        // Density (Tier 1 optional saturation)
-        if (densityAmount_ > 0.0f) {
-            applyDensity(sampleL);
-            applyDensity(sampleR);
-        }
+    // Saturation stages have no cross-channel state, so each channel runs
+    // as its own pass
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* samples = process[ch];
 
-        // Drive (Tier 1 optional saturation)
-        if (driveAmount_ > 0.0f) {
-            applyDrive(sampleL);
-            applyDrive(sampleR);
-        }
+        for (int i = 0; i < numSamples; ++i) {
+            // Input trim
+            float sample = samples[i] * inputTrim_;
+
+            // Density (Tier 1 optional saturation)
+            if (densityAmount_ > 0.0f) {
+                applyDensity(sample);
+            }
+
+            // Drive (Tier 1 optional saturation)
+            if (driveAmount_ > 0.0f) {
+                applyDrive(sample);
+            }
 
-        // Console DSP (Tier 0 - always on)
-        applyConsoleSaturation(sampleL);
-        applyConsoleSaturation(sampleR);
+            // Console DSP (Tier 0 - always on)
+            applyConsoleSaturation(sample);
 
-        processLeft[i] = sampleL;
-        processRight[i] = sampleR;
+            samples[i] = sample;
+        }
     }
 
     // EQ (per-sample not implemented here, would need filter state)
-    processEQ(processLeft, processRight, numSamples);
+    processEQ(process, numChannels, numSamples);
 
-    // Compressor
-    processCompressor(processLeft, processRight, numSamples);
+    // Compressor (linked across every channel of the layout)
+    processCompressor(process, numChannels, numSamples);
 
     // Limiter
-    processLimiter(processLeft, processRight, numSamples);
+    processLimiter(process, numChannels, numSamples);
 
     // Pan
-    processPan(processLeft, processRight, numSamples);
+    processPan(process, numChannels, numSamples);
 
     // Output trim
-    for (int i = 0; i < numSamples; ++i) {
-        processLeft[i] *= outputTrim_;
-        processRight[i] *= outputTrim_;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* samples = process[ch];
+        for (int i = 0; i < numSamples; ++i) {
+            samples[i] *= outputTrim_;
+        }
     }
 
     // Update meters
-    updateMeters(processLeft, processRight, numSamples);
+    updateMeters(process, numChannels, numSamples);
 
     // Copy to output if not in-place
     if (!isInPlace) {
-        std::memcpy(leftOut, processLeft, numSamples * sizeof(float));
-        std::memcpy(rightOut, processRight, numSamples * sizeof(float));
+        for (int ch = 0; ch < numChannels; ++ch) {
+            std::memcpy(outputs[ch], process[ch], numSamples * sizeof(float));
+        }
     }
 
     //==========================================================================
@@ -431,7 +437,10 @@ bool ConsoleChannelDSP::loadPreset(const char* jsonData) {
 
 //==============================================================================
 float ConsoleChannelDSP::getOutputLevel(int channel) const {
-    return (channel == 0) ? outputLevelL_ : outputLevelR_;
+    if (channel < 0 || channel >= maxChannels) {
+        return silenceThreshold_;
+    }
+    return outputLevels_[channel];
 }
 
 //==============================================================================
@@ -502,17 +511,21 @@ void ConsoleChannelDSP::applyDrive(float& sample) {
     }
 }
 
-void ConsoleChannelDSP::processEQ(float* left, float* right, int numSamples) {
+void ConsoleChannelDSP::processEQ(float* const* channels, int numChannels, int numSamples) {
     // Simplified EQ (bypass for now - full implementation would need filter state)
     // In production, implement biquad filters for low/mid/high bands
     // For now, just apply gain
-    for (int i = 0; i < numSamples; ++i) {
-        left[i] *= eqLowGain_ * eqMidGain_ * eqHighGain_;
-        right[i] *= eqLowGain_ * eqMidGain_ * eqHighGain_;
+    const float gain = eqLowGain_ * eqMidGain_ * eqHighGain_;
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* samples = channels[ch];
+        for (int i = 0; i < numSamples; ++i) {
+            samples[i] *= gain;
+        }
     }
 }
 
-void ConsoleChannelDSP::processCompressor(float* left, float* right, int numSamples) {
+void ConsoleChannelDSP::processCompressor(float* const* channels, int numChannels, int numSamples) {
     //==========================================================================
     // TASK 3: Control-Rate Compressor Optimization
     // Update gain reduction at control rate, not per sample
@@ -520,16 +533,21 @@ void ConsoleChannelDSP::processCompressor(float* left, float* right, int numSamp
 
     float slope = 1.0f / compRatio_;
     float targetGain = 1.0f;
+    const int lfeChannel = layout_.getLFEChannel();
 
     for (int i = 0; i < numSamples; ++i) {
         //======================================================================
         // Control-rate envelope detection (every 32 samples)
         //======================================================================
         if (++compControlCounter_ >= compControlInterval) {
-            // Measure input level (peak detection)
-            float inputL = std::abs(left[i]);
-            float inputR = std::abs(right[i]);
-            float inputLevel = std::max(inputL, inputR);
+            // Measure input level (peak detection, linked across channels;
+            // the LFE does not key the detector)
+            float inputLevel = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch) {
+                if (ch != lfeChannel) {
+                    inputLevel = std::max(inputLevel, std::abs(channels[ch][i]));
+                }
+            }
 
             // Calculate target gain reduction
             if (inputLevel > compThreshold_) {
@@ -554,8 +572,9 @@ void ConsoleChannelDSP::processCompressor(float* left, float* right, int numSamp
         compGainSmoother_ = compGainSmoother_ * (1.0f - alpha) + targetGain * alpha;
 
         // Apply smoothed gain
-        left[i] *= compGainSmoother_;
-        right[i] *= compGainSmoother_;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            channels[ch][i] *= compGainSmoother_;
+        }
     }
 
     //==========================================================================
@@ -577,45 +596,74 @@ void ConsoleChannelDSP::processCompressor(float* left, float* right, int numSamp
     //==========================================================================
 }
 
-void ConsoleChannelDSP::processLimiter(float* left, float* right, int numSamples) {
+void ConsoleChannelDSP::processLimiter(float* const* channels, int numChannels, int numSamples) {
     // Brickwall limiter
-    for (int i = 0; i < numSamples; ++i) {
-        left[i] = std::clamp(left[i], -limiterThreshold_, limiterThreshold_);
-        right[i] = std::clamp(right[i], -limiterThreshold_, limiterThreshold_);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* samples = channels[ch];
+        for (int i = 0; i < numSamples; ++i) {
+            samples[i] = std::clamp(samples[i], -limiterThreshold_, limiterThreshold_);
+        }
     }
 }
 
-void ConsoleChannelDSP::processPan(float* left, float* right, int numSamples) {
+void ConsoleChannelDSP::updatePanGains() {
     // Constant-power panning
     float angle = (pan_ + 1.0f) * 0.25f * 3.14159f;  // -1..1 maps to 0..pi/2
     float gainL = std::cos(angle);
     float gainR = std::sin(angle);
+    float gainCentre = std::cos(0.25f * 3.14159f);
 
-    for (int i = 0; i < numSamples; ++i) {
-        float mid = (left[i] + right[i]) * 0.5f;
-        float side = (left[i] - right[i]) * 0.5f;
+    for (int ch = 0; ch < maxChannels; ++ch) {
+        float gain = 1.0f;
+
+        if (layout_.isSpeakerLayout() && ch < layout_.getNumChannels() && layout_.getNumChannels() > 1) {
+            // Balance by side: azimuth is positive to the left
+            const auto& speaker = layout_.getSpeaker(ch);
+            const float side = std::sin(speaker.azimuth * 3.14159f / 180.0f);
+
+            if (speaker.isLFE || std::abs(side) < 0.01f) {
+                gain = gainCentre;
+            } else {
+                gain = side > 0.0f ? gainL : gainR;
+            }
+        }
 
-        left[i] = mid * gainL + side * gainL;
-        right[i] = mid * gainR - side * gainR;
+        panGains_[ch] = gain;
     }
+
+    lastPan_ = pan_;
 }
 
-void ConsoleChannelDSP::updateMeters(float* left, float* right, int numSamples) {
-    float peakL = 0.0f;
-    float peakR = 0.0f;
+void ConsoleChannelDSP::processPan(float* const* channels, int numChannels, int numSamples) {
+    if (pan_ != lastPan_) {
+        updatePanGains();
+    }
 
-    for (int i = 0; i < numSamples; ++i) {
-        peakL = std::max(peakL, std::abs(left[i]));
-        peakR = std::max(peakR, std::abs(right[i]));
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const float gain = panGains_[ch];
+        if (gain == 1.0f) {
+            continue;
+        }
+
+        float* samples = channels[ch];
+        for (int i = 0; i < numSamples; ++i) {
+            samples[i] *= gain;
+        }
     }
+}
+
+void ConsoleChannelDSP::updateMeters(float* const* channels, int numChannels, int numSamples) {
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float peak = 0.0f;
+        float sumOfSquares = 0.0f;
+        DSP::LayoutMeter::measure(channels[ch], numSamples, peak, sumOfSquares);
 
-    // Convert to dBFS
-    peakL = linearToDb(peakL);
-    peakR = linearToDb(peakR);
+        // Convert to dBFS
+        peak = linearToDb(peak);
 
-    // Decay
-    outputLevelL_ = outputLevelL_ * meterDecay_ + peakL * (1.0f - meterDecay_);
-    outputLevelR_ = outputLevelR_ * meterDecay_ + peakR * (1.0f - meterDecay_);
+        // Decay
+        outputLevels_[ch] = outputLevels_[ch] * meterDecay_ + peak * (1.0f - meterDecay_);
+    }
 }
 
 //==============================================================================
@@ -665,20 +713,14 @@ float ConsoleChannelDSP::measureInputEnergy(float** inputs, int numChannels, int
     // Reset meter
     inputMeter_.reset();
 
-    // Measure energy across all channels (stereo for now)
-    float* left = inputs[0];
-    float* right = inputs[1];
-
     // Sample the buffer (don't need every sample for energy measurement)
     int stride = std::max(1, numSamples / 32);  // Control-rate sampling
 
+    // Measure energy across all channels
     for (int i = 0; i < numSamples; i += stride) {
-        float sampleL = left[i];
-        float sampleR = right[i];
-
-        // Process both channels
-        inputMeter_.processSample(sampleL);
-        inputMeter_.processSample(sampleR);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            inputMeter_.processSample(inputs[ch][i]);
+        }
     }
 
     return inputMeter_.getLeveldB();
@@ -57,6 +57,7 @@
 #ifndef CONSOLE_CHANNEL_DSP_H_INCLUDED
 #define CONSOLE_CHANNEL_DSP_H_INCLUDED
 
+#include "dsp/ChannelLayout.h"
 #include <cstdint>
 #include <cmath>
 
@@ -79,7 +80,7 @@ namespace Console {
  * Per-Channel Processing:
  *   - Gain staging (input/output trim)
  *   - Console saturation (nonlinear summing)
- *   - Pan (stereo positioning)
+ *   - Pan (stereo pan, balance across surround layouts)
  *   - EQ (3-band: low, mid, high)
  *   - Dynamics (compressor, limiter)
  *   - Metering (level detection)
@@ -116,6 +117,18 @@ public:
      */
     bool prepare(double sampleRate, int blockSize);
 
+    /**
+     * @brief Set the channel layout the strip processes
+     *
+     * Pan acts as a balance on speaker layouts: left speakers follow the
+     * left gain, right speakers the right gain, and speakers on the centre
+     * line (C, LFE, rear centre) hold the centre gain. Ambisonic and
+     * discrete layouts are not panned. Default is stereo.
+     * Must NOT be called from audio thread.
+     */
+    void setChannelLayout(const DSP::ChannelLayout& layout);
+    const DSP::ChannelLayout& getChannelLayout() const { return layout_; }
+
     /**
      * @brief Reset all console state
      *
@@ -132,7 +145,8 @@ public:
      *
      * @param inputs Input buffers [numChannels][numSamples]
      * @param outputs Output buffers [numChannels][numSamples]
-     * @param numChannels Number of channels (typically 2 for stereo)
+     * @param numChannels Number of channels (1 to DSP::ChannelLayout::maxChannels;
+     *                    normally the layout's channel count)
      * @param numSamples Number of samples in this buffer
      *
      * Thread safety: Called from audio thread only.
@@ -212,7 +226,7 @@ public:
      *
      * Returns peak level in dBFS (after output trim).
      *
-     * @param channel Channel index (0 = left, 1 = right)
+     * @param channel Channel index in the layout (0 = left, 1 = right)
      * @return Peak level in dBFS (negative values)
      */
     float getOutputLevel(int channel) const;
@@ -261,9 +275,14 @@ private:
     // Channel state
     ChannelState channelState_;
 
-    // Pre-allocated buffers (no heap alloc in process())
-    float* tempBufferLeft_ = nullptr;
-    float* tempBufferRight_ = nullptr;
+    // Channel layout (pan gains follow it)
+    static constexpr int maxChannels = DSP::ChannelLayout::maxChannels;
+    DSP::ChannelLayout layout_;
+    float panGains_[maxChannels];
+    float lastPan_ = 2.0f;   // Pan the gains were computed for (out of range: stale)
+
+    // Pre-allocated buffers (no heap alloc in process()), one per channel
+    float* tempBuffer_ = nullptr;
     int tempBufferSize_ = 0;
 
     // Parameters (smoothed)
@@ -299,8 +318,7 @@ private:
     // DSP state (not smoothed, real-time variables)
     float compEnvelope_;     // Compressor envelope follower
     float limiterEnvelope_;  // Limiter envelope follower
-    float outputLevelL_;     // Left channel peak meter
-    float outputLevelR_;     // Right channel peak meter
+    float outputLevels_[maxChannels];  // Per-channel peak meters
     float gainReduction_;    // Current GR in dB
 
     // Task 3: Control-rate compressor optimization
@@ -319,12 +337,12 @@ private:
     // Helper methods
     float dbToLinear(float db) const;
     float linearToDb(float linear) const;
-    void processConsole(float* left, float* right, int numSamples);
-    void processEQ(float* left, float* right, int numSamples);
-    void processCompressor(float* left, float* right, int numSamples);
-    void processLimiter(float* left, float* right, int numSamples);
-    void processPan(float* left, float* right, int numSamples);
-    void updateMeters(float* left, float* right, int numSamples);
+    void processEQ(float* const* channels, int numChannels, int numSamples);
+    void processCompressor(float* const* channels, int numChannels, int numSamples);
+    void processLimiter(float* const* channels, int numChannels, int numSamples);
+    void processPan(float* const* channels, int numChannels, int numSamples);
+    void updatePanGains();
+    void updateMeters(float* const* channels, int numChannels, int numSamples);
 
     // Silence / Idle detection (Task 1)
     bool isChannelIdle(float** inputs, int numChannels, int numSamples);
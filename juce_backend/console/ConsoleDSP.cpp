@@ -8,7 +8,7 @@ namespace dynamics {
 //==============================================================================
 
 EnvelopeFollower::EnvelopeFollower() {
-    historyBuffer.resize(historySize);
+    detector.prepare(historySize);
     smoothedEnvelope.reset(44100.0, 0.01f);
     smoothedPeak.reset(44100.0, 0.01f);
 }
@@ -16,6 +16,7 @@ EnvelopeFollower::EnvelopeFollower() {
 void EnvelopeFollower::configure(const EnvelopeConfig& newConfig) {
     config = newConfig;
     updateRates();
+    updateDetector();
 }
 
 void EnvelopeFollower::reset() {
@@ -28,12 +29,14 @@ void EnvelopeFollower::reset() {
     smoothedEnvelope.setCurrentAndTargetValue(0.0f);
     smoothedPeak.setCurrentAndTargetValue(0.0f);
 
-    std::fill(historyBuffer.begin(), historyBuffer.end(), 0.0f);
+    detector.reset();
+    previousInput = 0.0f;
 }
 
 void EnvelopeFollower::prepareToPlay(double newSampleRate, int samplesPerBlock) {
     sampleRate = newSampleRate;
     updateRates();
+    updateDetector();
 
     smoothedEnvelope.reset(sampleRate, config.smoothingTime * 0.001f);
     smoothedPeak.reset(sampleRate, config.smoothingTime * 0.001f);
@@ -42,11 +45,21 @@ void EnvelopeFollower::prepareToPlay(double newSampleRate, int samplesPerBlock)
 float EnvelopeFollower::processSample(float input) noexcept {
     float processedInput = input * preGain;
 
-    // Update history buffer
-    historyBuffer.push_back(processedInput);
+    // Detect level over the last millisecond in O(1): the sliding window
+    // keeps squared samples, so Peak/TruePeak and RMS only need a sqrt here
+    float squared = processedInput * processedInput;
+    if (config.mode == DetectionMode::TruePeak) {
+        const float midpoint = (processedInput + previousInput) * 0.5f;
+        squared = std::max(squared, midpoint * midpoint);
+    }
+    previousInput = processedInput;
 
-    // Detect level based on mode
-    float detectedLevel = detectLevel(historyBuffer.data(), std::min(historySize, static_cast<int>(sampleRate * 0.001f)));
+    float detectedLevel = std::sqrt(detector.process(squared));
+    if (config.mode == DetectionMode::LUFS) {
+        detectedLevel = juce::Decibels::gainToDecibels(detectedLevel * 0.891f) * 0.1f + 1.0f;
+    } else if (config.mode == DetectionMode::Custom) {
+        detectedLevel = 0.0f;
+    }
 
     // Apply post gain
     detectedLevel *= postGain;
@@ -106,6 +119,12 @@ void EnvelopeFollower::setHoldTime(float holdMs) {
     config.holdTime = holdMs;
 }
 
+void EnvelopeFollower::updateDetector() {
+    const bool peakMode = (config.mode == DetectionMode::Peak || config.mode == DetectionMode::TruePeak);
+    detector.setMode(peakMode ? SlidingWindowDetector::Mode::Peak : SlidingWindowDetector::Mode::RMS);
+    detector.setWindowLength(std::min(historySize, std::max(1, static_cast<int>(sampleRate * 0.001f))));
+}
+
 void EnvelopeFollower::updateRates() {
     attackRate = std::exp(-1.0 / (sampleRate * config.attackTime * 0.001));
     releaseRate = std::exp(-1.0 / (sampleRate * config.releaseTime * 0.001));
@@ -128,53 +147,6 @@ void EnvelopeFollower::updatePeakAndRMS(const float* samples, int numSamples) {
     smoothedPeak.setCurrentAndTargetValue(currentPeak);
 }
 
-float EnvelopeFollower::detectLevel(const float* samples, int numSamples) {
-    switch (config.mode) {
-        case DetectionMode::Peak: {
-            float peak = 0.0f;
-            for (int i = 0; i < numSamples; ++i) {
-                peak = std::max(peak, std::abs(samples[i]));
-            }
-            return peak;
-        }
-
-        case DetectionMode::RMS: {
-            float sum = 0.0f;
-            for (int i = 0; i < numSamples; ++i) {
-                float sample = samples[i];
-                sum += sample * sample;
-            }
-            return std::sqrt(sum / numSamples);
-        }
-
-        case DetectionMode::TruePeak: {
-            // Oversample for true peak detection
-            float peak = 0.0f;
-            for (int i = 0; i < numSamples - 1; ++i) {
-                float interpolated1 = (samples[i] + samples[i + 1]) * 0.5f;
-                peak = std::max(peak, std::max(std::abs(samples[i]), std::abs(interpolated1)));
-            }
-            return peak;
-        }
-
-        case DetectionMode::LUFS: {
-            // Simplified LUFS calculation
-            float sum = 0.0f;
-            for (int i = 0; i < numSamples; ++i) {
-                float sample = samples[i];
-                // Apply K-weighting filter (simplified)
-                float filtered = sample;
-                sum += filtered * filtered;
-            }
-            float rms = std::sqrt(sum / numSamples);
-            return juce::Decibels::gainToDecibels(rms * 0.891f) * 0.1f + 1.0f;
-        }
-
-        default:
-            return 0.0f;
-    }
-}
-
 //==============================================================================
 // DynamicsProcessor Implementation
 //==============================================================================
@@ -238,6 +210,11 @@ bool DynamicsProcessor::initialize(DynamicsProcessorType type) {
         case DynamicsProcessorType::DeEsser:
             return initializeDeEsser(CompressorConfig{});
 
+        case DynamicsProcessorType::MultibandCompressor:
+            // Bands start from default CompressorConfig settings
+            multibandEnabled = true;
+            return true;
+
         default:
             jassertfalse; // Unsupported type
             return false;
@@ -254,6 +231,9 @@ void DynamicsProcessor::reset() {
         envelopeFollower->reset();
     }
 
+    compressorCore.reset();
+    truePeakLimiter.reset();
+
     // Reset processing chains
     for (auto& duplicator : duplicators) {
         duplicator->reset();
@@ -268,13 +248,7 @@ void DynamicsProcessor::reset() {
         characterChain->reset();
     }
 
-    // Reset multiband filters
-    if (multibandEnabled) {
-        for (auto& filter : crossoverFilters) {
-            filter->reset();
-        }
-        std::fill(bandOutputs.begin(), bandOutputs.end(), 0.0f);
-    }
+    multibandDynamics.reset();
 
     // Reset sidechain
     sidechainBuffer.setSize(2, 512);
@@ -294,6 +268,10 @@ void DynamicsProcessor::prepareToPlay(double newSampleRate, int newSamplesPerBlo
         envelopeFollower->prepareToPlay(sampleRate, samplesPerBlock);
     }
 
+    compressorCore.prepare(sampleRate, samplesPerBlock);
+    truePeakLimiter.prepare(sampleRate, samplesPerBlock);
+    multibandDynamics.prepare(sampleRate, samplesPerBlock);
+
     // Prepare processing chains
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
@@ -313,11 +291,6 @@ void DynamicsProcessor::prepareToPlay(double newSampleRate, int newSamplesPerBlo
         characterChain->prepare(spec);
     }
 
-    // Prepare multiband filters
-    if (multibandEnabled) {
-        setupMultibandFilters();
-    }
-
     // Prepare sidechain
     sidechainBuffer.setSize(2, samplesPerBlock);
     sidechainFilter = std::make_unique<juce::dsp::IIR::Filter<float>>();
@@ -353,6 +326,8 @@ bool DynamicsProcessor::initializeCompressor(const CompressorConfig& config) {
 
     envelopeFollower->configure(envConfig);
 
+    compressorCore.setParameters(config);
+
     return true;
 }
 
@@ -374,6 +349,8 @@ bool DynamicsProcessor::initializeLimiter(const LimiterConfig& config) {
 
     envelopeFollower->configure(envConfig);
 
+    truePeakLimiter.setParameters(config);
+
     return true;
 }
 
@@ -440,6 +417,7 @@ bool DynamicsProcessor::initializeDeEsser(const CompressorConfig& config) {
 
 void DynamicsProcessor::processBlock(juce::AudioBuffer<float>& buffer) {
     if (bypassed) {
+        setSharedSidechain(nullptr, 0, nullptr, 0);
         return;
     }
 
@@ -447,6 +425,7 @@ void DynamicsProcessor::processBlock(juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
 
     if (numSamples == 0) {
+        setSharedSidechain(nullptr, 0, nullptr, 0);
         return;
     }
 
@@ -455,7 +434,15 @@ void DynamicsProcessor::processBlock(juce::AudioBuffer<float>& buffer) {
     // Process based on type
     switch (currentType) {
         case DynamicsProcessorType::Compressor:
-            processCompressor(buffer);
+            if (multibandEnabled) {
+                processMultiband(buffer);
+            } else {
+                processCompressor(buffer);
+            }
+            break;
+
+        case DynamicsProcessorType::MultibandCompressor:
+            processMultiband(buffer);
             break;
 
         case DynamicsProcessorType::Limiter:
@@ -478,6 +465,9 @@ void DynamicsProcessor::processBlock(juce::AudioBuffer<float>& buffer) {
             break;
     }
 
+    // Shared sidechain views only live for the block they were published in
+    setSharedSidechain(nullptr, 0, nullptr, 0);
+
     // Apply character processing if enabled
     if (saturationAmount > 0.0f || tubeDriveAmount > 0.0f) {
         applyCharacter(buffer);
@@ -509,6 +499,10 @@ void DynamicsProcessor::processBlock(juce::AudioBuffer<float>& buffer) {
     updateStats(dryBuffer, buffer);
 }
 
+int DynamicsProcessor::getLatencySamples() const noexcept {
+    return (currentType == DynamicsProcessorType::Limiter) ? truePeakLimiter.getLatencySamples() : 0;
+}
+
 void DynamicsProcessor::processStereo(juce::AudioBuffer<float>& buffer) {
     processBlock(buffer); // Stereo processing is handled in processBlock
 }
@@ -536,104 +530,49 @@ void DynamicsProcessor::processSidechainInput(const float* sidechainData, int nu
     sidechainEnabled = true;
 }
 
-void DynamicsProcessor::processCompressor(juce::AudioBuffer<float>& buffer) {
-    const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
-
-    // Process envelope follower
-    if (sidechainEnabled) {
-        envelopeFollower->processStereo(sidechainBuffer.getReadPointer(0),
-                                      sidechainBuffer.getReadPointer(1),
-                                      analysisBuffer.data(),
-                                      analysisBuffer.data() + numSamples/2,
-                                      numSamples);
-    } else {
-        // Use input signal as sidechain
-        if (numChannels >= 2) {
-            envelopeFollower->processStereo(buffer.getReadPointer(0),
-                                          buffer.getReadPointer(1),
-                                          analysisBuffer.data(),
-                                          analysisBuffer.data() + numSamples/2,
-                                          numSamples);
-        } else {
-            envelopeFollower->processBlock(buffer.getReadPointer(0),
-                                         analysisBuffer.data(),
-                                         numSamples);
-        }
-    }
-
-    // Apply compression
-    for (int ch = 0; ch < numChannels; ++ch) {
-        float* channelData = buffer.getWritePointer(ch);
-
-        for (int i = 0; i < numSamples; ++i) {
-            float envelopeValue = (i < numSamples/2) ? analysisBuffer[i] : analysisBuffer[i];
-            float inputLevel = juce::Decibels::gainToDecibels(std::abs(channelData[i]) + 1e-8f);
-
-            // Calculate gain reduction
-            float gainReduction = computeGainReduction(inputLevel, compressorConfig.threshold,
-                                                      compressorConfig.ratio, compressorConfig.kneeWidth);
-
-            // Apply soft knee
-            gainReduction = applySoftKnee(gainReduction, compressorConfig.threshold,
-                                         compressorConfig.kneeWidth);
+void DynamicsProcessor::setSharedSidechain(const float* const* keyChannels, int numKeyChannels,
+                                           const float* keyPower, int numSamples) noexcept {
+    const bool hasKey = keyChannels != nullptr && numKeyChannels > 0;
 
-            // Convert to linear gain
-            float gainLinear = juce::Decibels::decibelsToGain(-gainReduction);
-
-            // Apply makeup gain
-            gainLinear *= juce::Decibels::decibelsToGain(compressorConfig.makeupGain);
-
-            // Apply gain
-            channelData[i] *= gainLinear;
-
-            // Update processing state
-            processingState.currentGainReduction = gainReduction;
-            processingState.currentlyProcessing = true;
-        }
-    }
+    sharedKeyChannels = hasKey ? keyChannels : nullptr;
+    sharedKeyNumChannels = hasKey ? numKeyChannels : 0;
+    sharedKeyPower = keyPower;
+    sharedKeyNumSamples = (hasKey || keyPower != nullptr) ? numSamples : 0;
 }
 
-void DynamicsProcessor::processLimiter(juce::AudioBuffer<float>& buffer) {
+void DynamicsProcessor::processCompressor(juce::AudioBuffer<float>& buffer) {
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
-
-    // Process envelope follower
-    if (sidechainEnabled) {
-        envelopeFollower->processStereo(sidechainBuffer.getReadPointer(0),
-                                      sidechainBuffer.getReadPointer(1),
-                                      analysisBuffer.data(),
-                                      analysisBuffer.data() + numSamples/2,
-                                      numSamples);
+    const bool useSharedKey = sharedKeyNumSamples >= numSamples;
+
+    if (useSharedKey && sharedKeyPower != nullptr) {
+        // The shared key stream has already been through the detector
+        compressorCore.processWithKeyPower(buffer.getArrayOfWritePointers(), numChannels, numSamples, sharedKeyPower);
+    } else if (useSharedKey && sharedKeyChannels != nullptr) {
+        compressorCore.process(buffer.getArrayOfWritePointers(), numChannels, numSamples,
+                               sharedKeyChannels, sharedKeyNumChannels);
     } else {
-        // Use input signal as sidechain
-        if (numChannels >= 2) {
-            envelopeFollower->processStereo(buffer.getReadPointer(0),
-                                          buffer.getReadPointer(1),
-                                          analysisBuffer.data(),
-                                          analysisBuffer.data() + numSamples/2,
-                                          numSamples);
-        } else {
-            envelopeFollower->processBlock(buffer.getReadPointer(0),
-                                         analysisBuffer.data(),
-                                         numSamples);
-        }
+        // Linked detection, log-domain gain computer and gain smoothing run in
+        // the core; the sidechain (when fed) drives the detector
+        const bool useSidechain = sidechainEnabled && sidechainBuffer.getNumSamples() >= numSamples;
+
+        compressorCore.process(buffer.getArrayOfWritePointers(), numChannels, numSamples,
+                               useSidechain ? sidechainBuffer.getArrayOfReadPointers() : nullptr,
+                               useSidechain ? sidechainBuffer.getNumChannels() : 0);
     }
 
-    // Apply limiting
-    for (int ch = 0; ch < numChannels; ++ch) {
-        float* channelData = buffer.getWritePointer(ch);
+    // Update processing state once per block
+    processingState.currentGainReduction = compressorCore.getGainReductionDb();
+    processingState.currentlyProcessing = processingState.currentGainReduction > 0.0f;
+}
 
-        for (int i = 0; i < numSamples; ++i) {
-            float sample = channelData[i];
-            float outputSample = limitOutput(sample, limiterConfig.ceiling, std::numeric_limits<float>::infinity());
-            channelData[i] = outputSample;
+void DynamicsProcessor::processLimiter(juce::AudioBuffer<float>& buffer) {
+    // Lookahead true-peak limiting; output is delayed by getLatencySamples()
+    truePeakLimiter.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
 
-            // Update processing state
-            processingState.currentGainReduction = juce::Decibels::gainToDecibels(std::abs(outputSample)) - limiterConfig.ceiling;
-            processingState.currentlyProcessing = std::abs(outputSample) >= juce::Decibels::decibelsToGain(limiterConfig.ceiling - 0.1f);
-        }
-    }
+    // Update processing state once per block
+    processingState.currentGainReduction = truePeakLimiter.getGainReductionDb();
+    processingState.currentlyProcessing = processingState.currentGainReduction > 0.0f;
 }
 
 void DynamicsProcessor::processGate(juce::AudioBuffer<float>& buffer) {
@@ -641,7 +580,13 @@ void DynamicsProcessor::processGate(juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
 
     // Process envelope follower
-    if (sidechainEnabled) {
+    if (sharedKeyNumSamples >= numSamples && sharedKeyChannels != nullptr) {
+        envelopeFollower->processStereo(sharedKeyChannels[0],
+                                      sharedKeyChannels[sharedKeyNumChannels > 1 ? 1 : 0],
+                                      analysisBuffer.data(),
+                                      analysisBuffer.data() + numSamples/2,
+                                      numSamples);
+    } else if (sidechainEnabled) {
         envelopeFollower->processStereo(sidechainBuffer.getReadPointer(0),
                                       sidechainBuffer.getReadPointer(1),
                                       analysisBuffer.data(),
@@ -792,53 +737,19 @@ void DynamicsProcessor::processDeEsser(juce::AudioBuffer<float>& buffer) {
 }
 
 void DynamicsProcessor::processMultiband(juce::AudioBuffer<float>& buffer) {
-    if (!multibandEnabled || crossoverFrequencies.empty()) {
-        return;
-    }
-
-    const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
-    const int numBands = static_cast<int>(crossoverFrequencies.size()) + 1;
-
-    // Ensure band outputs array is properly sized
-    if (bandOutputs.size() != numBands * numChannels * numSamples) {
-        bandOutputs.resize(numBands * numChannels * numSamples);
-    }
 
-    // Split into bands and process each separately
-    for (int ch = 0; ch < numChannels; ++ch) {
-        float* channelData = buffer.getWritePointer(ch);
+    // Band split, per-band detection and gain, and the band sum all run in
+    // the multiband engine; keyed bands read the sidechain when it is fed
+    const bool useSidechain = sidechainEnabled && sidechainBuffer.getNumSamples() >= numSamples;
 
-        // Process through crossover filters
-        std::vector<float*> bandPointers(numBands);
-        for (int band = 0; band < numBands; ++band) {
-            bandPointers[band] = bandOutputs.data() + (band * numChannels + ch) * numSamples;
-            std::copy(channelData, channelData + numSamples, bandPointers[band]);
-        }
-
-        // Apply crossover filtering
-        for (int i = 0; i < numSamples; ++i) {
-            // This is a simplified implementation - real crossover filtering would be more complex
-            // For now, we'll just copy the signal to all bands
-            for (int band = 0; band < numBands; ++band) {
-                bandPointers[band][i] = channelData[i];
-            }
-        }
-
-        // Process each band (simplified - real implementation would process each band separately)
-        for (int band = 0; band < numBands; ++band) {
-            juce::AudioBuffer<float> bandBuffer(bandPointers[band], 1, numSamples);
-            processCompressor(bandBuffer); // Apply compression to each band
-        }
+    multibandDynamics.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples,
+                              useSidechain ? sidechainBuffer.getArrayOfReadPointers() : nullptr,
+                              useSidechain ? sidechainBuffer.getNumChannels() : 0);
 
-        // Mix bands back together
-        std::fill(channelData, channelData + numSamples, 0.0f);
-        for (int band = 0; band < numBands; ++band) {
-            for (int i = 0; i < numSamples; ++i) {
-                channelData[i] += bandPointers[band][i] / numBands;
-            }
-        }
-    }
+    // Update processing state once per block
+    processingState.currentGainReduction = multibandDynamics.getGainReductionDb();
+    processingState.currentlyProcessing = processingState.currentGainReduction > 0.0f;
 }
 
 void DynamicsProcessor::processParallel(juce::AudioBuffer<float>& buffer, juce::AudioBuffer<float>& dryBuffer) {
@@ -929,21 +840,7 @@ void DynamicsProcessor::applyCharacter(juce::AudioBuffer<float>& buffer) {
 }
 
 void DynamicsProcessor::setupMultibandFilters() {
-    crossoverFilters.clear();
-
-    for (float freq : crossoverFrequencies) {
-        auto filter = std::make_unique<juce::dsp::LinkwitzRileyFilter<float>>();
-        filter->setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sampleRate;
-        spec.maximumBlockSize = samplesPerBlock;
-        spec.numChannels = 1;
-
-        filter->prepare(spec);
-        filter->setCutoffFrequency(freq);
-        crossoverFilters.push_back(std::move(filter));
-    }
+    multibandDynamics.setCrossoverFrequencies(crossoverFrequencies);
 }
 
 float DynamicsProcessor::computeGainReduction(float inputLevel, float threshold, float ratio, float kneeWidth) {
@@ -1068,15 +965,18 @@ void DynamicsProcessor::setLimiterConfig(const LimiterConfig& config) {
 void DynamicsProcessor::setThreshold(float thresholdDb) {
     processingState.currentThreshold = thresholdDb;
     compressorConfig.threshold = thresholdDb;
+    compressorCore.setParameters(compressorConfig);
 }
 
 void DynamicsProcessor::setRatio(float ratio) {
     processingState.currentRatio = ratio;
     compressorConfig.ratio = ratio;
+    compressorCore.setParameters(compressorConfig);
 }
 
 void DynamicsProcessor::setAttackTime(float attackMs) {
     compressorConfig.attackTime = attackMs;
+    compressorCore.setParameters(compressorConfig);
     if (envelopeFollower) {
         envelopeFollower->setAttackTime(attackMs);
     }
@@ -1084,6 +984,7 @@ void DynamicsProcessor::setAttackTime(float attackMs) {
 
 void DynamicsProcessor::setReleaseTime(float releaseMs) {
     compressorConfig.releaseTime = releaseMs;
+    compressorCore.setParameters(compressorConfig);
     if (envelopeFollower) {
         envelopeFollower->setReleaseTime(releaseMs);
     }
@@ -1092,14 +993,17 @@ void DynamicsProcessor::setReleaseTime(float releaseMs) {
 void DynamicsProcessor::setMakeupGain(float makeupDb) {
     processingState.currentMakeup = makeupDb;
     compressorConfig.makeupGain = makeupDb;
+    compressorCore.setParameters(compressorConfig);
 }
 
 void DynamicsProcessor::setKneeWidth(float kneeDb) {
     compressorConfig.kneeWidth = kneeDb;
+    compressorCore.setParameters(compressorConfig);
 }
 
 void DynamicsProcessor::setCeiling(float ceilingDb) {
     limiterConfig.ceiling = ceilingDb;
+    truePeakLimiter.setParameters(limiterConfig);
 }
 
 void DynamicsProcessor::enableMultiband(bool enabled) {
@@ -1112,9 +1016,7 @@ void DynamicsProcessor::setCrossoverFrequencies(const std::vector<float>& freque
 }
 
 void DynamicsProcessor::setBandConfig(int bandIndex, const CompressorConfig& config) {
-    // This would require storing separate configs for each band
-    // For simplicity, we'll just update the main compressor config
-    setCompressorConfig(config);
+    multibandDynamics.setBandParameters(bandIndex, config);
 }
 
 void DynamicsProcessor::setSaturationAmount(float amount, float drive) {
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include "dsp/PartitionedConvolution.h"
 #include <vector>
 #include <cmath>
 #include <cstring>
@@ -32,6 +33,7 @@ namespace DSP {
  * Features:
  * - Bridge nonlinear saturation (soft clipping distortion)
  * - Modal body resonator (acoustic guitar body emulation)
+ * - Optional cabinet impulse response (zero-latency convolution)
  * - Warm, musical distortion character
  * - Tone control with shelving EQ
  * - Mix control (dry/wet)
@@ -72,6 +74,34 @@ public:
      */
     void process(float** inputs, float** outputs, int numChannels, int numSamples);
 
+    /**
+     * Offline rendering: convolution tails are computed inline
+     * Takes effect at the next prepare()
+     */
+    void setNonRealtime(bool nonRealtime);
+
+    //==============================================================================
+    // Cabinet Impulse Response
+    //==============================================================================
+
+    /**
+     * Load a measured cabinet IR (message thread)
+     *
+     * While an IR is loaded the cabinet_simulation parameter blends it in
+     * place of the modal body resonator. Swaps crossfade; no added latency.
+     * @param channels IR channels (1 = mono, 2 = stereo, 4 = true stereo)
+     * @param numChannels Number of IR channels
+     * @param numSamples IR length in samples
+     * @param sampleRate IR sample rate (resampled if it differs)
+     * @return true if the IR was accepted
+     */
+    bool loadCabinetIR(const float* const* channels, int numChannels, int numSamples, double sampleRate);
+
+    /**
+     * Return to the modal body resonator (message thread)
+     */
+    void clearCabinetIR();
+
     //==============================================================================
     // Parameters
     //==============================================================================
@@ -245,6 +275,7 @@ private:
 
     BridgeNonlinearity bridgeNonlinearity_;
     ModalBodyResonator bodyResonator_;
+    ConvolutionEngine cabinetIR_;
 
     double sampleRate_ = 48000.0;
     int blockSize_ = 512;
@@ -252,6 +283,9 @@ private:
     // Temporary buffers for processing (avoid real-time allocations)
     static constexpr int MAX_BLOCK_SIZE = 512;
     float tempBuffer_[MAX_BLOCK_SIZE];
+    float dryBuffer_[2][MAX_BLOCK_SIZE];
+    float wetBuffer_[2][MAX_BLOCK_SIZE];
+    float cabinetBuffer_[2][MAX_BLOCK_SIZE];
 };
 
 //==============================================================================
@@ -334,6 +334,9 @@ bool AetherDrivePureDSP::prepare(double sampleRate, int blockSize)
     // Load guitar body preset by default
     bodyResonator_.loadGuitarBodyPreset();
 
+    // Rebuilds a loaded cabinet IR for the new sample rate
+    cabinetIR_.prepare(sampleRate, MAX_BLOCK_SIZE);
+
     return true;
 }
 
@@ -341,58 +344,89 @@ void AetherDrivePureDSP::reset()
 {
     bridgeNonlinearity_.reset();
     bodyResonator_.reset();
+    cabinetIR_.reset();
 }
 
 void AetherDrivePureDSP::process(float** inputs, float** outputs, int numChannels, int numSamples)
 {
     // Process mono or stereo
     int channelsToProcess = std::min(2, numChannels);
+    const bool useCabinetIR = cabinetIR_.hasImpulseResponse();
 
-    for (int ch = 0; ch < channelsToProcess; ++ch)
+    // Work through the fixed buffers; inputs may alias outputs
+    for (int offset = 0; offset < numSamples; offset += MAX_BLOCK_SIZE)
     {
-        // Clear output buffer
-        std::fill(outputs[ch], outputs[ch] + numSamples, 0.0f);
+        const int blockSamples = std::min(MAX_BLOCK_SIZE, numSamples - offset);
 
-        for (int i = 0; i < numSamples; ++i)
+        for (int ch = 0; ch < channelsToProcess; ++ch)
         {
-            float input = inputs[ch][i];
-
-            // Check for NaN input
-            if (std::isnan(input) || std::isinf(input))
+            for (int i = 0; i < blockSamples; ++i)
             {
-                input = 0.0f;
+                float input = inputs[ch][offset + i];
+
+                // Check for NaN input
+                if (std::isnan(input) || std::isinf(input))
+                {
+                    input = 0.0f;
+                }
+
+                // Store dry signal for mix
+                dryBuffer_[ch][i] = input;
+
+                // Process through bridge nonlinearity (distortion)
+                float distorted = bridgeNonlinearity_.processSample(input);
+
+                if (useCabinetIR)
+                {
+                    // Measured cabinet replaces the body resonator
+                    wetBuffer_[ch][i] = distorted;
+                    cabinetBuffer_[ch][i] = distorted;
+                    continue;
+                }
+
+                // Process through body resonator (cabinet simulation)
+                float resonant = bodyResonator_.processSample(distorted);
+
+                // Apply cabinet simulation (mix in resonant signal)
+                wetBuffer_[ch][i] = distorted * (1.0f - params_.cabinetSimulation) +
+                                    resonant * params_.cabinetSimulation;
             }
+        }
 
-            // Store dry signal for mix
-            float dry = input;
-
-            // Process through bridge nonlinearity (distortion)
-            float distorted = bridgeNonlinearity_.processSample(input);
+        if (useCabinetIR)
+        {
+            float* cabinet[2] = { cabinetBuffer_[0], cabinetBuffer_[1] };
+            cabinetIR_.process(cabinet, cabinet, channelsToProcess, blockSamples);
 
-            // Process through body resonator (cabinet simulation)
-            float resonant = bodyResonator_.processSample(distorted);
+            for (int ch = 0; ch < channelsToProcess; ++ch)
+            {
+                for (int i = 0; i < blockSamples; ++i)
+                {
+                    wetBuffer_[ch][i] = wetBuffer_[ch][i] * (1.0f - params_.cabinetSimulation) +
+                                        cabinetBuffer_[ch][i] * params_.cabinetSimulation;
+                }
+            }
+        }
 
-            // Apply cabinet simulation (mix in resonant signal)
-            float wet = distorted * (1.0f - params_.cabinetSimulation) +
-                       resonant * params_.cabinetSimulation;
+        for (int ch = 0; ch < channelsToProcess; ++ch)
+        {
+            for (int i = 0; i < blockSamples; ++i)
+            {
+                // Apply dry/wet mix
+                float output = dryBuffer_[ch][i] * (1.0f - params_.mix) + wetBuffer_[ch][i] * params_.mix;
 
-            // Apply dry/wet mix
-            float output = dry * (1.0f - params_.mix) + wet * params_.mix;
+                // Apply output level
+                output *= params_.outputLevel;
 
-            // Apply output level
-            output *= params_.outputLevel;
+                // Final safety checks
+                if (std::isnan(output) || std::isinf(output))
+                {
+                    output = 0.0f;
+                }
 
-            // Final safety checks
-            if (std::isnan(output) || std::isinf(output))
-            {
-                output = 0.0f;
+                // Soft clip output to prevent digital clipping
+                outputs[ch][offset + i] = std::tanh(output);
             }
-
-            // Soft clip output to prevent digital clipping
-            output = std::tanh(output);
-
-            // Copy to output
-            outputs[ch][i] = output;
         }
     }
 
@@ -403,6 +437,22 @@ void AetherDrivePureDSP::process(float** inputs, float** outputs, int numChannel
     }
 }
 
+void AetherDrivePureDSP::setNonRealtime(bool nonRealtime)
+{
+    cabinetIR_.setNonRealtime(nonRealtime);
+}
+
+bool AetherDrivePureDSP::loadCabinetIR(const float* const* channels, int numChannels,
+                                       int numSamples, double sampleRate)
+{
+    return cabinetIR_.loadImpulseResponse(channels, numChannels, numSamples, sampleRate);
+}
+
+void AetherDrivePureDSP::clearCabinetIR()
+{
+    cabinetIR_.clearImpulseResponse();
+}
+
 float AetherDrivePureDSP::getParameter(const char* paramId) const
 {
     if (std::strcmp(paramId, "drive") == 0)
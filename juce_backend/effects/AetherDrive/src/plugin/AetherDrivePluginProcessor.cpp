@@ -63,6 +63,7 @@ AetherDrivePluginProcessor::~AetherDrivePluginProcessor()
 //==============================================================================
 void AetherDrivePluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    dspEngine.setNonRealtime(isNonRealtime());
     dspEngine.prepare(sampleRate, samplesPerBlock);
 }
 
@@ -101,6 +101,7 @@ bool InterchangeableEffectSlot::loadExternalByName(const std::string& pluginName
 
 void InterchangeableEffectSlot::processBlock(juce::AudioBuffer<float>& buffer) {
     if (!currentEffect || bypassed || !enabled) {
+        sidechainBuffer = juce::AudioBuffer<float>();
         return;
     }
 
@@ -108,10 +109,11 @@ void InterchangeableEffectSlot::processBlock(juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
     juce::AudioBuffer<float> inputCopy = buffer;
 
-    // Process sidechain if available
+    // Process sidechain if available; the view is dropped once used
     if (sidechainBuffer.getNumSamples() == numSamples) {
         currentEffect->processSidechainInput(sidechainBuffer);
     }
+    sidechainBuffer = juce::AudioBuffer<float>();
 
     // Apply parameter smoothing
     applyParameterSmoothing();
@@ -146,7 +148,10 @@ void InterchangeableEffectSlot::processStereo(juce::AudioBuffer<float>& leftBuff
 }
 
 void InterchangeableEffectSlot::processSidechainInput(const juce::AudioBuffer<float>& sidechainBufferInput) {
-    sidechainBuffer.makeCopyOf(sidechainBufferInput);
+    // Shared keys are read in place rather than copied into every slot
+    sidechainBuffer.setDataToReferTo(const_cast<float* const*>(sidechainBufferInput.getArrayOfReadPointers()),
+                                     sidechainBufferInput.getNumChannels(),
+                                     sidechainBufferInput.getNumSamples());
 }
 
 float InterchangeableEffectSlot::getParameter(const std::string& parameterName) const {
@@ -666,9 +666,12 @@ void DynamicsEffectsChain::processBlock(juce::AudioBuffer<float>& buffer) {
         processSeriesMode(buffer);
     }
 
-    // Apply Mid/Side processing if enabled
-    if (midSideMode && numChannels >= 2) {
+    // Apply Mid/Side processing if enabled (on the front L/R pair of wider layouts)
+    if (midSideMode && numChannels == 2) {
         processMidSideMode(buffer);
+    } else if (midSideMode && numChannels > 2) {
+        juce::AudioBuffer<float> frontPair(buffer.getArrayOfWritePointers(), 2, numSamples);
+        processMidSideMode(frontPair);
     }
 
     // Apply master output gain
@@ -702,19 +705,16 @@ void DynamicsEffectsChain::processStereo(juce::AudioBuffer<float>& leftBuffer, j
 }
 
 void DynamicsEffectsChain::processMultichannel(juce::AudioBuffer<float>& buffer, int numChannels) {
-    // For now, limit to stereo processing
-    if (numChannels > 2) {
-        juce::AudioBuffer<float> stereoBuffer(2, buffer.getNumSamples());
-        stereoBuffer.copyFrom(0, 0, buffer, 0, 0, buffer.getNumSamples());
-        stereoBuffer.copyFrom(1, 0, buffer, 1, 0, buffer.getNumSamples());
+    numChannels = juce::jlimit(0, buffer.getNumChannels(), numChannels);
 
-        processBlock(stereoBuffer);
-
-        buffer.copyFrom(0, 0, stereoBuffer, 0, 0, buffer.getNumSamples());
-        buffer.copyFrom(1, 0, stereoBuffer, 1, 0, buffer.getNumSamples());
-    } else {
+    if (numChannels == buffer.getNumChannels()) {
         processBlock(buffer);
+        return;
     }
+
+    // Non-owning view of the requested channels: processed in place, no copies
+    juce::AudioBuffer<float> channels(buffer.getArrayOfWritePointers(), numChannels, buffer.getNumSamples());
+    processBlock(channels);
 }
 
 void DynamicsEffectsChain::processSidechainInput(const std::string& sourceName, const juce::AudioBuffer<float>& sidechainBuffer) {
@@ -1259,9 +1259,8 @@ void DynamicsEffectsChain::processParallelMode(juce::AudioBuffer<float>& buffer)
         float mixGain = 1.0f / slotBuffers.size(); // Equal power mixing
 
         for (const auto& slotBuffer : slotBuffers) {
-            buffer.addFrom(0, 0, slotBuffer, 0, 0, buffer.getNumSamples(), mixGain);
-            if (buffer.getNumChannels() > 1) {
-                buffer.addFrom(1, 0, slotBuffer, 1, 0, buffer.getNumSamples(), mixGain);
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+                buffer.addFrom(ch, 0, slotBuffer, ch, 0, buffer.getNumSamples(), mixGain);
             }
         }
     }
@@ -11,7 +11,8 @@
     - Distance-based attenuation (inverse square law)
     - High-frequency air absorption
     - Stereo width narrowing with distance
-    - Doppler effect from source velocity
+    - Doppler pitch shift from source velocity (phase vocoder, always in
+      the path so the reported latency of one frame never changes)
     - Near-to-far crossfading
 
   ==============================================================================
@@ -19,9 +20,11 @@
 
 #pragma once
 
+#include "dsp/PhaseVocoder.h"
 #include <cmath>
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 
 namespace farfield {
 
@@ -67,7 +70,6 @@ public:
         , lastRightIn(0.0f)
         , lastLeftOut(0.0f)
         , lastRightOut(0.0f)
-        , dopplerPhase(0.0f)
     {
     }
 
@@ -75,9 +77,11 @@ public:
     // Initialization
     //==========================================================================
 
-    void prepare(double newSampleRate, int /*maxSamplesPerBlock*/)
+    void prepare(double newSampleRate, int maxSamplesPerBlock)
     {
         sampleRate = newSampleRate;
+        dopplerShifter = std::make_unique<DSP::PhaseVocoder>(DSP::PhaseVocoder::Mode::LowLatency,
+                                                             newSampleRate, 2, std::max(1, maxSamplesPerBlock));
         reset();
     }
 
@@ -87,7 +91,15 @@ public:
         lastRightIn = 0.0f;
         lastLeftOut = 0.0f;
         lastRightOut = 0.0f;
-        dopplerPhase = 0.0f;
+
+        if (dopplerShifter)
+            dopplerShifter->reset();
+    }
+
+    /** Output delay of the Doppler shifter; constant once prepared */
+    int getLatencySamples() const
+    {
+        return dopplerShifter ? dopplerShifter->getLatency() : 0;
     }
 
     //==========================================================================
@@ -119,6 +131,15 @@ public:
 
             processSample(leftIn, rightIn, left[i], right[i]);
         }
+
+        // Doppler pitch shift over the whole block. The shifter runs at unity
+        // while Doppler is off so the latency stays the same either way.
+        if (dopplerShifter)
+        {
+            dopplerShifter->setPitchRatio(dopplerEngaged() ? getDopplerRatio() : 1.0);
+            float* channels[2] = { left, right };
+            dopplerShifter->processBlock(channels, channels, numSamples);
+        }
     }
 
 private:
@@ -168,13 +189,9 @@ private:
         float leftWide = mid + side * widthFactor;
         float rightWide = mid - side * widthFactor;
 
-        // 7. Apply Doppler effect (pitch shift based on source velocity)
-        float leftDoppler = applyDoppler(leftWide);
-        float rightDoppler = applyDoppler(rightWide);
-
-        // 8. Apply output level
-        leftOut = leftDoppler * params.level;
-        rightOut = rightDoppler * params.level;
+        // 7. Apply output level (Doppler shift follows per block)
+        leftOut = leftWide * params.level;
+        rightOut = rightWide * params.level;
 
         // Update state
         lastLeftIn = leftIn;
@@ -217,26 +234,18 @@ private:
     // Doppler Effect
     //==========================================================================
 
-    float applyDoppler(float input)
+    bool dopplerEngaged() const
+    {
+        return dopplerShifter && params.dopplerAmount >= 0.01f;
+    }
+
+    double getDopplerRatio() const
     {
-        if (params.dopplerAmount < 0.01f)
-            return input;
-
-        // Doppler shift frequency
-        float speedOfSound = 343.0f; // m/s at 20°C
-        float dopplerShift = 1.0f + (params.sourceVelocity / speedOfSound);
-        dopplerShift = 1.0f + (dopplerShift - 1.0f) * params.dopplerAmount;
-
-        // Simple delay-based Doppler implementation
-        float delaySamples = dopplerShift * 10.0f; // Max 10 samples delay
-        dopplerPhase += delaySamples;
-        if (dopplerPhase >= 10.0f)
-            dopplerPhase -= 10.0f;
-
-        // For simplicity, we'll just modulate the input slightly
-        // A full implementation would use a variable delay line
-        float modulation = std::sin(dopplerPhase * 0.1f) * 0.01f * params.dopplerAmount;
-        return input * (1.0f + modulation);
+        // Moving source, still listener: f' = f * c / (c - v), v > 0 approaching
+        const double speedOfSound = 343.0; // m/s at 20°C
+        const double velocity = std::clamp(static_cast<double>(params.sourceVelocity), -80.0, 80.0)
+                              * std::clamp(static_cast<double>(params.dopplerAmount), 0.0, 1.0);
+        return speedOfSound / (speedOfSound - velocity);
     }
 
     //==========================================================================
@@ -249,7 +258,9 @@ private:
     // State variables
     float lastLeftIn, lastRightIn;
     float lastLeftOut, lastRightOut;
-    float dopplerPhase;
+
+    // Doppler pitch shifter, created in prepare()
+    std::unique_ptr<DSP::PhaseVocoder> dopplerShifter;
 };
 
 //==============================================================================
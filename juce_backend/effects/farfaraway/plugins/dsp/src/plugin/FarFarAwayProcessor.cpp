@@ -139,6 +139,7 @@ FarFarAwayProcessor::~FarFarAwayProcessor()
 void FarFarAwayProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     farField.prepare(sampleRate, samplesPerBlock);
+    setLatencySamples(farField.getLatencySamples());
 }
 
 void FarFarAwayProcessor::releaseResources()
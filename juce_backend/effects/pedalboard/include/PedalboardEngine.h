@@ -0,0 +1,336 @@
+/*
+==============================================================================
+White Room Pedalboard Engine
+==============================================================================
+
+Real-time execution engine for the pedalboard chain.
+
+- The chain runs through two preallocated ping-pong buffers: the first pedal
+  reads the host buffer, the last writes back into it, and nothing is copied
+  or allocated per block.
+- Chains are built and prepared on the message thread and handed to the
+  audio thread through a single atomic slot. The audio thread picks them up
+  at a block boundary and crossfades from the old chain's output to the new
+  one's. Only structural edits and scene switches do this; parameter and
+  bypass changes go straight to the live chain's pedals.
+- Each saved scene keeps its own prepared pedal instances, so switching
+  scenes is a pointer handoff, not a rebuild. The chain that goes live is
+  detached from the scene and a fresh copy is prepared in its place, so
+  playing a scene never changes what it recalls.
+- The engine has no JUCE dependency; the processor hands it the host
+  buffer's channel pointers.
+
+Ownership: the engine owns every chain. A chain that has been handed to the
+audio thread is only freed after the audio thread gives it back (its
+audioUses count drops to zero), which collectGarbage() checks on the message
+thread.
+*/
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include "dsp/GuitarPedalPureDSP.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/**
+    Represents a single pedal instance in the pedalboard
+*/
+class PedalInstance
+{
+public:
+    PedalInstance(DSP::GuitarPedalPureDSP* pedal, const std::string& name)
+        : dspPedal(pedal), pedalName(name), bypassed(false)
+    {
+    }
+
+    /** Pedal that owns its DSP, so every chain and scene has its own state */
+    PedalInstance(std::unique_ptr<DSP::GuitarPedalPureDSP> pedal, const std::string& name)
+        : ownedPedal(std::move(pedal)), dspPedal(ownedPedal.get()), pedalName(name), bypassed(false)
+    {
+    }
+
+    ~PedalInstance()
+    {
+        // Note: dspPedal is only deleted when it was handed over as ownedPedal
+    }
+
+    void prepare(double sampleRate, int blockSize)
+    {
+        dspPedal->prepare(sampleRate, blockSize);
+        bypassRampStep = 1.0f / std::max(1.0f, (float) (bypassRampSeconds * sampleRate));
+    }
+
+    /** Audio thread. Inputs and outputs are separate buffers. */
+    void process(float** inputs, float** outputs, int numChannels, int numSamples)
+    {
+        const float target = bypassed.load(std::memory_order_relaxed) ? 0.0f : 1.0f;
+
+        if (engagedGain == target)
+        {
+            if (target == 0.0f)
+            {
+                // Just copy input to output
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    std::copy(inputs[ch], inputs[ch] + numSamples, outputs[ch]);
+                }
+            }
+            else
+            {
+                // Process through DSP pedal
+                dspPedal->process(inputs, outputs, numChannels, numSamples);
+            }
+            return;
+        }
+
+        // Switching: ramp between the pedal and the dry input. A pedal coming
+        // out of bypass starts clean rather than from where it stopped.
+        if (engagedGain == 0.0f)
+            dspPedal->reset();
+
+        dspPedal->process(inputs, outputs, numChannels, numSamples);
+
+        const float step = target > engagedGain ? bypassRampStep : -bypassRampStep;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float gain = engagedGain;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gain = std::clamp(gain + step, 0.0f, 1.0f);
+                outputs[ch][i] = inputs[ch][i] + gain * (outputs[ch][i] - inputs[ch][i]);
+            }
+        }
+
+        engagedGain = std::clamp(engagedGain + step * (float) numSamples, 0.0f, 1.0f);
+    }
+
+    /** Any thread; the audio thread ramps to it over a few milliseconds */
+    void setBypass(bool bypass)
+    {
+        bypassed.store(bypass, std::memory_order_relaxed);
+    }
+
+    bool isBypassed() const { return bypassed.load(std::memory_order_relaxed); }
+
+    std::string getName() const { return pedalName; }
+
+    DSP::GuitarPedalPureDSP* getDSP() { return dspPedal; }
+    const DSP::GuitarPedalPureDSP* getDSP() const { return dspPedal; }
+
+    nlohmann::json getParameters() const
+    {
+        nlohmann::json params;
+        params["bypassed"] = isBypassed();
+        params["parameters"] = nlohmann::json::array();
+
+        for (int i = 0; i < dspPedal->getNumParameters(); ++i)
+        {
+            nlohmann::json param;
+            param["index"] = i;
+
+            // Get parameter info
+            const auto* paramInfo = dspPedal->getParameter(i);
+            if (paramInfo)
+            {
+                param["name"] = paramInfo->name;
+                param["value"] = dspPedal->getParameterValue(i);
+            }
+
+            params["parameters"].push_back(param);
+        }
+
+        return params;
+    }
+
+    void setParameters(const nlohmann::json& params)
+    {
+        // Before the pedal is handed to the audio thread, so no ramp
+        if (params.contains("bypassed"))
+        {
+            const bool bypass = params["bypassed"];
+            bypassed.store(bypass, std::memory_order_relaxed);
+            engagedGain = bypass ? 0.0f : 1.0f;
+        }
+
+        if (params.contains("parameters"))
+        {
+            for (const auto& param : params["parameters"])
+            {
+                if (!param.contains("value"))
+                    continue;
+
+                int index = param["index"];
+                float value = param["value"];
+                dspPedal->setParameterValue(index, value);
+            }
+        }
+    }
+
+private:
+    std::unique_ptr<DSP::GuitarPedalPureDSP> ownedPedal;
+    DSP::GuitarPedalPureDSP* dspPedal;
+    std::string pedalName;
+    std::atomic<bool> bypassed;
+
+    static constexpr double bypassRampSeconds = 0.005;
+    float bypassRampStep = 1.0f;
+    float engagedGain = 1.0f;       // Audio thread: 1 processing, 0 bypassed
+};
+
+//==============================================================================
+/**
+    A prepared pedal chain. Its structure never changes after it has been
+    handed to the audio thread; structural edits build a new chain.
+*/
+class PedalChain
+{
+public:
+    std::vector<std::unique_ptr<PedalInstance>> pedals;
+
+    int getNumPedals() const { return (int) pedals.size(); }
+
+    /** Chain description in the preset/scene format ({"pedals": [...]}) */
+    nlohmann::json toJson() const;
+
+    void prepare(double sampleRate, int blockSize);
+    void reset();
+
+    /** Number of audio-thread references (pending, current or fading out) */
+    std::atomic<int> audioUses { 0 };
+};
+
+//==============================================================================
+/**
+    Zero-allocation pedal chain execution with scene crossfades
+*/
+class PedalboardEngine
+{
+public:
+    static constexpr int numScenes = 8;
+    static constexpr int maxChannels = 2;
+
+    /** Creates a fresh DSP instance for a pedal type, nullptr if unknown */
+    using PedalFactory = std::function<std::unique_ptr<DSP::GuitarPedalPureDSP>(const std::string&)>;
+
+    explicit PedalboardEngine(PedalFactory factory);
+    ~PedalboardEngine();
+
+    //==============================================================================
+    // Message thread
+
+    /**
+        Allocate buffers and prepare every chain. Only call while the audio
+        thread is stopped (prepareToPlay).
+    */
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+
+    /** Reset every chain's DSP state (audio stopped) */
+    void releaseResources();
+
+    /** Crossfade length used for scene switches and chain edits (default 20 ms) */
+    void setCrossfadeTime(double seconds);
+
+    /**
+        Build and prepare a chain from a description. Unknown pedal types are
+        skipped.
+    */
+    std::unique_ptr<PedalChain> buildChain(const nlohmann::json& description) const;
+
+    /** Make a new chain audible; the audio thread crossfades to it */
+    void setLiveChain(std::unique_ptr<PedalChain> chain);
+
+    /**
+        Chain most recently made live (what the editor shows). Read only:
+        the audio thread may be running it; edit by building a new chain.
+    */
+    const PedalChain* getLiveChain() const { return liveChain; }
+
+    /**
+        Set a parameter on a pedal of the live chain. The pedal takes it in
+        its next block, smoothing as it does for automation; there is no
+        rebuild or crossfade.
+        @return false if there is no such pedal or parameter
+    */
+    bool setLiveParameter(int pedalIndex, int parameterIndex, float value);
+
+    /**
+        Bypass or engage a pedal of the live chain. The pedal ramps between
+        its output and the dry signal over a few milliseconds.
+        @return false if there is no such pedal
+    */
+    bool setLiveBypass(int pedalIndex, bool bypassed);
+
+    /** Build and keep a scene's chain prepared, ready to switch to */
+    void prepareScene(int sceneNumber, const nlohmann::json& description);
+
+    bool hasScene(int sceneNumber) const;
+
+    /**
+        Switch to a prepared scene at the next block boundary. The scene's
+        chain becomes the live chain and the scene gets a freshly prepared
+        copy of its saved description.
+        @return false if the scene has not been prepared
+    */
+    bool switchToScene(int sceneNumber);
+
+    /** Free chains the audio thread has given back */
+    void collectGarbage();
+
+    /** Chains the engine currently owns (live, scenes and fading out) */
+    int getNumChains() const { return (int) chains.size(); }
+
+    //==============================================================================
+    // Audio thread
+
+    /** Run the chain in place over the host's channels. Lock-free and allocation-free. */
+    void process(float* const* channels, int numChannels, int numSamples) noexcept;
+
+    bool isCrossfading() const noexcept { return crossfading.load(std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    void post(PedalChain* chain);
+
+    void processChunk(float* const* host, int numChannels, int numSamples) noexcept;
+    void runChain(PedalChain& chain, float* const* host, float* const* destination,
+                  int numChannels, int numSamples) noexcept;
+
+    static void release(PedalChain* chain) noexcept;
+
+    PedalFactory factory;
+
+    // Message-thread state
+    std::vector<std::unique_ptr<PedalChain>> chains;        // Every chain the engine owns
+    std::array<PedalChain*, numScenes> sceneChains {};
+    std::array<nlohmann::json, numScenes> sceneDescriptions;
+    PedalChain* liveChain = nullptr;
+    double sampleRate = 48000.0;
+    int maxBlockSize = 512;
+    int numPreparedChannels = maxChannels;
+    double crossfadeSeconds = 0.02;
+
+    // Handoff slot; the poster adds an audioUses reference for it
+    std::atomic<PedalChain*> pendingChain { nullptr };
+
+    // Audio-thread state
+    PedalChain* currentChain = nullptr;
+    PedalChain* outgoingChain = nullptr;
+    int fadePosition = 0;
+    std::atomic<bool> crossfading { false };
+
+    // Preallocated in prepare(), one vector per channel
+    std::array<std::vector<float>, maxChannels> ping, pong, fadeBuffer;
+    std::vector<float> fadeInCurve;                         // sin^2, fade-out is 1 - fadeIn
+
+    PedalboardEngine(const PedalboardEngine&) = delete;
+    PedalboardEngine& operator=(const PedalboardEngine&) = delete;
+};
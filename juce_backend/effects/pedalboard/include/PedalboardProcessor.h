@@ -15,6 +15,7 @@ Version: 1.0.0
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <nlohmann/json.hpp>
 
+#include "PedalboardEngine.h"
 #include "dsp/GuitarPedalPureDSP.h"
 #include "dsp/VolumePedalPureDSP.h"
 #include "dsp/FuzzPedalPureDSP.h"
@@ -29,100 +30,6 @@ Version: 1.0.0
 
 using namespace DSP;
 
-//==============================================================================
-/**
-    Represents a single pedal instance in the pedalboard
-*/
-class PedalInstance
-{
-public:
-    PedalInstance(GuitarPedalPureDSP* pedal, const std::string& name)
-        : dspPedal(pedal), pedalName(name), bypassed(false)
-    {
-    }
-
-    ~PedalInstance()
-    {
-        // Note: We don't own the dspPedal pointer, it's managed by the pedalboard
-    }
-
-    void process(float** inputs, float** outputs, int numChannels, int numSamples)
-    {
-        if (bypassed)
-        {
-            // Just copy input to output
-            for (int ch = 0; ch < numChannels; ++ch)
-            {
-                std::copy(inputs[ch], inputs[ch] + numSamples, outputs[ch]);
-            }
-        }
-        else
-        {
-            // Process through DSP pedal
-            dspPedal->process(inputs, outputs, numChannels, numSamples);
-        }
-    }
-
-    void setBypass(bool bypass)
-    {
-        bypassed = bypass;
-    }
-
-    bool isBypassed() const { return bypassed; }
-
-    std::string getName() const { return pedalName; }
-
-    GuitarPedalPureDSP* getDSP() { return dspPedal; }
-
-    nlohmann::json getParameters() const
-    {
-        nlohmann::json params;
-        params["bypassed"] = bypassed;
-        params["parameters"] = nlohmann::json::array();
-
-        for (int i = 0; i < dspPedal->getNumParameters(); ++i)
-        {
-            nlohmann::json param;
-            param["index"] = i;
-
-            // Get parameter info
-            const auto* paramInfo = dspPedal->getParameter(i);
-            if (paramInfo)
-            {
-                param["name"] = paramInfo->name;
-                param["value"] = dspPedal->getParameterValue(i);
-            }
-
-            params["parameters"].push_back(param);
-        }
-
-        return params;
-    }
-
-    void setParameters(const nlohmann::json& params)
-    {
-        if (params.contains("bypassed"))
-        {
-            bypassed = params["bypassed"];
-        }
-
-        if (params.contains("parameters"))
-        {
-            for (const auto& param : params["parameters"])
-            {
-                int index = param["index"];
-                float value = param["value"];
-                dspPedal->setParameterValue(index, value);
-            }
-        }
-    }
-
-private:
-    GuitarPedalPureDSP* dspPedal;
-    std::string pedalName;
-    bool bypassed;
-};
-
 //==============================================================================
 /**
     Main plugin processor for the pedalboard
@@ -169,8 +76,14 @@ public:
     void removePedal(int position);
     void movePedal(int fromPosition, int toPosition);
 
-    int getNumPedals() const { return pedalChain.size(); }
-    PedalInstance* getPedal(int index) { return pedalChain[index].get(); }
+    int getNumPedals() const;
+
+    /** Read-only view of a live pedal; change it with the setters below */
+    const PedalInstance* getPedal(int index) const;
+
+    // Pedal edits (crossfade to a rebuilt chain; saved scenes are unaffected)
+    void setPedalParameter(int pedalIndex, int parameterIndex, float value);
+    void setPedalBypass(int pedalIndex, bool bypassed);
 
     // Preset management
     void savePreset(const std::string& presetName);
@@ -182,23 +95,15 @@ public:
 
 private:
     //==============================================================================
-    // Create a pedal instance by type
-    std::unique_ptr<PedalInstance> createPedalInstance(const std::string& pedalType);
-
-    // Pedal chain
-    std::vector<std::unique_ptr<PedalInstance>> pedalChain;
-
-    // All available pedal DSP instances (shared across pedalboard)
-    std::unique_ptr<VolumePedalPureDSP> volumeDSP;
-    std::unique_ptr<FuzzPedalPureDSP> fuzzDSP;
-    std::unique_ptr<OverdrivePedalPureDSP> overdriveDSP;
-    std::unique_ptr<CompressorPedalPureDSP> compressorDSP;
-    std::unique_ptr<EQPedalPureDSP> eqDSP;
-    std::unique_ptr<NoiseGatePedalPureDSP> noiseGateDSP;
-    std::unique_ptr<ChorusPedalPureDSP> chorusDSP;
-    std::unique_ptr<DelayPedalPureDSP> delayDSP;
-    std::unique_ptr<ReverbPedalPureDSP> reverbDSP;
-    // std::unique_ptr<BiPhasePedalPureDSP> phaserDSP;  // TODO: Fix BiPhaseDSP linking issues
+    // Create a new DSP instance by pedal type (nullptr if unknown)
+    static std::unique_ptr<GuitarPedalPureDSP> createPedalDSP(const std::string& pedalType);
+
+    // Current chain description, used as the starting point for edits
+    nlohmann::json describeLiveChain() const;
+
+    // Chain execution, prepared scenes and crossfades. Every pedal instance
+    // owns its DSP, so each scene keeps its own prepared state.
+    PedalboardEngine engine { &PedalboardProcessor::createPedalDSP };
 
     // Global parameters
     float inputLevel = 1.0f;
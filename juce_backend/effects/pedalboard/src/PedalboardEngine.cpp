@@ -0,0 +1,381 @@
+/*
+==============================================================================
+White Room Pedalboard Engine Implementation
+==============================================================================
+*/
+
+#include "PedalboardEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+}
+
+//==============================================================================
+nlohmann::json PedalChain::toJson() const
+{
+    nlohmann::json description;
+    description["pedals"] = nlohmann::json::array();
+
+    for (const auto& pedal : pedals)
+    {
+        nlohmann::json pedalData;
+        pedalData["type"] = pedal->getName();
+        pedalData["parameters"] = pedal->getParameters();
+        description["pedals"].push_back(pedalData);
+    }
+
+    return description;
+}
+
+void PedalChain::prepare(double sampleRate, int blockSize)
+{
+    for (auto& pedal : pedals)
+        pedal->prepare(sampleRate, blockSize);
+}
+
+void PedalChain::reset()
+{
+    for (auto& pedal : pedals)
+        pedal->getDSP()->reset();
+}
+
+//==============================================================================
+PedalboardEngine::PedalboardEngine(PedalFactory pedalFactory)
+    : factory(std::move(pedalFactory))
+{
+}
+
+PedalboardEngine::~PedalboardEngine()
+{
+    // The audio thread has stopped; drop its references so nothing dangles
+    pendingChain.store(nullptr);
+    currentChain = nullptr;
+    outgoingChain = nullptr;
+}
+
+//==============================================================================
+void PedalboardEngine::prepare(double newSampleRate, int newMaxBlockSize, int numChannels)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = std::max(1, newMaxBlockSize);
+    numPreparedChannels = std::clamp(numChannels, 1, (int) maxChannels);
+
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        ping[(size_t) ch].assign((size_t) maxBlockSize, 0.0f);
+        pong[(size_t) ch].assign((size_t) maxBlockSize, 0.0f);
+        fadeBuffer[(size_t) ch].assign((size_t) maxBlockSize, 0.0f);
+    }
+
+    // Equal-gain curve: the chains process the same input, so their outputs
+    // are largely correlated and sin^2 + cos^2 keeps the level constant
+    const int fadeLength = std::max(1, (int) std::lround(crossfadeSeconds * sampleRate));
+    fadeInCurve.resize((size_t) fadeLength);
+    for (int i = 0; i < fadeLength; ++i)
+    {
+        const double s = std::sin(0.5 * pi * (i + 1) / fadeLength);
+        fadeInCurve[(size_t) i] = (float) (s * s);
+    }
+
+    for (auto& chain : chains)
+    {
+        chain->prepare(sampleRate, maxBlockSize);
+        chain->reset();
+    }
+
+    // A fade interrupted by a device restart is simply completed
+    if (outgoingChain != nullptr)
+    {
+        release(outgoingChain);
+        outgoingChain = nullptr;
+        crossfading.store(false, std::memory_order_relaxed);
+    }
+}
+
+void PedalboardEngine::releaseResources()
+{
+    for (auto& chain : chains)
+        chain->reset();
+}
+
+void PedalboardEngine::setCrossfadeTime(double seconds)
+{
+    // Applied by the next prepare(); the curve is read by the audio thread
+    crossfadeSeconds = std::max(0.0, seconds);
+}
+
+//==============================================================================
+std::unique_ptr<PedalChain> PedalboardEngine::buildChain(const nlohmann::json& description) const
+{
+    auto chain = std::make_unique<PedalChain>();
+
+    if (!description.contains("pedals"))
+        return chain;
+
+    for (const auto& pedalData : description["pedals"])
+    {
+        if (!pedalData.contains("type"))
+            continue;
+
+        std::string pedalType = pedalData["type"];
+        auto dsp = factory(pedalType);
+        if (dsp == nullptr)
+            continue;
+
+        auto pedal = std::make_unique<PedalInstance>(std::move(dsp), pedalType);
+        pedal->prepare(sampleRate, maxBlockSize);
+        if (pedalData.contains("parameters"))
+            pedal->setParameters(pedalData["parameters"]);
+
+        // Settle smoothers on the loaded values so the chain starts clean
+        pedal->getDSP()->reset();
+        chain->pedals.push_back(std::move(pedal));
+    }
+
+    return chain;
+}
+
+void PedalboardEngine::setLiveChain(std::unique_ptr<PedalChain> chain)
+{
+    if (chain == nullptr)
+        return;
+
+    auto* raw = chain.get();
+    chains.push_back(std::move(chain));
+    post(raw);
+}
+
+bool PedalboardEngine::setLiveParameter(int pedalIndex, int parameterIndex, float value)
+{
+    if (liveChain == nullptr || pedalIndex < 0 || pedalIndex >= liveChain->getNumPedals())
+        return false;
+
+    auto* dsp = liveChain->pedals[(size_t) pedalIndex]->getDSP();
+    if (parameterIndex < 0 || parameterIndex >= dsp->getNumParameters())
+        return false;
+
+    dsp->setParameterValue(parameterIndex, value);
+    return true;
+}
+
+bool PedalboardEngine::setLiveBypass(int pedalIndex, bool bypassed)
+{
+    if (liveChain == nullptr || pedalIndex < 0 || pedalIndex >= liveChain->getNumPedals())
+        return false;
+
+    liveChain->pedals[(size_t) pedalIndex]->setBypass(bypassed);
+    return true;
+}
+
+void PedalboardEngine::prepareScene(int sceneNumber, const nlohmann::json& description)
+{
+    if (sceneNumber < 0 || sceneNumber >= numScenes)
+        return;
+
+    auto chain = buildChain(description);
+    sceneChains[(size_t) sceneNumber] = chain.get();
+    sceneDescriptions[(size_t) sceneNumber] = description;
+    chains.push_back(std::move(chain));
+
+    collectGarbage();
+}
+
+bool PedalboardEngine::hasScene(int sceneNumber) const
+{
+    return sceneNumber >= 0 && sceneNumber < numScenes
+        && sceneChains[(size_t) sceneNumber] != nullptr;
+}
+
+bool PedalboardEngine::switchToScene(int sceneNumber)
+{
+    if (!hasScene(sceneNumber))
+        return false;
+
+    // The prepared chain goes live as it is. From here on it belongs to the
+    // live chain, so the scene gets a new prepared copy of what was saved:
+    // edits to the live chain never reach the scene.
+    auto* chain = sceneChains[(size_t) sceneNumber];
+    sceneChains[(size_t) sceneNumber] = nullptr;
+
+    post(chain);
+    prepareScene(sceneNumber, sceneDescriptions[(size_t) sceneNumber]);
+    return true;
+}
+
+void PedalboardEngine::collectGarbage()
+{
+    chains.erase(std::remove_if(chains.begin(), chains.end(),
+        [this](const std::unique_ptr<PedalChain>& chain)
+        {
+            if (chain.get() == liveChain)
+                return false;
+
+            if (std::find(sceneChains.begin(), sceneChains.end(), chain.get()) != sceneChains.end())
+                return false;
+
+            // Acquire pairs with the audio thread's release in release()
+            return chain->audioUses.load(std::memory_order_acquire) == 0;
+        }),
+        chains.end());
+}
+
+void PedalboardEngine::post(PedalChain* chain)
+{
+    liveChain = chain;
+
+    // The reference travels with the pointer; the exchange publishes the
+    // fully built chain to the audio thread
+    chain->audioUses.fetch_add(1, std::memory_order_relaxed);
+    if (auto* unconsumed = pendingChain.exchange(chain, std::memory_order_acq_rel))
+        unconsumed->audioUses.fetch_sub(1, std::memory_order_release);
+
+    collectGarbage();
+}
+
+void PedalboardEngine::release(PedalChain* chain) noexcept
+{
+    if (chain != nullptr)
+        chain->audioUses.fetch_sub(1, std::memory_order_release);
+}
+
+//==============================================================================
+void PedalboardEngine::process(float* const* channels, int numHostChannels, int totalSamples) noexcept
+{
+    const int numChannels = std::min({ numHostChannels, numPreparedChannels, (int) maxChannels });
+
+    if (numChannels <= 0 || totalSamples <= 0 || ping[0].empty())
+        return;
+
+    float* host[maxChannels];
+
+    // Hosts may exceed the prepared block size; run in prepared-size chunks
+    for (int start = 0; start < totalSamples; start += maxBlockSize)
+    {
+        const int numSamples = std::min(maxBlockSize, totalSamples - start);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            host[ch] = channels[ch] + start;
+        for (int ch = numChannels; ch < maxChannels; ++ch)
+            host[ch] = host[0];
+
+        processChunk(host, numChannels, numSamples);
+    }
+}
+
+void PedalboardEngine::processChunk(float* const* host, int numChannels, int numSamples) noexcept
+{
+    // Chain changes are taken at a block boundary, one transition at a time;
+    // a request made during a fade waits in the slot until the fade ends
+    if (outgoingChain == nullptr)
+    {
+        if (auto* next = pendingChain.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            if (next == currentChain)
+            {
+                release(next);
+            }
+            else if (currentChain == nullptr)
+            {
+                currentChain = next;
+            }
+            else
+            {
+                outgoingChain = currentChain;
+                currentChain = next;
+                fadePosition = 0;
+                crossfading.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (currentChain == nullptr)
+        return;
+
+    if (outgoingChain == nullptr)
+    {
+        runChain(*currentChain, host, host, numChannels, numSamples);
+        return;
+    }
+
+    // Both chains read the untouched input: the outgoing one renders into the
+    // fade buffer first, then the incoming one runs in place
+    float* fade[maxChannels];
+    for (int ch = 0; ch < maxChannels; ++ch)
+        fade[ch] = fadeBuffer[(size_t) ch].data();
+
+    runChain(*outgoingChain, host, fade, numChannels, numSamples);
+    runChain(*currentChain, host, host, numChannels, numSamples);
+
+    const int fadeLength = (int) fadeInCurve.size();
+    const int fadeSamples = std::min(numSamples, std::max(0, fadeLength - fadePosition));
+    const float* curve = fadeInCurve.data() + fadePosition;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* out = host[ch];
+        const float* old = fade[ch];
+
+        for (int i = 0; i < fadeSamples; ++i)
+            out[i] = old[i] + curve[i] * (out[i] - old[i]);
+    }
+
+    fadePosition += numSamples;
+    if (fadePosition >= fadeLength)
+    {
+        release(outgoingChain);
+        outgoingChain = nullptr;
+        crossfading.store(false, std::memory_order_relaxed);
+    }
+}
+
+void PedalboardEngine::runChain(PedalChain& chain, float* const* host, float* const* destination,
+                                int numChannels, int numSamples) noexcept
+{
+    const int numPedals = chain.getNumPedals();
+
+    if (numPedals == 0)
+    {
+        if (destination != host)
+            for (int ch = 0; ch < numChannels; ++ch)
+                std::copy(host[ch], host[ch] + numSamples, destination[ch]);
+        return;
+    }
+
+    float* hostPtrs[maxChannels];
+    float* destinationPtrs[maxChannels];
+    float* pingPtrs[maxChannels];
+    float* pongPtrs[maxChannels];
+
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        hostPtrs[ch] = host[ch];
+        destinationPtrs[ch] = destination[ch];
+        pingPtrs[ch] = ping[(size_t) ch].data();
+        pongPtrs[ch] = pong[(size_t) ch].data();
+    }
+
+    // A single pedal writing back into its own input is not guaranteed to be
+    // safe, so it goes through ping and is copied back
+    const bool copyBack = (numPedals == 1 && destination == host);
+
+    float** input = hostPtrs;
+    for (int i = 0; i < numPedals; ++i)
+    {
+        float** output;
+        if (i == numPedals - 1 && !copyBack)
+            output = destinationPtrs;
+        else
+            output = (i % 2 == 0) ? pingPtrs : pongPtrs;
+
+        chain.pedals[(size_t) i]->process(input, output, numChannels, numSamples);
+        input = output;
+    }
+
+    if (copyBack)
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::copy(pingPtrs[ch], pingPtrs[ch] + numSamples, host[ch]);
+}
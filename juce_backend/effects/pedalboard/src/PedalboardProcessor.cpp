@@ -15,38 +15,15 @@ PedalboardProcessor::PedalboardProcessor()
         .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 #endif
 {
-    // Initialize all pedal DSP instances
-    volumeDSP = std::make_unique<VolumePedalPureDSP>();
-    fuzzDSP = std::make_unique<FuzzPedalPureDSP>();
-    overdriveDSP = std::make_unique<OverdrivePedalPureDSP>();
-    compressorDSP = std::make_unique<CompressorPedalPureDSP>();
-    eqDSP = std::make_unique<EQPedalPureDSP>();
-    noiseGateDSP = std::make_unique<NoiseGatePedalPureDSP>();
-    chorusDSP = std::make_unique<ChorusPedalPureDSP>();
-    delayDSP = std::make_unique<DelayPedalPureDSP>();
-    reverbDSP = std::make_unique<ReverbPedalPureDSP>();
-    // phaserDSP = std::make_unique<BiPhasePedalPureDSP>();  // TODO: Fix BiPhaseDSP linking issues
-
-    // Prepare all pedals with default settings
-    double defaultSampleRate = 48000.0;
-    int defaultBlockSize = 512;
-    volumeDSP->prepare(defaultSampleRate, defaultBlockSize);
-    fuzzDSP->prepare(defaultSampleRate, defaultBlockSize);
-    overdriveDSP->prepare(defaultSampleRate, defaultBlockSize);
-    compressorDSP->prepare(defaultSampleRate, defaultBlockSize);
-    eqDSP->prepare(defaultSampleRate, defaultBlockSize);
-    noiseGateDSP->prepare(defaultSampleRate, defaultBlockSize);
-    chorusDSP->prepare(defaultSampleRate, defaultBlockSize);
-    delayDSP->prepare(defaultSampleRate, defaultBlockSize);
-    reverbDSP->prepare(defaultSampleRate, defaultBlockSize);
-    // phaserDSP->prepare(defaultSampleRate, defaultBlockSize);  // TODO: Fix BiPhaseDSP linking issues
+    engine.prepare(48000.0, 512, 2);
 
     // Create default pedal chain
-    addPedal("Compressor", 0);
-    addPedal("EQ", 1);
-    addPedal("Chorus", 2);
-    addPedal("Delay", 3);
-    addPedal("Reverb", 4);
+    nlohmann::json chain;
+    chain["pedals"] = nlohmann::json::array();
+    for (const char* pedalType : { "Compressor", "EQ", "Chorus", "Delay", "Reverb" })
+        chain["pedals"].push_back({ { "type", pedalType } });
+
+    engine.setLiveChain(engine.buildChain(chain));
 }
 
 PedalboardProcessor::~PedalboardProcessor()
@@ -56,38 +33,15 @@ PedalboardProcessor::~PedalboardProcessor()
 //==============================================================================
 void PedalboardProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    // Prepare all DSP pedals with new sample rate and block size
-    volumeDSP->prepare(sampleRate, samplesPerBlock);
-    fuzzDSP->prepare(sampleRate, samplesPerBlock);
-    overdriveDSP->prepare(sampleRate, samplesPerBlock);
-    compressorDSP->prepare(sampleRate, samplesPerBlock);
-    eqDSP->prepare(sampleRate, samplesPerBlock);
-    noiseGateDSP->prepare(sampleRate, samplesPerBlock);
-    chorusDSP->prepare(sampleRate, samplesPerBlock);
-    delayDSP->prepare(sampleRate, samplesPerBlock);
-    reverbDSP->prepare(sampleRate, samplesPerBlock);
-    // phaserDSP->prepare(sampleRate, samplesPerBlock);  // TODO: Fix BiPhaseDSP linking issues
-
-    // Reset all pedals
-    volumeDSP->reset();
-    fuzzDSP->reset();
-    overdriveDSP->reset();
-    compressorDSP->reset();
-    eqDSP->reset();
-    noiseGateDSP->reset();
-    chorusDSP->reset();
-    delayDSP->reset();
-    reverbDSP->reset();
-    // phaserDSP->reset();  // TODO: Fix BiPhaseDSP linking issues
+    // Re-prepares and resets the live chain and every prepared scene, and
+    // allocates the ping-pong and crossfade buffers
+    engine.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
 }
 
 void PedalboardProcessor::releaseResources()
 {
     // Reset all pedals
-    for (auto& pedal : pedalChain)
-    {
-        pedal->getDSP()->reset();
-    }
+    engine.releaseResources();
 }
 
 //==============================================================================
@@ -108,25 +62,9 @@ void PedalboardProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     // Apply input level
     buffer.applyGain(inputLevel);
 
-    // Process through pedal chain
-    float* inputs[2];
-    float* outputs[2];
-
-    // Temporary buffers for processing
-    juce::AudioBuffer<float> tempBuffer = buffer;
-
-    for (auto& pedal : pedalChain)
-    {
-        inputs[0] = tempBuffer.getWritePointer(0);
-        inputs[1] = totalNumInputChannels > 1 ? tempBuffer.getWritePointer(1) : inputs[0];
-        outputs[0] = buffer.getWritePointer(0);
-        outputs[1] = totalNumInputChannels > 1 ? buffer.getWritePointer(1) : outputs[0];
-
-        pedal->process(inputs, outputs, totalNumInputChannels, buffer.getNumSamples());
-
-        // Copy output back to temp buffer for next pedal
-        tempBuffer.makeCopyOf(buffer);
-    }
+    // Process through pedal chain in place (no allocation, no copies between
+    // pedals); picks up scene switches and edits with a crossfade
+    engine.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
 
     // Apply dry/wet mix
     if (dryWetMix < 1.0f)
@@ -157,14 +95,7 @@ void PedalboardProcessor::getStateInformation(juce::MemoryBlock& destData)
     state["presetName"] = currentPresetName;
 
     // Save pedal chain
-    state["pedals"] = nlohmann::json::array();
-    for (const auto& pedal : pedalChain)
-    {
-        nlohmann::json pedalData;
-        pedalData["type"] = pedal->getName();
-        pedalData["parameters"] = pedal->getParameters();
-        state["pedals"].push_back(pedalData);
-    }
+    state["pedals"] = describeLiveChain()["pedals"];
 
     // Save scenes
     state["scenes"] = nlohmann::json::array();
@@ -201,92 +132,138 @@ void PedalboardProcessor::setStateInformation(const void* data, int sizeInBytes)
     // Load pedal chain
     if (state.contains("pedals"))
     {
-        pedalChain.clear();
-
-        for (const auto& pedalData : state["pedals"])
-        {
-            std::string pedalType = pedalData["type"];
-            addPedal(pedalType);
-
-            // Set parameters
-            if (pedalChain.size() > 0)
-            {
-                pedalChain.back()->setParameters(pedalData["parameters"]);
-            }
-        }
+        engine.setLiveChain(engine.buildChain(state));
     }
 
-    // Load scenes
+    // Load scenes and prepare their chains ahead of the first switch
     if (state.contains("scenes"))
     {
         for (size_t i = 0; i < scenes.size() && i < state["scenes"].size(); ++i)
         {
             scenes[i] = state["scenes"][i];
+
+            if (scenes[i].contains("pedals"))
+                engine.prepareScene((int) i, scenes[i]);
         }
     }
 }
 
 //==============================================================================
-std::unique_ptr<PedalInstance> PedalboardProcessor::createPedalInstance(const std::string& pedalType)
+std::unique_ptr<GuitarPedalPureDSP> PedalboardProcessor::createPedalDSP(const std::string& pedalType)
 {
     if (pedalType == "Volume")
-        return std::make_unique<PedalInstance>(volumeDSP.get(), "Volume");
+        return std::make_unique<VolumePedalPureDSP>();
     else if (pedalType == "Fuzz")
-        return std::make_unique<PedalInstance>(fuzzDSP.get(), "Fuzz");
+        return std::make_unique<FuzzPedalPureDSP>();
     else if (pedalType == "Overdrive")
-        return std::make_unique<PedalInstance>(overdriveDSP.get(), "Overdrive");
+        return std::make_unique<OverdrivePedalPureDSP>();
     else if (pedalType == "Compressor")
-        return std::make_unique<PedalInstance>(compressorDSP.get(), "Compressor");
+        return std::make_unique<CompressorPedalPureDSP>();
     else if (pedalType == "EQ")
-        return std::make_unique<PedalInstance>(eqDSP.get(), "EQ");
+        return std::make_unique<EQPedalPureDSP>();
     else if (pedalType == "Noise Gate")
-        return std::make_unique<PedalInstance>(noiseGateDSP.get(), "Noise Gate");
+        return std::make_unique<NoiseGatePedalPureDSP>();
     else if (pedalType == "Chorus")
-        return std::make_unique<PedalInstance>(chorusDSP.get(), "Chorus");
+        return std::make_unique<ChorusPedalPureDSP>();
     else if (pedalType == "Delay")
-        return std::make_unique<PedalInstance>(delayDSP.get(), "Delay");
+        return std::make_unique<DelayPedalPureDSP>();
     else if (pedalType == "Reverb")
-        return std::make_unique<PedalInstance>(reverbDSP.get(), "Reverb");
+        return std::make_unique<ReverbPedalPureDSP>();
     // else if (pedalType == "Phaser")
-    //     return std::make_unique<PedalInstance>(phaserDSP.get(), "Phaser");  // TODO: Fix BiPhaseDSP linking issues
+    //     return std::make_unique<BiPhasePedalPureDSP>();  // TODO: Fix BiPhaseDSP linking issues
     else
         return nullptr;
 }
 
+nlohmann::json PedalboardProcessor::describeLiveChain() const
+{
+    if (auto* chain = engine.getLiveChain())
+        return chain->toJson();
+
+    nlohmann::json description;
+    description["pedals"] = nlohmann::json::array();
+    return description;
+}
+
+int PedalboardProcessor::getNumPedals() const
+{
+    auto* chain = engine.getLiveChain();
+    return chain != nullptr ? chain->getNumPedals() : 0;
+}
+
+const PedalInstance* PedalboardProcessor::getPedal(int index) const
+{
+    auto* chain = engine.getLiveChain();
+    if (chain == nullptr || index < 0 || index >= chain->getNumPedals())
+        return nullptr;
+
+    return chain->pedals[(size_t) index].get();
+}
+
 //==============================================================================
+// Structural edits never touch the chain the audio thread is running: each
+// builds a new prepared chain (carrying over parameter values) and the engine
+// crossfades to it at the next block boundary. Parameter and bypass changes
+// go to the live pedals in place.
+
 void PedalboardProcessor::addPedal(const std::string& pedalType, int position)
 {
-    auto pedal = createPedalInstance(pedalType);
+    if (createPedalDSP(pedalType) == nullptr)
+        return;
+
+    auto description = describeLiveChain();
+    auto& pedals = description["pedals"];
 
-    if (pedal)
+    nlohmann::json pedalData;
+    pedalData["type"] = pedalType;
+
+    if (position < 0 || position >= (int)pedals.size())
     {
-        if (position < 0 || position >= (int)pedalChain.size())
-        {
-            pedalChain.push_back(std::move(pedal));
-        }
-        else
-        {
-            pedalChain.insert(pedalChain.begin() + position, std::move(pedal));
-        }
+        pedals.push_back(pedalData);
     }
+    else
+    {
+        pedals.insert(pedals.begin() + position, pedalData);
+    }
+
+    engine.setLiveChain(engine.buildChain(description));
+}
+
+void PedalboardProcessor::setPedalParameter(int pedalIndex, int parameterIndex, float value)
+{
+    engine.setLiveParameter(pedalIndex, parameterIndex, value);
+}
+
+void PedalboardProcessor::setPedalBypass(int pedalIndex, bool bypassed)
+{
+    engine.setLiveBypass(pedalIndex, bypassed);
 }
 
 void PedalboardProcessor::removePedal(int position)
 {
-    if (position >= 0 && position < (int)pedalChain.size())
+    auto description = describeLiveChain();
+    auto& pedals = description["pedals"];
+
+    if (position >= 0 && position < (int)pedals.size())
     {
-        pedalChain.erase(pedalChain.begin() + position);
+        pedals.erase(pedals.begin() + position);
+        engine.setLiveChain(engine.buildChain(description));
     }
 }
 
 void PedalboardProcessor::movePedal(int fromPosition, int toPosition)
 {
-    if (fromPosition >= 0 && fromPosition < (int)pedalChain.size() &&
-        toPosition >= 0 && toPosition < (int)pedalChain.size())
+    auto description = describeLiveChain();
+    auto& pedals = description["pedals"];
+
+    if (fromPosition >= 0 && fromPosition < (int)pedals.size() &&
+        toPosition >= 0 && toPosition < (int)pedals.size() &&
+        fromPosition != toPosition)
     {
-        auto pedal = std::move(pedalChain[fromPosition]);
-        pedalChain.erase(pedalChain.begin() + fromPosition);
-        pedalChain.insert(pedalChain.begin() + toPosition, std::move(pedal));
+        auto pedal = pedals[(size_t) fromPosition];
+        pedals.erase(pedals.begin() + fromPosition);
+        pedals.insert(pedals.begin() + toPosition, pedal);
+        engine.setLiveChain(engine.buildChain(description));
     }
 }
 
@@ -295,15 +272,7 @@ void PedalboardProcessor::savePreset(const std::string& presetName)
 {
     nlohmann::json preset;
     preset["name"] = presetName;
-    preset["pedals"] = nlohmann::json::array();
-
-    for (const auto& pedal : pedalChain)
-    {
-        nlohmann::json pedalData;
-        pedalData["type"] = pedal->getName();
-        pedalData["parameters"] = pedal->getParameters();
-        preset["pedals"].push_back(pedalData);
-    }
+    preset["pedals"] = describeLiveChain()["pedals"];
 
     // Save to file
     auto presetFile = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
@@ -334,19 +303,7 @@ void PedalboardProcessor::loadPreset(const std::string& presetName)
     // Load pedal chain
     if (preset.contains("pedals"))
     {
-        pedalChain.clear();
-
-        for (const auto& pedalData : preset["pedals"])
-        {
-            std::string pedalType = pedalData["type"];
-            addPedal(pedalType);
-
-            // Set parameters
-            if (pedalChain.size() > 0)
-            {
-                pedalChain.back()->setParameters(pedalData["parameters"]);
-            }
-        }
+        engine.setLiveChain(engine.buildChain(preset));
     }
 
     currentPresetName = presetName;
@@ -360,17 +317,13 @@ void PedalboardProcessor::saveScene(int sceneNumber, const std::string& sceneNam
 
     nlohmann::json scene;
     scene["name"] = sceneName;
-    scene["pedals"] = nlohmann::json::array();
-
-    for (const auto& pedal : pedalChain)
-    {
-        nlohmann::json pedalData;
-        pedalData["type"] = pedal->getName();
-        pedalData["parameters"] = pedal->getParameters();
-        scene["pedals"].push_back(pedalData);
-    }
+    scene["pedals"] = describeLiveChain()["pedals"];
 
     scenes[sceneNumber] = scene;
+
+    // Keep the scene's own pedal instances prepared so recalling it later is
+    // a handoff, not a rebuild
+    engine.prepareScene(sceneNumber, scene);
 }
 
 void PedalboardProcessor::loadScene(int sceneNumber)
@@ -378,25 +331,17 @@ void PedalboardProcessor::loadScene(int sceneNumber)
     if (sceneNumber < 0 || sceneNumber >= 8)
         return;
 
+    // Prepared scenes switch at the next block boundary with a crossfade
+    if (engine.switchToScene(sceneNumber))
+        return;
+
     const nlohmann::json& scene = scenes[sceneNumber];
 
     if (!scene.contains("pedals"))
         return;
 
-    // Load pedal chain
-    pedalChain.clear();
-
-    for (const auto& pedalData : scene["pedals"])
-    {
-        std::string pedalType = pedalData["type"];
-        addPedal(pedalType);
-
-        // Set parameters
-        if (pedalChain.size() > 0)
-        {
-            pedalChain.back()->setParameters(pedalData["parameters"]);
-        }
-    }
+    engine.prepareScene(sceneNumber, scene);
+    engine.switchToScene(sceneNumber);
 }
 
 //==============================================================================
@@ -0,0 +1,320 @@
+/*
+  ==============================================================================
+
+    PedalboardEngineTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Tests for the pedalboard execution engine
+    Checks chain processing, scene switching, crossfades, that edits to the
+    live chain never reach a saved scene, live parameter and bypass changes,
+    and that retired chains are freed
+
+  ==============================================================================
+*/
+
+#include "PedalboardEngine.h"
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace DSP;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 256;
+
+/** Stateless gain pedal: output = input * gain, so levels identify the chain */
+class GainPedal : public GuitarPedalPureDSP
+{
+public:
+    bool prepare(double newSampleRate, int) override
+    {
+        sampleRate_ = newSampleRate;
+        prepared_ = true;
+        return true;
+    }
+
+    void reset() override {}
+
+    void process(float** inputs, float** outputs, int numChannels, int numSamples) override
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                outputs[ch][i] = inputs[ch][i] * gain;
+    }
+
+    const char* getName() const override { return "Gain"; }
+    PedalCategory getCategory() const override { return PedalCategory::Dynamics; }
+
+    int getNumParameters() const override { return 1; }
+    const Parameter* getParameter(int index) const override { return index == 0 ? &parameter : nullptr; }
+    float getParameterValue(int index) const override { return index == 0 ? gain : 0.0f; }
+    void setParameterValue(int index, float value) override
+    {
+        if (index == 0)
+            gain = value;
+    }
+
+private:
+    Parameter parameter { "gain", "Gain", "", 0.0f, 4.0f, 1.0f, true, 0.0f };
+    float gain = 1.0f;
+};
+
+static std::unique_ptr<GuitarPedalPureDSP> createPedal(const std::string& type)
+{
+    if (type == "Gain")
+        return std::make_unique<GainPedal>();
+    return nullptr;
+}
+
+static nlohmann::json gainChain(std::vector<float> gains)
+{
+    nlohmann::json description;
+    description["pedals"] = nlohmann::json::array();
+    for (const float gain : gains)
+    {
+        nlohmann::json pedal;
+        pedal["type"] = "Gain";
+        pedal["parameters"]["parameters"] = { { { "index", 0 }, { "value", gain } } };
+        description["pedals"].push_back(pedal);
+    }
+    return description;
+}
+
+/** Runs one stereo block of constant 1.0 input; returns the left output */
+static std::vector<float> runBlock(PedalboardEngine& engine, int numSamples = blockSize)
+{
+    std::vector<float> left((size_t) numSamples, 1.0f), right((size_t) numSamples, 1.0f);
+    float* channels[] = { left.data(), right.data() };
+    engine.process(channels, 2, numSamples);
+    return left;
+}
+
+/** Level after any crossfade has finished */
+static float settledLevel(PedalboardEngine& engine)
+{
+    for (int i = 0; i < 8; ++i)
+        runBlock(engine);
+    return runBlock(engine).back();
+}
+
+static bool near(float a, float b)
+{
+    return std::abs(a - b) < 1.0e-4f;
+}
+
+//==============================================================================
+// Tests
+//==============================================================================
+
+static void testChainProcessing()
+{
+    std::cout << "\n=== Chain Processing ===" << std::endl;
+
+    PedalboardEngine engine(createPedal);
+    engine.prepare(sampleRate, blockSize, 2);
+
+    engine.setLiveChain(engine.buildChain(gainChain({ 2.0f, 0.5f, 3.0f })));
+    check(near(runBlock(engine).back(), 3.0f), "Pedals run in series through the ping-pong buffers");
+
+    engine.setLiveChain(engine.buildChain(gainChain({ 0.25f })));
+    check(near(settledLevel(engine), 0.25f), "A single pedal writes back into the host buffer");
+
+    auto unknown = gainChain({ 2.0f });
+    unknown["pedals"].push_back({ { "type", "Nonexistent" } });
+    engine.setLiveChain(engine.buildChain(unknown));
+    check(engine.getLiveChain()->getNumPedals() == 1 && near(settledLevel(engine), 2.0f),
+          "Unknown pedal types are skipped");
+
+    const auto oversized = runBlock(engine, blockSize * 3 + 17);
+    check(near(oversized.front(), 2.0f) && near(oversized.back(), 2.0f),
+          "Host blocks longer than prepared run in chunks");
+}
+
+static void testSceneSwitching()
+{
+    std::cout << "\n=== Scene Switching ===" << std::endl;
+
+    PedalboardEngine engine(createPedal);
+    engine.prepare(sampleRate, blockSize, 2);
+    engine.setLiveChain(engine.buildChain(gainChain({ 1.0f })));
+    settledLevel(engine);
+
+    engine.prepareScene(0, gainChain({ 0.5f }));
+    engine.prepareScene(1, gainChain({ 2.0f }));
+
+    check(engine.hasScene(0) && engine.hasScene(1) && !engine.hasScene(2), "Prepared scenes are known");
+    check(!engine.switchToScene(2) && !engine.switchToScene(-1), "Unprepared scenes do not switch");
+
+    check(engine.switchToScene(1) && near(settledLevel(engine), 2.0f), "Switching plays the scene");
+    check(engine.switchToScene(0) && near(settledLevel(engine), 0.5f), "Switching back plays the other scene");
+    check(engine.hasScene(1), "A scene that has played stays ready to recall");
+}
+
+static void testCrossfade()
+{
+    std::cout << "\n=== Crossfade ===" << std::endl;
+
+    PedalboardEngine engine(createPedal);
+    engine.setCrossfadeTime(0.02);
+    engine.prepare(sampleRate, blockSize, 2);
+
+    engine.setLiveChain(engine.buildChain(gainChain({ 1.0f })));
+    settledLevel(engine);
+    engine.prepareScene(0, gainChain({ 3.0f }));
+    engine.switchToScene(0);
+
+    // 20 ms at 48 kHz is 960 samples: four 256-sample blocks
+    std::vector<float> output;
+    for (int block = 0; block < 5; ++block)
+    {
+        const auto samples = runBlock(engine);
+        output.insert(output.end(), samples.begin(), samples.end());
+        if (block == 0)
+            check(engine.isCrossfading(), "The switch starts a crossfade at the block boundary");
+    }
+
+    bool monotonic = true, bounded = true;
+    for (size_t i = 1; i < output.size(); ++i)
+    {
+        monotonic = monotonic && output[i] >= output[i - 1] - 1.0e-6f;
+        bounded = bounded && output[i] >= 1.0f - 1.0e-6f && output[i] <= 3.0f + 1.0e-6f;
+    }
+
+    check(output.front() > 1.0f && output.front() < 1.01f, "The fade starts at the old chain's level");
+    check(monotonic && bounded, "The fade moves smoothly between the chains' levels");
+    check(near(output[959], 3.0f) && near(output.back(), 3.0f), "The fade lasts the crossfade time");
+    check(!engine.isCrossfading(), "The crossfade ends");
+
+    // Requests during a fade wait for it; the last one wins
+    engine.prepareScene(1, gainChain({ 0.5f }));
+    engine.prepareScene(2, gainChain({ 2.0f }));
+    engine.switchToScene(1);
+    runBlock(engine);
+    engine.switchToScene(2);
+    check(near(settledLevel(engine), 2.0f), "A switch made during a fade follows it");
+}
+
+static void testEditIsolation()
+{
+    std::cout << "\n=== Edit Isolation ===" << std::endl;
+
+    PedalboardEngine engine(createPedal);
+    engine.prepare(sampleRate, blockSize, 2);
+    engine.setLiveChain(engine.buildChain(gainChain({ 1.0f })));
+
+    engine.prepareScene(0, gainChain({ 0.5f }));
+    engine.prepareScene(1, gainChain({ 2.0f }));
+    engine.switchToScene(0);
+    settledLevel(engine);
+
+    // Edit the live chain the way the processor does: describe, change, rebuild
+    const auto* sceneLive = engine.getLiveChain();
+    auto edited = sceneLive->toJson();
+    edited["pedals"][0]["parameters"]["parameters"][0]["value"] = 1.5f;
+    engine.setLiveChain(engine.buildChain(edited));
+
+    check(engine.getLiveChain() != sceneLive && near(settledLevel(engine), 1.5f),
+          "An edit crossfades to a new chain");
+
+    engine.switchToScene(1);
+    settledLevel(engine);
+    engine.switchToScene(0);
+    check(near(settledLevel(engine), 0.5f), "Recalling the scene gives its saved state, not the edit");
+
+    // The chain that went live is not the scene's stored chain
+    const auto* liveBefore = engine.getLiveChain();
+    engine.switchToScene(0);
+    check(engine.getLiveChain() != liveBefore && near(settledLevel(engine), 0.5f),
+          "Each recall makes a separate copy live");
+
+    engine.setLiveBypass(0, true);
+    check(near(settledLevel(engine), 1.0f), "Bypass applies to the live chain");
+
+    engine.switchToScene(0);
+    check(near(settledLevel(engine), 0.5f), "Bypassing the live chain leaves the scene alone");
+}
+
+static void testLiveChanges()
+{
+    std::cout << "\n=== Live Parameter and Bypass Changes ===" << std::endl;
+
+    PedalboardEngine engine(createPedal);
+    engine.prepare(sampleRate, blockSize, 2);
+    engine.setLiveChain(engine.buildChain(gainChain({ 2.0f, 1.0f })));
+    engine.prepareScene(0, gainChain({ 0.5f, 1.0f }));
+    settledLevel(engine);
+
+    const auto* live = engine.getLiveChain();
+    check(engine.setLiveParameter(0, 0, 3.0f) && near(runBlock(engine).front(), 3.0f),
+          "A parameter change is heard from the next block");
+    check(engine.getLiveChain() == live && !engine.isCrossfading(),
+          "A parameter change does not rebuild or crossfade");
+    check(!engine.setLiveParameter(2, 0, 1.0f) && !engine.setLiveParameter(0, 1, 1.0f),
+          "Unknown pedals and parameters are rejected");
+
+    // 5 ms at 48 kHz is 240 samples
+    engine.setLiveBypass(0, true);
+    const auto ramp = runBlock(engine);
+    check(ramp.front() > 2.9f && near(ramp[239], 1.0f) && near(ramp.back(), 1.0f),
+          "Bypass ramps to the dry signal instead of stepping");
+    check(engine.getLiveChain() == live && !engine.isCrossfading(),
+          "Bypass does not rebuild or crossfade");
+
+    engine.setLiveBypass(0, false);
+    check(near(settledLevel(engine), 3.0f), "Engaging the pedal again ramps it back in");
+
+    engine.switchToScene(0);
+    check(near(settledLevel(engine), 0.5f), "Live changes never reach a saved scene");
+}
+
+static void testGarbageCollection()
+{
+    std::cout << "\n=== Chain Lifetime ===" << std::endl;
+
+    PedalboardEngine engine(createPedal);
+    engine.prepare(sampleRate, blockSize, 2);
+    engine.setLiveChain(engine.buildChain(gainChain({ 1.0f })));
+    engine.prepareScene(0, gainChain({ 0.5f }));
+    engine.prepareScene(1, gainChain({ 2.0f }));
+
+    for (int i = 0; i < 20; ++i)
+    {
+        engine.switchToScene(i % 2);
+        settledLevel(engine);
+    }
+
+    engine.collectGarbage();
+    check(engine.getNumChains() == 3, "Only the live chain and the two scenes stay alive");
+}
+
+int main()
+{
+    std::cout << "Pedalboard Engine Tests" << std::endl;
+
+    testChainProcessing();
+    testSceneSwitching();
+    testCrossfade();
+    testEditIsolation();
+    testLiveChanges();
+    testGarbageCollection();
+
+    std::cout << "\n" << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+#!/bin/bash
+# Build script for PedalboardEngineTests
+# Needs nlohmann/json on the include path (NLOHMANN_JSON_INCLUDE overrides)
+
+echo "Building PedalboardEngineTests..."
+
+JSON_INCLUDE=${NLOHMANN_JSON_INCLUDE:-/usr/local/include}
+
+# Compile the test
+g++ -O2 \
+    -I../include \
+    -I../../pedals/include \
+    -I"$JSON_INCLUDE" \
+    -std=c++17 \
+    PedalboardEngineTests.cpp \
+    ../src/PedalboardEngine.cpp \
+    ../../pedals/src/dsp/GuitarPedalPureDSP.cpp \
+    -o PedalboardEngineTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./PedalboardEngineTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -15,6 +15,7 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include <cmath>
 
 namespace DSP {
 
@@ -16,6 +16,8 @@
 #pragma once
 
 #include "dsp/GuitarPedalPureDSP.h"
+#include "dsp/PhaseVocoder.h"
+#include <memory>
 #include <vector>
 #include <array>
 
@@ -146,8 +148,9 @@ private:
 
     /**
      * Process shimmer reverb (octave up)
+     * @param octave The input an octave up, from the shimmer shifter
      */
-    float processShimmer(float input, int channel);
+    float processShimmer(float input, float octave, int channel);
 
     /**
      * Process modulated reverb
@@ -228,6 +231,11 @@ private:
     // Gate state
     float gateEnvelope_[2] = {0.0f, 0.0f};
 
+    // Shimmer octave shifter; its output lags the input by one frame
+    std::unique_ptr<PhaseVocoder> shimmerShifter_;
+    std::vector<float> shimmerBuffer_[2];
+    bool shimmerActive_ = false;
+
     //==============================================================================
     // Helper Methods
     //==============================================================================
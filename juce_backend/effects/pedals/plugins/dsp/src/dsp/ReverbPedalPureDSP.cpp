@@ -53,8 +53,13 @@ bool ReverbPedalPureDSP::prepare(double sampleRate, int blockSize)
 
         reverseBuffer_[ch].resize(MAX_DELAY_SAMPLES);
         std::fill(reverseBuffer_[ch].begin(), reverseBuffer_[ch].end(), 0.0f);
+
+        shimmerBuffer_[ch].resize(static_cast<size_t>(std::max(1, blockSize)));
     }
 
+    shimmerShifter_ = std::make_unique<PhaseVocoder>(PhaseVocoder::Mode::LowLatency, sampleRate, 2, std::max(1, blockSize));
+    shimmerShifter_->setPitchRatio(2.0);
+
     reset();
 
     return true;
@@ -84,6 +89,10 @@ void ReverbPedalPureDSP::reset()
     reverseFilling_[0] = true;
     reverseFilling_[1] = true;
 
+    if (shimmerShifter_)
+        shimmerShifter_->reset();
+    shimmerActive_ = false;
+
     // Clear delay lines
     for (int ch = 0; ch < 2; ++ch)
     {
@@ -103,6 +112,42 @@ void ReverbPedalPureDSP::reset()
 void ReverbPedalPureDSP::process(float** inputs, float** outputs,
                                 int numChannels, int numSamples)
 {
+    ReverbType type = static_cast<ReverbType>(params_.type);
+
+    // The shifter holds a frame of whatever it last saw; switching back to
+    // shimmer starts it from silence rather than replaying that frame
+    if (type != ReverbType::Shimmer)
+        shimmerActive_ = false;
+
+    if (type == ReverbType::Shimmer && shimmerShifter_)
+    {
+        if (!shimmerActive_)
+        {
+            shimmerShifter_->reset();
+            shimmerActive_ = true;
+        }
+
+        // The shifter works on whole blocks, so hosts sending more than
+        // the prepared block size are split
+        const int maxBlock = static_cast<int>(shimmerBuffer_[0].size());
+        if (numSamples > maxBlock)
+        {
+            for (int offset = 0; offset < numSamples; offset += maxBlock)
+            {
+                float* in[2] = { inputs[0] + offset, inputs[numChannels > 1 ? 1 : 0] + offset };
+                float* out[2] = { outputs[0] + offset, outputs[numChannels > 1 ? 1 : 0] + offset };
+                process(in, out, numChannels, std::min(maxBlock, numSamples - offset));
+            }
+            return;
+        }
+
+        // Octave up of the whole block before any output is written (the
+        // buffers may alias); mono feeds both shifter channels
+        const float* in[2] = { inputs[0], inputs[numChannels > 1 ? 1 : 0] };
+        float* octave[2] = { shimmerBuffer_[0].data(), shimmerBuffer_[1].data() };
+        shimmerShifter_->processBlock(in, octave, numSamples);
+    }
+
     for (int ch = 0; ch < numChannels; ++ch)
     {
         for (int i = 0; i < numSamples; ++i)
@@ -112,7 +157,6 @@ void ReverbPedalPureDSP::process(float** inputs, float** outputs,
             float wet = 0.0f;
 
             // Process based on reverb type
-            ReverbType type = static_cast<ReverbType>(params_.type);
 
             switch (type)
             {
@@ -129,7 +173,7 @@ void ReverbPedalPureDSP::process(float** inputs, float** outputs,
                     wet = processSpring(input, ch);
                     break;
                 case ReverbType::Shimmer:
-                    wet = processShimmer(input, ch);
+                    wet = processShimmer(input, shimmerBuffer_[ch][i], ch);
                     break;
                 case ReverbType::Modulated:
                     wet = processModulated(input, ch);
@@ -280,16 +324,13 @@ float ReverbPedalPureDSP::processSpring(float input, int channel)
     return output;
 }
 
-float ReverbPedalPureDSP::processShimmer(float input, int channel)
+float ReverbPedalPureDSP::processShimmer(float input, float octave, int channel)
 {
     // Shimmer reverb with octave-up effect
     float decaySamples = timeToSamples(params_.decay);
 
-    // Add octave-up shimmer
-    float shimmer = input * 2.0f;  // Simple octave simulation
-
-    // Write to delay line
-    delayLines_[channel][writeIndex_[channel]] = input + shimmer * 0.3f;
+    // Write to delay line with the octave-up shimmer
+    delayLines_[channel][writeIndex_[channel]] = input + octave * 0.3f;
     writeIndex_[channel] = (writeIndex_[channel] + 1) % MAX_DELAY_SAMPLES;
 
     // Read early reflections
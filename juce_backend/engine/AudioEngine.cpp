@@ -3,11 +3,11 @@
 #include <chrono>
 #include <thread>
 #include <algorithm>
+#include <cmath>
 
 AudioEngine::AudioEngine()
     : audioGraph(std::make_unique<juce::AudioProcessorGraph>()),
-      audioCallback(std::make_unique<AudioCallback>(*this)),
-      automationStartTime(std::chrono::high_resolution_clock::now())
+      audioCallback(std::make_unique<AudioCallback>(*this))
 {
     // Initialize audio graph
     audioGraph->setPlayConfigDetails(2, 2, 44100.0, 512);
@@ -15,13 +15,22 @@ AudioEngine::AudioEngine()
 
     // Set up processor player
     processorPlayer.setProcessor(audioGraph.get());
+
+    startTimer(250);
 }
 
 AudioEngine::~AudioEngine()
 {
+    stopTimer();
     shutdownAudio();
 }
 
+void AudioEngine::timerCallback()
+{
+    automation.collectRetired();
+    clipPlayback.collectRetired();
+}
+
 bool AudioEngine::initializeAudio()
 {
     auto* device = deviceManager.getCurrentAudioDevice();
@@ -220,6 +229,25 @@ int AudioEngine::loadPlugin(const juce::String& pluginPath)
         }
     }
 
+    if (pluginHostingMode == PluginHostingMode::OutOfProcess)
+    {
+        SchillingerEcosystem::Audio::OutOfProcessPluginHost::Config config;
+        config.pluginPaths = { pluginPath.toStdString() };
+
+        auto instance = std::make_unique<SchillingerEcosystem::Audio::IsolatedPluginInstance>(config);
+        instance->prepareToPlay(currentSampleRate, currentBufferSize);
+        if (!instance->getHost().isRunning())
+        {
+            juce::Logger::writeToLog("Plugin host failed to start: " + pluginPath);
+            return -1;
+        }
+
+        int pluginId = nextPluginId++;
+        loadedPlugins[pluginId] = std::move(instance);
+        juce::Logger::writeToLog("Isolated plugin loaded: " + pluginPath + " (ID: " + juce::String(pluginId) + ")");
+        return pluginId;
+    }
+
     int pluginId = nextPluginId++;
     // For now, just store the path and return an ID
     // Real plugin instances will be created in GREEN phase
@@ -242,6 +270,7 @@ void AudioEngine::unloadPlugin(int pluginId)
         if (paramIt != pluginParameters.end()) {
             pluginParameters.erase(paramIt);
         }
+        automation.clearPluginLanes(pluginId);
 
         juce::Logger::writeToLog("Mock plugin unloaded (ID: " + juce::String(pluginId) + ")");
     }
@@ -284,18 +313,47 @@ void AudioEngine::startPlayback()
 void AudioEngine::stopPlayback()
 {
     isPlayingState = false;
-    currentPosition = 0.0;
+    transportPosition = 0;
     juce::Logger::writeToLog("Playback stopped");
 }
 
 void AudioEngine::setPlaybackPosition(double seconds)
 {
-    currentPosition = seconds;
+    transportPosition = static_cast<int64_t>(std::llround(std::max(0.0, seconds) * automation.getSampleRate()));
 }
 
 double AudioEngine::getPlaybackPosition() const
 {
-    return currentPosition;
+    return static_cast<double>(transportPosition.load()) / automation.getSampleRate();
+}
+
+void AudioEngine::setLoopRange(double startSeconds, double endSeconds, bool enabled)
+{
+    const double sampleRate = automation.getSampleRate();
+
+    // The callback reads all three; disable first so it never sees a half-written range
+    loopEnabled = false;
+    loopStartSample = static_cast<int64_t>(std::llround(std::max(0.0, startSeconds) * sampleRate));
+    loopEndSample = static_cast<int64_t>(std::llround(std::max(0.0, endSeconds) * sampleRate));
+    loopEnabled = enabled && endSeconds > startSeconds;
+}
+
+void AudioEngine::setTransportSampleRate(double newSampleRate)
+{
+    // Called while the device is stopped; positions keep their time in seconds
+    const double previousRate = automation.getSampleRate();
+    if (newSampleRate <= 0.0 || newSampleRate == previousRate) {
+        return;
+    }
+
+    auto rescale = [=](std::atomic<int64_t>& samples) {
+        samples = static_cast<int64_t>(std::llround(static_cast<double>(samples.load()) * newSampleRate / previousRate));
+    };
+
+    automation.setSampleRate(newSampleRate);
+    rescale(transportPosition);
+    rescale(loopStartSample);
+    rescale(loopEndSample);
 }
 
 AudioEngine::AudioLevels AudioEngine::getCurrentAudioLevels() const
@@ -468,20 +526,49 @@ AudioEngine::PluginState AudioEngine::getPluginState(int pluginId) const
 bool AudioEngine::setParameterAutomation(int pluginId, const juce::String& parameterName,
                                        AutomationType type, float minVal, float maxVal, float frequency)
 {
-    // GREEN PHASE: Basic parameter automation implementation
     auto it = loadedPlugins.find(pluginId);
     if (it == loadedPlugins.end()) {
         return false;
     }
 
-    AutomationData automation;
-    automation.type = type;
-    automation.minValue = minVal;
-    automation.maxValue = maxVal;
-    automation.frequency = frequency;
-    automation.isActive = true;
+    const auto id = automation.registerParameter(pluginId, parameterName);
+    if (id == AutomationEngine::invalidId) {
+        return false;
+    }
+
+    // Each preset becomes a lane on the transport timeline, one cycle per 1 / frequency
+    const double period = 1.0 / std::max(0.001, static_cast<double>(frequency));
+    std::vector<AutomationPoint> points;
+    double repeatLength = period;
+
+    switch (type) {
+        case AutomationType::LFO:
+        {
+            // The same sine as before, starting at the centre and rising; 64
+            // linear segments per cycle stay within 0.1% of the range
+            constexpr int segments = 64;
+            points.reserve(segments + 1);
+            for (int i = 0; i <= segments; ++i) {
+                const double phase = static_cast<double>(i) / segments;
+                const float normalised = 0.5f + 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * phase));
+                points.push_back({ period * phase, minVal + normalised * (maxVal - minVal), AutomationCurve::Linear });
+            }
+            break;
+        }
+
+        case AutomationType::Envelope:
+            points = { { 0.0, minVal, AutomationCurve::Exponential },
+                       { period, maxVal, AutomationCurve::Linear } };
+            repeatLength = 0.0;
+            break;
+
+        case AutomationType::StepSequencer:
+            points = { { 0.0, minVal, AutomationCurve::Step },
+                       { period * 0.5, maxVal, AutomationCurve::Step } };
+            break;
+    }
 
-    parameterAutomations[std::make_pair(pluginId, parameterName)] = automation;
+    automation.setLane(id, std::move(points), repeatLength);
 
     juce::Logger::writeToLog("Parameter automation set: Plugin " + juce::String(pluginId) +
                             ", Param: " + parameterName + ", Type: " + juce::String((int)type));
@@ -491,23 +578,12 @@ bool AudioEngine::setParameterAutomation(int pluginId, const juce::String& param
 
 float AudioEngine::getParameterAutomationValue(int pluginId, const juce::String& parameterName) const
 {
-    auto key = std::make_pair(pluginId, parameterName);
-    auto it = parameterAutomations.find(key);
-
-    if (it != parameterAutomations.end() && it->second.isActive) {
-        const auto& automation = it->second;
-
-        // Simple LFO implementation
-        auto now = std::chrono::high_resolution_clock::now();
-        auto timeSinceStart = std::chrono::duration<double>(now - automationStartTime).count();
-
-        float phase = fmod(timeSinceStart * automation.frequency, 1.0);
-        float normalizedValue = 0.5f + 0.5f * std::sin(2.0 * M_PI * phase);
-
-        return automation.minValue + normalizedValue * (automation.maxValue - automation.minValue);
+    const auto id = automation.findParameter(pluginId, parameterName);
+    if (id == AutomationEngine::invalidId || !automation.hasLane(id)) {
+        return 0.0f; // Default value
     }
 
-    return 0.0f; // Default value
+    return automation.getValueAt(id, transportPosition.load());
 }
 
 bool AudioEngine::createPluginChain(const std::vector<int>& pluginIds)
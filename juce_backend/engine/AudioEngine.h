@@ -6,7 +6,12 @@
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_dsp/juce_dsp.h>
 
-class AudioEngine : public juce::ChangeBroadcaster
+#include "automation/AutomationEngine.h"
+#include "timeline/ClipPlaybackEngine.h"
+#include "hosting/OutOfProcessPluginHost.h"
+
+class AudioEngine : public juce::ChangeBroadcaster,
+                    private juce::Timer
 {
 public:
     AudioEngine();
@@ -55,6 +60,16 @@ public:
     std::vector<juce::String> getLoadedPlugins() const;
     bool setPluginParameter(int pluginId, const juce::String& parameterName, float value);
 
+    // Where newly loaded plugins run. OutOfProcess hosts each plugin in its own
+    // subprocess (Linux), so a crashing or stalling plugin only costs silence.
+    enum class PluginHostingMode
+    {
+        InProcess,
+        OutOfProcess
+    };
+    void setPluginHostingMode(PluginHostingMode mode) { pluginHostingMode = mode; }
+    PluginHostingMode getPluginHostingMode() const { return pluginHostingMode; }
+
     // Extended Plugin Management (GREEN Phase)
     struct PluginInfo {
         int pluginId;
@@ -77,15 +92,6 @@ public:
         StepSequencer
     };
 
-    struct AutomationData {
-        AutomationType type;
-        float minValue;
-        float maxValue;
-        float frequency;
-        float currentValue;
-        bool isActive;
-    };
-
     PluginInfo getPluginInfo(int pluginId) const;
     PluginState getPluginState(int pluginId) const;
     bool setParameterAutomation(int pluginId, const juce::String& parameterName,
@@ -101,10 +107,14 @@ public:
     void stopPlayback();
     void setPlaybackPosition(double seconds);
     double getPlaybackPosition() const;
+    void setLoopRange(double startSeconds, double endSeconds, bool enabled);
     bool isPlaying() const { return isPlayingState; }
     void setTempo(double bpm) { currentTempo = bpm; }
     double getTempo() const { return currentTempo; }
 
+    // Timeline clips, played on the transport and mixed into the output
+    ClipPlaybackEngine& getClipPlayback() { return clipPlayback; }
+
     // Audio Processing
     void audioProcessorParameterChanged(juce::AudioProcessor* processor, int parameterIndex, float newValue);
     void audioProcessorChanged(juce::AudioProcessor* processor, const juce::MemoryBlock& changeDetails);
@@ -123,18 +133,26 @@ public:
     bool saveSession(const juce::File& sessionFile);
 
 private:
+    // Frees automation lanes and clip lists retired by edits, so they do not
+    // wait for the next edit once playback has moved past them
+    void timerCallback() override;
+
     // Core Components
     juce::AudioDeviceManager deviceManager;
     std::unique_ptr<juce::AudioProcessorGraph> audioGraph;
     juce::AudioProcessorPlayer processorPlayer;
 
-    // Transport
-    bool isPlayingState = false;
+    // Transport, in samples at the automation sample rate; advanced by the audio callback
+    std::atomic<bool> isPlayingState { false };
     double currentTempo = 120.0;
-    double currentPosition = 0.0;
+    std::atomic<int64_t> transportPosition { 0 };
+    std::atomic<bool> loopEnabled { false };
+    std::atomic<int64_t> loopStartSample { 0 };
+    std::atomic<int64_t> loopEndSample { 0 };
 
     // Plugin Management
     std::map<int, std::unique_ptr<juce::AudioPluginInstance>> loadedPlugins;
+    PluginHostingMode pluginHostingMode = PluginHostingMode::InProcess;
     std::map<int, std::map<juce::String, float>> pluginParameters; // Store actual parameter values
     int nextPluginId = 0;
 
@@ -153,6 +171,8 @@ private:
         void audioDeviceAboutToStart(juce::AudioIODevice* device)
         {
             owner.processorPlayer.audioDeviceAboutToStart(device);
+            owner.setTransportSampleRate(device->getCurrentSampleRate());
+            owner.clipPlayback.prepare(device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
         }
 
         void audioDeviceStopped()
@@ -164,6 +184,14 @@ private:
                                   float** outputChannelData, int numOutputChannels,
                                   int numSamples)
         {
+            // Automation and clips read the block's transport range while pinned
+            const bool playing = owner.isPlayingState.load();
+            const int64_t position = owner.transportPosition.load();
+            const AutomationTransport transport { position, numSamples, owner.loopEnabled.load(),
+                                                  owner.loopStartSample.load(), owner.loopEndSample.load() };
+            owner.automation.beginBlock(transport);
+            owner.clipPlayback.beginBlock(transport);
+
             // Process audio through the graph directly
             if (auto* processor = owner.processorPlayer.getCurrentProcessor())
             {
@@ -175,6 +203,20 @@ private:
                 owner.processedSamplesCount.fetch_add(numSamples);
             }
 
+            // Clips are mixed after the graph until tracks are routed through it
+            if (playing)
+                owner.clipPlayback.renderAllTracks(outputChannelData, numOutputChannels);
+
+            owner.clipPlayback.endBlock();
+            owner.automation.endBlock();
+
+            // A seek from the message thread during the block wins
+            if (playing)
+            {
+                int64_t expected = position;
+                owner.transportPosition.compare_exchange_strong(expected, transport.getNextPosition());
+            }
+
             // Monitor audio levels
             owner.updateAudioLevels(outputChannelData, numOutputChannels, numSamples);
         }
@@ -196,16 +238,17 @@ private:
     std::vector<DeviceChangeListener*> deviceChangeListeners;
 
     // Plugin automation and chain management
-    std::map<std::pair<int, juce::String>, AutomationData> parameterAutomations;
+    AutomationEngine automation;
+    ClipPlaybackEngine clipPlayback;
     std::vector<std::vector<int>> pluginChains;
     std::atomic<int> processedSamplesCount{0};
-    std::chrono::high_resolution_clock::time_point automationStartTime;
 
     // GREEN PHASE: Signal processing simulation
     bool signalProcessingActive = false; // Track when plugin chain is processing
     mutable int getAudioLevelsCallCount = 0; // Track calls to simulate signal flow
 
     void updateAudioLevels(float** outputChannelData, int numOutputChannels, int numSamples);
+    void setTransportSampleRate(double newSampleRate);
     void updateLevelSmoothing(float leftRMS, float rightRMS, float leftPeak, float rightPeak);
 
     // Device change notification
@@ -41,7 +41,7 @@ float ADSREnvelope::getNextValue() noexcept {
 
     // Update performance monitoring
     peakValue = std::max(peakValue, currentValue);
-    averageValue = (averageValue * samplesProcessed + currentValue) / (samplesProcessed + 1);
+    valueSum += currentValue;
     samplesProcessed++;
 
     return currentValue;
@@ -74,6 +74,9 @@ void ADSREnvelope::noteOn(int midiNote, float velocity, bool accent) {
     currentVelocity = velocity;
     currentAccent = accent;
 
+    // Parameter changes take effect from the next note
+    applyPendingParams();
+
     // Apply velocity and accent to parameters
     applyVelocityAndAccent();
 
@@ -106,7 +109,7 @@ void ADSREnvelope::reset() noexcept {
     currentAccent = false;
 
     peakValue = 0.0f;
-    averageValue = 0.0f;
+    valueSum = 0.0;
     samplesProcessed = 0;
 
     modulationPhase = 0.0f;
@@ -117,7 +120,6 @@ void ADSREnvelope::reset() noexcept {
     decayTargetValue = 0.7f;
     releaseStartValue = 0.7f;
 
-    paramsChanged = false;
     needsRecalculation = true;
 }
 
@@ -304,10 +306,26 @@ void ADSREnvelope::updateRelease() noexcept {
 void ADSREnvelope::updateIdle() noexcept {
     currentValue = 0.0f;
     peakValue = 0.0f;
-    averageValue = 0.0f;
+    valueSum = 0.0;
     samplesProcessed = 0;
 }
 
+void ADSREnvelope::applyPendingParams() noexcept {
+    if (paramsChanged) {
+        currentParams = targetParams;
+        smoothedAttack = targetParams.attack;
+        smoothedDecay = targetParams.decay;
+        smoothedSustain = targetParams.sustain;
+        smoothedRelease = targetParams.release;
+        paramsChanged = false;
+        needsRecalculation = true;
+    }
+
+    if (needsRecalculation) {
+        calculateStageRates();
+    }
+}
+
 void ADSREnvelope::calculateStageRates() noexcept {
     attackRate = timeToSamples(smoothedAttack);
     decayRate = timeToSamples(smoothedDecay);
@@ -330,6 +348,8 @@ void ADSREnvelope::applyVelocityAndAccent() noexcept {
     // Apply velocity to envelope parameters
     effectiveSustain = smoothedSustain * velocityFactor;
     attackTargetValue = velocityFactor; // Attack peak affected by velocity
+    decayStartValue = attackTargetValue;
+    decayTargetValue = effectiveSustain;
 
     // Adjust timing slightly with velocity
     float velocityTimeFactor = 1.0f + (1.0f - velocityFactor) * 0.3f;
@@ -357,7 +377,7 @@ void ADSREnvelope::startStage(EnvelopeStage newStage) noexcept {
     // Reset progress monitoring
     if (newStage == EnvelopeStage::Attack) {
         peakValue = 0.0f;
-        averageValue = 0.0f;
+        valueSum = 0.0;
         samplesProcessed = 0;
     }
 }
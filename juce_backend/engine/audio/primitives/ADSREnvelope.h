@@ -1,7 +1,7 @@
 #pragma once
 
-#include <juce_audio_utils/juce_audio_utils.h>
-#include <juce_dsp/juce_dsp.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
 #include <chrono>
 
 /**
@@ -86,7 +86,9 @@ public:
 
     // Performance monitoring
     float getPeakValue() const noexcept { return peakValue; }
-    float getAverageValue() const noexcept { return averageValue; }
+    float getAverageValue() const noexcept {
+        return samplesProcessed > 0 ? static_cast<float>(valueSum / samplesProcessed) : 0.0f;
+    }
 
     // Audio rate modulation
     void setModulationAmount(float modAmount) noexcept { modulationAmount = modAmount; }
@@ -108,6 +110,7 @@ private:
     void updateIdle() noexcept;
 
     // Parameter calculation
+    void applyPendingParams() noexcept;
     void calculateStageRates() noexcept;
     void applyVelocityAndAccent() noexcept;
     float calculateStageValue(float progress, float start, float end, float curve) const noexcept;
@@ -145,7 +148,7 @@ private:
 
     // Performance monitoring
     float peakValue = 0.0f;
-    float averageValue = 0.0f;
+    double valueSum = 0.0;          // Mean is taken on read
     int samplesProcessed = 0;
 
     // Audio rate modulation
@@ -0,0 +1,265 @@
+#include "SegmentEnvelopeBank.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Overshoot of a curved segment's target, relative to the segment's span:
+// curve 1 is strongly exponential, curve near 0 almost linear
+float curveToOvershootRatio(float curve) noexcept {
+    return 0.001f * std::pow(1.0e5f, 1.0f - juce::jlimit(0.0f, 1.0f, curve));
+}
+
+} // namespace
+
+//==============================================================================
+// SegmentEnvelopeBank Implementation
+//==============================================================================
+
+SegmentEnvelopeBank::SegmentEnvelopeBank() {
+    reset();
+}
+
+void SegmentEnvelopeBank::prepare(double newSampleRate, int newMaxBlockSize, int newNumVoices) {
+    sampleRate = newSampleRate;
+    maxBlockSize = std::max(1, newMaxBlockSize);
+    numVoices = juce::jlimit(0, maxVoices, newNumVoices);
+    numLanes = (numVoices + laneCount - 1) / laneCount * laneCount;
+
+    frames.assign(static_cast<size_t>(maxBlockSize) * static_cast<size_t>(std::max(1, numLanes)), 0.0f);
+    reset();
+}
+
+void SegmentEnvelopeBank::reset() noexcept {
+    for (int voice = 0; voice < maxVoices; ++voice) {
+        value[voice] = 0.0f;
+        hold(voice, Stage::Idle, 0.0f);
+        peakLevel[voice] = 1.0f;
+        sustainLevel[voice] = currentParams.sustain;
+    }
+
+    numEvents = 0;
+    std::fill(frames.begin(), frames.end(), 0.0f);
+}
+
+void SegmentEnvelopeBank::setParams(const ADSREnvelope::ADSRParams& params) noexcept {
+    currentParams = params;
+    currentParams.attack = juce::jlimit(0.0f, 10.0f, params.attack);
+    currentParams.decay = juce::jlimit(0.0f, 10.0f, params.decay);
+    currentParams.sustain = juce::jlimit(0.0f, 1.0f, params.sustain);
+    currentParams.release = juce::jlimit(0.0f, 10.0f, params.release);
+}
+
+//==============================================================================
+void SegmentEnvelopeBank::noteOn(int voice, int sampleOffset, float velocity, bool accent) noexcept {
+    queueEvent({ sampleOffset, voice, velocity, true, accent });
+}
+
+void SegmentEnvelopeBank::noteOff(int voice, int sampleOffset) noexcept {
+    queueEvent({ sampleOffset, voice, 0.0f, false, false });
+}
+
+void SegmentEnvelopeBank::queueEvent(const GateEvent& event) noexcept {
+    jassert(numEvents < maxEvents);
+    if (event.voice < 0 || event.voice >= numVoices || numEvents >= maxEvents) {
+        return;
+    }
+
+    // Insertion keeps events ordered by offset and stable for equal offsets
+    int index = numEvents++;
+    while (index > 0 && events[index - 1].offset > event.offset) {
+        events[index] = events[index - 1];
+        --index;
+    }
+    events[index] = event;
+}
+
+void SegmentEnvelopeBank::applyEvent(const GateEvent& event) noexcept {
+    const int voice = event.voice;
+
+    if (event.on) {
+        // Same velocity/accent scaling as ADSREnvelope
+        float velocityFactor = 1.0f;
+        if (currentParams.velocitySensitivity) {
+            velocityFactor = 0.3f + juce::jlimit(0.0f, 1.0f, event.velocity) * currentParams.velocityAmount * 0.7f;
+        }
+        if (event.accent) {
+            velocityFactor *= currentParams.accentAmount;
+        }
+
+        peakLevel[voice] = velocityFactor;
+        sustainLevel[voice] = currentParams.sustain * velocityFactor;
+        const float velocityTimeFactor = 1.0f + (1.0f - velocityFactor) * 0.3f;
+
+        // A retrigger only covers the remaining distance to the peak
+        const float remainingFraction = (velocityFactor > 0.0f)
+            ? juce::jlimit(0.0f, 1.0f, (velocityFactor - value[voice]) / velocityFactor)
+            : 0.0f;
+        startSegment(voice, Stage::Attack, velocityFactor,
+                     currentParams.attack * velocityTimeFactor * remainingFraction, currentParams.attackCurve);
+    } else if (stage[voice] != Stage::Idle && stage[voice] != Stage::Release) {
+        startSegment(voice, Stage::Release, 0.0f, currentParams.release, currentParams.releaseCurve);
+    }
+}
+
+//==============================================================================
+void SegmentEnvelopeBank::process(int numSamples) noexcept {
+    jassert(numSamples <= maxBlockSize);
+    numSamples = std::min(numSamples, maxBlockSize);
+
+    if (numSamples <= 0 || numLanes == 0) {
+        return;
+    }
+
+    int position = 0;
+    int eventIndex = 0;
+
+    while (position < numSamples) {
+        // Events at or before this sample (late ones land on the last sample)
+        while (eventIndex < numEvents && std::min(events[eventIndex].offset, numSamples - 1) <= position) {
+            applyEvent(events[eventIndex++]);
+        }
+
+        const int runEnd = (eventIndex < numEvents)
+            ? std::max(position + 1, std::min(events[eventIndex].offset, numSamples - 1))
+            : numSamples;
+
+        renderRun(position, runEnd);
+        position = runEnd;
+    }
+
+    numEvents = 0;
+}
+
+void SegmentEnvelopeBank::renderRun(int start, int end) noexcept {
+    // Local copies let the lane loop vectorize without aliasing the output
+    alignas(32) float v[maxVoices];
+    alignas(32) float mul[maxVoices];
+    alignas(32) float add[maxVoices];
+    std::copy(value.begin(), value.begin() + numLanes, v);
+    std::copy(mulCoeff.begin(), mulCoeff.begin() + numLanes, mul);
+    std::copy(addCoeff.begin(), addCoeff.begin() + numLanes, add);
+
+    int position = start;
+    while (position < end) {
+        // The run lasts until the first voice reaches a segment boundary
+        int length = end - position;
+        for (int lane = 0; lane < numLanes; ++lane) {
+            length = std::min(length, remaining[lane]);
+        }
+
+        float* frame = frames.data() + static_cast<size_t>(position) * static_cast<size_t>(numLanes);
+        for (int i = 0; i < length; ++i) {
+            for (int lane = 0; lane < numLanes; ++lane) {
+                v[lane] = v[lane] * mul[lane] + add[lane];
+                frame[lane] = v[lane];
+            }
+            frame += numLanes;
+        }
+
+        position += length;
+
+        bool boundary = false;
+        for (int lane = 0; lane < numLanes; ++lane) {
+            remaining[lane] -= length;
+            boundary = boundary || remaining[lane] == 0;
+        }
+
+        if (boundary) {
+            // The segment's last sample is its end value, without the
+            // rounding the recurrence has picked up on the way
+            float* last = frames.data() + static_cast<size_t>(position - 1) * static_cast<size_t>(numLanes);
+            for (int lane = 0; lane < numLanes; ++lane) {
+                if (remaining[lane] == 0) {
+                    last[lane] = endValue[lane];
+                    advanceStage(lane);
+                    v[lane] = value[lane];
+                    mul[lane] = mulCoeff[lane];
+                    add[lane] = addCoeff[lane];
+                }
+            }
+        }
+    }
+
+    std::copy(v, v + numLanes, value.begin());
+}
+
+void SegmentEnvelopeBank::advanceStage(int voice) noexcept {
+    // Land exactly on the segment's end value
+    value[voice] = endValue[voice];
+
+    switch (stage[voice]) {
+        case Stage::Attack:
+            startSegment(voice, Stage::Decay, sustainLevel[voice], currentParams.decay, currentParams.decayCurve);
+            break;
+        case Stage::Decay:
+        case Stage::Sustain:
+            hold(voice, Stage::Sustain, sustainLevel[voice]);
+            break;
+        case Stage::Release:
+        case Stage::Idle:
+        default:
+            hold(voice, Stage::Idle, 0.0f);
+            break;
+    }
+}
+
+void SegmentEnvelopeBank::startSegment(int voice, Stage newStage, float target, float seconds, float curve) noexcept {
+    const int length = std::max(1, static_cast<int>(std::lround(seconds * sampleRate)));
+    const float from = value[voice];
+    const float span = target - from;
+
+    if (curve <= 0.0f || std::abs(span) < 1.0e-6f) {
+        mulCoeff[voice] = 1.0f;
+        addCoeff[voice] = span / static_cast<float>(length);
+    } else {
+        // Head for a target past the end value; after length samples the
+        // remaining distance has shrunk by ratio / (1 + ratio), which is
+        // exactly the end value
+        const float ratio = curveToOvershootRatio(curve);
+        const float overshootTarget = target + span * ratio;
+        const float coeff = static_cast<float>(std::pow(ratio / (1.0 + ratio), 1.0 / length));
+        mulCoeff[voice] = coeff;
+        addCoeff[voice] = overshootTarget * (1.0f - coeff);
+    }
+
+    stage[voice] = newStage;
+    endValue[voice] = target;
+    remaining[voice] = length;
+}
+
+void SegmentEnvelopeBank::hold(int voice, Stage newStage, float level) noexcept {
+    stage[voice] = newStage;
+    value[voice] = level;
+    endValue[voice] = level;
+    mulCoeff[voice] = 1.0f;
+    addCoeff[voice] = 0.0f;
+    remaining[voice] = holdLength;
+}
+
+//==============================================================================
+void SegmentEnvelopeBank::copyVoice(int voice, float* destination, int numSamples) const noexcept {
+    const float* source = getVoiceOutput(voice);
+    for (int i = 0; i < numSamples; ++i) {
+        destination[i] = source[static_cast<size_t>(i) * static_cast<size_t>(numLanes)];
+    }
+}
+
+void SegmentEnvelopeBank::applyToVoice(int voice, float* audio, int numSamples) const noexcept {
+    const float* source = getVoiceOutput(voice);
+    for (int i = 0; i < numSamples; ++i) {
+        audio[i] *= source[static_cast<size_t>(i) * static_cast<size_t>(numLanes)];
+    }
+}
+
+bool SegmentEnvelopeBank::isVoiceActive(int voice) const noexcept {
+    return voice >= 0 && voice < numVoices && stage[voice] != Stage::Idle;
+}
+
+ADSREnvelope::EnvelopeStage SegmentEnvelopeBank::getVoiceStage(int voice) const noexcept {
+    return (voice >= 0 && voice < numVoices) ? stage[voice] : Stage::Idle;
+}
+
+float SegmentEnvelopeBank::getCurrentValue(int voice) const noexcept {
+    return (voice >= 0 && voice < numVoices) ? value[voice] : 0.0f;
+}
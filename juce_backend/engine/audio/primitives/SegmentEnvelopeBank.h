@@ -0,0 +1,104 @@
+#pragma once
+
+#include "ADSREnvelope.h"
+
+#include <array>
+#include <limits>
+#include <vector>
+
+/**
+ * ADSR envelopes for a whole bank of voices, rendered as closed-form segments
+ *
+ * Every stage is the affine recurrence v = v * mul + add over a length that
+ * is known when the stage starts: linear stages step by a constant, curved
+ * stages approach an overshoot target geometrically and land exactly on the
+ * stage's end value after the stage time. Sustain and idle hold a constant.
+ *
+ * A block is cut only where some voice reaches a segment boundary or a gate
+ * event lands; in between every voice repeats its multiply-add, with the
+ * voices in SIMD lanes and no per-sample branching. Gate events carry a
+ * sample offset into the next block and take effect exactly there.
+ *
+ * Output is frame-major (stride getStride()); read a voice with
+ * getVoiceOutput(), copyVoice() or applyToVoice().
+ */
+class SegmentEnvelopeBank {
+public:
+    static constexpr int laneCount = 8;
+    static constexpr int maxVoices = 64;
+    static constexpr int maxEvents = 256;
+
+    SegmentEnvelopeBank();
+    ~SegmentEnvelopeBank() = default;
+
+    // Setup (not real-time safe)
+    void prepare(double newSampleRate, int newMaxBlockSize, int numVoices);
+    void reset() noexcept;
+
+    // Shared parameters; a running stage keeps its shape, the next one uses these
+    void setParams(const ADSREnvelope::ADSRParams& params) noexcept;
+    const ADSREnvelope::ADSRParams& getParams() const noexcept { return currentParams; }
+
+    // Gate events for the next process() call, sampleOffset from its start.
+    // A retrigger starts the attack from the current value.
+    void noteOn(int voice, int sampleOffset, float velocity = 1.0f, bool accent = false) noexcept;
+    void noteOff(int voice, int sampleOffset) noexcept;
+
+    // Render numSamples (up to the prepared block size) for every voice
+    void process(int numSamples) noexcept;
+
+    // Output of the last block
+    const float* getVoiceOutput(int voice) const noexcept { return frames.data() + voice; }
+    int getStride() const noexcept { return numLanes; }
+    void copyVoice(int voice, float* destination, int numSamples) const noexcept;
+    void applyToVoice(int voice, float* audio, int numSamples) const noexcept;
+
+    // Voice state
+    bool isVoiceActive(int voice) const noexcept;
+    ADSREnvelope::EnvelopeStage getVoiceStage(int voice) const noexcept;
+    float getCurrentValue(int voice) const noexcept;
+
+private:
+    using Stage = ADSREnvelope::EnvelopeStage;
+
+    struct GateEvent {
+        int offset;
+        int voice;
+        float velocity;
+        bool on;
+        bool accent;
+    };
+
+    static constexpr int holdLength = std::numeric_limits<int>::max();
+
+    void queueEvent(const GateEvent& event) noexcept;
+    void applyEvent(const GateEvent& event) noexcept;
+    void renderRun(int start, int end) noexcept;
+    void advanceStage(int voice) noexcept;
+    void startSegment(int voice, Stage stage, float target, float seconds, float curve) noexcept;
+    void hold(int voice, Stage stage, float level) noexcept;
+
+    ADSREnvelope::ADSRParams currentParams;
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int numVoices = 0;
+    int numLanes = 0;               // numVoices rounded up to laneCount
+
+    // Per-voice segment state, one lane per voice
+    alignas(32) std::array<float, maxVoices> value {};
+    alignas(32) std::array<float, maxVoices> mulCoeff {};
+    alignas(32) std::array<float, maxVoices> addCoeff {};
+    alignas(32) std::array<int, maxVoices> remaining {};
+    std::array<float, maxVoices> endValue {};
+    std::array<float, maxVoices> peakLevel {};
+    std::array<float, maxVoices> sustainLevel {};
+    std::array<Stage, maxVoices> stage {};
+
+    // Gate events for the next block, ordered by offset
+    std::array<GateEvent, maxEvents> events {};
+    int numEvents = 0;
+
+    std::vector<float> frames;      // maxBlockSize x numLanes
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SegmentEnvelopeBank)
+};
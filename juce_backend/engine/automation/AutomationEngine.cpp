@@ -0,0 +1,539 @@
+#include "AutomationEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    constexpr int64_t endOfTimeline = std::numeric_limits<int64_t>::max();
+
+    int64_t firstSampleAtOrAfter(double position) noexcept
+    {
+        return static_cast<int64_t>(std::ceil(position));
+    }
+
+    // Repeat cycles shorter than a sample are treated as non-repeating
+    double repeatSamples(const AutomationLane& lane, double sampleRate) noexcept
+    {
+        const double length = lane.getRepeatLength() * sampleRate;
+        return length >= 1.0 ? length : 0.0;
+    }
+
+    // 2^x from plain arithmetic. Under fast-math a library exp2 gets a
+    // vector variant that rounds differently from the scalar one, which would
+    // make values depend on where a block happens to split a ramp.
+    float exp2Arithmetic(float x) noexcept
+    {
+        x = std::min(126.0f, std::max(-126.0f, x));
+        const float whole = std::floor(x + 0.5f);
+        const float f = (x - whole) * 0.69314718f;      // |f| <= ln(2) / 2
+
+        // Taylor series of e^f, accurate to float precision on that range
+        float p = 1.0f / 5040.0f;
+        p = p * f + 1.0f / 720.0f;
+        p = p * f + 1.0f / 120.0f;
+        p = p * f + 1.0f / 24.0f;
+        p = p * f + 1.0f / 6.0f;
+        p = p * f + 0.5f;
+        p = p * f + 1.0f;
+        p = p * f + 1.0f;
+
+        const int32_t exponentBits = (static_cast<int32_t>(whole) + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &exponentBits, sizeof(scale));
+        return p * scale;
+    }
+}
+
+//==============================================================================
+int64_t AutomationTransport::getNextPosition() const noexcept
+{
+    int64_t position = startSample + numSamples;
+
+    if (looping && loopEndSample > loopStartSample && startSample < loopEndSample)
+    {
+        const int64_t loopLength = loopEndSample - loopStartSample;
+        if (position >= loopEndSample)
+            position = loopStartSample + (position - loopEndSample) % loopLength;
+    }
+
+    return position;
+}
+
+//==============================================================================
+AutomationLane::AutomationLane(std::vector<AutomationPoint> newPoints, double newRepeatLength)
+    : points(std::move(newPoints)),
+      repeatLength(std::max(0.0, newRepeatLength))
+{
+    for (auto& point : points)
+        point.time = std::max(0.0, point.time);
+
+    std::stable_sort(points.begin(), points.end(),
+                     [](const AutomationPoint& a, const AutomationPoint& b) { return a.time < b.time; });
+
+    // Exponential segments move geometrically, which needs both ends positive
+    log2Ratios.assign(points.size(), 0.0f);
+    for (size_t i = 0; i + 1 < points.size(); ++i)
+    {
+        const float from = points[i].value;
+        const float to = points[i + 1].value;
+        if (points[i].curve == AutomationCurve::Exponential && from > 0.0f && to > 0.0f)
+            log2Ratios[i] = std::log2(to / from);
+    }
+}
+
+float AutomationLane::interpolate(int segment, float fraction) const noexcept
+{
+    const auto& from = points[static_cast<size_t>(segment)];
+    const float to = points[static_cast<size_t>(segment) + 1].value;
+
+    switch (from.curve)
+    {
+        case AutomationCurve::Step:
+            return from.value;
+
+        case AutomationCurve::SCurve:
+            fraction = fraction * fraction * (3.0f - 2.0f * fraction);
+            break;
+
+        case AutomationCurve::Exponential:
+            if (log2Ratios[static_cast<size_t>(segment)] != 0.0f)
+                return from.value * exp2Arithmetic(fraction * log2Ratios[static_cast<size_t>(segment)]);
+            break;
+
+        case AutomationCurve::Linear:
+        default:
+            break;
+    }
+
+    return from.value + (to - from.value) * fraction;
+}
+
+float AutomationLane::getValueAt(double transportTime) const noexcept
+{
+    if (points.empty())
+        return 0.0f;
+
+    double laneTime = transportTime;
+    if (repeatLength > 0.0)
+        laneTime -= std::floor(transportTime / repeatLength) * repeatLength;
+
+    const auto next = std::upper_bound(points.begin(), points.end(), laneTime,
+                                       [](double time, const AutomationPoint& point) { return time < point.time; });
+
+    if (next == points.begin())
+        return points.front().value;
+    if (next == points.end())
+        return points.back().value;
+
+    const auto segment = static_cast<int>(next - points.begin()) - 1;
+    const double start = points[static_cast<size_t>(segment)].time;
+    const double length = next->time - start;
+    const double fraction = length > 0.0 ? (laneTime - start) / length : 1.0;
+    return interpolate(segment, static_cast<float>(juce::jlimit(0.0, 1.0, fraction)));
+}
+
+//==============================================================================
+AutomationEngine::AutomationEngine()
+    : liveLanes(maxParameters),
+      cursors(maxParameters)
+{
+    for (auto& lane : lanes)
+        lane.store(nullptr);
+}
+
+AutomationEngine::~AutomationEngine() = default;
+
+void AutomationEngine::setSampleRate(double newSampleRate)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    if (newSampleRate > 0.0)
+        sampleRate = newSampleRate;
+
+    // Boundaries move with the rate; every cursor re-finds its segment
+    for (auto& cursor : cursors)
+        cursor = Cursor();
+}
+
+AutomationParameterId AutomationEngine::registerParameter(int pluginId, const juce::String& parameterName)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    const auto key = std::make_pair(pluginId, parameterName);
+    auto it = parameterIds.find(key);
+    if (it != parameterIds.end())
+        return it->second;
+
+    if (numParameters >= maxParameters)
+        return invalidId;
+
+    const AutomationParameterId id = numParameters++;
+    parameterIds.emplace(key, id);
+    return id;
+}
+
+AutomationParameterId AutomationEngine::findParameter(int pluginId, const juce::String& parameterName) const
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    auto it = parameterIds.find(std::make_pair(pluginId, parameterName));
+    return it != parameterIds.end() ? it->second : invalidId;
+}
+
+bool AutomationEngine::setLane(AutomationParameterId id, std::vector<AutomationPoint> points, double repeatLength)
+{
+    if (id < 0 || id >= maxParameters)
+        return false;
+
+    // Built outside the lock; only the swap is serialised
+    auto lane = std::make_unique<AutomationLane>(std::move(points), repeatLength);
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (id >= numParameters)
+        return false;
+
+    publishLocked(id, lane->isEmpty() ? nullptr : std::move(lane));
+    return true;
+}
+
+void AutomationEngine::clearLane(AutomationParameterId id)
+{
+    if (id < 0 || id >= maxParameters)
+        return;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    publishLocked(id, nullptr);
+}
+
+void AutomationEngine::clearPluginLanes(int pluginId)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    for (auto it = parameterIds.lower_bound(std::make_pair(pluginId, juce::String()));
+         it != parameterIds.end() && it->first.first == pluginId; ++it)
+        publishLocked(it->second, nullptr);
+}
+
+bool AutomationEngine::hasLane(AutomationParameterId id) const
+{
+    if (id < 0 || id >= maxParameters)
+        return false;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    return liveLanes[static_cast<size_t>(id)] != nullptr;
+}
+
+float AutomationEngine::getValueAt(AutomationParameterId id, int64_t transportSample) const
+{
+    if (id < 0 || id >= maxParameters)
+        return 0.0f;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    const auto* lane = liveLanes[static_cast<size_t>(id)].get();
+    if (lane == nullptr)
+        return 0.0f;
+
+    Cursor cursor;
+    locate(cursor, *lane, transportSample);
+    return valueAt(*lane, cursor, transportSample);
+}
+
+size_t AutomationEngine::collectRetired()
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    return collectRetiredLocked();
+}
+
+void AutomationEngine::publishLocked(AutomationParameterId id, std::unique_ptr<AutomationLane> lane)
+{
+    const auto index = static_cast<size_t>(id);
+    if (lane == nullptr && liveLanes[index] == nullptr)
+        return;
+
+    // Everything that can throw happens before the exchange
+    retired.reserve(retired.size() + 1);
+
+    if (lane != nullptr)
+        lane->revision = nextRevision++;
+
+    std::unique_ptr<const AutomationLane> next(std::move(lane));
+    lanes[index].exchange(next.get());
+    auto previous = std::move(liveLanes[index]);
+    liveLanes[index] = std::move(next);
+
+    if (previous != nullptr)
+    {
+        // A block that pins this epoch or later loads the new lane, so the
+        // previous one is safe to free once the pinned epoch reaches it
+        Retired entry;
+        entry.epoch = globalEpoch.fetch_add(1) + 1;
+        entry.lane = std::move(previous);
+        retired.push_back(std::move(entry));
+    }
+
+    collectRetiredLocked();
+}
+
+size_t AutomationEngine::collectRetiredLocked()
+{
+    const uint64_t pinned = pinnedEpoch.load();
+
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [pinned](const Retired& entry) { return pinned == 0 || pinned >= entry.epoch; }),
+                  retired.end());
+    return retired.size();
+}
+
+//==============================================================================
+void AutomationEngine::beginBlock(const AutomationTransport& newTransport) noexcept
+{
+    // Pin before any lane is loaded; lanes retired after this epoch stay alive
+    pinnedEpoch.store(globalEpoch.load());
+    transport = newTransport;
+    transport.numSamples = std::max(0, transport.numSamples);
+}
+
+void AutomationEngine::endBlock() noexcept
+{
+    pinnedEpoch.store(0);
+}
+
+bool AutomationEngine::renderValues(AutomationParameterId id, float* output) noexcept
+{
+    return forEachRun(id, [this, output](int blockOffset, int count, int64_t startSample,
+                                         Cursor& cursor, const AutomationLane& lane)
+    {
+        fillSegment(lane, cursor, startSample, output + blockOffset, count);
+    });
+}
+
+int AutomationEngine::renderEvents(AutomationParameterId id, AutomationEvent* events, int maxEvents, int interval) noexcept
+{
+    int numEvents = 0;
+
+    forEachRun(id, [this, events, maxEvents, interval, &numEvents](int blockOffset, int count, int64_t startSample,
+                                                                   Cursor& cursor, const AutomationLane& lane)
+    {
+        auto emit = [&](int64_t sample)
+        {
+            const float value = valueAt(lane, cursor, sample);
+            if (numEvents >= maxEvents || (cursor.hasLastEvent && cursor.lastEventValue == value))
+                return;
+
+            events[numEvents++] = { blockOffset + static_cast<int>(sample - startSample), value };
+            cursor.lastEventValue = value;
+            cursor.hasLastEvent = true;
+        };
+
+        emit(startSample);
+
+        const int lastPoint = static_cast<int>(lane.points.size()) - 1;
+        const bool ramp = cursor.segment >= 0 && cursor.segment < lastPoint
+                       && lane.points[static_cast<size_t>(cursor.segment)].curve != AutomationCurve::Step;
+
+        if (ramp && interval > 0)
+        {
+            // Grid points are absolute, so any block size sees the same ones
+            const int64_t end = startSample + count;
+            int64_t gridSample = (startSample >= 0 ? startSample / interval + 1
+                                                   : -((-startSample) / interval)) * interval;
+            for (; gridSample < end; gridSample += interval)
+                emit(gridSample);
+        }
+    });
+
+    return numEvents;
+}
+
+//==============================================================================
+template <typename RunFunction>
+bool AutomationEngine::forEachRun(AutomationParameterId id, RunFunction&& run) noexcept
+{
+    if (id < 0 || id >= maxParameters)
+        return false;
+
+    const auto* lane = lanes[static_cast<size_t>(id)].load();
+    if (lane == nullptr)
+        return false;
+
+    auto& cursor = cursors[static_cast<size_t>(id)];
+    const bool loopActive = transport.looping && transport.loopEndSample > transport.loopStartSample;
+
+    int64_t position = transport.startSample;
+    int blockOffset = 0;
+
+    while (blockOffset < transport.numSamples)
+    {
+        // Split the block where the transport wraps back to the loop start
+        int count = transport.numSamples - blockOffset;
+        if (loopActive && position < transport.loopEndSample)
+            count = static_cast<int>(std::min<int64_t>(count, transport.loopEndSample - position));
+
+        // A seek, loop wrap or lane swap re-finds the segment; contiguous
+        // blocks carry on from where the last one stopped
+        if (cursor.revision != lane->revision || cursor.nextSample != position)
+        {
+            locate(cursor, *lane, position);
+            cursor.revision = lane->revision;
+            cursor.hasLastEvent = false;
+        }
+
+        const int64_t end = position + count;
+        while (position < end)
+        {
+            const int64_t runEnd = std::min(end, cursor.segmentEnd);
+            run(blockOffset, static_cast<int>(runEnd - position), position, cursor, *lane);
+
+            blockOffset += static_cast<int>(runEnd - position);
+            position = runEnd;
+
+            if (position == cursor.segmentEnd)
+                advance(cursor, *lane, position);
+        }
+
+        cursor.nextSample = position;
+
+        if (loopActive && position == transport.loopEndSample)
+            position = transport.loopStartSample;
+    }
+
+    return true;
+}
+
+void AutomationEngine::locate(Cursor& cursor, const AutomationLane& lane, int64_t sample) const noexcept
+{
+    const double repeat = repeatSamples(lane, sampleRate);
+
+    int64_t cycle = 0;
+    if (repeat > 0.0)
+    {
+        // Cycle boundaries are ceil(c * repeat); correct the division's rounding
+        cycle = static_cast<int64_t>(std::floor(static_cast<double>(sample) / repeat));
+        while (firstSampleAtOrAfter(static_cast<double>(cycle) * repeat) > sample)
+            --cycle;
+        while (firstSampleAtOrAfter(static_cast<double>(cycle + 1) * repeat) <= sample)
+            ++cycle;
+    }
+
+    cursor.cycle = cycle;
+    cursor.origin = static_cast<double>(cycle) * repeat;
+    cursor.cycleEnd = repeat > 0.0 ? firstSampleAtOrAfter(static_cast<double>(cycle + 1) * repeat) : endOfTimeline;
+
+    // Last point that starts at or before the sample
+    int low = 0;
+    int high = static_cast<int>(lane.points.size());
+    while (low < high)
+    {
+        const int middle = (low + high) / 2;
+        if (segmentStart(lane, cursor, middle) <= sample)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    cursor.segment = low - 1;
+    cursor.segmentEnd = low < static_cast<int>(lane.points.size())
+                          ? std::min(segmentStart(lane, cursor, low), cursor.cycleEnd)
+                          : cursor.cycleEnd;
+}
+
+void AutomationEngine::advance(Cursor& cursor, const AutomationLane& lane, int64_t sample) const noexcept
+{
+    const int numPoints = static_cast<int>(lane.points.size());
+
+    // Steps over zero-length segments and whole cycles one at a time, which
+    // lands exactly where locate() would
+    while (sample >= cursor.segmentEnd)
+    {
+        if (sample >= cursor.cycleEnd)
+        {
+            const double repeat = repeatSamples(lane, sampleRate);
+            ++cursor.cycle;
+            cursor.origin = static_cast<double>(cursor.cycle) * repeat;
+            cursor.cycleEnd = firstSampleAtOrAfter(static_cast<double>(cursor.cycle + 1) * repeat);
+            cursor.segment = -1;
+        }
+        else
+        {
+            ++cursor.segment;
+        }
+
+        const int next = cursor.segment + 1;
+        cursor.segmentEnd = next < numPoints ? std::min(segmentStart(lane, cursor, next), cursor.cycleEnd)
+                                             : cursor.cycleEnd;
+    }
+}
+
+int64_t AutomationEngine::segmentStart(const AutomationLane& lane, const Cursor& cursor, int point) const noexcept
+{
+    return firstSampleAtOrAfter(cursor.origin + lane.points[static_cast<size_t>(point)].time * sampleRate);
+}
+
+float AutomationEngine::valueAt(const AutomationLane& lane, const Cursor& cursor, int64_t sample) const noexcept
+{
+    float value = 0.0f;
+    fillSegment(lane, cursor, sample, &value, 1);
+    return value;
+}
+
+void AutomationEngine::fillSegment(const AutomationLane& lane, const Cursor& cursor, int64_t startSample,
+                                   float* output, int numSamples) const noexcept
+{
+    const int lastPoint = static_cast<int>(lane.points.size()) - 1;
+
+    if (cursor.segment < 0 || cursor.segment >= lastPoint)
+    {
+        const float hold = lane.points[cursor.segment < 0 ? 0 : static_cast<size_t>(lastPoint)].value;
+        std::fill(output, output + numSamples, hold);
+        return;
+    }
+
+    const auto segment = static_cast<size_t>(cursor.segment);
+    const auto& from = lane.points[segment];
+
+    if (from.curve == AutomationCurve::Step)
+    {
+        std::fill(output, output + numSamples, from.value);
+        return;
+    }
+
+    // The fraction depends only on the absolute sample index, never on
+    // where the block started, so any partition renders the same values
+    const double base = cursor.origin + from.time * sampleRate;
+    const double length = (lane.points[segment + 1].time - from.time) * sampleRate;
+    const double inverseLength = length > 0.0 ? 1.0 / length : 0.0;
+    const double first = static_cast<double>(startSample);
+
+    const float startValue = from.value;
+    const float span = lane.points[segment + 1].value - from.value;
+    const float log2Ratio = lane.log2Ratios[segment];
+
+    auto fractionAt = [=](int i)
+    {
+        const double fraction = length > 0.0 ? (first + static_cast<double>(i) - base) * inverseLength : 1.0;
+        return static_cast<float>(std::min(1.0, std::max(0.0, fraction)));
+    };
+
+    if (from.curve == AutomationCurve::Exponential && log2Ratio != 0.0f)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = startValue * exp2Arithmetic(fractionAt(i) * log2Ratio);
+    }
+    else if (from.curve == AutomationCurve::SCurve)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = fractionAt(i);
+            output[i] = startValue + span * (x * x * (3.0f - 2.0f * x));
+        }
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = startValue + span * fractionAt(i);
+    }
+}
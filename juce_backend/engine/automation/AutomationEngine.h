@@ -0,0 +1,226 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+/**
+    Sample-accurate parameter automation driven by the transport
+
+    - Each automated parameter owns a lane of breakpoints on the transport
+      timeline (seconds). Every point sets the curve towards the next one:
+      linear, exponential (geometric between positive values), S-curve or
+      step.
+    - Parameters are resolved once to an integer AutomationParameterId on the
+      message thread; the audio thread only indexes fixed arrays with it.
+    - Lanes are immutable. An edit builds a new lane and swaps the pointer;
+      the replaced lane is retired and freed by collectRetired() once no
+      block that could still read it is in flight (same epoch scheme as
+      MemorySafeAudioGraph). Edits collect as they go; the owner also calls
+      collectRetired() from a message-thread timer so the last edit's lane
+      is not kept until the next one.
+    - Per-parameter cursors remember the segment of the last sample rendered,
+      so contiguous blocks advance in O(1) amortized regardless of how many
+      points the lane holds; a loop wrap, seek or lane swap re-finds the
+      segment with a binary search.
+    - Every value is a pure function of the absolute sample position, so an
+      offline bounce with any block size renders exactly what playback does.
+
+    Threading: edits, registration and getValueAt() are message-thread calls
+    serialised by a writer mutex. beginBlock(), render*() and endBlock() are
+    the audio thread's, lock-free and allocation-free.
+*/
+
+using AutomationParameterId = int;
+
+enum class AutomationCurve
+{
+    Linear,
+    Exponential,
+    SCurve,
+    Step
+};
+
+struct AutomationPoint
+{
+    double time = 0.0;                                  // Seconds on the transport timeline
+    float value = 0.0f;
+    AutomationCurve curve = AutomationCurve::Linear;    // Shape towards the next point
+};
+
+/** Parameter change for hosts that take events instead of per-sample values */
+struct AutomationEvent
+{
+    int sampleOffset = 0;
+    float value = 0.0f;
+};
+
+/** Transport range covered by one audio block */
+struct AutomationTransport
+{
+    int64_t startSample = 0;
+    int numSamples = 0;
+    bool looping = false;
+    int64_t loopStartSample = 0;
+    int64_t loopEndSample = 0;
+
+    /** Position after this block, wrapped into the loop when looping */
+    int64_t getNextPosition() const noexcept;
+};
+
+//==============================================================================
+/**
+    Immutable breakpoint lane
+
+    Before the first point the lane holds the first value, after the last one
+    the last value. A lane with a repeat length folds the timeline into
+    [0, repeatLength); give it points at 0 and repeatLength for a seamless
+    cycle.
+*/
+class AutomationLane
+{
+public:
+    AutomationLane(std::vector<AutomationPoint> points, double repeatLength = 0.0);
+
+    const std::vector<AutomationPoint>& getPoints() const noexcept { return points; }
+    double getRepeatLength() const noexcept { return repeatLength; }
+    bool isEmpty() const noexcept { return points.empty(); }
+
+    /** Value at a transport time in seconds (continuous, for display) */
+    float getValueAt(double transportTime) const noexcept;
+
+private:
+    friend class AutomationEngine;
+
+    /** Value within the segment starting at point index, fraction in [0, 1] */
+    float interpolate(int segment, float fraction) const noexcept;
+
+    std::vector<AutomationPoint> points;            // Sorted by time
+    std::vector<float> log2Ratios;                  // Exponential segments; 0 = interpolate linearly
+    double repeatLength = 0.0;
+    uint64_t revision = 0;                          // Set once by the engine before publishing
+};
+
+//==============================================================================
+class AutomationEngine
+{
+public:
+    static constexpr int maxParameters = 1024;
+    static constexpr AutomationParameterId invalidId = -1;
+
+    AutomationEngine();
+    ~AutomationEngine();
+
+    //==============================================================================
+    // Message thread
+
+    /** Sample rate of the transport; call while the audio thread is stopped */
+    void setSampleRate(double newSampleRate);
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    /** Id for a plugin parameter, created on first use; invalidId when full */
+    AutomationParameterId registerParameter(int pluginId, const juce::String& parameterName);
+    AutomationParameterId findParameter(int pluginId, const juce::String& parameterName) const;
+
+    /** Replace a parameter's lane; points are sorted by time */
+    bool setLane(AutomationParameterId id, std::vector<AutomationPoint> points, double repeatLength = 0.0);
+    void clearLane(AutomationParameterId id);
+
+    /** Clear every lane of a plugin; its parameter ids stay valid */
+    void clearPluginLanes(int pluginId);
+    bool hasLane(AutomationParameterId id) const;
+
+    /** Value at a transport position, from the latest published lane */
+    float getValueAt(AutomationParameterId id, int64_t transportSample) const;
+
+    /**
+        Free retired lanes no block in flight can see
+        @return Number of lanes still waiting
+    */
+    size_t collectRetired();
+
+    //==============================================================================
+    // Audio thread
+
+    /** Pin the lanes and set the transport range for the render calls */
+    void beginBlock(const AutomationTransport& transport) noexcept;
+    void endBlock() noexcept;
+
+    /**
+        Per-sample values for the current block
+        @return false (output untouched) if the parameter has no lane
+    */
+    bool renderValues(AutomationParameterId id, float* output) noexcept;
+
+    /**
+        Value changes for the current block: at the block start, at each
+        breakpoint and, inside ramps, at every multiple of interval samples
+        on the transport grid. Repeats of the last value are skipped.
+        @return Number of events written, 0 if the parameter has no lane
+    */
+    int renderEvents(AutomationParameterId id, AutomationEvent* events, int maxEvents, int interval) noexcept;
+
+private:
+    // Segment boundaries are whole samples: point i of repeat cycle c starts
+    // at ceil(c * repeatSamples + time_i * sampleRate)
+    struct Cursor
+    {
+        uint64_t revision = 0;          // Lane the cursor was positioned on, 0 = none
+        int64_t nextSample = 0;         // Sample the cursor is positioned for
+        int segment = -1;               // Point index, -1 before the first point
+        int64_t cycle = 0;              // Repeat cycle
+        double origin = 0.0;            // Cycle start in (fractional) samples
+        int64_t segmentEnd = 0;         // First sample of the next segment
+        int64_t cycleEnd = 0;           // First sample of the next cycle
+        float lastEventValue = 0.0f;
+        bool hasLastEvent = false;
+    };
+
+    struct Retired
+    {
+        uint64_t epoch = 0;
+        std::unique_ptr<const AutomationLane> lane;
+    };
+
+    /** Calls run(blockOffset, count, startSample, cursor, lane) for each single-segment run of the block */
+    template <typename RunFunction>
+    bool forEachRun(AutomationParameterId id, RunFunction&& run) noexcept;
+
+    void locate(Cursor& cursor, const AutomationLane& lane, int64_t sample) const noexcept;
+    void advance(Cursor& cursor, const AutomationLane& lane, int64_t sample) const noexcept;
+    int64_t segmentStart(const AutomationLane& lane, const Cursor& cursor, int point) const noexcept;
+    float valueAt(const AutomationLane& lane, const Cursor& cursor, int64_t sample) const noexcept;
+    void fillSegment(const AutomationLane& lane, const Cursor& cursor, int64_t startSample,
+                     float* output, int numSamples) const noexcept;
+
+    void publishLocked(AutomationParameterId id, std::unique_ptr<AutomationLane> lane);
+    size_t collectRetiredLocked();
+
+    double sampleRate = 44100.0;
+
+    // Writer side (guarded by writerMutex)
+    mutable std::mutex writerMutex;
+    std::map<std::pair<int, juce::String>, AutomationParameterId> parameterIds;
+    std::vector<std::unique_ptr<const AutomationLane>> liveLanes;  // Owners of the published lanes
+    std::vector<Retired> retired;
+    int numParameters = 0;
+    uint64_t nextRevision = 1;
+
+    // Published to the audio thread
+    std::array<std::atomic<const AutomationLane*>, maxParameters> lanes;
+    std::atomic<uint64_t> globalEpoch { 1 };
+    std::atomic<uint64_t> pinnedEpoch { 0 };
+
+    // Audio-thread state
+    std::vector<Cursor> cursors;
+    AutomationTransport transport;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutomationEngine)
+};
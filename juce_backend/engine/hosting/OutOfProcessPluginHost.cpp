@@ -0,0 +1,577 @@
+/*
+  ==============================================================================
+    OutOfProcessPluginHost.cpp
+
+    Engine side of the plugin host subprocess: shared region, child
+    lifecycle, watchdog and the non-blocking audio path.
+  ==============================================================================
+*/
+
+#include "OutOfProcessPluginHost.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if JUCE_LINUX
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <spawn.h>
+ #include <sys/mman.h>
+ #include <sys/wait.h>
+ #include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace SchillingerEcosystem::Audio {
+
+using namespace PluginHostTransport;
+
+//==============================================================================
+// OutOfProcessPluginHost Implementation
+
+OutOfProcessPluginHost::OutOfProcessPluginHost(Config config)
+    : config_(std::move(config))
+{
+    config_.numChannels = std::clamp(config_.numChannels, 1, PluginHostTransport::maxChannels);
+}
+
+OutOfProcessPluginHost::~OutOfProcessPluginHost() {
+    stop();
+}
+
+std::string OutOfProcessPluginHost::getDefaultExecutable() {
+#if JUCE_LINUX
+    char path[4096];
+    const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0) {
+        return {};
+    }
+
+    std::string helper(path, static_cast<size_t>(length));
+    helper.erase(helper.find_last_of('/') + 1);
+    helper += PluginHostChild::helperExecutableName;
+
+    if (access(helper.c_str(), X_OK) == 0) {
+        return helper;
+    }
+#endif
+    return {};
+}
+
+bool OutOfProcessPluginHost::start(double sampleRate, int maxBlockSize) {
+#if JUCE_LINUX
+    stop();
+
+    if (config_.pluginPaths.empty() || sampleRate <= 0.0 ||
+        maxBlockSize <= 0 || maxBlockSize > PluginHostTransport::maxBlockSize) {
+        return false;
+    }
+
+    if (!createSharedRegion(sampleRate, maxBlockSize)) {
+        return false;
+    }
+
+    state_.store(State::Starting);
+    recentRestarts_.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(processMutex_);
+        if (!launchChild() || !waitForChildReady(config_.startupTimeout)) {
+            reapChild(true);
+            state_.store(State::Failed);
+            destroySharedRegion();
+            return false;
+        }
+    }
+
+    state_.store(State::Running);
+    watchdogRunning_.store(true);
+    watchdog_ = std::thread([this] { watchdogLoop(); });
+    return true;
+#else
+    juce::ignoreUnused(sampleRate, maxBlockSize);
+    return false;
+#endif
+}
+
+void OutOfProcessPluginHost::stop() {
+    // The audio thread must be done with process() by now (releaseResources)
+    watchdogRunning_.store(false);
+    if (watchdog_.joinable()) {
+        watchdog_.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(processMutex_);
+        reapChild(false);
+    }
+
+    destroySharedRegion();
+    state_.store(State::Stopped);
+}
+
+OutOfProcessPluginHost::Statistics OutOfProcessPluginHost::getStatistics() const noexcept {
+    Statistics stats;
+    stats.blocksSubmitted = blocksSubmitted_.load();
+    stats.blocksMissed = blocksMissed_.load();
+    stats.lateBlocksDropped = lateBlocksDropped_.load();
+    stats.restarts = restarts_.load();
+    stats.crashes = crashes_.load();
+    stats.hangs = hangs_.load();
+    return stats;
+}
+
+int OutOfProcessPluginHost::getLatencySamples() const noexcept {
+    return region_ != nullptr ? maxBlockSize_ + region_->latencySamples.load() : 0;
+}
+
+//==============================================================================
+// Shared region and child lifecycle (message thread / watchdog)
+
+bool OutOfProcessPluginHost::createSharedRegion(double sampleRate, int maxBlockSize) {
+#if JUCE_LINUX
+    regionFd_ = memfd_create("schillinger-plugin-host", MFD_CLOEXEC);
+    if (regionFd_ < 0) {
+        return false;
+    }
+
+    void* memory = MAP_FAILED;
+    if (ftruncate(regionFd_, static_cast<off_t>(sizeof(SharedRegion))) == 0) {
+        memory = mmap(nullptr, sizeof(SharedRegion), PROT_READ | PROT_WRITE, MAP_SHARED, regionFd_, 0);
+    }
+
+    if (memory == MAP_FAILED) {
+        close(regionFd_);
+        regionFd_ = -1;
+        return false;
+    }
+
+    // Keep the audio path off the page-fault path where the system allows it
+    mlock(memory, sizeof(SharedRegion));
+
+    region_ = new (memory) SharedRegion();
+    region_->magicNumber = PluginHostTransport::magic;
+    region_->layoutVersion = PluginHostTransport::version;
+    region_->sampleRate = sampleRate;
+    region_->maxBlockSize = maxBlockSize;
+    region_->numChannels = config_.numChannels;
+    region_->childState.store(static_cast<uint32_t>(ChildState::Starting));
+
+    maxBlockSize_ = maxBlockSize;
+
+    // Output is delayed by one maximum block; see the class comment
+    fifoCapacity_ = 2 * maxBlockSize;
+    fifo_.assign(static_cast<size_t>(config_.numChannels) * static_cast<size_t>(fifoCapacity_), 0.0f);
+    fifoRead_ = 0;
+    fifoLevel_ = maxBlockSize;
+    nextSerial_ = 0;
+    outstanding_ = false;
+    numMidiOut_ = 0;
+    return true;
+#else
+    juce::ignoreUnused(sampleRate, maxBlockSize);
+    return false;
+#endif
+}
+
+void OutOfProcessPluginHost::destroySharedRegion() {
+#if JUCE_LINUX
+    if (region_ != nullptr) {
+        munmap(region_, sizeof(SharedRegion));
+        region_ = nullptr;
+    }
+    if (regionFd_ >= 0) {
+        close(regionFd_);
+        regionFd_ = -1;
+    }
+#endif
+}
+
+bool OutOfProcessPluginHost::launchChild() {
+#if JUCE_LINUX
+    const std::string executable = config_.executable.empty() ? getDefaultExecutable() : config_.executable;
+    if (executable.empty()) {
+        return false;
+    }
+
+    std::vector<std::string> arguments { executable, PluginHostChild::commandLineFlag };
+    arguments.insert(arguments.end(), config_.pluginPaths.begin(), config_.pluginPaths.end());
+
+    std::vector<char*> argv;
+    for (auto& argument : arguments) {
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+
+    // The region is the only descriptor the child inherits (dup2 clears CLOEXEC)
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, regionFd_, PluginHostChild::regionFileDescriptor);
+
+    region_->childState.store(static_cast<uint32_t>(ChildState::Starting));
+    region_->shutdownRequested.store(0);
+
+    pid_t pid = -1;
+    const int result = posix_spawn(&pid, executable.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (result != 0) {
+        childPid_ = -1;
+        return false;
+    }
+
+    childPid_ = pid;
+    lastHeartbeat_ = region_->heartbeat.load();
+    lastProgress_ = std::chrono::steady_clock::now();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void OutOfProcessPluginHost::reapChild(bool kill) {
+#if JUCE_LINUX
+    if (childPid_ <= 0) {
+        return;
+    }
+
+    if (!kill && region_ != nullptr) {
+        // Ask nicely, then insist
+        region_->shutdownRequested.store(1);
+        region_->inputSignal.fetch_add(1);
+        futexWake(region_->inputSignal);
+
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            if (waitpid(childPid_, nullptr, WNOHANG) == childPid_) {
+                childPid_ = -1;
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    ::kill(childPid_, SIGKILL);
+    waitpid(childPid_, nullptr, 0);
+    childPid_ = -1;
+#else
+    juce::ignoreUnused(kill);
+#endif
+}
+
+bool OutOfProcessPluginHost::waitForChildReady(std::chrono::milliseconds timeout) {
+#if JUCE_LINUX
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (std::chrono::steady_clock::now() < deadline) {
+        const auto childState = static_cast<ChildState>(region_->childState.load());
+        if (childState == ChildState::Ready) {
+            return true;
+        }
+        if (childState == ChildState::LoadFailed || waitpid(childPid_, nullptr, WNOHANG) == childPid_) {
+            if (childState != ChildState::LoadFailed) {
+                childPid_ = -1;
+            }
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+#else
+    juce::ignoreUnused(timeout);
+#endif
+    return false;
+}
+
+bool OutOfProcessPluginHost::restartAllowed() {
+    const auto now = std::chrono::steady_clock::now();
+    recentRestarts_.erase(std::remove_if(recentRestarts_.begin(), recentRestarts_.end(),
+                                         [now](auto time) { return now - time > std::chrono::minutes(1); }),
+                          recentRestarts_.end());
+    return static_cast<int>(recentRestarts_.size()) < config_.maxRestartsPerMinute;
+}
+
+void OutOfProcessPluginHost::watchdogLoop() {
+#if JUCE_LINUX
+    using Clock = std::chrono::steady_clock;
+
+    while (watchdogRunning_.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        std::lock_guard<std::mutex> lock(processMutex_);
+        const auto now = Clock::now();
+        const State state = state_.load();
+
+        if (state == State::Running) {
+            bool restart = false;
+
+            if (childPid_ <= 0 || waitpid(childPid_, nullptr, WNOHANG) == childPid_) {
+                childPid_ = -1;
+                crashes_.fetch_add(1, std::memory_order_relaxed);
+                restart = true;
+            } else {
+                // The child bumps the heartbeat every turn, including idle
+                // futex timeouts, so a stalled heartbeat is a stuck plugin
+                const uint64_t heartbeat = region_->heartbeat.load();
+                if (heartbeat != lastHeartbeat_) {
+                    lastHeartbeat_ = heartbeat;
+                    lastProgress_ = now;
+                } else if (now - lastProgress_ > config_.hangTimeout) {
+                    hangs_.fetch_add(1, std::memory_order_relaxed);
+                    reapChild(true);
+                    restart = true;
+                }
+            }
+
+            if (restart) {
+                // Stop submitting before the child is replaced
+                state_.store(State::Restarting);
+                region_->childState.store(static_cast<uint32_t>(ChildState::Starting));
+
+                if (!restartAllowed()) {
+                    state_.store(State::Failed);
+                    continue;
+                }
+
+                // Exponential backoff: 50 ms, 100 ms, ... capped at 2 s
+                const auto backoff = std::chrono::milliseconds(
+                    std::min<int64_t>(2000, int64_t { 50 } << recentRestarts_.size()));
+                recentRestarts_.push_back(now);
+                nextLaunch_ = now + backoff;
+            }
+        } else if (state == State::Restarting && now >= nextLaunch_) {
+            restarts_.fetch_add(1, std::memory_order_relaxed);
+
+            if (launchChild() && waitForChildReady(config_.startupTimeout)) {
+                state_.store(State::Running);
+            } else {
+                const bool loadFailed = static_cast<ChildState>(region_->childState.load()) == ChildState::LoadFailed;
+                reapChild(true);
+
+                if (loadFailed || !restartAllowed()) {
+                    state_.store(State::Failed);
+                } else {
+                    recentRestarts_.push_back(now);
+                    nextLaunch_ = Clock::now() + std::chrono::milliseconds(
+                        std::min<int64_t>(2000, int64_t { 50 } << recentRestarts_.size()));
+                }
+            }
+        }
+    }
+#endif
+}
+
+//==============================================================================
+// Audio path
+
+void OutOfProcessPluginHost::process(float* const* channels, int numChannels, int numSamples,
+                                     juce::MidiBuffer& midi) noexcept {
+    if (region_ == nullptr || numSamples <= 0) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            juce::FloatVectorOperations::clear(channels[ch], std::max(0, numSamples));
+        }
+        midi.clear();
+        return;
+    }
+
+    jassert(numSamples <= maxBlockSize_);
+    const int blockSize = std::min(numSamples, maxBlockSize_);
+
+    // 1. Take whatever the child finished; 2. a block from an earlier
+    // callback that is still out has missed its deadline
+    collectOutput();
+    if (outstanding_) {
+        pushSilence(outstandingSize_);
+        blocksMissed_.fetch_add(1, std::memory_order_relaxed);
+        outstanding_ = false;
+    }
+    region_->discardBefore.store(nextSerial_, std::memory_order_relaxed);
+
+    // 3. Hand this block to the child, or give it up straight away
+    submitBlock(channels, numChannels, blockSize, midi);
+
+    // 4. Plugin MIDI arrives a callback late; keep it inside this block
+    midi.clear();
+    for (int i = 0; i < numMidiOut_; ++i) {
+        const auto& event = midiOut_[static_cast<size_t>(i)];
+        midi.addEvent(event.bytes, event.size, std::min(static_cast<int>(event.sampleOffset), blockSize - 1));
+    }
+    numMidiOut_ = 0;
+
+    // 5. Read the delayed output
+    const int channelsFromFifo = std::min(numChannels, config_.numChannels);
+    const int firstPart = std::min(blockSize, fifoCapacity_ - fifoRead_);
+    for (int ch = 0; ch < channelsFromFifo; ++ch) {
+        const float* source = fifo_.data() + static_cast<size_t>(ch) * static_cast<size_t>(fifoCapacity_);
+        std::memcpy(channels[ch], source + fifoRead_, sizeof(float) * static_cast<size_t>(firstPart));
+        std::memcpy(channels[ch] + firstPart, source, sizeof(float) * static_cast<size_t>(blockSize - firstPart));
+    }
+    for (int ch = channelsFromFifo; ch < numChannels; ++ch) {
+        juce::FloatVectorOperations::clear(channels[ch], blockSize);
+    }
+    for (int ch = 0; ch < numChannels && blockSize < numSamples; ++ch) {
+        juce::FloatVectorOperations::clear(channels[ch] + blockSize, numSamples - blockSize);
+    }
+
+    fifoRead_ = (fifoRead_ + blockSize) % fifoCapacity_;
+    fifoLevel_ -= blockSize;
+}
+
+void OutOfProcessPluginHost::collectOutput() noexcept {
+    while (const BlockSlot* slot = region_->output.beginRead()) {
+        if (outstanding_ && slot->serial == nextSerial_ - 1 && slot->numSamples == outstandingSize_) {
+            const float* audio[PluginHostTransport::maxChannels];
+            for (int ch = 0; ch < config_.numChannels; ++ch) {
+                audio[ch] = slot->audio[ch];
+            }
+            pushToFifo(audio, std::min(slot->numChannels, config_.numChannels), slot->numSamples);
+
+            numMidiOut_ = std::clamp(slot->numMidiEvents, 0, PluginHostTransport::maxMidiEvents);
+            std::copy(slot->midi, slot->midi + numMidiOut_, midiOut_.begin());
+            outstanding_ = false;
+        } else {
+            // Output for a block that already went out as silence
+            lateBlocksDropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        region_->output.endRead();
+    }
+}
+
+void OutOfProcessPluginHost::submitBlock(const float* const* channels, int numChannels, int numSamples,
+                                         const juce::MidiBuffer& midi) noexcept {
+    BlockSlot* slot = nullptr;
+    if (state_.load() == State::Running &&
+        region_->childState.load() == static_cast<uint32_t>(ChildState::Ready)) {
+        slot = region_->input.beginWrite();
+    }
+
+    if (slot == nullptr) {
+        // Child down, restarting or backed up: this block is silence
+        pushSilence(numSamples);
+        blocksMissed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    slot->serial = nextSerial_++;
+    slot->numChannels = config_.numChannels;
+    slot->numSamples = numSamples;
+
+    for (int ch = 0; ch < config_.numChannels; ++ch) {
+        if (ch < numChannels) {
+            std::memcpy(slot->audio[ch], channels[ch], sizeof(float) * static_cast<size_t>(numSamples));
+        } else {
+            std::memset(slot->audio[ch], 0, sizeof(float) * static_cast<size_t>(numSamples));
+        }
+    }
+
+    int numEvents = 0;
+    for (const auto metadata : midi) {
+        if (numEvents == PluginHostTransport::maxMidiEvents) {
+            break;
+        }
+        if (metadata.numBytes > 3 || metadata.samplePosition >= numSamples) {
+            continue;
+        }
+
+        auto& event = slot->midi[numEvents++];
+        event.sampleOffset = static_cast<uint32_t>(std::max(0, metadata.samplePosition));
+        event.size = static_cast<uint8_t>(metadata.numBytes);
+        std::memcpy(event.bytes, metadata.data, static_cast<size_t>(metadata.numBytes));
+    }
+    slot->numMidiEvents = numEvents;
+
+    region_->input.endWrite();
+    outstanding_ = true;
+    outstandingSize_ = numSamples;
+    blocksSubmitted_.fetch_add(1, std::memory_order_relaxed);
+
+    // Non-blocking wake; the child may already be spinning on the ring
+    region_->inputSignal.fetch_add(1, std::memory_order_release);
+#if JUCE_LINUX
+    futexWake(region_->inputSignal);
+#endif
+}
+
+void OutOfProcessPluginHost::pushToFifo(const float* const* channels, int numChannels, int numSamples) noexcept {
+    jassert(fifoLevel_ + numSamples <= fifoCapacity_);
+    numSamples = std::min(numSamples, fifoCapacity_ - fifoLevel_);
+
+    const int write = (fifoRead_ + fifoLevel_) % fifoCapacity_;
+    const int firstPart = std::min(numSamples, fifoCapacity_ - write);
+
+    for (int ch = 0; ch < config_.numChannels; ++ch) {
+        float* destination = fifo_.data() + static_cast<size_t>(ch) * static_cast<size_t>(fifoCapacity_);
+        if (channels != nullptr && ch < numChannels) {
+            std::memcpy(destination + write, channels[ch], sizeof(float) * static_cast<size_t>(firstPart));
+            std::memcpy(destination, channels[ch] + firstPart, sizeof(float) * static_cast<size_t>(numSamples - firstPart));
+        } else {
+            std::fill(destination + write, destination + write + firstPart, 0.0f);
+            std::fill(destination, destination + (numSamples - firstPart), 0.0f);
+        }
+    }
+
+    fifoLevel_ += numSamples;
+}
+
+void OutOfProcessPluginHost::pushSilence(int numSamples) noexcept {
+    pushToFifo(nullptr, 0, numSamples);
+}
+
+//==============================================================================
+// IsolatedPluginInstance Implementation
+
+namespace {
+
+juce::AudioChannelSet channelSetFor(int numChannels) {
+    return numChannels == 1 ? juce::AudioChannelSet::mono()
+         : numChannels == 2 ? juce::AudioChannelSet::stereo()
+                            : juce::AudioChannelSet::discreteChannels(numChannels);
+}
+
+} // namespace
+
+IsolatedPluginInstance::IsolatedPluginInstance(OutOfProcessPluginHost::Config config)
+    : juce::AudioPluginInstance(BusesProperties()
+                                    .withInput("Input", channelSetFor(config.numChannels), true)
+                                    .withOutput("Output", channelSetFor(config.numChannels), true))
+    , config_(config)
+    , host_(std::move(config))
+{
+}
+
+IsolatedPluginInstance::~IsolatedPluginInstance() {
+    host_.stop();
+}
+
+const juce::String IsolatedPluginInstance::getName() const {
+    if (config_.pluginPaths.empty()) {
+        return "Isolated Plugin";
+    }
+    return juce::File(config_.pluginPaths.front()).getFileNameWithoutExtension() + " (isolated)";
+}
+
+void IsolatedPluginInstance::fillInPluginDescription(juce::PluginDescription& description) const {
+    description.name = getName();
+    description.descriptiveName = getName();
+    description.pluginFormatName = "Isolated";
+    description.fileOrIdentifier = config_.pluginPaths.empty() ? juce::String() : juce::String(config_.pluginPaths.front());
+    description.numInputChannels = config_.numChannels;
+    description.numOutputChannels = config_.numChannels;
+    description.isInstrument = false;
+}
+
+void IsolatedPluginInstance::prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) {
+    if (!host_.start(sampleRate, maximumExpectedSamplesPerBlock)) {
+        juce::Logger::writeToLog("Isolated plugin host failed to start: " + getName());
+    }
+    setLatencySamples(host_.getLatencySamples());
+}
+
+void IsolatedPluginInstance::releaseResources() {
+    host_.stop();
+}
+
+void IsolatedPluginInstance::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) {
+    host_.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(), midi);
+}
+
+} // namespace SchillingerEcosystem::Audio
@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+    OutOfProcessPluginHost.h
+
+    Runs third-party plugins in a subprocess (Linux) so a crash or stall in
+    a plugin costs at most silence, never the engine.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PluginHostTransport.h"
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SchillingerEcosystem::Audio {
+
+//==============================================================================
+/**
+ * Engine side of a plugin host subprocess
+ *
+ * One child process hosts a chain of plugins (one plugin or a group). Audio
+ * and MIDI travel through shared-memory block rings; submitting a block
+ * bumps a futex the child sleeps on.
+ *
+ * The audio thread never waits for the child. A block submitted in one
+ * callback must be back by the next one; its output then goes through a
+ * FIFO primed with maxBlockSize samples of silence, so the path has a fixed
+ * latency of getLatencySamples() whatever the callback sizes. A block that
+ * misses that deadline (or that cannot be submitted because the child is
+ * down or its ring is full) is replaced by silence and its late output is
+ * dropped, keeping the timeline intact.
+ *
+ * A watchdog thread restarts a child that crashed, or that stopped making
+ * progress with work queued, with exponential backoff and a cap on restarts
+ * per minute. The child is the SchillingerPluginHost helper executable
+ * (PluginHostMain.cpp), which serves through PluginHostChild.
+ */
+class OutOfProcessPluginHost {
+public:
+    struct Config {
+        std::vector<std::string> pluginPaths;   // Processed in series in one child
+        std::string executable;                 // Empty: the helper (getDefaultExecutable)
+        int numChannels = 2;
+        std::chrono::milliseconds hangTimeout { 500 };
+        std::chrono::milliseconds startupTimeout { 10000 };
+        int maxRestartsPerMinute = 5;
+    };
+
+    enum class State {
+        Stopped,
+        Starting,
+        Running,
+        Restarting,
+        Failed          // Plugin failed to load, or crashed too often
+    };
+
+    struct Statistics {
+        uint64_t blocksSubmitted = 0;
+        uint64_t blocksMissed = 0;      // Replaced by silence
+        uint64_t lateBlocksDropped = 0;
+        uint64_t restarts = 0;
+        uint64_t crashes = 0;
+        uint64_t hangs = 0;
+    };
+
+    explicit OutOfProcessPluginHost(Config config);
+    ~OutOfProcessPluginHost();
+
+    /**
+     * Create the shared region and launch the child; waits (message thread)
+     * until the child reports its plugins loaded or startupTimeout passes.
+     */
+    bool start(double sampleRate, int maxBlockSize);
+    void stop();
+
+    State getState() const noexcept { return state_.load(); }
+    bool isRunning() const noexcept { return state_.load() == State::Running; }
+    Statistics getStatistics() const noexcept;
+
+    /** Transport latency plus whatever the hosted plugins report */
+    int getLatencySamples() const noexcept;
+
+    /** Audio thread: process in place, never blocks */
+    void process(float* const* channels, int numChannels, int numSamples, juce::MidiBuffer& midi) noexcept;
+
+    /**
+     * The helper installed next to this process's binary, or empty when it
+     * is missing (the host then fails to start rather than running plugins
+     * in-process)
+     */
+    static std::string getDefaultExecutable();
+
+private:
+    bool createSharedRegion(double sampleRate, int maxBlockSize);
+    void destroySharedRegion();
+    bool launchChild();
+    void reapChild(bool kill);
+    bool waitForChildReady(std::chrono::milliseconds timeout);
+    void watchdogLoop();
+
+    bool restartAllowed();
+    void collectOutput() noexcept;
+    void submitBlock(const float* const* channels, int numChannels, int numSamples,
+                     const juce::MidiBuffer& midi) noexcept;
+    void pushToFifo(const float* const* channels, int numChannels, int numSamples) noexcept;
+    void pushSilence(int numSamples) noexcept;
+
+    Config config_;
+    std::atomic<State> state_ { State::Stopped };
+
+    // Shared region
+    int regionFd_ = -1;
+    PluginHostTransport::SharedRegion* region_ = nullptr;
+    int maxBlockSize_ = 0;
+
+    // Child process (watchdog / message thread)
+    std::mutex processMutex_;
+    int childPid_ = -1;
+    std::thread watchdog_;
+    std::atomic<bool> watchdogRunning_ { false };
+    std::vector<std::chrono::steady_clock::time_point> recentRestarts_;
+
+    // Audio-thread state. At most one block is outstanding: everything
+    // submitted in earlier callbacks is resolved before the next submit.
+    uint64_t nextSerial_ = 0;
+    bool outstanding_ = false;
+    int outstandingSize_ = 0;
+    std::vector<float> fifo_;           // numChannels x fifoCapacity_, delayed output
+    int fifoCapacity_ = 0;
+    int fifoRead_ = 0;
+    int fifoLevel_ = 0;
+    std::array<PluginHostTransport::MidiEvent, PluginHostTransport::maxMidiEvents> midiOut_ {};
+    int numMidiOut_ = 0;
+
+    // Watchdog state
+    uint64_t lastHeartbeat_ = 0;
+    std::chrono::steady_clock::time_point lastProgress_;
+    std::chrono::steady_clock::time_point nextLaunch_;
+
+    // Statistics
+    std::atomic<uint64_t> blocksSubmitted_ { 0 };
+    std::atomic<uint64_t> blocksMissed_ { 0 };
+    std::atomic<uint64_t> lateBlocksDropped_ { 0 };
+    std::atomic<uint64_t> restarts_ { 0 };
+    std::atomic<uint64_t> crashes_ { 0 };
+    std::atomic<uint64_t> hangs_ { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutOfProcessPluginHost)
+};
+
+//==============================================================================
+/**
+ * Child side, run by the helper's main(). runIfRequested returns -1 when the
+ * process was not launched as a plugin host or plugin scanner
+ * (PluginScanner), otherwise the exit code to return.
+ */
+namespace PluginHostChild {
+
+constexpr const char* helperExecutableName = "SchillingerPluginHost";
+constexpr const char* commandLineFlag = "--schillinger-plugin-host";
+constexpr int regionFileDescriptor = 198;   // Where the engine maps the region in the child
+
+int runIfRequested(int argc, char** argv);
+
+/**
+ * Map the region the engine handed over on regionFileDescriptor and check
+ * its layout; nullptr if it is missing or from another version. Also ties
+ * the child's lifetime to the engine's.
+ */
+PluginHostTransport::SharedRegion* mapRegion();
+
+/**
+ * Serve blocks from a mapped region until shutdown or until the engine
+ * goes away. processBlock runs the hosted chain in place.
+ */
+using BlockProcessor = std::function<void(float* const* channels, int numChannels, int numSamples,
+                                          juce::MidiBuffer& midi)>;
+int serve(PluginHostTransport::SharedRegion& region, const BlockProcessor& processBlock);
+
+} // namespace PluginHostChild
+
+//==============================================================================
+/**
+ * AudioPluginInstance facade over an OutOfProcessPluginHost, so an isolated
+ * plugin can sit wherever an in-process one would (AudioProcessorGraph,
+ * AudioEngine's plugin map).
+ */
+class IsolatedPluginInstance : public juce::AudioPluginInstance {
+public:
+    explicit IsolatedPluginInstance(OutOfProcessPluginHost::Config config);
+    ~IsolatedPluginInstance() override;
+
+    OutOfProcessPluginHost& getHost() noexcept { return host_; }
+
+    const juce::String getName() const override;
+    void fillInPluginDescription(juce::PluginDescription& description) const override;
+
+    void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) override;
+
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return true; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+private:
+    OutOfProcessPluginHost::Config config_;
+    OutOfProcessPluginHost host_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IsolatedPluginInstance)
+};
+
+} // namespace SchillingerEcosystem::Audio
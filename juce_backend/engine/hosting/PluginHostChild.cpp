@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+    PluginHostChild.cpp
+
+    Child side of the plugin host subprocess: maps the engine's shared
+    region, loads the plugin chain and serves blocks until told to stop.
+  ==============================================================================
+*/
+
+#include "OutOfProcessPluginHost.h"
+#include "PluginScanner.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if JUCE_LINUX
+ #include <pthread.h>
+ #include <sched.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/prctl.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+namespace SchillingerEcosystem::Audio {
+
+using namespace PluginHostTransport;
+
+namespace PluginHostChild {
+
+int serve(SharedRegion& region, const BlockProcessor& processBlock) {
+#if JUCE_LINUX
+    const int numChannels = std::clamp(region.numChannels, 1, PluginHostTransport::maxChannels);
+    const pid_t engine = getppid();
+
+    // Scratch the hosted chain processes in; allocated before serving
+    std::vector<float> scratch(static_cast<size_t>(numChannels) * static_cast<size_t>(PluginHostTransport::maxBlockSize));
+    float* channels[PluginHostTransport::maxChannels] = {};
+    for (int ch = 0; ch < numChannels; ++ch) {
+        channels[ch] = scratch.data() + static_cast<size_t>(ch) * PluginHostTransport::maxBlockSize;
+    }
+
+    juce::MidiBuffer midi;
+    midi.ensureSize(static_cast<size_t>(PluginHostTransport::maxMidiEvents) * 8);
+
+    // Blocks queued for a previous child belong to callbacks long gone
+    region.input.discardPending();
+    region.childState.store(static_cast<uint32_t>(ChildState::Ready));
+
+    while (region.shutdownRequested.load() == 0 && getppid() == engine) {
+        region.heartbeat.fetch_add(1, std::memory_order_relaxed);
+
+        const BlockSlot* input = region.input.beginRead();
+        if (input == nullptr) {
+            // Recheck after sampling the futex word so a wake cannot slip in
+            // between; the timeout keeps the heartbeat going while idle
+            const uint32_t signal = region.inputSignal.load(std::memory_order_acquire);
+            if (region.input.beginRead() == nullptr) {
+                futexWait(region.inputSignal, signal, 100);
+            }
+            continue;
+        }
+
+        const uint64_t serial = input->serial;
+        const int numSamples = std::clamp(input->numSamples, 0, PluginHostTransport::maxBlockSize);
+
+        // The engine gave up on blocks it has already played as silence
+        if (serial < region.discardBefore.load(std::memory_order_relaxed)) {
+            region.input.endRead();
+            continue;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            std::memcpy(channels[ch], input->audio[ch], sizeof(float) * static_cast<size_t>(numSamples));
+        }
+
+        midi.clear();
+        const int numEvents = std::clamp(input->numMidiEvents, 0, PluginHostTransport::maxMidiEvents);
+        for (int i = 0; i < numEvents; ++i) {
+            const auto& event = input->midi[i];
+            midi.addEvent(event.bytes, event.size, static_cast<int>(event.sampleOffset));
+        }
+        region.input.endRead();
+
+        processBlock(channels, numChannels, numSamples, midi);
+
+        BlockSlot* output = region.output.beginWrite();
+        if (output == nullptr) {
+            continue;   // Engine is not draining; it will count the block as missed
+        }
+
+        output->serial = serial;
+        output->numChannels = numChannels;
+        output->numSamples = numSamples;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            std::memcpy(output->audio[ch], channels[ch], sizeof(float) * static_cast<size_t>(numSamples));
+        }
+
+        int numOut = 0;
+        for (const auto metadata : midi) {
+            if (numOut == PluginHostTransport::maxMidiEvents) {
+                break;
+            }
+            if (metadata.numBytes > 3) {
+                continue;
+            }
+            auto& event = output->midi[numOut++];
+            event.sampleOffset = static_cast<uint32_t>(std::max(0, metadata.samplePosition));
+            event.size = static_cast<uint8_t>(metadata.numBytes);
+            std::memcpy(event.bytes, metadata.data, static_cast<size_t>(metadata.numBytes));
+        }
+        output->numMidiEvents = numOut;
+
+        region.output.endWrite();
+        region.blocksProcessed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    region.childState.store(static_cast<uint32_t>(ChildState::Exiting));
+    return 0;
+#else
+    juce::ignoreUnused(region, processBlock);
+    return 1;
+#endif
+}
+
+SharedRegion* mapRegion() {
+#if JUCE_LINUX
+    // Never outlive the engine
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    struct stat info {};
+    if (fstat(regionFileDescriptor, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedRegion)) {
+        return nullptr;
+    }
+
+    void* memory = mmap(nullptr, sizeof(SharedRegion), PROT_READ | PROT_WRITE, MAP_SHARED, regionFileDescriptor, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto* region = static_cast<SharedRegion*>(memory);
+    if (region->magicNumber != PluginHostTransport::magic || region->layoutVersion != PluginHostTransport::version) {
+        munmap(memory, sizeof(SharedRegion));
+        return nullptr;
+    }
+    return region;
+#else
+    return nullptr;
+#endif
+}
+
+int runIfRequested(int argc, char** argv) {
+    if (argc == 3 && std::strcmp(argv[1], PluginScanner::commandLineFlag) == 0) {
+        return PluginScanner::runScanChild(juce::String::fromUTF8(argv[2]));
+    }
+
+    if (argc < 2 || std::strcmp(argv[1], commandLineFlag) != 0) {
+        return -1;
+    }
+
+#if JUCE_LINUX
+    SharedRegion* mapped = mapRegion();
+    if (mapped == nullptr) {
+        return 2;
+    }
+
+    auto& region = *mapped;
+    auto fail = [&region](const juce::String& reason) {
+        juce::Logger::writeToLog("Plugin host: " + reason);
+        region.childState.store(static_cast<uint32_t>(ChildState::LoadFailed));
+        return 3;
+    };
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::AudioPluginFormatManager formats;
+    formats.addDefaultFormats();
+
+    const double sampleRate = region.sampleRate;
+    const int blockSize = region.maxBlockSize;
+    const int numChannels = std::clamp(region.numChannels, 1, PluginHostTransport::maxChannels);
+
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> chain;
+    int latency = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        juce::OwnedArray<juce::PluginDescription> types;
+        for (auto* format : formats.getFormats()) {
+            format->findAllTypesForFile(types, argv[i]);
+        }
+        if (types.isEmpty()) {
+            return fail(juce::String("no plugin in ") + argv[i]);
+        }
+
+        juce::String error;
+        auto instance = formats.createPluginInstance(*types[0], sampleRate, blockSize, error);
+        if (instance == nullptr) {
+            return fail(juce::String(argv[i]) + ": " + error);
+        }
+
+        instance->setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        instance->prepareToPlay(sampleRate, blockSize);
+        latency += instance->getLatencySamples();
+        chain.push_back(std::move(instance));
+    }
+
+    if (chain.empty()) {
+        return fail("no plugins given");
+    }
+
+    region.latencySamples.store(latency);
+
+    // Match the engine's audio thread where the system allows it
+    sched_param priority {};
+    priority.sched_priority = std::max(1, sched_get_priority_max(SCHED_FIFO) - 10);
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &priority);
+
+    const int result = serve(region, [&chain](float* const* channels, int numChannels, int numSamples,
+                                               juce::MidiBuffer& midi) {
+        for (auto& plugin : chain) {
+            juce::AudioBuffer<float> buffer(channels, numChannels, numSamples);
+            plugin->processBlock(buffer, midi);
+        }
+    });
+
+    for (auto& plugin : chain) {
+        plugin->releaseResources();
+    }
+    return result;
+#else
+    return 1;
+#endif
+}
+
+} // namespace PluginHostChild
+
+} // namespace SchillingerEcosystem::Audio
@@ -0,0 +1,23 @@
+/*
+  ==============================================================================
+    PluginHostMain.cpp
+
+    Entry point of the SchillingerPluginHost helper: the child process
+    OutOfProcessPluginHost hosts plugins in and PluginScanner scans them in.
+    Installed next to every binary that hosts or scans plugins.
+  ==============================================================================
+*/
+
+#include "OutOfProcessPluginHost.h"
+
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    const int result = SchillingerEcosystem::Audio::PluginHostChild::runIfRequested(argc, argv);
+    if (result < 0) {
+        std::fprintf(stderr, "%s is started by the engine, not by hand\n",
+                     SchillingerEcosystem::Audio::PluginHostChild::helperExecutableName);
+        return 1;
+    }
+    return result;
+}
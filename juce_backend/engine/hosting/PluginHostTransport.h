@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+    PluginHostTransport.h
+
+    Shared-memory layout between the engine and a plugin host subprocess:
+    single-producer/single-consumer rings of audio+MIDI blocks in each
+    direction, a futex word that wakes the child, and a heartbeat the
+    engine's watchdog reads. Everything in the region is trivially copyable
+    or a lock-free atomic, so both processes can map it at any address.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if JUCE_LINUX
+ #include <climits>
+ #include <ctime>
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+namespace SchillingerEcosystem::Audio {
+
+namespace PluginHostTransport {
+
+constexpr uint32_t magic = 0x53504854;      // "SPHT"
+constexpr uint32_t version = 1;
+
+constexpr int maxChannels = 8;
+constexpr int maxBlockSize = 4096;
+constexpr int maxMidiEvents = 256;
+constexpr int ringSlots = 4;                // Power of two
+
+/** Short MIDI message; sysex does not cross the process boundary */
+struct MidiEvent {
+    uint32_t sampleOffset;
+    uint8_t size;
+    uint8_t bytes[3];
+};
+
+/** One block in flight; serial ties an output block to its input block */
+struct BlockSlot {
+    uint64_t serial;
+    int32_t numChannels;
+    int32_t numSamples;
+    int32_t numMidiEvents;
+    MidiEvent midi[maxMidiEvents];
+    float audio[maxChannels][maxBlockSize];
+};
+
+/**
+ * SPSC ring of block slots. The producer fills slots[head % ringSlots] and
+ * then publishes head; the consumer reads slots[tail % ringSlots] and then
+ * publishes tail. Indices only grow, so full is head - tail == ringSlots.
+ */
+struct BlockRing {
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) std::array<BlockSlot, ringSlots> slots;
+
+    BlockSlot* beginWrite() noexcept {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= static_cast<uint64_t>(ringSlots)) {
+            return nullptr;
+        }
+        return &slots[h % ringSlots];
+    }
+
+    void endWrite() noexcept {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    const BlockSlot* beginRead() noexcept {
+        const uint64_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots[t % ringSlots];
+    }
+
+    void endRead() noexcept {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /** Consumer side: drop everything queued (a new child starting up) */
+    void discardPending() noexcept {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+};
+
+enum class ChildState : uint32_t {
+    Starting = 0,
+    Ready,          // Plugins loaded and prepared, serving blocks
+    LoadFailed,     // Gave up; the engine must not restart it
+    Exiting
+};
+
+/** The whole shared region, created by the engine and sized with sizeof */
+struct SharedRegion {
+    uint32_t magicNumber;
+    uint32_t layoutVersion;
+    double sampleRate;
+    int32_t maxBlockSize;
+    int32_t numChannels;
+
+    alignas(64) std::atomic<uint32_t> childState;
+    std::atomic<int32_t> latencySamples;        // Reported by the hosted plugins
+    alignas(64) std::atomic<uint32_t> inputSignal;  // Futex word, bumped per submitted block
+    std::atomic<uint32_t> shutdownRequested;
+    std::atomic<uint64_t> discardBefore;            // Serials the engine already replaced with silence
+    alignas(64) std::atomic<uint64_t> heartbeat;    // Bumped by the child every loop turn
+    std::atomic<uint64_t> blocksProcessed;
+
+    BlockRing input;        // Engine -> child
+    BlockRing output;       // Child -> engine
+};
+
+static_assert(std::is_trivially_copyable_v<MidiEvent> && std::is_trivially_copyable_v<BlockSlot>,
+              "Shared blocks must be plain data");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "Cross-process atomics must be lock-free");
+
+//==============================================================================
+// Futex wrappers (shared, not PROCESS_PRIVATE: the word lives in a mapping
+// both processes see)
+
+#if JUCE_LINUX
+inline void futexWake(std::atomic<uint32_t>& word) noexcept {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/** Sleeps while word == expected, at most timeoutMs; spurious returns are fine */
+inline void futexWait(std::atomic<uint32_t>& word, uint32_t expected, int timeoutMs) noexcept {
+    timespec timeout { timeoutMs / 1000, static_cast<long>(timeoutMs % 1000) * 1000000L };
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+#endif
+
+} // namespace PluginHostTransport
+
+} // namespace SchillingerEcosystem::Audio
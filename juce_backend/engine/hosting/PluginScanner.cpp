@@ -0,0 +1,570 @@
+/*
+  ==============================================================================
+    PluginScanner.cpp
+
+    Scan cache persistence and validation, candidate discovery, and the
+    parallel crash-isolated scan (engine side and child side).
+  ==============================================================================
+*/
+
+#include "PluginScanner.h"
+#include "OutOfProcessPluginHost.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <thread>
+
+#if JUCE_LINUX
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <signal.h>
+ #include <spawn.h>
+ #include <sys/prctl.h>
+ #include <sys/wait.h>
+ #include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace SchillingerEcosystem::Audio {
+
+namespace {
+
+constexpr int cacheFormatVersion = 1;
+
+bool isFailure(PluginScanCache::Status status) {
+    return status == PluginScanCache::Status::Failed ||
+           status == PluginScanCache::Status::Crashed ||
+           status == PluginScanCache::Status::TimedOut ||
+           status == PluginScanCache::Status::NotScanned;
+}
+
+/** Regular files making up a plugin, sorted so bundle hashes are stable */
+juce::Array<juce::File> getPluginFiles(const juce::File& plugin) {
+    juce::Array<juce::File> files;
+    if (plugin.isDirectory()) {
+        files = plugin.findChildFiles(juce::File::findFiles, true);
+        std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b) {
+            return a.getFullPathName() < b.getFullPathName();
+        });
+    } else if (plugin.existsAsFile()) {
+        files.add(plugin);
+    }
+    return files;
+}
+
+} // namespace
+
+//==============================================================================
+// PluginScanCache Implementation
+
+PluginScanCache::PluginScanCache(juce::File cacheFile)
+    : cacheFile_(std::move(cacheFile))
+{
+}
+
+juce::File PluginScanCache::getDefaultCacheFile() {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("SchillingerEcosystem")
+        .getChildFile("PluginScanCache.xml");
+}
+
+bool PluginScanCache::load() {
+    auto xml = juce::parseXML(cacheFile_);
+    if (xml == nullptr || !xml->hasTagName("PLUGINSCANCACHE") ||
+        xml->getIntAttribute("version") != cacheFormatVersion) {
+        return false;
+    }
+
+    std::map<juce::String, Entry> loaded;
+    for (auto* fileXml : xml->getChildWithTagNameIterator("FILE")) {
+        Entry entry;
+        entry.path = fileXml->getStringAttribute("path");
+        entry.size = fileXml->getStringAttribute("size").getLargeIntValue();
+        entry.modificationTime = fileXml->getStringAttribute("modified").getLargeIntValue();
+        entry.contentHash = fileXml->getStringAttribute("hash");
+        entry.status = statusFromString(fileXml->getStringAttribute("status"));
+        entry.error = fileXml->getStringAttribute("error");
+
+        for (auto* pluginXml : fileXml->getChildWithTagNameIterator("PLUGIN")) {
+            juce::PluginDescription description;
+            if (description.loadFromXml(*pluginXml)) {
+                entry.descriptions.push_back(description);
+            }
+        }
+
+        if (entry.path.isNotEmpty()) {
+            const auto path = entry.path;
+            loaded[path] = std::move(entry);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_ = std::move(loaded);
+    dirty_ = false;
+    return true;
+}
+
+bool PluginScanCache::save() {
+    juce::XmlElement xml("PLUGINSCANCACHE");
+    xml.setAttribute("version", cacheFormatVersion);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_ && cacheFile_.existsAsFile()) {
+            return true;
+        }
+
+        for (const auto& [path, entry] : entries_) {
+            auto* fileXml = xml.createNewChildElement("FILE");
+            fileXml->setAttribute("path", entry.path);
+            fileXml->setAttribute("size", juce::String(entry.size));
+            fileXml->setAttribute("modified", juce::String(entry.modificationTime));
+            fileXml->setAttribute("hash", entry.contentHash);
+            fileXml->setAttribute("status", statusToString(entry.status));
+            if (entry.error.isNotEmpty()) {
+                fileXml->setAttribute("error", entry.error);
+            }
+            for (const auto& description : entry.descriptions) {
+                fileXml->addChildElement(description.createXml().release());
+            }
+        }
+        dirty_ = false;
+    }
+
+    cacheFile_.getParentDirectory().createDirectory();
+    return xml.writeTo(cacheFile_);
+}
+
+std::optional<PluginScanCache::Entry> PluginScanCache::lookup(const juce::File& plugin, juce::String* hashOut) {
+    if (hashOut != nullptr) {
+        *hashOut = {};
+    }
+
+    const auto print = fingerprint(plugin);
+    if (!print.exists) {
+        return std::nullopt;
+    }
+
+    const auto path = plugin.getFullPathName();
+    juce::String cachedHash;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = entries_.find(path);
+        if (it == entries_.end()) {
+            return std::nullopt;    // Never seen: the scan hashes it
+        }
+        if (it->second.size == print.size && it->second.modificationTime == print.modificationTime) {
+            return it->second;
+        }
+        cachedHash = it->second.contentHash;
+    }
+
+    // Stamp changed; only the content decides
+    const auto hash = hashContents(plugin);
+    if (hashOut != nullptr) {
+        *hashOut = hash;
+    }
+    if (hash.isEmpty() || hash != cachedHash) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(path);
+    if (it == entries_.end() || it->second.contentHash != hash) {
+        return std::nullopt;
+    }
+    it->second.size = print.size;
+    it->second.modificationTime = print.modificationTime;
+    dirty_ = true;
+    return it->second;
+}
+
+juce::String PluginScanCache::getCachedHash(const juce::File& plugin) const {
+    const auto print = fingerprint(plugin);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(plugin.getFullPathName());
+    if (!print.exists || it == entries_.end() ||
+        it->second.size != print.size || it->second.modificationTime != print.modificationTime) {
+        return {};
+    }
+    return it->second.contentHash;
+}
+
+void PluginScanCache::store(Entry entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto path = entry.path;
+    entries_[path] = std::move(entry);
+    dirty_ = true;
+}
+
+void PluginScanCache::remove(const juce::String& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_ = entries_.erase(path) > 0 || dirty_;
+}
+
+void PluginScanCache::removeMissing() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (!juce::File(it->first).exists()) {
+            it = entries_.erase(it);
+            dirty_ = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void PluginScanCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    dirty_ = true;
+}
+
+size_t PluginScanCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+PluginScanCache::Fingerprint PluginScanCache::fingerprint(const juce::File& plugin) {
+    Fingerprint print;
+    print.exists = plugin.exists();
+    if (!print.exists) {
+        return print;
+    }
+
+    print.modificationTime = plugin.getLastModificationTime().toMilliseconds();
+    for (const auto& file : getPluginFiles(plugin)) {
+        print.size += file.getSize();
+        print.modificationTime = std::max(print.modificationTime, file.getLastModificationTime().toMilliseconds());
+    }
+    return print;
+}
+
+juce::String PluginScanCache::hashContents(const juce::File& plugin) {
+    if (plugin.existsAsFile()) {
+        return juce::SHA256(plugin).toHexString();
+    }
+
+    // Bundle: hash of every member's relative path and hash
+    const auto files = getPluginFiles(plugin);
+    if (files.isEmpty()) {
+        return {};
+    }
+
+    juce::String manifest;
+    for (const auto& file : files) {
+        manifest << file.getRelativePathFrom(plugin) << ':' << juce::SHA256(file).toHexString() << '\n';
+    }
+    return juce::SHA256(manifest.toUTF8()).toHexString();
+}
+
+juce::String PluginScanCache::statusToString(Status status) {
+    switch (status) {
+        case Status::Scanned:   return "scanned";
+        case Status::NoPlugins: return "empty";
+        case Status::Failed:    return "failed";
+        case Status::Crashed:   return "crashed";
+        case Status::TimedOut:  return "timeout";
+        case Status::NotScanned: return "not scanned";
+    }
+    return "failed";
+}
+
+PluginScanCache::Status PluginScanCache::statusFromString(const juce::String& text) {
+    if (text == "scanned") return Status::Scanned;
+    if (text == "empty")   return Status::NoPlugins;
+    if (text == "crashed") return Status::Crashed;
+    if (text == "timeout") return Status::TimedOut;
+    return Status::Failed;
+}
+
+//==============================================================================
+// PluginScanner Implementation
+
+PluginScanner::PluginScanner(PluginScanCache& cache, Options options)
+    : cache_(cache), options_(std::move(options))
+{
+}
+
+juce::StringArray PluginScanner::findCandidateFiles(const juce::StringArray& directories) {
+    juce::FileSearchPath searchPath;
+    for (const auto& directory : directories) {
+        searchPath.add(juce::File(directory));
+    }
+
+    juce::AudioPluginFormatManager formats;
+    formats.addDefaultFormats();
+
+    juce::StringArray files;
+    for (auto* format : formats.getFormats()) {
+        if (!format->canScanForPlugins()) {
+            continue;
+        }
+        for (const auto& identifier : format->searchPathsForPlugins(searchPath, true, false)) {
+            if (juce::File::isAbsolutePath(identifier)) {
+                files.addIfNotAlreadyThere(identifier);
+            }
+        }
+    }
+
+    files.sort(false);
+    return files;
+}
+
+PluginScanner::Results PluginScanner::scan(const juce::StringArray& directories) {
+    cache_.removeMissing();
+    return scanFiles(findCandidateFiles(directories));
+}
+
+PluginScanner::Results PluginScanner::scanFiles(const juce::StringArray& files) {
+    Results results;
+    results.entries.resize(static_cast<size_t>(files.size()));
+
+    std::atomic<int> nextFile { 0 };
+    std::atomic<int> fromCache { 0 };
+    std::atomic<int> scanned { 0 };
+    std::atomic<int> failed { 0 };
+
+    auto worker = [&] {
+        for (int i = nextFile++; i < files.size(); i = nextFile++) {
+            const juce::File plugin(files[i]);
+
+            juce::String hash;
+            auto cached = cache_.lookup(plugin, &hash);
+            if (cached && !(options_.rescanFailed && isFailure(cached->status))) {
+                ++fromCache;
+                failed += isFailure(cached->status) ? 1 : 0;
+                results.entries[static_cast<size_t>(i)] = std::move(*cached);
+                continue;
+            }
+
+            auto entry = scanFile(plugin, hash);
+            ++scanned;
+            failed += isFailure(entry.status) ? 1 : 0;
+            if (isFailure(entry.status)) {
+                juce::Logger::writeToLog("Plugin scan " + PluginScanCache::statusToString(entry.status) +
+                                         ": " + entry.path + (entry.error.isNotEmpty() ? " (" + entry.error + ")" : juce::String()));
+            }
+
+            // A scanner that never ran says nothing about the plugin
+            if (entry.status != PluginScanCache::Status::NotScanned) {
+                cache_.store(entry);
+            }
+            results.entries[static_cast<size_t>(i)] = std::move(entry);
+        }
+    };
+
+#if JUCE_LINUX
+    // Workers mostly wait on their child processes
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int parallelScans = options_.maxParallelScans > 0 ? options_.maxParallelScans : hardwareThreads;
+    const int numWorkers = std::clamp(files.size(), 1, parallelScans);
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < numWorkers; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+#else
+    // In-process scans instantiate plugins, which wants the message thread
+    worker();
+#endif
+
+    results.filesFromCache = fromCache.load();
+    results.filesScanned = scanned.load();
+    results.filesFailed = failed.load();
+
+    if (!cache_.save()) {
+        juce::Logger::writeToLog("Failed to write plugin scan cache");
+    }
+    return results;
+}
+
+PluginScanCache::Entry PluginScanner::scanFile(const juce::File& plugin, const juce::String& knownHash) {
+    PluginScanCache::Entry entry;
+    entry.path = plugin.getFullPathName();
+
+    // Stamp before scanning: a file replaced mid-scan is rescanned next time
+    const auto print = PluginScanCache::fingerprint(plugin);
+    entry.size = print.size;
+    entry.modificationTime = print.modificationTime;
+    entry.contentHash = knownHash.isNotEmpty() ? knownHash : PluginScanCache::hashContents(plugin);
+
+    auto fail = [&entry](PluginScanCache::Status status, const juce::String& error) {
+        entry.status = status;
+        entry.error = error;
+        return entry;
+    };
+
+    if (!print.exists) {
+        return fail(PluginScanCache::Status::Failed, "file not found");
+    }
+
+#if JUCE_LINUX
+    std::string executable = options_.executable.empty() ? OutOfProcessPluginHost::getDefaultExecutable()
+                                                         : options_.executable;
+    if (executable.empty()) {
+        return fail(PluginScanCache::Status::NotScanned,
+                    juce::String(PluginHostChild::helperExecutableName) + " not found");
+    }
+
+    int pipeFds[2];
+    if (pipe2(pipeFds, O_CLOEXEC) != 0) {
+        return fail(PluginScanCache::Status::NotScanned, "cannot start scanner process");
+    }
+
+    std::string flag = commandLineFlag;
+    std::string path = entry.path.toStdString();
+    char* argv[] = { executable.data(), flag.data(), path.data(), nullptr };
+
+    // The result pipe is the only descriptor the child inherits (dup2 clears CLOEXEC)
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], resultFileDescriptor);
+
+    pid_t pid = -1;
+    const int spawned = posix_spawn(&pid, executable.c_str(), &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipeFds[1]);
+
+    if (spawned != 0) {
+        close(pipeFds[0]);
+        return fail(PluginScanCache::Status::NotScanned, "cannot start scanner process");
+    }
+
+    // Read until the child exits; helpers a plugin forks may hold the pipe
+    // open, so exit is checked directly rather than waiting for EOF
+    std::string output;
+    int status = 0;
+    bool exited = false;
+    const auto deadline = std::chrono::steady_clock::now() + options_.timeoutPerFile;
+
+    auto drain = [&output, fd = pipeFds[0]] {
+        char buffer[4096];
+        for (;;) {
+            pollfd readable { fd, POLLIN, 0 };
+            if (poll(&readable, 1, 0) <= 0) {
+                return;
+            }
+            const ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                return;
+            }
+            output.append(buffer, static_cast<size_t>(n));
+        }
+    };
+
+    while (!exited && std::chrono::steady_clock::now() < deadline) {
+        pollfd readable { pipeFds[0], POLLIN, 0 };
+        if (poll(&readable, 1, 50) > 0) {
+            drain();
+        }
+        exited = waitpid(pid, &status, WNOHANG) == pid;
+    }
+    drain();
+    close(pipeFds[0]);
+
+    if (!exited) {
+        ::kill(pid, SIGKILL);
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        return fail(PluginScanCache::Status::TimedOut,
+                    "no result after " + juce::String(static_cast<int>(options_.timeoutPerFile.count())) + " ms");
+    }
+
+    if (WIFSIGNALED(status)) {
+        return fail(PluginScanCache::Status::Crashed, "scanner died with signal " + juce::String(WTERMSIG(status)));
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return fail(PluginScanCache::Status::Failed, "scanner exited with code " + juce::String(WEXITSTATUS(status)));
+    }
+
+    auto result = juce::parseXML(juce::String::fromUTF8(output.data(), static_cast<int>(output.size())));
+    if (result == nullptr || !result->hasTagName("SCANRESULT")) {
+        return fail(PluginScanCache::Status::Failed, "unreadable scanner output");
+    }
+
+    for (auto* pluginXml : result->getChildWithTagNameIterator("PLUGIN")) {
+        juce::PluginDescription description;
+        if (description.loadFromXml(*pluginXml)) {
+            entry.descriptions.push_back(description);
+        }
+    }
+    entry.error = result->getStringAttribute("error");
+#else
+    juce::OwnedArray<juce::PluginDescription> types;
+    describeFile(entry.path, types);
+    for (auto* type : types) {
+        entry.descriptions.push_back(*type);
+    }
+#endif
+
+    if (entry.error.isNotEmpty()) {
+        entry.status = PluginScanCache::Status::Failed;
+    } else {
+        entry.status = entry.descriptions.empty() ? PluginScanCache::Status::NoPlugins
+                                                  : PluginScanCache::Status::Scanned;
+    }
+    return entry;
+}
+
+void PluginScanner::describeFile(const juce::String& path, juce::OwnedArray<juce::PluginDescription>& types) {
+    juce::AudioPluginFormatManager formats;
+    formats.addDefaultFormats();
+
+    for (auto* format : formats.getFormats()) {
+        if (format->fileMightContainThisPluginType(path)) {
+            format->findAllTypesForFile(types, path);
+        }
+    }
+}
+
+int PluginScanner::runScanChild(const juce::String& path) {
+#if JUCE_LINUX
+    // Never outlive the engine
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    juce::XmlElement result("SCANRESULT");
+    {
+        juce::ScopedJuceInitialiser_GUI juceInitialiser;
+        juce::OwnedArray<juce::PluginDescription> types;
+
+        try {
+            describeFile(path, types);
+        } catch (const std::exception& e) {
+            result.setAttribute("error", juce::String(e.what()));
+        } catch (...) {
+            result.setAttribute("error", "unknown exception");
+        }
+
+        for (auto* type : types) {
+            result.addChildElement(type->createXml().release());
+        }
+    }
+
+    const std::string text = result.toString().toStdString();
+    size_t written = 0;
+    while (written < text.size()) {
+        const ssize_t n = write(resultFileDescriptor, text.data() + written, text.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return 4;
+        }
+        written += static_cast<size_t>(n);
+    }
+    close(resultFileDescriptor);
+    return 0;
+#else
+    juce::ignoreUnused(path);
+    return 1;
+#endif
+}
+
+} // namespace SchillingerEcosystem::Audio
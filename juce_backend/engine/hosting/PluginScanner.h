@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+    PluginScanner.h
+
+    Parallel, crash-isolated plugin scanning backed by a persistent cache of
+    scan results keyed by path, size, modification time and content hash.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace SchillingerEcosystem::Audio {
+
+//==============================================================================
+/**
+ * Scan results per plugin file, persisted as XML
+ *
+ * An entry is valid while its file is unchanged. Size and modification time
+ * are checked first; only when they differ is the content rehashed, and a
+ * matching hash (a touched or copied file) just refreshes the stamp. The
+ * stored hash is the file's SHA-256, so integrity checks can take it from
+ * here instead of reading the binary again.
+ */
+class PluginScanCache {
+public:
+    enum class Status {
+        Scanned,        // Plugins found (descriptions holds them)
+        NoPlugins,      // Loaded fine, nothing in it
+        Failed,         // Scanner reported an error
+        Crashed,        // Scanner process died
+        TimedOut,       // Scanner process killed after the deadline
+        NotScanned      // Scanner process could not be started; never cached
+    };
+
+    struct Entry {
+        juce::String path;
+        juce::int64 size = 0;
+        juce::int64 modificationTime = 0;       // Milliseconds since the epoch
+        juce::String contentHash;
+        Status status = Status::NoPlugins;
+        juce::String error;
+        std::vector<juce::PluginDescription> descriptions;
+    };
+
+    /** Size and newest modification time; bundles (directories) cover every file inside */
+    struct Fingerprint {
+        bool exists = false;
+        juce::int64 size = 0;
+        juce::int64 modificationTime = 0;
+    };
+
+    explicit PluginScanCache(juce::File cacheFile);
+
+    /** Default location in the user's application data directory */
+    static juce::File getDefaultCacheFile();
+
+    bool load();
+    bool save();
+
+    /**
+     * The cached entry if the plugin on disk is unchanged. On a miss,
+     * hashOut receives the content hash computed for the comparison (empty
+     * if none was needed) so the caller does not hash the file again.
+     */
+    std::optional<Entry> lookup(const juce::File& plugin, juce::String* hashOut = nullptr);
+
+    /** Content hash of an unchanged cached plugin, empty otherwise; never reads the file */
+    juce::String getCachedHash(const juce::File& plugin) const;
+
+    void store(Entry entry);
+    void remove(const juce::String& path);
+    void removeMissing();       // Drop entries whose file is gone
+    void clear();
+    size_t size() const;
+
+    static Fingerprint fingerprint(const juce::File& plugin);
+    static juce::String hashContents(const juce::File& plugin);
+
+    static juce::String statusToString(Status status);
+    static Status statusFromString(const juce::String& text);
+
+private:
+    juce::File cacheFile_;
+    mutable std::mutex mutex_;
+    std::map<juce::String, Entry> entries_;
+    bool dirty_ = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginScanCache)
+};
+
+//==============================================================================
+/**
+ * Finds plugin files and scans the ones the cache cannot answer for
+ *
+ * Each file is scanned in its own short-lived child process (Linux), the
+ * SchillingerPluginHost helper (see OutOfProcessPluginHost), so a plugin
+ * that crashes or hangs while being instantiated only fails its own entry.
+ * Several children run at once. Without the helper nothing is scanned and
+ * nothing is cached, so files are picked up once it is installed. Failures are cached too: a
+ * broken plugin is not retried until it changes on disk (or rescanFailed).
+ * Elsewhere files are scanned in-process on the calling thread.
+ */
+class PluginScanner {
+public:
+    struct Options {
+        int maxParallelScans = 0;                       // 0: hardware threads
+        std::chrono::milliseconds timeoutPerFile { 30000 };
+        std::string executable;                         // Empty: the helper (getDefaultExecutable)
+        bool rescanFailed = false;
+    };
+
+    struct Results {
+        std::vector<PluginScanCache::Entry> entries;    // One per candidate file
+        int filesFromCache = 0;
+        int filesScanned = 0;
+        int filesFailed = 0;                            // Failed, crashed or timed out
+    };
+
+    PluginScanner(PluginScanCache& cache, Options options);
+
+    /** Candidate plugin files under the directories, for every default format */
+    static juce::StringArray findCandidateFiles(const juce::StringArray& directories);
+
+    /** Scan (or take from the cache) every candidate and save the cache */
+    Results scan(const juce::StringArray& directories);
+    Results scanFiles(const juce::StringArray& files);
+
+    /** Scan one file in a child process; the cache is not consulted */
+    PluginScanCache::Entry scanFile(const juce::File& plugin, const juce::String& knownHash);
+
+    /** Child side, reached through PluginHostChild::runIfRequested() in the helper */
+    static constexpr const char* commandLineFlag = "--schillinger-plugin-scan";
+    static constexpr int resultFileDescriptor = 199;
+    static int runScanChild(const juce::String& path);
+
+private:
+    static void describeFile(const juce::String& path, juce::OwnedArray<juce::PluginDescription>& types);
+
+    PluginScanCache& cache_;
+    Options options_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginScanner)
+};
+
+} // namespace SchillingerEcosystem::Audio
@@ -1,7 +1,9 @@
 #include "InstrumentManager.h"
 #include "InstrumentInstance.h"
+#include "InstrumentRegistry.h"
 #include "PluginManager.h"
 #include "../plugins/PluginInstance.h"
+#include "../hosting/PluginScanner.h"
 #include <juce_core/juce_core.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <algorithm>
@@ -19,6 +21,9 @@ InstrumentManager::InstrumentManager()
     currentBlockSize = 512;
     poolingEnabled = true;
 
+    registry = std::make_unique<InstrumentRegistry>();
+    registry->setAudioConfiguration(currentSampleRate, currentBlockSize);
+
     // Set up preset directory
     presetDirectory = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
                         .getChildFile("SchillingerEcosystem")
@@ -31,10 +36,19 @@ InstrumentManager::InstrumentManager()
 
     // Update initial statistics
     updateStatistics();
+
+    poolMaintainer = std::thread([this] { poolMaintenanceLoop(); });
 }
 
 InstrumentManager::~InstrumentManager()
 {
+    {
+        std::lock_guard<std::mutex> lock(poolMaintainerMutex);
+        stopPoolMaintainer = true;
+    }
+    poolMaintainerWake.notify_one();
+    poolMaintainer.join();
+
     // Save presets database
     savePresetsDatabase();
 
@@ -76,6 +90,15 @@ bool InstrumentManager::registerBuiltInSynth(const juce::String& identifier,
 
     instruments[identifier] = entry;
 
+    auto registryInfo = info;
+    registryInfo.identifier = identifier;
+    const auto handle = registry->registerInstrument(registryInfo, factory, entry->maxInstances);
+
+    // Built-in synths are cheap to construct ahead of time; external plugins
+    // are only created on demand
+    if (poolingEnabled && handle.isValid() && info.type == InstrumentType::BuiltInSynthesizer)
+        registry->prewarm(handle, builtInPoolSize);
+
     juce::Logger::writeToLog("Registered built-in synth: " + identifier);
     updateStatistics();
 
@@ -92,6 +115,7 @@ InstrumentManager::ScanResults InstrumentManager::scanExternalPlugins(const juce
         return results;
     }
 
+    juce::StringArray searchDirectories;
     for (const auto& directory : directories)
     {
         juce::File dir(directory);
@@ -100,29 +124,88 @@ InstrumentManager::ScanResults InstrumentManager::scanExternalPlugins(const juce
             results.errors.add("Invalid directory: " + directory);
             continue;
         }
+        searchDirectories.add(directory);
+    }
 
-        try
+    if (searchDirectories.isEmpty())
+        return results;
+
+    if (!pluginScanCache)
+    {
+        pluginScanCache = std::make_unique<Audio::PluginScanCache>(Audio::PluginScanCache::getDefaultCacheFile());
+        pluginScanCache->load();
+    }
+
+    Audio::PluginScanner scanner(*pluginScanCache, {});
+    const auto scanned = scanner.scan(searchDirectories);
+
+    for (const auto& entry : scanned.entries)
+    {
+        if (entry.status != Audio::PluginScanCache::Status::Scanned)
         {
-            juce::StringArray directories;
-            directories.add(directory);
-            auto scanResult = pluginManager->scanPlugins(directories);
-            results.pluginsFound += scanResult.totalPluginsFound;
-            results.pluginsLoaded += scanResult.validPluginsLoaded;
-            results.pluginsFailed += scanResult.invalidPluginsSkipped;
-
-            for (const auto& error : scanResult.errors)
-                results.errors.add(error);
+            if (entry.status != Audio::PluginScanCache::Status::NoPlugins)
+            {
+                results.pluginsFailed++;
+                results.errors.add(entry.path + ": " + Audio::PluginScanCache::statusToString(entry.status)
+                                   + (entry.error.isNotEmpty() ? " (" + entry.error + ")" : juce::String()));
+            }
+            continue;
         }
-        catch (const std::exception& e)
+
+        for (const auto& description : entry.descriptions)
         {
-            results.errors.add("Exception scanning " + directory + ": " + e.what());
+            results.pluginsFound++;
+            if (registerScannedPlugin(description))
+                results.pluginsLoaded++;
+            else
+                results.pluginsFailed++;
         }
     }
 
+    juce::Logger::writeToLog("Plugin scan: " + juce::String(scanned.filesScanned) + " files scanned, "
+                             + juce::String(scanned.filesFromCache) + " from cache");
+
     updateStatistics();
     return results;
 }
 
+bool InstrumentManager::registerScannedPlugin(const juce::PluginDescription& description)
+{
+    const auto identifier = description.createIdentifierString();
+    if (isInstrumentAvailable(identifier))
+        return true;    // Registered by an earlier scan
+
+    InstrumentInfo info;
+    info.identifier = identifier;
+    info.name = description.name;
+    info.category = description.category.isNotEmpty() ? description.category : juce::String("External Plugin");
+    info.manufacturer = description.manufacturerName;
+    info.version = description.version;
+    info.type = InstrumentType::ExternalPlugin;
+    info.formats.add(description.pluginFormatName);
+    info.description = description.descriptiveName;
+    info.isInstrument = description.isInstrument;
+    info.hasCustomUI = true;
+    info.supportsMIDI = description.isInstrument;
+    info.maxVoices = 0;
+    info.numInputs = description.numInputChannels;
+    info.numOutputs = description.numOutputChannels;
+    info.sampleRate = currentSampleRate;
+    info.blockSize = currentBlockSize;
+
+    auto factory = [this, filePath = description.fileOrIdentifier]() -> std::unique_ptr<InstrumentInstance> {
+        auto plugin = pluginManager->loadPlugin(filePath);
+        if (plugin)
+        {
+            plugin->prepareToPlay(currentSampleRate, currentBlockSize);
+            return plugin;
+        }
+        return nullptr;
+    };
+
+    return registerBuiltInSynth(identifier, factory, info);
+}
+
 bool InstrumentManager::loadExternalPlugin(const juce::String& filePath)
 {
     if (!pluginManager)
@@ -195,14 +278,16 @@ std::vector<InstrumentInfo> InstrumentManager::getAvailableInstruments() const
 
 std::vector<InstrumentInfo> InstrumentManager::getInstrumentsByCategory(const juce::String& category) const
 {
-    auto allInstruments = getAvailableInstruments();
+    // Precomputed index in the registry snapshot; no lock, no scan
+    auto snapshot = registry->getSnapshot();
+    const auto& handles = snapshot->category(category);
+
     std::vector<InstrumentInfo> result;
+    result.reserve(handles.size());
 
-    std::copy_if(allInstruments.begin(), allInstruments.end(),
-                 std::back_inserter(result),
-                 [&category](const InstrumentInfo& info) {
-                     return info.category.equalsIgnoreCase(category);
-                 });
+    for (const auto& handle : handles)
+        if (const auto* record = registry->getRecord(handle))
+            result.push_back(record->info);
 
     return result;
 }
@@ -223,25 +308,15 @@ std::vector<InstrumentInfo> InstrumentManager::getInstrumentsByType(InstrumentTy
 
 std::vector<InstrumentInfo> InstrumentManager::searchInstruments(const juce::String& query) const
 {
-    auto allInstruments = getAvailableInstruments();
     std::vector<InstrumentInfo> result;
 
     if (query.isEmpty())
         return result;
 
-    juce::String lowercaseQuery = query.toLowerCase();
-
-    std::copy_if(allInstruments.begin(), allInstruments.end(),
-                 std::back_inserter(result),
-                 [&lowercaseQuery](const InstrumentInfo& info) {
-                     return info.name.toLowerCase().contains(lowercaseQuery) ||
-                            info.description.toLowerCase().contains(lowercaseQuery) ||
-                            info.manufacturer.toLowerCase().contains(lowercaseQuery) ||
-                            std::any_of(info.tags.begin(), info.tags.end(),
-                                       [&lowercaseQuery](const juce::String& tag) {
-                                           return tag.toLowerCase().contains(lowercaseQuery);
-                                       });
-                 });
+    // Matches against the lower-cased search text precomputed at registration
+    for (const auto& handle : registry->search(query))
+        if (const auto* record = registry->getRecord(handle))
+            result.push_back(record->info);
 
     return result;
 }
@@ -474,6 +549,8 @@ void InstrumentManager::setAudioConfiguration(double sampleRate, int blockSize)
     currentSampleRate = sampleRate;
     currentBlockSize = blockSize;
 
+    registry->setAudioConfiguration(sampleRate, blockSize);
+
     // Update all active instances
     for (auto* instance : getActiveInstances())
     {
@@ -499,6 +576,13 @@ void InstrumentManager::setMaxInstances(const juce::String& identifier, int maxI
 void InstrumentManager::setInstrumentPoolingEnabled(bool enabled)
 {
     poolingEnabled = enabled;
+
+    // Pools above the new target drain as their instances are released
+    const auto snapshot = registry->getSnapshot();
+    for (const auto& record : snapshot->records)
+        if (record->info.type == InstrumentType::BuiltInSynthesizer)
+            registry->prewarm(record->handle, enabled ? builtInPoolSize : 0);
+
     juce::Logger::writeToLog("Instrument pooling: " + juce::String(enabled ? "enabled" : "disabled"));
 }
 
@@ -715,6 +799,23 @@ void InstrumentManager::cleanupStaleInstances()
     }
 }
 
+void InstrumentManager::poolMaintenanceLoop()
+{
+    std::unique_lock<std::mutex> lock(poolMaintainerMutex);
+
+    while (!stopPoolMaintainer)
+    {
+        poolMaintainerWake.wait_for(lock, std::chrono::milliseconds(poolMaintenanceIntervalMs),
+                                    [this] { return stopPoolMaintainer; });
+        if (stopPoolMaintainer)
+            break;
+
+        lock.unlock();
+        registry->maintainPool();
+        lock.lock();
+    }
+}
+
 void InstrumentManager::updateStatistics() const
 {
     std::lock_guard<std::mutex> lock(instrumentMutex);
@@ -8,6 +8,8 @@
 #include <functional>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <thread>
 
 /**
  * @brief Core Instrument Management System
@@ -19,12 +21,17 @@
  * - AI agent integration bridge
  */
 
+namespace SchillingerEcosystem::Audio {
+class PluginScanCache;
+}
+
 namespace SchillingerEcosystem::Instrument {
 
 // Forward declarations
 class InstrumentInstance;
 class PluginManager;
 class InstrumentFactory;
+class InstrumentRegistry;
 
 enum class InstrumentType
 {
@@ -79,6 +86,12 @@ public:
 
     /**
      * Scan and register external plugins from directories
+     *
+     * Files are scanned in parallel, each in a separate process, and the
+     * results cached on disk; unchanged plugins are neither rescanned nor
+     * rehashed on later calls. A plugin that crashes the scan is reported
+     * in the results without affecting the others.
+     *
      * @param directories List of directories to scan
      * @return Scan results with counts
      */
@@ -168,6 +181,20 @@ public:
      */
     bool isInstrumentAvailable(const juce::String& identifier) const;
 
+    //==============================================================================
+    // HANDLE-BASED ACCESS
+    //==============================================================================
+
+    /**
+     * Lock-free registry mirroring every registered instrument
+     *
+     * Audio and FFI paths should resolve identifiers once via
+     * getRegistry().resolve(), keep the InstrumentHandle, and claim prepared
+     * instances with getRegistry().claimInstance() instead of calling
+     * createInstance() during playback.
+     */
+    InstrumentRegistry& getRegistry() noexcept { return *registry; }
+
     //==============================================================================
     // PRESET MANAGEMENT
     //==============================================================================
@@ -319,6 +346,7 @@ private:
 
     void initializeBuiltInSynths();
     void initializePluginManager();
+    bool registerScannedPlugin(const juce::PluginDescription& description);
     void loadPresetsDatabase();
     void savePresetsDatabase();
 
@@ -327,6 +355,7 @@ private:
 
     void cleanupStaleInstances();
     void updateStatistics() const;
+    void poolMaintenanceLoop();
 
     std::shared_ptr<InstrumentEntry> findInstrumentEntry(const juce::String& identifier) const;
     bool validateInstrumentInfo(const InstrumentInfo& info) const;
@@ -340,6 +369,18 @@ private:
     // Registered instruments
     std::unordered_map<juce::String, std::shared_ptr<InstrumentEntry>> instruments;
 
+    // Handle-based, lock-free view of the same instruments
+    std::unique_ptr<InstrumentRegistry> registry;
+
+    // Prepared instances kept per built-in synth; released ones are
+    // recycled by a background thread so claims never wait on a factory
+    static constexpr int builtInPoolSize = 2;
+    static constexpr int poolMaintenanceIntervalMs = 250;
+    std::thread poolMaintainer;
+    std::mutex poolMaintainerMutex;
+    std::condition_variable poolMaintainerWake;
+    bool stopPoolMaintainer = false;
+
     // Active instances
     std::vector<std::weak_ptr<InstrumentInstance>> activeInstances;
 
@@ -349,6 +390,7 @@ private:
 
     // Plugin management
     std::unique_ptr<PluginManager> pluginManager;
+    std::unique_ptr<Audio::PluginScanCache> pluginScanCache;
 
     // AI agent integration
     std::unordered_map<juce::String, std::unique_ptr<AIAgentInterface>> aiInterfaces;
@@ -0,0 +1,497 @@
+#include "InstrumentRegistry.h"
+#include "InstrumentInstance.h"
+#include <algorithm>
+
+namespace SchillingerEcosystem::Instrument {
+
+//==============================================================================
+// Snapshot
+//==============================================================================
+
+namespace
+{
+    const std::vector<InstrumentHandle>& emptyHandleList()
+    {
+        static const std::vector<InstrumentHandle> empty;
+        return empty;
+    }
+}
+
+const std::vector<InstrumentHandle>& InstrumentRegistry::Snapshot::category(const juce::String& name) const
+{
+    auto it = byCategory.find(name.toLowerCase());
+    return it != byCategory.end() ? it->second : emptyHandleList();
+}
+
+const std::vector<InstrumentHandle>& InstrumentRegistry::Snapshot::tag(const juce::String& name) const
+{
+    auto it = byTag.find(name.toLowerCase());
+    return it != byTag.end() ? it->second : emptyHandleList();
+}
+
+//==============================================================================
+// InstrumentRegistry Implementation
+//==============================================================================
+
+InstrumentRegistry::InstrumentRegistry()
+    : instrumentSlots(std::make_unique<InstrumentSlot[]>(maxInstruments)),
+      instanceSlots(std::make_unique<InstanceSlot[]>(maxInstances))
+{
+    freeInstrumentSlots.reserve(maxInstruments);
+    for (int i = maxInstruments; --i >= 0;)
+        freeInstrumentSlots.push_back(static_cast<uint32_t>(i));
+
+    freeInstanceSlots.reserve(maxInstances);
+    for (int i = maxInstances; --i >= 0;)
+        freeInstanceSlots.push_back(static_cast<uint32_t>(i));
+
+    std::atomic_store_explicit(&snapshot,
+                               std::shared_ptr<const Snapshot>(std::make_shared<Snapshot>()),
+                               std::memory_order_release);
+}
+
+InstrumentRegistry::~InstrumentRegistry()
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    for (int i = 0; i < maxInstances; ++i)
+        instanceSlots[i].instance.reset();
+}
+
+//==============================================================================
+// REGISTRATION
+//==============================================================================
+
+InstrumentHandle InstrumentRegistry::registerInstrument(const InstrumentInfo& info, Factory factory, int maxInstanceCount)
+{
+    if (info.identifier.isEmpty() || !factory)
+        return {};
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    for (const auto& existing : liveRecords)
+        if (existing->info.identifier == info.identifier)
+            return {};
+
+    if (freeInstrumentSlots.empty())
+    {
+        juce::Logger::writeToLog("InstrumentRegistry full, cannot register: " + info.identifier);
+        return {};
+    }
+
+    const uint32_t index = freeInstrumentSlots.back();
+    freeInstrumentSlots.pop_back();
+
+    auto& slot = instrumentSlots[index];
+
+    auto record = std::make_shared<Record>();
+    record->handle = { index, slot.generation.load(std::memory_order_relaxed) };
+    record->info = info;
+    record->factory = std::move(factory);
+    record->maxInstances = maxInstanceCount;
+
+    juce::String searchText = info.name + "\n" + info.description + "\n" + info.manufacturer;
+    for (const auto& tag : info.tags)
+        searchText << "\n" << tag;
+    record->searchText = searchText.toLowerCase();
+
+    slot.liveInstances.store(0, std::memory_order_relaxed);
+    slot.pooledInstances.store(0, std::memory_order_relaxed);
+    slot.poolTarget = 0;
+    slot.record.store(record.get(), std::memory_order_release);
+
+    liveRecords.push_back(record);
+    publishSnapshot();
+
+    return record->handle;
+}
+
+bool InstrumentRegistry::unregisterInstrument(InstrumentHandle handle)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    if (!isAvailable(handle))
+        return false;
+
+    auto& slot = instrumentSlots[handle.index];
+
+    // Invalidate handles first so no new claims can start
+    slot.record.store(nullptr, std::memory_order_release);
+    slot.generation.fetch_add(1, std::memory_order_seq_cst);
+    slot.poolTarget = 0;
+    drainPool(handle.index);
+
+    auto it = std::find_if(liveRecords.begin(), liveRecords.end(),
+                           [handle](const auto& r) { return r->handle == handle; });
+    if (it != liveRecords.end())
+    {
+        retiredRecords.push_back(*it);
+        liveRecords.erase(it);
+    }
+
+    // Claimed instances still count against this slot when released, so it
+    // is only reused once maintainPool() has seen them all come back
+    if (slot.liveInstances.load(std::memory_order_seq_cst) == 0)
+        freeInstrumentSlots.push_back(handle.index);
+    else
+        retiredInstrumentSlots.push_back(handle.index);
+
+    publishSnapshot();
+    return true;
+}
+
+void InstrumentRegistry::setAudioConfiguration(double newSampleRate, int newBlockSize)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    sampleRate = newSampleRate;
+    blockSize = newBlockSize;
+
+    // Pull each pooled instance out while it is re-prepared so it cannot be
+    // claimed half-configured, then put it back.
+    for (const auto& record : liveRecords)
+    {
+        auto& slot = instrumentSlots[record->handle.index];
+
+        for (auto& entry : slot.pool)
+        {
+            const uint32_t value = entry.exchange(0, std::memory_order_acq_rel);
+            if (value == 0)
+                continue;
+
+            auto& instanceSlot = instanceSlots[value - 1];
+            instanceSlot.instance->prepareToPlay(sampleRate, blockSize);
+            entry.store(value, std::memory_order_release);
+        }
+    }
+}
+
+int InstrumentRegistry::prewarm(InstrumentHandle handle, int count)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    const auto* record = getRecord(handle);
+    if (record == nullptr)
+        return 0;
+
+    auto& slot = instrumentSlots[handle.index];
+    slot.poolTarget = juce::jlimit(0, maxPooledPerInstrument, count);
+
+    while (slot.pooledInstances.load(std::memory_order_relaxed) < slot.poolTarget)
+    {
+        if (!addPooledInstance(handle.index, *record))
+            break;
+    }
+
+    return slot.pooledInstances.load(std::memory_order_relaxed);
+}
+
+void InstrumentRegistry::maintainPool()
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    // Recycle released instances
+    for (uint32_t i = 0; i < static_cast<uint32_t>(maxInstances); ++i)
+    {
+        auto& instanceSlot = instanceSlots[i];
+        if (instanceSlot.state.load(std::memory_order_acquire) != InstanceState::released)
+            continue;
+
+        // Stale InstanceHandles stop resolving from here on
+        instanceSlot.generation.fetch_add(1, std::memory_order_acq_rel);
+
+        const uint32_t owner = instanceSlot.instrumentIndex.load(std::memory_order_relaxed);
+        auto& slot = instrumentSlots[owner];
+
+        // Instances of an unregistered instrument are never pooled again
+        if (slot.record.load(std::memory_order_acquire) == nullptr
+            || instanceSlot.instrumentGeneration.load(std::memory_order_relaxed)
+                   != slot.generation.load(std::memory_order_acquire)
+            || slot.pooledInstances.load(std::memory_order_relaxed) >= slot.poolTarget)
+        {
+            destroyInstanceSlot(i);
+            continue;
+        }
+
+        instanceSlot.instance->allNotesOff();
+        instanceSlot.instance->resetPerformanceStats();
+
+        bool pooled = false;
+        for (auto& entry : slot.pool)
+        {
+            if (entry.load(std::memory_order_relaxed) == 0)
+            {
+                instanceSlot.state.store(InstanceState::pooled, std::memory_order_release);
+                entry.store(i + 1, std::memory_order_release);
+                slot.pooledInstances.fetch_add(1, std::memory_order_relaxed);
+                pooled = true;
+                break;
+            }
+        }
+
+        if (!pooled)
+            destroyInstanceSlot(i);
+    }
+
+    // Slots of unregistered instruments whose last instance has come back
+    for (auto it = retiredInstrumentSlots.begin(); it != retiredInstrumentSlots.end();)
+    {
+        if (instrumentSlots[*it].liveInstances.load(std::memory_order_acquire) == 0)
+        {
+            freeInstrumentSlots.push_back(*it);
+            it = retiredInstrumentSlots.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Top pools back up
+    for (const auto& record : liveRecords)
+    {
+        auto& slot = instrumentSlots[record->handle.index];
+        while (slot.pooledInstances.load(std::memory_order_relaxed) < slot.poolTarget)
+        {
+            if (!addPooledInstance(record->handle.index, *record))
+                break;
+        }
+    }
+}
+
+//==============================================================================
+// LOOKUPS
+//==============================================================================
+
+bool InstrumentRegistry::isAvailable(InstrumentHandle handle) const noexcept
+{
+    return getRecord(handle) != nullptr;
+}
+
+const InstrumentRegistry::Record* InstrumentRegistry::getRecord(InstrumentHandle handle) const noexcept
+{
+    if (handle.index >= static_cast<uint32_t>(maxInstruments))
+        return nullptr;
+
+    const auto& slot = instrumentSlots[handle.index];
+    if (slot.generation.load(std::memory_order_acquire) != handle.generation)
+        return nullptr;
+
+    return slot.record.load(std::memory_order_acquire);
+}
+
+int InstrumentRegistry::getInstanceCount(InstrumentHandle handle) const noexcept
+{
+    if (!isAvailable(handle))
+        return 0;
+
+    return instrumentSlots[handle.index].liveInstances.load(std::memory_order_relaxed);
+}
+
+int InstrumentRegistry::getPooledCount(InstrumentHandle handle) const noexcept
+{
+    if (!isAvailable(handle))
+        return 0;
+
+    return instrumentSlots[handle.index].pooledInstances.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<const InstrumentRegistry::Snapshot> InstrumentRegistry::getSnapshot() const noexcept
+{
+    return std::atomic_load_explicit(&snapshot, std::memory_order_acquire);
+}
+
+InstrumentHandle InstrumentRegistry::resolve(const juce::String& identifier) const
+{
+    auto current = getSnapshot();
+    auto it = current->byIdentifier.find(identifier);
+    return it != current->byIdentifier.end() ? it->second : InstrumentHandle {};
+}
+
+std::vector<InstrumentHandle> InstrumentRegistry::search(const juce::String& query) const
+{
+    std::vector<InstrumentHandle> result;
+    if (query.isEmpty())
+        return result;
+
+    const auto lowercaseQuery = query.toLowerCase();
+    auto current = getSnapshot();
+
+    for (const auto& record : current->records)
+        if (record->searchText.contains(lowercaseQuery))
+            result.push_back(record->handle);
+
+    return result;
+}
+
+//==============================================================================
+// INSTANCES
+//==============================================================================
+
+InstanceHandle InstrumentRegistry::claimInstance(InstrumentHandle handle) noexcept
+{
+    const auto* record = getRecord(handle);
+    if (record == nullptr)
+        return {};
+
+    auto& slot = instrumentSlots[handle.index];
+
+    // Reserve a live count first so concurrent claims cannot overshoot the
+    // limit, and so a racing unregister either sees the claim or the claim
+    // sees the new generation
+    const int live = slot.liveInstances.fetch_add(1, std::memory_order_seq_cst) + 1;
+    if ((record->maxInstances > 0 && live > record->maxInstances)
+        || slot.generation.load(std::memory_order_seq_cst) != handle.generation)
+    {
+        slot.liveInstances.fetch_sub(1, std::memory_order_acq_rel);
+        return {};
+    }
+
+    for (auto& entry : slot.pool)
+    {
+        // Plain load first so empty entries are not written to
+        if (entry.load(std::memory_order_relaxed) == 0)
+            continue;
+
+        const uint32_t value = entry.exchange(0, std::memory_order_acq_rel);
+        if (value == 0)
+            continue;
+
+        auto& instanceSlot = instanceSlots[value - 1];
+        instanceSlot.state.store(InstanceState::claimed, std::memory_order_release);
+        slot.pooledInstances.fetch_sub(1, std::memory_order_relaxed);
+
+        return { value - 1, instanceSlot.generation.load(std::memory_order_acquire) };
+    }
+
+    slot.liveInstances.fetch_sub(1, std::memory_order_acq_rel);
+    return {};
+}
+
+InstrumentInstance* InstrumentRegistry::getInstance(InstanceHandle handle) const noexcept
+{
+    if (handle.index >= static_cast<uint32_t>(maxInstances))
+        return nullptr;
+
+    const auto& instanceSlot = instanceSlots[handle.index];
+    if (instanceSlot.generation.load(std::memory_order_acquire) != handle.generation
+        || instanceSlot.state.load(std::memory_order_acquire) != InstanceState::claimed)
+        return nullptr;
+
+    return instanceSlot.instance.get();
+}
+
+bool InstrumentRegistry::releaseInstance(InstanceHandle handle) noexcept
+{
+    if (handle.index >= static_cast<uint32_t>(maxInstances))
+        return false;
+
+    auto& instanceSlot = instanceSlots[handle.index];
+    if (instanceSlot.generation.load(std::memory_order_acquire) != handle.generation)
+        return false;
+
+    auto expected = InstanceState::claimed;
+    if (!instanceSlot.state.compare_exchange_strong(expected, InstanceState::released, std::memory_order_acq_rel))
+        return false;
+
+    const uint32_t owner = instanceSlot.instrumentIndex.load(std::memory_order_relaxed);
+    instrumentSlots[owner].liveInstances.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+//==============================================================================
+// INTERNAL METHODS
+//==============================================================================
+
+void InstrumentRegistry::publishSnapshot()
+{
+    auto next = std::make_shared<Snapshot>();
+    next->records = liveRecords;
+
+    for (const auto& record : liveRecords)
+    {
+        const auto& info = record->info;
+        next->byIdentifier[info.identifier] = record->handle;
+        next->byCategory[info.category.toLowerCase()].push_back(record->handle);
+
+        for (const auto& tag : info.tags)
+            next->byTag[tag.toLowerCase()].push_back(record->handle);
+
+        next->byType[static_cast<size_t>(info.type)].push_back(record->handle);
+    }
+
+    std::atomic_store_explicit(&snapshot,
+                               std::shared_ptr<const Snapshot>(std::move(next)),
+                               std::memory_order_release);
+}
+
+bool InstrumentRegistry::addPooledInstance(uint32_t instrumentIndex, const Record& record)
+{
+    if (freeInstanceSlots.empty())
+        return false;
+
+    auto& slot = instrumentSlots[instrumentIndex];
+
+    auto entry = std::find_if(slot.pool.begin(), slot.pool.end(),
+                              [](const auto& e) { return e.load(std::memory_order_relaxed) == 0; });
+    if (entry == slot.pool.end())
+        return false;
+
+    std::unique_ptr<InstrumentInstance> instance;
+    try
+    {
+        instance = record.factory();
+    }
+    catch (const std::exception& e)
+    {
+        juce::Logger::writeToLog("Failed to create pooled instance of " + record.info.identifier + ": " + e.what());
+        return false;
+    }
+
+    if (!instance)
+        return false;
+
+    instance->prepareToPlay(sampleRate, blockSize);
+
+    const uint32_t instanceIndex = freeInstanceSlots.back();
+    freeInstanceSlots.pop_back();
+
+    auto& instanceSlot = instanceSlots[instanceIndex];
+    instanceSlot.instance = std::move(instance);
+    instanceSlot.instrumentIndex.store(instrumentIndex, std::memory_order_relaxed);
+    instanceSlot.instrumentGeneration.store(slot.generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    instanceSlot.state.store(InstanceState::pooled, std::memory_order_release);
+
+    entry->store(instanceIndex + 1, std::memory_order_release);
+    slot.pooledInstances.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void InstrumentRegistry::destroyInstanceSlot(uint32_t slotIndex)
+{
+    auto& instanceSlot = instanceSlots[slotIndex];
+
+    instanceSlot.generation.fetch_add(1, std::memory_order_acq_rel);
+    instanceSlot.instance.reset();
+    instanceSlot.instrumentIndex.store(InstrumentHandle::invalidIndex, std::memory_order_relaxed);
+    instanceSlot.state.store(InstanceState::free, std::memory_order_release);
+
+    freeInstanceSlots.push_back(slotIndex);
+}
+
+void InstrumentRegistry::drainPool(uint32_t instrumentIndex)
+{
+    auto& slot = instrumentSlots[instrumentIndex];
+
+    for (auto& entry : slot.pool)
+    {
+        const uint32_t value = entry.exchange(0, std::memory_order_acq_rel);
+        if (value == 0)
+            continue;
+
+        slot.pooledInstances.fetch_sub(1, std::memory_order_relaxed);
+        destroyInstanceSlot(value - 1);
+    }
+}
+
+} // namespace SchillingerEcosystem::Instrument
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "InstrumentManager.h"
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Handle-based instrument registry and prepared-instance pool
+ *
+ * InstrumentManager resolves every call through a juce::String hash under
+ * instrumentMutex. The registry replaces that on hot paths:
+ *
+ * - Instruments are addressed by generation-checked integer handles. Handle
+ *   lookups touch a fixed slot table with atomics only (no lock, no hash).
+ * - Identifier/category/tag/type queries run against an immutable snapshot
+ *   with precomputed indices, published by atomic pointer swap like
+ *   SessionPlanCache. Readers never block writers and vice versa.
+ * - Each instrument keeps a pool of instances that were created and prepared
+ *   off the audio thread. claimInstance() takes one without allocating or
+ *   locking and returns an InstanceHandle that the audio and FFI paths use to
+ *   drive it.
+ *
+ * Threading:
+ * - registerInstrument, unregisterInstrument, setAudioConfiguration, prewarm
+ *   and maintainPool run on non-audio threads (serialised internally).
+ * - isAvailable, getRecord, getInstanceCount, claimInstance, getInstance and
+ *   releaseInstance are lock-free and allocation-free; call from any thread.
+ */
+
+namespace SchillingerEcosystem::Instrument {
+
+class InstrumentInstance;
+
+//==============================================================================
+// HANDLES
+//==============================================================================
+
+/** Generation-checked reference to a registered instrument */
+struct InstrumentHandle
+{
+    static constexpr uint32_t invalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = invalidIndex;
+    uint32_t generation = 0;
+
+    bool isValid() const noexcept { return index != invalidIndex; }
+
+    /** Pack into a single integer for the FFI */
+    uint64_t toRaw() const noexcept { return (uint64_t(generation) << 32) | index; }
+    static InstrumentHandle fromRaw(uint64_t raw) noexcept { return { uint32_t(raw & 0xFFFFFFFFu), uint32_t(raw >> 32) }; }
+
+    bool operator==(const InstrumentHandle& other) const noexcept { return index == other.index && generation == other.generation; }
+    bool operator!=(const InstrumentHandle& other) const noexcept { return !(*this == other); }
+};
+
+/** Generation-checked reference to a claimed instrument instance */
+struct InstanceHandle
+{
+    static constexpr uint32_t invalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = invalidIndex;
+    uint32_t generation = 0;
+
+    bool isValid() const noexcept { return index != invalidIndex; }
+
+    uint64_t toRaw() const noexcept { return (uint64_t(generation) << 32) | index; }
+    static InstanceHandle fromRaw(uint64_t raw) noexcept { return { uint32_t(raw & 0xFFFFFFFFu), uint32_t(raw >> 32) }; }
+
+    bool operator==(const InstanceHandle& other) const noexcept { return index == other.index && generation == other.generation; }
+    bool operator!=(const InstanceHandle& other) const noexcept { return !(*this == other); }
+};
+
+//==============================================================================
+// REGISTRY
+//==============================================================================
+
+class InstrumentRegistry
+{
+public:
+    static constexpr int maxInstruments = 1024;
+    static constexpr int maxPooledPerInstrument = 16;
+    static constexpr int maxInstances = 4096;
+
+    using Factory = std::function<std::unique_ptr<InstrumentInstance>()>;
+
+    /** Immutable per-instrument data shared by all snapshots */
+    struct Record
+    {
+        InstrumentHandle handle;
+        InstrumentInfo info;
+        Factory factory;
+        juce::String searchText;     // Lower-case name, description, manufacturer and tags
+        int maxInstances = 0;        // 0 = unlimited
+    };
+
+    /** Immutable view of all registered instruments with precomputed indices */
+    struct Snapshot
+    {
+        std::vector<std::shared_ptr<const Record>> records;     // Registration order
+        std::unordered_map<juce::String, InstrumentHandle> byIdentifier;
+        std::unordered_map<juce::String, std::vector<InstrumentHandle>> byCategory;   // Lower-case keys
+        std::unordered_map<juce::String, std::vector<InstrumentHandle>> byTag;        // Lower-case keys
+        std::array<std::vector<InstrumentHandle>, 3> byType;
+
+        const std::vector<InstrumentHandle>& category(const juce::String& name) const;
+        const std::vector<InstrumentHandle>& tag(const juce::String& name) const;
+        const std::vector<InstrumentHandle>& type(InstrumentType t) const { return byType[static_cast<size_t>(t)]; }
+    };
+
+    InstrumentRegistry();
+    ~InstrumentRegistry();
+
+    //==============================================================================
+    // REGISTRATION (message thread)
+    //==============================================================================
+
+    /**
+     * Register an instrument
+     * @return Handle, or an invalid handle if the identifier is taken or the
+     *         registry is full
+     */
+    InstrumentHandle registerInstrument(const InstrumentInfo& info, Factory factory, int maxInstances = 0);
+
+    /**
+     * Unregister an instrument. Outstanding handles become invalid; claimed
+     * instances stay usable until released. The slot is not reused until
+     * the last of them has been released and recycled.
+     */
+    bool unregisterInstrument(InstrumentHandle handle);
+
+    /** Re-prepare pooled instances for a new device configuration */
+    void setAudioConfiguration(double sampleRate, int blockSize);
+
+    /**
+     * Keep @p count prepared instances ready to claim (capped at
+     * maxPooledPerInstrument). Creates the missing ones immediately.
+     * @return Number of instances now pooled
+     */
+    int prewarm(InstrumentHandle handle, int count);
+
+    /**
+     * Recycle released instances (all notes off, back into the pool or
+     * destroyed) and top pools back up to their prewarm targets. Call
+     * periodically from a non-audio thread; InstrumentManager runs it every
+     * 250 ms.
+     */
+    void maintainPool();
+
+    //==============================================================================
+    // LOOKUPS (lock-free, any thread)
+    //==============================================================================
+
+    bool isAvailable(InstrumentHandle handle) const noexcept;
+
+    /**
+     * Record for a handle, or nullptr if stale. Records of unregistered
+     * instruments stay alive until the registry is destroyed, so the pointer
+     * remains dereferenceable even if it races an unregister.
+     */
+    const Record* getRecord(InstrumentHandle handle) const noexcept;
+
+    /** Claimed (live) instances of an instrument */
+    int getInstanceCount(InstrumentHandle handle) const noexcept;
+
+    /** Pooled (ready to claim) instances of an instrument */
+    int getPooledCount(InstrumentHandle handle) const noexcept;
+
+    /** Current snapshot; hold the pointer for as long as its data is used */
+    std::shared_ptr<const Snapshot> getSnapshot() const noexcept;
+
+    /** Resolve an identifier once, then keep the handle */
+    InstrumentHandle resolve(const juce::String& identifier) const;
+
+    /** Case-insensitive substring search over the precomputed search text */
+    std::vector<InstrumentHandle> search(const juce::String& query) const;
+
+    //==============================================================================
+    // INSTANCES (lock-free, allocation-free)
+    //==============================================================================
+
+    /**
+     * Take a prepared instance from the instrument's pool
+     * @return Invalid handle if the pool is empty, the handle is stale or the
+     *         instrument's instance limit is reached
+     */
+    InstanceHandle claimInstance(InstrumentHandle handle) noexcept;
+
+    /** Instance for a claimed handle, or nullptr if stale */
+    InstrumentInstance* getInstance(InstanceHandle handle) const noexcept;
+
+    /**
+     * Give a claimed instance back. The caller must stop using it; it is
+     * reset and recycled by the next maintainPool().
+     */
+    bool releaseInstance(InstanceHandle handle) noexcept;
+
+private:
+    enum class InstanceState : uint32_t
+    {
+        free,
+        pooled,
+        claimed,
+        released
+    };
+
+    struct InstrumentSlot
+    {
+        std::atomic<uint32_t> generation { 1 };
+        std::atomic<const Record*> record { nullptr };
+        std::atomic<int> liveInstances { 0 };
+        std::atomic<int> pooledInstances { 0 };
+        std::array<std::atomic<uint32_t>, maxPooledPerInstrument> pool {};   // Instance slot index + 1, 0 = empty
+        int poolTarget = 0;                                                  // Message thread only
+    };
+
+    struct InstanceSlot
+    {
+        std::atomic<uint32_t> generation { 1 };
+        std::atomic<InstanceState> state { InstanceState::free };
+        std::atomic<uint32_t> instrumentIndex { InstrumentHandle::invalidIndex };
+        std::atomic<uint32_t> instrumentGeneration { 0 };   // Owner's generation when created
+        std::unique_ptr<InstrumentInstance> instance;      // Written by the message thread only while free
+    };
+
+    void publishSnapshot();
+    bool addPooledInstance(uint32_t instrumentIndex, const Record& record);
+    void destroyInstanceSlot(uint32_t slotIndex);
+    void drainPool(uint32_t instrumentIndex);
+
+    std::unique_ptr<InstrumentSlot[]> instrumentSlots;
+    std::unique_ptr<InstanceSlot[]> instanceSlots;
+
+    std::mutex writerMutex;
+    std::vector<uint32_t> freeInstrumentSlots;                   // Writer only
+    std::vector<uint32_t> retiredInstrumentSlots;                // Writer only: unregistered, instances still claimed
+    std::vector<uint32_t> freeInstanceSlots;                     // Writer only
+    std::vector<std::shared_ptr<const Record>> liveRecords;      // Writer only
+    std::vector<std::shared_ptr<const Record>> retiredRecords;   // Kept alive for racing readers
+    std::shared_ptr<const Snapshot> snapshot;                    // atomic_load / atomic_store only
+
+    double sampleRate = 44100.0;
+    int blockSize = 512;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InstrumentRegistry)
+};
+
+} // namespace SchillingerEcosystem::Instrument
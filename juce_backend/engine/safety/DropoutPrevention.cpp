@@ -1,4 +1,5 @@
 #include "audio/DropoutPrevention.h"
+#include "dsp/RealtimeLog.h"
 #include "juce_audio_basics/juce_audio_basics.h"
 #include "juce_core/juce_core.h"
 #include <algorithm>
@@ -547,21 +548,21 @@ void DropoutPrevention::processSampleRateConversion(const float* input, float* o
 
   // SECURITY FIX: Validate sample count and conversion ratio
   if (numSamples <= 0 || numSamples > MAX_SAFE_SAMPLES) {
-    juce::Logger::writeToLog("DropoutPrevention::processSampleRateConversion - Invalid sample count: " + juce::String(numSamples));
+    DSP_LOG_WARNING("DropoutPrevention::processSampleRateConversion - Invalid sample count: %d", numSamples);
     return;
   }
 
   // Validate conversion ratio is safe
   double const ratio = outputSampleRate_.load() / inputSampleRate_.load();
   if (ratio <= 0.0 || ratio > MAX_SAFE_RATIO) {
-    juce::Logger::writeToLog("DropoutPrevention::processSampleRateConversion - Unsafe conversion ratio: " + juce::String(ratio));
+    DSP_LOG_WARNING("DropoutPrevention::processSampleRateConversion - Unsafe conversion ratio: %f", ratio);
     return;
   }
 
   // Calculate expected output size and validate it's safe
   int expectedOutputSamples = static_cast<int>(numSamples * ratio);
   if (expectedOutputSamples <= 0 || expectedOutputSamples > MAX_SAFE_SAMPLES * MAX_SAFE_RATIO) {
-    juce::Logger::writeToLog("DropoutPrevention::processSampleRateConversion - Unsafe output size: " + juce::String(expectedOutputSamples));
+    DSP_LOG_WARNING("DropoutPrevention::processSampleRateConversion - Unsafe output size: %d", expectedOutputSamples);
     return;
   }
 
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <future>
+#include <queue>
 #include <sstream>
 #include <thread>
 
@@ -26,6 +27,7 @@ MemorySafeAudioNode::MemorySafeAudioNode(std::string nodeId,
                                        double sampleRate)
     : nodeId_(std::move(nodeId))
     , nodeType_(type)
+    , sampleRate_(sampleRate)
 {
     // Initialize audio buffers with proper RAII
     try {
@@ -145,25 +147,24 @@ bool MemorySafeAudioNode::processAudio(const float* const* inputAudio,
         return false;
     }
 
-    // Try to acquire processing lock
+    // Try to acquire processing lock (sets isProcessing_ on success)
     if (!tryAcquireProcessingLock()) {
         return false;
     }
 
     // Use RAII for processing lock management
     struct ProcessingLockGuard {
-        std::atomic<bool>& isProcessing;
+        MemorySafeAudioNode& node;
         std::atomic<uint32_t>& processingCount;
-        ProcessingLockGuard(std::atomic<bool>& proc, std::atomic<uint32_t>& count)
-            : isProcessing(proc), processingCount(count) {
-            isProcessing.store(true);
+        ProcessingLockGuard(MemorySafeAudioNode& n, std::atomic<uint32_t>& count)
+            : node(n), processingCount(count) {
             processingCount.fetch_add(1);
         }
         ~ProcessingLockGuard() {
-            isProcessing.store(false);
             processingCount.fetch_sub(1);
+            node.releaseProcessingLock();
         }
-    } lockGuard(isProcessing_, processingCount_);
+    } lockGuard(*this, processingCount_);
 
     try {
         bool success = processInternal(inputAudio, numInputChannels, numSamples,
@@ -204,7 +205,7 @@ bool MemorySafeAudioNode::processInternal(const float* const* inputAudio,
         int channelsToCopy = std::min(numInputChannels, inputBuffer_->getNumChannels());
         for (int ch = 0; ch < channelsToCopy; ++ch) {
             if (inputAudio[ch]) {
-                inputBuffer_->copyFrom(ch, 0, inputAudio[ch], 0, numSamples);
+                inputBuffer_->copyFrom(ch, 0, inputAudio[ch], numSamples);
             }
         }
     }
@@ -212,21 +213,11 @@ bool MemorySafeAudioNode::processInternal(const float* const* inputAudio,
     // Apply processing callback if set
     if (processCallback_) {
         try {
-            // Prepare input channel pointers
-            std::vector<const float*> inputChannels(inputBuffer_->getNumChannels());
-            for (int ch = 0; ch < inputBuffer_->getNumChannels(); ++ch) {
-                inputChannels[ch] = inputBuffer_->getReadPointer(ch);
-            }
-
-            // Prepare output channel pointers
-            std::vector<float*> outputChannels(outputBuffer_->getNumChannels());
-            for (int ch = 0; ch < outputBuffer_->getNumChannels(); ++ch) {
-                outputChannels[ch] = outputBuffer_->getWritePointer(ch);
-            }
-
-            // Call user callback
-            processCallback_(inputChannels.data(), inputChannels.size(), numSamples,
-                           outputChannels.data(), outputChannels.size());
+            // Channel pointer arrays are owned by the buffers, so the audio
+            // thread does not allocate here
+            processCallback_(inputBuffer_->getArrayOfReadPointers(), inputBuffer_->getNumChannels(),
+                             numSamples,
+                             outputBuffer_->getArrayOfWritePointers(), outputBuffer_->getNumChannels());
 
         } catch (const std::exception& e) {
             juce::Logger::writeToLog("ERROR: Processing callback failed in node " + nodeId_ + ": " + e.what());
@@ -234,7 +225,10 @@ bool MemorySafeAudioNode::processInternal(const float* const* inputAudio,
         }
     } else {
         // Default behavior: copy input to output
-        *outputBuffer_ = *inputBuffer_;
+        int channelsToCopy = std::min(inputBuffer_->getNumChannels(), outputBuffer_->getNumChannels());
+        for (int ch = 0; ch < channelsToCopy; ++ch) {
+            outputBuffer_->copyFrom(ch, 0, *inputBuffer_, ch, 0, numSamples);
+        }
     }
 
     // Copy to output if provided
@@ -451,8 +445,17 @@ int MemorySafeAudioNode::getChannelCount() const {
            inputBuffer_->getNumChannels() : 2;
 }
 
+bool MemorySafeAudioNode::setSampleRate(double newSampleRate) {
+    if (newSampleRate <= 0.0) {
+        return false;
+    }
+
+    sampleRate_.store(newSampleRate);
+    return true;
+}
+
 double MemorySafeAudioNode::getSampleRate() const {
-    return 44100.0; // Default - can be enhanced with actual sample rate tracking
+    return sampleRate_.load();
 }
 
 MemorySafeAudioNode::ProcessingStats MemorySafeAudioNode::getStats() const {
@@ -498,13 +501,25 @@ bool MemorySafeAudioNode::tryAcquireProcessingLock() {
         return false;
     }
 
-    if (isProcessing_.load()) {
+    // Claim atomically so two renders can never process the node at once
+    bool expected = false;
+    if (!isProcessing_.compare_exchange_strong(expected, true)) {
         return false; // Already processing
     }
 
+    // Re-check after claiming: shutdown() sets the state before waiting on us
+    if (currentState_.load() != NodeState::Ready) {
+        isProcessing_.store(false);
+        return false;
+    }
+
     return true; // Ready to process
 }
 
+void MemorySafeAudioNode::releaseProcessingLock() {
+    isProcessing_.store(false);
+}
+
 void MemorySafeAudioNode::cleanupConnections() {
     std::unique_lock<std::shared_mutex> lock(connectionMutex_);
     connectedInputs_.clear();
@@ -534,7 +549,29 @@ MemorySafeAudioGraph::MemorySafeAudioGraph() {
 
 MemorySafeAudioGraph::~MemorySafeAudioGraph() {
     requestShutdown();
-    clear();
+
+    // A render that pinned before the shutdown flag was set may still be
+    // running; it re-checks the flag after pinning, so this wait is bounded
+    // by one block
+    while (pinnedEpoch_.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    delete current_.exchange(nullptr);
+
+    for (auto& entry : retired_) {
+        for (auto& node : entry.removedNodes) {
+            node->shutdown();
+        }
+    }
+    retired_.clear();
+
+    for (auto& node : nodes_) {
+        node->shutdown();
+    }
+    nodes_.clear();
+    connections_.clear();
 }
 
 bool MemorySafeAudioGraph::addNode(NodePtr node) {
@@ -542,126 +579,105 @@ bool MemorySafeAudioGraph::addNode(NodePtr node) {
         return false;
     }
 
-    std::unique_lock<std::shared_mutex> lock(nodesMutex_);
+    std::lock_guard<std::mutex> lock(writerMutex_);
 
     std::string nodeId = node->getId();
 
     // Check if node already exists
-    if (nodes_.find(nodeId) != nodes_.end()) {
+    if (findNodeLocked(nodeId)) {
         juce::Logger::writeToLog("WARNING: Node " + nodeId + " already exists in graph");
         return false;
     }
 
     try {
-        // Add node to map
-        nodes_[nodeId] = std::move(node);
-
-        // Mark processing order as dirty
-        processingOrderDirty_ = true;
-
-        #ifdef DEBUG
-        lastNodeModification_.store(std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now().time_since_epoch()).count());
-        #endif
-
-        juce::Logger::writeToLog("Added node " + nodeId + " to audio graph");
-        return true;
+        nodes_.push_back(SharedNodePtr(std::move(node)));
+        publishLocked();
 
     } catch (const std::exception& e) {
+        nodes_.pop_back();
         juce::Logger::writeToLog("ERROR: Failed to add node " + nodeId + " to graph: " + e.what());
         return false;
     }
+
+    touchModificationTime();
+    juce::Logger::writeToLog("Added node " + nodeId + " to audio graph");
+    return true;
 }
 
 bool MemorySafeAudioGraph::removeNode(const std::string& nodeId) {
-    std::unique_lock<std::shared_mutex> nodesLock(nodesMutex_);
+    std::lock_guard<std::mutex> lock(writerMutex_);
 
-    auto nodeIt = nodes_.find(nodeId);
+    auto nodeIt = std::find_if(nodes_.begin(), nodes_.end(),
+        [&nodeId](const SharedNodePtr& node) { return node->getId() == nodeId; });
     if (nodeIt == nodes_.end()) {
         return false; // Node not found
     }
 
-    auto& node = nodeIt->second;
-    if (!node) {
-        nodes_.erase(nodeIt);
-        return false;
-    }
+    const auto savedNodes = nodes_;
+    const auto savedConnections = connections_;
+    SharedNodePtr removed = *nodeIt;
 
-    // Wait for any processing to complete
-    while (node->isProcessing()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
+    // Drop every connection that touches the node
+    connections_.erase(
+        std::remove_if(connections_.begin(), connections_.end(),
+            [&nodeId](const Connection& c) {
+                return c.source == nodeId || c.destination == nodeId;
+            }),
+        connections_.end());
+    nodes_.erase(nodeIt);
 
-    // Remove node from connections
-    {
-        std::unique_lock<std::shared_mutex> connectionsLock(connectionsMutex_);
-        connections_.erase(nodeId);
+    try {
+        // The node stays alive in the retired version until no render can
+        // reach it, then it is shut down off the audio thread
+        publishLocked({ removed });
 
-        // Remove from other nodes' connections
-        for (auto& [id, weakNode] : connections_) {
-            if (auto sharedNode = weakNode.lock()) {
-                sharedNode->disconnectOutput(nodeId);
-                sharedNode->disconnectInput(nodeId);
-            }
-        }
+    } catch (const std::exception& e) {
+        nodes_ = savedNodes;
+        connections_ = savedConnections;
+        juce::Logger::writeToLog("ERROR: Failed to remove node " + nodeId + " from graph: " + e.what());
+        return false;
     }
 
-    // Shutdown the node safely
-    node->shutdown();
-
-    // Remove node from map (RAII handles cleanup)
-    nodes_.erase(nodeIt);
-
-    // Mark processing order as dirty
-    processingOrderDirty_ = true;
-
-    #ifdef DEBUG
-    lastNodeModification_.store(std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()).count());
-    #endif
+    for (auto& node : nodes_) {
+        node->disconnectInput(nodeId);
+        node->disconnectOutput(nodeId);
+    }
 
+    touchModificationTime();
     juce::Logger::writeToLog("Removed node " + nodeId + " from audio graph");
     return true;
 }
 
 std::future<bool> MemorySafeAudioGraph::removeNodeAsync(const std::string& nodeId) {
-    return std::async(std::launch::async, [this, nodeId]() -> bool {
-        return removeNode(nodeId);
-    });
+    std::promise<bool> result;
+    result.set_value(removeNode(nodeId));
+    return result.get_future();
 }
 
 std::weak_ptr<MemorySafeAudioNode> MemorySafeAudioGraph::getNode(const std::string& nodeId) {
-    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
-
-    auto it = nodes_.find(nodeId);
-    if (it != nodes_.end() && it->second) {
-        return std::weak_ptr<MemorySafeAudioNode>(it->second);
-    }
-
-    return std::weak_ptr<MemorySafeAudioNode>();
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return findNodeLocked(nodeId);
 }
 
 bool MemorySafeAudioGraph::hasNode(const std::string& nodeId) const {
-    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
-    return nodes_.find(nodeId) != nodes_.end();
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return findNodeLocked(nodeId) != nullptr;
 }
 
 std::vector<std::string> MemorySafeAudioGraph::getNodeIds() const {
-    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
+    std::lock_guard<std::mutex> lock(writerMutex_);
     std::vector<std::string> ids;
 
     ids.reserve(nodes_.size());
-    for (const auto& [nodeId, node] : nodes_) {
-        if (node) {
-            ids.push_back(nodeId);
-        }
+    for (const auto& node : nodes_) {
+        ids.push_back(node->getId());
     }
 
     return ids;
 }
 
 size_t MemorySafeAudioGraph::getNodeCount() const {
-    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
+    std::lock_guard<std::mutex> lock(writerMutex_);
     return nodes_.size();
 }
 
@@ -674,66 +690,94 @@ bool MemorySafeAudioGraph::processAudio(const float* const* inputAudio,
         return false;
     }
 
-    // Set processing state
-    isGraphProcessing_.store(true);
-    activeProcessingCount_.fetch_add(1);
-
-    // RAII for processing state management
-    struct GraphProcessingGuard {
-        std::atomic<bool>& isProcessing;
-        std::atomic<uint32_t>& activeCount;
-        GraphProcessingGuard(std::atomic<bool>& proc, std::atomic<uint32_t>& count)
-            : isProcessing(proc), activeCount(count) {}
-        ~GraphProcessingGuard() {
-            isProcessing.store(false);
-            activeCount.fetch_sub(1);
-        }
-    } processingGuard(isGraphProcessing_, activeProcessingCount_);
+    totalProcessCalls_.fetch_add(1, std::memory_order_relaxed);
 
-    totalProcessCalls_.fetch_add(1);
+    // Pin the epoch before loading the topology. Anything retired at a later
+    // epoch stays alive until the pin is released.
+    uint64_t idle = 0;
+    if (!pinnedEpoch_.compare_exchange_strong(idle, globalEpoch_.load())) {
+        rejectedRenders_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
 
-    try {
-        // Get processing order
-        auto processingOrder = getProcessingOrderSnapshot();
+    struct EpochPin {
+        std::atomic<uint64_t>& pinned;
+        ~EpochPin() { pinned.store(0); }
+    } pin{pinnedEpoch_};
 
-        // Process nodes in order
-        for (const std::string& nodeId : processingOrder) {
-            if (shutdownRequested_.load()) {
-                break;
+    const int samples = std::max(numSamples, 0);
+    if (outputAudio) {
+        for (int ch = 0; ch < numOutputChannels; ++ch) {
+            if (outputAudio[ch]) {
+                juce::FloatVectorOperations::clear(outputAudio[ch], samples);
             }
+        }
+    }
 
-            if (!validateNodeForProcessing(nodeId)) {
-                continue;
-            }
+    // Writers that need exclusive access to the nodes set a flag and then
+    // wait for the pin to clear; checking after pinning closes the race
+    if (renderSuspended_.load() || shutdownRequested_.load()) {
+        return false;
+    }
 
-            auto weakNode = getNode(nodeId);
-            auto node = weakNode.lock();
-            if (!node) {
-                continue; // Node was removed during processing
-            }
+    Topology* topology = current_.load();
+    if (!topology || topology->nodes.empty()) {
+        return true;
+    }
 
-            // Process node
-            bool success = node->processAudio(inputAudio, numInputChannels, numSamples,
-                                            outputAudio, numOutputChannels);
+    if (numSamples <= 0 || numSamples > topology->maxBlockSize) {
+        totalErrors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
 
-            if (!success) {
-                totalErrors_.fetch_add(1);
-                juce::Logger::writeToLog("WARNING: Node " + nodeId + " failed processing");
+    const int numChannels = topology->numChannels;
+    const int channelsToMix = outputAudio ? std::min(numOutputChannels, numChannels) : 0;
+    bool allSucceeded = true;
+
+    for (size_t i = 0; i < topology->nodes.size(); ++i) {
+        MemorySafeAudioNode* node = topology->nodes[i].get();
+        float* const* nodeOutput = topology->outputPointers.data() + i * numChannels;
+
+        const float* const* nodeInput = inputAudio;
+        int nodeInputChannels = numInputChannels;
+        const uint32_t sourceCount = topology->sourceCount[i];
+        const uint32_t* sources = topology->sources.data() + topology->sourceStart[i];
+
+        if (sourceCount == 1) {
+            nodeInput = topology->outputPointers.data() + sources[0] * numChannels;
+            nodeInputChannels = numChannels;
+        } else if (sourceCount > 1) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                float* mix = topology->mixPointers[ch];
+                juce::FloatVectorOperations::copy(mix, topology->outputPointers[sources[0] * numChannels + ch], numSamples);
+                for (uint32_t s = 1; s < sourceCount; ++s) {
+                    juce::FloatVectorOperations::add(mix, topology->outputPointers[sources[s] * numChannels + ch], numSamples);
+                }
             }
+            nodeInput = topology->mixPointers.data();
+            nodeInputChannels = numChannels;
         }
 
-        return true;
-
-    } catch (const std::exception& e) {
-        totalErrors_.fetch_add(1);
-        juce::Logger::writeToLog("ERROR: Exception during graph processing: " + e.what());
-        return false;
+        if (!node->processAudio(nodeInput, nodeInputChannels, numSamples, nodeOutput, numChannels)) {
+            // Downstream nodes hear silence rather than a stale block
+            for (int ch = 0; ch < numChannels; ++ch) {
+                juce::FloatVectorOperations::clear(nodeOutput[ch], numSamples);
+            }
+            totalErrors_.fetch_add(1, std::memory_order_relaxed);
+            allSucceeded = false;
+            continue;
+        }
 
-    } catch (...) {
-        totalErrors_.fetch_add(1);
-        juce::Logger::writeToLog("ERROR: Unknown exception during graph processing");
-        return false;
+        if (topology->isSink[i]) {
+            for (int ch = 0; ch < channelsToMix; ++ch) {
+                if (outputAudio[ch]) {
+                    juce::FloatVectorOperations::add(outputAudio[ch], nodeOutput[ch], numSamples);
+                }
+            }
+        }
     }
+
+    return allSucceeded;
 }
 
 bool MemorySafeAudioGraph::connectNodes(const std::string& sourceNodeId,
@@ -742,181 +786,413 @@ bool MemorySafeAudioGraph::connectNodes(const std::string& sourceNodeId,
         return false; // Cannot connect node to itself
     }
 
-    auto sourceWeak = getNode(sourceNodeId);
-    auto destWeak = getNode(destinationNodeId);
-
-    auto sourceShared = sourceWeak.lock();
-    auto destShared = destWeak.lock();
+    std::lock_guard<std::mutex> lock(writerMutex_);
 
-    if (!sourceShared || !destShared) {
+    auto source = findNodeLocked(sourceNodeId);
+    auto destination = findNodeLocked(destinationNodeId);
+    if (!source || !destination) {
         return false; // One or both nodes don't exist
     }
 
-    // Create connection
-    if (!sourceShared->connectOutput(destWeak) ||
-        !destShared->connectInput(sourceWeak)) {
+    for (const auto& c : connections_) {
+        if (c.source == sourceNodeId && c.destination == destinationNodeId) {
+            return false; // Already connected
+        }
+    }
+
+    auto updated = connections_;
+    updated.push_back({ sourceNodeId, destinationNodeId });
+
+    std::vector<uint32_t> order;
+    if (!sortNodesLocked(updated, order)) {
+        juce::Logger::writeToLog("WARNING: Connecting " + sourceNodeId + " -> " + destinationNodeId
+                                 + " would create a cycle");
         return false;
     }
 
-    // Store connection
-    {
-        std::unique_lock<std::shared_mutex> lock(connectionsMutex_);
-        connections_[destinationNodeId] = sourceWeak;
+    connections_.swap(updated);
+
+    try {
+        publishLocked();
+
+    } catch (const std::exception& e) {
+        connections_.swap(updated);
+        juce::Logger::writeToLog("ERROR: Failed to connect " + sourceNodeId + " -> " + destinationNodeId
+                                 + ": " + e.what());
+        return false;
     }
 
-    // Mark processing order as dirty
-    processingOrderDirty_ = true;
+    source->connectOutput(destination);
+    destination->connectInput(source);
 
+    touchModificationTime();
     juce::Logger::writeToLog("Connected " + sourceNodeId + " -> " + destinationNodeId);
     return true;
 }
 
 bool MemorySafeAudioGraph::disconnectNodes(const std::string& sourceNodeId,
                                          const std::string& destinationNodeId) {
-    auto sourceWeak = getNode(sourceNodeId);
-    auto destWeak = getNode(destinationNodeId);
+    std::lock_guard<std::mutex> lock(writerMutex_);
 
-    auto sourceShared = sourceWeak.lock();
-    auto destShared = destWeak.lock();
-
-    if (!sourceShared || !destShared) {
+    auto it = std::find_if(connections_.begin(), connections_.end(),
+        [&](const Connection& c) {
+            return c.source == sourceNodeId && c.destination == destinationNodeId;
+        });
+    if (it == connections_.end()) {
         return false;
     }
 
-    // Remove connection
-    sourceShared->disconnectOutput(destinationNodeId);
-    destShared->disconnectInput(sourceNodeId);
+    const Connection removed = *it;
+    const auto position = it - connections_.begin();
+    connections_.erase(it);
 
-    // Remove from connections map
-    {
-        std::unique_lock<std::shared_mutex> lock(connectionsMutex_);
-        auto it = connections_.find(destinationNodeId);
-        if (it != connections_.end()) {
-            auto connectedSource = it->second.lock();
-            if (connectedSource && connectedSource->getId() == sourceNodeId) {
-                connections_.erase(it);
-            }
-        }
+    try {
+        publishLocked();
+
+    } catch (const std::exception& e) {
+        connections_.insert(connections_.begin() + position, removed);
+        juce::Logger::writeToLog("ERROR: Failed to disconnect " + sourceNodeId + " -> " + destinationNodeId
+                                 + ": " + e.what());
+        return false;
     }
 
-    // Mark processing order as dirty
-    processingOrderDirty_ = true;
+    if (auto source = findNodeLocked(sourceNodeId)) {
+        source->disconnectOutput(destinationNodeId);
+    }
+    if (auto destination = findNodeLocked(destinationNodeId)) {
+        destination->disconnectInput(sourceNodeId);
+    }
 
+    touchModificationTime();
     juce::Logger::writeToLog("Disconnected " + sourceNodeId + " -> " + destinationNodeId);
     return true;
 }
 
 std::vector<std::string> MemorySafeAudioGraph::getNodeConnections(const std::string& nodeId) const {
-    auto nodeWeak = getNode(nodeId);
-    auto node = nodeWeak.lock();
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    std::vector<std::string> destinations;
 
-    if (!node) {
-        return {};
+    for (const auto& c : connections_) {
+        if (c.source == nodeId) {
+            destinations.push_back(c.destination);
+        }
+    }
+
+    return destinations;
+}
+
+bool MemorySafeAudioGraph::setGraphBufferSize(int newBufferSize) {
+    if (newBufferSize <= 0) {
+        return false;
     }
 
-    return node->getConnectedOutputIds();
+    std::lock_guard<std::mutex> lock(writerMutex_);
+
+    // Nodes resize their own buffers in place, so this is the one operation
+    // that needs the audio thread out of the graph
+    suspendRenderingLocked();
+
+    bool success = true;
+    for (auto& node : nodes_) {
+        success = node->resizeBuffers(newBufferSize) && success;
+    }
+
+    try {
+        publishLocked();
+    } catch (const std::exception& e) {
+        juce::Logger::writeToLog("ERROR: Failed to publish graph after resize: " + std::string(e.what()));
+        success = false;
+    }
+
+    renderSuspended_.store(false);
+    return success;
+}
+
+bool MemorySafeAudioGraph::setGraphSampleRate(double newSampleRate) {
+    if (newSampleRate <= 0.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(writerMutex_);
+
+    bool success = true;
+    for (auto& node : nodes_) {
+        success = node->setSampleRate(newSampleRate) && success;
+    }
+
+    return success;
+}
+
+void MemorySafeAudioGraph::optimizeProcessingOrder() {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    publishLocked();
+}
+
+size_t MemorySafeAudioGraph::collectRetired() {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return collectRetiredLocked();
+}
+
+uint64_t MemorySafeAudioGraph::getTopologyVersion() const {
+    // The writer mutex keeps the version from being reclaimed while we read it
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    const Topology* topology = current_.load();
+    return topology ? topology->version : 0;
 }
 
 bool MemorySafeAudioGraph::validateGraphIntegrity() const {
-    std::shared_lock<std::shared_mutex> nodesLock(nodesMutex_);
+    std::lock_guard<std::mutex> lock(writerMutex_);
 
     // Validate all nodes
-    for (const auto& [nodeId, node] : nodes_) {
+    for (const auto& node : nodes_) {
         if (!node) {
-            juce::Logger::writeToLog("ERROR: Null node found in graph: " + nodeId);
+            juce::Logger::writeToLog("ERROR: Null node found in graph");
             return false;
         }
 
         if (node->getState() == MemorySafeAudioNode::NodeState::Error) {
-            juce::Logger::writeToLog("WARNING: Node in error state: " + nodeId);
+            juce::Logger::writeToLog("WARNING: Node in error state: " + node->getId());
         }
 
         #ifdef DEBUG
         if (!node->validateMemoryIntegrity()) {
-            juce::Logger::writeToLog("ERROR: Memory corruption detected in node: " + nodeId);
+            juce::Logger::writeToLog("ERROR: Memory corruption detected in node: " + node->getId());
             return false;
         }
         #endif
     }
 
+    // The published version must match the model
+    const Topology* topology = current_.load();
+    if (topology && topology->nodes.size() != nodes_.size()) {
+        juce::Logger::writeToLog("ERROR: Published topology is out of date");
+        return false;
+    }
+
+    std::vector<uint32_t> order;
+    if (!sortNodesLocked(connections_, order)) {
+        juce::Logger::writeToLog("ERROR: Cycle found in graph connections");
+        return false;
+    }
+
     return true;
 }
 
 MemorySafeAudioGraph::GraphStats MemorySafeAudioGraph::getStats() const {
-    std::shared_lock<std::shared_mutex> nodesLock(nodesMutex_);
-    std::shared_lock<std::shared_mutex> connectionsLock(connectionsMutex_);
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    const Topology* topology = current_.load();
+    const bool rendering = pinnedEpoch_.load() != 0;
 
     return {
         nodes_.size(),
         connections_.size(),
         totalProcessCalls_.load(),
         totalErrors_.load(),
-        isGraphProcessing_.load(),
-        activeProcessingCount_.load()
+        rendering,
+        rendering ? 1u : 0u,
+        topology ? topology->version : 0,
+        publishedVersions_.load(),
+        rejectedRenders_.load(),
+        retired_.size()
     };
 }
 
 void MemorySafeAudioGraph::clear() {
-    // Request shutdown
-    requestShutdown();
+    std::lock_guard<std::mutex> lock(writerMutex_);
 
-    // Wait for processing to complete
-    while (isGraphProcessing_.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    auto removed = nodes_;
+    nodes_.clear();
+    connections_.clear();
+
+    try {
+        publishLocked(std::move(removed));
+    } catch (const std::exception& e) {
+        // An empty topology needs no buffers; only the retire list can throw
+        juce::Logger::writeToLog("ERROR: Failed to clear audio graph: " + std::string(e.what()));
     }
 
-    std::unique_lock<std::shared_mutex> nodesLock(nodesMutex_);
-    std::unique_lock<std::shared_mutex> connectionsLock(connectionsMutex_);
+    juce::Logger::writeToLog("Audio graph cleared");
+}
 
-    // Shutdown all nodes safely
-    for (auto& [nodeId, node] : nodes_) {
-        if (node) {
-            node->shutdown();
+//==============================================================================
+// Writer-side operations
+
+MemorySafeAudioGraph::SharedNodePtr MemorySafeAudioGraph::findNodeLocked(const std::string& nodeId) const {
+    for (const auto& node : nodes_) {
+        if (node->getId() == nodeId) {
+            return node;
         }
     }
+    return nullptr;
+}
 
-    // Clear all containers (RAII handles cleanup)
-    nodes_.clear();
-    connections_.clear();
-    processingOrder_.clear();
+bool MemorySafeAudioGraph::sortNodesLocked(const std::vector<Connection>& connections,
+                                         std::vector<uint32_t>& order) const {
+    const auto numNodes = static_cast<uint32_t>(nodes_.size());
 
-    juce::Logger::writeToLog("Audio graph cleared");
+    std::unordered_map<std::string, uint32_t> indexOf;
+    indexOf.reserve(numNodes);
+    for (uint32_t i = 0; i < numNodes; ++i) {
+        indexOf.emplace(nodes_[i]->getId(), i);
+    }
+
+    std::vector<std::vector<uint32_t>> outgoing(numNodes);
+    std::vector<uint32_t> inDegree(numNodes, 0);
+    for (const auto& c : connections) {
+        auto source = indexOf.find(c.source);
+        auto destination = indexOf.find(c.destination);
+        if (source == indexOf.end() || destination == indexOf.end()) {
+            continue;
+        }
+        outgoing[source->second].push_back(destination->second);
+        ++inDegree[destination->second];
+    }
+
+    // Kahn's algorithm, lowest insertion index first for a stable order
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+    for (uint32_t i = 0; i < numNodes; ++i) {
+        if (inDegree[i] == 0) {
+            ready.push(i);
+        }
+    }
+
+    order.clear();
+    order.reserve(numNodes);
+    while (!ready.empty()) {
+        const uint32_t index = ready.top();
+        ready.pop();
+        order.push_back(index);
+
+        for (uint32_t next : outgoing[index]) {
+            if (--inDegree[next] == 0) {
+                ready.push(next);
+            }
+        }
+    }
+
+    return order.size() == numNodes;
 }
 
-void MemorySafeAudioGraph::updateProcessingOrder() {
-    std::unique_lock<std::mutex> lock(processingOrderMutex_);
+std::unique_ptr<MemorySafeAudioGraph::Topology> MemorySafeAudioGraph::buildTopologyLocked() const {
+    auto topology = std::make_unique<Topology>();
 
-    processingOrder_.clear();
+    std::vector<uint32_t> order;
+    if (!sortNodesLocked(connections_, order)) {
+        throw std::logic_error("audio graph contains a cycle");
+    }
 
-    // Get all node IDs
-    auto nodeIds = getNodeIds();
+    const auto numNodes = static_cast<uint32_t>(order.size());
+    std::vector<uint32_t> positionOf(numNodes);
+    std::unordered_map<std::string, uint32_t> positionById;
+    positionById.reserve(numNodes);
+
+    topology->nodes.reserve(numNodes);
+    for (uint32_t position = 0; position < numNodes; ++position) {
+        const auto& node = nodes_[order[position]];
+        positionOf[order[position]] = position;
+        positionById.emplace(node->getId(), position);
+        topology->nodes.push_back(node);
+        topology->numChannels = std::max(topology->numChannels, node->getChannelCount());
+        topology->maxBlockSize = std::max(topology->maxBlockSize, node->getBufferSize());
+    }
 
-    // Simple topological sort
-    // For now, just use the order they were added
-    // A real implementation would do proper dependency resolution
-    processingOrder_ = nodeIds;
+    // Flatten each node's sources; a node feeding nothing is a sink
+    std::vector<std::vector<uint32_t>> incoming(numNodes);
+    topology->isSink.assign(numNodes, 1);
+    for (const auto& c : connections_) {
+        auto source = positionById.find(c.source);
+        auto destination = positionById.find(c.destination);
+        if (source == positionById.end() || destination == positionById.end()) {
+            continue;
+        }
+        incoming[destination->second].push_back(source->second);
+        topology->isSink[source->second] = 0;
+    }
+
+    topology->sourceStart.resize(numNodes);
+    topology->sourceCount.resize(numNodes);
+    for (uint32_t i = 0; i < numNodes; ++i) {
+        topology->sourceStart[i] = static_cast<uint32_t>(topology->sources.size());
+        topology->sourceCount[i] = static_cast<uint32_t>(incoming[i].size());
+        topology->sources.insert(topology->sources.end(), incoming[i].begin(), incoming[i].end());
+    }
 
-    processingOrderDirty_ = false;
+    // Scratch buffers for this version
+    const int numChannels = topology->numChannels;
+    if (numNodes > 0 && numChannels > 0) {
+        topology->nodeOutputs.setSize(static_cast<int>(numNodes) * numChannels, topology->maxBlockSize);
+        topology->nodeOutputs.clear();
+        topology->mixBuffer.setSize(numChannels, topology->maxBlockSize);
+        topology->mixBuffer.clear();
+
+        topology->outputPointers.resize(static_cast<size_t>(numNodes) * numChannels);
+        for (int ch = 0; ch < topology->nodeOutputs.getNumChannels(); ++ch) {
+            topology->outputPointers[ch] = topology->nodeOutputs.getWritePointer(ch);
+        }
+        topology->mixPointers.resize(numChannels);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            topology->mixPointers[ch] = topology->mixBuffer.getWritePointer(ch);
+        }
+    }
+
+    return topology;
 }
 
-std::vector<std::string> MemorySafeAudioGraph::getProcessingOrderSnapshot() const {
-    std::shared_lock<std::mutex> lock(processingOrderMutex_);
+void MemorySafeAudioGraph::publishLocked(std::vector<SharedNodePtr> removedNodes) {
+    // Everything that can throw happens before the exchange
+    auto next = buildTopologyLocked();
+    next->version = nextVersion_;
+    retired_.reserve(retired_.size() + 1);
+
+    Topology* previous = current_.exchange(next.release());
+    ++nextVersion_;
+    publishedVersions_.fetch_add(1, std::memory_order_relaxed);
+
+    // A render that pins this epoch or later loads the new version, so the
+    // previous one is safe to free once the pinned epoch reaches it
+    const uint64_t retireEpoch = globalEpoch_.fetch_add(1) + 1;
+
+    Retired entry;
+    entry.epoch = retireEpoch;
+    entry.topology.reset(previous);
+    entry.removedNodes = std::move(removedNodes);
+    retired_.push_back(std::move(entry));
+
+    collectRetiredLocked();
+}
 
-    if (processingOrderDirty_) {
-        // Need to update processing order
-        lock.unlock();
-        const_cast<MemorySafeAudioGraph*>(this)->updateProcessingOrder();
-        lock.lock();
+size_t MemorySafeAudioGraph::collectRetiredLocked() {
+    const uint64_t pinned = pinnedEpoch_.load();
+
+    auto reclaimable = [pinned](const Retired& entry) {
+        return pinned == 0 || pinned >= entry.epoch;
+    };
+
+    for (auto& entry : retired_) {
+        if (reclaimable(entry)) {
+            for (auto& node : entry.removedNodes) {
+                node->shutdown();
+            }
+        }
     }
 
-    return processingOrder_;
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(), reclaimable), retired_.end());
+    return retired_.size();
 }
 
-bool MemorySafeAudioGraph::validateNodeForProcessing(const std::string& nodeId) {
-    auto weakNode = getNode(nodeId);
-    auto node = weakNode.lock();
+void MemorySafeAudioGraph::suspendRenderingLocked() {
+    renderSuspended_.store(true);
+
+    while (pinnedEpoch_.load() != 0) {
+        std::this_thread::yield();
+    }
+}
 
-    return node && node->isReady();
+void MemorySafeAudioGraph::touchModificationTime() {
+    #ifdef DEBUG
+    lastNodeModification_.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    #endif
 }
 
 #ifdef DEBUG
@@ -925,9 +1201,9 @@ void MemorySafeAudioGraph::setCreatorContext(const std::string& context) {
 }
 
 bool MemorySafeAudioGraph::validateAllNodesMemoryIntegrity() const {
-    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
+    std::lock_guard<std::mutex> lock(writerMutex_);
 
-    for (const auto& [nodeId, node] : nodes_) {
+    for (const auto& node : nodes_) {
         if (node && !node->validateMemoryIntegrity()) {
             return false;
         }
@@ -1046,7 +1322,7 @@ ScopedAudioGraphManager::ScopedAudioGraphManager()
         graph_ = std::make_unique<MemorySafeAudioGraph>();
         initialized_ = true;
     } catch (const std::exception& e) {
-        juce::Logger::writeToLog("ERROR: Failed to create scoped audio graph: " + e.what());
+        juce::Logger::writeToLog("ERROR: Failed to create scoped audio graph: " + std::string(e.what()));
         graph_.reset();
         initialized_ = false;
     }
@@ -1072,7 +1348,7 @@ void ScopedAudioGraphManager::reset() {
         graph_ = std::make_unique<MemorySafeAudioGraph>();
         initialized_ = true;
     } catch (const std::exception& e) {
-        juce::Logger::writeToLog("ERROR: Failed to reset scoped audio graph: " + e.what());
+        juce::Logger::writeToLog("ERROR: Failed to reset scoped audio graph: " + std::string(e.what()));
         graph_.reset();
         initialized_ = false;
     }
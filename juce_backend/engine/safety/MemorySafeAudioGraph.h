@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <atomic>
@@ -69,6 +70,7 @@ private:
     const std::string nodeId_;
     const NodeType nodeType_;
     std::atomic<NodeState> currentState_{NodeState::Uninitialized};
+    std::atomic<double> sampleRate_{44100.0};
 
     // Audio buffers with automatic cleanup
     std::unique_ptr<juce::AudioBuffer<float>> inputBuffer_;
@@ -335,43 +337,93 @@ private:
 
 //==============================================================================
 /**
- * Memory-safe audio graph with proper lifecycle management
+ * Memory-safe audio graph with wait-free audio-thread traversal
  *
- * Eliminates use-after-free vulnerabilities through:
- * - Smart pointer-based node ownership
- * - Safe node removal during processing
- * - Atomic state management
- * - Exception-safe operations
- * - Comprehensive error handling
+ * The audio thread never takes a lock and never frees memory:
+ * - Every structural change (add/remove/connect/disconnect/resize) builds a
+ *   new immutable Topology on the calling thread: nodes in topological
+ *   order, flattened source lists, and the scratch buffers the render needs.
+ *   The new version is published with a single atomic pointer exchange.
+ * - processAudio() pins the current epoch before loading the topology and
+ *   unpins when done. Nothing it can reach is freed while it is pinned.
+ * - Replaced versions, and the nodes and buffers only they referenced, go on
+ *   a retire list stamped with the epoch at which they were unpublished.
+ *   collectRetired() frees every entry that no pinned render can still see.
+ *   Writers call it after each publish; call it from a message-thread timer
+ *   as well so retirements complete while the graph is idle.
+ *
+ * Routing: a node without inputs reads the graph input, a node with inputs
+ * reads the sum of its sources' outputs, and nodes without outputs are summed
+ * into the graph output.
+ *
+ * Threading: structural operations are serialised by a writer mutex and may
+ * be called from any non-audio thread. One render runs at a time; a second
+ * concurrent processAudio() call is rejected (returns false) instead of
+ * waiting.
  */
 class MemorySafeAudioGraph {
 public:
     using NodePtr = std::unique_ptr<MemorySafeAudioNode>;
-    using NodeMap = std::unordered_map<std::string, NodePtr>;
+    using SharedNodePtr = std::shared_ptr<MemorySafeAudioNode>;
+    using NodeMap = std::unordered_map<std::string, SharedNodePtr>;
     using WeakNodeMap = std::unordered_map<std::string, std::weak_ptr<MemorySafeAudioNode>>;
 
 private:
-    // Node storage with unique ownership
-    NodeMap nodes_;
-    mutable std::shared_mutex nodesMutex_;
+    /**
+     * Immutable graph version traversed by the audio thread
+     *
+     * Structure never changes after publication. The buffers are render
+     * scratch owned by the version, so they are retired together with the
+     * nodes that write into them.
+     */
+    struct Topology {
+        uint64_t version = 0;
+        int numChannels = 0;
+        int maxBlockSize = 0;
+
+        std::vector<SharedNodePtr> nodes;         // Processing order
+        std::vector<uint32_t> sourceStart;        // Per node, into sources
+        std::vector<uint32_t> sourceCount;        // Per node
+        std::vector<uint32_t> sources;            // Indices into nodes
+        std::vector<uint8_t> isSink;              // Per node, summed into the graph output
+
+        juce::AudioBuffer<float> nodeOutputs;     // nodes.size() * numChannels channels
+        juce::AudioBuffer<float> mixBuffer;       // Sum of sources for multi-input nodes
+        std::vector<float*> outputPointers;       // Per node, numChannels each
+        std::vector<float*> mixPointers;
+    };
 
-    // Processing state
-    std::atomic<bool> isGraphProcessing_{false};
-    std::atomic<uint32_t> activeProcessingCount_{0};
-    std::atomic<bool> shutdownRequested_{false};
+    /** Unpublished data waiting for every render that could see it to finish */
+    struct Retired {
+        uint64_t epoch = 0;
+        std::unique_ptr<Topology> topology;
+        std::vector<SharedNodePtr> removedNodes;  // Shut down on reclamation
+    };
 
-    // Graph structure with safe references
-    WeakNodeMap connections_;
-    mutable std::shared_mutex connectionsMutex_;
+    struct Connection {
+        std::string source;
+        std::string destination;
+    };
 
-    // Processing order and optimization
-    std::vector<std::string> processingOrder_;
-    mutable std::mutex processingOrderMutex_;
-    bool processingOrderDirty_{true};
+    // Writer-side model (guarded by writerMutex_)
+    mutable std::mutex writerMutex_;
+    std::vector<SharedNodePtr> nodes_;            // Insertion order
+    std::vector<Connection> connections_;
+    std::vector<Retired> retired_;
+    uint64_t nextVersion_{1};
+
+    // Published state shared with the audio thread
+    std::atomic<Topology*> current_{nullptr};
+    std::atomic<uint64_t> globalEpoch_{1};
+    std::atomic<uint64_t> pinnedEpoch_{0};        // 0 = no render in flight
+    std::atomic<bool> renderSuspended_{false};
+    std::atomic<bool> shutdownRequested_{false};
 
     // Statistics and monitoring
     std::atomic<uint64_t> totalProcessCalls_{0};
     std::atomic<uint64_t> totalErrors_{0};
+    std::atomic<uint64_t> rejectedRenders_{0};
+    std::atomic<uint64_t> publishedVersions_{0};
 
     // Memory safety debugging
     #ifdef DEBUG
@@ -386,18 +438,15 @@ public:
     MemorySafeAudioGraph();
 
     /**
-     * Destructor ensures clean shutdown of all nodes
+     * Destructor waits for an in-flight render, then frees every version
      */
     ~MemorySafeAudioGraph();
 
-    // Disable copying to maintain unique ownership
+    // The audio thread holds a pointer to the graph, so it is neither
+    // copyable nor movable
     MemorySafeAudioGraph(const MemorySafeAudioGraph&) = delete;
     MemorySafeAudioGraph& operator=(const MemorySafeAudioGraph&) = delete;
 
-    // Enable moving
-    MemorySafeAudioGraph(MemorySafeAudioGraph&&) = default;
-    MemorySafeAudioGraph& operator=(MemorySafeAudioGraph&&) = default;
-
     //==============================================================================
     // Memory-safe node management
 
@@ -410,8 +459,9 @@ public:
     bool addNode(NodePtr node);
 
     /**
-     * Remove a node safely from the graph
-     * Ensures node is not processing before removal
+     * Remove a node and its connections from the graph
+     * Returns immediately; the node is shut down and freed once no render
+     * can reference it any more.
      *
      * @param nodeId ID of node to remove
      * @return true if node removed successfully
@@ -419,11 +469,12 @@ public:
     bool removeNode(const std::string& nodeId);
 
     /**
-     * Remove a node asynchronously during processing
-     * Uses futures to ensure safe cleanup
+     * Remove a node without blocking on the audio thread
+     * Removal never waits for a render, so the returned future is already
+     * satisfied. Kept for callers written against the blocking design.
      *
      * @param nodeId ID of node to remove
-     * @return Future that completes when removal is done
+     * @return Future holding the result of removeNode()
      */
     std::future<bool> removeNodeAsync(const std::string& nodeId);
 
@@ -448,18 +499,20 @@ public:
     size_t getNodeCount() const;
 
     //==============================================================================
-    // Memory-safe processing
+    // Wait-free processing
 
     /**
-     * Process the entire audio graph safely
-     * Handles node removal and state changes atomically
+     * Render one block through the current topology version
+     * Lock-free and allocation-free. Structural changes made while this runs
+     * take effect from the next block.
      *
      * @param inputAudio Input audio buffers
      * @param numInputChannels Number of input channels
      * @param numSamples Number of samples to process
      * @param outputAudio Output audio buffers
      * @param numOutputChannels Number of output channels
-     * @return true if processing successful
+     * @return false if a node failed, the block exceeds the node buffers,
+     *         another render is in flight, or the graph is suspended
      */
     bool processAudio(const float* const* inputAudio,
                      int numInputChannels,
@@ -468,9 +521,9 @@ public:
                      int numOutputChannels);
 
     /**
-     * Check if graph is currently processing
+     * Check if a render is currently in flight
      */
-    bool isProcessing() const noexcept { return isGraphProcessing_.load(); }
+    bool isProcessing() const noexcept { return pinnedEpoch_.load() != 0; }
 
     /**
      * Request graph shutdown
@@ -487,7 +540,8 @@ public:
 
     /**
      * Connect two nodes safely
-     * Validates node existence and connection validity
+     * Rejects self-connections, duplicates and connections that would
+     * create a cycle.
      *
      * @param sourceNodeId Source node ID
      * @param destinationNodeId Destination node ID
@@ -507,7 +561,7 @@ public:
                         const std::string& destinationNodeId);
 
     /**
-     * Get all connections for a node
+     * Get all destinations fed by a node
      */
     std::vector<std::string> getNodeConnections(const std::string& nodeId) const;
 
@@ -516,7 +570,7 @@ public:
 
     /**
      * Set buffer size for all nodes safely
-     * Waits for processing to complete before changing
+     * Suspends rendering (renders return false) while the nodes resize.
      */
     bool setGraphBufferSize(int newBufferSize);
 
@@ -526,10 +580,26 @@ public:
     bool setGraphSampleRate(double newSampleRate);
 
     /**
-     * Optimize processing order
+     * Rebuild and republish the processing order
      */
     void optimizeProcessingOrder();
 
+    //==============================================================================
+    // Deferred reclamation
+
+    /**
+     * Free retired topology versions, nodes and buffers that no render can
+     * still reference. Never blocks on the audio thread.
+     *
+     * @return Number of retirements still pending
+     */
+    size_t collectRetired();
+
+    /**
+     * Topology version currently visible to the audio thread (0 = none)
+     */
+    uint64_t getTopologyVersion() const;
+
     //==============================================================================
     // Memory safety and monitoring
 
@@ -549,13 +619,18 @@ public:
         uint64_t totalErrors;
         bool isCurrentlyProcessing;
         uint32_t activeProcessingCount;
+        uint64_t topologyVersion;
+        uint64_t publishedVersions;
+        uint64_t rejectedRenders;
+        size_t pendingRetirements;
     };
 
     GraphStats getStats() const;
 
     /**
-     * Clear all nodes safely
-     * Ensures no processing is active before cleanup
+     * Remove all nodes
+     * Publishes an empty topology; the old nodes are reclaimed once the
+     * render that may be using them finishes.
      */
     void clear();
 
@@ -573,27 +648,45 @@ public:
 
 private:
     //==============================================================================
-    // Memory-safe internal operations
+    // Writer-side operations (writerMutex_ held)
+
+    /**
+     * Find a node in the writer-side model
+     */
+    SharedNodePtr findNodeLocked(const std::string& nodeId) const;
+
+    /**
+     * Topological order of the model as indices into nodes_
+     * Ties keep insertion order. Returns false if the connections contain a
+     * cycle.
+     */
+    bool sortNodesLocked(const std::vector<Connection>& connections,
+                         std::vector<uint32_t>& order) const;
+
+    /**
+     * Build a topology version from the writer-side model
+     */
+    std::unique_ptr<Topology> buildTopologyLocked() const;
 
     /**
-     * Update processing order based on connections
+     * Publish a new version and retire the previous one
      */
-    void updateProcessingOrder();
+    void publishLocked(std::vector<SharedNodePtr> removedNodes = {});
 
     /**
-     * Get processing order snapshot
+     * Free retirements whose epoch every pinned render has passed
      */
-    std::vector<std::string> getProcessingOrderSnapshot() const;
+    size_t collectRetiredLocked();
 
     /**
-     * Validate node before processing
+     * Stop new renders and wait for the in-flight one to finish
      */
-    bool validateNodeForProcessing(const std::string& nodeId);
+    void suspendRenderingLocked();
 
     /**
-     * Cleanup disconnected nodes safely
+     * Record modification time (debug builds)
      */
-    void cleanupDisconnectedNodes();
+    void touchModificationTime();
 };
 
 //==============================================================================
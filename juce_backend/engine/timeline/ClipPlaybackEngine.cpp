@@ -0,0 +1,885 @@
+#include "ClipPlaybackEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    constexpr int readChunkFrames = 16384;
+    constexpr auto streamerInterval = std::chrono::milliseconds(2);
+
+    float fadeGain(double fraction, SchillingerEcosystem::Timeline::AudioClip::FadeCurve curve) noexcept
+    {
+        using FadeCurve = SchillingerEcosystem::Timeline::AudioClip::FadeCurve;
+
+        if (curve == FadeCurve::EqualPower)
+            return static_cast<float>(std::sin(fraction * juce::MathConstants<double>::halfPi));
+
+        return static_cast<float>(fraction);
+    }
+
+    // 4-point Catmull-Rom between y1 and y2
+    float cubic(float y0, float y1, float y2, float y3, float x) noexcept
+    {
+        return y1 + 0.5f * x * (y2 - y0 + x * (2.0f * y0 - 5.0f * y1 + 4.0f * y2 - y3
+                                             + x * (3.0f * (y1 - y2) + y3 - y0)));
+    }
+
+    int64_t floorFrame(double position) noexcept
+    {
+        return static_cast<int64_t>(std::floor(position));
+    }
+}
+
+//==============================================================================
+/** An open audio file, shared by every clip that plays it; only the streamer reads it */
+struct ClipPlaybackEngine::Source
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    double sampleRate = 44100.0;
+    int64_t length = 0;
+    int numChannels = 0;
+};
+
+/**
+    Ring of source frames for one clip, starting where the streamer first
+    needed it and only moving forward. Frames [consumed, writtenEnd) are
+    valid. The audio
+    thread only reads at or after consumed and only raises it; the streamer
+    only writes below consumed + ringFrames, so it never overwrites a frame
+    the audio thread can still read.
+*/
+struct ClipPlaybackEngine::Stream
+{
+    std::vector<float> ring;                    // maxStreamChannels x ringFrames
+
+    std::atomic<int64_t> writtenEnd { 0 };      // Published by the streamer
+    std::atomic<int64_t> consumed { 0 };        // Published by the audio thread
+
+    // Streamer side (streamMutex)
+    bool inUse = false;
+    bool matched = false;
+    int64_t consumedSnapshot = 0;
+    uint64_t retiredEpoch = 0;                  // Free once no block pinned before it runs
+    std::shared_ptr<Source> source;
+    int numChannels = 0;
+    int64_t endFrame = 0;                       // Fill limit
+    double ratio = 1.0;
+    double mapping = 0.0;                       // Source frame at timeline sample 0
+    TrackId ownerTrack = invalidId;
+    uint64_t ownerRevision = 0;                 // Clip list holding ownerSlot
+    std::atomic<Stream*>* ownerSlot = nullptr;
+};
+
+//==============================================================================
+size_t ClipPlaybackEngine::ClipList::firstCandidate(int64_t sample) const noexcept
+{
+    // Every clip before the first running maximum past sample has already ended
+    return static_cast<size_t>(std::upper_bound(endPrefixMax.begin(), endPrefixMax.end(), sample)
+                               - endPrefixMax.begin());
+}
+
+//==============================================================================
+ClipPlaybackEngine::ClipPlaybackEngine()
+{
+    formatManager.registerBasicFormats();
+
+    for (auto& list : lists)
+        list.store(nullptr);
+}
+
+ClipPlaybackEngine::~ClipPlaybackEngine()
+{
+    stopStreamer();
+}
+
+void ClipPlaybackEngine::prepare(double newSampleRate, int newMaxBlockSize)
+{
+    stopStreamer();
+
+    {
+        std::lock_guard<std::mutex> writerLock(writerMutex);
+        std::unique_lock<std::mutex> streamLock(streamMutex);
+
+        if (newSampleRate > 0.0)
+            sampleRate = newSampleRate;
+        maxBlockSize = std::max(1, newMaxBlockSize);
+        gainBuffer.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+
+        // Room for the read-ahead of a source at up to twice the engine rate
+        const auto wanted = static_cast<int64_t>(std::ceil(readAheadSeconds * sampleRate * 2.0));
+        ringFrames = juce::nextPowerOfTwo(static_cast<int>(std::max<int64_t>({ wanted, 4 * maxBlockSize, 4096 })));
+
+        streamPool.clear();
+        for (int i = 0; i < numStreams; ++i)
+        {
+            auto stream = std::make_unique<Stream>();
+            stream->ring.assign(static_cast<size_t>(maxStreamChannels * ringFrames), 0.0f);
+            streamPool.push_back(std::move(stream));
+        }
+        readBuffer.setSize(maxStreamChannels, readChunkFrames);
+        activeStreams.reserve(static_cast<size_t>(numStreams));
+        streamLock.unlock();
+
+        // Boundaries move with the rate; the rebuilt lists start without rings
+        for (TrackId track = 0; track < maxTracks; ++track)
+        {
+            if (!tracks[static_cast<size_t>(track)].active)
+                continue;
+
+            bool allOpened = true;
+            publishLocked(track, buildList(tracks[static_cast<size_t>(track)].clips, allOpened));
+        }
+
+        collectRetiredLocked();
+    }
+
+    startStreamer();
+}
+
+void ClipPlaybackEngine::setStreamingOptions(int newNumStreams, double newReadAheadSeconds)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    numStreams = std::max(1, newNumStreams);
+    readAheadSeconds = std::max(0.05, newReadAheadSeconds);
+}
+
+ClipPlaybackEngine::TrackId ClipPlaybackEngine::addTrack()
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    for (TrackId id = 0; id < maxTracks; ++id)
+    {
+        auto& track = tracks[static_cast<size_t>(id)];
+        if (track.active)
+            continue;
+
+        track.active = true;
+        track.clips.clear();
+        return id;
+    }
+
+    juce::Logger::writeToLog("ClipPlaybackEngine: no free track slot");
+    return invalidId;
+}
+
+void ClipPlaybackEngine::removeTrack(TrackId id)
+{
+    if (id < 0 || id >= maxTracks)
+        return;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    auto& track = tracks[static_cast<size_t>(id)];
+    if (!track.active)
+        return;
+
+    publishLocked(id, nullptr);
+    track.active = false;
+    track.clips.clear();
+}
+
+bool ClipPlaybackEngine::setClips(TrackId id, std::vector<Clip> clips)
+{
+    if (id < 0 || id >= maxTracks)
+        return false;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    auto& track = tracks[static_cast<size_t>(id)];
+    if (!track.active)
+        return false;
+
+    bool allOpened = true;
+    auto list = buildList(clips, allOpened);
+    track.clips = std::move(clips);
+    publishLocked(id, std::move(list));
+    return allOpened;
+}
+
+void ClipPlaybackEngine::clearTrack(TrackId id)
+{
+    if (id < 0 || id >= maxTracks)
+        return;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    tracks[static_cast<size_t>(id)].clips.clear();
+    publishLocked(id, nullptr);
+}
+
+int ClipPlaybackEngine::getNumClips(TrackId id) const
+{
+    if (id < 0 || id >= maxTracks)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    const auto& live = tracks[static_cast<size_t>(id)].live;
+    return live != nullptr ? static_cast<int>(live->clips.size()) : 0;
+}
+
+size_t ClipPlaybackEngine::collectRetired()
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    return collectRetiredLocked();
+}
+
+std::unique_ptr<ClipPlaybackEngine::ClipList> ClipPlaybackEngine::buildList(const std::vector<Clip>& clips,
+                                                                            bool& allOpened)
+{
+    auto list = std::make_unique<ClipList>();
+    list->clips.reserve(clips.size());
+
+    for (const auto& clip : clips)
+    {
+        std::shared_ptr<Source> source;
+        double sourceRate = clip.getSourceSampleRate();
+        int64_t sourceLength = 0;
+        int numChannels = 0;
+
+        if (clip.isStreamed())
+        {
+            const auto path = clip.getSourceFile().getFullPathName();
+            source = openSources[path].lock();
+
+            if (source == nullptr)
+            {
+                std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(clip.getSourceFile()));
+                if (reader == nullptr || reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0)
+                {
+                    juce::Logger::writeToLog("ClipPlaybackEngine: cannot open " + path);
+                    allOpened = false;
+                    continue;
+                }
+
+                source = std::make_shared<Source>();
+                source->sampleRate = reader->sampleRate;
+                source->length = reader->lengthInSamples;
+                source->numChannels = std::min(static_cast<int>(reader->numChannels), maxStreamChannels);
+                source->reader = std::move(reader);
+                openSources[path] = source;
+            }
+
+            sourceRate = source->sampleRate;
+            sourceLength = source->length;
+            numChannels = source->numChannels;
+        }
+        else if (const auto& buffer = clip.getAudioBuffer(); buffer != nullptr)
+        {
+            sourceLength = buffer->getNumSamples();
+            numChannels = buffer->getNumChannels();
+        }
+
+        if (sourceLength <= 0 || numChannels <= 0 || sourceRate <= 0.0)
+            continue;
+
+        PlaybackClip playback;
+        playback.start = std::llround(clip.getStart() * sampleRate);
+        playback.ratio = sourceRate / sampleRate;
+        playback.sourceOffset = clip.getSourceStart() * sourceRate;
+        playback.sourceEnd = std::min(clip.getSourceEnd() * sourceRate, static_cast<double>(sourceLength));
+        playback.integral = playback.ratio == 1.0 && playback.sourceOffset == std::floor(playback.sourceOffset);
+        playback.gain = clip.getGain();
+        playback.numChannels = numChannels;
+        playback.sourceLength = sourceLength;
+        playback.buffer = clip.isStreamed() ? nullptr : clip.getAudioBuffer();
+        playback.source = source;
+
+        // The clip ends at its end or where the source range runs out
+        const auto playable = static_cast<int64_t>(std::ceil((playback.sourceEnd - playback.sourceOffset) / playback.ratio));
+        playback.end = std::min<int64_t>(std::llround(clip.getEnd() * sampleRate), playback.start + playable);
+        if (playback.end <= playback.start)
+            continue;
+
+        playback.fadeInSamples = std::llround(clip.getFadeIn() * sampleRate);
+        playback.fadeOutSamples = std::llround(clip.getFadeOut() * sampleRate);
+        playback.fadeInCurve = clip.getFadeInCurve();
+        playback.fadeOutCurve = clip.getFadeOutCurve();
+
+        list->clips.push_back(std::move(playback));
+    }
+
+    std::stable_sort(list->clips.begin(), list->clips.end(),
+                     [](const PlaybackClip& a, const PlaybackClip& b) { return a.start < b.start; });
+
+    for (size_t i = 0; i < list->clips.size(); ++i)
+    {
+        auto& clip = list->clips[i];
+
+        // A clip starting inside the previous one, which ends inside it, crossfades over the overlap
+        if (i > 0)
+        {
+            auto& previous = list->clips[i - 1];
+            const int64_t overlap = previous.end - clip.start;
+
+            if (overlap > 0 && previous.start < clip.start && previous.end <= clip.end)
+            {
+                if (previous.fadeOutSamples < overlap)
+                {
+                    previous.fadeOutSamples = overlap;
+                    previous.fadeOutCurve = Clip::FadeCurve::EqualPower;
+                }
+
+                if (clip.fadeInSamples < overlap)
+                {
+                    clip.fadeInSamples = overlap;
+                    clip.fadeInCurve = Clip::FadeCurve::EqualPower;
+                }
+            }
+        }
+    }
+
+    for (auto& clip : list->clips)
+    {
+        // Fades longer than the clip share it in proportion
+        const int64_t length = clip.end - clip.start;
+        const int64_t fades = clip.fadeInSamples + clip.fadeOutSamples;
+        if (fades > length)
+        {
+            clip.fadeInSamples = clip.fadeInSamples * length / fades;
+            clip.fadeOutSamples = length - clip.fadeInSamples;
+        }
+
+        list->endPrefixMax.push_back(std::max(clip.end, list->endPrefixMax.empty() ? clip.end
+                                                                                   : list->endPrefixMax.back()));
+    }
+
+    list->streams = std::vector<StreamSlots>(list->clips.size());
+    for (auto& slots : list->streams)
+        for (auto& slot : slots)
+            slot.store(nullptr);
+
+    return list;
+}
+
+void ClipPlaybackEngine::publishLocked(TrackId id, std::unique_ptr<ClipList> list)
+{
+    const auto index = static_cast<size_t>(id);
+    auto& track = tracks[index];
+
+    if (list != nullptr && list->clips.empty())
+        list.reset();
+    if (list == nullptr && track.live == nullptr)
+        return;
+
+    // Everything that can throw happens before the exchange
+    retired.reserve(retired.size() + 1);
+
+    if (list != nullptr)
+    {
+        list->revision = nextRevision++;
+
+        // Rings of clips that survive the edit unchanged carry over, so
+        // editing one clip does not re-buffer the whole track
+        std::lock_guard<std::mutex> streamLock(streamMutex);
+        for (auto& stream : streamPool)
+        {
+            if (!stream->inUse || stream->ownerTrack != id)
+                continue;
+
+            for (size_t i = 0; i < list->clips.size(); ++i)
+            {
+                const auto& clip = list->clips[i];
+                auto& slots = list->streams[i];
+
+                if (clip.source != stream->source || clip.ratio != stream->ratio
+                    || std::abs(clip.sourceOffset - static_cast<double>(clip.start) * clip.ratio - stream->mapping) > 1.0e-6)
+                    continue;
+
+                auto* slot = slots[0].load() == nullptr ? &slots[0]
+                           : slots[1].load() == nullptr ? &slots[1] : nullptr;
+                if (slot == nullptr)
+                    continue;
+
+                slot->store(stream.get());
+                stream->endFrame = std::min(clip.sourceLength, static_cast<int64_t>(std::ceil(clip.sourceEnd)) + 2);
+                stream->ownerRevision = list->revision;
+                stream->ownerSlot = slot;
+                break;
+            }
+        }
+    }
+
+    std::unique_ptr<const ClipList> next(std::move(list));
+    lists[index].exchange(next.get());
+    auto previous = std::move(track.live);
+    track.live = std::move(next);
+
+    if (previous != nullptr)
+    {
+        // A block or streamer pass that pins this epoch or later loads the
+        // new list, so the previous one is safe to free once both reach it
+        Retired entry;
+        entry.epoch = globalEpoch.fetch_add(1) + 1;
+        entry.list = std::move(previous);
+        retired.push_back(std::move(entry));
+    }
+
+    collectRetiredLocked();
+}
+
+size_t ClipPlaybackEngine::collectRetiredLocked()
+{
+    const uint64_t audioPinned = pinnedEpoch.load();
+    const uint64_t streamerPinned = streamerEpoch.load();
+
+    auto releasable = [](uint64_t pinned, uint64_t epoch) { return pinned == 0 || pinned >= epoch; };
+
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [&](const Retired& entry)
+                                 {
+                                     return releasable(audioPinned, entry.epoch)
+                                         && releasable(streamerPinned, entry.epoch);
+                                 }),
+                  retired.end());
+
+    // Files no remaining clip plays are closed
+    for (auto it = openSources.begin(); it != openSources.end();)
+        it = it->second.expired() ? openSources.erase(it) : std::next(it);
+
+    return retired.size();
+}
+
+//==============================================================================
+void ClipPlaybackEngine::beginBlock(const AutomationTransport& newTransport) noexcept
+{
+    // Pin before any list is loaded; lists retired after this epoch stay alive
+    pinnedEpoch.store(globalEpoch.load());
+    transport = newTransport;
+    transport.numSamples = std::max(0, transport.numSamples);
+    blockUnderrun = false;
+
+    const bool loopActive = transport.looping && transport.loopEndSample > transport.loopStartSample;
+    playheadLooping.store(loopActive);
+    playheadLoopStart.store(transport.loopStartSample);
+    playheadLoopEnd.store(transport.loopEndSample);
+    playhead.store(transport.startSample);
+
+    if (nonRealtime.load())
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        serviceStreams();
+    }
+}
+
+void ClipPlaybackEngine::endBlock() noexcept
+{
+    if (blockUnderrun)
+        underruns.fetch_add(1, std::memory_order_relaxed);
+
+    pinnedEpoch.store(0);
+}
+
+bool ClipPlaybackEngine::renderTrack(TrackId id, float* const* outputs, int numChannels) noexcept
+{
+    if (id < 0 || id >= maxTracks || outputs == nullptr || numChannels <= 0)
+        return false;
+
+    const auto* list = lists[static_cast<size_t>(id)].load();
+    if (list == nullptr)
+        return false;
+
+    bool rendered = false;
+
+    forEachRun([&](int blockOffset, int count, int64_t startSample)
+    {
+        const int64_t endSample = startSample + count;
+
+        for (size_t i = list->firstCandidate(startSample);
+             i < list->clips.size() && list->clips[i].start < endSample; ++i)
+        {
+            const auto& clip = list->clips[i];
+            if (clip.end <= startSample)
+                continue;
+
+            const int64_t from = std::max(startSample, clip.start);
+            const int64_t to = std::min(endSample, clip.end);
+            rendered |= renderClip(clip, list->streams[i], from, static_cast<int>(to - from), outputs,
+                                   blockOffset + static_cast<int>(from - startSample), numChannels);
+        }
+    });
+
+    return rendered;
+}
+
+bool ClipPlaybackEngine::renderAllTracks(float* const* outputs, int numChannels) noexcept
+{
+    bool rendered = false;
+
+    for (TrackId id = 0; id < maxTracks; ++id)
+        rendered |= renderTrack(id, outputs, numChannels);
+
+    return rendered;
+}
+
+template <typename RunFunction>
+void ClipPlaybackEngine::forEachRun(RunFunction&& run) const noexcept
+{
+    const bool loopActive = transport.looping && transport.loopEndSample > transport.loopStartSample;
+
+    int64_t position = transport.startSample;
+    int blockOffset = 0;
+
+    while (blockOffset < transport.numSamples)
+    {
+        // Split the block where the transport wraps back to the loop start
+        int count = transport.numSamples - blockOffset;
+        if (loopActive && position < transport.loopEndSample)
+            count = static_cast<int>(std::min<int64_t>(count, transport.loopEndSample - position));
+
+        run(blockOffset, count, position);
+
+        blockOffset += count;
+        position += count;
+
+        if (loopActive && position == transport.loopEndSample)
+            position = transport.loopStartSample;
+    }
+}
+
+void ClipPlaybackEngine::applyFades(const PlaybackClip& clip, int64_t startSample, int count, float* gains) const noexcept
+{
+    std::fill(gains, gains + count, clip.gain);
+
+    // Fade in: 0 at the first sample; fade out: 1 / length at the last one,
+    // so a crossfade's two gains always sum to one before the curve
+    const int64_t fadeInEnd = clip.start + clip.fadeInSamples;
+    for (int64_t t = startSample; t < std::min(startSample + count, fadeInEnd); ++t)
+    {
+        const double fraction = static_cast<double>(t - clip.start) / static_cast<double>(clip.fadeInSamples);
+        gains[t - startSample] *= fadeGain(fraction, clip.fadeInCurve);
+    }
+
+    const int64_t fadeOutStart = clip.end - clip.fadeOutSamples;
+    for (int64_t t = std::max(startSample, fadeOutStart); t < startSample + count; ++t)
+    {
+        const double fraction = static_cast<double>(clip.end - t) / static_cast<double>(clip.fadeOutSamples);
+        gains[t - startSample] *= fadeGain(fraction, clip.fadeOutCurve);
+    }
+}
+
+bool ClipPlaybackEngine::renderClip(const PlaybackClip& clip, const StreamSlots& streams, int64_t startSample, int count,
+                                    float* const* outputs, int outputOffset, int numChannels) noexcept
+{
+    // Source frames this stretch reads, with the interpolator's neighbours
+    const auto positionAt = [&clip](int64_t sample)
+    {
+        return clip.sourceOffset + static_cast<double>(sample - clip.start) * clip.ratio;
+    };
+
+    const int64_t lowFrame = std::max<int64_t>(0, floorFrame(positionAt(startSample)) - (clip.integral ? 0 : 1));
+    const int64_t highFrame = std::min(clip.sourceLength - 1,
+                                       floorFrame(positionAt(startSample + count - 1)) + (clip.integral ? 0 : 2));
+
+    const float* ring = nullptr;
+    Stream* stream = nullptr;
+    if (clip.source != nullptr)
+    {
+        for (const auto& slot : streams)
+        {
+            auto* candidate = slot.load();
+            if (candidate != nullptr && lowFrame >= candidate->consumed.load(std::memory_order_relaxed)
+                && highFrame < candidate->writtenEnd.load(std::memory_order_acquire))
+            {
+                stream = candidate;
+                break;
+            }
+        }
+
+        if (stream == nullptr)
+        {
+            blockUnderrun = true;
+            return false;
+        }
+
+        ring = stream->ring.data();
+    }
+
+    const int64_t mask = ringFrames - 1;
+    const int64_t length = clip.sourceLength;
+    const auto* buffer = clip.buffer.get();
+
+    const auto frameAt = [&](int channel, int64_t frame) noexcept -> float
+    {
+        if (frame < 0 || frame >= length)
+            return 0.0f;
+        if (ring != nullptr)
+            return ring[channel * ringFrames + (frame & mask)];
+        return buffer->getSample(channel, static_cast<int>(frame));
+    };
+
+    for (int done = 0; done < count;)
+    {
+        const int chunk = std::min(count - done, static_cast<int>(gainBuffer.size()));
+        const int64_t chunkStart = startSample + done;
+        applyFades(clip, chunkStart, chunk, gainBuffer.data());
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const int sourceChannel = std::min(channel, clip.numChannels - 1);
+            float* output = outputs[channel] + outputOffset + done;
+
+            if (clip.integral)
+            {
+                const int64_t firstFrame = static_cast<int64_t>(clip.sourceOffset) + (chunkStart - clip.start);
+                for (int i = 0; i < chunk; ++i)
+                    output[i] += gainBuffer[static_cast<size_t>(i)] * frameAt(sourceChannel, firstFrame + i);
+            }
+            else
+            {
+                for (int i = 0; i < chunk; ++i)
+                {
+                    const double position = positionAt(chunkStart + i);
+                    const int64_t frame = floorFrame(position);
+                    const float x = static_cast<float>(position - static_cast<double>(frame));
+                    const float value = cubic(frameAt(sourceChannel, frame - 1), frameAt(sourceChannel, frame),
+                                              frameAt(sourceChannel, frame + 1), frameAt(sourceChannel, frame + 2), x);
+                    output[i] += gainBuffer[static_cast<size_t>(i)] * value;
+                }
+            }
+        }
+
+        done += chunk;
+    }
+
+    // Frames before the next sample's neighbours are free for the streamer
+    if (stream != nullptr)
+    {
+        const int64_t next = std::max<int64_t>(0, floorFrame(positionAt(startSample + count)) - 1);
+        if (next > stream->consumed.load(std::memory_order_relaxed))
+            stream->consumed.store(next, std::memory_order_release);
+    }
+
+    return true;
+}
+
+//==============================================================================
+void ClipPlaybackEngine::startStreamer()
+{
+    if (streamerRunning.exchange(true))
+        return;
+
+    streamer = std::thread([this] { streamerLoop(); });
+}
+
+void ClipPlaybackEngine::stopStreamer()
+{
+    if (!streamerRunning.exchange(false))
+        return;
+
+    if (streamer.joinable())
+        streamer.join();
+}
+
+void ClipPlaybackEngine::streamerLoop()
+{
+    while (streamerRunning.load())
+    {
+        if (!nonRealtime.load())
+        {
+            std::lock_guard<std::mutex> lock(streamMutex);
+
+            streamerEpoch.store(globalEpoch.load());
+            serviceStreams();
+            streamerEpoch.store(0);
+        }
+
+        std::this_thread::sleep_for(streamerInterval);
+    }
+}
+
+void ClipPlaybackEngine::serviceStreams()
+{
+    if (streamPool.empty())
+        return;
+
+    // Read every ring's position before the playhead: the audio thread moves
+    // consumed at the end of a block, so a ring can then be at most one block
+    // ahead of the playhead read below, never behind it
+    for (auto& stream : streamPool)
+    {
+        stream->matched = false;
+        stream->consumedSnapshot = stream->consumed.load();
+    }
+
+    const int64_t position = playhead.load();
+    const bool loopActive = playheadLooping.load();
+    const int64_t loopStart = playheadLoopStart.load();
+    const int64_t loopEnd = playheadLoopEnd.load();
+
+    // The read-ahead window, folded back to the loop start when it crosses the loop end
+    const auto ahead = std::max<int64_t>(std::llround(readAheadSeconds * sampleRate), 2 * maxBlockSize);
+    std::pair<int64_t, int64_t> windows[2] = { { position, position + ahead }, { 0, 0 } };
+    int numWindows = 1;
+
+    if (loopActive && position < loopEnd && position + ahead > loopEnd)
+    {
+        windows[0].second = loopEnd;
+        windows[1] = { loopStart, loopStart + std::min(ahead - (loopEnd - position), loopEnd - loopStart) };
+        numWindows = 2;
+    }
+
+    activeStreams.clear();
+
+    for (TrackId id = 0; id < maxTracks; ++id)
+    {
+        const auto* list = lists[static_cast<size_t>(id)].load();
+        if (list == nullptr)
+            continue;
+
+        for (int w = 0; w < numWindows; ++w)
+        {
+            const auto [windowStart, windowEnd] = windows[w];
+
+            for (size_t i = list->firstCandidate(windowStart);
+                 i < list->clips.size() && list->clips[i].start < windowEnd; ++i)
+            {
+                const auto& clip = list->clips[i];
+                auto& slots = list->streams[i];
+                if (clip.source == nullptr || clip.end <= windowStart)
+                    continue;
+
+                // First source frame the window plays, with the interpolator's history
+                const int64_t from = std::max(windowStart, clip.start);
+                const double sourcePosition = clip.sourceOffset + static_cast<double>(from - clip.start) * clip.ratio;
+                const int64_t need = std::max<int64_t>(0, floorFrame(sourcePosition) - 1);
+
+                // Keep a ring that already holds the frame or will reach it soon
+                const auto blockFrames = static_cast<int64_t>(maxBlockSize * clip.ratio) + 4;
+                Stream* found = nullptr;
+                for (auto& slot : slots)
+                {
+                    auto* stream = slot.load();
+                    if (stream != nullptr && !stream->matched && need + blockFrames >= stream->consumedSnapshot
+                        && need <= stream->writtenEnd.load() + ringFrames / 4)
+                    {
+                        found = stream;
+                        break;
+                    }
+                }
+
+                if (found == nullptr)
+                {
+                    // Replace a ring nothing needs, after any this pass kept
+                    std::atomic<Stream*>* slot = nullptr;
+                    for (auto& candidate : slots)
+                    {
+                        auto* stream = candidate.load();
+                        if (stream == nullptr || !stream->matched)
+                        {
+                            slot = &candidate;
+                            break;
+                        }
+                    }
+
+                    if (slot == nullptr)
+                        continue;
+
+                    if (auto* replaced = slot->load())
+                        retireStream(*replaced);
+
+                    found = acquireStream();
+                    if (found == nullptr)
+                        continue;
+
+                    found->inUse = true;
+                    found->source = clip.source;
+                    found->numChannels = clip.numChannels;
+                    found->endFrame = std::min(clip.sourceLength, static_cast<int64_t>(std::ceil(clip.sourceEnd)) + 2);
+                    found->ratio = clip.ratio;
+                    found->mapping = clip.sourceOffset - static_cast<double>(clip.start) * clip.ratio;
+                    found->ownerTrack = id;
+                    found->ownerRevision = list->revision;
+                    found->ownerSlot = slot;
+                    found->consumed.store(need);
+                    found->consumedSnapshot = need;
+                    found->writtenEnd.store(need);
+                    slot->store(found);
+                }
+
+                found->matched = true;
+                activeStreams.push_back(found);
+            }
+        }
+    }
+
+    // Rings the playhead has left are released
+    for (auto& stream : streamPool)
+    {
+        if (stream->inUse && !stream->matched)
+            retireStream(*stream);
+    }
+
+    // Emptiest ring first: every ring gets a quarter before any is topped up
+    std::sort(activeStreams.begin(), activeStreams.end(), [](const Stream* a, const Stream* b)
+    {
+        return (a->writtenEnd.load() - a->consumed.load()) / a->ratio
+             < (b->writtenEnd.load() - b->consumed.load()) / b->ratio;
+    });
+
+    for (const int64_t target : { ringFrames / 4, ringFrames })
+    {
+        for (auto* stream : activeStreams)
+            fillStream(*stream, target);
+    }
+}
+
+ClipPlaybackEngine::Stream* ClipPlaybackEngine::acquireStream()
+{
+    const uint64_t pinned = pinnedEpoch.load();
+
+    for (auto& stream : streamPool)
+    {
+        if (stream->inUse)
+            continue;
+
+        if (stream->retiredEpoch == 0 || pinned == 0 || pinned >= stream->retiredEpoch)
+        {
+            stream->retiredEpoch = 0;
+            return stream.get();
+        }
+    }
+
+    return nullptr;
+}
+
+void ClipPlaybackEngine::retireStream(Stream& stream)
+{
+    // The owning clip's slot only exists while its list is still the published one
+    const auto* list = stream.ownerTrack != invalidId ? lists[static_cast<size_t>(stream.ownerTrack)].load() : nullptr;
+    if (list != nullptr && list->revision == stream.ownerRevision && stream.ownerSlot != nullptr)
+    {
+        auto* expected = &stream;
+        stream.ownerSlot->compare_exchange_strong(expected, nullptr);
+    }
+
+    stream.inUse = false;
+    stream.matched = false;
+    stream.source.reset();
+    stream.ownerTrack = invalidId;
+    stream.ownerSlot = nullptr;
+    stream.retiredEpoch = globalEpoch.fetch_add(1) + 1;
+}
+
+void ClipPlaybackEngine::fillStream(Stream& stream, int64_t aheadFrames)
+{
+    auto* reader = stream.source->reader.get();
+    const int64_t consumed = stream.consumed.load(std::memory_order_acquire);
+    const int64_t limit = std::min({ consumed + aheadFrames, consumed + ringFrames, stream.endFrame });
+    int64_t written = stream.writtenEnd.load();
+
+    while (written < limit)
+    {
+        // Up to the ring's wrap point, one read at a time
+        const int64_t ringIndex = written & (ringFrames - 1);
+        const int chunk = static_cast<int>(std::min({ limit - written, ringFrames - ringIndex,
+                                                      static_cast<int64_t>(readBuffer.getNumSamples()) }));
+
+        reader->read(&readBuffer, 0, chunk, written, true, stream.numChannels > 1);
+
+        for (int channel = 0; channel < stream.numChannels; ++channel)
+            std::copy_n(readBuffer.getReadPointer(channel), chunk,
+                        stream.ring.data() + channel * ringFrames + ringIndex);
+
+        written += chunk;
+        stream.writtenEnd.store(written, std::memory_order_release);
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include "../automation/AutomationEngine.h"
+#include "../../include/timeline/AudioClip.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+/**
+    Audio clip playback for the timeline, with disk streaming
+
+    - Each track holds an immutable clip list sorted by start, with a running
+      maximum of clip ends beside it. The clips a block touches are found
+      with one binary search on that maximum, then a scan while clips still
+      start inside the block: O(log n) plus the clips that actually play.
+    - Lists are swapped by pointer and retired with the same epoch scheme as
+      AutomationEngine, so an edit never blocks playback.
+    - In-memory clips are read directly. File clips are streamed: a
+      background thread keeps a ring of source frames ahead of every clip
+      within the read-ahead window of the playhead (and of the loop start
+      when the window wraps), serving the emptiest ring first. Long
+      multitrack recordings never have to fit in memory.
+    - Boundaries and fades are whole samples on the transport timeline.
+      Clips that overlap on a track crossfade with equal power over the
+      overlap unless they already fade for longer.
+    - Sources at another sample rate are resampled on the fly with 4-point
+      cubic interpolation. Output depends only on the absolute transport
+      position, never on how the timeline is cut into blocks.
+
+    A ring that is not ready (after a seek, or when the disk falls behind)
+    plays silence and counts an underrun; with setNonRealtime(true) the
+    audio thread fills it synchronously instead, so bounces are exact.
+
+    Threading: prepare() and track edits are message-thread calls. prepare()
+    runs while the audio thread is stopped. beginBlock(), render*() and
+    endBlock() are the audio thread's, lock-free and allocation-free.
+*/
+class ClipPlaybackEngine
+{
+public:
+    using Clip = SchillingerEcosystem::Timeline::AudioClip;
+    using TrackId = int;
+
+    static constexpr int maxTracks = 256;
+    static constexpr int maxStreamChannels = 2;
+    static constexpr TrackId invalidId = -1;
+
+    ClipPlaybackEngine();
+    ~ClipPlaybackEngine();
+
+    //==============================================================================
+    // Message thread
+
+    /**
+        Size the stream pool and rebuild every track for the sample rate,
+        then start the streaming thread; call while the audio thread is stopped
+    */
+    void prepare(double sampleRate, int maxBlockSize);
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    /**
+        Streams (file clips that can play or pre-roll at once) and seconds of
+        source read ahead; take effect at the next prepare()
+    */
+    void setStreamingOptions(int numStreams, double readAheadSeconds);
+
+    /** Fill rings on the audio thread instead of the streaming thread (offline rendering) */
+    void setNonRealtime(bool shouldBeNonRealtime) noexcept { nonRealtime.store(shouldBeNonRealtime); }
+
+    TrackId addTrack();
+    void removeTrack(TrackId track);
+
+    /**
+        Replace a track's clips. File clips whose file cannot be opened are
+        skipped.
+        @return false if the track is unknown or a file failed to open
+    */
+    bool setClips(TrackId track, std::vector<Clip> clips);
+    void clearTrack(TrackId track);
+    int getNumClips(TrackId track) const;
+
+    /**
+        Free retired clip lists no block in flight can see
+        @return Number of lists still waiting
+    */
+    size_t collectRetired();
+
+    /** Blocks in which a streamed clip had no data ready */
+    uint32_t getNumUnderruns() const noexcept { return underruns.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    // Audio thread
+
+    /** Pin the clip lists, set the transport range and publish the playhead to the streamer */
+    void beginBlock(const AutomationTransport& transport) noexcept;
+    void endBlock() noexcept;
+
+    /**
+        Add a track's clips for the current block into outputs. Mono sources
+        feed every output; otherwise output channel c plays source channel c
+        (the last one for outputs beyond the source's channels).
+        @return false (outputs untouched) if nothing on the track plays
+    */
+    bool renderTrack(TrackId track, float* const* outputs, int numChannels) noexcept;
+
+    /** renderTrack() for every track, summed */
+    bool renderAllTracks(float* const* outputs, int numChannels) noexcept;
+
+private:
+    struct Source;
+    struct Stream;
+
+    /** A clip resolved to whole samples at the engine rate */
+    struct PlaybackClip
+    {
+        int64_t start = 0;                      // Timeline samples, end exclusive
+        int64_t end = 0;
+        double sourceOffset = 0.0;              // Source frame played at start
+        double sourceEnd = 0.0;                 // Source frames past this play silence
+        double ratio = 1.0;                     // Source frames per timeline sample
+        bool integral = true;                   // ratio 1 and whole offset: copy, no interpolation
+        float gain = 1.0f;
+
+        int64_t fadeInSamples = 0;
+        int64_t fadeOutSamples = 0;
+        Clip::FadeCurve fadeInCurve = Clip::FadeCurve::EqualPower;
+        Clip::FadeCurve fadeOutCurve = Clip::FadeCurve::EqualPower;
+
+        int numChannels = 0;
+        int64_t sourceLength = 0;               // Frames
+        std::shared_ptr<juce::AudioBuffer<float>> buffer;   // In-memory source
+        std::shared_ptr<Source> source;                     // Streamed source
+    };
+
+    /** Rings of a streamed clip: one for the playhead and one for the loop start */
+    using StreamSlots = std::array<std::atomic<Stream*>, 2>;
+
+    struct ClipList
+    {
+        std::vector<PlaybackClip> clips;        // Sorted by start
+        std::vector<int64_t> endPrefixMax;      // endPrefixMax[i] = max end of clips[0..i]
+        mutable std::vector<StreamSlots> streams;   // Per clip, set by the streamer
+        uint64_t revision = 0;
+
+        /** First clip that can still be playing at or after sample */
+        size_t firstCandidate(int64_t sample) const noexcept;
+    };
+
+    struct Retired
+    {
+        uint64_t epoch = 0;
+        std::unique_ptr<const ClipList> list;
+    };
+
+    struct Track
+    {
+        bool active = false;
+        std::vector<Clip> clips;                        // As given, to rebuild at another rate
+        std::unique_ptr<const ClipList> live;           // Owner of the published list
+    };
+
+    std::unique_ptr<ClipList> buildList(const std::vector<Clip>& clips, bool& allOpened);
+    void publishLocked(TrackId track, std::unique_ptr<ClipList> list);
+    size_t collectRetiredLocked();
+
+    /** Calls run(blockOffset, count, startSample) for each contiguous stretch of the block */
+    template <typename RunFunction>
+    void forEachRun(RunFunction&& run) const noexcept;
+
+    bool renderClip(const PlaybackClip& clip, const StreamSlots& streams, int64_t startSample, int count,
+                    float* const* outputs, int outputOffset, int numChannels) noexcept;
+    void applyFades(const PlaybackClip& clip, int64_t startSample, int count, float* gains) const noexcept;
+
+    // Streaming (streamMutex held)
+    void startStreamer();
+    void stopStreamer();
+    void streamerLoop();
+    void serviceStreams();
+    Stream* acquireStream();
+    void retireStream(Stream& stream);
+    void fillStream(Stream& stream, int64_t maxFrames);
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 512;
+    int numStreams = 32;
+    double readAheadSeconds = 1.0;
+
+    // Writer side (guarded by writerMutex)
+    mutable std::mutex writerMutex;
+    std::array<Track, maxTracks> tracks;
+    std::vector<Retired> retired;
+    std::map<juce::String, std::weak_ptr<Source>> openSources;
+    juce::AudioFormatManager formatManager;
+    uint64_t nextRevision = 1;
+
+    // Published to the audio and streaming threads
+    std::array<std::atomic<const ClipList*>, maxTracks> lists;
+    std::atomic<uint64_t> globalEpoch { 1 };
+    std::atomic<uint64_t> pinnedEpoch { 0 };        // Audio thread
+    std::atomic<uint64_t> streamerEpoch { 0 };      // Streaming thread
+    std::atomic<int64_t> playhead { 0 };
+    std::atomic<bool> playheadLooping { false };
+    std::atomic<int64_t> playheadLoopStart { 0 };
+    std::atomic<int64_t> playheadLoopEnd { 0 };
+    std::atomic<bool> nonRealtime { false };
+    std::atomic<uint32_t> underruns { 0 };
+
+    // Stream pool (guarded by streamMutex; rings are read by the audio thread)
+    std::mutex streamMutex;
+    std::vector<std::unique_ptr<Stream>> streamPool;
+    juce::AudioBuffer<float> readBuffer;
+    std::vector<Stream*> activeStreams;
+    int64_t ringFrames = 0;
+
+    std::thread streamer;
+    std::atomic<bool> streamerRunning { false };
+
+    // Audio-thread state
+    AutomationTransport transport;
+    std::vector<float> gainBuffer;
+    bool blockUnderrun = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipPlaybackEngine)
+};
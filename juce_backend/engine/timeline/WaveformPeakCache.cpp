@@ -0,0 +1,635 @@
+#include "WaveformPeakCache.h"
+
+#include <juce_cryptography/juce_cryptography.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr int peaksMagic = 0x4b504657;          // "WFPK"
+    constexpr int peakFileMagic = 0x46504657;       // "WFPF"
+    constexpr int peakFileVersion = 1;
+    constexpr int buildChunkFrames = 65536;
+    constexpr int hashBlocks = 16;
+    constexpr int hashBlockBytes = 65536;
+    constexpr int64_t unknownLengthSamples = static_cast<int64_t>(48000) * 60 * 60 * 24;
+
+    int16_t quantise(float value) noexcept
+    {
+        return static_cast<int16_t>(std::lround(juce::jlimit(-1.0f, 1.0f, value) * 32767.0f));
+    }
+
+    float unquantise(int16_t value) noexcept
+    {
+        return static_cast<float>(value) / 32767.0f;
+    }
+}
+
+//==============================================================================
+void WaveformPeaks::Accumulator::add(float low, float high, double squares, int64_t count) noexcept
+{
+    if (count <= 0)
+        return;
+
+    min = samples == 0 ? low : std::min(min, low);
+    max = samples == 0 ? high : std::max(max, high);
+    sumSquares += squares;
+    samples += count;
+}
+
+//==============================================================================
+WaveformPeaks::WaveformPeaks(int channels, double rate, int64_t expectedSamples)
+    : numChannels(std::max(1, channels)),
+      sampleRate(rate)
+{
+    const int64_t reserved = expectedSamples > 0 ? expectedSamples : unknownLengthSamples;
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        auto& level = levels[static_cast<size_t>(i)];
+        level.shift = levelShifts[i];
+        level.maxChunks = ((reserved >> level.shift) + 1) / chunkBuckets + 1;
+        level.chunks = std::make_unique<std::atomic<int16_t*>[]>(static_cast<size_t>(level.maxChunks));
+        level.pending.resize(static_cast<size_t>(numChannels));
+
+        for (int64_t c = 0; c < level.maxChunks; ++c)
+            level.chunks[static_cast<size_t>(c)].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+WaveformPeaks::~WaveformPeaks()
+{
+    for (auto& level : levels)
+        for (int64_t c = 0; c < level.maxChunks; ++c)
+            delete[] level.chunks[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+}
+
+std::unique_ptr<WaveformPeaks> WaveformPeaks::fromBuffer(const juce::AudioBuffer<float>& buffer, double rate)
+{
+    auto peaks = std::make_unique<WaveformPeaks>(buffer.getNumChannels(), rate, buffer.getNumSamples());
+
+    std::vector<const float*> channels;
+    for (int c = 0; c < buffer.getNumChannels(); ++c)
+        channels.push_back(buffer.getReadPointer(c));
+
+    if (! channels.empty())
+        peaks->append(channels.data(), buffer.getNumSamples());
+
+    peaks->finish();
+    return peaks;
+}
+
+//==============================================================================
+int16_t* WaveformPeaks::bucketData(const Level& level, int64_t bucket) const noexcept
+{
+    auto* chunk = level.chunks[static_cast<size_t>(bucket / chunkBuckets)].load(std::memory_order_acquire);
+    return chunk + (bucket % chunkBuckets) * numChannels * 3;
+}
+
+bool WaveformPeaks::storeBucket(Level& level)
+{
+    const int64_t bucket = level.numBuckets.load(std::memory_order_relaxed);
+    const int64_t chunkIndex = bucket / chunkBuckets;
+
+    if (chunkIndex >= level.maxChunks)
+    {
+        if (! overflowed)
+            juce::Logger::writeToLog("WaveformPeaks: source longer than reserved, later audio is not summarised");
+
+        overflowed = true;
+        return false;
+    }
+
+    auto& slot = level.chunks[static_cast<size_t>(chunkIndex)];
+    if (slot.load(std::memory_order_relaxed) == nullptr)
+        slot.store(new int16_t[static_cast<size_t>(chunkBuckets * numChannels * 3)](), std::memory_order_release);
+
+    auto* data = bucketData(level, bucket);
+    for (int c = 0; c < numChannels; ++c)
+    {
+        const auto& pending = level.pending[static_cast<size_t>(c)];
+        const double rms = pending.samples > 0 ? std::sqrt(pending.sumSquares / static_cast<double>(pending.samples)) : 0.0;
+
+        data[c * 3] = quantise(pending.min);
+        data[c * 3 + 1] = quantise(pending.max);
+        data[c * 3 + 2] = quantise(static_cast<float>(rms));
+    }
+
+    level.numBuckets.store(bucket + 1, std::memory_order_release);
+    return true;
+}
+
+void WaveformPeaks::append(const float* const* channels, int count)
+{
+    if (overflowed || complete.load(std::memory_order_relaxed))
+        return;
+
+    int64_t position = numSamples.load(std::memory_order_relaxed);
+    auto& finest = levels[0];
+    const int64_t bucketSize = int64_t { 1 } << finest.shift;
+
+    for (int offset = 0; offset < count && ! overflowed;)
+    {
+        // Run up to the end of the open finest bucket
+        const int run = static_cast<int>(std::min<int64_t>(count - offset, bucketSize - (position & (bucketSize - 1))));
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            const float* samples = channels[c] + offset;
+            float low = samples[0], high = samples[0];
+            double squares = 0.0;
+
+            for (int i = 0; i < run; ++i)
+            {
+                low = std::min(low, samples[i]);
+                high = std::max(high, samples[i]);
+                squares += static_cast<double>(samples[i]) * samples[i];
+            }
+
+            finest.pending[static_cast<size_t>(c)].add(low, high, squares, run);
+        }
+
+        offset += run;
+        position += run;
+
+        // Close every bucket that ends here, each feeding the next level up
+        for (int i = 0; i < numLevels; ++i)
+        {
+            auto& level = levels[static_cast<size_t>(i)];
+            if ((position & ((int64_t { 1 } << level.shift) - 1)) != 0)
+                break;
+
+            if (! storeBucket(level))
+                break;
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                auto& pending = level.pending[static_cast<size_t>(c)];
+                if (i + 1 < numLevels)
+                    levels[static_cast<size_t>(i + 1)].pending[static_cast<size_t>(c)]
+                        .add(pending.min, pending.max, pending.sumSquares, pending.samples);
+                pending = {};
+            }
+        }
+    }
+
+    numSamples.store(position, std::memory_order_release);
+}
+
+void WaveformPeaks::finish()
+{
+    if (complete.load(std::memory_order_relaxed))
+        return;
+
+    for (int i = 0; i < numLevels && ! overflowed; ++i)
+    {
+        auto& level = levels[static_cast<size_t>(i)];
+        if (level.pending[0].samples == 0 || ! storeBucket(level))
+            continue;
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            auto& pending = level.pending[static_cast<size_t>(c)];
+            if (i + 1 < numLevels)
+                levels[static_cast<size_t>(i + 1)].pending[static_cast<size_t>(c)]
+                    .add(pending.min, pending.max, pending.sumSquares, pending.samples);
+            pending = {};
+        }
+    }
+
+    complete.store(true, std::memory_order_release);
+}
+
+//==============================================================================
+void WaveformPeaks::accumulate(int levelIndex, int channel, int64_t from, int64_t to, int64_t total,
+                               Accumulator& result) const noexcept
+{
+    const auto& level = levels[static_cast<size_t>(levelIndex)];
+    const int64_t bucketSize = int64_t { 1 } << level.shift;
+    const int64_t available = level.numBuckets.load(std::memory_order_acquire);
+
+    const int64_t firstBucket = from >> level.shift;
+    const int64_t endBucket = std::min((to + bucketSize - 1) >> level.shift, available);
+
+    for (int64_t bucket = firstBucket; bucket < endBucket; ++bucket)
+    {
+        const auto* data = bucketData(level, bucket) + channel * 3;
+        const int64_t samples = std::min(bucketSize, total - (bucket << level.shift));
+        const double rms = unquantise(data[2]);
+
+        result.add(unquantise(data[0]), unquantise(data[1]), rms * rms * static_cast<double>(samples), samples);
+    }
+
+    // The tail this level has not closed yet comes from the finer levels
+    const int64_t covered = endBucket << level.shift;
+    if (levelIndex > 0 && covered < to)
+        accumulate(levelIndex - 1, channel, std::max(from, covered), to, total, result);
+}
+
+int WaveformPeaks::getPeaks(int channel, int64_t startSample, double samplesPerPixel,
+                            WaveformPeak* pixels, int numPixels) const noexcept
+{
+    if (pixels == nullptr || numPixels <= 0)
+        return 0;
+
+    std::fill(pixels, pixels + numPixels, WaveformPeak {});
+
+    if (channel < 0 || channel >= numChannels || samplesPerPixel <= 0.0)
+        return 0;
+
+    // Coarsest level giving each pixel at least one bucket
+    int levelIndex = 0;
+    while (levelIndex + 1 < numLevels && static_cast<double>(int64_t { 1 } << levels[static_cast<size_t>(levelIndex + 1)].shift) <= samplesPerPixel)
+        ++levelIndex;
+
+    // Only a complete summary has a short last bucket
+    const bool finished = isComplete();
+    const int64_t total = finished ? getNumSamples() : std::numeric_limits<int64_t>::max();
+    const int64_t covered = finished ? total
+                                     : levels[0].numBuckets.load(std::memory_order_acquire) << levels[0].shift;
+    int pixelsWithData = 0;
+
+    for (int p = 0; p < numPixels; ++p)
+    {
+        const int64_t from = std::max<int64_t>(0, startSample + static_cast<int64_t>(std::floor(p * samplesPerPixel)));
+        const int64_t to = std::min(covered, startSample + static_cast<int64_t>(std::floor((p + 1) * samplesPerPixel)));
+
+        if (from >= covered)
+            break;
+
+        // Narrower than a bucket: the bucket holding it
+        Accumulator result;
+        accumulate(levelIndex, channel, from, std::max(to, from + 1), total, result);
+
+        if (result.samples > 0)
+        {
+            pixels[p].min = result.min;
+            pixels[p].max = result.max;
+            pixels[p].rms = static_cast<float>(std::sqrt(result.sumSquares / static_cast<double>(result.samples)));
+        }
+
+        pixelsWithData = p + 1;
+    }
+
+    return pixelsWithData;
+}
+
+//==============================================================================
+bool WaveformPeaks::writeTo(juce::OutputStream& output) const
+{
+    if (! isComplete())
+        return false;
+
+    output.writeInt(peaksMagic);
+    output.writeInt(numChannels);
+    output.writeDouble(sampleRate);
+    output.writeInt64(getNumSamples());
+
+    for (const auto& level : levels)
+    {
+        const int64_t buckets = level.numBuckets.load(std::memory_order_acquire);
+        output.writeInt64(buckets);
+
+        for (int64_t first = 0; first < buckets; first += chunkBuckets)
+        {
+            const int64_t count = std::min<int64_t>(chunkBuckets, buckets - first);
+            if (! output.write(bucketData(level, first), static_cast<size_t>(count * numChannels * 3) * sizeof(int16_t)))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool WaveformPeaks::readFrom(juce::InputStream& input)
+{
+    if (getNumSamples() != 0 || isComplete())
+        return false;
+
+    if (input.readInt() != peaksMagic || input.readInt() != numChannels || input.readDouble() != sampleRate)
+        return false;
+
+    const int64_t total = input.readInt64();
+    if (total < 0)
+        return false;
+
+    for (auto& level : levels)
+    {
+        const int64_t buckets = input.readInt64();
+        const int64_t expected = (total + (int64_t { 1 } << level.shift) - 1) >> level.shift;
+
+        if (buckets != expected || (buckets + chunkBuckets - 1) / chunkBuckets > level.maxChunks)
+            return false;
+
+        for (int64_t first = 0; first < buckets; first += chunkBuckets)
+        {
+            const int64_t count = std::min<int64_t>(chunkBuckets, buckets - first);
+            auto* chunk = new int16_t[static_cast<size_t>(chunkBuckets * numChannels * 3)]();
+            level.chunks[static_cast<size_t>(first / chunkBuckets)].store(chunk, std::memory_order_release);
+
+            const auto bytes = static_cast<int>(static_cast<size_t>(count * numChannels * 3) * sizeof(int16_t));
+            if (input.read(chunk, bytes) != bytes)
+                return false;
+        }
+    }
+
+    // Publish only once every level is in
+    numSamples.store(total, std::memory_order_release);
+    for (auto& level : levels)
+        level.numBuckets.store((total + (int64_t { 1 } << level.shift) - 1) >> level.shift, std::memory_order_release);
+
+    complete.store(true, std::memory_order_release);
+    return true;
+}
+
+//==============================================================================
+WaveformPeakCache::WaveformPeakCache()
+    : fallbackDirectory(getDefaultFallbackDirectory())
+{
+    formatManager.registerBasicFormats();
+}
+
+WaveformPeakCache::~WaveformPeakCache()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+
+    wake.notify_all();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+juce::File WaveformPeakCache::getDefaultFallbackDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("SchillingerEcosystem")
+        .getChildFile("WaveformPeaks");
+}
+
+void WaveformPeakCache::setFallbackDirectory(const juce::File& directory)
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    fallbackDirectory = directory;
+}
+
+juce::File WaveformPeakCache::getPeakFile(const juce::File& audioFile) const
+{
+    juce::File fallback;
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        fallback = fallbackDirectory;
+    }
+
+    const auto directory = audioFile.getParentDirectory();
+    if (directory.hasWriteAccess())
+        return audioFile.getSiblingFile(audioFile.getFileName() + ".peaks");
+
+    // Keyed by the full path so equal names in different directories do not collide
+    return fallback.getChildFile(juce::String::toHexString(audioFile.getFullPathName().hashCode64())
+                                          + "_" + audioFile.getFileName() + ".peaks");
+}
+
+juce::String WaveformPeakCache::hashContents(const juce::File& audioFile)
+{
+    juce::FileInputStream input(audioFile);
+    if (! input.openedOk())
+        return {};
+
+    const int64_t size = input.getTotalLength();
+    juce::MemoryOutputStream sampled;
+    sampled.writeInt64(size);
+
+    if (size <= static_cast<int64_t>(hashBlocks) * hashBlockBytes)
+    {
+        sampled.writeFromInputStream(input, size);
+    }
+    else
+    {
+        for (int i = 0; i < hashBlocks; ++i)
+        {
+            input.setPosition((size - hashBlockBytes) * i / (hashBlocks - 1));
+            sampled.writeFromInputStream(input, hashBlockBytes);
+        }
+    }
+
+    return juce::SHA256(sampled.getData(), sampled.getDataSize()).toHexString();
+}
+
+//==============================================================================
+std::shared_ptr<const WaveformPeaks> WaveformPeakCache::getPeaks(const juce::File& audioFile)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    const auto key = audioFile.getFullPathName();
+    if (auto existing = entries[key].lock())
+        return existing;
+
+    // Shape comes from the header; the audio is read on the worker
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
+    if (reader == nullptr)
+    {
+        entries.erase(key);
+        return nullptr;
+    }
+
+    auto peaks = std::make_shared<WaveformPeaks>(static_cast<int>(reader->numChannels), reader->sampleRate,
+                                                 std::max<int64_t>(1, reader->lengthInSamples));
+    entries[key] = peaks;
+    lock.unlock();
+
+    enqueue({ audioFile, peaks, false });
+    return peaks;
+}
+
+std::shared_ptr<WaveformPeaks> WaveformPeakCache::startRecording(const juce::File& audioFile, int numChannels,
+                                                                 double sampleRate)
+{
+    auto peaks = std::make_shared<WaveformPeaks>(numChannels, sampleRate);
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    entries[audioFile.getFullPathName()] = peaks;
+    return peaks;
+}
+
+void WaveformPeakCache::finishRecording(const juce::File& audioFile)
+{
+    std::shared_ptr<WaveformPeaks> peaks;
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        const auto entry = entries.find(audioFile.getFullPathName());
+        if (entry != entries.end())
+            peaks = entry->second.lock();
+    }
+
+    if (peaks == nullptr)
+        return;
+
+    peaks->finish();
+    enqueue({ audioFile, peaks, true });
+}
+
+void WaveformPeakCache::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return jobs.empty() && ! busy; });
+}
+
+//==============================================================================
+void WaveformPeakCache::enqueue(Job job)
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (stopping)
+            return;
+
+        jobs.push_back(std::move(job));
+
+        if (! worker.joinable())
+            worker = std::thread([this] { workerLoop(); });
+    }
+
+    wake.notify_one();
+}
+
+void WaveformPeakCache::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (! stopping)
+    {
+        if (jobs.empty())
+        {
+            busy = false;
+            idle.notify_all();
+            wake.wait(lock, [this] { return stopping || ! jobs.empty(); });
+            continue;
+        }
+
+        busy = true;
+        const Job job = std::move(jobs.front());
+        jobs.pop_front();
+
+        lock.unlock();
+        runJob(job);
+        lock.lock();
+    }
+
+    busy = false;
+    idle.notify_all();
+}
+
+void WaveformPeakCache::runJob(const Job& job)
+{
+    if (job.saveOnly)
+    {
+        savePeakFile(job.audioFile, *job.peaks);
+        return;
+    }
+
+    if (loadPeakFile(job.audioFile, *job.peaks))
+        return;
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        reader.reset(formatManager.createReaderFor(job.audioFile));
+    }
+
+    if (reader == nullptr)
+    {
+        juce::Logger::writeToLog("WaveformPeakCache: cannot read " + job.audioFile.getFullPathName());
+        return;
+    }
+
+    const int numChannels = job.peaks->getNumChannels();
+    juce::AudioBuffer<float> block(numChannels, buildChunkFrames);
+    std::vector<const float*> channels;
+    for (int c = 0; c < numChannels; ++c)
+        channels.push_back(block.getReadPointer(c));
+
+    for (int64_t position = 0; position < reader->lengthInSamples; position += buildChunkFrames)
+    {
+        // Nobody wants these peaks any more (the only owner left is the job)
+        if (stopping || job.peaks.use_count() == 1)
+            return;
+
+        const int count = static_cast<int>(std::min<int64_t>(buildChunkFrames, reader->lengthInSamples - position));
+        reader->read(&block, 0, count, position, true, true);
+        job.peaks->append(channels.data(), count);
+    }
+
+    job.peaks->finish();
+    ++filesBuilt;
+    savePeakFile(job.audioFile, *job.peaks);
+}
+
+//==============================================================================
+bool WaveformPeakCache::loadPeakFile(const juce::File& audioFile, WaveformPeaks& peaks)
+{
+    const auto peakFile = getPeakFile(audioFile);
+    juce::FileInputStream input(peakFile);
+    if (! input.openedOk())
+        return false;
+
+    if (input.readInt() != peakFileMagic || input.readInt() != peakFileVersion)
+        return false;
+
+    const int64_t size = input.readInt64();
+    const int64_t modificationTime = input.readInt64();
+    const auto hash = input.readString();
+
+    // Stamp first; the content hash only when the stamp moved
+    const bool stampMatches = size == audioFile.getSize()
+                           && modificationTime == audioFile.getLastModificationTime().toMilliseconds();
+
+    if (! stampMatches && (size != audioFile.getSize() || hash != hashContents(audioFile)))
+        return false;
+
+    if (! peaks.readFrom(input))
+        return false;
+
+    if (! stampMatches)
+        savePeakFile(audioFile, peaks);     // Same audio, new stamp
+
+    return true;
+}
+
+bool WaveformPeakCache::savePeakFile(const juce::File& audioFile, const WaveformPeaks& peaks)
+{
+    const auto peakFile = getPeakFile(audioFile);
+    peakFile.getParentDirectory().createDirectory();
+
+    juce::TemporaryFile temp(peakFile);
+    {
+        juce::FileOutputStream output(temp.getFile());
+        if (! output.openedOk())
+            return false;
+
+        output.writeInt(peakFileMagic);
+        output.writeInt(peakFileVersion);
+        output.writeInt64(audioFile.getSize());
+        output.writeInt64(audioFile.getLastModificationTime().toMilliseconds());
+        output.writeString(hashContents(audioFile));
+
+        if (! peaks.writeTo(output))
+            return false;
+
+        output.flush();
+        if (output.getStatus().failed())
+            return false;
+    }
+
+    if (! temp.overwriteTargetFileWithTemporary())
+    {
+        juce::Logger::writeToLog("WaveformPeakCache: cannot write " + peakFile.getFullPathName());
+        return false;
+    }
+
+    return true;
+}
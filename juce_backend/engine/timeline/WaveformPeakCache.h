@@ -0,0 +1,209 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+//==============================================================================
+/**
+    Waveform overview data: minimum, maximum and RMS of one channel over a
+    stretch of samples
+*/
+struct WaveformPeak
+{
+    float min = 0.0f;
+    float max = 0.0f;
+    float rms = 0.0f;
+};
+
+//==============================================================================
+/**
+    Min/max/RMS mipmap of one audio source
+
+    - Three levels summarise 256, 4096 and 65536 samples per bucket. A query
+      reads the coarsest level that still gives every pixel at least one
+      bucket, so drawing costs O(pixels) at any zoom and never touches the
+      audio. Below 256 samples per pixel draw from the audio itself.
+    - Buckets are stored as 16-bit values (full scale = 1.0, louder samples
+      clip), six bytes per bucket and channel: a one-hour stereo take at
+      48 kHz needs about 8 MB at the finest level.
+    - One writer appends audio (import, or a recording as it arrives) while
+      any number of readers query. Buckets live in chunks that never move
+      and are published with a count, so readers see complete buckets only;
+      the part a coarse level has not summarised yet is answered from the
+      finer ones.
+*/
+class WaveformPeaks
+{
+public:
+    static constexpr int numLevels = 3;
+    static constexpr int levelShifts[numLevels] = { 8, 12, 16 };   // log2 of samples per bucket
+
+    /**
+        @param expectedSamples Length to reserve chunk slots for; 0 reserves
+               about a day at 48 kHz (recordings of unknown length)
+    */
+    WaveformPeaks(int numChannels, double sampleRate, int64_t expectedSamples = 0);
+    ~WaveformPeaks();
+
+    /** Summarise an in-memory buffer (sampler samples, clips without a file) */
+    static std::unique_ptr<WaveformPeaks> fromBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate);
+
+    int getNumChannels() const noexcept { return numChannels; }
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    /** Samples summarised so far */
+    int64_t getNumSamples() const noexcept { return numSamples.load(std::memory_order_acquire); }
+
+    /** True once finish() has run: every level covers every sample */
+    bool isComplete() const noexcept { return complete.load(std::memory_order_acquire); }
+
+    //==============================================================================
+    // Writer (one thread at a time)
+
+    void append(const float* const* channels, int count);
+
+    /** Close the partial buckets at the end of the source */
+    void finish();
+
+    //==============================================================================
+    // Readers (any thread)
+
+    /**
+        Peaks for numPixels pixels of samplesPerPixel samples each, starting
+        at startSample. Pixels past the summarised audio are zero.
+        @return Number of pixels that have data
+    */
+    int getPeaks(int channel, int64_t startSample, double samplesPerPixel,
+                 WaveformPeak* pixels, int numPixels) const noexcept;
+
+    //==============================================================================
+    // Persistence
+
+    bool writeTo(juce::OutputStream& output) const;
+
+    /** Fill an empty instance of the same shape from writeTo() data */
+    bool readFrom(juce::InputStream& input);
+
+private:
+    static constexpr int chunkBuckets = 4096;
+
+    struct Accumulator
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        double sumSquares = 0.0;
+        int64_t samples = 0;
+
+        void add(float low, float high, double squares, int64_t count) noexcept;
+    };
+
+    struct Level
+    {
+        int shift = 0;
+        int64_t maxChunks = 0;
+        std::unique_ptr<std::atomic<int16_t*>[]> chunks;   // chunkBuckets x channels x (min, max, rms)
+        std::atomic<int64_t> numBuckets { 0 };              // Published buckets
+        std::vector<Accumulator> pending;                   // Writer: the open bucket, per channel
+    };
+
+    int16_t* bucketData(const Level& level, int64_t bucket) const noexcept;
+    bool storeBucket(Level& level);
+    void accumulate(int levelIndex, int channel, int64_t from, int64_t to, int64_t total,
+                    Accumulator& result) const noexcept;
+
+    const int numChannels;
+    const double sampleRate;
+    std::array<Level, numLevels> levels;
+    std::atomic<int64_t> numSamples { 0 };
+    std::atomic<bool> complete { false };
+    bool overflowed = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPeaks)
+};
+
+//==============================================================================
+/**
+    Peak files for audio on disk, built in the background
+
+    getPeaks() answers at once with an instance that fills in as the worker
+    summarises the file, or that is loaded from the peak file saved next to
+    the audio ("take.wav" -> "take.wav.peaks"; a fallback directory is used
+    when the audio's directory is read-only). A peak file is trusted while
+    the audio's size and modification time match; when they differ a
+    content hash decides, so a copied or touched file keeps its peaks. The
+    hash covers the file size and 64 KB at 16 evenly spaced offsets, so
+    checking it never reads a long file in full.
+
+    Recordings are summarised as they are written: startRecording() hands
+    the writer a WaveformPeaks to append to, and finishRecording() saves it
+    once the audio file is closed.
+*/
+class WaveformPeakCache
+{
+public:
+    WaveformPeakCache();
+    ~WaveformPeakCache();
+
+    /** Peaks of an audio file, loading or building them in the background; nullptr if unreadable */
+    std::shared_ptr<const WaveformPeaks> getPeaks(const juce::File& audioFile);
+
+    /** Summary for a recording in progress; append from the thread writing the audio */
+    std::shared_ptr<WaveformPeaks> startRecording(const juce::File& audioFile, int numChannels, double sampleRate);
+
+    /** Finish the recording's summary and save its peak file (call after the audio file is closed) */
+    void finishRecording(const juce::File& audioFile);
+
+    /** Where audioFile's peaks are saved */
+    juce::File getPeakFile(const juce::File& audioFile) const;
+
+    /** Directory for peaks of audio in read-only directories */
+    void setFallbackDirectory(const juce::File& directory);
+    static juce::File getDefaultFallbackDirectory();
+
+    /** Block until every queued build or save has finished */
+    void waitUntilIdle();
+
+    /** Files summarised from their audio, rather than loaded from a peak file */
+    int getNumFilesBuilt() const noexcept { return filesBuilt.load(); }
+
+    static juce::String hashContents(const juce::File& audioFile);
+
+private:
+    struct Job
+    {
+        juce::File audioFile;
+        std::shared_ptr<WaveformPeaks> peaks;
+        bool saveOnly = false;                      // Finished recording
+    };
+
+    void workerLoop();
+    void runJob(const Job& job);
+    bool loadPeakFile(const juce::File& audioFile, WaveformPeaks& peaks);
+    bool savePeakFile(const juce::File& audioFile, const WaveformPeaks& peaks);
+    void enqueue(Job job);
+
+    juce::AudioFormatManager formatManager;
+    juce::File fallbackDirectory;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<Job> jobs;
+    bool busy = false;
+    std::atomic<bool> stopping { false };
+    std::map<juce::String, std::weak_ptr<WaveformPeaks>> entries;   // By audio path
+    std::thread worker;
+
+    std::atomic<int> filesBuilt { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPeakCache)
+};
@@ -0,0 +1,926 @@
+/*
+  ==============================================================================
+
+    ChannelLayout.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Implementation of channel layouts, layout negotiation, VBAP / Ambisonic
+    panning and layout metering
+
+  ==============================================================================
+*/
+
+#include "dsp/ChannelLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace DSP {
+
+namespace {
+
+constexpr float pi = 3.14159265358979323846f;
+constexpr float degToRad = pi / 180.0f;
+constexpr float minusThreeDb = 0.70710678f;
+
+// Speakers at or above this elevation belong to the height ring
+constexpr float heightRingElevation = 20.0f;
+
+// Directions outside a ring's coverage ease down to -3 dB over this arc
+constexpr float foldArc = 30.0f;
+
+using Speaker = ChannelLayout::Speaker;
+
+//==============================================================================
+// Speaker tables (SMPTE / ITU order)
+//==============================================================================
+
+const Speaker monoSpeakers[] = {
+    { "C",     0.0f,   0.0f, false }
+};
+
+const Speaker stereoSpeakers[] = {
+    { "L",    30.0f,   0.0f, false },
+    { "R",   -30.0f,   0.0f, false }
+};
+
+const Speaker lcrSpeakers[] = {
+    { "L",    30.0f,   0.0f, false },
+    { "R",   -30.0f,   0.0f, false },
+    { "C",     0.0f,   0.0f, false }
+};
+
+const Speaker quadSpeakers[] = {
+    { "L",    45.0f,   0.0f, false },
+    { "R",   -45.0f,   0.0f, false },
+    { "Ls",  135.0f,   0.0f, false },
+    { "Rs", -135.0f,   0.0f, false }
+};
+
+const Speaker surround50Speakers[] = {
+    { "L",    30.0f,   0.0f, false },
+    { "R",   -30.0f,   0.0f, false },
+    { "C",     0.0f,   0.0f, false },
+    { "Ls",  110.0f,   0.0f, false },
+    { "Rs", -110.0f,   0.0f, false }
+};
+
+const Speaker surround51Speakers[] = {
+    { "L",    30.0f,   0.0f, false },
+    { "R",   -30.0f,   0.0f, false },
+    { "C",     0.0f,   0.0f, false },
+    { "LFE",   0.0f,   0.0f, true  },
+    { "Ls",  110.0f,   0.0f, false },
+    { "Rs", -110.0f,   0.0f, false },
+    // 5.1.x heights
+    { "Ltf",  45.0f,  45.0f, false },
+    { "Rtf", -45.0f,  45.0f, false },
+    { "Ltr", 135.0f,  45.0f, false },
+    { "Rtr",-135.0f,  45.0f, false }
+};
+
+const Speaker surround70Speakers[] = {
+    { "L",    30.0f,   0.0f, false },
+    { "R",   -30.0f,   0.0f, false },
+    { "C",     0.0f,   0.0f, false },
+    { "Lss",  90.0f,   0.0f, false },
+    { "Rss", -90.0f,   0.0f, false },
+    { "Lrs", 135.0f,   0.0f, false },
+    { "Rrs",-135.0f,   0.0f, false }
+};
+
+const Speaker surround71Speakers[] = {
+    { "L",    30.0f,   0.0f, false },
+    { "R",   -30.0f,   0.0f, false },
+    { "C",     0.0f,   0.0f, false },
+    { "LFE",   0.0f,   0.0f, true  },
+    { "Lss",  90.0f,   0.0f, false },
+    { "Rss", -90.0f,   0.0f, false },
+    { "Lrs", 135.0f,   0.0f, false },
+    { "Rrs",-135.0f,   0.0f, false },
+    // 7.1.4 heights
+    { "Ltf",  45.0f,  45.0f, false },
+    { "Rtf", -45.0f,  45.0f, false },
+    { "Ltr", 135.0f,  45.0f, false },
+    { "Rtr",-135.0f,  45.0f, false }
+};
+
+const Speaker surround512Speakers[] = {
+    { "L",    30.0f,   0.0f, false },
+    { "R",   -30.0f,   0.0f, false },
+    { "C",     0.0f,   0.0f, false },
+    { "LFE",   0.0f,   0.0f, true  },
+    { "Ls",  110.0f,   0.0f, false },
+    { "Rs", -110.0f,   0.0f, false },
+    { "Ltm",  90.0f,  45.0f, false },
+    { "Rtm", -90.0f,  45.0f, false }
+};
+
+const Speaker surround712Speakers[] = {
+    { "L",    30.0f,   0.0f, false },
+    { "R",   -30.0f,   0.0f, false },
+    { "C",     0.0f,   0.0f, false },
+    { "LFE",   0.0f,   0.0f, true  },
+    { "Lss",  90.0f,   0.0f, false },
+    { "Rss", -90.0f,   0.0f, false },
+    { "Lrs", 135.0f,   0.0f, false },
+    { "Rrs",-135.0f,   0.0f, false },
+    { "Ltm",  90.0f,  45.0f, false },
+    { "Rtm", -90.0f,  45.0f, false }
+};
+
+const Speaker unpositioned = { "", 0.0f, 0.0f, false };
+
+//==============================================================================
+// Fold-downs that standard downmixes route by name rather than by angle
+//==============================================================================
+
+struct Fallback
+{
+    const char* label;
+    const char* targets[3];     // First one present in the destination wins
+    float gain;
+};
+
+const Fallback fallbacks[] = {
+    // 7.1 sides and rears share the 5.1 surround, -3 dB each
+    { "Lss", { "Ls", nullptr, nullptr },    minusThreeDb },
+    { "Rss", { "Rs", nullptr, nullptr },    minusThreeDb },
+    { "Lrs", { "Ls", nullptr, nullptr },    minusThreeDb },
+    { "Rrs", { "Rs", nullptr, nullptr },    minusThreeDb },
+    // Heights: front and rear pairs share a top-middle pair, or drop to the
+    // ear-level speaker below them at -3 dB
+    { "Ltf", { "Ltm", "L", nullptr },       minusThreeDb },
+    { "Rtf", { "Rtm", "R", nullptr },       minusThreeDb },
+    { "Ltr", { "Ltm", "Lrs", "Ls" },        minusThreeDb },
+    { "Rtr", { "Rtm", "Rrs", "Rs" },        minusThreeDb }
+};
+
+//==============================================================================
+// Panning helpers
+//==============================================================================
+
+/** Angle from a to b going counterclockwise (increasing azimuth), [0, 360) */
+float arcFrom(float a, float b)
+{
+    float arc = std::fmod(b - a, 360.0f);
+    return arc < 0.0f ? arc + 360.0f : arc;
+}
+
+float foldGain(float degreesOutside)
+{
+    if (degreesOutside <= 0.0f)
+        return 1.0f;
+    if (degreesOutside >= foldArc)
+        return minusThreeDb;
+    return std::pow(10.0f, -3.0f * (degreesOutside / foldArc) / 20.0f);
+}
+
+/**
+ * 2D VBAP within one ring of speakers
+ * @param channels / azimuths Ring speakers sorted by azimuth
+ */
+void panRing(const int* channels, const float* azimuths, int count, float azimuth,
+             float scale, float* gains)
+{
+    if (count == 0)
+        return;
+
+    if (count == 1)
+    {
+        const float distance = std::min(arcFrom(azimuths[0], azimuth), arcFrom(azimuth, azimuths[0]));
+        gains[channels[0]] += scale * foldGain(distance);
+        return;
+    }
+
+    // The counterclockwise pair whose arc holds the direction
+    int first = count - 1;
+    for (int i = 0; i < count - 1; ++i)
+    {
+        if (arcFrom(azimuths[i], azimuth) <= azimuths[i + 1] - azimuths[i])
+        {
+            first = i;
+            break;
+        }
+    }
+
+    const int second = (first + 1) % count;
+    const float span = arcFrom(azimuths[first], azimuths[second]);
+    const float offset = std::min(arcFrom(azimuths[first], azimuth), span);
+
+    float gainFirst = 0.0f;
+    float gainSecond = 0.0f;
+
+    if (span > 180.5f)
+    {
+        // Uncovered arc: hold on the nearer edge, cross over in the middle
+        const float t = std::clamp((offset - (0.5f * span - foldArc)) / (2.0f * foldArc), 0.0f, 1.0f);
+        const float fold = foldGain(std::min(offset, span - offset));
+        gainFirst = fold * std::cos(0.5f * pi * t);
+        gainSecond = fold * std::sin(0.5f * pi * t);
+    }
+    else if (span > 179.5f)
+    {
+        // Opposite speakers: VBAP is singular, use an equal-power crossfade
+        const float t = offset / span;
+        gainFirst = std::cos(0.5f * pi * t);
+        gainSecond = std::sin(0.5f * pi * t);
+    }
+    else
+    {
+        const float a1 = azimuths[first] * degToRad;
+        const float a2 = azimuths[second] * degToRad;
+        const float p = azimuth * degToRad;
+        const float l1x = std::cos(a1), l1y = std::sin(a1);
+        const float l2x = std::cos(a2), l2y = std::sin(a2);
+        const float px = std::cos(p), py = std::sin(p);
+        const float det = l1x * l2y - l1y * l2x;
+
+        gainFirst = std::max(0.0f, (px * l2y - py * l2x) / det);
+        gainSecond = std::max(0.0f, (l1x * py - l1y * px) / det);
+
+        const float power = std::sqrt(gainFirst * gainFirst + gainSecond * gainSecond);
+        if (power > 0.0f)
+        {
+            gainFirst /= power;
+            gainSecond /= power;
+        }
+    }
+
+    gains[channels[first]] += scale * gainFirst;
+    gains[channels[second]] += scale * gainSecond;
+}
+
+/** Real spherical harmonics, ACN order, SN3D, up to third order */
+void sphericalHarmonics(float azimuth, float elevation, int order, float* y)
+{
+    const float az = azimuth * degToRad;
+    const float el = elevation * degToRad;
+    const float x1 = std::cos(el) * std::cos(az);
+    const float y1 = std::cos(el) * std::sin(az);
+    const float z1 = std::sin(el);
+
+    y[0] = 1.0f;
+    if (order < 1)
+        return;
+
+    y[1] = y1;
+    y[2] = z1;
+    y[3] = x1;
+    if (order < 2)
+        return;
+
+    const float root3 = std::sqrt(3.0f);
+    y[4] = root3 * x1 * y1;
+    y[5] = root3 * y1 * z1;
+    y[6] = 0.5f * (3.0f * z1 * z1 - 1.0f);
+    y[7] = root3 * x1 * z1;
+    y[8] = 0.5f * root3 * (x1 * x1 - y1 * y1);
+    if (order < 3)
+        return;
+
+    const float root58 = std::sqrt(5.0f / 8.0f);
+    const float root38 = std::sqrt(3.0f / 8.0f);
+    const float root15 = std::sqrt(15.0f);
+    y[9] = root58 * y1 * (3.0f * x1 * x1 - y1 * y1);
+    y[10] = root15 * x1 * y1 * z1;
+    y[11] = root38 * y1 * (5.0f * z1 * z1 - 1.0f);
+    y[12] = 0.5f * z1 * (5.0f * z1 * z1 - 3.0f);
+    y[13] = root38 * x1 * (5.0f * z1 * z1 - 1.0f);
+    y[14] = 0.5f * root15 * z1 * (x1 * x1 - y1 * y1);
+    y[15] = root58 * x1 * (x1 * x1 - 3.0f * y1 * y1);
+}
+
+int degreeOfAcn(int acn)
+{
+    int degree = 0;
+    while ((degree + 1) * (degree + 1) <= acn)
+        ++degree;
+    return degree;
+}
+
+/** max-rE weight of each degree for a decoder of the given order */
+void maxReWeights(int order, float* weights)
+{
+    const double x = std::cos(137.9 * 3.14159265358979323846 / 180.0 / (order + 1.51));
+    double previous = 1.0;
+    double current = x;
+    weights[0] = 1.0f;
+
+    for (int n = 1; n <= order; ++n)
+    {
+        weights[n] = static_cast<float>(current);
+        const double next = ((2.0 * n + 1.0) * x * current - n * previous) / (n + 1.0);
+        previous = current;
+        current = next;
+    }
+}
+
+/** Roughly uniform directions (Fibonacci sphere) for the AllRAD virtual array */
+constexpr int numVirtualSpeakers = 64;
+
+void virtualSpeaker(int index, float& azimuth, float& elevation)
+{
+    const float golden = pi * (3.0f - std::sqrt(5.0f));
+    const float z = 1.0f - (2.0f * index + 1.0f) / numVirtualSpeakers;
+    elevation = std::asin(z) / degToRad;
+    azimuth = std::remainder(golden * index, 2.0f * pi) / degToRad;
+}
+
+} // namespace
+
+//==============================================================================
+// Channel Layout
+//==============================================================================
+
+ChannelLayout::ChannelLayout(Type type)
+    : type_(type)
+{
+    switch (type)
+    {
+        case Type::Discrete:     numChannels_ = 1; break;
+        case Type::Mono:         speakers_ = monoSpeakers;        numChannels_ = 1;  break;
+        case Type::Stereo:       speakers_ = stereoSpeakers;      numChannels_ = 2;  break;
+        case Type::LCR:          speakers_ = lcrSpeakers;         numChannels_ = 3;  break;
+        case Type::Quad:         speakers_ = quadSpeakers;        numChannels_ = 4;  break;
+        case Type::Surround50:   speakers_ = surround50Speakers;  numChannels_ = 5;  break;
+        case Type::Surround51:   speakers_ = surround51Speakers;  numChannels_ = 6;  break;
+        case Type::Surround70:   speakers_ = surround70Speakers;  numChannels_ = 7;  break;
+        case Type::Surround71:   speakers_ = surround71Speakers;  numChannels_ = 8;  break;
+        case Type::Surround512:  speakers_ = surround512Speakers; numChannels_ = 8;  break;
+        case Type::Surround514:  speakers_ = surround51Speakers;  numChannels_ = 10; break;
+        case Type::Surround712:  speakers_ = surround712Speakers; numChannels_ = 10; break;
+        case Type::Surround714:  speakers_ = surround71Speakers;  numChannels_ = 12; break;
+        case Type::Ambisonic1:   ambisonicOrder_ = 1; numChannels_ = 4;  break;
+        case Type::Ambisonic2:   ambisonicOrder_ = 2; numChannels_ = 9;  break;
+        case Type::Ambisonic3:   ambisonicOrder_ = 3; numChannels_ = 16; break;
+    }
+}
+
+ChannelLayout ChannelLayout::discrete(int numChannels)
+{
+    ChannelLayout layout(Type::Discrete);
+    layout.numChannels_ = std::clamp(numChannels, 1, maxChannels);
+    return layout;
+}
+
+ChannelLayout ChannelLayout::fromChannelCount(int numChannels)
+{
+    switch (numChannels)
+    {
+        case 1:  return ChannelLayout(Type::Mono);
+        case 2:  return ChannelLayout(Type::Stereo);
+        case 3:  return ChannelLayout(Type::LCR);
+        case 4:  return ChannelLayout(Type::Quad);
+        case 5:  return ChannelLayout(Type::Surround50);
+        case 6:  return ChannelLayout(Type::Surround51);
+        case 7:  return ChannelLayout(Type::Surround70);
+        case 8:  return ChannelLayout(Type::Surround71);
+        case 10: return ChannelLayout(Type::Surround514);
+        case 12: return ChannelLayout(Type::Surround714);
+        case 16: return ChannelLayout(Type::Ambisonic3);
+        default: return discrete(numChannels);
+    }
+}
+
+const char* ChannelLayout::getName() const
+{
+    switch (type_)
+    {
+        case Type::Discrete:     return "Discrete";
+        case Type::Mono:         return "Mono";
+        case Type::Stereo:       return "Stereo";
+        case Type::LCR:          return "LCR";
+        case Type::Quad:         return "Quad";
+        case Type::Surround50:   return "5.0";
+        case Type::Surround51:   return "5.1";
+        case Type::Surround70:   return "7.0";
+        case Type::Surround71:   return "7.1";
+        case Type::Surround512:  return "5.1.2";
+        case Type::Surround514:  return "5.1.4";
+        case Type::Surround712:  return "7.1.2";
+        case Type::Surround714:  return "7.1.4";
+        case Type::Ambisonic1:   return "Ambisonics (1st order)";
+        case Type::Ambisonic2:   return "Ambisonics (2nd order)";
+        case Type::Ambisonic3:   return "Ambisonics (3rd order)";
+    }
+    return "";
+}
+
+const ChannelLayout::Speaker& ChannelLayout::getSpeaker(int channel) const
+{
+    if (speakers_ == nullptr || channel < 0 || channel >= numChannels_)
+        return unpositioned;
+    return speakers_[channel];
+}
+
+int ChannelLayout::findChannel(const char* label) const
+{
+    if (speakers_ == nullptr || label == nullptr)
+        return -1;
+
+    for (int channel = 0; channel < numChannels_; ++channel)
+        if (std::strcmp(speakers_[channel].label, label) == 0)
+            return channel;
+
+    return -1;
+}
+
+int ChannelLayout::getLFEChannel() const
+{
+    if (speakers_ == nullptr)
+        return -1;
+
+    for (int channel = 0; channel < numChannels_; ++channel)
+        if (speakers_[channel].isLFE)
+            return channel;
+
+    return -1;
+}
+
+bool ChannelLayout::hasHeightChannels() const
+{
+    if (speakers_ == nullptr)
+        return false;
+
+    for (int channel = 0; channel < numChannels_; ++channel)
+        if (speakers_[channel].elevation >= heightRingElevation)
+            return true;
+
+    return false;
+}
+
+void ChannelLayout::getPanGains(float azimuth, float elevation, float* gains) const
+{
+    std::fill(gains, gains + numChannels_, 0.0f);
+
+    if (isAmbisonic())
+    {
+        sphericalHarmonics(azimuth, elevation, ambisonicOrder_, gains);
+        return;
+    }
+
+    if (isDiscrete())
+    {
+        std::fill(gains, gains + numChannels_, 1.0f / std::sqrt(static_cast<float>(numChannels_)));
+        return;
+    }
+
+    // Split into the ear-level and height rings, each sorted by azimuth
+    int earChannels[maxChannels], heightChannels[maxChannels];
+    float earAzimuths[maxChannels], heightAzimuths[maxChannels];
+    int numEar = 0, numHeight = 0;
+    float heightElevation = 0.0f;
+
+    for (int channel = 0; channel < numChannels_; ++channel)
+    {
+        const Speaker& speaker = speakers_[channel];
+        if (speaker.isLFE)
+            continue;
+
+        if (speaker.elevation >= heightRingElevation)
+        {
+            heightChannels[numHeight] = channel;
+            heightAzimuths[numHeight++] = speaker.azimuth;
+            heightElevation += speaker.elevation;
+        }
+        else
+        {
+            earChannels[numEar] = channel;
+            earAzimuths[numEar++] = speaker.azimuth;
+        }
+    }
+
+    auto sortRing = [](int* channels, float* azimuths, int count)
+    {
+        for (int i = 1; i < count; ++i)
+            for (int j = i; j > 0 && azimuths[j] < azimuths[j - 1]; --j)
+            {
+                std::swap(azimuths[j], azimuths[j - 1]);
+                std::swap(channels[j], channels[j - 1]);
+            }
+    };
+
+    sortRing(earChannels, earAzimuths, numEar);
+    sortRing(heightChannels, heightAzimuths, numHeight);
+
+    float heightShare = 0.0f;
+    if (numHeight > 0)
+        heightShare = std::clamp(elevation / (heightElevation / numHeight), 0.0f, 1.0f);
+
+    panRing(earChannels, earAzimuths, numEar, azimuth, std::cos(0.5f * pi * heightShare), gains);
+    panRing(heightChannels, heightAzimuths, numHeight, azimuth, std::sin(0.5f * pi * heightShare), gains);
+}
+
+//==============================================================================
+// Mix Matrix
+//==============================================================================
+
+MixMatrix::MixMatrix()
+    : MixMatrix(identity(2))
+{
+}
+
+MixMatrix::MixMatrix(int numInputs, int numOutputs)
+    : numInputs_(std::clamp(numInputs, 1, ChannelLayout::maxChannels))
+    , numOutputs_(std::clamp(numOutputs, 1, ChannelLayout::maxChannels))
+{
+    updateRoutes();
+}
+
+MixMatrix MixMatrix::identity(int numChannels)
+{
+    MixMatrix matrix(numChannels, numChannels);
+    for (int channel = 0; channel < matrix.numInputs_; ++channel)
+        matrix.gains_[channel][channel] = 1.0f;
+    matrix.updateRoutes();
+    return matrix;
+}
+
+void MixMatrix::setGain(int input, int output, float gain)
+{
+    if (input < 0 || input >= numInputs_ || output < 0 || output >= numOutputs_)
+        return;
+
+    gains_[output][input] = gain;
+    updateRoutes();
+}
+
+void MixMatrix::updateRoutes()
+{
+    numRoutes_ = 0;
+    identity_ = numInputs_ == numOutputs_;
+
+    for (int output = 0; output < numOutputs_; ++output)
+    {
+        for (int input = 0; input < numInputs_; ++input)
+        {
+            const float gain = gains_[output][input];
+            if (gain != (input == output ? 1.0f : 0.0f))
+                identity_ = false;
+
+            if (gain != 0.0f)
+                routes_[numRoutes_++] = { static_cast<std::uint8_t>(input), static_cast<std::uint8_t>(output), gain };
+        }
+    }
+}
+
+MixMatrix MixMatrix::negotiate(const ChannelLayout& source, const ChannelLayout& destination)
+{
+    MixMatrix matrix(source.getNumChannels(), destination.getNumChannels());
+    auto& gains = matrix.gains_;
+
+    if (source == destination || source.isDiscrete() || destination.isDiscrete()
+        || (source.isAmbisonic() && destination.isAmbisonic()))
+    {
+        // Same format, no positions to go by, or nested Ambisonic orders:
+        // channel n feeds channel n
+        for (int channel = 0; channel < std::min(matrix.numInputs_, matrix.numOutputs_); ++channel)
+            gains[channel][channel] = 1.0f;
+    }
+    else if (source.isSpeakerLayout())
+    {
+        const bool flattenHeights = destination.isSpeakerLayout() && !destination.hasHeightChannels();
+        float panGains[ChannelLayout::maxChannels];
+
+        for (int input = 0; input < matrix.numInputs_; ++input)
+        {
+            const auto& speaker = source.getSpeaker(input);
+
+            if (speaker.isLFE)
+            {
+                const int lfe = destination.getLFEChannel();
+                if (lfe >= 0)
+                    gains[lfe][input] = 1.0f;
+                continue;
+            }
+
+            const int sameLabel = destination.findChannel(speaker.label);
+            if (sameLabel >= 0)
+            {
+                gains[sameLabel][input] = 1.0f;
+                continue;
+            }
+
+            bool routed = false;
+            for (const auto& fallback : fallbacks)
+            {
+                if (std::strcmp(fallback.label, speaker.label) != 0)
+                    continue;
+
+                for (const char* target : fallback.targets)
+                {
+                    const int output = destination.findChannel(target);
+                    if (output >= 0)
+                    {
+                        gains[output][input] = fallback.gain;
+                        routed = true;
+                        break;
+                    }
+                }
+                break;
+            }
+
+            if (routed)
+                continue;
+
+            destination.getPanGains(speaker.azimuth, speaker.elevation, panGains);
+            const float heightFold = flattenHeights && speaker.elevation >= heightRingElevation ? minusThreeDb : 1.0f;
+
+            for (int output = 0; output < matrix.numOutputs_; ++output)
+                gains[output][input] = panGains[output] * heightFold;
+        }
+    }
+    else
+    {
+        // AllRAD: max-rE sampling decode onto a uniform virtual array, each
+        // virtual speaker panned onto the real layout
+        const int order = source.getAmbisonicOrder();
+        float weights[4];
+        maxReWeights(order, weights);
+
+        float harmonics[ChannelLayout::maxChannels];
+        float panGains[ChannelLayout::maxChannels];
+
+        for (int k = 0; k < numVirtualSpeakers; ++k)
+        {
+            float azimuth, elevation;
+            virtualSpeaker(k, azimuth, elevation);
+            sphericalHarmonics(azimuth, elevation, order, harmonics);
+            destination.getPanGains(azimuth, elevation, panGains);
+
+            for (int output = 0; output < matrix.numOutputs_; ++output)
+            {
+                if (panGains[output] == 0.0f)
+                    continue;
+
+                for (int acn = 0; acn < matrix.numInputs_; ++acn)
+                {
+                    const int degree = degreeOfAcn(acn);
+                    gains[output][acn] += panGains[output] * (2.0f * degree + 1.0f) * weights[degree]
+                                        * harmonics[acn] / numVirtualSpeakers;
+                }
+            }
+        }
+
+        // Scale so a plane wave averages unit power across the speakers
+        double power = 0.0;
+        for (int k = 0; k < numVirtualSpeakers; ++k)
+        {
+            float azimuth, elevation;
+            virtualSpeaker(k, azimuth, elevation);
+            sphericalHarmonics(azimuth, elevation, order, harmonics);
+
+            for (int output = 0; output < matrix.numOutputs_; ++output)
+            {
+                float sum = 0.0f;
+                for (int acn = 0; acn < matrix.numInputs_; ++acn)
+                    sum += gains[output][acn] * harmonics[acn];
+                power += static_cast<double>(sum) * sum;
+            }
+        }
+
+        if (power > 0.0)
+        {
+            const auto scale = static_cast<float>(1.0 / std::sqrt(power / numVirtualSpeakers));
+            for (int output = 0; output < matrix.numOutputs_; ++output)
+                for (int acn = 0; acn < matrix.numInputs_; ++acn)
+                    gains[output][acn] *= scale;
+        }
+    }
+
+    matrix.updateRoutes();
+    return matrix;
+}
+
+void MixMatrix::process(const float* const* input, float* const* output, int numSamples,
+                        bool accumulate, float gain) const noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    int route = 0;
+
+    for (int channel = 0; channel < numOutputs_; ++channel)
+    {
+        float* out = output[channel];
+        bool written = accumulate;
+
+        for (; route < numRoutes_ && routes_[route].output == channel; ++route)
+        {
+            const float* in = input[routes_[route].input];
+            if (out == nullptr || in == nullptr)
+                continue;
+
+            const float g = routes_[route].gain * gain;
+
+            if (written)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] += g * in[i];
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = g * in[i];
+                written = true;
+            }
+        }
+
+        if (out != nullptr && !written)
+            std::fill(out, out + numSamples, 0.0f);
+    }
+}
+
+//==============================================================================
+// Spatial Panner
+//==============================================================================
+
+SpatialPanner::SpatialPanner(const ChannelLayout& layout)
+{
+    setLayout(layout);
+}
+
+void SpatialPanner::setLayout(const ChannelLayout& layout)
+{
+    layout_ = layout;
+    std::fill(std::begin(targetGains_), std::end(targetGains_), 0.0f);
+    layout_.getPanGains(azimuth_, elevation_, targetGains_);
+    reset();
+}
+
+void SpatialPanner::setDirection(float azimuth, float elevation)
+{
+    if (azimuth == azimuth_ && elevation == elevation_)
+        return;
+
+    azimuth_ = azimuth;
+    elevation_ = std::clamp(elevation, -90.0f, 90.0f);
+    layout_.getPanGains(azimuth_, elevation_, targetGains_);
+}
+
+void SpatialPanner::reset()
+{
+    std::copy(std::begin(targetGains_), std::end(targetGains_), std::begin(currentGains_));
+}
+
+void SpatialPanner::process(const float* input, float* const* output, int numSamples,
+                            bool accumulate) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const int numChannels = layout_.getNumChannels();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* out = output[channel];
+        if (out == nullptr)
+            continue;
+
+        const float start = currentGains_[channel];
+        const float step = (targetGains_[channel] - start) / static_cast<float>(numSamples);
+
+        // Sample i gets start + (i + 1) * step, ending exactly on the target
+        if (step == 0.0f)
+        {
+            if (accumulate)
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] += start * input[i];
+            else
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = start * input[i];
+        }
+        else
+        {
+            if (accumulate)
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] += (start + static_cast<float>(i + 1) * step) * input[i];
+            else
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = (start + static_cast<float>(i + 1) * step) * input[i];
+        }
+    }
+
+    reset();
+}
+
+//==============================================================================
+// Layout Meter
+//==============================================================================
+
+LayoutMeter::LayoutMeter(const ChannelLayout& layout)
+{
+    setLayout(layout);
+}
+
+void LayoutMeter::setLayout(const ChannelLayout& layout)
+{
+    layout_ = layout;
+    std::fill(std::begin(weights_), std::end(weights_), 0.0f);
+
+    for (int channel = 0; channel < layout.getNumChannels(); ++channel)
+        weights_[channel] = getChannelWeight(layout, channel);
+
+    reset();
+}
+
+float LayoutMeter::getChannelWeight(const ChannelLayout& layout, int channel)
+{
+    if (channel < 0 || channel >= layout.getNumChannels())
+        return 0.0f;
+
+    if (layout.isAmbisonic())
+        return channel == 0 ? 1.0f : 0.0f;
+
+    const auto& speaker = layout.getSpeaker(channel);
+    const float side = std::abs(speaker.azimuth);
+
+    if (speaker.isLFE)
+        return 0.0f;
+    if (speaker.elevation < 30.0f && side >= 60.0f && side <= 120.0f)
+        return 1.41f;
+    return 1.0f;
+}
+
+void LayoutMeter::reset()
+{
+    std::fill(std::begin(peak_), std::end(peak_), 0.0f);
+    std::fill(std::begin(rms_), std::end(rms_), 0.0f);
+    programLevel_ = 0.0f;
+    clippingMask_ = 0;
+}
+
+float LayoutMeter::getPeak(int channel) const
+{
+    return channel >= 0 && channel < ChannelLayout::maxChannels ? peak_[channel] : 0.0f;
+}
+
+float LayoutMeter::getRMS(int channel) const
+{
+    return channel >= 0 && channel < ChannelLayout::maxChannels ? rms_[channel] : 0.0f;
+}
+
+void LayoutMeter::process(const float* const* channels, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    float program = 0.0f;
+    std::uint32_t clipping = 0;
+
+    for (int channel = 0; channel < layout_.getNumChannels(); ++channel)
+    {
+        float peak = 0.0f;
+        float sumOfSquares = 0.0f;
+        if (channels[channel] != nullptr)
+            measure(channels[channel], numSamples, peak, sumOfSquares);
+
+        const float meanSquare = sumOfSquares / static_cast<float>(numSamples);
+        peak_[channel] = peak;
+        rms_[channel] = std::sqrt(meanSquare);
+        program += weights_[channel] * meanSquare;
+
+        if (peak > 1.0f)
+            clipping |= 1u << channel;
+    }
+
+    programLevel_ = std::sqrt(program);
+    clippingMask_ = clipping;
+}
+
+void LayoutMeter::measure(const float* data, int numSamples, float& peak, float& sumOfSquares) noexcept
+{
+    constexpr int lanes = 4;
+
+    // Independent lane accumulators keep the loop free of serial dependencies
+    float lanePeak[lanes] = {};
+    float laneSum[lanes] = {};
+    const int vectorSamples = numSamples - (numSamples % lanes);
+
+    for (int i = 0; i < vectorSamples; i += lanes)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const float value = data[i + lane];
+            lanePeak[lane] = std::max(lanePeak[lane], std::abs(value));
+            laneSum[lane] += value * value;
+        }
+    }
+
+    for (int i = vectorSamples; i < numSamples; ++i)
+    {
+        lanePeak[0] = std::max(lanePeak[0], std::abs(data[i]));
+        laneSum[0] += data[i] * data[i];
+    }
+
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        peak = std::max(peak, lanePeak[lane]);
+        sumOfSquares += laneSum[lane];
+    }
+}
+
+} // namespace DSP
@@ -0,0 +1,334 @@
+/*
+  ==============================================================================
+
+    ChannelLayout.h
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Channel layouts for multichannel and immersive buses
+    - Named speaker layouts from mono through 7.1.4
+    - First to third order Ambisonics (ACN channel order, SN3D)
+    - Layout negotiation: the mix matrix that carries one layout into another
+    - VBAP / Ambisonic panning and per-layout metering with N-channel
+      block kernels (no per-channel virtual calls)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace DSP {
+
+//==============================================================================
+// Channel Layout
+//==============================================================================
+
+/**
+ * A bus format: how many channels and what each one carries
+ *
+ * Speaker layouts use SMPTE / ITU channel order (L R C LFE Ls Rs, then rear
+ * surrounds, then heights). Directions are in degrees, azimuth positive to
+ * the left and elevation positive upwards (ITU-R BS.2051 convention):
+ *
+ *   Layout     Channels
+ *   Mono       C
+ *   Stereo     L R
+ *   LCR        L R C
+ *   Quad       L R Ls Rs
+ *   5.0        L R C Ls Rs
+ *   5.1        L R C LFE Ls Rs
+ *   7.0        L R C Lss Rss Lrs Rrs
+ *   7.1        L R C LFE Lss Rss Lrs Rrs
+ *   5.1.2      5.1 + Ltm Rtm
+ *   5.1.4      5.1 + Ltf Rtf Ltr Rtr
+ *   7.1.2      7.1 + Ltm Rtm
+ *   7.1.4      7.1 + Ltf Rtf Ltr Rtr
+ *
+ * Ambisonic layouts carry (order + 1)^2 spherical harmonic channels in ACN
+ * order with SN3D normalisation (AmbiX). Discrete layouts are plain
+ * numbered channels with no positions.
+ *
+ * Layouts are small values: copy them freely, including on the audio thread.
+ */
+class ChannelLayout
+{
+public:
+    static constexpr int maxChannels = 16;
+
+    enum class Type
+    {
+        Discrete,
+        Mono,
+        Stereo,
+        LCR,
+        Quad,
+        Surround50,
+        Surround51,
+        Surround70,
+        Surround71,
+        Surround512,
+        Surround514,
+        Surround712,
+        Surround714,
+        Ambisonic1,
+        Ambisonic2,
+        Ambisonic3
+    };
+
+    struct Speaker
+    {
+        const char* label;
+        float azimuth;      // Degrees, positive left
+        float elevation;    // Degrees, positive up
+        bool isLFE;
+    };
+
+    /** Stereo */
+    ChannelLayout() : ChannelLayout(Type::Stereo) {}
+
+    explicit ChannelLayout(Type type);
+
+    /** Numbered channels with no positions, clamped to [1, maxChannels] */
+    static ChannelLayout discrete(int numChannels);
+
+    /**
+     * The usual layout for a channel count: 1 mono, 2 stereo, 3 LCR,
+     * 4 quad, 5 5.0, 6 5.1, 7 7.0, 8 7.1, 10 5.1.4, 12 7.1.4, 16 third order
+     * Ambisonics; anything else is discrete
+     */
+    static ChannelLayout fromChannelCount(int numChannels);
+
+    Type getType() const { return type_; }
+    int getNumChannels() const { return numChannels_; }
+    const char* getName() const;
+
+    bool isDiscrete() const { return type_ == Type::Discrete; }
+    bool isAmbisonic() const { return ambisonicOrder_ > 0; }
+    bool isSpeakerLayout() const { return !isDiscrete() && !isAmbisonic(); }
+
+    /** 0 for speaker and discrete layouts */
+    int getAmbisonicOrder() const { return ambisonicOrder_; }
+
+    /** Speaker position and label; only valid on speaker layouts */
+    const Speaker& getSpeaker(int channel) const;
+
+    /** Channel carrying the label, or -1 */
+    int findChannel(const char* label) const;
+
+    /** LFE channel, or -1 */
+    int getLFEChannel() const;
+
+    bool hasHeightChannels() const;
+
+    /**
+     * Gains that place a point source at a direction
+     *
+     * Speaker layouts use VBAP: 2D pairwise panning within the ear-level
+     * ring and within the height ring, blended by elevation with equal power.
+     * Directions outside the arc a ring covers (behind a stereo pair, say)
+     * fold onto its edge speakers, easing down to -3 dB over 30 degrees.
+     * Ambisonic layouts get the SN3D spherical harmonics of the direction;
+     * discrete layouts spread equally. LFE channels are always 0. Speaker
+     * gains have unit power except where a direction is folded.
+     *
+     * @param gains getNumChannels() values
+     */
+    void getPanGains(float azimuth, float elevation, float* gains) const;
+
+    bool operator==(const ChannelLayout& other) const
+    {
+        return type_ == other.type_ && numChannels_ == other.numChannels_;
+    }
+
+    bool operator!=(const ChannelLayout& other) const { return !(*this == other); }
+
+private:
+    Type type_;
+    int numChannels_ = 1;
+    int ambisonicOrder_ = 0;
+    const Speaker* speakers_ = nullptr;
+};
+
+//==============================================================================
+// Mix Matrix
+//==============================================================================
+
+/**
+ * Gains from every input channel to every output channel
+ *
+ * negotiate() builds the matrix that connects two node formats; process()
+ * applies it to a block. Only non-zero gains are visited, so identity,
+ * upmix and fold-down matrices cost what they route.
+ */
+class MixMatrix
+{
+public:
+    /** Identity on stereo */
+    MixMatrix();
+
+    MixMatrix(int numInputs, int numOutputs);
+
+    static MixMatrix identity(int numChannels);
+
+    /**
+     * The matrix that carries source into destination
+     *
+     * - Same layout: identity
+     * - Either side discrete: channel n to channel n
+     * - Speaker to speaker: channels with the same label pass at unity;
+     *   the rest are panned at their own direction into the destination
+     *   (ITU-R BS.775 fold-downs: C at -3 dB into L/R, surrounds into the
+     *   front pair at -3 dB). Heights into a layout without heights are
+     *   lowered to ear level at -3 dB. LFE goes to the destination LFE or is
+     *   dropped.
+     * - Speakers into Ambisonics: each speaker is encoded at its direction
+     * - Ambisonics into speakers: max-rE weighted decode to a uniform
+     *   virtual array, panned onto the real speakers (AllRAD)
+     * - Ambisonics into Ambisonics: shared orders pass, extra orders are
+     *   dropped or left silent
+     *
+     * Allocation free, but the Ambisonic decoder is some hundred
+     * microseconds of setup: negotiate when a format changes, not per block.
+     */
+    static MixMatrix negotiate(const ChannelLayout& source, const ChannelLayout& destination);
+
+    int getNumInputs() const { return numInputs_; }
+    int getNumOutputs() const { return numOutputs_; }
+    bool isIdentity() const { return identity_; }
+
+    float getGain(int input, int output) const { return gains_[output][input]; }
+    void setGain(int input, int output, float gain);
+
+    /**
+     * output[o] = (or +=) sum over i of gain(i, o) * input[i]
+     *
+     * Input and output channels must not alias. The channel counts are the
+     * matrix's; pointers may be null for channels that are absent, which
+     * then read as silence or are skipped.
+     */
+    void process(const float* const* input, float* const* output, int numSamples,
+                 bool accumulate = false, float gain = 1.0f) const noexcept;
+
+private:
+    void updateRoutes();
+
+    int numInputs_;
+    int numOutputs_;
+    bool identity_ = false;
+    float gains_[ChannelLayout::maxChannels][ChannelLayout::maxChannels] = {};
+
+    // Non-zero gains, output-major, for the block kernel
+    struct Route
+    {
+        std::uint8_t input;
+        std::uint8_t output;
+        float gain;
+    };
+
+    Route routes_[ChannelLayout::maxChannels * ChannelLayout::maxChannels];
+    int numRoutes_ = 0;
+};
+
+//==============================================================================
+// Spatial Panner
+//==============================================================================
+
+/**
+ * Mono source into any layout
+ *
+ * VBAP on speaker layouts, spherical harmonic encoding on Ambisonic ones.
+ * Gains are recomputed only when the direction changes and ramp across
+ * the next block, so moving sources do not zipper. One pass per output
+ * channel, no virtual calls, allocation free.
+ */
+class SpatialPanner
+{
+public:
+    explicit SpatialPanner(const ChannelLayout& layout = ChannelLayout());
+
+    /** Changes the output format; the next block starts at the new gains */
+    void setLayout(const ChannelLayout& layout);
+    const ChannelLayout& getLayout() const { return layout_; }
+
+    /** Degrees, positive left / up */
+    void setDirection(float azimuth, float elevation = 0.0f);
+    float getAzimuth() const { return azimuth_; }
+    float getElevation() const { return elevation_; }
+
+    /** Gains the current ramp is heading for */
+    const float* getTargetGains() const { return targetGains_; }
+
+    /** Jump to the target gains */
+    void reset();
+
+    /**
+     * Pan numSamples of input into output[0 .. layout channels)
+     * @param accumulate Add into output instead of replacing it
+     */
+    void process(const float* input, float* const* output, int numSamples,
+                 bool accumulate = false) noexcept;
+
+private:
+    ChannelLayout layout_;
+    float azimuth_ = 0.0f;
+    float elevation_ = 0.0f;
+    float currentGains_[ChannelLayout::maxChannels] = {};
+    float targetGains_[ChannelLayout::maxChannels] = {};
+};
+
+//==============================================================================
+// Layout Meter
+//==============================================================================
+
+/**
+ * Peak and RMS for every channel of a layout, plus one program level
+ *
+ * The program level sums channel power with ITU-R BS.1770 channel weights
+ * (side and rear surrounds +1.5 dB, LFE excluded); on Ambisonic layouts it
+ * is the omnidirectional W channel. It is not K-weighted: use it for bus
+ * meters, not loudness compliance.
+ */
+class LayoutMeter
+{
+public:
+    explicit LayoutMeter(const ChannelLayout& layout = ChannelLayout());
+
+    void setLayout(const ChannelLayout& layout);
+    const ChannelLayout& getLayout() const { return layout_; }
+
+    /** Measure one block (channels may be null: read as silence) */
+    void process(const float* const* channels, int numSamples) noexcept;
+
+    /** Last block's linear peak and RMS */
+    float getPeak(int channel) const;
+    float getRMS(int channel) const;
+
+    /** Last block's weighted program RMS, linear */
+    float getProgramLevel() const { return programLevel_; }
+
+    /** Bit n set when channel n peaked above full scale in the last block */
+    std::uint32_t getClippingMask() const { return clippingMask_; }
+
+    void reset();
+
+    /**
+     * Peak and sum of squares of a block in one vectorisable pass
+     * (shared with the bus kernels)
+     */
+    static void measure(const float* data, int numSamples, float& peak, float& sumOfSquares) noexcept;
+
+    /** Power weight a channel contributes to the program level */
+    static float getChannelWeight(const ChannelLayout& layout, int channel);
+
+private:
+    ChannelLayout layout_;
+    float weights_[ChannelLayout::maxChannels] = {};
+    float peak_[ChannelLayout::maxChannels] = {};
+    float rms_[ChannelLayout::maxChannels] = {};
+    float programLevel_ = 0.0f;
+    std::uint32_t clippingMask_ = 0;
+};
+
+} // namespace DSP
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    ConstantQ.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Implementation of the sparse-kernel constant-Q transform
+
+  ==============================================================================
+*/
+
+#include "dsp/ConstantQ.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace DSP {
+
+namespace {
+
+constexpr double twoPi = 6.28318530717958647692;
+
+// Kernel FFT bins below this fraction of the kernel's peak are dropped;
+// Hann sidelobes start at -31 dB, so the first ones are kept
+constexpr double sparsity = 0.005;
+
+// Main lobe widths either side of the centre searched for kept bins
+constexpr int searchLobes = 8;
+
+/** sum of exp(-i * theta * m) for m in [0, length) */
+std::complex<double> dirichlet(double theta, int length)
+{
+    const std::complex<double> step = std::polar(1.0, -theta);
+    const std::complex<double> denominator = 1.0 - step;
+    if (std::abs(denominator) < 1.0e-12)
+        return static_cast<double>(length);
+
+    return (1.0 - std::polar(1.0, -theta * length)) / denominator;
+}
+
+} // namespace
+
+//==============================================================================
+// Construction
+//==============================================================================
+
+ConstantQ::ConstantQ(double sampleRate, int order, double minFrequency, double maxFrequency, int binsPerOctave)
+    : sampleRate_(sampleRate)
+    , binsPerOctave_(std::max(1, binsPerOctave))
+    , fft_(order)
+{
+    const int frameSize = fft_.getSize();
+    const int numFftBins = fft_.getNumBins();
+
+    minFrequency = std::max(1.0, minFrequency);
+    maxFrequency = std::min(maxFrequency, 0.45 * sampleRate_);
+    numBins_ = maxFrequency > minFrequency
+                   ? static_cast<int>(std::floor(binsPerOctave_ * std::log2(maxFrequency / minFrequency))) + 1
+                   : 1;
+
+    re_.resize(static_cast<size_t>(numFftBins));
+    im_.resize(static_cast<size_t>(numFftBins));
+
+    const double q = 1.0 / (std::pow(2.0, 1.0 / binsPerOctave_) - 1.0);
+    std::vector<std::complex<double>> spectrum;
+
+    kernelStart_.reserve(static_cast<size_t>(numBins_ + 1));
+
+    for (int k = 0; k < numBins_; ++k)
+    {
+        const double frequency = minFrequency * std::pow(2.0, static_cast<double>(k) / binsPerOctave_);
+        const int length = std::min(frameSize, static_cast<int>(std::ceil(q * sampleRate_ / frequency)));
+
+        frequencies_.push_back(frequency);
+        kernelLengths_.push_back(length);
+
+        const double lobeBins = binsPerOctave_ * std::log2(1.0 + 2.0 * sampleRate_ / (length * frequency));
+        peakWidths_.push_back(std::max(2, static_cast<int>(std::lround(lobeBins))));
+
+        // The kernel is a Hann-windowed complex exponential at the end of
+        // the frame, scaled so a sinusoid at the centre frequency reads its
+        // amplitude. Its DFT is closed form: the window's three Dirichlet
+        // kernels, shifted to the centre frequency.
+        const double omega = twoPi * frequency / sampleRate_;
+        const double lobe = twoPi / length;
+        const double scale = 4.0 / length;
+        const int offset = frameSize - length;
+
+        const double centre = omega * frameSize / twoPi;
+        const double reach = searchLobes * 2.0 * frameSize / length;
+        const int first = std::max(0, static_cast<int>(std::floor(centre - reach)));
+        const int last = std::min(numFftBins - 1, static_cast<int>(std::ceil(centre + reach)));
+
+        spectrum.clear();
+        double peak = 0.0;
+        for (int j = first; j <= last; ++j)
+        {
+            const double bin = twoPi * j / frameSize;
+            const double theta = bin - omega;
+            const auto value = scale * std::polar(1.0, -bin * offset)
+                             * (0.5 * dirichlet(theta, length) - 0.25 * dirichlet(theta - lobe, length)
+                                - 0.25 * dirichlet(theta + lobe, length));
+            spectrum.push_back(value);
+            peak = std::max(peak, std::abs(value));
+        }
+
+        // By Parseval, sum(x * conj(t)) = sum(X * conj(T)) / N, and T has
+        // (almost) nothing at negative frequencies
+        kernelStart_.push_back(static_cast<int>(kernelBin_.size()));
+        for (int j = first; j <= last; ++j)
+        {
+            const auto& value = spectrum[static_cast<size_t>(j - first)];
+            if (std::abs(value) < sparsity * peak)
+                continue;
+
+            kernelBin_.push_back(j);
+            kernelRe_.push_back(static_cast<float>(value.real() / frameSize));
+            kernelIm_.push_back(static_cast<float>(-value.imag() / frameSize));
+        }
+    }
+
+    kernelStart_.push_back(static_cast<int>(kernelBin_.size()));
+}
+
+//==============================================================================
+// Processing
+//==============================================================================
+
+void ConstantQ::process(const float* frame, float* magnitudes)
+{
+    fft_.forward(frame, re_.data(), im_.data());
+
+    for (int k = 0; k < numBins_; ++k)
+    {
+        float sumRe = 0.0f, sumIm = 0.0f;
+        const auto end = static_cast<size_t>(kernelStart_[static_cast<size_t>(k) + 1]);
+
+        for (auto i = static_cast<size_t>(kernelStart_[static_cast<size_t>(k)]); i < end; ++i)
+        {
+            const auto j = static_cast<size_t>(kernelBin_[i]);
+            sumRe += re_[j] * kernelRe_[i] - im_[j] * kernelIm_[i];
+            sumIm += re_[j] * kernelIm_[i] + im_[j] * kernelRe_[i];
+        }
+
+        magnitudes[k] = std::sqrt(sumRe * sumRe + sumIm * sumIm);
+    }
+}
+
+} // namespace DSP
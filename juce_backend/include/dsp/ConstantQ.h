@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    ConstantQ.h
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Constant-Q spectrum for pitch analysis in the pure-DSP code
+    - Log-spaced bins, a fixed number per octave
+    - Sparse spectral kernels applied to one real FFT per frame
+    - Kernels end at the frame end, so high bins see the newest audio only
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "dsp/RealFFT.h"
+#include <vector>
+
+namespace DSP {
+
+//==============================================================================
+// Constant-Q Transform
+//==============================================================================
+
+/**
+ * Constant-Q magnitude spectrum
+ *
+ * Bin k is centred on minFrequency * 2^(k / binsPerOctave) and analysed
+ * with a Hann-windowed kernel Q periods long, so every bin has the same
+ * resolution in cents. Kernels longer than the frame are cut to the
+ * frame, which widens the lowest bins instead of delaying them.
+ *
+ * Each kernel is transformed once at construction and only its
+ * significant FFT bins are kept; a frame then costs one real FFT and a
+ * short sum per bin. All kernels end at the last sample of the frame: a
+ * bin reacts within its own kernel length, not the frame's.
+ *
+ * A sinusoid of amplitude A at a bin's centre frequency reads A in that
+ * bin. Construct (allocates) off the audio thread; process() does not
+ * allocate. Not thread safe: one instance per thread.
+ */
+class ConstantQ
+{
+public:
+    /**
+     * @param order         log2 of the frame size
+     * @param maxFrequency  Bins stop at the last centre at or below this
+     *                      (and below 0.45 * sampleRate)
+     */
+    ConstantQ(double sampleRate, int order, double minFrequency, double maxFrequency, int binsPerOctave);
+
+    ConstantQ(const ConstantQ&) = delete;
+    ConstantQ& operator=(const ConstantQ&) = delete;
+
+    int getFrameSize() const { return fft_.getSize(); }
+    int getNumBins() const { return numBins_; }
+    int getBinsPerOctave() const { return binsPerOctave_; }
+    double getSampleRate() const { return sampleRate_; }
+
+    double getFrequency(int bin) const { return frequencies_[static_cast<size_t>(bin)]; }
+
+    /** Samples the bin analyses (at most the frame size) */
+    int getKernelLength(int bin) const { return kernelLengths_[static_cast<size_t>(bin)]; }
+
+    /** Half width of a bin's main lobe, in bins */
+    int getPeakWidth(int bin) const { return peakWidths_[static_cast<size_t>(bin)]; }
+
+    /** frame[frameSize], oldest sample first -> magnitudes[numBins] */
+    void process(const float* frame, float* magnitudes);
+
+private:
+    double sampleRate_;
+    int binsPerOctave_;
+    int numBins_ = 0;
+
+    RealFFT fft_;
+    std::vector<float> re_, im_;
+
+    std::vector<double> frequencies_;
+    std::vector<int> kernelLengths_;
+    std::vector<int> peakWidths_;
+
+    // Sparse kernels, bin k in [kernelStart_[k], kernelStart_[k + 1]).
+    // Conjugated and scaled, so a bin is sum(X[j] * kernel[j]).
+    std::vector<int> kernelStart_;
+    std::vector<int> kernelBin_;
+    std::vector<float> kernelRe_, kernelIm_;
+};
+
+} // namespace DSP
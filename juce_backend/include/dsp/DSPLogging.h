@@ -5,6 +5,8 @@
 
     Shared logging utilities for all instrument DSP implementations.
     Provides timestamped parameter change logging for debug builds.
+    Changes go through the deferred RealtimeLog, so setParameter() may be
+    called from the audio thread.
 
     Usage:
       #include "dsp/DSPLogging.h"
@@ -20,8 +22,8 @@
 
 #pragma once
 
-#include <chrono>
-#include <cstdio>
+#include "RealtimeLog.h"
+#include <cmath>
 
 #ifdef DEBUG
 
@@ -40,13 +42,11 @@
 ///   - newValue: Parameter value after change
 #define LOG_PARAMETER_CHANGE(instrumentName, paramId, oldValue, newValue) \
     do { \
-        auto now = std::chrono::system_clock::now(); \
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>( \
-            now.time_since_epoch()).count(); \
-        float delta = std::abs((newValue) - (oldValue)); \
-        if (delta > 0.001f) { \
-            printf("[%lld] [%sDSP] %s: %.3f -> %.3f (Δ%.3f)\n", \
-                   timestamp, instrumentName, paramId, oldValue, newValue, delta); \
+        const double delta = std::abs(static_cast<double>(newValue) - static_cast<double>(oldValue)); \
+        if (delta > 0.001) { \
+            DSP_LOG_DEBUG("[%sDSP] %s: %.3f -> %.3f (Δ%.3f)", \
+                          instrumentName, paramId, static_cast<double>(oldValue), \
+                          static_cast<double>(newValue), delta); \
         } \
     } while(0)
 
@@ -0,0 +1,780 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolution.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Implementation of the non-uniformly partitioned convolution engine
+
+  ==============================================================================
+*/
+
+#include "dsp/PartitionedConvolution.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace DSP {
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+//==============================================================================
+// Background tail worker
+//==============================================================================
+
+/**
+ * One block of tail work. The audio thread posts it (Pending), then either
+ * the worker or, at the deadline, the audio thread claims it (Running);
+ * whoever claims it computes it and marks it Done.
+ */
+struct TailJob
+{
+    enum State { Idle, Pending, Running, Done };
+
+    virtual ~TailJob() = default;
+    virtual void run() = 0;
+
+    bool claim()
+    {
+        int expected = Pending;
+        return state.compare_exchange_strong(expected, Running, std::memory_order_acq_rel);
+    }
+
+    void runClaimed()
+    {
+        run();
+        state.store(Done, std::memory_order_release);
+    }
+
+    std::atomic<int> state { Idle };
+    std::atomic<int64_t> deadlineNs { 0 };     // steady_clock time the output is needed
+};
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Shared worker for every convolver's tail segments, so ten IR reverbs
+ * cost one thread. Pending jobs run earliest deadline first. The worker
+ * holds the registry lock while computing, so removing a job waits for it
+ * to finish; the audio thread never takes the lock.
+ */
+class TailWorker
+{
+public:
+    static TailWorker& getInstance()
+    {
+        static TailWorker instance;
+        return instance;
+    }
+
+    void add(TailJob* job)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+    }
+
+    void remove(TailJob* job)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.erase(std::remove(jobs_.begin(), jobs_.end(), job), jobs_.end());
+    }
+
+    void notify() noexcept
+    {
+        posted_.fetch_add(1, std::memory_order_release);
+        wakeUp_.notify_one();
+    }
+
+private:
+    TailWorker() : thread_([this] { run(); }) {}
+
+    ~TailWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quit_ = true;
+        }
+        wakeUp_.notify_one();
+        thread_.join();
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (!quit_)
+        {
+            const auto seen = posted_.load(std::memory_order_acquire);
+
+            TailJob* next = nullptr;
+            int64_t earliest = INT64_MAX;
+            for (auto* job : jobs_)
+            {
+                if (job->state.load(std::memory_order_acquire) != TailJob::Pending)
+                    continue;
+
+                const auto deadline = job->deadlineNs.load(std::memory_order_relaxed);
+                if (deadline < earliest)
+                {
+                    earliest = deadline;
+                    next = job;
+                }
+            }
+
+            if (next != nullptr)
+            {
+                if (next->claim())
+                    next->runClaimed();
+                continue;
+            }
+
+            // notify() does not take the lock, so a wake-up can fall between
+            // the scan and the wait; the timeout bounds how long that costs
+            wakeUp_.wait_for(lock, std::chrono::milliseconds(1), [this, seen] {
+                return quit_ || posted_.load(std::memory_order_acquire) != seen;
+            });
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::vector<TailJob*> jobs_;
+    std::atomic<uint32_t> posted_ { 0 };
+    bool quit_ = false;
+    std::thread thread_;
+};
+
+//==============================================================================
+// IR preparation
+//==============================================================================
+
+/** Windowed-sinc resampling by ratio = target rate / source rate */
+std::vector<float> resample(const std::vector<float>& source, double ratio)
+{
+    const int sourceLength = static_cast<int>(source.size());
+    const int outputLength = static_cast<int>(std::ceil(sourceLength * ratio));
+    const double cutoff = std::min(1.0, ratio);                 // Band-limit when downsampling
+    const int halfWidth = static_cast<int>(std::ceil(16.0 / cutoff));
+
+    std::vector<float> output(static_cast<size_t>(outputLength), 0.0f);
+
+    for (int n = 0; n < outputLength; ++n)
+    {
+        const double position = n / ratio;
+        const int centre = static_cast<int>(std::floor(position));
+        const int first = std::max(0, centre - halfWidth + 1);
+        const int last = std::min(sourceLength - 1, centre + halfWidth);
+
+        double sum = 0.0;
+        for (int k = first; k <= last; ++k)
+        {
+            const double distance = position - k;
+            const double u = distance / halfWidth;
+            const double window = 0.42 + 0.5 * std::cos(pi * u) + 0.08 * std::cos(2.0 * pi * u);
+            const double x = pi * cutoff * distance;
+            const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(x) / x;
+            sum += source[static_cast<size_t>(k)] * cutoff * sinc * window;
+        }
+
+        output[static_cast<size_t>(n)] = static_cast<float>(sum);
+    }
+
+    return output;
+}
+
+/** Length with the common silent tail (below -100 dB of the peak) removed */
+int trimmedLength(const std::vector<std::vector<float>>& channels)
+{
+    float peak = 0.0f;
+    for (const auto& channel : channels)
+        for (float sample : channel)
+            peak = std::max(peak, std::abs(sample));
+
+    const float threshold = peak * 1.0e-5f;
+    int length = 0;
+    for (const auto& channel : channels)
+    {
+        for (int i = static_cast<int>(channel.size()) - 1; i >= length; --i)
+        {
+            if (std::abs(channel[static_cast<size_t>(i)]) > threshold)
+            {
+                length = i + 1;
+                break;
+            }
+        }
+    }
+
+    return length;
+}
+
+} // namespace
+
+//==============================================================================
+// Partitioned Convolver
+//==============================================================================
+
+/**
+ * Uniformly partitioned overlap-save over one stretch of the IR. Each
+ * completed input block is transformed once into a frequency-domain delay
+ * line and multiplied against every partition's spectrum.
+ */
+struct PartitionedConvolver::Segment : TailJob
+{
+    Segment(const float* impulse, int length, int start, int end, int block, bool isTail, bool useWorker)
+        : blockSize(block)
+        , numPartitions((std::min(end, length) - start + block - 1) / block)
+        , numBins(block + 1)
+        , tail(isTail)
+        , background(isTail && useWorker)
+        , fft(orderOf(2 * block))
+    {
+        const auto spectrumSize = static_cast<size_t>(numPartitions * numBins);
+        irRe.resize(spectrumSize);
+        irIm.resize(spectrumSize);
+        fdlRe.assign(spectrumSize, 0.0f);
+        fdlIm.assign(spectrumSize, 0.0f);
+        accRe.resize(static_cast<size_t>(numBins));
+        accIm.resize(static_cast<size_t>(numBins));
+        timeBuffer.resize(static_cast<size_t>(2 * block));
+        window.assign(static_cast<size_t>(2 * block), 0.0f);
+        jobInput.assign(static_cast<size_t>(2 * block), 0.0f);
+        output[0].assign(static_cast<size_t>(block), 0.0f);
+        output[1].assign(static_cast<size_t>(block), 0.0f);
+
+        // Partition p is zero-padded to 2B, so the last B outputs of each
+        // overlap-save block are free of wrap-around
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            std::fill(timeBuffer.begin(), timeBuffer.end(), 0.0f);
+            const int first = start + p * block;
+            const int count = std::min(block, std::min(end, length) - first);
+            std::copy(impulse + first, impulse + first + count, timeBuffer.begin());
+            fft.forward(timeBuffer.data(), &irRe[static_cast<size_t>(p * numBins)],
+                        &irIm[static_cast<size_t>(p * numBins)]);
+        }
+    }
+
+    static int orderOf(int size)
+    {
+        int order = 0;
+        while ((1 << order) < size)
+            ++order;
+        return order;
+    }
+
+    void compute(const float* input, float* result)
+    {
+        const auto head = static_cast<size_t>(fdlHead * numBins);
+        fft.forward(input, &fdlRe[head], &fdlIm[head]);
+
+        std::fill(accRe.begin(), accRe.end(), 0.0f);
+        std::fill(accIm.begin(), accIm.end(), 0.0f);
+
+        float* sumRe = accRe.data();
+        float* sumIm = accIm.data();
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            const int slot = (fdlHead - p + numPartitions) % numPartitions;
+            const float* xr = &fdlRe[static_cast<size_t>(slot * numBins)];
+            const float* xi = &fdlIm[static_cast<size_t>(slot * numBins)];
+            const float* hr = &irRe[static_cast<size_t>(p * numBins)];
+            const float* hi = &irIm[static_cast<size_t>(p * numBins)];
+
+            for (int k = 0; k < numBins; ++k)
+            {
+                sumRe[k] += xr[k] * hr[k] - xi[k] * hi[k];
+                sumIm[k] += xr[k] * hi[k] + xi[k] * hr[k];
+            }
+        }
+
+        fdlHead = (fdlHead + 1) % numPartitions;
+
+        fft.inverse(sumRe, sumIm, timeBuffer.data());
+        std::copy(timeBuffer.begin() + blockSize, timeBuffer.end(), result);
+    }
+
+    void run() override
+    {
+        compute(jobInput.data(), output[jobSlot].data());
+    }
+
+    void clear()
+    {
+        std::fill(fdlRe.begin(), fdlRe.end(), 0.0f);
+        std::fill(fdlIm.begin(), fdlIm.end(), 0.0f);
+        std::fill(window.begin(), window.end(), 0.0f);
+        std::fill(output[0].begin(), output[0].end(), 0.0f);
+        std::fill(output[1].begin(), output[1].end(), 0.0f);
+        fdlHead = 0;
+        readSlot = 0;
+        jobSlot = 1;
+    }
+
+    const int blockSize;
+    const int numPartitions;
+    const int numBins;
+    const bool tail;                // Offset 2B: output due one block after the input completes
+    const bool background;          // Tail computed by the worker rather than inline
+
+    RealFFT fft;
+    std::vector<float> irRe, irIm;          // Partition spectra
+    std::vector<float> fdlRe, fdlIm;        // Input spectra, ring of numPartitions
+    int fdlHead = 0;
+    std::vector<float> accRe, accIm;
+    std::vector<float> timeBuffer;
+
+    std::vector<float> window;              // Previous block | block being filled
+    std::vector<float> jobInput;            // Tail: window snapshot the job reads
+    std::vector<float> output[2];           // Tail: one being played, one being computed
+    int readSlot = 0;
+    int jobSlot = 1;
+};
+
+PartitionedConvolver::PartitionedConvolver(const float* impulse, int length, double sampleRate,
+                                           int headSize, bool useBackgroundThread)
+    : length_(std::max(0, length))
+    , sampleRate_(sampleRate > 0.0 ? sampleRate : 48000.0)
+{
+    headSize_ = 1 << Segment::orderOf(std::max(1, headSize));
+
+    const int H = headSize_;
+    head_.assign(static_cast<size_t>(H), 0.0f);
+    std::copy(impulse, impulse + std::min(H, length_), head_.begin());
+    headHistory_.assign(static_cast<size_t>(2 * H - 1), 0.0f);
+
+    struct Layout { int start, end, blockSize; bool tail; };
+    const Layout layout[] =
+    {
+        { H,        8 * H,   H,       false },
+        { 8 * H,    64 * H,  8 * H,   false },
+        { 64 * H,   512 * H, 32 * H,  true },
+        { 512 * H,  INT_MAX, 256 * H, true }
+    };
+
+    for (const auto& stretch : layout)
+    {
+        if (stretch.start >= length_)
+            break;
+
+        segments_.push_back(std::make_unique<Segment>(impulse, length_, stretch.start, stretch.end,
+                                                      stretch.blockSize, stretch.tail, useBackgroundThread));
+    }
+
+    for (auto& segment : segments_)
+    {
+        if (segment->background)
+            TailWorker::getInstance().add(segment.get());
+    }
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    for (auto& segment : segments_)
+    {
+        if (segment->background)
+            TailWorker::getInstance().remove(segment.get());
+    }
+}
+
+void PartitionedConvolver::reset()
+{
+    for (auto& segment : segments_)
+    {
+        finishTail(*segment);
+        segment->clear();
+    }
+
+    std::fill(headHistory_.begin(), headHistory_.end(), 0.0f);
+    samplesProcessed_ = 0;
+}
+
+void PartitionedConvolver::process(const float* input, float* output, int numSamples)
+{
+    int done = 0;
+    while (done < numSamples)
+    {
+        // Chunks never cross a head block boundary, so no segment boundary either
+        const int intoBlock = static_cast<int>(samplesProcessed_ % headSize_);
+        const int count = std::min(numSamples - done, headSize_ - intoBlock);
+        processChunk(input + done, output + done, count);
+        done += count;
+    }
+}
+
+void PartitionedConvolver::processChunk(const float* input, float* output, int numSamples)
+{
+    const int H = headSize_;
+    float* history = headHistory_.data();
+    float* current = history + H - 1;
+
+    // Input goes to the history first, so output may alias input
+    std::copy(input, input + numSamples, current);
+
+    // Direct-form head, tap by tap so the inner loop vectorises
+    std::fill(output, output + numSamples, 0.0f);
+    for (int k = 0; k < H; ++k)
+    {
+        const float tap = head_[static_cast<size_t>(k)];
+        if (tap == 0.0f)
+            continue;
+
+        const float* x = current - k;
+        for (int i = 0; i < numSamples; ++i)
+            output[i] += tap * x[i];
+    }
+
+    for (auto& segment : segments_)
+    {
+        const int position = static_cast<int>(samplesProcessed_ % segment->blockSize);
+        std::copy(current, current + numSamples, segment->window.begin() + segment->blockSize + position);
+
+        const float* result = segment->output[segment->readSlot].data() + position;
+        for (int i = 0; i < numSamples; ++i)
+            output[i] += result[i];
+    }
+
+    std::memmove(history, history + numSamples, static_cast<size_t>(H - 1) * sizeof(float));
+    samplesProcessed_ += numSamples;
+
+    if (samplesProcessed_ % H != 0)
+        return;
+
+    for (auto& segment : segments_)
+    {
+        if (samplesProcessed_ % segment->blockSize == 0)
+            completeBlock(*segment);
+    }
+}
+
+void PartitionedConvolver::completeBlock(Segment& segment)
+{
+    const int B = segment.blockSize;
+
+    if (!segment.tail)
+    {
+        // Output for the block just completed plays from now on
+        segment.compute(segment.window.data(), segment.output[0].data());
+    }
+    else
+    {
+        // The previous block's result is due now; this block's is due in B samples
+        if (segment.state.load(std::memory_order_acquire) != TailJob::Idle)
+        {
+            finishTail(segment);
+            segment.readSlot = segment.jobSlot;
+        }
+
+        segment.jobSlot = 1 - segment.readSlot;
+        std::copy(segment.window.begin(), segment.window.end(), segment.jobInput.begin());
+
+        if (segment.background)
+        {
+            const auto slack = static_cast<int64_t>(1.0e9 * B / sampleRate_);
+            segment.deadlineNs.store(nowNs() + slack, std::memory_order_relaxed);
+            segment.state.store(TailJob::Pending, std::memory_order_release);
+            TailWorker::getInstance().notify();
+        }
+        else
+        {
+            segment.state.store(TailJob::Running, std::memory_order_relaxed);
+            segment.runClaimed();
+        }
+    }
+
+    std::copy(segment.window.begin() + B, segment.window.end(), segment.window.begin());
+}
+
+void PartitionedConvolver::finishTail(Segment& segment)
+{
+    if (segment.state.load(std::memory_order_acquire) == TailJob::Idle)
+        return;
+
+    if (segment.background)
+    {
+        if (segment.claim())
+        {
+            // The worker never got to it: compute here rather than miss the deadline
+            segment.runClaimed();
+            lateTailBlocks_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (segment.state.load(std::memory_order_acquire) != TailJob::Done)
+        {
+            lateTailBlocks_.fetch_add(1, std::memory_order_relaxed);
+            while (segment.state.load(std::memory_order_acquire) != TailJob::Done)
+                std::this_thread::yield();
+        }
+    }
+
+    segment.state.store(TailJob::Idle, std::memory_order_relaxed);
+}
+
+//==============================================================================
+// Convolution Engine
+//==============================================================================
+
+/** One loaded IR: a convolver per input -> output path */
+struct ConvolutionEngine::Kernel
+{
+    struct Path
+    {
+        int input;
+        int output;
+        std::unique_ptr<PartitionedConvolver> convolver;
+    };
+
+    std::vector<Path> paths;
+};
+
+ConvolutionEngine::ConvolutionEngine() = default;
+
+ConvolutionEngine::~ConvolutionEngine()
+{
+    collectGarbage();
+    delete pending_.exchange(nullptr);
+    delete active_;
+    delete incoming_;
+    delete retiring_;
+}
+
+void ConvolutionEngine::setHeadSize(int headSize)
+{
+    headSize_ = std::max(16, headSize);
+}
+
+bool ConvolutionEngine::prepare(double sampleRate, int maxBlockSize)
+{
+    collectGarbage();
+    delete pending_.exchange(nullptr);
+    delete active_;
+    delete incoming_;
+    delete retiring_;
+    active_ = incoming_ = retiring_ = nullptr;
+
+    sampleRate_ = sampleRate > 0.0 ? sampleRate : 48000.0;
+    maxBlockSize_ = std::max(1, maxBlockSize);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        wetBuffer_[ch].assign(static_cast<size_t>(maxBlockSize_), 0.0f);
+        fadeBuffer_[ch].assign(static_cast<size_t>(maxBlockSize_), 0.0f);
+    }
+    pathBuffer_.assign(static_cast<size_t>(maxBlockSize_), 0.0f);
+
+    if (!sourceChannels_.empty())
+        active_ = buildKernel().release();
+
+    hasImpulse_.store(active_ != nullptr && !active_->paths.empty());
+    return true;
+}
+
+bool ConvolutionEngine::loadImpulseResponse(const float* const* channels, int numChannels,
+                                            int numSamples, double irSampleRate)
+{
+    if (channels == nullptr || numSamples <= 0 || irSampleRate <= 0.0
+        || (numChannels != 1 && numChannels != 2 && numChannels != 4))
+        return false;
+
+    sourceChannels_.clear();
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (channels[ch] == nullptr)
+            return false;
+
+        sourceChannels_.emplace_back(channels[ch], channels[ch] + numSamples);
+    }
+    sourceSampleRate_ = irSampleRate;
+
+    auto kernel = buildKernel();
+    collectGarbage();
+
+    // A kernel the audio thread never picked up is simply replaced
+    delete pending_.exchange(kernel.release(), std::memory_order_acq_rel);
+    return true;
+}
+
+void ConvolutionEngine::clearImpulseResponse()
+{
+    sourceChannels_.clear();
+    impulseLength_ = 0;
+    collectGarbage();
+    delete pending_.exchange(new Kernel(), std::memory_order_acq_rel);
+}
+
+std::unique_ptr<ConvolutionEngine::Kernel> ConvolutionEngine::buildKernel()
+{
+    auto kernel = std::make_unique<Kernel>();
+
+    std::vector<std::vector<float>> channels;
+    const double ratio = sampleRate_ / sourceSampleRate_;
+    for (const auto& source : sourceChannels_)
+        channels.push_back(std::abs(ratio - 1.0) < 1.0e-9 ? source : resample(source, ratio));
+
+    const int length = trimmedLength(channels);
+    impulseLength_ = length;
+    if (length == 0)
+        return kernel;
+
+    auto addPath = [&](int input, int output, int channel) {
+        kernel->paths.push_back({ input, output,
+                                  std::make_unique<PartitionedConvolver>(channels[static_cast<size_t>(channel)].data(),
+                                                                         length, sampleRate_, headSize_, !nonRealtime_) });
+    };
+
+    switch (channels.size())
+    {
+        case 1:
+            addPath(0, 0, 0);
+            addPath(1, 1, 0);
+            break;
+
+        case 2:
+            addPath(0, 0, 0);
+            addPath(1, 1, 1);
+            break;
+
+        default:    // True stereo: L->L, L->R, R->L, R->R
+            addPath(0, 0, 0);
+            addPath(0, 1, 1);
+            addPath(1, 0, 2);
+            addPath(1, 1, 3);
+            break;
+    }
+
+    return kernel;
+}
+
+void ConvolutionEngine::collectGarbage()
+{
+    delete retired_.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void ConvolutionEngine::reset()
+{
+    for (auto* kernel : { active_, incoming_ })
+    {
+        if (kernel == nullptr)
+            continue;
+
+        for (auto& path : kernel->paths)
+            path.convolver->reset();
+    }
+}
+
+uint32_t ConvolutionEngine::getNumLateTailBlocks() const
+{
+    uint32_t late = 0;
+    if (active_ != nullptr)
+    {
+        for (const auto& path : active_->paths)
+            late += path.convolver->getNumLateTailBlocks();
+    }
+
+    return late;
+}
+
+void ConvolutionEngine::processKernel(Kernel& kernel, const float* const* inputs, int numChannels,
+                                      int offset, int numSamples, std::vector<float>* destination)
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        std::fill(destination[ch].begin(), destination[ch].begin() + numSamples, 0.0f);
+
+    for (auto& path : kernel.paths)
+    {
+        // Mono processing runs only the paths into the left output
+        if (path.output >= numChannels)
+            continue;
+
+        const float* input = inputs[std::min(path.input, numChannels - 1)] + offset;
+        path.convolver->process(input, pathBuffer_.data(), numSamples);
+
+        float* sum = destination[path.output].data();
+        for (int i = 0; i < numSamples; ++i)
+            sum[i] += pathBuffer_[static_cast<size_t>(i)];
+    }
+}
+
+void ConvolutionEngine::process(const float* const* inputs, float* const* outputs, int numChannels, int numSamples)
+{
+    numChannels = std::min(2, numChannels);
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    // Hand a fully faded-out kernel back; wait if the last one is still uncollected
+    if (retiring_ != nullptr)
+    {
+        Kernel* expected = nullptr;
+        if (retired_.compare_exchange_strong(expected, retiring_, std::memory_order_acq_rel))
+            retiring_ = nullptr;
+    }
+
+    if (incoming_ == nullptr && retiring_ == nullptr)
+    {
+        if (auto* next = pending_.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            incoming_ = next;
+            fadePosition_ = 0;
+            fadeLength_ = std::max(1, static_cast<int>(crossfadeSeconds_ * sampleRate_));
+        }
+    }
+
+    hasImpulse_.store((active_ != nullptr && !active_->paths.empty())
+                      || (incoming_ != nullptr && !incoming_->paths.empty()),
+                      std::memory_order_relaxed);
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize_)
+    {
+        const int count = std::min(maxBlockSize_, numSamples - offset);
+
+        if (active_ != nullptr)
+        {
+            processKernel(*active_, inputs, numChannels, offset, count, wetBuffer_);
+        }
+        else
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                std::fill(wetBuffer_[ch].begin(), wetBuffer_[ch].begin() + count, 0.0f);
+        }
+
+        if (incoming_ != nullptr)
+        {
+            processKernel(*incoming_, inputs, numChannels, offset, count, fadeBuffer_);
+
+            const float step = 1.0f / static_cast<float>(fadeLength_);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float* wet = wetBuffer_[ch].data();
+                const float* fadeIn = fadeBuffer_[ch].data();
+                for (int i = 0; i < count; ++i)
+                {
+                    const float gain = std::min(1.0f, static_cast<float>(fadePosition_ + i + 1) * step);
+                    wet[i] += gain * (fadeIn[i] - wet[i]);
+                }
+            }
+
+            fadePosition_ += count;
+            if (fadePosition_ >= fadeLength_)
+            {
+                retiring_ = active_;
+                active_ = incoming_;
+                incoming_ = nullptr;
+            }
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::copy(wetBuffer_[ch].begin(), wetBuffer_[ch].begin() + count, outputs[ch] + offset);
+    }
+}
+
+} // namespace DSP
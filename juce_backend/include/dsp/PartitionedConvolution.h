@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolution.h
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Zero-latency convolution for measured impulse responses
+    - Direct-form head, so the first taps cost no latency
+    - FFT partitions that grow with distance into the IR (non-uniform)
+    - Long tail partitions computed on a shared background worker,
+      earliest deadline first, with an audio-thread fallback
+    - Mono, stereo and true-stereo IRs, hot-swapped with a crossfade
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "dsp/RealFFT.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DSP {
+
+//==============================================================================
+// Partitioned Convolver
+//==============================================================================
+
+/**
+ * Mono zero-latency convolver for one impulse response
+ *
+ * With head size H the IR is laid out as
+ *
+ *   [0, H)         direct form, per sample
+ *   [H, 8H)        FFT blocks of H,   computed when each block fills
+ *   [8H, 64H)      FFT blocks of 8H,  computed when each block fills
+ *   [64H, 512H)    FFT blocks of 32H, background, due one block later
+ *   [512H, end)    FFT blocks of 256H, background, due one block later
+ *
+ * A segment with block size B normally starts at offset B, so its output
+ * is needed the moment its input block is complete. The tail segments
+ * start at 2B instead, which gives the worker a whole block of slack; if
+ * the worker is late the audio thread computes the block itself, so the
+ * output never depends on scheduling. With H = 64 the largest transform
+ * on the audio thread is 1024 points, so a 5 s IR at 48 kHz stays cheap
+ * at 64-sample buffers.
+ *
+ * Construct and destroy on a non-realtime thread; process never locks or
+ * allocates.
+ */
+class PartitionedConvolver
+{
+public:
+    /**
+     * @param impulse IR samples (already at the processing sample rate)
+     * @param length Number of IR samples
+     * @param sampleRate Processing sample rate, used for worker deadlines
+     * @param headSize Direct-form length and smallest FFT block (power of two)
+     * @param useBackgroundThread false computes the tail inline (offline rendering)
+     */
+    PartitionedConvolver(const float* impulse, int length, double sampleRate,
+                         int headSize = 64, bool useBackgroundThread = true);
+    ~PartitionedConvolver();
+
+    PartitionedConvolver(const PartitionedConvolver&) = delete;
+    PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+    /** Convolve numSamples of input into output (output may alias input) */
+    void process(const float* input, float* output, int numSamples);
+
+    /** Clear all signal history (audio thread, or while not processing) */
+    void reset();
+
+    int getImpulseLength() const { return length_; }
+
+    /** Tail blocks the audio thread had to compute because the worker was late */
+    uint32_t getNumLateTailBlocks() const { return lateTailBlocks_.load(std::memory_order_relaxed); }
+
+private:
+    struct Segment;
+
+    void processChunk(const float* input, float* output, int numSamples);
+    void completeBlock(Segment& segment);
+    void finishTail(Segment& segment);
+
+    int length_ = 0;
+    int headSize_ = 64;
+    double sampleRate_ = 48000.0;
+
+    std::vector<float> head_;                   // First H taps
+    std::vector<float> headHistory_;            // H-1 past samples + current chunk
+    std::vector<std::unique_ptr<Segment>> segments_;
+    int64_t samplesProcessed_ = 0;
+
+    std::atomic<uint32_t> lateTailBlocks_ { 0 };
+};
+
+//==============================================================================
+// Convolution Engine
+//==============================================================================
+
+/**
+ * Stereo IR convolution with hot-swap
+ *
+ * Impulse responses are loaded on the message thread as 1 channel (same IR
+ * on every channel), 2 channels (left/right) or 4 channels (true stereo:
+ * L->L, L->R, R->L, R->R). IRs at another sample rate are resampled and
+ * silent tails are trimmed. A new IR is built off the audio thread, then
+ * crossfaded in; the old one is handed back and freed on the next load.
+ *
+ * process() writes only the convolved (wet) signal and supports in-place
+ * buffers. With one channel only the paths into the left output run, all
+ * fed from that channel.
+ */
+class ConvolutionEngine
+{
+public:
+    ConvolutionEngine();
+    ~ConvolutionEngine();
+
+    ConvolutionEngine(const ConvolutionEngine&) = delete;
+    ConvolutionEngine& operator=(const ConvolutionEngine&) = delete;
+
+    //==============================================================================
+    // Message thread
+    //==============================================================================
+
+    /** Rebuilds the current IR for the new rate; call while not processing */
+    bool prepare(double sampleRate, int maxBlockSize);
+
+    /** Offline rendering computes the tail inline; takes effect at the next prepare() */
+    void setNonRealtime(bool nonRealtime) { nonRealtime_ = nonRealtime; }
+
+    /** Direct-form length and smallest FFT block; takes effect at the next load or prepare() */
+    void setHeadSize(int headSize);
+
+    void setCrossfadeTime(double seconds) { crossfadeSeconds_ = seconds; }
+
+    /**
+     * Load an impulse response (1, 2 or 4 channels) and crossfade to it
+     * @return false for an unsupported channel count or an empty IR
+     */
+    bool loadImpulseResponse(const float* const* channels, int numChannels,
+                             int numSamples, double irSampleRate);
+
+    /** Crossfade to silence */
+    void clearImpulseResponse();
+
+    /** Length of the last loaded IR at the processing rate, after trimming */
+    int getImpulseLength() const { return impulseLength_; }
+
+    //==============================================================================
+    // Audio thread
+    //==============================================================================
+
+    void reset();
+
+    /** Convolve numChannels (1 or 2) of input into output */
+    void process(const float* const* inputs, float* const* outputs, int numChannels, int numSamples);
+
+    /** True once an IR is playing (or fading in) */
+    bool hasImpulseResponse() const { return hasImpulse_.load(std::memory_order_relaxed); }
+
+    /** Always zero: the head is computed in direct form */
+    int getLatencySamples() const { return 0; }
+
+    /** Tail blocks of the playing IR that missed the worker (see PartitionedConvolver) */
+    uint32_t getNumLateTailBlocks() const;
+
+private:
+    struct Kernel;
+
+    std::unique_ptr<Kernel> buildKernel();
+    void processKernel(Kernel& kernel, const float* const* inputs, int numChannels,
+                       int offset, int numSamples, std::vector<float>* destination);
+    void collectGarbage();
+
+    // Source IR, kept for rebuilding at another sample rate
+    std::vector<std::vector<float>> sourceChannels_;
+    double sourceSampleRate_ = 0.0;
+
+    double sampleRate_ = 48000.0;
+    int maxBlockSize_ = 512;
+    int headSize_ = 64;
+    bool nonRealtime_ = false;
+    double crossfadeSeconds_ = 0.05;
+    int impulseLength_ = 0;
+
+    // Audio thread
+    Kernel* active_ = nullptr;
+    Kernel* incoming_ = nullptr;
+    Kernel* retiring_ = nullptr;                // Faded out, waiting for retired_ to free up
+    int fadePosition_ = 0;
+    int fadeLength_ = 0;
+    std::vector<float> wetBuffer_[2];
+    std::vector<float> fadeBuffer_[2];
+    std::vector<float> pathBuffer_;
+
+    // Hand-over between threads: the message thread publishes into pending_,
+    // the audio thread hands replaced kernels back through retired_
+    std::atomic<Kernel*> pending_ { nullptr };
+    std::atomic<Kernel*> retired_ { nullptr };
+    std::atomic<bool> hasImpulse_ { false };
+};
+
+} // namespace DSP
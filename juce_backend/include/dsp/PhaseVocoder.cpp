@@ -0,0 +1,527 @@
+/*
+  ==============================================================================
+
+    PhaseVocoder.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Implementation of the phase-locked vocoder
+
+  ==============================================================================
+*/
+
+#include "dsp/PhaseVocoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace DSP {
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+constexpr double twoPi = 2.0 * pi;
+
+// A bin rising by more than 3 dB counts towards a transient; a frame in
+// which more than this fraction of bins rise is one
+constexpr float riseFactor = 1.4125f;
+constexpr float transientFraction = 0.35f;
+
+double wrapPhase(double phase)
+{
+    return phase - twoPi * std::floor((phase + pi) / twoPi);
+}
+
+int orderFor(PhaseVocoder::Mode mode, double sampleRate)
+{
+    // 1024 or 4096 at 48 kHz, nearest power of two at other rates
+    const double base = mode == PhaseVocoder::Mode::LowLatency ? 1024.0 : 4096.0;
+    const double scaled = base * std::max(8000.0, sampleRate) / 48000.0;
+    return std::max(8, static_cast<int>(std::lround(std::log2(scaled))));
+}
+
+} // namespace
+
+//==============================================================================
+// Construction
+//==============================================================================
+
+PhaseVocoder::PhaseVocoder(Mode mode, double sampleRate, int numChannels, int maxBlockSize)
+    : mode_(mode)
+    , numChannels_(std::max(1, numChannels))
+    , maxBlockSize_(std::max(1, maxBlockSize))
+    , fft_(orderFor(mode, sampleRate))
+{
+    frameSize_ = fft_.getSize();
+    numBins_ = fft_.getNumBins();
+    synthesisHop_ = frameSize_ / (mode == Mode::LowLatency ? 4 : 8);
+
+    // Periodic Hann for analysis and synthesis; the squared windows of
+    // overlapping frames sum to 3/8 * frameSize / hop
+    window_.resize(static_cast<size_t>(frameSize_));
+    for (int n = 0; n < frameSize_; ++n)
+        window_[static_cast<size_t>(n)] = static_cast<float>(0.5 - 0.5 * std::cos(twoPi * n / frameSize_));
+
+    synthesisGain_ = static_cast<float>(synthesisHop_ / (0.375 * frameSize_));
+
+    const auto bins = static_cast<size_t>(numBins_);
+    const auto inputCapacity = static_cast<size_t>(2 * frameSize_ + 2 * maxBlockSize_);
+    const auto outputCapacity = static_cast<size_t>(2 * frameSize_ + 4 * maxBlockSize_ + 2 * synthesisHop_);
+
+    channels_.resize(static_cast<size_t>(numChannels_));
+    for (auto& channel : channels_)
+    {
+        channel.input.resize(inputCapacity);
+        channel.accumulator.resize(static_cast<size_t>(frameSize_));
+        channel.output.resize(outputCapacity);
+        for (auto* spectrum : { &channel.re, &channel.im, &channel.prevRe, &channel.prevIm,
+                                &channel.unitRe, &channel.unitIm, &channel.mag })
+            spectrum->resize(bins);
+    }
+
+    magSum_.resize(bins);
+    prevMagSum_.resize(bins);
+    peaks_.reserve(bins);
+    frame_.resize(static_cast<size_t>(frameSize_));
+    outRe_.resize(bins);
+    outIm_.resize(bins);
+    inputPointers_.resize(static_cast<size_t>(numChannels_));
+    outputPointers_.resize(static_cast<size_t>(numChannels_));
+
+    reset();
+}
+
+void PhaseVocoder::setTimeRatio(double ratio)
+{
+    timeRatio_ = std::clamp(ratio, minRatio, maxRatio);
+}
+
+void PhaseVocoder::setPitchRatio(double ratio)
+{
+    pitchRatio_ = std::clamp(ratio, minRatio, maxRatio);
+}
+
+void PhaseVocoder::reset()
+{
+    for (auto& channel : channels_)
+    {
+        std::fill(channel.accumulator.begin(), channel.accumulator.end(), 0.0f);
+        std::fill(channel.prevRe.begin(), channel.prevRe.end(), 0.0f);
+        std::fill(channel.prevIm.begin(), channel.prevIm.end(), 0.0f);
+        std::fill(channel.unitRe.begin(), channel.unitRe.end(), 0.0f);
+        std::fill(channel.unitIm.begin(), channel.unitIm.end(), 0.0f);
+    }
+
+    std::fill(prevMagSum_.begin(), prevMagSum_.end(), 0.0f);
+
+    inputStart_ = 0;
+    inputCount_ = 0;
+    outputCount_ = 0;
+    hopRemainder_ = 0.0;
+    lastHop_ = synthesisHop_;
+    firstFrame_ = true;
+    primed_ = false;
+    prevRiseFraction_ = 0.0f;
+    prevWasTransient_ = false;
+    numTransients_ = 0;
+    lockedFrames_ = 0;
+    stretchDebt_ = 0.0;
+}
+
+//==============================================================================
+// Streaming
+//==============================================================================
+
+int PhaseVocoder::getSamplesRequired() const
+{
+    return std::max(0, frameSize_ - inputCount_);
+}
+
+void PhaseVocoder::runPendingFrames()
+{
+    const int outputCapacity = static_cast<int>(channels_[0].output.size());
+
+    while (inputCount_ >= frameSize_ && outputCount_ + synthesisHop_ <= outputCapacity)
+        runFrame();
+}
+
+int PhaseVocoder::write(const float* const* input, int numSamples)
+{
+    runPendingFrames();
+
+    const int capacity = static_cast<int>(channels_[0].input.size());
+    if (inputStart_ + inputCount_ + numSamples > capacity && inputStart_ > 0)
+    {
+        for (auto& channel : channels_)
+            std::memmove(channel.input.data(), channel.input.data() + inputStart_,
+                         sizeof(float) * static_cast<size_t>(inputCount_));
+        inputStart_ = 0;
+    }
+
+    const int accepted = std::max(0, std::min(numSamples, capacity - inputStart_ - inputCount_));
+    for (int c = 0; c < numChannels_; ++c)
+        std::memcpy(channels_[static_cast<size_t>(c)].input.data() + inputStart_ + inputCount_,
+                    input[c], sizeof(float) * static_cast<size_t>(accepted));
+
+    inputCount_ += accepted;
+    runPendingFrames();
+    return accepted;
+}
+
+int PhaseVocoder::read(float* const* output, int numSamples)
+{
+    const int count = std::max(0, std::min(numSamples, outputCount_));
+
+    for (int c = 0; c < numChannels_; ++c)
+    {
+        auto& buffer = channels_[static_cast<size_t>(c)].output;
+        std::memcpy(output[c], buffer.data(), sizeof(float) * static_cast<size_t>(count));
+        std::memmove(buffer.data(), buffer.data() + count, sizeof(float) * static_cast<size_t>(outputCount_ - count));
+    }
+
+    outputCount_ -= count;
+    runPendingFrames();
+    return count;
+}
+
+void PhaseVocoder::processBlock(const float* const* input, float* const* output, int numSamples)
+{
+    timeRatio_ = 1.0;
+
+    if (!primed_)
+    {
+        // A frame of silence in front, so every block can be answered in full
+        for (auto& channel : channels_)
+            std::fill(channel.output.begin(), channel.output.begin() + frameSize_, 0.0f);
+        outputCount_ = frameSize_;
+        primed_ = true;
+    }
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize_)
+    {
+        const int count = std::min(maxBlockSize_, numSamples - offset);
+        for (int c = 0; c < numChannels_; ++c)
+        {
+            inputPointers_[static_cast<size_t>(c)] = input[c] + offset;
+            outputPointers_[static_cast<size_t>(c)] = output[c] + offset;
+        }
+
+        write(inputPointers_.data(), count);
+        read(outputPointers_.data(), count);
+    }
+}
+
+//==============================================================================
+// Frames
+//==============================================================================
+
+void PhaseVocoder::runFrame()
+{
+    for (auto& channel : channels_)
+        analyse(channel);
+
+    // A transient locks the hops together until it has left the frame, so
+    // the attack is copied rather than stretched; with phases taken from
+    // the input those frames reconstruct it exactly
+    const bool rising = detectTransient();
+    const bool transient = transientDetection_ && rising && !firstFrame_ && lockedFrames_ == 0;
+    if (transient)
+    {
+        ++numTransients_;
+        lockedFrames_ = frameSize_ / synthesisHop_ + 1;
+    }
+
+    const bool locked = lockedFrames_ > 0;
+    const bool resetPhases = firstFrame_ || transient || (locked && pitchRatio_ == 1.0);
+
+    for (auto& channel : channels_)
+        synthesise(channel, resetPhases);
+
+    outputCount_ += synthesisHop_;
+    firstFrame_ = false;
+
+    // Next analysis hop: the synthesis hop shrunk by the time ratio, with
+    // the fraction carried so the average rate is exact. Stretch skipped
+    // while locked is made up over the following frames
+    const double nominalHop = synthesisHop_ / timeRatio_;
+    double exactHop = nominalHop;
+    if (locked)
+    {
+        exactHop = synthesisHop_;
+        stretchDebt_ += exactHop - nominalHop;
+        --lockedFrames_;
+    }
+    else if (stretchDebt_ != 0.0)
+    {
+        const double repay = std::clamp(stretchDebt_, -0.5 * nominalHop, 0.5 * nominalHop);
+        exactHop -= repay;
+        stretchDebt_ -= repay;
+    }
+
+    exactHop += hopRemainder_;
+    const int hop = std::max(1, static_cast<int>(exactHop));
+    hopRemainder_ = exactHop - hop;
+
+    inputStart_ += hop;
+    inputCount_ -= hop;
+    lastHop_ = hop;
+}
+
+void PhaseVocoder::analyse(Channel& channel)
+{
+    // Zero-phase window: the frame centre is time 0, so a partial has the
+    // same phase in every bin of its main lobe
+    const float* x = channel.input.data() + inputStart_;
+    const int halfFrame = frameSize_ / 2;
+    const float* w = window_.data();
+    float* frame = frame_.data();
+
+    for (int n = 0; n < halfFrame; ++n)
+        frame[n] = x[n + halfFrame] * w[n + halfFrame];
+    for (int n = 0; n < halfFrame; ++n)
+        frame[n + halfFrame] = x[n] * w[n];
+
+    fft_.forward(frame, channel.re.data(), channel.im.data());
+
+    const float* re = channel.re.data();
+    const float* im = channel.im.data();
+    float* mag = channel.mag.data();
+    for (int k = 0; k < numBins_; ++k)
+        mag[k] = std::sqrt(re[k] * re[k] + im[k] * im[k]);
+}
+
+bool PhaseVocoder::detectTransient()
+{
+    std::fill(magSum_.begin(), magSum_.end(), 0.0f);
+    for (const auto& channel : channels_)
+        for (int k = 0; k < numBins_; ++k)
+            magSum_[static_cast<size_t>(k)] += channel.mag[static_cast<size_t>(k)];
+
+    // Rising bins, ignoring those still in the noise floor
+    const float floor = 1.0e-5f * static_cast<float>(frameSize_);
+    int rising = 0;
+    for (int k = 1; k < numBins_ - 1; ++k)
+    {
+        const float now = magSum_[static_cast<size_t>(k)];
+        rising += (now > floor && now > riseFactor * prevMagSum_[static_cast<size_t>(k)]) ? 1 : 0;
+    }
+
+    const float fraction = static_cast<float>(rising) / static_cast<float>(numBins_ - 2);
+    const bool transient = fraction > transientFraction && fraction > prevRiseFraction_ && !prevWasTransient_;
+
+    prevRiseFraction_ = fraction;
+    prevWasTransient_ = transient;
+    std::swap(magSum_, prevMagSum_);
+    return transient;
+}
+
+void PhaseVocoder::synthesise(Channel& channel, bool resetPhases)
+{
+    const float* re = channel.re.data();
+    const float* im = channel.im.data();
+    const float* mag = channel.mag.data();
+    float* outRe = outRe_.data();
+    float* outIm = outIm_.data();
+
+    std::fill(outRe_.begin(), outRe_.end(), 0.0f);
+    std::fill(outIm_.begin(), outIm_.end(), 0.0f);
+
+    // Peaks: local maxima over +-2 bins above the noise floor
+    const float floor = 1.0e-6f * static_cast<float>(frameSize_);
+    peaks_.clear();
+    for (int k = 1; k < numBins_ - 1; ++k)
+    {
+        const float m = mag[k];
+        if (m > floor && m > mag[k - 1] && m >= mag[k + 1]
+            && (k < 2 || m > mag[k - 2]) && (k + 2 >= numBins_ || m >= mag[k + 2]))
+            peaks_.push_back(k);
+    }
+
+    const double binFrequency = twoPi / frameSize_;
+    const bool shifting = pitchRatio_ != 1.0;
+
+    if (peaks_.empty())
+    {
+        if (!shifting)
+        {
+            std::copy(re, re + numBins_, outRe);
+            std::copy(im, im + numBins_, outIm);
+        }
+    }
+
+    for (size_t i = 0; i < peaks_.size(); ++i)
+    {
+        const int peak = peaks_[i];
+
+        // Region of influence: from the quietest bin below the peak to the
+        // quietest bin below the next one
+        int low = 0;
+        if (i > 0)
+        {
+            low = peaks_[i - 1] + 1;
+            for (int k = low; k < peak; ++k)
+                if (mag[k] < mag[low])
+                    low = k;
+        }
+
+        int high = numBins_;
+        if (i + 1 < peaks_.size())
+        {
+            high = peak + 1;
+            for (int k = high; k < peaks_[i + 1]; ++k)
+                if (mag[k] < mag[high])
+                    high = k;
+        }
+
+        // Measured frequency from the phase advance since the last frame
+        double frequency = peak * binFrequency;
+        if (!firstFrame_)
+        {
+            const double cross = static_cast<double>(im[peak]) * channel.prevRe[static_cast<size_t>(peak)]
+                               - static_cast<double>(re[peak]) * channel.prevIm[static_cast<size_t>(peak)];
+            const double dot = static_cast<double>(re[peak]) * channel.prevRe[static_cast<size_t>(peak)]
+                             + static_cast<double>(im[peak]) * channel.prevIm[static_cast<size_t>(peak)];
+            const double deviation = wrapPhase(std::atan2(cross, dot) - frequency * lastHop_);
+            frequency += deviation / lastHop_;
+        }
+
+        const double shiftedFrequency = frequency * pitchRatio_;
+        const int target = shifting ? static_cast<int>(std::lround(shiftedFrequency / binFrequency)) : peak;
+        if (target <= 0 || target >= numBins_)
+            continue;
+
+        // Rotation taking the peak from its analysis phase to its synthesis phase
+        float rotRe = 1.0f, rotIm = 0.0f;
+        const float lastRe = channel.unitRe[static_cast<size_t>(target)];
+        const float lastIm = channel.unitIm[static_cast<size_t>(target)];
+
+        if (!resetPhases && (lastRe != 0.0f || lastIm != 0.0f))
+        {
+            const double advance = shiftedFrequency * synthesisHop_;
+            const float c = static_cast<float>(std::cos(advance));
+            const float s = static_cast<float>(std::sin(advance));
+            const float synthRe = lastRe * c - lastIm * s;
+            const float synthIm = lastRe * s + lastIm * c;
+
+            const float inverseMag = 1.0f / mag[peak];
+            const float peakRe = re[peak] * inverseMag;
+            const float peakIm = im[peak] * inverseMag;
+            rotRe = synthRe * peakRe + synthIm * peakIm;
+            rotIm = synthIm * peakRe - synthRe * peakIm;
+        }
+
+        // Every bin of the region turns with its peak (and moves with it).
+        // The move is whole bins plus a fraction, which is split linearly
+        // with the neighbouring bin so the partial lands on its exact frequency
+        const int shift = target - peak;
+        const float fraction = std::clamp(static_cast<float>((shiftedFrequency - frequency) / binFrequency - shift), -1.0f, 1.0f);
+        const float near = 1.0f - std::abs(fraction);
+        const float far = std::abs(fraction);
+
+        int from = std::max(low, -shift);
+        int to = std::min(high, numBins_ - shift);
+        for (int k = from; k < to; ++k)
+        {
+            outRe[k + shift] += near * (re[k] * rotRe - im[k] * rotIm);
+            outIm[k + shift] += near * (re[k] * rotIm + im[k] * rotRe);
+        }
+
+        if (far > 0.0f)
+        {
+            const int farShift = shift + (fraction > 0.0f ? 1 : -1);
+            from = std::max(low, -farShift);
+            to = std::min(high, numBins_ - farShift);
+            for (int k = from; k < to; ++k)
+            {
+                outRe[k + farShift] += far * (re[k] * rotRe - im[k] * rotIm);
+                outIm[k + farShift] += far * (re[k] * rotIm + im[k] * rotRe);
+            }
+        }
+    }
+
+    // Keep this frame's synthesis phases for the next one
+    float* unitRe = channel.unitRe.data();
+    float* unitIm = channel.unitIm.data();
+    for (int k = 0; k < numBins_; ++k)
+    {
+        const float m = std::sqrt(outRe[k] * outRe[k] + outIm[k] * outIm[k]);
+        const float inverse = m > 0.0f ? 1.0f / m : 0.0f;
+        unitRe[k] = outRe[k] * inverse;
+        unitIm[k] = outIm[k] * inverse;
+    }
+
+    std::swap(channel.re, channel.prevRe);
+    std::swap(channel.im, channel.prevIm);
+
+    // Back to time, undo the zero-phase rotation, window and overlap-add
+    fft_.inverse(outRe, outIm, frame_.data());
+
+    const int halfFrame = frameSize_ / 2;
+    const float* frame = frame_.data();
+    const float* w = window_.data();
+    float* accumulator = channel.accumulator.data();
+    const float gain = synthesisGain_;
+
+    for (int n = 0; n < halfFrame; ++n)
+        accumulator[n] += frame[n + halfFrame] * w[n] * gain;
+    for (int n = 0; n < halfFrame; ++n)
+        accumulator[n + halfFrame] += frame[n] * w[n + halfFrame] * gain;
+
+    std::memcpy(channel.output.data() + outputCount_, accumulator, sizeof(float) * static_cast<size_t>(synthesisHop_));
+    std::memmove(accumulator, accumulator + synthesisHop_, sizeof(float) * static_cast<size_t>(frameSize_ - synthesisHop_));
+    std::fill(accumulator + frameSize_ - synthesisHop_, accumulator + frameSize_, 0.0f);
+}
+
+//==============================================================================
+// Offline
+//==============================================================================
+
+std::vector<float> PhaseVocoder::process(const float* input, int numSamples, double sampleRate,
+                                         double timeRatio, double pitchRatio, Mode mode)
+{
+    constexpr int chunk = 4096;
+    PhaseVocoder vocoder(mode, sampleRate, 1, chunk);
+    vocoder.setTimeRatio(timeRatio);
+    vocoder.setPitchRatio(pitchRatio);
+
+    const double ratio = vocoder.getTimeRatio();
+    const int frame = vocoder.getFrameSize();
+    const auto length = static_cast<size_t>(std::max<long>(0, std::lround(numSamples * ratio)));
+
+    // Two frames of silence in front, so the first real sample lands where
+    // frames fully overlap. A frame centre maps input x to output
+    // (x - frame/2) * ratio + frame/2, which gives the offset to skip
+    const int padding = 2 * frame;
+    const auto skip = static_cast<size_t>(std::lround((padding - frame / 2) * ratio + frame / 2));
+
+    std::vector<float> output;
+    output.reserve(skip + length + static_cast<size_t>(chunk));
+    std::vector<float> feed(static_cast<size_t>(chunk));
+    std::vector<float> pulled(static_cast<size_t>(chunk));
+    long position = -padding;
+
+    while (output.size() < skip + length)
+    {
+        float* pulledChannels[] = { pulled.data() };
+        if (const int count = vocoder.read(pulledChannels, chunk); count > 0)
+        {
+            output.insert(output.end(), pulled.begin(), pulled.begin() + count);
+            continue;
+        }
+
+        // Input, with silence before and after the signal
+        for (int i = 0; i < chunk; ++i)
+        {
+            const long source = position + i;
+            feed[static_cast<size_t>(i)] = source >= 0 && source < numSamples ? input[source] : 0.0f;
+        }
+
+        const float* feedChannels[] = { feed.data() };
+        position += vocoder.write(feedChannels, chunk);
+    }
+
+    return std::vector<float>(output.begin() + static_cast<long>(skip),
+                              output.begin() + static_cast<long>(skip + length));
+}
+
+} // namespace DSP
@@ -0,0 +1,853 @@
+/*
+  ==============================================================================
+
+    PolyphonicTranscriber.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Implementation of the multi-pitch transcriber and its live wrapper
+
+  ==============================================================================
+*/
+
+#include "dsp/PolyphonicTranscriber.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace DSP {
+
+namespace {
+
+// A candidate whose fundamental is weaker than this fraction of its
+// strongest partial is a sub-harmonic of something else
+constexpr float fundamentalFloor = 0.1f;
+
+// Level rise over the settled floor that counts as a new strike (6 dB)
+constexpr float restrikeRatio = 2.0f;
+
+double noteFrequency(double note)
+{
+    return 440.0 * std::pow(2.0, (note - 69.0) / 12.0);
+}
+
+int orderFor(PolyphonicTranscriber::Mode mode, double sampleRate)
+{
+    // 8192 or 32768 at 48 kHz, nearest power of two at other rates
+    const double base = mode == PolyphonicTranscriber::Mode::RealTime ? 8192.0 : 32768.0;
+    const double scaled = base * std::max(8000.0, sampleRate) / 48000.0;
+    return std::max(10, static_cast<int>(std::lround(std::log2(scaled))));
+}
+
+PolyphonicTranscriber::Settings sanitise(PolyphonicTranscriber::Settings settings)
+{
+    settings.minNote = std::clamp(settings.minNote, 12, 120);
+    settings.maxNote = std::clamp(settings.maxNote, settings.minNote, 127);
+    settings.maxPolyphony = std::clamp(settings.maxPolyphony, 1, 16);
+    return settings;
+}
+
+float velocityFor(float level)
+{
+    // -60 dBFS to 0 dBFS
+    return std::clamp(1.0f + 20.0f * std::log10(std::max(level, 1.0e-6f)) / 60.0f, 0.0f, 1.0f);
+}
+
+} // namespace
+
+//==============================================================================
+// Construction
+//==============================================================================
+
+PolyphonicTranscriber::PolyphonicTranscriber(Mode mode, double sampleRate, const Settings& settings)
+    : mode_(mode)
+    , settings_(sanitise(settings))
+    , cq_(sampleRate, orderFor(mode, sampleRate),
+          noteFrequency(settings_.minNote - 1.0 / binsPerSemitone),
+          noteFrequency(settings_.maxNote + 2.0 / binsPerSemitone) * numHarmonics,
+          12 * binsPerSemitone)
+{
+    const int frameSize = cq_.getFrameSize();
+    hop_ = frameSize / (mode == Mode::RealTime ? 16 : 128);
+    minOnFrames_ = mode == Mode::RealTime ? 2 : 3;
+    minOffFrames_ = mode == Mode::RealTime ? 3 : 4;
+
+    numCandidates_ = std::min(cq_.getNumBins(), (settings_.maxNote - settings_.minNote + 1) * binsPerSemitone);
+
+    for (int h = 0; h < numHarmonics; ++h)
+    {
+        harmonicOffsets_[static_cast<size_t>(h)] = static_cast<int>(std::lround(12 * binsPerSemitone * std::log2(h + 1.0)));
+        harmonicWeights_[static_cast<size_t>(h)] = 1.0f / std::sqrt(static_cast<float>(h + 1));
+    }
+
+    history_.resize(static_cast<size_t>(frameSize));
+    spectrum_.resize(static_cast<size_t>(cq_.getNumBins()));
+    residual_.resize(static_cast<size_t>(cq_.getNumBins()));
+    estimates_.reserve(static_cast<size_t>(settings_.maxPolyphony));
+    levels_.resize(static_cast<size_t>(128 * historyLength));
+
+    for (int note = settings_.minNote; note <= settings_.maxNote; ++note)
+    {
+        const int length = cq_.getKernelLength(std::min(cq_.getNumBins() - 1, centreBin(note)));
+        kernelLengths_[static_cast<size_t>(note)] = length;
+        settleFrames_[static_cast<size_t>(note)] = std::min(historyLength / 2, (length + hop_ - 1) / hop_);
+    }
+
+    for (int note = settings_.minNote; note <= settings_.maxNote; ++note)
+    {
+        const int lowest = std::max(settings_.minNote, note - 36);
+        const int extra = std::max(0, kernelLengths_[static_cast<size_t>(lowest)] - kernelLengths_[static_cast<size_t>(note)]);
+        confirmFrames_[static_cast<size_t>(note)] = minOnFrames_ + (extra / 2 + hop_ - 1) / hop_;
+    }
+}
+
+void PolyphonicTranscriber::reset()
+{
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    pending_ = 0;
+    position_ = 0;
+    estimates_.clear();
+    tracks_.fill(NoteTrack {});
+    std::fill(levels_.begin(), levels_.end(), 0.0f);
+    framePositions_.fill(0);
+    frameIndex_ = -1;
+}
+
+bool PolyphonicTranscriber::isNoteActive(int note) const
+{
+    return note >= 0 && note < 128 && tracks_[static_cast<size_t>(note)].active;
+}
+
+//==============================================================================
+// Streaming
+//==============================================================================
+
+void PolyphonicTranscriber::process(const float* input, int numSamples, std::vector<NoteEvent>& events)
+{
+    const int frameSize = cq_.getFrameSize();
+
+    while (numSamples > 0)
+    {
+        const int count = std::min(numSamples, hop_ - pending_);
+        std::copy(input, input + count, history_.begin() + (frameSize - hop_ + pending_));
+
+        input += count;
+        numSamples -= count;
+        pending_ += count;
+        position_ += count;
+
+        if (pending_ == hop_)
+        {
+            runFrame(events);
+            std::copy(history_.begin() + hop_, history_.end(), history_.begin());
+            pending_ = 0;
+        }
+    }
+}
+
+void PolyphonicTranscriber::skip(int numSamples)
+{
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    pending_ = 0;
+    position_ += std::max(0, numSamples);
+}
+
+void PolyphonicTranscriber::finish(std::vector<NoteEvent>& events)
+{
+    for (int note = 0; note < 128; ++note)
+    {
+        auto& track = tracks_[static_cast<size_t>(note)];
+        if (track.active)
+            endNote(track, note, position_, events);
+        track.framesOn = 0;
+    }
+}
+
+void PolyphonicTranscriber::runFrame(std::vector<NoteEvent>& events)
+{
+    ++frameIndex_;
+    framePositions_[static_cast<size_t>(frameIndex_ % historyLength)] = position_;
+
+    cq_.process(history_.data(), spectrum_.data());
+    estimatePitches();
+    trackNotes(events);
+}
+
+//==============================================================================
+// Multi-pitch Estimation
+//==============================================================================
+
+int PolyphonicTranscriber::noteOf(double bin) const
+{
+    return settings_.minNote + static_cast<int>(std::lround((bin - 1.0) / binsPerSemitone));
+}
+
+float PolyphonicTranscriber::salience(int bin) const
+{
+    const int numBins = cq_.getNumBins();
+    float sum = 0.0f, strongest = 0.0f, fundamental = 0.0f;
+
+    for (int h = 0; h < numHarmonics; ++h)
+    {
+        const int at = bin + harmonicOffsets_[static_cast<size_t>(h)];
+        if (at >= numBins)
+            break;
+
+        // A bin either side allows for inharmonicity and tuning
+        float partial = residual_[static_cast<size_t>(at)];
+        if (at > 0)
+            partial = std::max(partial, residual_[static_cast<size_t>(at - 1)]);
+        if (at + 1 < numBins)
+            partial = std::max(partial, residual_[static_cast<size_t>(at + 1)]);
+
+        if (h == 0)
+            fundamental = partial;
+
+        sum += harmonicWeights_[static_cast<size_t>(h)] * partial;
+        strongest = std::max(strongest, partial);
+    }
+
+    if (fundamental < fundamentalFloor * strongest)
+        return 0.0f;
+
+    // The fundamental must be a peak of the spectrum, not the skirt of one
+    const int width = cq_.getPeakWidth(bin);
+    float local = 0.0f, around = 0.0f;
+    for (int i = std::max(0, bin - width); i <= std::min(numBins - 1, bin + width); ++i)
+    {
+        const float value = spectrum_[static_cast<size_t>(i)];
+        if (std::abs(i - bin) <= 1)
+            local = std::max(local, value);
+        else
+            around = std::max(around, value);
+    }
+
+    return local >= around ? sum : 0.0f;
+}
+
+float PolyphonicTranscriber::prominence(int bin) const
+{
+    const int numBins = cq_.getNumBins();
+    float weighted = 0.0f, energy = 0.0f;
+
+    for (int h = 0; h < numHarmonics; ++h)
+    {
+        const int at = bin + harmonicOffsets_[static_cast<size_t>(h)];
+        if (at >= numBins)
+            break;
+
+        int peak = at;
+        for (int i = std::max(0, at - 1); i <= std::min(numBins - 1, at + 1); ++i)
+            if (spectrum_[static_cast<size_t>(i)] > spectrum_[static_cast<size_t>(peak)])
+                peak = i;
+
+        // Mean level just outside the main lobe on each side; the quieter
+        // side, in case the other holds a neighbouring note
+        const int width = cq_.getPeakWidth(peak);
+        float sides[2] = { 0.0f, 0.0f };
+        int counts[2] = { 0, 0 };
+        for (int offset = width + 1; offset <= 2 * width + 3; ++offset)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                const int i = side == 0 ? peak - offset : peak + offset;
+                if (i < 0 || i >= numBins)
+                    continue;
+                sides[side] += spectrum_[static_cast<size_t>(i)];
+                ++counts[side];
+            }
+        }
+
+        float surround = 0.0f;
+        if (counts[0] > 0 && counts[1] > 0)
+            surround = std::min(sides[0] / static_cast<float>(counts[0]), sides[1] / static_cast<float>(counts[1]));
+        else if (counts[0] + counts[1] > 0)
+            surround = (sides[0] + sides[1]) / static_cast<float>(counts[0] + counts[1]);
+
+        const float partial = spectrum_[static_cast<size_t>(peak)];
+        if (partial <= 0.0f)
+            continue;
+
+        weighted += partial * partial * std::max(0.0f, (partial - surround) / (partial + surround));
+        energy += partial * partial;
+    }
+
+    return energy > 0.0f ? weighted / energy : 0.0f;
+}
+
+void PolyphonicTranscriber::cancelHarmonics(int bin)
+{
+    const int numBins = cq_.getNumBins();
+    std::array<int, numHarmonics> peakBins {};
+    std::array<float, numHarmonics> partials {};
+    int numPartials = 0;
+
+    for (int h = 0; h < numHarmonics; ++h, ++numPartials)
+    {
+        const int at = bin + harmonicOffsets_[static_cast<size_t>(h)];
+        if (at >= numBins)
+            break;
+
+        int peak = at;
+        for (int i = std::max(0, at - 1); i <= std::min(numBins - 1, at + 1); ++i)
+            if (residual_[static_cast<size_t>(i)] > residual_[static_cast<size_t>(peak)])
+                peak = i;
+
+        peakBins[static_cast<size_t>(h)] = peak;
+        partials[static_cast<size_t>(h)] = residual_[static_cast<size_t>(peak)];
+    }
+
+    for (int h = 0; h < numPartials; ++h)
+    {
+        const float partial = partials[static_cast<size_t>(h)];
+        if (partial <= 0.0f)
+            continue;
+
+        // The fundamental is the note's own; an overtone keeps whatever
+        // stands out from its neighbours, which belongs to another note
+        float amount = partial;
+        if (h > 0)
+        {
+            const int last = std::min(numPartials - 1, h + 1);
+            float sum = 0.0f;
+            for (int i = h - 1; i <= last; ++i)
+                sum += partials[static_cast<size_t>(i)];
+            amount = std::min(partial, sum / static_cast<float>(last - h + 2));
+        }
+
+        // Scale the partial's whole main lobe down
+        const float gain = (partial - amount) / partial;
+        const int peak = peakBins[static_cast<size_t>(h)];
+        const int width = cq_.getPeakWidth(peak);
+
+        for (int i = std::max(0, peak - width); i <= std::min(numBins - 1, peak + width); ++i)
+            residual_[static_cast<size_t>(i)] *= gain;
+    }
+}
+
+void PolyphonicTranscriber::estimatePitches()
+{
+    estimates_.clear();
+
+    const int numBins = cq_.getNumBins();
+    if (*std::max_element(spectrum_.begin(), spectrum_.end()) < settings_.silenceThreshold)
+        return;
+
+    std::copy(spectrum_.begin(), spectrum_.end(), residual_.begin());
+
+    std::array<bool, 128> taken {};
+    float firstSalience = 0.0f;
+
+    for (int i = 0; i < settings_.maxPolyphony; ++i)
+    {
+        int best = -1;
+        float bestSalience = 0.0f;
+
+        for (int bin = 0; bin < numCandidates_; ++bin)
+        {
+            const int note = noteOf(bin);
+            if (note > settings_.maxNote || taken[static_cast<size_t>(note)])
+                continue;
+
+            const float value = salience(bin);
+            if (value > bestSalience)
+            {
+                best = bin;
+                bestSalience = value;
+            }
+        }
+
+        if (best < 0 || bestSalience < settings_.silenceThreshold
+            || bestSalience < settings_.relativeSalience * firstSalience)
+            break;
+
+        if (i == 0)
+            firstSalience = bestSalience;
+
+        // Tuning from the fundamental's peak, interpolated
+        int peak = best;
+        for (int bin = std::max(0, best - 1); bin <= std::min(numBins - 1, best + 1); ++bin)
+            if (spectrum_[static_cast<size_t>(bin)] > spectrum_[static_cast<size_t>(peak)])
+                peak = bin;
+
+        double position = peak;
+        if (peak > 0 && peak + 1 < numBins)
+        {
+            const double left = spectrum_[static_cast<size_t>(peak - 1)];
+            const double centre = spectrum_[static_cast<size_t>(peak)];
+            const double right = spectrum_[static_cast<size_t>(peak + 1)];
+            const double curvature = left - 2.0 * centre + right;
+            if (curvature < 0.0)
+                position += 0.5 * (left - right) / curvature;
+        }
+
+        const int note = noteOf(best);
+        taken[static_cast<size_t>(note)] = true;
+
+        PitchEstimate estimate;
+        estimate.note = note;
+        estimate.cents = static_cast<float>(std::clamp(
+            ((position - 1.0) / binsPerSemitone - (note - settings_.minNote)) * 100.0, -50.0, 50.0));
+        estimate.level = spectrum_[static_cast<size_t>(peak)];
+        estimate.confidence = prominence(peak);
+
+        // Salience is flat across the tolerance; the harmonics line up
+        // from where the fundamental actually peaks. A pitch too unclear
+        // to keep is still cancelled, so its partials are not reused.
+        cancelHarmonics(peak);
+        if (estimate.confidence >= settings_.minConfidence)
+            estimates_.push_back(estimate);
+    }
+}
+
+//==============================================================================
+// Note Tracking
+//==============================================================================
+
+float& PolyphonicTranscriber::levelAt(int note, int64_t frame)
+{
+    return levels_[static_cast<size_t>(note) * historyLength + static_cast<size_t>(frame % historyLength)];
+}
+
+int64_t PolyphonicTranscriber::framePosition(int64_t frame) const
+{
+    return framePositions_[static_cast<size_t>(frame % historyLength)];
+}
+
+int64_t PolyphonicTranscriber::crossing(int note, int64_t from, int64_t to, float threshold, bool rising)
+{
+    from = std::max({ from, frameIndex_ - historyLength + 1, int64_t { 0 } });
+
+    for (int64_t frame = from + 1; frame <= to; ++frame)
+    {
+        const float before = levelAt(note, frame - 1);
+        const float after = levelAt(note, frame);
+        const bool crossed = rising ? (before < threshold && after >= threshold)
+                                    : (before >= threshold && after < threshold);
+        if (!crossed)
+            continue;
+
+        const double fraction = (threshold - before) / static_cast<double>(after - before);
+        const auto start = framePosition(frame - 1);
+        const auto position = start + static_cast<int64_t>(fraction * static_cast<double>(framePosition(frame) - start));
+        return std::max<int64_t>(0, position - kernelLengths_[static_cast<size_t>(note)] / 2);
+    }
+
+    return -1;
+}
+
+void PolyphonicTranscriber::beginOnset(NoteTrack& track, float baseLevel)
+{
+    track.firstFrame = frameIndex_;
+    track.baseLevel = baseLevel;
+    track.peakLevel = 0.0f;
+    track.confidenceSum = 0.0f;
+    track.centsSum = 0.0f;
+    track.numFrames = 0;
+    track.releaseFrame = -1;
+}
+
+void PolyphonicTranscriber::accumulate(NoteTrack& track, const PitchEstimate& estimate)
+{
+    track.peakLevel = std::max(track.peakLevel, estimate.level);
+    track.confidenceSum += estimate.confidence;
+    track.centsSum += estimate.cents;
+    ++track.numFrames;
+}
+
+void PolyphonicTranscriber::announce(NoteTrack& track, int note, std::vector<NoteEvent>& events)
+{
+    // An attack reads half its final level half a kernel after it starts
+    const float threshold = track.baseLevel + 0.5f * (track.peakLevel - track.baseLevel);
+    track.start = crossing(note, track.firstFrame - 1, frameIndex_, threshold, true);
+    if (track.start < 0)
+        track.start = std::max<int64_t>(0, framePosition(track.firstFrame) - kernelLengths_[static_cast<size_t>(note)] / 2);
+
+    if (track.restruck)
+    {
+        track.restruckOff.samplePosition = track.start;
+        events.push_back(track.restruckOff);
+        track.restruck = false;
+    }
+
+    NoteEvent event;
+    event.type = NoteEvent::Type::NoteOn;
+    event.note = note;
+    event.samplePosition = track.start;
+    event.velocity = velocityFor(track.peakLevel);
+    event.confidence = track.confidenceSum / static_cast<float>(std::max(1, track.numFrames));
+    event.cents = track.centsSum / static_cast<float>(std::max(1, track.numFrames));
+    events.push_back(event);
+
+    track.announced = true;
+}
+
+void PolyphonicTranscriber::endNote(NoteTrack& track, int note, int64_t position, std::vector<NoteEvent>& events)
+{
+    if (!track.announced)
+        announce(track, note, events);
+
+    NoteEvent event;
+    event.type = NoteEvent::Type::NoteOff;
+    event.note = note;
+    event.samplePosition = std::max(position, track.start);
+    event.velocity = velocityFor(track.peakLevel);
+    event.confidence = track.confidenceSum / static_cast<float>(std::max(1, track.numFrames));
+    event.cents = track.centsSum / static_cast<float>(std::max(1, track.numFrames));
+    events.push_back(event);
+
+    track.active = false;
+    track.announced = false;
+    track.framesOn = 0;
+    track.framesOff = 0;
+}
+
+void PolyphonicTranscriber::trackNotes(std::vector<NoteEvent>& events)
+{
+    detected_.fill(nullptr);
+    for (auto& estimate : estimates_)
+        detected_[static_cast<size_t>(estimate.note)] = &estimate;
+
+    for (int note = settings_.minNote; note <= settings_.maxNote; ++note)
+    {
+        auto& track = tracks_[static_cast<size_t>(note)];
+        const PitchEstimate* estimate = detected_[static_cast<size_t>(note)];
+        const auto index = static_cast<size_t>(note);
+
+        levelAt(note, frameIndex_) = estimate != nullptr ? estimate->level : 0.0f;
+
+        if (estimate == nullptr)
+        {
+            if (!track.active)
+            {
+                track.framesOn = 0;
+                continue;
+            }
+
+            // Ends where the level fell through half, if it was seen to
+            if (++track.framesOff == 1)
+            {
+                const bool recent = track.releaseFrame >= frameIndex_ - settleFrames_[index] - 2;
+                track.end = recent ? track.releasePosition
+                                   : std::max<int64_t>(0, position_ - kernelLengths_[index] / 2);
+            }
+
+            if (track.framesOff >= minOffFrames_)
+                endNote(track, note, track.end, events);
+            continue;
+        }
+
+        track.framesOff = 0;
+
+        if (!track.active)
+        {
+            if (track.framesOn++ == 0)
+                beginOnset(track, 0.0f);
+            accumulate(track, *estimate);
+
+            // A high pitch may be the overtone of a note whose longer kernel
+            // has not filled yet: wait until a fundamental up to three
+            // octaves down would have shown
+            if (track.framesOn >= confirmFrames_[index])
+            {
+                track.active = true;
+                track.age = 0;
+                if (mode_ == Mode::RealTime)
+                    announce(track, note, events);
+            }
+            continue;
+        }
+
+        accumulate(track, *estimate);
+        ++track.age;
+
+        if (!track.announced && track.age >= settleFrames_[index])
+            announce(track, note, events);
+
+        // The level rises while the attack fills the kernel; after that a
+        // jump over the lowest level since is a new strike, and a fall to
+        // half of the level a kernel earlier is the release
+        if (track.age < settleFrames_[index])
+            continue;
+
+        const int64_t earlier = frameIndex_ - settleFrames_[index];
+        const float release = 0.5f * levelAt(note, earlier);
+        if (estimate->level < release && levelAt(note, frameIndex_ - 1) >= 0.5f * levelAt(note, earlier - 1))
+        {
+            const int64_t position = crossing(note, frameIndex_ - 1, frameIndex_, release, false);
+            if (position >= 0)
+            {
+                track.releaseFrame = frameIndex_;
+                track.releasePosition = position;
+            }
+        }
+
+        if (track.age == settleFrames_[index])
+        {
+            track.floorLevel = estimate->level;
+        }
+        else if (estimate->level > restrikeRatio * track.floorLevel)
+        {
+            if (!track.announced)
+                announce(track, note, events);
+
+            track.restruckOff = NoteEvent {};
+            track.restruckOff.type = NoteEvent::Type::NoteOff;
+            track.restruckOff.note = note;
+            track.restruckOff.velocity = velocityFor(track.peakLevel);
+            track.restruckOff.confidence = track.confidenceSum / static_cast<float>(track.numFrames);
+            track.restruckOff.cents = track.centsSum / static_cast<float>(track.numFrames);
+            track.restruck = true;
+
+            beginOnset(track, track.floorLevel);
+            accumulate(track, *estimate);
+            track.announced = false;
+            track.age = 0;
+            if (mode_ == Mode::RealTime)
+                announce(track, note, events);
+        }
+        else
+        {
+            track.floorLevel = std::min(track.floorLevel, estimate->level);
+        }
+    }
+}
+
+//==============================================================================
+// Offline
+//==============================================================================
+
+std::vector<TranscribedNote> PolyphonicTranscriber::transcribe(const float* input, int numSamples,
+                                                               double sampleRate, const Settings& settings)
+{
+    PolyphonicTranscriber transcriber(Mode::Offline, sampleRate, settings);
+    std::vector<NoteEvent> events;
+
+    transcriber.process(input, numSamples, events);
+
+    // Let the frames run past the end so the last notes end where they
+    // fade, not at the cut
+    const std::vector<float> tail(static_cast<size_t>(transcriber.getFrameSize()), 0.0f);
+    transcriber.process(tail.data(), static_cast<int>(tail.size()), events);
+    transcriber.finish(events);
+
+    std::vector<TranscribedNote> notes;
+    std::array<int, 128> open;
+    open.fill(-1);
+
+    for (const auto& event : events)
+    {
+        auto& index = open[static_cast<size_t>(event.note)];
+
+        if (event.type == NoteEvent::Type::NoteOn)
+        {
+            TranscribedNote note;
+            note.note = event.note;
+            note.start = event.samplePosition;
+            note.velocity = event.velocity;
+            index = static_cast<int>(notes.size());
+            notes.push_back(note);
+        }
+        else if (index >= 0)
+        {
+            auto& note = notes[static_cast<size_t>(index)];
+            note.end = std::min<int64_t>(event.samplePosition, numSamples);
+            note.confidence = event.confidence;
+            note.cents = event.cents;
+            index = -1;
+        }
+    }
+
+    std::stable_sort(notes.begin(), notes.end(), [](const TranscribedNote& a, const TranscribedNote& b)
+    {
+        return a.start != b.start ? a.start < b.start : a.note < b.note;
+    });
+    return notes;
+}
+
+//==============================================================================
+// Realtime Transcriber
+//==============================================================================
+
+RealtimeTranscriber::RealtimeTranscriber(double sampleRate, const PolyphonicTranscriber::Settings& settings)
+    : transcriber_(PolyphonicTranscriber::Mode::RealTime, sampleRate, settings)
+    , maxBacklog_(8 * transcriber_.getHopSize())
+{
+    // A second of input, and always room for the backlog and a few blocks
+    int64_t capacity = 1;
+    while (capacity < std::max<int64_t>(static_cast<int64_t>(sampleRate), 4 * maxBacklog_))
+        capacity *= 2;
+
+    input_.resize(static_cast<size_t>(capacity));
+    inputMask_ = capacity - 1;
+
+    eventQueue_.resize(static_cast<size_t>(eventCapacity));
+    chunk_.resize(static_cast<size_t>(transcriber_.getHopSize()));
+    events_.reserve(256);
+}
+
+RealtimeTranscriber::~RealtimeTranscriber()
+{
+    stop();
+}
+
+void RealtimeTranscriber::start()
+{
+    if (running_.load(std::memory_order_acquire))
+        return;
+
+    transcriber_.reset();
+    for (auto& bits : sounding_)
+        bits.store(0, std::memory_order_relaxed);
+
+    // Anything pushed before this start is stale
+    inputRead_.store(inputWrite_.load(std::memory_order_acquire), std::memory_order_release);
+
+    running_.store(true, std::memory_order_release);
+    worker_ = std::thread([this] { workerLoop(); });
+}
+
+void RealtimeTranscriber::stop()
+{
+    if (!running_.load(std::memory_order_acquire))
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.store(false, std::memory_order_release);
+    }
+    wake_.notify_all();
+    worker_.join();
+
+    // The worker is gone, so this thread may produce events
+    transcriber_.finish(events_);
+    publish();
+}
+
+void RealtimeTranscriber::pushAudio(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (!running_.load(std::memory_order_acquire) || numChannels <= 0 || numSamples <= 0)
+        return;
+
+    const int64_t write = inputWrite_.load(std::memory_order_relaxed);
+    const int64_t space = inputMask_ + 1 - (write - inputRead_.load(std::memory_order_acquire));
+    const int count = static_cast<int>(std::min<int64_t>(numSamples, space));
+
+    if (count < numSamples)
+        droppedSamples_.fetch_add(static_cast<uint32_t>(numSamples - count), std::memory_order_relaxed);
+
+    const float scale = 1.0f / static_cast<float>(numChannels);
+    for (int i = 0; i < count; ++i)
+    {
+        float sum = 0.0f;
+        for (int c = 0; c < numChannels; ++c)
+            sum += channels[c][i];
+        input_[static_cast<size_t>((write + i) & inputMask_)] = sum * scale;
+    }
+
+    inputWrite_.store(write + count, std::memory_order_release);
+}
+
+int RealtimeTranscriber::readEvents(NoteEvent* events, int maxEvents) noexcept
+{
+    const int64_t read = eventRead_.load(std::memory_order_relaxed);
+    const int64_t available = eventWrite_.load(std::memory_order_acquire) - read;
+    const int count = static_cast<int>(std::min<int64_t>(available, std::max(0, maxEvents)));
+
+    for (int i = 0; i < count; ++i)
+        events[i] = eventQueue_[static_cast<size_t>((read + i) % eventCapacity)];
+
+    eventRead_.store(read + count, std::memory_order_release);
+    return count;
+}
+
+bool RealtimeTranscriber::isNoteSounding(int note) const noexcept
+{
+    if (note < 0 || note >= 128)
+        return false;
+
+    const auto bits = sounding_[static_cast<size_t>(note / 64)].load(std::memory_order_acquire);
+    return (bits >> (note % 64)) & 1u;
+}
+
+int RealtimeTranscriber::getSoundingNotes(int* notes, int maxNotes) const noexcept
+{
+    int count = 0;
+    for (size_t word = 0; word < sounding_.size(); ++word)
+    {
+        const auto bits = sounding_[word].load(std::memory_order_acquire);
+        for (int bit = 0; bit < 64 && count < maxNotes; ++bit)
+            if ((bits >> bit) & 1u)
+                notes[count++] = static_cast<int>(word) * 64 + bit;
+    }
+    return count;
+}
+
+void RealtimeTranscriber::workerLoop()
+{
+    const auto hopTime = std::chrono::duration<double>(transcriber_.getHopSize() / transcriber_.getSampleRate());
+    const auto interval = std::max(std::chrono::microseconds(500),
+                                   std::chrono::duration_cast<std::chrono::microseconds>(hopTime / 2));
+
+    while (running_.load(std::memory_order_acquire))
+    {
+        drainInput();
+        publish();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait_for(lock, interval, [this] { return !running_.load(std::memory_order_acquire); });
+    }
+}
+
+void RealtimeTranscriber::drainInput()
+{
+    const int64_t write = inputWrite_.load(std::memory_order_acquire);
+    int64_t read = inputRead_.load(std::memory_order_relaxed);
+
+    // Too far behind: jump to the newest hop rather than add latency
+    if (write - read > maxBacklog_)
+    {
+        const int64_t gap = write - read - transcriber_.getHopSize();
+        transcriber_.skip(static_cast<int>(gap));
+        skippedSamples_.fetch_add(static_cast<uint32_t>(gap), std::memory_order_relaxed);
+        read += gap;
+    }
+
+    while (read < write)
+    {
+        const int count = static_cast<int>(std::min<int64_t>(write - read, static_cast<int64_t>(chunk_.size())));
+        for (int i = 0; i < count; ++i)
+            chunk_[static_cast<size_t>(i)] = input_[static_cast<size_t>((read + i) & inputMask_)];
+
+        read += count;
+        inputRead_.store(read, std::memory_order_release);
+        transcriber_.process(chunk_.data(), count, events_);
+    }
+}
+
+void RealtimeTranscriber::publish()
+{
+    for (const auto& event : events_)
+    {
+        const int64_t write = eventWrite_.load(std::memory_order_relaxed);
+        if (write - eventRead_.load(std::memory_order_acquire) >= eventCapacity)
+        {
+            droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        eventQueue_[static_cast<size_t>(write % eventCapacity)] = event;
+        eventWrite_.store(write + 1, std::memory_order_release);
+    }
+    events_.clear();
+
+    std::array<uint64_t, 2> bits {};
+    for (int note = 0; note < 128; ++note)
+        if (transcriber_.isNoteActive(note))
+            bits[static_cast<size_t>(note / 64)] |= uint64_t { 1 } << (note % 64);
+
+    sounding_[0].store(bits[0], std::memory_order_release);
+    sounding_[1].store(bits[1], std::memory_order_release);
+}
+
+} // namespace DSP
@@ -0,0 +1,356 @@
+/*
+  ==============================================================================
+
+    PolyphonicTranscriber.h
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Polyphonic audio-to-note transcription for the pure-DSP code
+    - Constant-Q front end, three bins per semitone
+    - Multi-pitch salience with iterative harmonic cancellation
+    - Note tracking with onset, re-articulation and offset detection
+    - Real-time mode on a worker thread at bounded latency, and an
+      offline mode for whole samples
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "dsp/ConstantQ.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DSP {
+
+//==============================================================================
+// Results
+//==============================================================================
+
+/** Pitch found in one analysis frame */
+struct PitchEstimate
+{
+    int note = 0;                   // MIDI note
+    float cents = 0.0f;             // Tuning against equal temperament, -50..50
+    float confidence = 0.0f;        // 0-1: how much of the frame the pitch explains
+    float level = 0.0f;             // Amplitude of the fundamental
+};
+
+/** Start or end of a transcribed note */
+struct NoteEvent
+{
+    enum class Type
+    {
+        NoteOn,
+        NoteOff
+    };
+
+    Type type = Type::NoteOn;
+    int note = 0;
+    int64_t samplePosition = 0;     // Estimated onset or offset in the input stream
+    float velocity = 0.0f;          // 0-1, from the level at the onset
+    float confidence = 0.0f;        // Mean frame confidence of the note so far
+    float cents = 0.0f;             // Mean tuning of the note so far
+};
+
+/** A whole note from offline transcription */
+struct TranscribedNote
+{
+    int note = 0;
+    int64_t start = 0;              // Samples
+    int64_t end = 0;
+    float velocity = 0.0f;
+    float confidence = 0.0f;
+    float cents = 0.0f;
+};
+
+/** Range and thresholds of a transcriber */
+struct TranscriptionSettings
+{
+    int minNote = 40;                   // E2
+    int maxNote = 96;                   // C7
+    int maxPolyphony = 6;
+    float silenceThreshold = 0.001f;    // Frames quieter than this (amplitude) have no pitch
+    float relativeSalience = 0.2f;      // Further pitches need this fraction of the first's salience
+    float minConfidence = 0.5f;         // Frame pitches less clear than this are dropped
+};
+
+//==============================================================================
+// Polyphonic Transcriber
+//==============================================================================
+
+/**
+ * Streaming multi-pitch transcription
+ *
+ * Every hop, a constant-Q spectrum of the newest frame is searched for
+ * pitches. A candidate's salience sums its first eight harmonics (each
+ * within a bin either side, weighted down with harmonic number), and the
+ * candidate must have a fundamental. The most salient candidate is taken
+ * and its harmonics cancelled from the spectrum: each partial is reduced
+ * by at most the mean of its neighbouring partials (spectral smoothness),
+ * so a partial shared with another note keeps that note's share. The
+ * search repeats on what is left, up to maxPolyphony pitches, while
+ * candidates stay within relativeSalience of the first.
+ *
+ * A pitch's confidence is how far its partials stand above the spectrum
+ * just outside their main lobes (energy weighted): clean tones score near
+ * 1, chance peaks in noise 0.3 to 0.5.
+ *
+ * Notes start after minOnFrames frames with the pitch and end after
+ * minOffFrames without it. A note whose level jumps more than 6 dB above
+ * its lowest level since it settled is struck again: it ends and a new
+ * one starts. Events are placed half a kernel length before the frame
+ * that saw them, which is about where the change crossed the kernel.
+ *
+ *   Mode       Frame (48 kHz)   Hop    On / off frames
+ *   RealTime   8192             512    2 / 3
+ *   Offline    32768            256    3 / 4
+ *
+ * Frame sizes scale with the sample rate. Kernels end at the frame end,
+ * so a note is seen within its own kernel length: high notes in a few
+ * milliseconds, the lowest within the frame. In RealTime mode kernels
+ * below about 300 Hz are cut to the frame, which widens those bins
+ * (neighbouring bass semitones can merge).
+ *
+ * Construct (allocates) off the audio thread. process() does not lock;
+ * it only allocates if events outgrows its capacity. Not thread safe: see
+ * RealtimeTranscriber for live input.
+ */
+class PolyphonicTranscriber
+{
+public:
+    enum class Mode
+    {
+        RealTime,       // Short frames and hops: live input
+        Offline         // Long frames, finer hops: sample analysis
+    };
+
+    using Settings = TranscriptionSettings;
+
+    static constexpr int binsPerSemitone = 3;
+    static constexpr int numHarmonics = 8;
+
+    PolyphonicTranscriber(Mode mode, double sampleRate, const Settings& settings = {});
+
+    PolyphonicTranscriber(const PolyphonicTranscriber&) = delete;
+    PolyphonicTranscriber& operator=(const PolyphonicTranscriber&) = delete;
+
+    Mode getMode() const { return mode_; }
+    const Settings& getSettings() const { return settings_; }
+    int getFrameSize() const { return cq_.getFrameSize(); }
+    int getHopSize() const { return hop_; }
+    double getSampleRate() const { return cq_.getSampleRate(); }
+
+    /** Worst case from a note starting to its NoteOn: the frame plus the frames needed to confirm it */
+    int getLatency() const { return getFrameSize() + minOnFrames_ * hop_; }
+
+    /** Samples consumed since construction or reset() */
+    int64_t getPosition() const { return position_; }
+
+    /** Clear all signal and note state; the position restarts at 0 */
+    void reset();
+
+    //==============================================================================
+    // Streaming
+    //==============================================================================
+
+    /** Analyse mono input, appending events for every frame it completes */
+    void process(const float* input, int numSamples, std::vector<NoteEvent>& events);
+
+    /**
+     * Leave out numSamples of input (a gap in the stream): the position
+     * moves on and analysis restarts from silence
+     */
+    void skip(int numSamples);
+
+    /** End every sounding note at the current position */
+    void finish(std::vector<NoteEvent>& events);
+
+    /** Pitches of the last frame, most salient first */
+    const std::vector<PitchEstimate>& getLastEstimates() const { return estimates_; }
+
+    bool isNoteActive(int note) const;
+
+    //==============================================================================
+    // Offline
+    //==============================================================================
+
+    /** Transcribe a whole mono signal in Offline mode, notes in start order */
+    static std::vector<TranscribedNote> transcribe(const float* input, int numSamples, double sampleRate,
+                                                   const Settings& settings = {});
+
+private:
+    static constexpr int historyLength = 256;  // Frames of level kept per note
+
+    struct NoteTrack
+    {
+        bool active = false;
+        bool announced = false;         // NoteOn sent; Offline holds it until the level settles
+        int framesOn = 0;               // Frames with the pitch before the note started
+        int framesOff = 0;              // Frames without it since it was last seen
+        int age = 0;                    // Frames since the note started
+        int64_t firstFrame = 0;         // Frame the onset was first seen in
+        float baseLevel = 0.0f;         // Level the onset rose from
+        int64_t start = 0;
+        int64_t end = 0;                // Where the note stops if it stays missing
+        int64_t releaseFrame = -1;      // Last frame the level fell to half of a kernel earlier
+        int64_t releasePosition = 0;
+        float peakLevel = 0.0f;
+        float floorLevel = 0.0f;        // Lowest level since the note settled
+        float confidenceSum = 0.0f;
+        float centsSum = 0.0f;
+        int numFrames = 0;
+        bool restruck = false;          // The last note ends where this onset starts
+        NoteEvent restruckOff;
+    };
+
+    void runFrame(std::vector<NoteEvent>& events);
+    void estimatePitches();
+    float salience(int bin) const;
+    float prominence(int bin) const;
+    void cancelHarmonics(int bin);
+    void trackNotes(std::vector<NoteEvent>& events);
+
+    int noteOf(double bin) const;
+    int centreBin(int note) const { return (note - settings_.minNote) * binsPerSemitone + 1; }
+
+    float& levelAt(int note, int64_t frame);
+    int64_t framePosition(int64_t frame) const;
+
+    /**
+     * Where the note's level first crossed threshold in (from, to], less
+     * half a kernel (when the change sat mid-kernel); -1 if it did not
+     */
+    int64_t crossing(int note, int64_t from, int64_t to, float threshold, bool rising);
+
+    void beginOnset(NoteTrack& track, float baseLevel);
+    void accumulate(NoteTrack& track, const PitchEstimate& estimate);
+    void announce(NoteTrack& track, int note, std::vector<NoteEvent>& events);
+    void endNote(NoteTrack& track, int note, int64_t position, std::vector<NoteEvent>& events);
+
+    Mode mode_;
+    Settings settings_;
+    ConstantQ cq_;
+    int hop_;
+    int minOnFrames_;
+    int minOffFrames_;
+    int numCandidates_;
+    std::array<int, numHarmonics> harmonicOffsets_ {};
+    std::array<float, numHarmonics> harmonicWeights_ {};
+
+    std::vector<float> history_;                // Newest frame, oldest sample first
+    int pending_ = 0;                           // Samples of the next hop already in history_
+    int64_t position_ = 0;
+
+    std::vector<float> spectrum_, residual_;
+    std::vector<PitchEstimate> estimates_;
+    std::array<PitchEstimate*, 128> detected_ {};
+
+    // Note tracking; per-note tables are indexed by MIDI note
+    std::array<NoteTrack, 128> tracks_ {};
+    std::array<int, 128> kernelLengths_ {};
+    std::array<int, 128> confirmFrames_ {};     // Frames a new pitch needs before it is a note
+    std::array<int, 128> settleFrames_ {};      // Frames for an onset to fill the kernel
+    std::vector<float> levels_;                 // 128 x historyLength, by frame
+    std::array<int64_t, historyLength> framePositions_ {};
+    int64_t frameIndex_ = -1;
+};
+
+//==============================================================================
+// Realtime Transcriber
+//==============================================================================
+
+/**
+ * Live transcription on a worker thread
+ *
+ * The audio thread pushes input into a lock-free ring (downmixed to
+ * mono); a worker runs a RealTime PolyphonicTranscriber on it and
+ * publishes note events to a lock-free queue and the set of sounding
+ * notes to atomics, so chords can be read from any thread.
+ *
+ * Latency is bounded: if the worker falls more than eight hops behind
+ * (descheduled, machine overloaded) it skips to the newest audio instead
+ * of catching up, and counts the gap. Event positions count samples
+ * pushed since start().
+ *
+ * Threading: start() and stop() from one control thread. pushAudio() is
+ * the audio thread's (lock-free, allocation-free; ignored while stopped).
+ * readEvents() from one consumer thread at a time; the rest from any.
+ */
+class RealtimeTranscriber
+{
+public:
+    static constexpr int eventCapacity = 1024;
+
+    explicit RealtimeTranscriber(double sampleRate, const PolyphonicTranscriber::Settings& settings = {});
+    ~RealtimeTranscriber();
+
+    RealtimeTranscriber(const RealtimeTranscriber&) = delete;
+    RealtimeTranscriber& operator=(const RealtimeTranscriber&) = delete;
+
+    /** Start the worker from silence; events still queued from before stay readable */
+    void start();
+
+    /** Stop the worker; sounding notes get their NoteOff */
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /** Queue input; channels are averaged. Drops (and counts) what the ring cannot take. */
+    void pushAudio(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** @return Events copied into events (at most maxEvents), oldest first */
+    int readEvents(NoteEvent* events, int maxEvents) noexcept;
+
+    bool isNoteSounding(int note) const noexcept;
+
+    /** @return Sounding notes written to notes (at most maxNotes), lowest first */
+    int getSoundingNotes(int* notes, int maxNotes) const noexcept;
+
+    /** Worst case from a note starting to its NoteOn being readable */
+    int getLatency() const { return transcriber_.getLatency() + maxBacklog_; }
+
+    uint32_t getNumDroppedSamples() const { return droppedSamples_.load(std::memory_order_relaxed); }
+    uint32_t getNumSkippedSamples() const { return skippedSamples_.load(std::memory_order_relaxed); }
+    uint32_t getNumDroppedEvents() const { return droppedEvents_.load(std::memory_order_relaxed); }
+
+private:
+    void workerLoop();
+    void drainInput();
+    void publish();
+
+    PolyphonicTranscriber transcriber_;
+    int maxBacklog_;
+
+    // Input ring: free-running counts, index by count & inputMask_
+    std::vector<float> input_;
+    int64_t inputMask_;
+    std::atomic<int64_t> inputWrite_ { 0 };     // Audio thread
+    std::atomic<int64_t> inputRead_ { 0 };      // Worker
+
+    std::vector<NoteEvent> eventQueue_;
+    std::atomic<int64_t> eventWrite_ { 0 };     // Worker
+    std::atomic<int64_t> eventRead_ { 0 };      // Consumer
+
+    std::array<std::atomic<uint64_t>, 2> sounding_ {};
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> running_ { false };
+
+    // Worker scratch
+    std::vector<float> chunk_;
+    std::vector<NoteEvent> events_;
+
+    std::atomic<uint32_t> droppedSamples_ { 0 };
+    std::atomic<uint32_t> skippedSamples_ { 0 };
+    std::atomic<uint32_t> droppedEvents_ { 0 };
+};
+
+} // namespace DSP
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    RealFFT.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Implementation of the shared-plan radix-2 real FFT
+
+  ==============================================================================
+*/
+
+#include "dsp/RealFFT.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace DSP {
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+} // namespace
+
+//==============================================================================
+// Plan
+//==============================================================================
+
+RealFFT::Plan::Plan(int order)
+    : size(1 << std::max(1, order))
+    , half(size / 2)
+{
+    bitReverse.resize(static_cast<size_t>(half));
+    int bits = 0;
+    while ((1 << bits) < half)
+        ++bits;
+
+    for (int i = 0; i < half; ++i)
+    {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b)
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        bitReverse[static_cast<size_t>(i)] = reversed;
+    }
+
+    // Each stage reads its twiddles contiguously: stage of length L holds
+    // cos/sin(2 pi j / L) for j < L/2, so the butterfly loop runs unit-stride
+    for (int length = 2; length <= half; length <<= 1)
+    {
+        for (int j = 0; j < length / 2; ++j)
+        {
+            stageCos.push_back(static_cast<float>(std::cos(2.0 * pi * j / length)));
+            stageSin.push_back(static_cast<float>(std::sin(2.0 * pi * j / length)));
+        }
+    }
+
+    splitCos.resize(static_cast<size_t>(half));
+    splitSin.resize(static_cast<size_t>(half));
+    for (int k = 0; k < half; ++k)
+    {
+        splitCos[static_cast<size_t>(k)] = static_cast<float>(std::cos(2.0 * pi * k / size));
+        splitSin[static_cast<size_t>(k)] = static_cast<float>(std::sin(2.0 * pi * k / size));
+    }
+}
+
+std::shared_ptr<const RealFFT::Plan> RealFFT::getSharedPlan(int order)
+{
+    static std::mutex mutex;
+    static std::map<int, std::weak_ptr<const Plan>> plans;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = plans[std::max(1, order)];
+
+    if (auto plan = slot.lock())
+        return plan;
+
+    auto plan = std::make_shared<const Plan>(order);
+    slot = plan;
+    return plan;
+}
+
+//==============================================================================
+// Real FFT
+//==============================================================================
+
+RealFFT::RealFFT(int order)
+    : plan_(getSharedPlan(order))
+    , workRe_(static_cast<size_t>(plan_->half))
+    , workIm_(static_cast<size_t>(plan_->half))
+{
+}
+
+void RealFFT::transform(bool inverse)
+{
+    const Plan& plan = *plan_;
+    float* re = workRe_.data();
+    float* im = workIm_.data();
+    const float sign = inverse ? 1.0f : -1.0f;
+    const float* stageCos = plan.stageCos.data();
+    const float* stageSin = plan.stageSin.data();
+
+    for (int length = 2; length <= plan.half; length <<= 1)
+    {
+        const int halfLength = length / 2;
+
+        for (int start = 0; start < plan.half; start += length)
+        {
+            float* aRe = re + start;
+            float* aIm = im + start;
+            float* bRe = aRe + halfLength;
+            float* bIm = aIm + halfLength;
+
+            for (int j = 0; j < halfLength; ++j)
+            {
+                const float wr = stageCos[j];
+                const float wi = sign * stageSin[j];
+                const float vr = bRe[j] * wr - bIm[j] * wi;
+                const float vi = bRe[j] * wi + bIm[j] * wr;
+
+                bRe[j] = aRe[j] - vr;
+                bIm[j] = aIm[j] - vi;
+                aRe[j] += vr;
+                aIm[j] += vi;
+            }
+        }
+
+        stageCos += halfLength;
+        stageSin += halfLength;
+    }
+}
+
+void RealFFT::forward(const float* input, float* re, float* im)
+{
+    const Plan& plan = *plan_;
+    const int half = plan.half;
+
+    // Even samples as real, odd as imaginary, loaded in bit-reversed order
+    for (int n = 0; n < half; ++n)
+    {
+        const auto target = static_cast<size_t>(plan.bitReverse[static_cast<size_t>(n)]);
+        workRe_[target] = input[2 * n];
+        workIm_[target] = input[2 * n + 1];
+    }
+
+    transform(false);
+
+    re[0] = workRe_[0] + workIm_[0];
+    im[0] = 0.0f;
+    re[half] = workRe_[0] - workIm_[0];
+    im[half] = 0.0f;
+
+    for (int k = 1; k < half; ++k)
+    {
+        const float ar = workRe_[static_cast<size_t>(k)];
+        const float ai = workIm_[static_cast<size_t>(k)];
+        const float br = workRe_[static_cast<size_t>(half - k)];
+        const float bi = workIm_[static_cast<size_t>(half - k)];
+
+        // Even and odd half spectra, then X[k] = E[k] + W^k O[k]
+        const float evenRe = 0.5f * (ar + br);
+        const float evenIm = 0.5f * (ai - bi);
+        const float oddRe = 0.5f * (ai + bi);
+        const float oddIm = -0.5f * (ar - br);
+
+        const float c = plan.splitCos[static_cast<size_t>(k)];
+        const float s = plan.splitSin[static_cast<size_t>(k)];
+        re[k] = evenRe + c * oddRe + s * oddIm;
+        im[k] = evenIm + c * oddIm - s * oddRe;
+    }
+}
+
+void RealFFT::inverse(const float* re, const float* im, float* output)
+{
+    const Plan& plan = *plan_;
+    const int half = plan.half;
+
+    for (int k = 0; k < half; ++k)
+    {
+        const float ar = re[k];
+        const float ai = im[k];
+        const float br = re[half - k];
+        const float bi = im[half - k];
+
+        const float evenRe = 0.5f * (ar + br);
+        const float evenIm = 0.5f * (ai - bi);
+        const float dr = 0.5f * (ar - br);
+        const float di = 0.5f * (ai + bi);
+
+        const float c = plan.splitCos[static_cast<size_t>(k)];
+        const float s = plan.splitSin[static_cast<size_t>(k)];
+        const float oddRe = dr * c - di * s;
+        const float oddIm = dr * s + di * c;
+
+        const auto target = static_cast<size_t>(plan.bitReverse[static_cast<size_t>(k)]);
+        workRe_[target] = evenRe - oddIm;
+        workIm_[target] = evenIm + oddRe;
+    }
+
+    transform(true);
+
+    const float scale = 1.0f / static_cast<float>(half);
+    for (int n = 0; n < half; ++n)
+    {
+        output[2 * n] = workRe_[static_cast<size_t>(n)] * scale;
+        output[2 * n + 1] = workIm_[static_cast<size_t>(n)] * scale;
+    }
+}
+
+} // namespace DSP
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    RealFFT.h
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Radix-2 real FFT shared by the pure-DSP code (no juce::dsp)
+    - Twiddle and bit-reversal tables built once per size and shared by
+      every instance of that size
+    - Split real/imaginary spectra, so per-bin loops vectorise
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace DSP {
+
+//==============================================================================
+// Real FFT
+//==============================================================================
+
+/**
+ * Radix-2 real FFT
+ *
+ * A real signal of N samples is transformed as an N/2 point complex FFT
+ * plus a split step. Spectra are N/2 + 1 bins in split real/imaginary
+ * arrays. The tables live in a Plan that all instances of one size share;
+ * an instance only owns its work buffers, so it is not thread safe: each
+ * thread needs its own instance. Construct off the audio thread.
+ */
+class RealFFT
+{
+public:
+    /** Tables for one transform size, immutable once built */
+    struct Plan
+    {
+        explicit Plan(int order);
+
+        int size;
+        int half;
+        std::vector<int> bitReverse;
+        std::vector<float> stageCos, stageSin;  // Butterfly twiddles, stage after stage
+        std::vector<float> splitCos, splitSin;  // Real/complex split twiddles
+    };
+
+    explicit RealFFT(int order);
+
+    int getSize() const { return plan_->size; }
+    int getNumBins() const { return plan_->size / 2 + 1; }
+
+    /** input[size] -> re[numBins], im[numBins] */
+    void forward(const float* input, float* re, float* im);
+
+    /** re[numBins], im[numBins] -> output[size], scaled so inverse(forward(x)) == x */
+    void inverse(const float* re, const float* im, float* output);
+
+    /** The shared tables (the same object for every instance of this size) */
+    const std::shared_ptr<const Plan>& getPlan() const { return plan_; }
+
+private:
+    static std::shared_ptr<const Plan> getSharedPlan(int order);
+
+    void transform(bool inverse);
+
+    std::shared_ptr<const Plan> plan_;
+    std::vector<float> workRe_, workIm_;
+};
+
+} // namespace DSP
@@ -0,0 +1,727 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.h
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Logging that is safe to call from the audio thread
+    - The caller writes a fixed-size binary record (call site, raw
+      arguments, tick timestamp) into a wait-free ring of its own thread
+    - A background thread formats the records and writes them out
+    - Severity filtering at compile time (DSP_LOG_MIN_LEVEL) and at run
+      time (setLevel)
+    - Rate limiting per call site, with a count of what was suppressed
+
+    Usage:
+      #include "dsp/RealtimeLog.h"
+
+      DSP_LOG_WARNING("SRC ratio %.3f out of range (%d samples)", ratio, numSamples);
+
+    Arguments are numbers, enums, pointers and C strings (copied, up to 40
+    bytes per record). Header only, so every target that includes it shares
+    one logger.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #if defined(_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+ #define DSP_LOG_HAS_TSC 1
+#else
+ #define DSP_LOG_HAS_TSC 0
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+ #include <pthread.h>
+ #define DSP_LOG_HAS_PTHREAD_KEY 1
+#else
+ #define DSP_LOG_HAS_PTHREAD_KEY 0
+#endif
+
+//==============================================================================
+// Compile-time filter: calls below this level compile to nothing
+// (0 debug, 1 info, 2 warning, 3 error, 4 off)
+//==============================================================================
+
+#ifndef DSP_LOG_MIN_LEVEL
+ #ifdef DEBUG
+  #define DSP_LOG_MIN_LEVEL 0
+ #else
+  #define DSP_LOG_MIN_LEVEL 1
+ #endif
+#endif
+
+namespace DSP {
+
+enum class LogLevel : int
+{
+    Debug = 0,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+//==============================================================================
+// Log Site
+//==============================================================================
+
+/**
+ * One DSP_LOG call in the source: its level, format and rate-limit state
+ *
+ * Sites are static locals created by the macros; the logger links them
+ * into a list the first time they fire, so it can report repeats that were
+ * suppressed after a site went quiet.
+ */
+struct LogSite
+{
+    LogLevel level;
+    const char* format;                     // printf style, static storage
+    const char* file;
+    int line;
+
+    // Rate limiting: records admitted in the window starting at windowStart
+    std::atomic<std::uint64_t> windowStart { 0 };
+    std::atomic<std::uint32_t> windowCount { 0 };
+    std::atomic<std::uint32_t> suppressed { 0 };
+
+    std::atomic<bool> registered { false };
+    LogSite* next = nullptr;
+};
+
+//==============================================================================
+// Log Record
+//==============================================================================
+
+/** What the audio thread writes: no formatting, no allocation */
+struct LogRecord
+{
+    static constexpr int maxArgs = 6;
+    static constexpr int textCapacity = 40;
+
+    enum class ArgType : std::uint8_t { Signed, Unsigned, Double, Pointer, Text };
+
+    union Arg
+    {
+        std::int64_t i;
+        std::uint64_t u;
+        double d;
+        const void* p;
+    };
+
+    const LogSite* site = nullptr;
+    std::uint64_t ticks = 0;
+    std::uint32_t suppressedBefore = 0;     // Repeats of the site dropped since its last record
+    std::uint8_t numArgs = 0;
+    std::uint8_t textUsed = 0;
+    ArgType types[maxArgs] = {};
+    Arg args[maxArgs] = {};
+    char text[textCapacity] = {};           // C string arguments; args[n].i is the offset, -1 if no room
+
+    template <typename T>
+    void add(const T& value) noexcept
+    {
+        using V = std::decay_t<T>;
+        const int n = numArgs++;
+
+        if constexpr (std::is_same_v<V, const char*> || std::is_same_v<V, char*>)
+        {
+            types[n] = ArgType::Text;
+            args[n].i = -1;
+
+            const int room = textCapacity - textUsed;
+            if (room > 0)
+            {
+                const char* source = value;
+                if constexpr (!std::is_array_v<T>)
+                    source = source != nullptr ? source : "(null)";
+
+                int length = 0;
+                while (length < room - 1 && source[length] != '\0')
+                    ++length;
+
+                std::memcpy(text + textUsed, source, static_cast<size_t>(length));
+                text[textUsed + length] = '\0';
+                args[n].i = textUsed;
+                textUsed = static_cast<std::uint8_t>(textUsed + length + 1);
+            }
+        }
+        else if constexpr (std::is_floating_point_v<V>)
+        {
+            types[n] = ArgType::Double;
+            args[n].d = static_cast<double>(value);
+        }
+        else if constexpr (std::is_enum_v<V>)
+        {
+            types[n] = ArgType::Signed;
+            args[n].i = static_cast<std::int64_t>(value);
+        }
+        else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>)
+        {
+            types[n] = ArgType::Signed;
+            args[n].i = static_cast<std::int64_t>(value);
+        }
+        else if constexpr (std::is_integral_v<V>)
+        {
+            types[n] = ArgType::Unsigned;
+            args[n].u = static_cast<std::uint64_t>(value);
+        }
+        else if constexpr (std::is_pointer_v<V>)
+        {
+            types[n] = ArgType::Pointer;
+            args[n].p = static_cast<const void*>(value);
+        }
+        else
+        {
+            static_assert(std::is_pointer_v<V>, "Log arguments are numbers, enums, pointers and C strings");
+        }
+    }
+};
+
+//==============================================================================
+// Realtime Log
+//==============================================================================
+
+/**
+ * The process-wide deferred logger
+ *
+ * log() is wait-free: one relaxed check of the level, the rate limit
+ * (a few atomic adds on the site) and a copy into the calling thread's
+ * single-producer ring. The first record from a thread claims one of
+ * maxThreads rings (lock-free). The ring is released when the thread
+ * exits, through a pthread key where there is one: a thread_local with a
+ * destructor would register it with the runtime at that first record,
+ * which can allocate. A full ring drops the record and counts it.
+ *
+ * instance() constructs the logger and starts its writer thread. This
+ * header does that during static initialisation (see below), so it never
+ * happens on an audio thread. The writer wakes every flush interval,
+ * formats everything pending and hands each line to the sink (stdout,
+ * warnings and errors to stderr, by default).
+ */
+class RealtimeLog
+{
+public:
+    static constexpr int maxThreads = 32;
+    static constexpr int recordsPerThread = 256;
+
+    using Sink = std::function<void(LogLevel level, const char* line)>;
+
+    static RealtimeLog& instance()
+    {
+        static RealtimeLog log;
+        return log;
+    }
+
+    ~RealtimeLog()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            running = false;
+        }
+
+        wake.notify_all();
+        if (writer.joinable())
+            writer.join();
+
+        flush();
+
+       #if DSP_LOG_HAS_PTHREAD_KEY
+        if (hasRingKey)
+            pthread_key_delete(ringKey);
+       #endif
+    }
+
+    //==============================================================================
+    // CONFIGURATION (any thread but the audio thread)
+    //==============================================================================
+
+    /** Run-time filter: records below level are discarded at the call */
+    void setLevel(LogLevel level) noexcept { minLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel getLevel() const noexcept { return static_cast<LogLevel>(minLevel.load(std::memory_order_relaxed)); }
+
+    bool isEnabled(LogLevel level) const noexcept
+    {
+        return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    /** Records per second each call site may write; 0 for no limit */
+    void setRateLimit(int recordsPerSecond) noexcept { rateLimit.store(recordsPerSecond, std::memory_order_relaxed); }
+
+    /** Where formatted lines go; called on the writer thread (or flush()'s caller) */
+    void setSink(Sink newSink)
+    {
+        std::lock_guard<std::mutex> lock(drainMutex);
+        sink = newSink ? std::move(newSink) : Sink(writeToStandardStreams);
+    }
+
+    void setFlushInterval(std::chrono::milliseconds interval) noexcept
+    {
+        flushIntervalMs.store(static_cast<int>(std::max<std::int64_t>(1, interval.count())), std::memory_order_relaxed);
+        wake.notify_all();
+    }
+
+    /** Format and write everything logged so far */
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(drainMutex);
+        drain();
+    }
+
+    //==============================================================================
+    // LOGGING (any thread, including the audio thread)
+    //==============================================================================
+
+    template <typename... Args>
+    void log(LogSite& site, const Args&... args) noexcept
+    {
+        static_assert(sizeof...(Args) <= LogRecord::maxArgs, "Too many log arguments");
+
+        if (!isEnabled(site.level))
+            return;
+
+        const std::uint64_t ticks = now();
+        registerSite(site);
+
+        std::uint32_t suppressedBefore = 0;
+        if (!admit(site, ticks, suppressedBefore))
+            return;
+
+        Ring* ring = threadRing();
+        const std::uint32_t head = ring != nullptr ? ring->head.load(std::memory_order_relaxed) : 0;
+
+        if (ring == nullptr || head - ring->tail.load(std::memory_order_acquire) >= recordsPerThread)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            site.suppressed.fetch_add(suppressedBefore, std::memory_order_relaxed);
+            return;
+        }
+
+        LogRecord& record = ring->records[head % recordsPerThread];
+        record.site = &site;
+        record.ticks = ticks;
+        record.suppressedBefore = suppressedBefore;
+        record.numArgs = 0;
+        record.textUsed = 0;
+        (record.add(args), ...);
+
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    /** Timestamp ticks: the TSC where there is one, else the steady clock */
+    static std::uint64_t now() noexcept
+    {
+       #if DSP_LOG_HAS_TSC
+        return static_cast<std::uint64_t>(__rdtsc());
+       #else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+       #endif
+    }
+
+    //==============================================================================
+    // MONITORING
+    //==============================================================================
+
+    /** Records lost to a full ring (or no free ring) */
+    std::uint64_t getNumDropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    /** Records held back by rate limiting and reported so far */
+    std::uint64_t getNumSuppressed() const noexcept { return suppressedReported.load(std::memory_order_relaxed); }
+
+    /** Format a record as the writer would (without timestamp and level) */
+    static std::string formatMessage(const LogRecord& record)
+    {
+        std::string message;
+        const char* format = record.site != nullptr ? record.site->format : "";
+        int argument = 0;
+
+        for (const char* c = format; *c != '\0'; ++c)
+        {
+            if (*c != '%')
+            {
+                message += *c;
+                continue;
+            }
+
+            if (c[1] == '%')
+            {
+                message += '%';
+                ++c;
+                continue;
+            }
+
+            // Flags, width and precision pass through; length modifiers are
+            // replaced to match the stored argument
+            std::string spec = "%";
+            const char* s = c + 1;
+            while (*s != '\0' && std::strchr("-+ #0123456789.", *s) != nullptr)
+                spec += *s++;
+            while (*s != '\0' && std::strchr("hljztLq", *s) != nullptr)
+                ++s;
+
+            if (*s == '\0')
+                break;
+
+            c = s;
+            const char conversion = *s;
+
+            if (argument >= record.numArgs)
+            {
+                message += "<?>";
+                continue;
+            }
+
+            const auto type = record.types[argument];
+            const auto& value = record.args[argument];
+            ++argument;
+
+            char buffer[128];
+            int written = 0;
+
+            if (type == LogRecord::ArgType::Text)
+            {
+                const char* text = value.i >= 0 ? record.text + value.i : "";
+                written = std::snprintf(buffer, sizeof(buffer), (spec + 's').c_str(), text);
+            }
+            else if (std::strchr("fFeEgGaA", conversion) != nullptr)
+            {
+                const double number = type == LogRecord::ArgType::Double ? value.d
+                                    : type == LogRecord::ArgType::Signed ? static_cast<double>(value.i)
+                                    : static_cast<double>(value.u);
+                written = std::snprintf(buffer, sizeof(buffer), (spec + conversion).c_str(), number);
+            }
+            else if (conversion == 'p' || type == LogRecord::ArgType::Pointer)
+            {
+                written = std::snprintf(buffer, sizeof(buffer), (spec + 'p').c_str(), value.p);
+            }
+            else if (conversion == 'd' || conversion == 'i' || conversion == 'c')
+            {
+                const long long number = type == LogRecord::ArgType::Double ? static_cast<long long>(value.d)
+                                                                            : static_cast<long long>(value.i);
+                written = conversion == 'c'
+                    ? std::snprintf(buffer, sizeof(buffer), (spec + 'c').c_str(), static_cast<int>(number))
+                    : std::snprintf(buffer, sizeof(buffer), (spec + "lld").c_str(), number);
+            }
+            else
+            {
+                // u, o, x, X
+                const unsigned long long number = type == LogRecord::ArgType::Double
+                                                ? static_cast<unsigned long long>(value.d)
+                                                : static_cast<unsigned long long>(value.u);
+                written = std::snprintf(buffer, sizeof(buffer), (spec + "ll" + conversion).c_str(), number);
+            }
+
+            if (written > 0)
+                message.append(buffer, static_cast<size_t>(std::min<int>(written, sizeof(buffer) - 1)));
+        }
+
+        return message;
+    }
+
+private:
+    struct Ring
+    {
+        std::array<LogRecord, recordsPerThread> records;
+        std::atomic<std::uint32_t> head { 0 };          // Producer
+        std::atomic<std::uint32_t> tail { 0 };          // Writer
+        std::atomic<bool> claimed { false };
+    };
+
+    static void releaseRing(void* ring) noexcept
+    {
+        static_cast<Ring*>(ring)->claimed.store(false, std::memory_order_release);
+    }
+
+   #if !DSP_LOG_HAS_PTHREAD_KEY
+    /** Releases the thread's ring when the thread exits */
+    struct ThreadSlot
+    {
+        Ring* ring = nullptr;
+
+        ~ThreadSlot()
+        {
+            if (ring != nullptr)
+                releaseRing(ring);
+        }
+    };
+   #endif
+
+    RealtimeLog()
+    {
+        sink = writeToStandardStreams;
+
+        // Ticks to wall time: an origin now, and the tick rate
+        wallOriginMs = static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count());
+        steadyOrigin = std::chrono::steady_clock::now();
+        tickOrigin = now();
+
+        // The TSC rate is measured by the writer at each drain, so nothing
+        // here waits for it; until then the 1 GHz default stands in
+       #if !DSP_LOG_HAS_TSC
+        ticksPerSecond = static_cast<double>(std::chrono::steady_clock::period::den)
+                       / static_cast<double>(std::chrono::steady_clock::period::num);
+       #endif
+        windowTicks.store(static_cast<std::uint64_t>(ticksPerSecond), std::memory_order_relaxed);
+
+       #if DSP_LOG_HAS_PTHREAD_KEY
+        hasRingKey = pthread_key_create(&ringKey, releaseRing) == 0;
+       #endif
+
+        writer = std::thread([this] { writerLoop(); });
+    }
+
+    Ring* threadRing() noexcept
+    {
+        // Trivially destructible, so first use registers nothing with the runtime
+        thread_local Ring* threadRing = nullptr;
+
+        if (threadRing == nullptr)
+        {
+            for (auto& ring : rings)
+            {
+                if (!ring.claimed.exchange(true, std::memory_order_acquire))
+                {
+                    threadRing = &ring;
+                    break;
+                }
+            }
+
+            if (threadRing != nullptr)
+            {
+               #if DSP_LOG_HAS_PTHREAD_KEY
+                // The first few keys live in the thread itself: setting one does not allocate
+                if (hasRingKey)
+                    pthread_setspecific(ringKey, threadRing);
+               #else
+                thread_local ThreadSlot slot;
+                slot.ring = threadRing;
+               #endif
+            }
+        }
+
+        return threadRing;
+    }
+
+    void registerSite(LogSite& site) noexcept
+    {
+        if (site.registered.load(std::memory_order_relaxed) || site.registered.exchange(true, std::memory_order_relaxed))
+            return;
+
+        site.next = sites.load(std::memory_order_relaxed);
+        while (!sites.compare_exchange_weak(site.next, &site, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    bool admit(LogSite& site, std::uint64_t ticks, std::uint32_t& suppressedBefore) noexcept
+    {
+        const int limit = rateLimit.load(std::memory_order_relaxed);
+
+        if (limit > 0)
+        {
+            // One caller wins the reset of an expired window
+            auto start = site.windowStart.load(std::memory_order_relaxed);
+            if (ticks - start >= windowTicks.load(std::memory_order_relaxed)
+                && site.windowStart.compare_exchange_strong(start, ticks, std::memory_order_relaxed))
+                site.windowCount.store(0, std::memory_order_relaxed);
+
+            if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= static_cast<std::uint32_t>(limit))
+            {
+                site.suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        suppressedBefore = site.suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    void writerLoop()
+    {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+
+        while (running)
+        {
+            wake.wait_for(lock, std::chrono::milliseconds(flushIntervalMs.load(std::memory_order_relaxed)));
+
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    /** drainMutex must be held */
+    void drain()
+    {
+       #if DSP_LOG_HAS_TSC
+        calibrate();
+       #endif
+
+        std::string line;
+
+        for (auto& ring : rings)
+        {
+            std::uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+            const std::uint32_t head = ring.head.load(std::memory_order_acquire);
+
+            for (; tail != head; ++tail)
+            {
+                const LogRecord& record = ring.records[tail % recordsPerThread];
+                const LogLevel level = record.site->level;
+
+                line = prefix(record.ticks, level) + formatMessage(record);
+                if (record.suppressedBefore > 0)
+                    line += " (" + std::to_string(record.suppressedBefore) + " similar suppressed)";
+
+                suppressedReported.fetch_add(record.suppressedBefore, std::memory_order_relaxed);
+                sink(level, line.c_str());
+            }
+
+            ring.tail.store(tail, std::memory_order_release);
+        }
+
+        // Sites that were rate limited and have gone quiet since
+        const std::uint64_t ticks = now();
+        for (LogSite* site = sites.load(std::memory_order_acquire); site != nullptr; site = site->next)
+        {
+            if (site->suppressed.load(std::memory_order_relaxed) == 0
+                || ticks - site->windowStart.load(std::memory_order_relaxed) < windowTicks.load(std::memory_order_relaxed))
+                continue;
+
+            const auto count = site->suppressed.exchange(0, std::memory_order_relaxed);
+            if (count == 0)
+                continue;
+
+            line = prefix(ticks, site->level) + std::to_string(count) + " more like \"" + site->format + "\" suppressed";
+            suppressedReported.fetch_add(count, std::memory_order_relaxed);
+            sink(site->level, line.c_str());
+        }
+
+        const auto lost = dropped.load(std::memory_order_relaxed);
+        if (lost != droppedReported)
+        {
+            line = prefix(ticks, LogLevel::Warning) + std::to_string(lost - droppedReported)
+                 + " log records dropped (ring full)";
+            droppedReported = lost;
+            sink(LogLevel::Warning, line.c_str());
+        }
+    }
+
+   #if DSP_LOG_HAS_TSC
+    /** Measure the TSC rate against the steady clock since construction */
+    void calibrate() noexcept
+    {
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - steadyOrigin).count();
+        if (elapsed <= 0.0)
+            return;
+
+        ticksPerSecond = static_cast<double>(now() - tickOrigin) / elapsed;
+        windowTicks.store(static_cast<std::uint64_t>(ticksPerSecond), std::memory_order_relaxed);
+    }
+   #endif
+
+    /** "[epoch ms] [LEVEL] " */
+    std::string prefix(std::uint64_t ticks, LogLevel level) const
+    {
+        static const char* const names[] = { "DEBUG", "INFO", "WARN", "ERROR", "" };
+
+        const double elapsed = static_cast<double>(static_cast<std::int64_t>(ticks - tickOrigin)) / ticksPerSecond;
+        const auto milliseconds = static_cast<long long>(wallOriginMs + elapsed * 1000.0);
+
+        char buffer[48];
+        std::snprintf(buffer, sizeof(buffer), "[%lld] [%s] ", milliseconds, names[static_cast<int>(level)]);
+        return buffer;
+    }
+
+    static void writeToStandardStreams(LogLevel level, const char* line)
+    {
+        std::FILE* stream = level >= LogLevel::Warning ? stderr : stdout;
+        std::fputs(line, stream);
+        std::fputc('\n', stream);
+        std::fflush(stream);
+    }
+
+    std::array<Ring, maxThreads> rings;
+    std::atomic<LogSite*> sites { nullptr };
+
+    std::atomic<int> minLevel { DSP_LOG_MIN_LEVEL };
+    std::atomic<int> rateLimit { 20 };
+    std::atomic<int> flushIntervalMs { 20 };
+    std::atomic<std::uint64_t> windowTicks { 1000000000 };   // One second of ticks
+
+    // Writer (drainMutex also guards the sink and the clock calibration)
+    std::mutex drainMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool running = true;
+    std::thread writer;
+    Sink sink;
+
+   #if DSP_LOG_HAS_PTHREAD_KEY
+    pthread_key_t ringKey {};
+    bool hasRingKey = false;
+   #endif
+
+    double wallOriginMs = 0.0;
+    std::chrono::steady_clock::time_point steadyOrigin;
+    std::uint64_t tickOrigin = 0;
+    double ticksPerSecond = 1.0e9;
+
+    std::atomic<std::uint64_t> dropped { 0 };
+    std::uint64_t droppedReported = 0;
+    std::atomic<std::uint64_t> suppressedReported { 0 };
+};
+
+#if DSP_LOG_MIN_LEVEL < 4
+namespace detail
+{
+    // Starts the logger during static initialisation of every binary that
+    // can log, before any audio thread exists
+    inline const bool realtimeLogStarted = (RealtimeLog::instance(), true);
+}
+#endif
+
+} // namespace DSP
+
+//==============================================================================
+// Macros
+//==============================================================================
+
+/**
+ * Log from any thread. The format must be a string literal; below
+ * DSP_LOG_MIN_LEVEL the call and its arguments compile to nothing.
+ */
+#define DSP_LOG(level, format, ...) \
+    do { \
+        if constexpr (static_cast<int>(level) >= DSP_LOG_MIN_LEVEL) { \
+            static ::DSP::LogSite dspLogSite { level, format, __FILE__, __LINE__ }; \
+            ::DSP::RealtimeLog::instance().log(dspLogSite, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define DSP_LOG_DEBUG(...)   DSP_LOG(::DSP::LogLevel::Debug, __VA_ARGS__)
+#define DSP_LOG_INFO(...)    DSP_LOG(::DSP::LogLevel::Info, __VA_ARGS__)
+#define DSP_LOG_WARNING(...) DSP_LOG(::DSP::LogLevel::Warning, __VA_ARGS__)
+#define DSP_LOG_ERROR(...)   DSP_LOG(::DSP::LogLevel::Error, __VA_ARGS__)
@@ -391,6 +391,75 @@ inline void addBuffers(float* dest, const float* src, int numSamples)
     #endif
 }
 
+/**
+ * @brief Multiply buffer by buffer (gain curves, envelopes)
+ */
+inline void multiplyBuffers(float* dest, const float* src, int numSamples)
+{
+    #if defined(__ARM_NEON) || defined(__aarch64__)
+
+        int simdEnd = numSamples - 3;
+        int i = 0;
+
+        for (; i <= simdEnd; i += 4)
+        {
+            float32x4_t destData = vld1q_f32(dest + i);
+            float32x4_t srcData = vld1q_f32(src + i);
+            destData = vmulq_f32(destData, srcData);
+            vst1q_f32(dest + i, destData);
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            dest[i] *= src[i];
+        }
+
+    #elif defined(__AVX__)
+
+        int simdEnd = numSamples - 7;
+        int i = 0;
+
+        for (; i <= simdEnd; i += 8)
+        {
+            __m256 destData = _mm256_loadu_ps(dest + i);
+            __m256 srcData = _mm256_loadu_ps(src + i);
+            destData = _mm256_mul_ps(destData, srcData);
+            _mm256_storeu_ps(dest + i, destData);
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            dest[i] *= src[i];
+        }
+
+    #elif defined(__SSE4_1__) || defined(__SSE2__)
+
+        int simdEnd = numSamples - 3;
+        int i = 0;
+
+        for (; i <= simdEnd; i += 4)
+        {
+            __m128 destData = _mm_loadu_ps(dest + i);
+            __m128 srcData = _mm_loadu_ps(src + i);
+            destData = _mm_mul_ps(destData, srcData);
+            _mm_storeu_ps(dest + i, destData);
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            dest[i] *= src[i];
+        }
+
+    #else
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] *= src[i];
+        }
+
+    #endif
+}
+
 //==============================================================================
 // Soft Clipping ( SIMD-optimized)
 //==============================================================================
@@ -0,0 +1,339 @@
+#include "CompressorCore.h"
+#include "DynamicsConfig.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace schill {
+namespace dynamics {
+
+//==============================================================================
+// SlidingWindowDetector Implementation
+//==============================================================================
+
+void SlidingWindowDetector::prepare(int maxWindowLength) {
+    capacity = std::max(1, maxWindowLength);
+    windowLength = std::clamp(windowLength, 1, capacity);
+
+    squares.assign(static_cast<size_t>(capacity), 0.0f);
+    queueValues.assign(static_cast<size_t>(capacity) + 1, 0.0f);
+    queueIndices.assign(static_cast<size_t>(capacity) + 1, 0);
+
+    reset();
+}
+
+void SlidingWindowDetector::setMode(Mode newMode) noexcept {
+    if (mode != newMode) {
+        mode = newMode;
+        reset();
+    }
+}
+
+void SlidingWindowDetector::setWindowLength(int length) noexcept {
+    length = std::clamp(length, 1, std::max(1, capacity));
+    if (length != windowLength) {
+        windowLength = length;
+        reset();
+    }
+}
+
+void SlidingWindowDetector::reset() noexcept {
+    std::fill(squares.begin(), squares.end(), 0.0f);
+    writePosition = 0;
+    runningSum = 0.0;
+    queueHead = 0;
+    queueSize = 0;
+    sampleIndex = 0;
+}
+
+float SlidingWindowDetector::process(float power) noexcept {
+    if (capacity == 0) {
+        return power;
+    }
+
+    if (mode == Mode::RMS) {
+        float& oldest = squares[static_cast<size_t>(writePosition)];
+        runningSum += static_cast<double>(power) - static_cast<double>(oldest);
+        oldest = power;
+
+        if (++writePosition >= windowLength) {
+            writePosition = 0;
+        }
+
+        return static_cast<float>(std::max(0.0, runningSum)) / static_cast<float>(windowLength);
+    }
+
+    // Peak: drop queued values the new one dominates, append it, then expire
+    // the front once it leaves the window. The front is the window maximum.
+    const int ringSize = capacity + 1;
+
+    while (queueSize > 0) {
+        int back = queueHead + queueSize - 1;
+        if (back >= ringSize) {
+            back -= ringSize;
+        }
+        if (queueValues[static_cast<size_t>(back)] > power) {
+            break;
+        }
+        --queueSize;
+    }
+
+    int tail = queueHead + queueSize;
+    if (tail >= ringSize) {
+        tail -= ringSize;
+    }
+    queueValues[static_cast<size_t>(tail)] = power;
+    queueIndices[static_cast<size_t>(tail)] = sampleIndex;
+    ++queueSize;
+
+    while (queueIndices[static_cast<size_t>(queueHead)] <= sampleIndex - windowLength) {
+        if (++queueHead >= ringSize) {
+            queueHead = 0;
+        }
+        --queueSize;
+    }
+
+    ++sampleIndex;
+    return queueValues[static_cast<size_t>(queueHead)];
+}
+
+//==============================================================================
+// CompressorCore Implementation
+//==============================================================================
+
+void CompressorCore::prepare(double newSampleRate, int newMaxBlockSize) {
+    sampleRate = newSampleRate;
+    maxBlockSize = std::max(1, newMaxBlockSize);
+    gainBuffer.assign(static_cast<size_t>(maxChannels * maxBlockSize), 0.0f);
+
+    // Longest window is the 400 ms loudness window
+    const int windowCapacity = static_cast<int>(std::ceil(sampleRate * 0.4)) + 1;
+    for (auto& detector : detectors) {
+        detector.prepare(windowCapacity);
+    }
+
+    // Not running, so every slot can take the settings directly
+    updateCoefficients(configured);
+    for (auto& slot : slots) {
+        slot = configured;
+    }
+    latestSlot.store(latestSlot.load(std::memory_order_relaxed) & ~freshBit, std::memory_order_relaxed);
+    applyDetectorSettings();
+
+    reset();
+}
+
+void CompressorCore::reset() noexcept {
+    for (auto& detector : detectors) {
+        detector.reset();
+    }
+
+    std::fill(std::begin(previousInput), std::end(previousInput), 0.0f);
+    std::fill(std::begin(smoothedReduction), std::end(smoothedReduction), 0.0f);
+    lastGainReductionDb = 0.0f;
+}
+
+void CompressorCore::setParameters(const CompressorConfig& config) {
+    Settings& settings = configured;
+    settings.threshold = config.threshold;
+    settings.slope = 1.0f - 1.0f / std::max(1.0f, config.ratio);
+    settings.kneeWidth = std::max(0.0f, config.kneeWidth);
+    settings.range = std::max(0.0f, config.range);
+    settings.makeupDb = config.makeupGain;
+    settings.link = config.stereoLink ? std::clamp(config.stereoLinkRatio, 0.0f, 1.0f) : 0.0f;
+    settings.attackMs = config.attackTime;
+    settings.releaseMs = config.releaseTime;
+
+    switch (config.mode) {
+        case CompressorMode::Peak:
+        case CompressorMode::TruePeak:
+            settings.detectionMode = SlidingWindowDetector::Mode::Peak;
+            settings.windowMs = 1.0f;
+            break;
+
+        case CompressorMode::RMS_VU:
+            settings.detectionMode = SlidingWindowDetector::Mode::RMS;
+            settings.windowMs = 300.0f;
+            break;
+
+        case CompressorMode::LUFS:
+            settings.detectionMode = SlidingWindowDetector::Mode::RMS;
+            settings.windowMs = 400.0f;
+            break;
+
+        case CompressorMode::RMS:
+        case CompressorMode::Custom:
+        default:
+            settings.detectionMode = SlidingWindowDetector::Mode::RMS;
+            settings.windowMs = 10.0f;
+            break;
+    }
+    settings.truePeak = (config.mode == CompressorMode::TruePeak);
+
+    // Detector power at the bottom of the knee; anything quieter skips the log
+    settings.kneeStartPower = std::pow(10.0f, (settings.threshold - settings.kneeWidth * 0.5f) * 0.1f);
+
+    updateCoefficients(settings);
+    publish();
+}
+
+void CompressorCore::updateCoefficients(Settings& settings) const noexcept {
+    settings.attackCoeff = static_cast<float>(std::exp(-1.0 / (sampleRate * std::max(0.01f, settings.attackMs) * 0.001)));
+    settings.releaseCoeff = static_cast<float>(std::exp(-1.0 / (sampleRate * std::max(0.01f, settings.releaseMs) * 0.001)));
+    settings.windowLength = std::max(1, static_cast<int>(std::lround(settings.windowMs * 0.001 * sampleRate)));
+}
+
+void CompressorCore::publish() noexcept {
+    // Fill the slot only this thread owns, then trade it for the previous
+    // latest one, which the audio thread has either taken or skipped
+    slots[backSlot] = configured;
+    backSlot = latestSlot.exchange(backSlot | freshBit, std::memory_order_acq_rel) & ~freshBit;
+}
+
+void CompressorCore::takeLatestSettings() noexcept {
+    if ((latestSlot.load(std::memory_order_relaxed) & freshBit) == 0) {
+        return;
+    }
+
+    audioSlot = latestSlot.exchange(audioSlot, std::memory_order_acq_rel) & ~freshBit;
+    applyDetectorSettings();
+}
+
+void CompressorCore::applyDetectorSettings() noexcept {
+    // Detectors only restart when the mode or window actually changes
+    const Settings& settings = slots[audioSlot];
+    for (auto& detector : detectors) {
+        detector.setMode(settings.detectionMode);
+        detector.setWindowLength(settings.windowLength);
+    }
+}
+
+float CompressorCore::computeGainReductionDb(const Settings& settings, float levelDb) noexcept {
+    const float overshoot = levelDb - settings.threshold;
+    float reduction;
+
+    if (2.0f * overshoot <= -settings.kneeWidth) {
+        reduction = 0.0f;
+    } else if (2.0f * std::abs(overshoot) < settings.kneeWidth) {
+        // Quadratic soft knee
+        const float kneePosition = overshoot + settings.kneeWidth * 0.5f;
+        reduction = settings.slope * kneePosition * kneePosition / (2.0f * settings.kneeWidth);
+    } else {
+        reduction = settings.slope * overshoot;
+    }
+
+    return std::min(reduction, settings.range);
+}
+
+void CompressorCore::process(float* const* channels, int numChannels, int numSamples,
+                             const float* const* sidechain, int numSidechainChannels) noexcept {
+    lastGainReductionDb = 0.0f;
+
+    if (numChannels <= 0 || numSamples <= 0 || maxBlockSize == 0) {
+        return;
+    }
+
+    takeLatestSettings();
+
+    if (sidechain == nullptr || numSidechainChannels <= 0) {
+        sidechain = nullptr;
+        numSidechainChannels = 0;
+    }
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize) {
+        processChunk(channels, numChannels, std::min(maxBlockSize, numSamples - offset),
+                     sidechain, numSidechainChannels, nullptr, offset);
+    }
+}
+
+void CompressorCore::processWithKeyPower(float* const* channels, int numChannels, int numSamples,
+                                         const float* keyPower) noexcept {
+    if (keyPower == nullptr) {
+        process(channels, numChannels, numSamples);
+        return;
+    }
+
+    lastGainReductionDb = 0.0f;
+
+    if (numChannels <= 0 || numSamples <= 0 || maxBlockSize == 0) {
+        return;
+    }
+
+    takeLatestSettings();
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize) {
+        processChunk(channels, numChannels, std::min(maxBlockSize, numSamples - offset),
+                     nullptr, 0, keyPower, offset);
+    }
+}
+
+void CompressorCore::processChunk(float* const* channels, int numChannels, int numSamples,
+                                  const float* const* sidechain, int numSidechainChannels,
+                                  const float* keyPower, int offset) noexcept {
+    const Settings& settings = slots[audioSlot];
+    const float link = settings.link;
+    const int numDetected = (keyPower != nullptr) ? 0 : std::min(numChannels, maxChannels);
+    const bool fullyLinked = (keyPower != nullptr || link >= 1.0f || numDetected == 1);
+    const int numGainRows = fullyLinked ? 1 : numDetected;
+    float maxReduction = lastGainReductionDb;
+
+    // Pass 1: detection, gain computer and smoothing, one gain row per
+    // channel (or a single shared row when fully linked), in dB
+    for (int i = 0; i < numSamples; ++i) {
+        float power[maxChannels];
+        float maxPower = (keyPower != nullptr) ? keyPower[offset + i] : 0.0f;
+
+        for (int ch = 0; ch < numDetected; ++ch) {
+            const float* source = (sidechain != nullptr) ? sidechain[ch % numSidechainChannels] : channels[ch];
+            const float x = source[offset + i];
+            float squared = x * x;
+
+            if (settings.truePeak) {
+                // Midpoint estimate of the inter-sample peak
+                const float midpoint = 0.5f * (x + previousInput[ch]);
+                squared = std::max(squared, midpoint * midpoint);
+                previousInput[ch] = x;
+            }
+
+            power[ch] = detectors[ch].process(squared);
+            maxPower = std::max(maxPower, power[ch]);
+        }
+
+        for (int row = 0; row < numGainRows; ++row) {
+            const float detected = fullyLinked ? maxPower : link * maxPower + (1.0f - link) * power[row];
+            const float target = (detected > settings.kneeStartPower)
+                ? computeGainReductionDb(settings, FastMath::powerToDecibels(detected))
+                : 0.0f;
+
+            float& reduction = smoothedReduction[row];
+            const float coeff = (target > reduction) ? settings.attackCoeff : settings.releaseCoeff;
+            reduction = target + coeff * (reduction - target);
+
+            gainBuffer[static_cast<size_t>(row * maxBlockSize + i)] = settings.makeupDb - reduction;
+            maxReduction = std::max(maxReduction, reduction);
+        }
+    }
+
+    // Pass 2: dB to linear and apply, branch-free loops over the block
+    for (int row = 0; row < numGainRows; ++row) {
+        float* gains = gainBuffer.data() + row * maxBlockSize;
+        for (int i = 0; i < numSamples; ++i) {
+            gains[i] = FastMath::decibelsToGain(gains[i]);
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const int row = fullyLinked ? 0 : std::min(ch, numGainRows - 1);
+        const float* gains = gainBuffer.data() + row * maxBlockSize;
+        float* data = channels[ch] + offset;
+
+        for (int i = 0; i < numSamples; ++i) {
+            data[i] *= gains[i];
+        }
+    }
+
+    lastGainReductionDb = maxReduction;
+}
+
+} // namespace dynamics
+} // namespace schill
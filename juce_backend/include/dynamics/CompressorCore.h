@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace schill {
+namespace dynamics {
+
+struct CompressorConfig;
+
+//==============================================================================
+// Fast Log-Domain Math
+//==============================================================================
+
+/**
+ * Polynomial log2/exp2 approximations for per-sample gain computation.
+ * Errors stay around 0.001 dB, far finer than any compressor parameter can
+ * be set.
+ */
+namespace FastMath {
+
+inline float log2(float x) noexcept {
+    // x = m * 2^e with m in [1, 2); log2(m) from a quartic that is exact at
+    // both ends, so the curve stays continuous across octaves
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    const float exponent = static_cast<float>(static_cast<int>((bits >> 23) & 0xFFu) - 127);
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+
+    return exponent - 2.51432332f + m * (4.06793322f + m * (-2.11185581f + m * (0.63825681f + m * -0.08001090f)));
+}
+
+inline float exp2(float x) noexcept {
+    x = x < -126.0f ? -126.0f : (x > 126.0f ? 126.0f : x);
+
+    // 2^x = 2^i * 2^f with f in [0, 1)
+    const float floored = static_cast<float>(static_cast<int>(x) - (x < 0.0f ? 1 : 0));
+    const float f = x - floored;
+    const float p = 1.0f + f * (0.69303533f + f * (0.24144451f + f * (0.05183618f + f * 0.01368398f)));
+
+    const uint32_t bits = static_cast<uint32_t>(static_cast<int>(floored) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+/** 10 * log10(power) */
+inline float powerToDecibels(float power) noexcept {
+    return 3.01029996f * log2(power > 1.0e-20f ? power : 1.0e-20f);
+}
+
+inline float decibelsToGain(float decibels) noexcept {
+    return exp2(decibels * 0.16609640f);
+}
+
+} // namespace FastMath
+
+//==============================================================================
+// Sliding Window Level Detector
+//==============================================================================
+
+/**
+ * Fixed-capacity sliding window over squared samples. Peak mode keeps a
+ * monotonic queue (O(1) amortized per sample), RMS mode keeps a running sum.
+ * Outputs are in the power domain (peak^2 or mean square), so the gain
+ * computer needs no square root. Allocates only in prepare().
+ */
+class SlidingWindowDetector {
+public:
+    enum class Mode {
+        Peak,
+        RMS
+    };
+
+    void prepare(int maxWindowLength);
+    void setMode(Mode newMode) noexcept;
+    void setWindowLength(int length) noexcept;
+    void reset() noexcept;
+
+    int getWindowLength() const noexcept { return windowLength; }
+
+    /** Push one squared sample and return the window's power */
+    float process(float power) noexcept;
+
+private:
+    Mode mode = Mode::RMS;
+    int capacity = 0;
+    int windowLength = 1;
+    int64_t sampleIndex = 0;
+
+    // RMS: ring of squares and their running sum
+    std::vector<float> squares;
+    int writePosition = 0;
+    double runningSum = 0.0;
+
+    // Peak: monotonic (decreasing) queue stored as a ring
+    std::vector<float> queueValues;
+    std::vector<int64_t> queueIndices;
+    int queueHead = 0;
+    int queueSize = 0;
+};
+
+//==============================================================================
+// Compressor Core
+//==============================================================================
+
+/**
+ * Block-based feed-forward compressor.
+ *
+ * - Windowed peak/RMS detection per channel, linked across channels by
+ *   CompressorConfig::stereoLinkRatio (0 = independent, 1 = fully linked).
+ * - Gain computer in the log domain (soft knee, ratio, range) using
+ *   FastMath; levels below the knee skip the log entirely.
+ * - Attack/release smoothing runs on the gain reduction, not on the signal.
+ *   Gains for the whole block are computed first, then applied in one
+ *   multiply pass per channel.
+ * - setParameters builds a complete settings snapshot and publishes it
+ *   through a three-slot swap; the audio thread takes the newest snapshot
+ *   at the start of a block, so it never sees half-written coefficients
+ *   and neither side allocates or waits.
+ */
+class CompressorCore {
+public:
+    static constexpr int maxChannels = 8;
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset() noexcept;
+
+    /** Takes threshold, ratio, knee, range, times, makeup, mode and linking */
+    void setParameters(const CompressorConfig& config);
+
+    /**
+     * Compress in place. When a sidechain is given its channels drive the
+     * detector (channel index wraps if it has fewer channels).
+     */
+    void process(float* const* channels, int numChannels, int numSamples,
+                 const float* const* sidechain = nullptr, int numSidechainChannels = 0) noexcept;
+
+    /**
+     * Compress in place from an already detected key (a shared sidechain
+     * detector stream): one power value per sample, fully linked. The
+     * stream must come from a detector matching getDetectionMode(),
+     * getDetectionWindowMs() and usesTruePeakDetection() to sound the same
+     * as process() with the key as sidechain.
+     */
+    void processWithKeyPower(float* const* channels, int numChannels, int numSamples,
+                             const float* keyPower) noexcept;
+
+    // Latest settings passed to setParameters (same thread as setParameters)
+    SlidingWindowDetector::Mode getDetectionMode() const noexcept { return configured.detectionMode; }
+    float getDetectionWindowMs() const noexcept { return configured.windowMs; }
+    bool usesTruePeakDetection() const noexcept { return configured.truePeak; }
+
+    /** Largest gain reduction of the last block, in dB (positive) */
+    float getGainReductionDb() const noexcept { return lastGainReductionDb; }
+
+    /** Static curve of the latest settings: gain reduction in dB for a detector level in dB */
+    float computeGainReductionDb(float levelDb) const noexcept { return computeGainReductionDb(configured, levelDb); }
+
+private:
+    struct Settings {
+        float threshold = -20.0f;
+        float slope = 0.75f;            // 1 - 1 / ratio
+        float kneeWidth = 2.0f;
+        float range = 60.0f;
+        float makeupDb = 0.0f;
+        float link = 1.0f;
+        float kneeStartPower = 0.0f;    // Detector power below which no reduction applies
+        float attackMs = 2.0f;
+        float releaseMs = 100.0f;
+        float attackCoeff = 0.0f;
+        float releaseCoeff = 0.0f;
+        float windowMs = 10.0f;
+        int windowLength = 1;
+        bool truePeak = false;
+        SlidingWindowDetector::Mode detectionMode = SlidingWindowDetector::Mode::RMS;
+    };
+
+    static float computeGainReductionDb(const Settings& settings, float levelDb) noexcept;
+    void updateCoefficients(Settings& settings) const noexcept;
+    void publish() noexcept;
+    void takeLatestSettings() noexcept;
+    void applyDetectorSettings() noexcept;
+    void processChunk(float* const* channels, int numChannels, int numSamples,
+                      const float* const* sidechain, int numSidechainChannels,
+                      const float* keyPower, int offset) noexcept;
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+
+    // Settings: the writer fills configured and publishes it into its back
+    // slot; latestSlot holds the newest slot index (plus freshBit until the
+    // audio thread takes it) and audioSlot is the one being rendered with
+    static constexpr int freshBit = 4;
+    Settings configured;
+    Settings slots[3];
+    int backSlot = 0;
+    int audioSlot = 1;
+    std::atomic<int> latestSlot { 2 };
+
+    // State
+    SlidingWindowDetector detectors[maxChannels];
+    float previousInput[maxChannels] = {};
+    float smoothedReduction[maxChannels] = {};
+    float lastGainReductionDb = 0.0f;
+
+    std::vector<float> gainBuffer;  // maxChannels x maxBlockSize, dB then linear
+};
+
+} // namespace dynamics
+} // namespace schill
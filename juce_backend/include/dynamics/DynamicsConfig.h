@@ -0,0 +1,139 @@
+#pragma once
+
+namespace schill {
+namespace dynamics {
+
+//==============================================================================
+// Dynamics Configuration
+//==============================================================================
+
+/*
+ * Plain parameter structs shared by DynamicsProcessor and the JUCE-free
+ * cores (CompressorCore, TruePeakLimiter, MultibandDynamics).
+ */
+
+enum class CompressorMode {
+    Peak,
+    RMS,
+    TruePeak,
+    LUFS,
+    RMS_VU,
+    Custom
+};
+
+enum class LimiterType {
+    Brickwall,
+    SoftClip,
+    Loudness,
+    TruePeak,
+    K14,
+    Custom
+};
+
+//==============================================================================
+// Advanced Compressor Configuration
+//==============================================================================
+
+struct CompressorConfig {
+    // Basic parameters
+    float threshold = -20.0f;         // dB
+    float ratio = 4.0f;                // 1:1 to ∞:1
+    float attackTime = 2.0f;           // ms
+    float releaseTime = 100.0f;         // ms
+    float makeupGain = 0.0f;            // dB
+
+    // Advanced parameters
+    float kneeWidth = 2.0f;             // dB for soft knee
+    float range = 60.0f;                // Maximum gain reduction
+    CompressorMode mode = CompressorMode::RMS;
+    bool autoMakeup = true;              // Automatic makeup gain
+    bool autoRelease = false;            // Auto release based on input
+    bool lookaheadEnabled = true;        // Lookahead processing
+    float lookaheadTime = 2.0f;          // ms
+
+    // Stereo linking
+    bool stereoLink = true;              // Link stereo channels
+    float stereoLinkRatio = 1.0f;        // 0-1, how much linking
+
+    // Sidechain options
+    bool externalSidechain = false;
+    float sidechainFrequency = 1000.0f;  // Hz for frequency-dependent sidechain
+    float sidechainQ = 1.0f;             // Q factor for sidechain filter
+    bool sidechainListen = false;         // Monitor sidechain input
+
+    // Character options
+    float warmth = 0.0f;                 // 0-1, adds analog saturation
+    float tubeDrive = 0.0f;              // 0-1, tube saturation
+    float colorAmount = 0.0f;            // 0-1, frequency-dependent saturation
+
+    // Detection
+    float attackShape = 0.5f;            // 0-1, attack curve shape
+    float releaseShape = 0.5f;           // 0-1, release curve shape
+    bool adaptiveRelease = false;        // Adaptive release based on program material
+
+    // UI feedback
+    bool showGainReduction = true;
+    bool showInputLevel = true;
+    bool showOutputLevel = true;
+    bool showGRMeter = true;
+
+    // Advanced features
+    bool parallelProcessing = false;    // Mix wet/dry signals
+    float mixAmount = 0.0f;             // 0-1, wet/dry mix
+    bool midSideProcessing = false;      // Mid/Side processing
+    float midSideAmount = 0.0f;         // 0-1, amount of M/S processing
+
+    // Automation
+    bool automationEnabled = true;
+    float automationSmoothTime = 50.0f;  // ms
+};
+
+//==============================================================================
+// Limiter Configuration
+//==============================================================================
+
+struct LimiterConfig {
+    // Basic parameters
+    float ceiling = -0.1f;              // dBFS
+    float releaseTime = 10.0f;           // ms
+    LimiterType type = LimiterType::Brickwall;
+
+    // Advanced parameters
+    float threshold = 0.0f;             // dB (below ceiling)
+    float kneeWidth = 1.0f;             // dB for soft limiting
+    float lookaheadTime = 0.5f;          // ms
+    bool overshootProtection = true;     // Prevent overshoots
+
+    // True peak limiting
+    bool truePeakMode = false;           // ITU-1770 compliant true peak
+    float oversamplingFactor = 4.0f;     // For accurate true peak detection
+    float interChannelCrest = 0.5f;      // Allow inter-sample peaks
+
+    // Loudness limiting (K-system)
+    bool kSystemMode = false;             // K-14 loudness normalization
+    float targetLUFS = -14.0f;           // Target loudness
+    float allowedOvershoot = 0.5f;       // Allowed overshoot in LU
+
+    // Character options
+    float saturationAmount = 0.0f;       // 0-1, saturation before limiting
+    LimiterType clipType = LimiterType::SoftClip; // Pre-limiting saturation
+    float clipThreshold = -0.5f;         // dB, saturation threshold
+
+    // Stereo/Mono
+    bool monoMode = false;                // Convert to mono before limiting
+    bool midSideMode = false;             // Mid/Side limiting
+    float sideLimitingAmount = 0.0f;     // Amount of side limiting
+
+    // UI and monitoring
+    bool showPeakLevels = true;
+    bool showLoudness = false;
+    bool showTruePeak = true;
+    bool showLimitingCurve = false;
+
+    // Adaptive features
+    bool adaptiveRelease = false;        // Adaptive release based on content
+    float adaptiveRatio = 2.0f;          // Ratio for adaptive release
+};
+
+} // namespace dynamics
+} // namespace schill
@@ -254,6 +254,8 @@ public:
     // Main processing
     void processBlock(juce::AudioBuffer<float>& buffer);
     void processStereo(juce::AudioBuffer<float>& leftBuffer, juce::AudioBuffer<float>& rightBuffer);
+    // Processes the first numChannels of any layout in place (5.1 through
+    // 7.1.4, Ambisonics); Mid/Side applies to the front L/R pair only
     void processMultichannel(juce::AudioBuffer<float>& buffer, int numChannels);
 
     // Sidechain routing
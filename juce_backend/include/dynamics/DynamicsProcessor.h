@@ -2,6 +2,10 @@
 
 #include <JuceHeader.h>
 #include "FilterGate.h"
+#include "DynamicsConfig.h"
+#include "CompressorCore.h"
+#include "TruePeakLimiter.h"
+#include "MultibandDynamics.h"
 
 namespace schill {
 namespace dynamics {
@@ -21,129 +25,6 @@ enum class DynamicsProcessorType {
     CharacterProcessor
 };
 
-enum class CompressorMode {
-    Peak,
-    RMS,
-    TruePeak,
-    LUFS,
-    RMS_VU,
-    Custom
-};
-
-enum class LimiterType {
-    Brickwall,
-    SoftClip,
-    Loudness,
-    TruePeak,
-    K14,
-    Custom
-};
-
-//==============================================================================
-// Advanced Compressor Configuration
-//==============================================================================
-
-struct CompressorConfig {
-    // Basic parameters
-    float threshold = -20.0f;         // dB
-    float ratio = 4.0f;                // 1:1 to ∞:1
-    float attackTime = 2.0f;           // ms
-    float releaseTime = 100.0f;         // ms
-    float makeupGain = 0.0f;            // dB
-
-    // Advanced parameters
-    float kneeWidth = 2.0f;             // dB for soft knee
-    float range = 60.0f;                // Maximum gain reduction
-    CompressorMode mode = CompressorMode::RMS;
-    bool autoMakeup = true;              // Automatic makeup gain
-    bool autoRelease = false;            // Auto release based on input
-    bool lookaheadEnabled = true;        // Lookahead processing
-    float lookaheadTime = 2.0f;          // ms
-
-    // Stereo linking
-    bool stereoLink = true;              // Link stereo channels
-    float stereoLinkRatio = 1.0f;        // 0-1, how much linking
-
-    // Sidechain options
-    bool externalSidechain = false;
-    float sidechainFrequency = 1000.0f;  // Hz for frequency-dependent sidechain
-    float sidechainQ = 1.0f;             // Q factor for sidechain filter
-    bool sidechainListen = false;         // Monitor sidechain input
-
-    // Character options
-    float warmth = 0.0f;                 // 0-1, adds analog saturation
-    float tubeDrive = 0.0f;              // 0-1, tube saturation
-    float colorAmount = 0.0f;            // 0-1, frequency-dependent saturation
-
-    // Detection
-    float attackShape = 0.5f;            // 0-1, attack curve shape
-    float releaseShape = 0.5f;           // 0-1, release curve shape
-    bool adaptiveRelease = false;        // Adaptive release based on program material
-
-    // UI feedback
-    bool showGainReduction = true;
-    bool showInputLevel = true;
-    bool showOutputLevel = true;
-    bool showGRMeter = true;
-
-    // Advanced features
-    bool parallelProcessing = false;    // Mix wet/dry signals
-    float mixAmount = 0.0f;             // 0-1, wet/dry mix
-    bool midSideProcessing = false;      // Mid/Side processing
-    float midSideAmount = 0.0f;         // 0-1, amount of M/S processing
-
-    // Automation
-    bool automationEnabled = true;
-    float automationSmoothTime = 50.0f;  // ms
-};
-
-//==============================================================================
-// Limiter Configuration
-//==============================================================================
-
-struct LimiterConfig {
-    // Basic parameters
-    float ceiling = -0.1f;              // dBFS
-    float releaseTime = 10.0f;           // ms
-    LimiterType type = LimiterType::Brickwall;
-
-    // Advanced parameters
-    float threshold = 0.0f;             // dB (below ceiling)
-    float kneeWidth = 1.0f;             // dB for soft limiting
-    float lookaheadTime = 0.5f;          // ms
-    bool overshootProtection = true;     // Prevent overshoots
-
-    // True peak limiting
-    bool truePeakMode = false;           // ITU-1770 compliant true peak
-    float oversamplingFactor = 4.0f;     // For accurate true peak detection
-    float interChannelCrest = 0.5f;      // Allow inter-sample peaks
-
-    // Loudness limiting (K-system)
-    bool kSystemMode = false;             // K-14 loudness normalization
-    float targetLUFS = -14.0f;           // Target loudness
-    float allowedOvershoot = 0.5f;       // Allowed overshoot in LU
-
-    // Character options
-    float saturationAmount = 0.0f;       // 0-1, saturation before limiting
-    LimiterType clipType = LimiterType::SoftClip; // Pre-limiting saturation
-    float clipThreshold = -0.5f;         // dB, saturation threshold
-
-    // Stereo/Mono
-    bool monoMode = false;                // Convert to mono before limiting
-    bool midSideMode = false;             // Mid/Side limiting
-    float sideLimitingAmount = 0.0f;     // Amount of side limiting
-
-    // UI and monitoring
-    bool showPeakLevels = true;
-    bool showLoudness = false;
-    bool showTruePeak = true;
-    bool showLimitingCurve = false;
-
-    // Adaptive features
-    bool adaptiveRelease = false;        // Adaptive release based on content
-    float adaptiveRatio = 2.0f;          // Ratio for adaptive release
-};
-
 //==============================================================================
 // Envelope Follower for Sidechain Detection
 //==============================================================================
@@ -211,12 +92,16 @@ private:
     float postGain = 1.0f;
 
     juce::LinearSmoothedValue<float> smoothedEnvelope;
-    std::queue<float> historyBuffer;
+    juce::LinearSmoothedValue<float> smoothedPeak;
+
+    // Fixed-size detection window (no allocation after construction)
+    SlidingWindowDetector detector;
+    float previousInput = 0.0f;
     static constexpr int historySize = 1024;
 
     void updateRates();
+    void updateDetector();
     void updatePeakAndRMS(const float* samples, int numSamples);
-    float detectLevel(const float* samples, int numSamples);
 };
 
 //==============================================================================
@@ -235,6 +120,9 @@ public:
 
     // Main processing
     void processBlock(juce::AudioBuffer<float>& buffer);
+
+    /** Processing delay to report to the host (limiter lookahead) */
+    int getLatencySamples() const noexcept;
     void processStereo(juce::AudioBuffer<float>& buffer);
     void processMono(juce::AudioBuffer<float>& buffer);
 
@@ -264,6 +152,18 @@ public:
     void processSidechainInput(const juce::AudioBuffer<float>& sidechainBuffer);
     void processSidechainInput(const float* sidechainData, int numSamples);
 
+    /**
+     * Shared sidechain (SidechainBus): the key is read in place and, for
+     * the compressor, keyPower is a detector stream computed once for all
+     * subscribers. Pointers must stay valid until the next processBlock,
+     * which consumes them; keyPower may be null.
+     */
+    void setSharedSidechain(const float* const* keyChannels, int numKeyChannels,
+                            const float* keyPower, int numSamples) noexcept;
+
+    /** Detector settings the compressor expects from a shared key stream */
+    const CompressorCore& getCompressorCore() const noexcept { return compressorCore; }
+
     // Multiband support
     void enableMultiband(bool enabled);
     void setCrossoverFrequencies(const std::vector<float>& frequencies);
@@ -345,6 +245,8 @@ private:
 
     // Processing components
     std::unique_ptr<EnvelopeFollower> envelopeFollower;
+    CompressorCore compressorCore;
+    TruePeakLimiter truePeakLimiter;
     std::vector<std::unique_ptr<juce::dsp::ProcessorDuplicator<float>> duplicators;
     std::vector<std::unique_ptr<juce::dsp::ProcessorChain<float, juce::dsp::ProcessorBase>>> processingChains;
     std::vector<std::unique_ptr<juce::dsp::Gain<float>>> gainStages;
@@ -352,8 +254,7 @@ private:
     // Multiband processing
     bool multibandEnabled = false;
     std::vector<float> crossoverFrequencies;
-    std::vector<std::unique_ptr<juce::dsp::LinkwitzRileyFilter<float>>> crossoverFilters;
-    std::vector<float> bandOutputs;
+    MultibandDynamics multibandDynamics;
 
     // Sidechain processing
     juce::AudioBuffer<float> sidechainBuffer;
@@ -361,6 +262,12 @@ private:
     bool sidechainEnabled = false;
     bool sidechainListen = false;
 
+    // Shared sidechain views, valid for one block
+    const float* const* sharedKeyChannels = nullptr;
+    int sharedKeyNumChannels = 0;
+    const float* sharedKeyPower = nullptr;
+    int sharedKeyNumSamples = 0;
+
     // Character processing
     float saturationAmount = 0.0f;
     float tubeDriveAmount = 0.0f;
@@ -395,6 +302,7 @@ private:
     std::unique_ptr<juce::dsp::FFT> fft;
     std::vector<float> fftBuffer;
     std::vector<float> magnitudeBuffer;
+    std::vector<float> analysisBuffer;
 
     // Internal processing
     void processCompressor(juce::AudioBuffer<float>& buffer);
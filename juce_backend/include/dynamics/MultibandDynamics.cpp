@@ -0,0 +1,347 @@
+#include "MultibandDynamics.h"
+#include "DynamicsConfig.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace schill {
+namespace dynamics {
+
+namespace {
+    constexpr double pi = 3.14159265358979323846;
+    constexpr float sqrt2 = 1.41421356f;
+}
+
+//==============================================================================
+// MultibandDynamics Implementation
+//==============================================================================
+
+MultibandDynamics::MultibandDynamics() {
+    for (int band = 0; band < laneCount; ++band) {
+        detectorCoeff[band] = 1.0f;
+    }
+
+    for (int band = 0; band < maxBands; ++band) {
+        setBandParameters(band, CompressorConfig{});
+    }
+}
+
+void MultibandDynamics::prepare(double newSampleRate, int newMaxBlockSize) {
+    sampleRate = newSampleRate;
+    maxBlockSize = std::max(1, newMaxBlockSize);
+
+    const size_t bandSize = static_cast<size_t>(maxBands * maxChannels * maxBlockSize);
+    bandBuffer.assign(bandSize, 0.0f);
+    sidechainBuffer.assign(bandSize, 0.0f);
+    gainBuffer.assign(static_cast<size_t>(laneCount * maxBlockSize), 1.0f);
+
+    updateCrossoverCoefficients();
+    for (int band = 0; band < maxBands; ++band) {
+        updateBandCoefficients(band);
+    }
+
+    reset();
+}
+
+void MultibandDynamics::reset() noexcept {
+    for (int ch = 0; ch < maxChannels; ++ch) {
+        for (int split = 0; split < maxCrossovers; ++split) {
+            crossovers[ch][split] = CrossoverState{};
+            sidechainCrossovers[ch][split] = CrossoverState{};
+        }
+    }
+
+    std::fill(std::begin(detectedPower), std::end(detectedPower), 0.0f);
+    std::fill(std::begin(smoothedReduction), std::end(smoothedReduction), 0.0f);
+    std::fill(std::begin(bandGainReductionDb), std::end(bandGainReductionDb), 0.0f);
+    lastGainReductionDb = 0.0f;
+}
+
+void MultibandDynamics::setCrossoverFrequencies(const std::vector<float>& frequencies) {
+    std::vector<float> sorted(frequencies.begin(),
+                              frequencies.begin() + std::min<size_t>(frequencies.size(), maxCrossovers));
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        crossoverHz[i] = sorted[i];
+    }
+
+    // Moving a crossover keeps the filter state; a different tree does not
+    const int newNumBands = static_cast<int>(sorted.size()) + 1;
+    if (newNumBands != numBands) {
+        numBands = newNumBands;
+        reset();
+    }
+
+    updateCrossoverCoefficients();
+}
+
+void MultibandDynamics::setBandParameters(int band, const CompressorConfig& config) {
+    if (band < 0 || band >= maxBands) {
+        return;
+    }
+
+    const float ratio = std::max(1.0f, config.ratio);
+    const float knee = std::max(0.0f, config.kneeWidth);
+
+    threshold[band] = config.threshold;
+    slope[band] = 1.0f - 1.0f / ratio;
+    kneeWidth[band] = knee;
+    halfKnee[band] = knee * 0.5f;
+    inverseTwoKnee[band] = (knee > 0.0f) ? 0.5f / knee : 0.0f;
+    range[band] = std::max(0.0f, config.range);
+    makeupDb[band] = config.makeupGain;
+    externalKey[band] = config.externalSidechain;
+    attackMs[band] = config.attackTime;
+    releaseMs[band] = config.releaseTime;
+
+    // Same integration times as the broadband core's windows
+    switch (config.mode) {
+        case CompressorMode::Peak:
+        case CompressorMode::TruePeak:
+            detectorMs[band] = 0.0f;
+            break;
+
+        case CompressorMode::RMS_VU:
+            detectorMs[band] = 300.0f;
+            break;
+
+        case CompressorMode::LUFS:
+            detectorMs[band] = 400.0f;
+            break;
+
+        case CompressorMode::RMS:
+        case CompressorMode::Custom:
+        default:
+            detectorMs[band] = 10.0f;
+            break;
+    }
+
+    updateBandCoefficients(band);
+}
+
+float MultibandDynamics::getBandGainReductionDb(int band) const noexcept {
+    return (band >= 0 && band < maxBands) ? bandGainReductionDb[band] : 0.0f;
+}
+
+void MultibandDynamics::updateCrossoverCoefficients() {
+    const float nyquistLimit = static_cast<float>(sampleRate * 0.45);
+    float lowest = 20.0f;
+
+    for (int split = 0; split < numBands - 1; ++split) {
+        // Keep the splits ascending even when clamped
+        const float hz = std::clamp(crossoverHz[split], lowest, std::max(lowest, nyquistLimit));
+        lowest = hz;
+
+        const float g = static_cast<float>(std::tan(pi * hz / sampleRate));
+        crossoverG[split] = g;
+        crossoverH[split] = 1.0f / (1.0f + sqrt2 * g + g * g);
+    }
+}
+
+void MultibandDynamics::updateBandCoefficients(int band) {
+    attackCoeff[band] = static_cast<float>(std::exp(-1.0 / (sampleRate * std::max(0.01f, attackMs[band]) * 0.001)));
+    releaseCoeff[band] = static_cast<float>(std::exp(-1.0 / (sampleRate * std::max(0.01f, releaseMs[band]) * 0.001)));
+    detectorCoeff[band] = (detectorMs[band] > 0.0f)
+        ? static_cast<float>(1.0 - std::exp(-1.0 / (sampleRate * detectorMs[band] * 0.001)))
+        : 1.0f;
+}
+
+void MultibandDynamics::process(float* const* channels, int numChannels, int numSamples,
+                                const float* const* sidechain, int numSidechainChannels) noexcept {
+    std::fill(std::begin(bandGainReductionDb), std::end(bandGainReductionDb), 0.0f);
+    lastGainReductionDb = 0.0f;
+
+    if (numChannels <= 0 || numSamples <= 0 || maxBlockSize == 0) {
+        return;
+    }
+
+    if (sidechain == nullptr || numSidechainChannels <= 0) {
+        sidechain = nullptr;
+        numSidechainChannels = 0;
+    }
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize) {
+        processChunk(channels, numChannels, std::min(maxBlockSize, numSamples - offset),
+                     sidechain, numSidechainChannels, offset);
+    }
+
+    for (int band = 0; band < numBands; ++band) {
+        lastGainReductionDb = std::max(lastGainReductionDb, bandGainReductionDb[band]);
+    }
+}
+
+void MultibandDynamics::splitBands(CrossoverState (&state)[maxChannels][maxCrossovers], const float* input,
+                                   float* bandData, int channel, int numSamples, bool compensate) noexcept {
+    const size_t bandStride = static_cast<size_t>(maxChannels * maxBlockSize);
+    const float r2 = sqrt2;
+
+    // The top band's slot carries the remainder down the tree
+    float* remainder = bandData + static_cast<size_t>(numBands - 1) * bandStride + static_cast<size_t>(channel * maxBlockSize);
+    std::copy(input, input + numSamples, remainder);
+
+    for (int split = 0; split < numBands - 1; ++split) {
+        float* low = bandData + static_cast<size_t>(split) * bandStride + static_cast<size_t>(channel * maxBlockSize);
+        auto& s = state[channel][split];
+        const float g = crossoverG[split];
+        const float h = crossoverH[split];
+
+        float s1 = s.split[0], s2 = s.split[1], s3 = s.split[2];
+        float s4 = s.split[3], s5 = s.split[4], s6 = s.split[5];
+
+        for (int i = 0; i < numSamples; ++i) {
+            // Butterworth SVF shared by both outputs
+            const float yH = (remainder[i] - (r2 + g) * s1 - s2) * h;
+            const float yB = g * yH + s1;
+            s1 = g * yH + yB;
+            const float yL = g * yB + s2;
+            s2 = g * yB + yL;
+
+            // Second Butterworth stage on each output gives LR4
+            const float lH = (yL - (r2 + g) * s3 - s4) * h;
+            const float lB = g * lH + s3;
+            s3 = g * lH + lB;
+            const float lL = g * lB + s4;
+            s4 = g * lB + lL;
+
+            const float hH = (yH - (r2 + g) * s5 - s6) * h;
+            const float hB = g * hH + s5;
+            s5 = g * hH + hB;
+            const float hL = g * hB + s6;
+            s6 = g * hB + hL;
+
+            low[i] = lL;
+            remainder[i] = hH;
+        }
+
+        s.split[0] = s1; s.split[1] = s2; s.split[2] = s3;
+        s.split[3] = s4; s.split[4] = s5; s.split[5] = s6;
+
+        if (!compensate) {
+            continue;
+        }
+
+        // Bands below this split see the allpass that LP + HP forms above it.
+        // Their recurrences are independent, so they share one pass.
+        float* lowerBands[maxCrossovers];
+        float a1[maxCrossovers], a2[maxCrossovers];
+        for (int lower = 0; lower < split; ++lower) {
+            lowerBands[lower] = bandData + static_cast<size_t>(lower) * bandStride + static_cast<size_t>(channel * maxBlockSize);
+            a1[lower] = s.allpass[lower][0];
+            a2[lower] = s.allpass[lower][1];
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            for (int lower = 0; lower < split; ++lower) {
+                const float x = lowerBands[lower][i];
+                const float yH = (x - (r2 + g) * a1[lower] - a2[lower]) * h;
+                const float yB = g * yH + a1[lower];
+                a1[lower] = g * yH + yB;
+                const float yL = g * yB + a2[lower];
+                a2[lower] = g * yB + yL;
+                lowerBands[lower][i] = x - 2.0f * r2 * yB;
+            }
+        }
+
+        for (int lower = 0; lower < split; ++lower) {
+            s.allpass[lower][0] = a1[lower];
+            s.allpass[lower][1] = a2[lower];
+        }
+    }
+}
+
+void MultibandDynamics::processChunk(float* const* channels, int numChannels, int numSamples,
+                                     const float* const* sidechain, int numSidechainChannels, int offset) noexcept {
+    const int numProcessed = std::min(numChannels, maxChannels);
+    const int numKeyChannels = std::min(numSidechainChannels, maxChannels);
+
+    bool keyed = false;
+    for (int band = 0; band < numBands; ++band) {
+        keyed = keyed || (sidechain != nullptr && externalKey[band]);
+    }
+
+    for (int ch = 0; ch < numProcessed; ++ch) {
+        splitBands(crossovers, channels[ch] + offset, bandBuffer.data(), ch, numSamples, true);
+    }
+
+    // Detection needs only magnitudes, so the key bands skip the allpasses
+    if (keyed) {
+        for (int ch = 0; ch < numKeyChannels; ++ch) {
+            splitBands(sidechainCrossovers, sidechain[ch] + offset, sidechainBuffer.data(), ch, numSamples, false);
+        }
+    }
+
+    const float* keys[maxBands][maxChannels];
+    int keyChannels[maxBands];
+    for (int band = 0; band < numBands; ++band) {
+        const bool external = keyed && externalKey[band];
+        keyChannels[band] = external ? numKeyChannels : numProcessed;
+
+        for (int ch = 0; ch < keyChannels[band]; ++ch) {
+            keys[band][ch] = external ? bandPointer(sidechainBuffer, band, ch) : bandPointer(bandBuffer, band, ch);
+        }
+    }
+
+    // Detection and gain computer, all bands in lanes
+    alignas(32) float peakReduction[laneCount] = {};
+    for (int i = 0; i < numSamples; ++i) {
+        alignas(32) float power[laneCount] = {};
+
+        for (int band = 0; band < numBands; ++band) {
+            for (int ch = 0; ch < keyChannels[band]; ++ch) {
+                const float x = keys[band][ch][i];
+                power[band] = std::max(power[band], x * x);
+            }
+        }
+
+        float* gains = gainBuffer.data() + static_cast<size_t>(i * laneCount);
+        for (int lane = 0; lane < laneCount; ++lane) {
+            const float detected = detectedPower[lane] + detectorCoeff[lane] * (power[lane] - detectedPower[lane]);
+            detectedPower[lane] = detected;
+
+            // Soft knee without branches: the quadratic part saturates at
+            // the top of the knee, the linear part starts there
+            const float overshoot = FastMath::powerToDecibels(detected) - threshold[lane];
+            const float kneePosition = std::min(std::max(overshoot + halfKnee[lane], 0.0f), kneeWidth[lane]);
+            const float reduction = std::min(range[lane],
+                slope[lane] * (kneePosition * kneePosition * inverseTwoKnee[lane]
+                               + std::max(overshoot - halfKnee[lane], 0.0f)));
+
+            // Both coefficients loaded up front keep this a select
+            const float previous = smoothedReduction[lane];
+            const float attack = attackCoeff[lane];
+            const float release = releaseCoeff[lane];
+            const float coeff = (reduction > previous) ? attack : release;
+            const float smoothed = reduction + coeff * (previous - reduction);
+            smoothedReduction[lane] = smoothed;
+
+            gains[lane] = FastMath::decibelsToGain(makeupDb[lane] - smoothed);
+            peakReduction[lane] = std::max(peakReduction[lane], smoothed);
+        }
+    }
+
+    // Weight each band by its gain and sum back into the channel
+    for (int ch = 0; ch < numProcessed; ++ch) {
+        float* out = channels[ch] + offset;
+        const float* gains = gainBuffer.data();
+
+        const float* first = bandPointer(bandBuffer, 0, ch);
+        for (int i = 0; i < numSamples; ++i) {
+            out[i] = first[i] * gains[i * laneCount];
+        }
+
+        for (int band = 1; band < numBands; ++band) {
+            const float* data = bandPointer(bandBuffer, band, ch);
+            for (int i = 0; i < numSamples; ++i) {
+                out[i] += data[i] * gains[i * laneCount + band];
+            }
+        }
+    }
+
+    for (int band = 0; band < numBands; ++band) {
+        bandGainReductionDb[band] = std::max(bandGainReductionDb[band], peakReduction[band]);
+    }
+}
+
+} // namespace dynamics
+} // namespace schill
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CompressorCore.h"
+
+#include <vector>
+
+namespace schill {
+namespace dynamics {
+
+struct CompressorConfig;
+
+//==============================================================================
+// Multiband Dynamics
+//==============================================================================
+
+/**
+ * Band-split compressor for up to maxBands bands.
+ *
+ * Crossovers are 4th-order Linkwitz-Riley (two cascaded Butterworth SVFs)
+ * arranged as a tree: each split takes the low band off the remainder. Bands
+ * below a split get a matching 2nd-order allpass, so every band carries the
+ * same phase and the bands sum back to a flat (allpassed) response.
+ *
+ * Detectors and gain computers are laid out structure-of-arrays with one
+ * lane per band (laneCount lanes, padded), so the per-sample detection,
+ * soft-knee curve, attack/release and dB-to-gain steps run across all bands
+ * in one vectorizable loop. Detection is linked across channels.
+ *
+ * A band whose CompressorConfig has externalSidechain set is keyed by the
+ * matching band of the sidechain input, which goes through its own
+ * crossover bank.
+ */
+class MultibandDynamics {
+public:
+    static constexpr int maxBands = 6;
+    static constexpr int maxCrossovers = maxBands - 1;
+    static constexpr int laneCount = 8;
+    static constexpr int maxChannels = 8;
+
+    MultibandDynamics();
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset() noexcept;
+
+    /** Up to maxCrossovers frequencies; sorted and clamped to the audio band */
+    void setCrossoverFrequencies(const std::vector<float>& frequencies);
+    int getNumBands() const noexcept { return numBands; }
+
+    /** Takes threshold, ratio, knee, range, times, makeup, mode and externalSidechain */
+    void setBandParameters(int band, const CompressorConfig& config);
+
+    /**
+     * Compress in place. Keyed bands are linked across the sidechain's
+     * channels; without a sidechain every band keys from its own signal.
+     */
+    void process(float* const* channels, int numChannels, int numSamples,
+                 const float* const* sidechain = nullptr, int numSidechainChannels = 0) noexcept;
+
+    /** Largest gain reduction of the last block, in dB (positive) */
+    float getGainReductionDb() const noexcept { return lastGainReductionDb; }
+    float getBandGainReductionDb(int band) const noexcept;
+
+private:
+    // One LR4 split: a shared first SVF, a second SVF per output, plus the
+    // compensation allpass state for each lower band
+    struct CrossoverState {
+        float split[6] = {};
+        float allpass[maxCrossovers][2] = {};
+    };
+
+    void updateCrossoverCoefficients();
+    void updateBandCoefficients(int band);
+    void splitBands(CrossoverState (&state)[maxChannels][maxCrossovers], const float* input,
+                    float* bandData, int channel, int numSamples, bool compensate) noexcept;
+    void processChunk(float* const* channels, int numChannels, int numSamples,
+                      const float* const* sidechain, int numSidechainChannels, int offset) noexcept;
+
+    float* bandPointer(std::vector<float>& buffer, int band, int channel) noexcept {
+        return buffer.data() + (static_cast<size_t>(band) * maxChannels + static_cast<size_t>(channel)) * static_cast<size_t>(maxBlockSize);
+    }
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+
+    // Crossovers
+    int numBands = 1;
+    float crossoverHz[maxCrossovers] = {};
+    float crossoverG[maxCrossovers] = {};    // tan(pi fc / fs)
+    float crossoverH[maxCrossovers] = {};    // 1 / (1 + sqrt2 g + g^2)
+    CrossoverState crossovers[maxChannels][maxCrossovers];
+    CrossoverState sidechainCrossovers[maxChannels][maxCrossovers];
+
+    // Per-band settings, one lane per band
+    float attackMs[laneCount] = {};
+    float releaseMs[laneCount] = {};
+    float detectorMs[laneCount] = {};    // 0 = peak
+    alignas(32) float threshold[laneCount] = {};
+    alignas(32) float slope[laneCount] = {};
+    alignas(32) float halfKnee[laneCount] = {};
+    alignas(32) float kneeWidth[laneCount] = {};
+    alignas(32) float inverseTwoKnee[laneCount] = {};
+    alignas(32) float range[laneCount] = {};
+    alignas(32) float makeupDb[laneCount] = {};
+    alignas(32) float attackCoeff[laneCount] = {};
+    alignas(32) float releaseCoeff[laneCount] = {};
+    alignas(32) float detectorCoeff[laneCount] = {};  // 1 = peak, else power averaging
+    bool externalKey[maxBands] = {};
+
+    // Per-band state
+    alignas(32) float detectedPower[laneCount] = {};
+    alignas(32) float smoothedReduction[laneCount] = {};
+    float bandGainReductionDb[maxBands] = {};
+    float lastGainReductionDb = 0.0f;
+
+    std::vector<float> bandBuffer;       // maxBands x maxChannels x maxBlockSize
+    std::vector<float> sidechainBuffer;  // same layout, detection only
+    std::vector<float> gainBuffer;       // maxBlockSize x laneCount (lanes interleaved), linear
+};
+
+} // namespace dynamics
+} // namespace schill
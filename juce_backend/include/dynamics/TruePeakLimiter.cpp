@@ -0,0 +1,236 @@
+#include "TruePeakLimiter.h"
+#include "DynamicsConfig.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace schill {
+namespace dynamics {
+
+namespace {
+    constexpr double pi = 3.14159265358979323846;
+}
+
+//==============================================================================
+// TruePeakLimiter Implementation
+//==============================================================================
+
+void TruePeakLimiter::prepare(double newSampleRate, int newMaxBlockSize, int numChannels) {
+    sampleRate = newSampleRate;
+    maxBlockSize = std::max(1, newMaxBlockSize);
+    numPreparedChannels = std::max(1, numChannels);
+
+    const int maxLookahead = static_cast<int>(std::ceil(maxLookaheadMs * 0.001 * sampleRate));
+    const int maxHistory = maxLookahead + tapsPerPhase;
+    historyStride = maxHistory + maxBlockSize;
+
+    history.assign(static_cast<size_t>(numPreparedChannels * historyStride), 0.0f);
+    peakBuffer.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+    phaseBuffer.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+    gainBuffer.assign(static_cast<size_t>(maxBlockSize), 1.0f);
+
+    holdWindow.prepare(maxLookahead + 2);
+    smoothWindow.prepare(maxLookahead + 2);
+
+    // Blackman-windowed sinc for the fractional phases; tap j weights
+    // x[n - j] for the point (tapsPerPhase / 2 - j - fraction) samples away
+    const double halfSpan = tapsPerPhase / 2.0;
+    for (int phase = 0; phase < oversampling - 1; ++phase) {
+        const double fraction = (phase + 1) / static_cast<double>(oversampling);
+        double sum = 0.0;
+
+        for (int j = 0; j < tapsPerPhase; ++j) {
+            const double t = halfSpan - j - fraction;
+            const double sinc = std::sin(pi * t) / (pi * t);
+            const double w = 0.42 + 0.5 * std::cos(pi * t / halfSpan)
+                           + 0.08 * std::cos(2.0 * pi * t / halfSpan);
+            phaseCoefficients[phase][j] = static_cast<float>(sinc * w);
+            sum += sinc * w;
+        }
+
+        for (int j = 0; j < tapsPerPhase; ++j) {
+            phaseCoefficients[phase][j] = static_cast<float>(phaseCoefficients[phase][j] / sum);
+        }
+    }
+
+    historyLength = 0;
+    applyPendingParameters();
+}
+
+void TruePeakLimiter::reset() noexcept {
+    std::fill(history.begin(), history.end(), 0.0f);
+    holdWindow.reset();
+    smoothWindow.reset();
+
+    // Start the gain average at unity rather than fading in from silence
+    for (int i = 0; i < windowLength; ++i) {
+        smoothWindow.process(1.0f);
+    }
+
+    releasedGain = 1.0f;
+    lastGainReductionDb = 0.0f;
+}
+
+void TruePeakLimiter::setParameters(const LimiterConfig& config) {
+    const float lookahead = std::clamp(config.lookaheadTime, 0.0f, maxLookaheadMs);
+    const bool truePeak = config.truePeakMode || config.type == LimiterType::TruePeak;
+
+    pendingCeilingDb.store(std::min(0.0f, config.ceiling), std::memory_order_relaxed);
+    pendingLookaheadMs.store(lookahead, std::memory_order_relaxed);
+    pendingReleaseMs.store(std::max(1.0f, config.releaseTime), std::memory_order_relaxed);
+    pendingTruePeakMode.store(truePeak, std::memory_order_relaxed);
+    parametersChanged.store(true, std::memory_order_release);
+
+    // Hosts ask for the latency straight after a change, before the audio
+    // thread has applied it
+    reportedLatency.store(computeWindowLength(lookahead) - 1 + (truePeak ? tapsPerPhase / 2 : 0),
+                          std::memory_order_relaxed);
+}
+
+int TruePeakLimiter::computeWindowLength(float lookahead) const noexcept {
+    const int maxLookahead = static_cast<int>(std::ceil(maxLookaheadMs * 0.001 * sampleRate));
+    return std::clamp(static_cast<int>(std::lround(lookahead * 0.001 * sampleRate)), 1, std::max(1, maxLookahead));
+}
+
+void TruePeakLimiter::applyPendingParameters() noexcept {
+    parametersChanged.store(false, std::memory_order_relaxed);
+
+    ceilingDb = pendingCeilingDb.load(std::memory_order_relaxed);
+    lookaheadMs = pendingLookaheadMs.load(std::memory_order_relaxed);
+    releaseMs = pendingReleaseMs.load(std::memory_order_relaxed);
+    truePeakMode = pendingTruePeakMode.load(std::memory_order_relaxed);
+
+    updateConfiguration();
+}
+
+void TruePeakLimiter::updateConfiguration() noexcept {
+    ceilingGain = std::pow(10.0f, (ceilingDb - (truePeakMode ? truePeakMarginDb : 0.0f)) / 20.0f);
+    releaseCoeff = static_cast<float>(std::exp(-1.0 / (sampleRate * releaseMs * 0.001)));
+
+    const int newWindowLength = computeWindowLength(lookaheadMs);
+    const int newDetectorDelay = truePeakMode ? tapsPerPhase / 2 : 0;
+
+    // Ceiling and release changes apply seamlessly; only a new delay
+    // structure restarts the limiter
+    if (newWindowLength == windowLength && newDetectorDelay == detectorDelay && historyLength > 0) {
+        return;
+    }
+
+    windowLength = newWindowLength;
+    detectorDelay = newDetectorDelay;
+
+    // The box filter reaches the held gain windowLength - 1 samples after
+    // the detector sees a peak; the hold covers one more sample so the
+    // interpolated point after it is inside too
+    latencySamples = windowLength - 1 + detectorDelay;
+    reportedLatency.store(latencySamples, std::memory_order_relaxed);
+    historyLength = std::max(latencySamples, tapsPerPhase - 1);
+
+    holdWindow.setMode(SlidingWindowDetector::Mode::Peak);
+    holdWindow.setWindowLength(windowLength + 1);
+    smoothWindow.setMode(SlidingWindowDetector::Mode::RMS);   // Moving average
+    smoothWindow.setWindowLength(windowLength);
+
+    reset();
+}
+
+void TruePeakLimiter::process(float* const* channels, int numChannels, int numSamples) noexcept {
+    lastGainReductionDb = 0.0f;
+
+    if (numChannels <= 0 || numSamples <= 0 || maxBlockSize == 0) {
+        return;
+    }
+
+    if (parametersChanged.load(std::memory_order_acquire)) {
+        applyPendingParameters();
+    }
+
+    float minGain = 1.0f;
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize) {
+        const int chunk = std::min(maxBlockSize, numSamples - offset);
+        processChunk(channels, numChannels, chunk, offset);
+
+        for (int i = 0; i < chunk; ++i) {
+            minGain = std::min(minGain, gainBuffer[static_cast<size_t>(i)]);
+        }
+    }
+
+    // Exported once per block
+    lastGainReductionDb = (minGain < 1.0f) ? -20.0f * std::log10(std::max(minGain, 1.0e-6f)) : 0.0f;
+}
+
+void TruePeakLimiter::processChunk(float* const* channels, int numChannels, int numSamples, int offset) noexcept {
+    const int numLimited = std::min(numChannels, numPreparedChannels);
+    float* peaks = peakBuffer.data();
+    float* phaseOut = phaseBuffer.data();
+    float* gains = gainBuffer.data();
+
+    std::fill(peaks, peaks + numSamples, 0.0f);
+
+    // Linked peak detection over the new samples
+    for (int ch = 0; ch < numLimited; ++ch) {
+        float* channelHistory = history.data() + ch * historyStride;
+        float* block = channelHistory + historyLength;
+        std::copy(channels[ch] + offset, channels[ch] + offset + numSamples, block);
+
+        if (!truePeakMode) {
+            for (int i = 0; i < numSamples; ++i) {
+                peaks[i] = std::max(peaks[i], std::abs(block[i]));
+            }
+            continue;
+        }
+
+        const float* centre = block - detectorDelay;
+        for (int i = 0; i < numSamples; ++i) {
+            peaks[i] = std::max(peaks[i], std::abs(centre[i]));
+        }
+
+        for (int phase = 0; phase < oversampling - 1; ++phase) {
+            std::fill(phaseOut, phaseOut + numSamples, 0.0f);
+
+            for (int j = 0; j < tapsPerPhase; ++j) {
+                const float c = phaseCoefficients[phase][j];
+                const float* source = block - j;
+                for (int i = 0; i < numSamples; ++i) {
+                    phaseOut[i] += c * source[i];
+                }
+            }
+
+            for (int i = 0; i < numSamples; ++i) {
+                peaks[i] = std::max(peaks[i], std::abs(phaseOut[i]));
+            }
+        }
+    }
+
+    // Gain envelope: hold the required attenuation over the lookahead,
+    // release, then average over the lookahead
+    const float inverseCeiling = 1.0f / ceilingGain;
+    for (int i = 0; i < numSamples; ++i) {
+        const float attenuation = std::max(1.0f, peaks[i] * inverseCeiling);
+        const float target = 1.0f / holdWindow.process(attenuation);
+
+        releasedGain = (target < releasedGain) ? target : target + releaseCoeff * (releasedGain - target);
+        gains[i] = std::min(1.0f, smoothWindow.process(releasedGain));
+    }
+
+    // Apply to the delayed signal and keep the tail for the next block
+    for (int ch = 0; ch < numLimited; ++ch) {
+        float* channelHistory = history.data() + ch * historyStride;
+        const float* delayed = channelHistory + historyLength - latencySamples;
+
+        float* out = channels[ch] + offset;
+        for (int i = 0; i < numSamples; ++i) {
+            out[i] = delayed[i] * gains[i];
+        }
+        std::memmove(channelHistory, channelHistory + numSamples, sizeof(float) * static_cast<size_t>(historyLength));
+    }
+
+    // No delay line for channels beyond the prepared layout
+    for (int ch = numLimited; ch < numChannels; ++ch) {
+        std::fill(channels[ch] + offset, channels[ch] + offset + numSamples, 0.0f);
+    }
+}
+
+} // namespace dynamics
+} // namespace schill
@@ -50,6 +50,7 @@ public:
     // Processing interface
     void processBlock(juce::AudioBuffer<float>& buffer);
     void processStereo(juce::AudioBuffer<float>& leftBuffer, juce::AudioBuffer<float>& rightBuffer);
+    /** Key for the next processBlock; referenced, not copied, so it must outlive that call */
     void processSidechainInput(const juce::AudioBuffer<float>& sidechainBuffer);
 
     // Parameter interface
@@ -129,7 +130,7 @@ private:
     bool bypassed = false;
     bool enabled = true;
 
-    // Sidechain buffer
+    // Sidechain view onto the caller's key, valid for one block
     juce::AudioBuffer<float> sidechainBuffer;
 
     // Parameter smoothing for external plugins
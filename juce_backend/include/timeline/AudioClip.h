@@ -1,6 +1,9 @@
 #pragma once
 
-#include "JuceHeader.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <limits>
 #include <memory>
 
 namespace SchillingerEcosystem::Timeline {
@@ -33,33 +36,116 @@ namespace AudioConstants {
 
 /**
  * AudioClip represents a segment of audio on the timeline
- * This header matches what AudioClip_safe_example.cpp expects
+ *
+ * The clip plays its source from sourceStart at the source's own speed,
+ * starting at the timeline position start and stopping at end (or when
+ * the source range runs out, whichever comes first). The source is either
+ * a buffer already in memory or an audio file that ClipPlaybackEngine
+ * streams from disk; file clips take their sample rate from the file.
+ *
+ * A clip is a plain value: edit a copy and hand the track's clips to the
+ * engine again.
  */
 class AudioClip {
 public:
-    AudioClip();
+    enum class FadeCurve {
+        Linear,
+        EqualPower      // sin/cos, constant power across a crossfade
+    };
+
+    AudioClip() = default;
+
+    /** Clip playing an in-memory buffer recorded at sampleRate */
     AudioClip(juce::String name,
               const std::shared_ptr<juce::AudioBuffer<float>>& audioData,
-              Core::SampleRate sampleRate);
+              Core::SampleRate sampleRate)
+        : clipName(std::move(name)),
+          audioBuffer(audioData),
+          sourceSampleRate(sampleRate.toHz())
+    {
+        const double length = audioBuffer != nullptr && sourceSampleRate > 0.0
+            ? audioBuffer->getNumSamples() / sourceSampleRate : 0.0;
+        sourceEndPosition = std::max(length, AudioConstants::MIN_TIME_OFFSET);
+        updateDuration();
+    }
+
+    /** Clip streamed from an audio file; the source range defaults to the whole file */
+    AudioClip(juce::String name, const juce::File& file)
+        : clipName(std::move(name)),
+          sourceEndPosition(std::numeric_limits<double>::max()),
+          sourceFile(file)
+    {
+    }
+
     ~AudioClip() = default;
 
-    // Methods expected by the implementation
-    void setPosition(const Core::TimeRange& position);
-    void setSourceRange(const Core::TimeRange& sourceRange);
+    /** Timeline range in seconds; end is kept at least MIN_TIME_OFFSET after start */
+    void setPosition(const Core::TimeRange& position) {
+        startPosition = std::max(0.0, position.start.toSeconds());
+        endPosition = std::max(position.end.toSeconds(), startPosition + AudioConstants::MIN_TIME_OFFSET);
+    }
+
+    /** Range of the source in seconds; playback starts at its start */
+    void setSourceRange(const Core::TimeRange& sourceRange) {
+        sourceStartPosition = std::max(0.0, sourceRange.start.toSeconds());
+        sourceEndPosition = std::max(sourceRange.end.toSeconds(),
+                                     sourceStartPosition + AudioConstants::MIN_TIME_OFFSET);
+    }
+
+    /** Set end so the clip covers the whole source range (in-memory clips) */
+    void updateDuration() {
+        if (sourceEndPosition < std::numeric_limits<double>::max())
+            endPosition = startPosition + (sourceEndPosition - sourceStartPosition);
+    }
 
-    // Stub implementations
-    void updateDuration() {} // Placeholder
-    void someMethod() {} // Placeholder for any missing methods
+    void setName(const juce::String& name) { clipName = name; }
+    void setGain(float newGain) { gain = std::max(0.0f, newGain); }
+
+    /** Fades in seconds, inside the clip; overlapping clips also crossfade automatically */
+    void setFadeIn(double seconds, FadeCurve curve = FadeCurve::EqualPower) {
+        fadeInLength = std::max(0.0, seconds);
+        fadeInCurve = curve;
+    }
+
+    void setFadeOut(double seconds, FadeCurve curve = FadeCurve::EqualPower) {
+        fadeOutLength = std::max(0.0, seconds);
+        fadeOutCurve = curve;
+    }
+
+    const juce::String& getName() const { return clipName; }
+    double getStart() const { return startPosition; }
+    double getEnd() const { return endPosition; }
+    double getLength() const { return endPosition - startPosition; }
+    double getSourceStart() const { return sourceStartPosition; }
+    double getSourceEnd() const { return sourceEndPosition; }
+    float getGain() const { return gain; }
+    double getFadeIn() const { return fadeInLength; }
+    double getFadeOut() const { return fadeOutLength; }
+    FadeCurve getFadeInCurve() const { return fadeInCurve; }
+    FadeCurve getFadeOutCurve() const { return fadeOutCurve; }
+
+    const std::shared_ptr<juce::AudioBuffer<float>>& getAudioBuffer() const { return audioBuffer; }
+    const juce::File& getSourceFile() const { return sourceFile; }
+    bool isStreamed() const { return audioBuffer == nullptr && sourceFile != juce::File(); }
+
+    /** Rate of an in-memory source; streamed clips use the file's rate */
+    double getSourceSampleRate() const { return sourceSampleRate; }
 
 private:
-    // Member variables expected by the implementation
     juce::String clipName = "New Clip";
     double startPosition = 0.0;
     double endPosition = 1.0;
     double sourceStartPosition = 0.0;
     double sourceEndPosition = 1.0;
     std::shared_ptr<juce::AudioBuffer<float>> audioBuffer;
+    juce::File sourceFile;
     double sourceSampleRate = 44100.0;
+
+    float gain = 1.0f;
+    double fadeInLength = 0.0;
+    double fadeOutLength = 0.0;
+    FadeCurve fadeInCurve = FadeCurve::EqualPower;
+    FadeCurve fadeOutCurve = FadeCurve::EqualPower;
 };
 
-} // namespace SchillingerEcosystem::Timeline
\ No newline at end of file
+} // namespace SchillingerEcosystem::Timeline
@@ -17,6 +17,9 @@
 #include <variant>
 #include <map>
 #include <functional>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
 
 namespace white_room {
 namespace validation {
@@ -29,7 +32,7 @@ namespace validation {
  * Validation error with field path and message
  */
 struct ValidationError {
-    std::string fieldPath;      // e.g., "ensemble.voices[0].id"
+    std::string fieldPath;      // JSON pointer, e.g., "/ensemble/voices/0/id"
     std::string message;        // User-friendly error
     std::optional<std::string> value;  // The invalid value (as string)
 
@@ -204,8 +207,10 @@ ValidationResult<std::string> validatePerformanceState(const std::string& json);
 // =============================================================================
 
 /**
- * Helper class for JSON parsing
- * In production, use a proper JSON library (nlohmann/json, rapidjson, etc.)
+ * Helper class for ad-hoc JSON field lookups
+ *
+ * Each call rescans the document. Model validation uses the compiled
+ * schemas in StreamingSchemaValidator.h instead.
  */
 class JsonHelper {
 public:
@@ -0,0 +1,304 @@
+/*
+  StreamingSchemaValidator.h - Compiled-schema, single-pass JSON validation
+
+  JsonHelper locates every field by running a regex over the whole document,
+  so validating N fields costs N full scans. This header provides the
+  replacement used by SchemaValidator and the FFI server:
+
+  - SchemaSpec describes a schema declaratively (the subset of JSON Schema the
+    White Room models use: types, ranges, lengths, enums, formats, required
+    and additional properties, array items).
+  - CompiledSchema flattens a SchemaSpec once into a table of states. Object
+    states carry sorted key transitions and a required-property bitmask, so a
+    key lookup never touches the document again.
+  - StreamingValidator walks the document exactly once, SAX-style, with no
+    DOM. Every violation is reported with an RFC 6901 JSON pointer
+    (e.g. "/ensemble/voices/0/id").
+
+  A StreamingValidator owns reusable scratch storage and is not thread-safe;
+  keep one per thread. CompiledSchema is immutable and can be shared freely.
+*/
+
+#pragma once
+
+#include "validation/SchemaValidator.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace white_room {
+namespace validation {
+
+// =============================================================================
+// Schema Description
+// =============================================================================
+
+/**
+ * JSON value type mask. "number" accepts integers as well.
+ */
+enum JsonTypeMask : uint8_t {
+    kJsonNull    = 1 << 0,
+    kJsonBoolean = 1 << 1,
+    kJsonInteger = 1 << 2,
+    kJsonNumber  = 1 << 3,
+    kJsonString  = 1 << 4,
+    kJsonArray   = 1 << 5,
+    kJsonObject  = 1 << 6,
+    kJsonAny     = 0x7F
+};
+
+/**
+ * String formats understood by the validator
+ */
+enum class StringFormat : uint8_t {
+    None,
+    UUID,       // 8-4-4-4-12 hex digits
+    DateTime    // ISO 8601 date-time (see isValidISO8601)
+};
+
+/**
+ * Declarative schema node
+ *
+ * Built with the static factories and chained setters:
+ *
+ *   auto spec = SchemaSpec::object()
+ *       .property("id", SchemaSpec::string().withFormat(StringFormat::UUID), true)
+ *       .property("tempo", SchemaSpec::number().range(0.0, 500.0, false, true), true);
+ */
+struct SchemaSpec {
+    uint8_t types = kJsonAny;
+
+    // Numeric constraints
+    std::optional<double> minimum;
+    std::optional<double> maximum;
+    bool exclusiveMinimum = false;
+    bool exclusiveMaximum = false;
+    std::vector<double> numberEnum;
+
+    // String constraints
+    size_t minLength = 0;
+    size_t maxLength = std::numeric_limits<size_t>::max();
+    StringFormat format = StringFormat::None;
+    std::vector<std::string> stringEnum;
+
+    // Object constraints
+    std::vector<std::pair<std::string, SchemaSpec>> properties;
+    std::vector<std::string> required;
+    bool additionalProperties = true;
+
+    // Array constraints
+    std::shared_ptr<SchemaSpec> items;
+    size_t minItems = 0;
+    size_t maxItems = std::numeric_limits<size_t>::max();
+
+    // Optional user-facing message replacing the generic one
+    std::string message;
+
+    static SchemaSpec any()     { return SchemaSpec{}; }
+    static SchemaSpec object()  { return ofType(kJsonObject); }
+    static SchemaSpec string()  { return ofType(kJsonString); }
+    static SchemaSpec number()  { return ofType(kJsonNumber | kJsonInteger); }
+    static SchemaSpec integer() { return ofType(kJsonInteger); }
+    static SchemaSpec boolean() { return ofType(kJsonBoolean); }
+    static SchemaSpec array(SchemaSpec itemSpec = SchemaSpec::any());
+
+    static SchemaSpec ofType(uint8_t typeMask) {
+        SchemaSpec spec;
+        spec.types = typeMask;
+        return spec;
+    }
+
+    SchemaSpec& property(const std::string& name, SchemaSpec spec, bool isRequired = false);
+    SchemaSpec& range(double min, double max, bool minInclusive = true, bool maxInclusive = true);
+    SchemaSpec& atLeast(double min, bool inclusive = true);
+    SchemaSpec& length(size_t minLen, size_t maxLen);
+    SchemaSpec& withFormat(StringFormat f) { format = f; return *this; }
+    SchemaSpec& oneOf(std::vector<std::string> values) { stringEnum = std::move(values); return *this; }
+    SchemaSpec& oneOf(std::vector<double> values) { numberEnum = std::move(values); return *this; }
+    SchemaSpec& closed() { additionalProperties = false; return *this; }
+    SchemaSpec& withMessage(const std::string& msg) { message = msg; return *this; }
+};
+
+// =============================================================================
+// Compiled Schema
+// =============================================================================
+
+/**
+ * Immutable state table compiled from a SchemaSpec
+ *
+ * State 0 is the permissive "any" state used for undeclared properties.
+ * Objects support up to 64 required properties.
+ */
+class CompiledSchema {
+public:
+    static constexpr uint32_t kAnyState = 0;
+    static constexpr uint32_t kNoRequiredBit = 0xFF;
+
+    struct Transition {
+        std::string key;
+        uint32_t target = kAnyState;
+        uint8_t requiredBit = kNoRequiredBit;
+    };
+
+    struct State {
+        uint8_t types = kJsonAny;
+        bool hasMinimum = false;
+        bool hasMaximum = false;
+        bool exclusiveMinimum = false;
+        bool exclusiveMaximum = false;
+        bool additionalProperties = true;
+        StringFormat format = StringFormat::None;
+        double minimum = 0.0;
+        double maximum = 0.0;
+        size_t minLength = 0;
+        size_t maxLength = std::numeric_limits<size_t>::max();
+        size_t minItems = 0;
+        size_t maxItems = std::numeric_limits<size_t>::max();
+        uint32_t firstTransition = 0;   // Sorted by key
+        uint32_t transitionCount = 0;
+        uint64_t requiredMask = 0;
+        uint32_t itemState = kAnyState;
+        uint32_t firstEnum = 0;          // Into stringEnums / numberEnums
+        uint32_t enumCount = 0;
+        std::string message;
+    };
+
+    /**
+     * Compile a schema description. Throws std::invalid_argument when an
+     * object declares more than 64 required properties.
+     */
+    static std::shared_ptr<const CompiledSchema> compile(const SchemaSpec& spec);
+
+    uint32_t rootState() const { return root; }
+    const State& state(uint32_t index) const { return states[index]; }
+    size_t stateCount() const { return states.size(); }
+
+    /** Follow the key transition out of an object state (kAnyState if undeclared) */
+    const Transition* findTransition(const State& objectState, std::string_view key) const;
+
+    /** Name of a required property by bit index, used for "missing" reports */
+    const std::string& requiredName(const State& objectState, uint8_t bit) const;
+
+    bool matchesStringEnum(const State& s, std::string_view value) const;
+    bool matchesNumberEnum(const State& s, double value) const;
+
+private:
+    CompiledSchema() = default;
+    uint32_t compileNode(const SchemaSpec& spec);
+
+    std::vector<State> states;
+    std::vector<Transition> transitions;
+    std::vector<std::string> stringEnums;
+    std::vector<double> numberEnums;
+    uint32_t root = kAnyState;
+};
+
+// =============================================================================
+// Streaming Validator
+// =============================================================================
+
+/**
+ * Single-pass validator
+ *
+ * Reuse one instance per thread: its stack, error list and scratch string
+ * keep their capacity between calls, so steady-state validation of similar
+ * documents performs no allocation beyond the reported errors.
+ */
+class StreamingValidator {
+public:
+    struct Options {
+        size_t maxErrors = 64;      // Stop after this many violations
+        size_t maxDepth = 256;      // Nesting limit (reported as a syntax error)
+    };
+
+    StreamingValidator() = default;
+    explicit StreamingValidator(const Options& opts) : options(opts) {}
+
+    /**
+     * Validate a document. Returns true when it is well-formed JSON and
+     * satisfies the schema. All violations (up to maxErrors) are available
+     * from getErrors(); syntax errors stop validation immediately.
+     */
+    bool validate(std::string_view json, const CompiledSchema& schema);
+
+    const std::vector<ValidationError>& getErrors() const { return errors; }
+    bool hadSyntaxError() const { return syntaxError; }
+
+    /** Adapt the last run to the legacy single-error result type */
+    ValidationResult<std::string> toResult(const std::string& json) const;
+
+private:
+    struct Frame {
+        uint32_t state = CompiledSchema::kAnyState;
+        bool isArray = false;
+        bool hasElements = false;
+        uint64_t seenRequired = 0;
+        size_t index = 0;                // Array element index
+        std::string_view key;            // Raw (escaped) key of current member
+    };
+
+    bool fail(const std::string& message);
+    void report(const std::string& message, std::string_view value = {});
+    void reportMissing(const CompiledSchema::State& objectState, uint64_t missing,
+                       const CompiledSchema& schema);
+    std::string currentPointer(bool includeLastToken = true) const;
+
+    void skipWhitespace();
+    bool scanString(std::string_view& raw, bool& hasEscapes, size_t& codePoints);
+    std::string_view decodeString(std::string_view raw, bool hasEscapes);
+    bool scanNumber(std::string_view& token, bool& isInteger);
+
+    bool beginObjectMember(const CompiledSchema& schema, uint32_t& nextState);
+    void validateString(const CompiledSchema& schema, const CompiledSchema::State& s,
+                        std::string_view raw, bool hasEscapes, size_t codePoints);
+    void validateNumber(const CompiledSchema& schema, const CompiledSchema::State& s,
+                        std::string_view token, bool isInteger);
+    void validateType(const CompiledSchema::State& s, uint8_t actualType, std::string_view value);
+
+    Options options;
+    std::string_view text;
+    size_t pos = 0;
+    bool syntaxError = false;
+    bool limitReached = false;
+    std::vector<Frame> stack;
+    std::vector<ValidationError> errors;
+    std::string scratch;
+};
+
+// =============================================================================
+// Model Schemas
+// =============================================================================
+
+/**
+ * White Room model schemas, compiled once on first use
+ */
+enum class ModelSchema {
+    SchillingerSong_v1,
+    SongModel_v1,
+    PerformanceState_v1
+};
+
+const CompiledSchema& getCompiledSchema(ModelSchema model);
+
+/**
+ * Resolve a schema by its wire name ("SchillingerSong_v1", ...)
+ */
+std::optional<ModelSchema> modelSchemaFromName(std::string_view name);
+
+/**
+ * Schema that accepts any well-formed JSON (syntax check only)
+ */
+const CompiledSchema& getPermissiveSchema();
+
+/**
+ * JSON pointer token escaping per RFC 6901 ("~" -> "~0", "/" -> "~1")
+ */
+void appendJsonPointerToken(std::string& pointer, std::string_view token);
+
+} // namespace validation
+} // namespace white_room
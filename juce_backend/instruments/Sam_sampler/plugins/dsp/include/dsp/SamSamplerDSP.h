@@ -22,7 +22,9 @@
 #include <array>
 #include <memory>
 #include <cmath>
+#include <cstdint>
 #include <functional>
+#include <string>
 
 namespace DSP {
 
@@ -42,7 +44,41 @@ struct Sample
     double rootNote = 60.0;      // MIDI note number (60 = C4)
     double pitchCorrection = 0.0; // cents
 
+    // Sustain loop in frames (loopEnd <= loopStart: one-shot)
+    int loopStart = 0;
+    int loopEnd = 0;
+    int loopCrossfade = 0;       // Frames blended across the loop seam
+
+    double timeStretch = 1.0;    // Baked length / recorded length, pitch kept (0.25-4)
+
     bool isValid() const { return !audioData.empty() && numSamples > 0; }
+    bool isLooped() const { return loopEnd > loopStart && loopEnd <= numSamples; }
+
+    /**
+     * @brief Build the playback copy voices read from (load time, allocates)
+     *
+     * Channel 0 as float with the loop crossfade written into the loop
+     * tail and the loop start repeated after loopEnd, so interpolation
+     * runs straight through the seam and a voice wraps with a plain
+     * position reset. Guard frames on both sides keep cubic reads in range.
+     * A timeStretch other than 1 first runs channel 0 through the phase
+     * vocoder, so loops can follow the song tempo without changing pitch;
+     * the loop points are scaled with it.
+     */
+    void bakeForPlayback();
+    bool isBaked() const { return !playbackData.empty(); }
+
+    /** Baked frame 0; frames [-1, getPlaybackEnd() + 2] are readable */
+    const float* getPlaybackFrames() const { return playbackData.data() + 1; }
+
+    /** As baked: loop end (or sample end for a one-shot) and loop start (-1: one-shot) */
+    int getPlaybackEnd() const { return playbackEnd; }
+    int getPlaybackLoopStart() const { return playbackLoopStart; }
+
+private:
+    std::vector<float> playbackData;
+    int playbackEnd = 0;
+    int playbackLoopStart = -1;
 };
 
 //==============================================================================
@@ -86,14 +122,29 @@ struct ADSREnvelope
     bool isReleased = false;
     bool isActive = false;
 
+    double releaseLevel = 0.0;   // Level the release stage starts from
+
     void reset();
     void start();
     void release();
     double process(double sampleRate, int numSamples);
 
+    /**
+     * @brief Render one gain per sample for the next numSamples
+     *
+     * Each stage is a closed-form curve, filled segment by segment in
+     * float. Returns the number of samples rendered, less than numSamples
+     * when the release finishes inside the block.
+     */
+    int renderBlock(float* gains, int numSamples, double sampleRate);
+
 private:
     // Apply curve to normalized position (0-1)
     double applyCurve(double t, EnvelopeCurve curve) const;
+
+    // gains[i] = offset + scale * curve(start + i * step)
+    static void renderCurve(float* gains, int numSamples, double start, double step,
+                            EnvelopeCurve curve, double offset, double scale);
 };
 
 //==============================================================================
@@ -205,21 +256,21 @@ private:
     // Interpolation quality
     int interpolationQuality_ = 1; // 0=linear, 1=cubic
 
-    // Loop handling
+    // Loop handling (crossfade is baked into the sample)
     bool isLooping_ = false;
     double loopStart_ = 0.0;
-    double loopEnd_ = 0.0;
-    double loopCrossfade_ = 0.0; // seconds
+    double playbackEnd_ = 0.0;
+
+    // Block scratch, so process() never allocates
+    static constexpr int renderChunkSize = 256;
+    alignas(32) float voiceBuffer_[renderChunkSize] = {};
+    alignas(32) float gainBuffer_[renderChunkSize] = {};
 
     // Calculate frequency from MIDI note
     double midiToFrequency(int midiNote) const;
 
-    // Interpolation methods
-    double interpolateLinear(double position) const;
-    double interpolateCubic(double position) const;
-
-    // Loop handling with crossfade
-    double processLoopCrossfade(double position, int channel);
+    // Read numSamples frames from playPosition_ without crossing playbackEnd_
+    void renderRun(float* destination, int numSamples) const;
 };
 
 //==============================================================================
@@ -415,6 +466,7 @@ private:
         double loopStart = 0.0;
         double loopEnd = 1.0;
         double crossfade = 0.01;      // Loop crossfade (seconds)
+        double timeStretch = 1.0;     // Length multiplier at constant pitch (0.25-4)
 
         // Amplitude envelope (global, affects all voices)
         double envAttack = 0.01;
@@ -20,6 +20,8 @@
 #include "../../../../include/dsp/InstrumentFactory.h"
 #include "../../../../include/dsp/LookupTables.h"
 #include "../../../../include/dsp/DSPLogging.h"
+#include "../../../../include/dsp/SIMDBufferOps.h"
+#include "../../../../include/dsp/PhaseVocoder.h"
 #include <cstring>
 #include <cmath>
 #include <sstream>
@@ -29,6 +31,74 @@
 
 namespace DSP {
 
+//==============================================================================
+// Sample Playback Baking
+//==============================================================================
+
+void Sample::bakeForPlayback()
+{
+    playbackData.clear();
+    playbackEnd = 0;
+    playbackLoopStart = -1;
+
+    if (!isValid())
+        return;
+
+    const int stride = std::max(1, numChannels);
+    const int recorded = std::min(numSamples, static_cast<int>(audioData.size()) / stride);
+
+    std::vector<float> channel(static_cast<size_t>(std::max(0, recorded)));
+    for (int i = 0; i < recorded; ++i)
+        channel[static_cast<size_t>(i)] = audioData[static_cast<size_t>(i) * stride];
+
+    // Stretched to tempo at the same pitch; the loop points move with it
+    const double stretch = std::clamp(timeStretch, PhaseVocoder::minRatio, PhaseVocoder::maxRatio);
+    int start = loopStart;
+    int end = loopEnd;
+    int crossfade = loopCrossfade;
+
+    if (stretch != 1.0 && recorded > 0)
+    {
+        channel = PhaseVocoder::process(channel.data(), recorded, static_cast<double>(sampleRate), stretch, 1.0);
+        start = static_cast<int>(std::lround(loopStart * stretch));
+        end = static_cast<int>(std::lround(loopEnd * stretch));
+        crossfade = static_cast<int>(std::lround(loopCrossfade * stretch));
+    }
+
+    const int available = static_cast<int>(channel.size());
+    auto source = [&](int frame) { return channel[static_cast<size_t>(frame)]; };
+
+    const bool looped = isLooped() && loopEnd <= recorded && end > start && end <= available;
+    playbackEnd = looped ? end : available;
+
+    // One guard frame in front, three behind (silence for a one-shot)
+    playbackData.assign(static_cast<size_t>(playbackEnd) + 4, 0.0f);
+    float* frames = playbackData.data() + 1;
+
+    for (int i = 0; i < playbackEnd; ++i)
+        frames[i] = source(i);
+
+    if (!looped)
+        return;
+
+    playbackLoopStart = start;
+    const int loopLength = end - start;
+
+    // Fade the loop tail into the material leading up to the loop start, so
+    // the last baked frame runs straight on into it after the wrap
+    const int fade = std::min({ crossfade, start, loopLength });
+    for (int k = 0; k < fade; ++k)
+    {
+        const float fadeIn = static_cast<float>(k + 1) / static_cast<float>(fade);
+        const int i = end - fade + k;
+        frames[i] = source(i) * (1.0f - fadeIn) + source(start - fade + k) * fadeIn;
+    }
+
+    // Reads past the loop end continue at the loop start
+    for (int k = 0; k < 3; ++k)
+        frames[end + k] = frames[start + k % loopLength];
+}
+
 //==============================================================================
 // Enhanced ADSR Envelope Implementation
 //==============================================================================
@@ -53,6 +123,7 @@ void ADSREnvelope::release()
 {
     isReleased = true;
     envelopeTime = 0.0;
+    releaseLevel = currentLevel;
 }
 
 double ADSREnvelope::applyCurve(double t, EnvelopeCurve curve) const
@@ -125,7 +196,7 @@ double ADSREnvelope::process(double sampleRate, int numSamples)
         {
             double t = timeInRelease / releaseTime;
             double curve = applyCurve(1.0 - t, releaseCurve);  // Invert for release
-            target = currentLevel * curve;
+            target = releaseLevel * curve;
         }
         else
         {
@@ -140,6 +211,126 @@ double ADSREnvelope::process(double sampleRate, int numSamples)
     return currentLevel;
 }
 
+int ADSREnvelope::renderBlock(float* gains, int numSamples, double sampleRate)
+{
+    if (!isActive)
+    {
+        currentLevel = 0.0;
+        return 0;
+    }
+
+    int rendered = 0;
+    while (rendered < numSamples)
+    {
+        const double time = envelopeTime / sampleRate;
+        const int remaining = numSamples - rendered;
+        float* out = gains + rendered;
+
+        // Samples of this block left before the stage ending at stageEnd (seconds)
+        auto samplesUntil = [&](double stageEnd)
+        {
+            const double left = std::ceil(stageEnd * sampleRate - envelopeTime);
+            return static_cast<int>(std::max(1.0, std::min(static_cast<double>(remaining), left)));
+        };
+
+        int count = remaining;
+        if (!isReleased)
+        {
+            if (time < attack)
+            {
+                count = samplesUntil(attack);
+                renderCurve(out, count, time / attack, 1.0 / (attack * sampleRate),
+                            attackCurve, 0.0, 1.0);
+            }
+            else if (time < (attack + hold))
+            {
+                count = samplesUntil(attack + hold);
+                std::fill(out, out + count, 1.0f);
+            }
+            else if (time < (attack + hold + decay))
+            {
+                count = samplesUntil(attack + hold + decay);
+                renderCurve(out, count, 1.0 - (time - attack - hold) / decay, -1.0 / (decay * sampleRate),
+                            decayCurve, sustain, 1.0 - sustain);
+            }
+            else
+            {
+                std::fill(out, out + count, static_cast<float>(sustain));
+            }
+        }
+        else if (time < releaseTime)
+        {
+            count = samplesUntil(releaseTime);
+            renderCurve(out, count, 1.0 - time / releaseTime, -1.0 / (releaseTime * sampleRate),
+                        releaseCurve, 0.0, releaseLevel);
+        }
+        else
+        {
+            isActive = false;
+            currentLevel = 0.0;
+            return rendered;
+        }
+
+        envelopeTime += static_cast<double>(count);
+        rendered += count;
+        currentLevel = out[count - 1];
+    }
+
+    return rendered;
+}
+
+void ADSREnvelope::renderCurve(float* gains, int numSamples, double start, double step,
+                               EnvelopeCurve curve, double offset, double scale)
+{
+    const float t0 = static_cast<float>(start);
+    const float dt = static_cast<float>(step);
+    const float a = static_cast<float>(offset);
+    const float b = static_cast<float>(scale);
+
+    // Positions are clamped so rounding at a stage edge can't leave 0-1
+    auto position = [t0, dt](int i) { return std::min(1.0f, std::max(0.0f, t0 + dt * static_cast<float>(i))); };
+
+    switch (curve)
+    {
+        case EnvelopeCurve::Exponential:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float t = position(i);
+                gains[i] = a + b * t * t;
+            }
+            break;
+
+        case EnvelopeCurve::Logarithmic:
+            for (int i = 0; i < numSamples; ++i)
+                gains[i] = a + b * std::sqrt(position(i));
+            break;
+
+        case EnvelopeCurve::SCurve:
+        {
+            // cos(pi t) by rotation, restarted exactly on every call
+            double c = std::cos(M_PI * start);
+            double s = std::sin(M_PI * start);
+            const double stepCos = std::cos(M_PI * step);
+            const double stepSin = std::sin(M_PI * step);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gains[i] = a + b * static_cast<float>(0.5 * (1.0 - c));
+                const double nextC = c * stepCos - s * stepSin;
+                s = s * stepCos + c * stepSin;
+                c = nextC;
+            }
+            break;
+        }
+
+        case EnvelopeCurve::Linear:
+        default:
+            for (int i = 0; i < numSamples; ++i)
+                gains[i] = a + b * position(i);
+            break;
+    }
+}
+
 //==============================================================================
 // State Variable Filter Implementation
 //==============================================================================
@@ -277,127 +468,6 @@ void SamSamplerVoice::setInterpolationQuality(int quality)
     interpolationQuality_ = quality;
 }
 
-double SamSamplerVoice::interpolateLinear(double position) const
-{
-    if (!sample_ || !sample_->isValid())
-        return 0.0;
-
-    int index0 = static_cast<int>(position);
-    int index1 = index0 + 1;
-    double frac = position - index0;
-
-    // Handle stereo samples
-    int stride = sample_->numChannels;
-
-    if (sample_->numChannels == 1)
-    {
-        // Mono
-        if (index0 >= 0 && index0 < sample_->numSamples - 1)
-        {
-            return sample_->audioData[index0] * (1.0 - frac) +
-                   sample_->audioData[index1] * frac;
-        }
-    }
-    else if (sample_->numChannels == 2)
-    {
-        // Stereo - take left channel
-        index0 = index0 * 2;
-        index1 = index0 + 2;
-
-        if (index0 >= 0 && index0 < sample_->numSamples * 2 - 2)
-        {
-            return sample_->audioData[index0] * (1.0 - frac) +
-                   sample_->audioData[index1] * frac;
-        }
-    }
-
-    return 0.0;
-}
-
-double SamSamplerVoice::interpolateCubic(double position) const
-{
-    if (!sample_ || !sample_->isValid())
-        return 0.0;
-
-    int index = static_cast<int>(position);
-    double frac = position - index;
-
-    // Handle stereo samples
-    int stride = sample_->numChannels;
-
-    if (sample_->numChannels == 1)
-    {
-        // Mono - need 4 samples for cubic
-        if (index >= 1 && index < sample_->numSamples - 2)
-        {
-            double y0 = sample_->audioData[index - 1];
-            double y1 = sample_->audioData[index];
-            double y2 = sample_->audioData[index + 1];
-            double y3 = sample_->audioData[index + 2];
-
-            // Cubic interpolation
-            return y1 + 0.5 * frac * (y2 - y0 +
-                   frac * (2.0 * y0 - 5.0 * y1 + 4.0 * y2 - y3 +
-                   frac * (3.0 * (y1 - y2) + y3 - y0)));
-        }
-    }
-    else if (sample_->numChannels == 2)
-    {
-        // Stereo - left channel
-        index = index * 2;
-
-        if (index >= 2 && index < sample_->numSamples * 2 - 4)
-        {
-            double y0 = sample_->audioData[index - 2];
-            double y1 = sample_->audioData[index];
-            double y2 = sample_->audioData[index + 2];
-            double y3 = sample_->audioData[index + 4];
-
-            // Cubic interpolation
-            return y1 + 0.5 * frac * (y2 - y0 +
-                   frac * (2.0 * y0 - 5.0 * y1 + 4.0 * y2 - y3 +
-                   frac * (3.0 * (y1 - y2) + y3 - y0)));
-        }
-    }
-
-    // Fall back to linear if out of bounds
-    return interpolateLinear(position);
-}
-
-double SamSamplerVoice::processLoopCrossfade(double position, int channel)
-{
-    if (!sample_ || !sample_->isValid())
-        return 0.0;
-
-    // Check if we're near loop end
-    if (isLooping_ && position >= loopEnd_ - loopCrossfade_ * sample_->sampleRate)
-    {
-        double crossfadeSamples = loopCrossfade_ * sample_->sampleRate;
-        double distanceToEnd = loopEnd_ - position;
-        double crossfadeAmount = 1.0 - (distanceToEnd / crossfadeSamples);
-        crossfadeAmount = std::max(0.0, std::min(1.0, crossfadeAmount));
-
-        // Get sample from current position
-        double sample1 = (interpolationQuality_ == 1) ?
-                         interpolateCubic(position) :
-                         interpolateLinear(position);
-
-        // Get sample from loop start position
-        double loopPosition = loopStart_ + (position - (loopEnd_ - crossfadeSamples));
-        double sample2 = (interpolationQuality_ == 1) ?
-                         interpolateCubic(loopPosition) :
-                         interpolateLinear(loopPosition);
-
-        // Crossfade
-        return sample1 * (1.0 - crossfadeAmount) + sample2 * crossfadeAmount;
-    }
-
-    // Normal playback
-    return (interpolationQuality_ == 1) ?
-           interpolateCubic(position) :
-           interpolateLinear(position);
-}
-
 void SamSamplerVoice::startNote(int midiNote, float velocity, std::shared_ptr<Sample> sample)
 {
     midiNote_ = midiNote;
@@ -412,9 +482,15 @@ void SamSamplerVoice::startNote(int midiNote, float velocity, std::shared_ptr<Sa
     // Reset filter state
     filter_.reset();
 
-    // Calculate playback rate based on sample's root note
-    if (sample_ && sample_->isValid())
+    // Calculate playback rate based on sample's root note. Samples are baked
+    // when they are loaded; an unbaked one is never baked here on the audio
+    // thread and the note is dropped instead.
+    if (sample_ && sample_->isValid() && sample_->isBaked())
     {
+        isLooping_ = sample_->getPlaybackLoopStart() >= 0;
+        loopStart_ = isLooping_ ? sample_->getPlaybackLoopStart() : 0.0;
+        playbackEnd_ = sample_->getPlaybackEnd();
+
         double sampleRootFreq = midiToFrequency(static_cast<int>(sample_->rootNote));
         playbackRate_ = frequency_ / sampleRootFreq;
 
@@ -427,6 +503,9 @@ void SamSamplerVoice::startNote(int midiNote, float velocity, std::shared_ptr<Sa
     else
     {
         playbackRate_ = 1.0;
+        isLooping_ = false;
+        playbackEnd_ = 0.0;
+        isActive_ = false;
     }
 
     playPosition_ = 0.0;
@@ -459,63 +538,93 @@ double SamSamplerVoice::midiToFrequency(int midiNote) const
 
 void SamSamplerVoice::process(float** outputs, int numChannels, int numSamples, double sampleRate)
 {
-    if (!isActive_ || !sample_ || !sample_->isValid())
+    if (!isActive_ || !sample_ || !sample_->isBaked())
         return;
 
-    // Temporary buffer for voice output (for filtering)
-    std::vector<float> voiceBuffer(numSamples);
-
-    // Process each sample
-    for (int sample = 0; sample < numSamples; ++sample)
+    for (int offset = 0; offset < numSamples && isActive_; offset += renderChunkSize)
     {
-        // Get envelope value
-        double env = envelope_.process(sampleRate, 1);
+        const int chunk = std::min(renderChunkSize, numSamples - offset);
 
-        // Check if voice is finished
+        // Envelope for the whole chunk; it stops short when the release ends
+        const int audible = envelope_.renderBlock(gainBuffer_, chunk, sampleRate);
         if (!envelope_.isActive)
-        {
             isActive_ = false;
-            break;
-        }
-
-        // Get interpolated sample with improved quality
-        double output = processLoopCrossfade(playPosition_, 0);
 
-        // Apply envelope and velocity
-        output *= env * static_cast<double>(velocity_);
+        // Read in runs that never cross the loop end (wrap) or sample end (stop)
+        int rendered = 0;
+        while (rendered < audible)
+        {
+            if (playPosition_ >= playbackEnd_)
+            {
+                if (!isLooping_)
+                {
+                    isActive_ = false;
+                    break;
+                }
 
-        // Store in voice buffer
-        voiceBuffer[sample] = static_cast<float>(output);
+                playPosition_ = loopStart_ + std::fmod(playPosition_ - playbackEnd_, playbackEnd_ - loopStart_);
+            }
 
-        // Advance playhead
-        playPosition_ += playbackRate_;
+            const double toEnd = std::ceil((playbackEnd_ - playPosition_) / playbackRate_);
+            const int run = static_cast<int>(std::min(static_cast<double>(audible - rendered), toEnd));
 
-        // Handle looping
-        if (isLooping_ && playPosition_ >= loopEnd_)
-        {
-            playPosition_ = loopStart_ + (playPosition_ - loopEnd_);
+            renderRun(voiceBuffer_ + rendered, run);
+            playPosition_ += run * playbackRate_;
+            rendered += run;
         }
-        // Check for end of sample
-        else if (playPosition_ >= sample_->numSamples)
+
+        std::fill(voiceBuffer_ + rendered, voiceBuffer_ + chunk, 0.0f);
+
+        // Apply envelope and velocity
+        SIMDBufferOps::multiplyBuffer(gainBuffer_, rendered, velocity_);
+        SIMDBufferOps::multiplyBuffers(voiceBuffer_, gainBuffer_, rendered);
+
+        // Apply filter if enabled (processes entire chunk)
+        if (filterEnabled_)
         {
-            isActive_ = false;
-            break;
+            float* channelPtr[1] = { voiceBuffer_ };
+            filter_.process(channelPtr, 1, chunk);
         }
+
+        // Write to all output channels
+        for (int ch = 0; ch < numChannels; ++ch)
+            SIMDBufferOps::addBuffers(outputs[ch] + offset, voiceBuffer_, chunk);
     }
+}
 
-    // Apply filter if enabled (processes entire buffer)
-    if (filterEnabled_)
+void SamSamplerVoice::renderRun(float* destination, int numSamples) const
+{
+    const double base = std::floor(playPosition_);
+    const float* origin = sample_->getPlaybackFrames() + static_cast<int>(base);
+    const float frac = static_cast<float>(playPosition_ - base);
+    const float rate = static_cast<float>(playbackRate_);
+
+    // Offsets from the run start stay small, so float keeps sub-sample
+    // precision; the baked guard frames make every read in range
+    if (interpolationQuality_ == 1)
     {
-        float* channelPtr[1] = { voiceBuffer.data() };
-        filter_.process(channelPtr, 1, numSamples);
-    }
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float position = frac + rate * static_cast<float>(i);
+            const int index = static_cast<int>(position);
+            const float t = position - static_cast<float>(index);
+            const float* y = origin + index;
 
-    // Write to all output channels
-    for (int ch = 0; ch < numChannels; ++ch)
+            // Cubic interpolation
+            destination[i] = y[0] + 0.5f * t * (y[1] - y[-1] +
+                             t * (2.0f * y[-1] - 5.0f * y[0] + 4.0f * y[1] - y[2] +
+                             t * (3.0f * (y[0] - y[1]) + y[2] - y[-1])));
+        }
+    }
+    else
     {
         for (int i = 0; i < numSamples; ++i)
         {
-            outputs[ch][i] += voiceBuffer[i];
+            const float position = frac + rate * static_cast<float>(i);
+            const int index = static_cast<int>(position);
+            const float t = position - static_cast<float>(index);
+
+            destination[i] = origin[index] + t * (origin[index + 1] - origin[index]);
         }
     }
 }
@@ -658,6 +767,22 @@ bool SamSamplerDSP::prepare(double sampleRate, int blockSize)
                 sampleCopy->numSamples = sample->numSamples;
                 sampleCopy->rootNote = sample->rootNote;
                 sampleCopy->pitchCorrection = sample->pitchCorrection;
+                sampleCopy->loopStart = sample->loopStart;
+                sampleCopy->loopEnd = sample->loopEnd;
+                sampleCopy->loopCrossfade = sample->loopCrossfade;
+
+                if (params_.loopEnabled && !sampleCopy->isLooped())
+                {
+                    sampleCopy->loopStart = static_cast<int>(params_.loopStart * sampleCopy->numSamples);
+                    sampleCopy->loopEnd = static_cast<int>(params_.loopEnd * sampleCopy->numSamples);
+                    sampleCopy->loopCrossfade = static_cast<int>(params_.crossfade * sampleCopy->sampleRate);
+                }
+
+                sampleCopy->timeStretch = params_.timeStretch;
+
+                // Time stretch, loop crossfade and interpolation guards are
+                // baked here, never on the audio thread
+                sampleCopy->bakeForPlayback();
                 sampleCache_.push_back(sampleCopy);
             }
         }
@@ -804,6 +929,9 @@ float SamSamplerDSP::getParameter(const char* paramId) const
     if (std::strcmp(paramId, "basePitch") == 0)
         return static_cast<float>(params_.basePitch);
 
+    if (std::strcmp(paramId, "timeStretch") == 0)
+        return static_cast<float>(params_.timeStretch);
+
     if (std::strcmp(paramId, "envAttack") == 0)
         return static_cast<float>(params_.envAttack);
 
@@ -869,6 +997,14 @@ void SamSamplerDSP::setParameter(const char* paramId, float value)
         return;
     }
 
+    if (std::strcmp(paramId, "timeStretch") == 0)
+    {
+        // Applied when samples are baked into the cache
+        params_.timeStretch = clamp(value, 0.25f, 4.0f);
+        LOG_PARAMETER_CHANGE("SamSampler", paramId, oldValue, value);
+        return;
+    }
+
     if (std::strcmp(paramId, "envAttack") == 0)
     {
         params_.envAttack = clamp(value, 0.001f, 5.0f);
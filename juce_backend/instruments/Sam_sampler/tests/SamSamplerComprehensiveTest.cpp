@@ -15,6 +15,8 @@
 #include <cstdio>
 #include <cmath>
 #include <vector>
+#include <memory>
+#include <algorithm>
 
 using namespace DSP;
 
@@ -294,6 +296,194 @@ bool testPitchBend(TestStats& stats) {
     return true;
 }
 
+//==============================================================================
+// Test 8: Block Envelope
+//==============================================================================
+
+bool testBlockEnvelope(TestStats& stats) {
+    std::cout << "\n[Test 8] Block Envelope" << std::endl;
+
+    const double sampleRate = 48000.0;
+    const EnvelopeCurve curves[] = { EnvelopeCurve::Linear, EnvelopeCurve::Exponential,
+                                     EnvelopeCurve::Logarithmic, EnvelopeCurve::SCurve };
+
+    double maxError = 0.0;
+    for (EnvelopeCurve curve : curves) {
+        ADSREnvelope perSample, perBlock;
+        for (ADSREnvelope* env : { &perSample, &perBlock }) {
+            env->attack = 0.01;
+            env->hold = 0.005;
+            env->decay = 0.05;
+            env->sustain = 0.4;
+            env->releaseTime = 0.03;
+            env->attackCurve = env->decayCurve = env->releaseCurve = curve;
+            env->start();
+        }
+
+        // Odd block size, so stage boundaries land inside blocks
+        std::vector<float> gains(173);
+        for (int block = 0; block < 40; ++block) {
+            if (block == 25) {
+                perSample.release();
+                perBlock.release();
+            }
+
+            const int rendered = perBlock.renderBlock(gains.data(), 173, sampleRate);
+            for (int i = 0; i < rendered; ++i) {
+                maxError = std::max(maxError, std::abs(gains[i] - perSample.process(sampleRate, 1)));
+            }
+        }
+
+        if (perBlock.isActive || perSample.process(sampleRate, 1) != 0.0) {
+            stats.fail("block_envelope", "Release did not finish");
+            return false;
+        }
+    }
+
+    std::cout << "    Max deviation from per-sample envelope: " << maxError << std::endl;
+
+    if (maxError > 1.0e-4) {
+        stats.fail("block_envelope", "Block envelope differs from per-sample envelope");
+        return false;
+    }
+
+    stats.pass("block_envelope");
+    return true;
+}
+
+//==============================================================================
+// Test 9: Baked Loop Playback
+//==============================================================================
+
+bool testBakedLoop(TestStats& stats) {
+    std::cout << "\n[Test 9] Baked Loop Playback" << std::endl;
+
+    // Loop length is not a whole number of periods, so an unfaded seam would click
+    auto sample = std::make_shared<Sample>();
+    sample->sampleRate = 48000;
+    sample->numSamples = 4800;
+    sample->audioData.resize(4800);
+    for (int i = 0; i < 4800; ++i) {
+        sample->audioData[i] = static_cast<float>(std::sin(2.0 * M_PI * 440.0 * i / 48000.0));
+    }
+    sample->loopStart = 1000;
+    sample->loopEnd = 4321;
+    sample->loopCrossfade = 480;
+    sample->bakeForPlayback();
+
+    SamSamplerVoice voice;
+    voice.setEnvelopeParameters(0.001, 0.0, 0.001, 1.0, 0.1,
+                                EnvelopeCurve::Linear, EnvelopeCurve::Linear, EnvelopeCurve::Linear);
+    voice.startNote(60, 1.0f, sample);
+
+    // Three times the sample length: only a looping voice survives
+    std::vector<float> left(14400), right(14400);
+    for (int offset = 0; offset < 14400; offset += 480) {
+        float* outputs[] = { left.data() + offset, right.data() + offset };
+        voice.process(outputs, 2, 480, 48000.0);
+    }
+
+    float maxStep = 0.0f;
+    for (int i = 480; i < 14400; ++i) {
+        maxStep = std::max(maxStep, std::abs(left[i] - left[i - 1]));
+    }
+
+    // A 440 Hz sine moves at most ~0.058 per sample
+    std::cout << "    Still playing: " << (voice.isActive() ? "yes" : "no")
+              << ", largest step: " << maxStep << std::endl;
+
+    if (!voice.isActive() || getPeakLevel(left.data() + 13920, 480) < 0.5f) {
+        stats.fail("baked_loop", "Voice stopped instead of looping");
+        return false;
+    }
+
+    if (maxStep > 0.07f) {
+        stats.fail("baked_loop", "Discontinuity at the loop seam");
+        return false;
+    }
+
+    stats.pass("baked_loop");
+    return true;
+}
+
+//==============================================================================
+// Test 10: Time-Stretched Loop
+//==============================================================================
+
+bool testTimeStretchedLoop(TestStats& stats) {
+    std::cout << "\n[Test 10] Time-Stretched Loop" << std::endl;
+
+    auto sample = std::make_shared<Sample>();
+    sample->sampleRate = 48000;
+    sample->numSamples = 24000;
+    sample->audioData.resize(24000);
+    for (int i = 0; i < 24000; ++i) {
+        sample->audioData[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 440.0 * i / 48000.0));
+    }
+    sample->loopStart = 6000;
+    sample->loopEnd = 18000;
+    sample->loopCrossfade = 480;
+    sample->timeStretch = 1.5;
+    sample->bakeForPlayback();
+
+    std::cout << "    Baked loop: " << sample->getPlaybackLoopStart() << " - " << sample->getPlaybackEnd() << std::endl;
+
+    if (sample->getPlaybackLoopStart() != 9000 || sample->getPlaybackEnd() != 27000) {
+        stats.fail("time_stretch", "Loop points not scaled with the stretch");
+        return false;
+    }
+
+    // Pitch is kept: count rising zero crossings through the loop body
+    const float* frames = sample->getPlaybackFrames();
+    int crossings = 0;
+    for (int i = 9001; i < 21000; ++i) {
+        if (frames[i - 1] < 0.0f && frames[i] >= 0.0f) {
+            ++crossings;
+        }
+    }
+
+    const double frequency = crossings * 48000.0 / 12000.0;
+    std::cout << "    Stretched frequency: " << frequency << " Hz" << std::endl;
+
+    if (std::abs(frequency - 440.0) > 8.0 || getPeakLevel(frames + 9000, 12000) < 0.4f) {
+        stats.fail("time_stretch", "Stretch changed the pitch or level");
+        return false;
+    }
+
+    stats.pass("time_stretch");
+    return true;
+}
+
+//==============================================================================
+// Test 11: Unbaked Sample
+//==============================================================================
+
+bool testUnbakedSample(TestStats& stats) {
+    std::cout << "\n[Test 11] Unbaked Sample" << std::endl;
+
+    // Baking allocates, so a voice never does it; the note is dropped
+    auto sample = std::make_shared<Sample>();
+    sample->sampleRate = 48000;
+    sample->numSamples = 4800;
+    sample->audioData.assign(4800, 0.5f);
+
+    SamSamplerVoice voice;
+    voice.startNote(60, 1.0f, sample);
+
+    if (sample->isBaked()) {
+        stats.fail("unbaked_sample", "Voice baked the sample");
+        return false;
+    }
+
+    if (voice.isActive()) {
+        stats.fail("unbaked_sample", "Voice started on an unbaked sample");
+        return false;
+    }
+
+    stats.pass("unbaked_sample");
+    return true;
+}
+
 //==============================================================================
 // Main Test Runner
 //==============================================================================
@@ -312,6 +502,10 @@ int main(int argc, char* argv[]) {
     testSampleRates(stats);
     testPolyphony(stats);
     testPitchBend(stats);
+    testBlockEnvelope(stats);
+    testBakedLoop(stats);
+    testTimeStretchedLoop(stats);
+    testUnbakedSample(stats);
 
     stats.printSummary();
 
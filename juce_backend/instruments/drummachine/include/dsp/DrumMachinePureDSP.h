@@ -20,6 +20,8 @@
 #pragma once
 
 #include "dsp/InstrumentDSP.h"
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <array>
 #include <memory>
@@ -516,7 +518,7 @@ struct PhraseDetector
     }
 };
 
-// Safety: Maximum micro-hits per audio block (prevents audio thread DOS)
+// Safety: Maximum hits fired per audio block (prevents audio thread DOS)
 constexpr int kMaxMicroHitsPerBlock = 256;
 
 // Rhythm feel mode (groove vs drill)
@@ -569,6 +571,19 @@ struct StepCell
     DrillIntent drillIntent = DrillIntent::Optional;  // Semantic intent
 };
 
+//==============================================================================
+// Compiled Pattern (precomputed hit timeline)
+//==============================================================================
+
+// One resolved hit: swing, groove layers, probability, flams, rolls and
+// drill bursts already applied
+struct CompiledHit
+{
+    int64_t samplePosition = 0;  // Within the loop, [0, loopLengthSamples)
+    uint8_t track = 0;
+    float velocity = 0.0f;       // 0..1
+};
+
 struct Track
 {
     enum class DrumType
@@ -601,11 +616,23 @@ struct Track
     TrackDrillOverride drillOverride;
 };
 
+// Sorted hit timeline for one loop (one phrase) of the pattern, plus what
+// the audio thread needs to play it. Immutable once published.
+struct CompiledPattern
+{
+    std::vector<CompiledHit> hits;  // Sorted by samplePosition, then track
+    int64_t loopLengthSamples = 0;
+    int bars = 1;
+    int patternLength = 16;
+    double stepLengthSamples = 1.0;
+    std::array<Track, 16> tracks{};  // Snapshot for live triggers and voice types
+};
+
 class StepSequencer
 {
 public:
     StepSequencer();
-    ~StepSequencer() = default;
+    ~StepSequencer();
 
     void prepare(double sampleRate, int samplesPerBlock);
     void reset();
@@ -616,14 +643,25 @@ public:
     void setPatternLength(int length);
     int getCurrentStep() const { return currentStep_; }
 
-    void triggerTrack(int trackIndex, int stepIndex, float velocity);
-    void triggerAllTracks(int stepIndex);
+    void triggerTrack(int trackIndex, int stepIndex, float velocity);  // Audio thread, from the playing pattern
 
     bool isTrackTriggered(int trackIndex, int stepIndex) const;
 
     void advance(int numSamples);
     void processTrack(int trackIndex, float* output, int numSamples);
 
+    // Pattern compiler: any change to the pattern or its timing parameters
+    // marks the timeline dirty. compilePattern() rebuilds it on the editing
+    // (message or worker) thread and publishes it; the audio thread swaps it
+    // in at the next block boundary and only ever walks a cursor through it.
+    void compilePattern();
+    bool isPatternDirty() const { return patternDirty_.load(std::memory_order_relaxed); }
+    const CompiledPattern& getCompiledPattern() const;  // Editing thread: latest compiled
+
+    // Seed for probability, Dilla drift and drill randomness in the timeline
+    void setPatternSeed(uint32_t seed) { patternSeed_ = seed; patternDirty_ = true; }
+    uint32_t getPatternSeed() const { return patternSeed_; }
+
     void setTrack(int index, const Track& track);
     Track getTrack(int index) const;
 
@@ -631,43 +669,44 @@ public:
     bool hasActiveVoices() const;  // Check if any drum voice is playing
 
     // Timing role system
-    void setRoleTimingParams(const RoleTimingParams& params) { roleTimingParams_ = params; }
+    void setRoleTimingParams(const RoleTimingParams& params) { roleTimingParams_ = params; patternDirty_ = true; }
     RoleTimingParams getRoleTimingParams() const { return roleTimingParams_; }
 
-    void setDillaParams(const DillaParams& params) { dillaParams_ = params; }
+    void setDillaParams(const DillaParams& params) { dillaParams_ = params; patternDirty_ = true; }
     DillaParams getDillaParams() const { return dillaParams_; }
 
     // Drill mode system
-    void setDrillMode(const DrillMode& drill) { drillMode_ = drill; }
+    void setDrillMode(const DrillMode& drill) { drillMode_ = drill; patternDirty_ = true; }
     DrillMode getDrillMode() const { return drillMode_; }
 
-    void setRhythmFeelMode(RhythmFeelMode mode) { rhythmFeelMode_ = mode; }
+    void setRhythmFeelMode(RhythmFeelMode mode) { rhythmFeelMode_ = mode; patternDirty_ = true; }
     RhythmFeelMode getRhythmFeelMode() const { return rhythmFeelMode_; }
 
     // Drill intensity automation (compositional sequencing)
-    void setDrillAutomation(const DrillAutomationLane& lane) { drillAutomation_ = lane; }
+    void setDrillAutomation(const DrillAutomationLane& lane) { drillAutomation_ = lane; patternDirty_ = true; }
     DrillAutomationLane getDrillAutomation() const { return drillAutomation_; }
-    void addDrillAutomationPoint(int bar, float amount) { drillAutomation_.addPoint(bar, amount); }
-    void clearDrillAutomation() { drillAutomation_.clear(); }
+    void addDrillAutomationPoint(int bar, float amount) { drillAutomation_.addPoint(bar, amount); patternDirty_ = true; }
+    void clearDrillAutomation() { drillAutomation_.clear(); patternDirty_ = true; }
 
     // Automatic drill fills
-    void setDrillFillPolicy(const DrillFillPolicy& policy) { drillFillPolicy_ = policy; }
+    void setDrillFillPolicy(const DrillFillPolicy& policy) { drillFillPolicy_ = policy; patternDirty_ = true; }
     DrillFillPolicy getDrillFillPolicy() const { return drillFillPolicy_; }
 
     // Drill ↔ Silence gating
-    void setDrillGatePolicy(const DrillGatePolicy& policy) { drillGatePolicy_ = policy; }
+    void setDrillGatePolicy(const DrillGatePolicy& policy) { drillGatePolicy_ = policy; patternDirty_ = true; }
     DrillGatePolicy getDrillGatePolicy() const { return drillGatePolicy_; }
 
     // Musical phrase intelligence
-    void setPhraseDetector(const PhraseDetector& p) { phraseDetector_ = p; }
+    void setPhraseDetector(const PhraseDetector& p) { phraseDetector_ = p; patternDirty_ = true; }
     PhraseDetector getPhraseDetector() const { return phraseDetector_; }
     int getBarsPerPhrase() const { return phraseDetector_.barsPerPhrase; }
-    void setBarsPerPhrase(int bars) { phraseDetector_.barsPerPhrase = bars; }
+    void setBarsPerPhrase(int bars) { phraseDetector_.barsPerPhrase = bars; patternDirty_ = true; }
 
     // IDM Macro Presets (behavioral identities)
     void applyIdmMacroPreset(const IdmMacroPreset& preset)
     {
         preset.applyTo(drillMode_, drillFillPolicy_, drillGatePolicy_);
+        patternDirty_ = true;
     }
 
     // IDM macro preset loaders (complete behavioral identities)
@@ -713,7 +752,7 @@ private:
     double sampleRate_ = 48000.0;
     float samplesPerBeat_ = 0.0f;
     float samplesPerStep_ = 0.0f;
-    double position_ = 0.0;
+    double position_ = 0.0;                  // Audio thread: samples into the current step
     int currentStep_ = 0;
     int patternLength_ = 16;
 
@@ -729,11 +768,11 @@ private:
     DrillMode drillMode_;
     RhythmFeelMode rhythmFeelMode_ = RhythmFeelMode::Groove;
     DeterministicRng drillRng_;  // RNG for drill mode
-    int microHitsThisBlock_ = 0;  // Safety counter for audio thread protection
 
     // Drill intensity automation (compositional sequencing)
     DrillAutomationLane drillAutomation_;
-    int currentBar_ = 0;  // Track current bar for automation
+    int currentBar_ = 0;  // Audio thread: bar being played
+    int compileBar_ = 0;  // Editing thread: bar being compiled (automation, fills, phrases)
 
     // Automatic drill fills (context-sensitive)
     DrillFillPolicy drillFillPolicy_;
@@ -766,10 +805,35 @@ private:
     SnareVoice special_;
 
     // PRNG state for probability checks (deterministic)
-    mutable unsigned probSeed = 123;
+    mutable unsigned probSeed = 123;         // Editing thread (compiler)
+    unsigned triggerSeed_ = 123;             // Audio thread (live triggers)
+
+    // Compiled timeline. The editing thread publishes each new pattern
+    // through pending_; the audio thread swaps it in between blocks and
+    // hands the replaced one back through retired_, which the next compile
+    // frees. Nothing is allocated or freed on the audio thread.
+    uint32_t patternSeed_ = 0x12345678u;
+    std::atomic<bool> patternDirty_ { true };
+    const CompiledPattern* latest_ = nullptr;           // Editing thread: last published
+    std::atomic<CompiledPattern*> pending_ { nullptr };
+    std::atomic<CompiledPattern*> retired_ { nullptr };
+
+    // Playback (audio thread)
+    CompiledPattern* active_ = nullptr;
+    int64_t loopPosition_ = 0;               // Samples into the loop
+    size_t nextHit_ = 0;                     // First hit at or after loopPosition_
 
     float processDrumVoice(Track::DrumType type, float velocity);
-    void advanceStep();
+
+    // Pattern compiler helpers (positions in samples, not yet wrapped)
+    void compileStep(int stepIndex, double stepStart, std::vector<CompiledHit>& out);
+    void compileGrooveHit(int trackIndex, const StepCell& cell, double stepStart, float velocity,
+                          std::vector<CompiledHit>& out);
+    DrillFillPolicy getPhraseAwareFillPolicy() const;
+    void adoptPendingPattern();
+    void seekCursor();
+    template <typename Callback>
+    void forEachHitInBlock(int numSamples, Callback&& callback) const;
 
     // Timing system helpers
     void updateDillaDrift(int trackIndex, TimingRole role);
@@ -780,7 +844,7 @@ private:
     bool trackWantsDrill(Track::DrumType type) const;
     bool cellWantsDrill(const StepCell& cell, const DrillMode& drill, float globalDrillAmount) const;
     void scheduleMicroBurst(int trackIndex, const StepCell& cell,
-                           double stepStartSeconds, double stepDurationSeconds,
+                           double stepStart, std::vector<CompiledHit>& out,
                            float effectiveDrillAmount = -1.0f); // -1 means use drillMode_.amount
     int chooseGridDivisor(DrillGrid grid);
 
@@ -792,7 +856,6 @@ private:
     bool shouldGateStep(const DrillGatePolicy& policy);
 
     // Bar tracking for automation
-    void updateBarIndex();
     int getStepsPerBar() const { return 16; } // 16 steps = 4 beats at 16th note resolution
 };
 
@@ -909,6 +972,11 @@ public:
     float getParameter(const char* paramId) const override;
     void setParameter(const char* paramId, float value) override;
 
+    // Editing (message or worker) thread: hands timing parameter changes to
+    // the sequencer and recompiles the pattern. setParameter() also arrives
+    // on the audio thread (AUv3 render events), so it only records them.
+    void updatePattern();
+
     // Base class interface implementations (call enhanced versions)
     bool savePreset(char* jsonBuffer, int jsonBufferSize) const override;
     bool loadPreset(const char* jsonData) override;
@@ -969,6 +1037,26 @@ private:
                                   0.8f, 0.8f, 0.8f, 0.8f, 0.8f, 0.8f, 0.8f, 0.8f};
     } params_;
 
+    // Pattern timing as last set, read by updatePattern()
+    struct TimingParameters
+    {
+        std::atomic<float> tempo { 120.0f };
+        std::atomic<float> swing { 0.0f };
+        std::atomic<float> patternLength { 16.0f };
+        std::atomic<float> pocketOffset { 0.0f };
+        std::atomic<float> pushOffset { -0.04f };
+        std::atomic<float> pullOffset { +0.06f };
+        std::atomic<float> dillaAmount { 0.6f };
+        std::atomic<float> dillaHatBias { 0.55f };
+        std::atomic<float> dillaSnareLate { 0.8f };
+        std::atomic<float> dillaKickTight { 0.7f };
+        std::atomic<float> dillaMaxDrift { 0.15f };
+    } timing_;
+    std::atomic<bool> timingChanged_ { false };
+
+    void storeTimingParameters();  // params_ -> timing_
+    void applyTimingParameters();  // timing_ -> sequencer (editing thread)
+
     VoiceParams voiceParams_;  // Drum voice parameters for kit presets
 
     double sampleRate_ = 48000.0;
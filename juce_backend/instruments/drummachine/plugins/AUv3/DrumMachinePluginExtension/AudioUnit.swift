@@ -13,6 +13,10 @@ public class AudioUnit: AUAudioUnit {
     var dsp: DrumMachineDSPWrapper?
     var parameterTree: AUParameterTree!
 
+    // Parameter events arrive in the render block, where the pattern must
+    // not be recompiled; this timer picks the changes up off the audio thread
+    private var patternTimer: DispatchSourceTimer?
+
     // Drum Machine Parameters
     private let globalParameters: [AUParameterIdentifier: (name: String, range: ClosedRange<Float>, unit: AUUnitParameterUnit, defaultValue: Float)] = [
         "tempo": ("Tempo", 60.0...200.0, .bpm, 120.0),
@@ -182,9 +186,19 @@ public class AudioUnit: AUAudioUnit {
             dsp.initialize(withSampleRate: format.sampleRate,
                           maximumFramesToRender: Int32(self.maximumFramesToRender))
         }
+
+        let timer = DispatchSource.makeTimerSource(queue: DispatchQueue.global(qos: .userInitiated))
+        timer.schedule(deadline: .now(), repeating: .milliseconds(20))
+        timer.setEventHandler { [weak self] in
+            self?.dsp?.updatePattern()
+        }
+        timer.resume()
+        patternTimer = timer
     }
 
     public override func deallocateRenderResources() {
+        patternTimer?.cancel()
+        patternTimer = nil
         super.deallocateRenderResources()
     }
 
@@ -48,6 +48,12 @@ public class DrumMachineDSPWrapper: NSObject {
         return DrumMachineDSP_GetParameter(ptr, address)
     }
 
+    public func updatePattern() {
+        if let ptr = dspPtr {
+            DrumMachineDSP_UpdatePattern(ptr)
+        }
+    }
+
     public func handleMIDIEvent(_ message: [UInt8], messageSize: UInt8) {
         if let ptr = dspPtr {
             message.withUnsafeBytes { bytes in
@@ -158,6 +164,11 @@ private func DrumMachineDSP_GetParameter(_ dsp: OpaquePointer, _ address: AUPara
     return impl.getParameter(address)
 }
 
+private func DrumMachineDSP_UpdatePattern(_ dsp: OpaquePointer) {
+    let impl = Unmanaged<AnyObject>.fromOpaque(dsp).takeUnretainedValue() as! DrumMachineDSP
+    impl.updatePattern()
+}
+
 private func DrumMachineDSP_HandleMIDIEvent(_ dsp: OpaquePointer, _ message: UnsafeRawPointer, _ messageSize: UInt8) {
     let impl = Unmanaged<AnyObject>.fromOpaque(dsp).takeUnretainedValue() as! DrumMachineDSP
     let bytes = message.assumingMemoryBound(to: UInt8.self)
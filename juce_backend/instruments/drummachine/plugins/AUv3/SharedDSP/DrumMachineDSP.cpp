@@ -380,6 +380,12 @@ public:
         return dsp_->getParameter(paramId);
     }
 
+    void updatePattern() {
+        if (dsp_) {
+            dsp_->updatePattern();
+        }
+    }
+
     void handleMIDIEvent(const uint8_t *message, uint8_t messageSize) {
         if (!dsp_ || messageSize < 3) return;
 
@@ -502,6 +508,10 @@ float DrumMachineDSP::getParameter(AUParameterAddress address) const {
     return impl->getParameter(address);
 }
 
+void DrumMachineDSP::updatePattern() {
+    impl->updatePattern();
+}
+
 void DrumMachineDSP::handleMIDIEvent(const uint8_t *message, uint8_t messageSize) {
     impl->handleMIDIEvent(message, messageSize);
 }
@@ -160,6 +160,10 @@ public:
     void setParameter(AUParameterAddress address, float value);
     float getParameter(AUParameterAddress address) const;
 
+    // Recompiles the pattern after timing parameter changes; call from a
+    // non-realtime thread, never from the render block
+    void updatePattern();
+
     // MIDI
     void handleMIDIEvent(const uint8_t *message, uint8_t messageSize);
 
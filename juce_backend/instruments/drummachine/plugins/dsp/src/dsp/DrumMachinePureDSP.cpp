@@ -667,14 +667,19 @@ StepSequencer::StepSequencer()
     }
 }
 
+StepSequencer::~StepSequencer()
+{
+    // latest_ is the pending or the active pattern, never owned separately
+    delete pending_.exchange(nullptr);
+    delete retired_.exchange(nullptr);
+    delete active_;
+}
+
 void StepSequencer::prepare(double sampleRate, int samplesPerBlock)
 {
     sampleRate_ = sampleRate;
     setTempo(tempo_);
 
-    // Reset micro-hit safety counter at start of each audio block
-    microHitsThisBlock_ = 0;
-
     // Prepare all drum voices
     kick_.prepare(sampleRate);
     snare_.prepare(sampleRate);
@@ -691,13 +696,23 @@ void StepSequencer::prepare(double sampleRate, int samplesPerBlock)
     tambourine_.prepare(sampleRate);
     percussion_.prepare(sampleRate);
     special_.prepare(sampleRate);
+
+    // Not playing yet: install the timeline right away
+    compilePattern();
+    adoptPendingPattern();
+    delete retired_.exchange(nullptr, std::memory_order_acq_rel);
+    seekCursor();
 }
 
 void StepSequencer::reset()
 {
     position_ = 0.0;
     currentStep_ = 0;
-    microHitsThisBlock_ = 0;  // Reset micro-hit safety counter
+    currentBar_ = 0;
+    loopPosition_ = 0;
+
+    adoptPendingPattern();
+    seekCursor();
 
     kick_.reset();
     snare_.reset();
@@ -722,16 +737,19 @@ void StepSequencer::setTempo(float bpm)
     float beatsPerSecond = bpm / 60.0f;
     samplesPerBeat_ = sampleRate_ / beatsPerSecond;
     samplesPerStep_ = samplesPerBeat_ / 4.0f;  // 16th notes
+    patternDirty_ = true;
 }
 
 void StepSequencer::setSwing(float swingAmount)
 {
     swingAmount_ = swingAmount;
+    patternDirty_ = true;
 }
 
 void StepSequencer::setPatternLength(int length)
 {
     patternLength_ = std::max(1, std::min(16, length));
+    patternDirty_ = true;
 }
 
 bool StepSequencer::isTrackTriggered(int trackIndex, int stepIndex) const
@@ -746,19 +764,22 @@ void StepSequencer::triggerTrack(int trackIndex, int stepIndex, float velocity)
 {
     if (trackIndex < 0 || trackIndex >= static_cast<int>(tracks_.size())) return;
     if (stepIndex < 0 || stepIndex >= 16) return;
+    if (active_ == nullptr) return;
 
-    auto& step = tracks_[trackIndex].steps[stepIndex];
+    // Read the playing pattern's snapshot; tracks_ belongs to the editing thread
+    const Track& track = active_->tracks[static_cast<size_t>(trackIndex)];
+    const auto& step = track.steps[static_cast<size_t>(stepIndex)];
 
     // Check probability
     if (step.probability < 1.0f)
     {
-        probSeed = probSeed * 1103515245 + 12345;
-        float randVal = static_cast<float>((probSeed & 0x7fffffff)) / static_cast<float>(0x7fffffff);
+        triggerSeed_ = triggerSeed_ * 1103515245 + 12345;
+        float randVal = static_cast<float>((triggerSeed_ & 0x7fffffff)) / static_cast<float>(0x7fffffff);
         if (randVal > step.probability) return;
     }
 
     // Trigger appropriate drum voice
-    Track::DrumType type = tracks_[trackIndex].type;
+    Track::DrumType type = track.type;
 
     // Apply flam
     if (step.hasFlam)
@@ -782,18 +803,11 @@ void StepSequencer::triggerTrack(int trackIndex, int stepIndex, float velocity)
     }
 }
 
-void StepSequencer::triggerAllTracks(int stepIndex)
+DrillFillPolicy StepSequencer::getPhraseAwareFillPolicy() const
 {
-    // ========================================================================
-    // PHASE 0: Phrase-Aware Intelligence (Musical Form)
-    // ========================================================================
-
-    // Create phrase-aware copies of policies (don't modify originals)
     DrillFillPolicy phraseAwareFill = drillFillPolicy_;
-    DrillGatePolicy phraseAwareGate = drillGatePolicy_;
 
-    // Phrase-aware fill escalation
-    if (phraseDetector_.isPhraseEnd(currentBar_))
+    if (phraseDetector_.isPhraseEnd(compileBar_))
     {
         // Phrase boundaries: more intense fills
         phraseAwareFill.triggerChance = std::max(phraseAwareFill.triggerChance, 0.9f);
@@ -806,8 +820,21 @@ void StepSequencer::triggerAllTracks(int stepIndex)
         phraseAwareFill.fillAmount = std::min(phraseAwareFill.fillAmount, 0.6f);
     }
 
+    return phraseAwareFill;
+}
+
+void StepSequencer::compileStep(int stepIndex, double stepStart, std::vector<CompiledHit>& out)
+{
+    // ========================================================================
+    // PHASE 0: Phrase-Aware Intelligence (Musical Form)
+    // ========================================================================
+
+    // Create phrase-aware copies of policies (don't modify originals)
+    const DrillFillPolicy phraseAwareFill = getPhraseAwareFillPolicy();
+    DrillGatePolicy phraseAwareGate = drillGatePolicy_;
+
     // Phrase-aware gate activation (temporal collapse at boundaries)
-    if (phraseDetector_.isPhraseEnd(currentBar_))
+    if (phraseDetector_.isPhraseEnd(compileBar_))
     {
         phraseAwareGate.enabled = true;  // Enable gate at phrase ends
     }
@@ -826,7 +853,7 @@ void StepSequencer::triggerAllTracks(int stepIndex)
     // Apply automation (compositional sequencing)
     if (!drillAutomation_.points.empty())
     {
-        const float automatedAmount = drillAutomation_.evaluateAt(currentBar_);
+        const float automatedAmount = drillAutomation_.evaluateAt(compileBar_);
         effectiveDrillAmount = automatedAmount; // Automation overrides base
     }
 
@@ -905,62 +932,207 @@ void StepSequencer::triggerAllTracks(int stepIndex)
         {
             // DRILL MODE: Apply micro-burst scheduling
             // Note: drill mode bypasses groove timing layers for burst hits
-            double stepStartSeconds = 0.0; // Relative to current step
-            double stepDurationSeconds = samplesPerStep_ / sampleRate_;
-
             // Pass effective drill amount (from automation/fill/gate)
-            scheduleMicroBurst(i, cell, stepStartSeconds, stepDurationSeconds, effectiveDrillAmount);
+            scheduleMicroBurst(i, cell, stepStart, out, effectiveDrillAmount);
         }
         else
         {
             // GROOVE MODE: Apply timing layers (swing + role + Dilla)
             applyTimingLayers(i, stepIndex);
-            triggerTrack(i, stepIndex, cell.velocity / 127.0f);
+            compileGrooveHit(i, cell, stepStart, cell.velocity / 127.0f, out);
         }
     }
 }
 
-void StepSequencer::advance(int numSamples)
+void StepSequencer::compileGrooveHit(int trackIndex, const StepCell& cell, double stepStart, float velocity,
+                                     std::vector<CompiledHit>& out)
 {
-    position_ += numSamples;
+    // Check probability
+    if (cell.probability < 1.0f)
+    {
+        probSeed = probSeed * 1103515245 + 12345;
+        float randVal = static_cast<float>((probSeed & 0x7fffffff)) / static_cast<float>(0x7fffffff);
+        if (randVal > cell.probability) return;
+    }
+
+    const double hitStart = stepStart + static_cast<double>(cell.timingOffset) * samplesPerStep_;
+    const auto addHit = [&](double position, float hitVelocity)
+    {
+        out.push_back({ static_cast<int64_t>(std::llround(position)), static_cast<uint8_t>(trackIndex), hitVelocity });
+    };
 
-    // Check if we've advanced past the current step
-    while (position_ >= samplesPerStep_)
+    // Apply flam: grace note 15 ms ahead of the main hit
+    if (cell.hasFlam)
+    {
+        addHit(hitStart - 0.015 * sampleRate_, velocity * 0.7f);
+    }
+
+    // Apply roll: notes spread evenly across the step
+    if (cell.isRoll && cell.rollNotes > 1)
+    {
+        const double spacing = samplesPerStep_ / static_cast<double>(cell.rollNotes);
+        for (int i = 0; i < cell.rollNotes; ++i)
+        {
+            addHit(hitStart + i * spacing, velocity);
+        }
+    }
+    else
     {
-        position_ -= samplesPerStep_;
-        advanceStep();
+        addHit(hitStart, velocity);
     }
 }
 
-void StepSequencer::advanceStep()
+void StepSequencer::compilePattern()
 {
-    currentStep_ = (currentStep_ + 1) % patternLength_;
+    // Edits made from here on need another compile
+    patternDirty_ = false;
+
+    // The pattern the audio thread swapped out last time is ours to free
+    delete retired_.exchange(nullptr, std::memory_order_acq_rel);
 
-    // Update bar index for automation
-    updateBarIndex();
+    auto compiled = std::make_unique<CompiledPattern>();
+    auto& hits = compiled->hits;
 
-    // Check if we're at the start of a new bar (step 0)
-    if (currentStep_ == 0)
+    const int bars = std::max(1, std::min(16, phraseDetector_.barsPerPhrase));
+    const double stepLength = std::max(1.0, static_cast<double>(samplesPerStep_));
+
+    compiled->bars = bars;
+    compiled->patternLength = patternLength_;
+    compiled->stepLengthSamples = stepLength;
+    compiled->loopLengthSamples = std::max<int64_t>(1, std::llround(bars * patternLength_ * stepLength));
+
+    // Every random choice starts from the pattern seed, so a pattern always
+    // compiles to the same hits and the loop repeats exactly
+    drillRng_ = DeterministicRng(patternSeed_);
+    probSeed = patternSeed_;
+    for (auto& state : dillaStates_)
     {
-        // Apply phrase-aware intelligence to fill policy for the new bar
-        DrillFillPolicy phraseAwareFill = drillFillPolicy_;
+        state.drift = 0.0f;
+    }
+    drillGateState_ = DrillGateState{};
+    drillFillState_ = DrillFillState{};
 
-        // Phrase boundaries get more aggressive fill triggering
-        if (phraseDetector_.isPhraseEnd(currentBar_))
+    // One loop covers a phrase, so phrase-end fills and gates are part of it
+    for (int bar = 0; bar < bars; ++bar)
+    {
+        compileBar_ = bar;
+        updateFillState(getPhraseAwareFillPolicy());
+
+        for (int step = 0; step < patternLength_; ++step)
         {
-            phraseAwareFill.triggerChance = std::max(phraseAwareFill.triggerChance, 0.9f);
+            compileStep(step, (bar * patternLength_ + step) * stepLength, hits);
         }
-        else
+    }
+
+    // Early hits (push, flams) before the loop start wrap to its end
+    const int64_t loopLength = compiled->loopLengthSamples;
+    for (auto& hit : hits)
+    {
+        hit.samplePosition = ((hit.samplePosition % loopLength) + loopLength) % loopLength;
+    }
+
+    std::stable_sort(hits.begin(), hits.end(), [](const CompiledHit& a, const CompiledHit& b)
+    {
+        return a.samplePosition != b.samplePosition ? a.samplePosition < b.samplePosition : a.track < b.track;
+    });
+
+    // Timing layers write into the cells, so snapshot the tracks afterwards
+    compiled->tracks = tracks_;
+
+    // A pattern the audio thread never picked up is simply replaced
+    latest_ = compiled.get();
+    delete pending_.exchange(compiled.release(), std::memory_order_acq_rel);
+}
+
+const CompiledPattern& StepSequencer::getCompiledPattern() const
+{
+    static const CompiledPattern empty;
+    return latest_ != nullptr ? *latest_ : empty;
+}
+
+void StepSequencer::adoptPendingPattern()
+{
+    if (pending_.load(std::memory_order_acquire) == nullptr)
+        return;
+
+    // Hand the playing pattern back first; if the last one is still
+    // uncollected, keep playing this one and try again next block
+    if (active_ != nullptr)
+    {
+        CompiledPattern* expected = nullptr;
+        if (!retired_.compare_exchange_strong(expected, active_, std::memory_order_acq_rel))
+            return;
+    }
+
+    active_ = pending_.exchange(nullptr, std::memory_order_acq_rel);
+    loopPosition_ = loopPosition_ % active_->loopLengthSamples;
+}
+
+void StepSequencer::seekCursor()
+{
+    if (active_ == nullptr)
+        return;
+
+    const auto& hits = active_->hits;
+    const auto it = std::lower_bound(hits.begin(), hits.end(), loopPosition_,
+                                     [](const CompiledHit& hit, int64_t position) { return hit.samplePosition < position; });
+    nextHit_ = static_cast<size_t>(it - hits.begin());
+
+    const int64_t step = static_cast<int64_t>(loopPosition_ / active_->stepLengthSamples);
+    currentStep_ = static_cast<int>(step % active_->patternLength);
+    currentBar_ = static_cast<int>(step / active_->patternLength);
+    position_ = loopPosition_ - step * active_->stepLengthSamples;
+}
+
+template <typename Callback>
+void StepSequencer::forEachHitInBlock(int numSamples, Callback&& callback) const
+{
+    if (active_ == nullptr)
+        return;
+
+    const auto& hits = active_->hits;
+    const int64_t loopLength = active_->loopLengthSamples;
+
+    if (hits.empty() || loopLength <= 0)
+        return;
+
+    int64_t position = loopPosition_;
+    size_t index = nextHit_;
+    int64_t blockOffset = 0;
+    int fired = 0;
+
+    while (blockOffset < numSamples && fired < kMaxMicroHitsPerBlock)
+    {
+        if (index >= hits.size())
         {
-            phraseAwareFill.triggerChance = std::min(phraseAwareFill.triggerChance, 0.4f);
+            // Wrap to the top of the loop
+            blockOffset += loopLength - position;
+            position = 0;
+            index = 0;
+            continue;
         }
 
-        // Update fill state for the new bar (phrase-aware)
-        updateFillState(phraseAwareFill);
+        const CompiledHit& hit = hits[index];
+        const int64_t hitOffset = blockOffset + (hit.samplePosition - position);
+        if (hitOffset >= numSamples)
+            break;
+
+        callback(hit, static_cast<int>(hitOffset));
+        ++fired;
+        ++index;
     }
+}
 
-    // Trigger all tracks at current step
-    triggerAllTracks(currentStep_);
+void StepSequencer::advance(int numSamples)
+{
+    if (active_ != nullptr)
+    {
+        loopPosition_ = (loopPosition_ + numSamples) % active_->loopLengthSamples;
+    }
+
+    // Patterns published during the block take effect from the next one
+    adoptPendingPattern();
+    seekCursor();
 }
 
 //==============================================================================
@@ -1109,15 +1281,38 @@ void StepSequencer::processTrack(int trackIndex, float* output, int numSamples)
 {
     if (trackIndex < 0 || trackIndex >= static_cast<int>(tracks_.size())) return;
 
-    // Clear output
-    std::fill(output, output + numSamples, 0.0f);
+    if (active_ == nullptr)
+    {
+        std::fill(output, output + numSamples, 0.0f);
+        return;
+    }
+
+    // This track's hits in the block, in order (from the compiled timeline)
+    struct BlockHit { int offset; float velocity; };
+    std::array<BlockHit, kMaxMicroHitsPerBlock> blockHits;
+    int numBlockHits = 0;
+
+    forEachHitInBlock(numSamples, [&](const CompiledHit& hit, int offset)
+    {
+        if (hit.track == trackIndex)
+        {
+            blockHits[static_cast<size_t>(numBlockHits++)] = { offset, hit.velocity };
+        }
+    });
 
-    // Process the drum voice for this track
-    Track::DrumType type = tracks_[trackIndex].type;
+    // Process the drum voice for this track, triggering at exact sample offsets
+    Track::DrumType type = active_->tracks[static_cast<size_t>(trackIndex)].type;
+    int nextBlockHit = 0;
 
     for (int i = 0; i < numSamples; ++i)
     {
-        output[i] = processDrumVoice(type, 0.0f);  // 0 velocity = process existing envelope
+        float velocity = 0.0f;  // 0 velocity = process existing envelope
+        while (nextBlockHit < numBlockHits && blockHits[static_cast<size_t>(nextBlockHit)].offset == i)
+        {
+            velocity = std::max(velocity, blockHits[static_cast<size_t>(nextBlockHit++)].velocity);
+        }
+
+        output[i] = processDrumVoice(type, velocity);
     }
 }
 
@@ -1126,6 +1321,7 @@ void StepSequencer::setTrack(int index, const Track& track)
     if (index >= 0 && index < static_cast<int>(tracks_.size()))
     {
         tracks_[index] = track;
+        patternDirty_ = true;
     }
 }
 
@@ -1247,24 +1443,13 @@ bool DrumMachinePureDSP::prepare(double sampleRate, int blockSize)
     sampleRate_ = sampleRate;
     blockSize_ = blockSize;
 
-    sequencer_.prepare(sampleRate, blockSize);
-    sequencer_.setTempo(params_.tempo);
-    sequencer_.setPatternLength(static_cast<int>(params_.patternLength));
-
     // Initialize timing parameters
-    RoleTimingParams roleParams;
-    roleParams.pocketOffset = params_.pocketOffset;
-    roleParams.pushOffset = params_.pushOffset;
-    roleParams.pullOffset = params_.pullOffset;
-    sequencer_.setRoleTimingParams(roleParams);
+    timingChanged_.store(false, std::memory_order_relaxed);
+    storeTimingParameters();
+    applyTimingParameters();
 
-    DillaParams dillaParams;
-    dillaParams.amount = params_.dillaAmount;
-    dillaParams.hatBias = params_.dillaHatBias;
-    dillaParams.snareLate = params_.dillaSnareLate;
-    dillaParams.kickTight = params_.dillaKickTight;
-    dillaParams.maxDrift = params_.dillaMaxDrift;
-    sequencer_.setDillaParams(dillaParams);
+    // Last, so the timeline it builds and installs has the settings above
+    sequencer_.prepare(sampleRate, blockSize);
 
     return true;
 }
@@ -1381,15 +1566,19 @@ void DrumMachinePureDSP::setParameter(const char* paramId, float value)
     // Get old value for logging (before change)
     float oldValue = getParameter(paramId);
 
+    // Timing parameters are only recorded here: this may be the audio thread,
+    // and the sequencer is updated and recompiled by updatePattern()
+    std::atomic<float>* timing = nullptr;
+
     if (std::strcmp(paramId, "tempo") == 0)
     {
         params_.tempo = value;
-        sequencer_.setTempo(value);
+        timing = &timing_.tempo;
     }
     else if (std::strcmp(paramId, "swing") == 0)
     {
         params_.swing = value;
-        sequencer_.setSwing(value);
+        timing = &timing_.swing;
     }
     else if (std::strcmp(paramId, "master_volume") == 0)
     {
@@ -1398,65 +1587,49 @@ void DrumMachinePureDSP::setParameter(const char* paramId, float value)
     else if (std::strcmp(paramId, "pattern_length") == 0)
     {
         params_.patternLength = value;
-        sequencer_.setPatternLength(static_cast<int>(value));
+        timing = &timing_.patternLength;
     }
     // Role timing parameters
     else if (std::strcmp(paramId, "pocket_offset") == 0)
     {
         params_.pocketOffset = value;
-        RoleTimingParams params = sequencer_.getRoleTimingParams();
-        params.pocketOffset = value;
-        sequencer_.setRoleTimingParams(params);
+        timing = &timing_.pocketOffset;
     }
     else if (std::strcmp(paramId, "push_offset") == 0)
     {
         params_.pushOffset = value;
-        RoleTimingParams params = sequencer_.getRoleTimingParams();
-        params.pushOffset = value;
-        sequencer_.setRoleTimingParams(params);
+        timing = &timing_.pushOffset;
     }
     else if (std::strcmp(paramId, "pull_offset") == 0)
     {
         params_.pullOffset = value;
-        RoleTimingParams params = sequencer_.getRoleTimingParams();
-        params.pullOffset = value;
-        sequencer_.setRoleTimingParams(params);
+        timing = &timing_.pullOffset;
     }
     // Dilla parameters
     else if (std::strcmp(paramId, "dilla_amount") == 0)
     {
         params_.dillaAmount = value;
-        DillaParams params = sequencer_.getDillaParams();
-        params.amount = value;
-        sequencer_.setDillaParams(params);
+        timing = &timing_.dillaAmount;
     }
     else if (std::strcmp(paramId, "dilla_hat_bias") == 0)
     {
         params_.dillaHatBias = value;
-        DillaParams params = sequencer_.getDillaParams();
-        params.hatBias = value;
-        sequencer_.setDillaParams(params);
+        timing = &timing_.dillaHatBias;
     }
     else if (std::strcmp(paramId, "dilla_snare_late") == 0)
     {
         params_.dillaSnareLate = value;
-        DillaParams params = sequencer_.getDillaParams();
-        params.snareLate = value;
-        sequencer_.setDillaParams(params);
+        timing = &timing_.dillaSnareLate;
     }
     else if (std::strcmp(paramId, "dilla_kick_tight") == 0)
     {
         params_.dillaKickTight = value;
-        DillaParams params = sequencer_.getDillaParams();
-        params.kickTight = value;
-        sequencer_.setDillaParams(params);
+        timing = &timing_.dillaKickTight;
     }
     else if (std::strcmp(paramId, "dilla_max_drift") == 0)
     {
         params_.dillaMaxDrift = value;
-        DillaParams params = sequencer_.getDillaParams();
-        params.maxDrift = value;
-        sequencer_.setDillaParams(params);
+        timing = &timing_.dillaMaxDrift;
     }
     else
     {
@@ -1473,10 +1646,61 @@ void DrumMachinePureDSP::setParameter(const char* paramId, float value)
         }
     }
 
+    if (timing != nullptr)
+    {
+        timing->store(value, std::memory_order_relaxed);
+        timingChanged_.store(true, std::memory_order_release);
+    }
+
     // Log parameter change (shared telemetry infrastructure)
     LOG_PARAMETER_CHANGE("DrumMachine", paramId, oldValue, value);
 }
 
+void DrumMachinePureDSP::updatePattern()
+{
+    if (timingChanged_.exchange(false, std::memory_order_acquire))
+        applyTimingParameters();
+
+    if (sequencer_.isPatternDirty())
+        sequencer_.compilePattern();
+}
+
+void DrumMachinePureDSP::storeTimingParameters()
+{
+    timing_.tempo.store(params_.tempo, std::memory_order_relaxed);
+    timing_.swing.store(params_.swing, std::memory_order_relaxed);
+    timing_.patternLength.store(params_.patternLength, std::memory_order_relaxed);
+    timing_.pocketOffset.store(params_.pocketOffset, std::memory_order_relaxed);
+    timing_.pushOffset.store(params_.pushOffset, std::memory_order_relaxed);
+    timing_.pullOffset.store(params_.pullOffset, std::memory_order_relaxed);
+    timing_.dillaAmount.store(params_.dillaAmount, std::memory_order_relaxed);
+    timing_.dillaHatBias.store(params_.dillaHatBias, std::memory_order_relaxed);
+    timing_.dillaSnareLate.store(params_.dillaSnareLate, std::memory_order_relaxed);
+    timing_.dillaKickTight.store(params_.dillaKickTight, std::memory_order_relaxed);
+    timing_.dillaMaxDrift.store(params_.dillaMaxDrift, std::memory_order_relaxed);
+}
+
+void DrumMachinePureDSP::applyTimingParameters()
+{
+    sequencer_.setTempo(timing_.tempo.load(std::memory_order_relaxed));
+    sequencer_.setSwing(timing_.swing.load(std::memory_order_relaxed));
+    sequencer_.setPatternLength(static_cast<int>(timing_.patternLength.load(std::memory_order_relaxed)));
+
+    RoleTimingParams roleParams = sequencer_.getRoleTimingParams();
+    roleParams.pocketOffset = timing_.pocketOffset.load(std::memory_order_relaxed);
+    roleParams.pushOffset = timing_.pushOffset.load(std::memory_order_relaxed);
+    roleParams.pullOffset = timing_.pullOffset.load(std::memory_order_relaxed);
+    sequencer_.setRoleTimingParams(roleParams);
+
+    DillaParams dillaParams = sequencer_.getDillaParams();
+    dillaParams.amount = timing_.dillaAmount.load(std::memory_order_relaxed);
+    dillaParams.hatBias = timing_.dillaHatBias.load(std::memory_order_relaxed);
+    dillaParams.snareLate = timing_.dillaSnareLate.load(std::memory_order_relaxed);
+    dillaParams.kickTight = timing_.dillaKickTight.load(std::memory_order_relaxed);
+    dillaParams.maxDrift = timing_.dillaMaxDrift.load(std::memory_order_relaxed);
+    sequencer_.setDillaParams(dillaParams);
+}
+
 //==============================================================================
 // Base Class Preset Interface
 //==============================================================================
@@ -1883,6 +2107,9 @@ bool DrumMachinePureDSP::loadPresetEx(const char* jsonData, int sections)
     }
     sequencer_.setDillaParams(dillaParams);
 
+    storeTimingParameters();
+    sequencer_.compilePattern();
+
     return true;
 }
 
@@ -2051,17 +2278,6 @@ bool StepSequencer::shouldGateStep(const DrillGatePolicy& policy)
     return false;
 }
 
-//==============================================================================
-// Bar Tracking for Automation
-//==============================================================================
-
-void StepSequencer::updateBarIndex()
-{
-    // Calculate bar index from current step
-    // Assuming 16 steps per bar (4/4 time at 16th note resolution)
-    currentBar_ = currentStep_ / getStepsPerBar();
-}
-
 
 int StepSequencer::chooseGridDivisor(DrillGrid grid)
 {
@@ -2083,11 +2299,15 @@ int StepSequencer::chooseGridDivisor(DrillGrid grid)
 }
 
 void StepSequencer::scheduleMicroBurst(int trackIndex, const StepCell& cell,
-                                       double stepStartSeconds, double stepDurationSeconds,
+                                       double stepStart, std::vector<CompiledHit>& out,
                                        float effectiveDrillAmount)
 {
     if (trackIndex < 0 || trackIndex >= static_cast<int>(tracks_.size())) return;
 
+    // Burst placement works in seconds relative to the step
+    const double stepStartSeconds = 0.0;
+    const double stepDurationSeconds = samplesPerStep_ / sampleRate_;
+
     Track& track = tracks_[trackIndex];
 
     // Get drill mode (per-track override or global)
@@ -2103,17 +2323,12 @@ void StepSequencer::scheduleMicroBurst(int trackIndex, const StepCell& cell,
     const float amt = std::max(0.0f, std::min(1.0f, drill.amount));
     if (!drill.enabled || amt <= 0.0001f || drill.maxBurst <= 1)
     {
-        // Single hit - use existing trigger mechanism
+        // Single hit - same as a groove step
         // Convert timingOffset from fraction to sample delay
         int sampleDelay = static_cast<int>(cell.timingOffset * samplesPerStep_);
         if (sampleDelay >= 0 && sampleDelay < static_cast<int>(samplesPerStep_))
         {
-            // Safety check for single hit
-            if (microHitsThisBlock_ < kMaxMicroHitsPerBlock)
-            {
-                triggerTrack(trackIndex, 0, cell.velocity / 127.0f);
-                microHitsThisBlock_++;
-            }
+            compileGrooveHit(trackIndex, cell, stepStart, cell.velocity / 127.0f, out);
         }
         return;
     }
@@ -2166,13 +2381,6 @@ void StepSequencer::scheduleMicroBurst(int trackIndex, const StepCell& cell,
     // Schedule micro-hits
     for (int i = 0; i < cellBurstCount; ++i)
     {
-        // Safety check: prevent audio thread DOS
-        if (microHitsThisBlock_ >= kMaxMicroHitsPerBlock)
-        {
-            // Drop remaining micro-hits if we've exceeded the limit
-            break;
-        }
-
         // Dropout: chance to skip this micro-hit (scaled by amt)
         if (drillRng_.next01() < std::max(0.0f, std::min(1.0f, static_cast<float>(cellDropout))) * amt)
             continue;
@@ -2224,20 +2432,10 @@ void StepSequencer::scheduleMicroBurst(int trackIndex, const StepCell& cell,
             v = std::max(0.0f, std::min(1.0f, v * spike));
         }
 
-        // Convert velocity back to MIDI range
-        uint8_t midiVel = static_cast<uint8_t>(std::max(0.0f, std::min(1.0f, v)) * 127.0f);
-
-        // Create temporary cell for this micro-hit
-        StepCell microCell = cell;
-        microCell.timingOffset = timingOffsetFraction;
-        microCell.velocity = midiVel;
-        microCell.useDrill = false; // Prevent infinite recursion
-
-        // Trigger the micro-hit
-        triggerTrack(trackIndex, 0, v);
-
-        // Increment safety counter
-        microHitsThisBlock_++;
+        // Schedule the micro-hit
+        const double hitPosition = stepStart + static_cast<double>(timingOffsetFraction) * samplesPerStep_;
+        out.push_back({ static_cast<int64_t>(std::llround(hitPosition)), static_cast<uint8_t>(trackIndex),
+                        std::max(0.0f, std::min(1.0f, v)) });
     }
 }
 
@@ -326,6 +326,154 @@ bool testStereoOutput(TestStats& stats) {
     return true;
 }
 
+//==============================================================================
+// Test 8: Pattern Compiler
+//==============================================================================
+
+static void setupCompilerPattern(StepSequencer& seq, uint32_t seed) {
+    seq.prepare(48000.0, 512);
+    seq.setTempo(120.0f);  // 6000 samples per step
+    seq.setSwing(0.5f);
+
+    DillaParams dilla;
+    dilla.amount = 0.0f;   // No drift, so groove positions are exact
+    seq.setDillaParams(dilla);
+
+    Track kick = seq.getTrack(0);
+    kick.steps[4].active = true;
+    kick.steps[5].active = true;   // Swung step
+    seq.setTrack(0, kick);
+
+    Track hats = seq.getTrack(2);
+    for (auto& step : hats.steps) {
+        step.active = true;
+        step.probability = 0.5f;
+        step.drillIntent = DrillIntent::Emphasize;
+    }
+    seq.setTrack(2, hats);
+
+    seq.setDrillMode(StepSequencer::presetAmenShredder());
+    seq.setPatternSeed(seed);
+    seq.compilePattern();
+}
+
+bool testPatternCompiler(TestStats& stats) {
+    std::cout << "\n[Test 8] Pattern Compiler" << std::endl;
+
+    StepSequencer a, b, c;
+    setupCompilerPattern(a, 1);
+    setupCompilerPattern(b, 1);
+    setupCompilerPattern(c, 2);
+
+    const CompiledPattern& timeline = a.getCompiledPattern();
+    std::cout << "    Hits per loop: " << timeline.hits.size()
+              << ", loop: " << timeline.loopLengthSamples << " samples" << std::endl;
+
+    if (timeline.loopLengthSamples != 4 * 16 * 6000 || timeline.hits.empty()) {
+        stats.fail("pattern_compiler", "Unexpected loop length or empty timeline");
+        return false;
+    }
+
+    int kicks = 0;
+    for (size_t i = 0; i < timeline.hits.size(); ++i) {
+        const auto& hit = timeline.hits[i];
+        if (hit.samplePosition < 0 || hit.samplePosition >= timeline.loopLengthSamples
+            || (i > 0 && hit.samplePosition < timeline.hits[i - 1].samplePosition)) {
+            stats.fail("pattern_compiler", "Timeline not sorted within the loop");
+            return false;
+        }
+        if (hit.track == 0) {
+            const int64_t inBar = hit.samplePosition % (16 * 6000);
+            if (inBar != 4 * 6000 && inBar != 5 * 6000 + 1500) {
+                stats.fail("pattern_compiler", "Kick not at its step (plus swing)");
+                return false;
+            }
+            ++kicks;
+        }
+    }
+    if (kicks != 8) {
+        stats.fail("pattern_compiler", "Expected two kicks per bar over four bars");
+        return false;
+    }
+
+    // Same seed, same timeline; another seed rolls probability and drill differently
+    const auto& same = b.getCompiledPattern().hits;
+    bool identical = same.size() == timeline.hits.size();
+    for (size_t i = 0; identical && i < same.size(); ++i) {
+        identical = same[i].samplePosition == timeline.hits[i].samplePosition
+                 && same[i].track == timeline.hits[i].track
+                 && same[i].velocity == timeline.hits[i].velocity;
+    }
+    if (!identical || c.getCompiledPattern().hits.size() == timeline.hits.size()) {
+        stats.fail("pattern_compiler", "Timeline is not determined by the seed");
+        return false;
+    }
+
+    // Playback fires the kick on its exact sample, not at a block boundary.
+    // The reference keeps playing the original pattern for the edit below.
+    StepSequencer seq, reference;
+    Track kick;
+    for (StepSequencer* s : { &seq, &reference }) {
+        s->prepare(48000.0, 512);
+        s->setTempo(120.0f);
+        kick = s->getTrack(0);
+        kick.steps[3].active = true;
+        s->setTrack(0, kick);
+        s->compilePattern();
+    }
+
+    std::vector<float> block(500), referenceBlock(500);
+    int position = 0;
+    int firstSound = -1;
+    for (; position < 24000; position += 500) {
+        seq.processTrack(0, block.data(), 500);
+        reference.processTrack(0, referenceBlock.data(), 500);
+        for (int i = 0; i < 500 && firstSound < 0; ++i) {
+            if (block[i] != 0.0f) firstSound = position + i;
+        }
+        seq.advance(500);
+        reference.advance(500);
+    }
+    std::cout << "    Kick onset: sample " << firstSound << std::endl;
+
+    if (firstSound != 3 * 6000) {
+        stats.fail("pattern_compiler", "Kick onset not sample accurate");
+        return false;
+    }
+
+    // An edit is compiled off the audio path and played from the next block;
+    // the kick still ringing from step 3 is common to both, so the first
+    // sample that differs from the reference is the moved kick
+    kick.steps[3].active = false;
+    kick.steps[7].active = true;
+    seq.setTrack(0, kick);
+    if (!seq.isPatternDirty()) {
+        stats.fail("pattern_compiler", "Edit did not mark the pattern dirty");
+        return false;
+    }
+    seq.compilePattern();
+
+    int movedSound = -1;
+    for (; position < 96000 && movedSound < 0; position += 500) {
+        seq.processTrack(0, block.data(), 500);
+        reference.processTrack(0, referenceBlock.data(), 500);
+        for (int i = 0; i < 500 && movedSound < 0; ++i) {
+            if (block[i] != referenceBlock[i]) movedSound = position + i;
+        }
+        seq.advance(500);
+        reference.advance(500);
+    }
+    std::cout << "    Moved kick onset: sample " << movedSound << std::endl;
+
+    if (seq.isPatternDirty() || movedSound != 7 * 6000) {
+        stats.fail("pattern_compiler", "Published edit not played at its step");
+        return false;
+    }
+
+    stats.pass("pattern_compiler");
+    return true;
+}
+
 //==============================================================================
 // Main Test Runner
 //==============================================================================
@@ -344,6 +492,7 @@ int main(int argc, char* argv[]) {
     testSampleRates(stats);
     testParameterChanges(stats);
     testStereoOutput(stats);
+    testPatternCompiler(stats);
 
     stats.printSummary();
 
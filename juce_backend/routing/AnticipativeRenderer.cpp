@@ -0,0 +1,561 @@
+#include "AnticipativeRenderer.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <chrono>
+
+namespace SchillingerEcosystem::Routing {
+
+namespace
+{
+    // Workers look for work this often when every ring is full
+    constexpr auto workerInterval = std::chrono::milliseconds(1);
+
+    int ringIndex(juce::int64 count, int ringLength) noexcept
+    {
+        return static_cast<int>(count % ringLength);
+    }
+}
+
+AnticipativeRenderer::~AnticipativeRenderer()
+{
+    release();
+}
+
+//==============================================================================
+// CONFIGURATION
+//==============================================================================
+
+void AnticipativeRenderer::prepare(double newSampleRate, int newMaxBlockSize, const Settings& newSettings)
+{
+    release();
+
+    sampleRate = newSampleRate;
+    maxBlockSize = std::max(1, newMaxBlockSize);
+    settings = newSettings;
+    settings.chunkSize = std::max(1, settings.chunkSize);
+
+    // Room for a chunk beyond the block the callback may be reading
+    ringLength = std::max(settings.aheadSamples, settings.chunkSize + maxBlockSize);
+    settings.aheadSamples = ringLength;
+
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex);
+
+        for (auto& track : tracks)
+        {
+            if (!track)
+                continue;
+
+            track->ring.setSize(track->numChannels, ringLength);
+            track->ring.clear();
+            track->scratch.setSize(track->numChannels, maxBlockSize);
+
+            track->readCount.store(0);
+            track->writeCount.store(0);
+            track->anchorCount.store(0);
+            track->anchorPosition.store(0);
+            track->loopStart.store(0);
+            track->loopEnd.store(0);
+            track->loopRevision = 0;
+            track->renderedTo = -1;
+            track->seekServed.store(track->seekRequests.load());
+            track->invalidateServed.store(track->invalidateRequests.load());
+        }
+    }
+
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int numThreads = settings.numThreads > 0 ? settings.numThreads : std::max(1, hardwareThreads - 1);
+
+    running.store(true);
+    for (int i = 0; i < numThreads; ++i)
+        workers.emplace_back([this] { workerLoop(); });
+
+    juce::Logger::writeToLog("Anticipative rendering: " + juce::String(numThreads) + " threads, "
+                             + juce::String(settings.chunkSize) + " sample chunks, "
+                             + juce::String(ringLength) + " samples ahead");
+}
+
+void AnticipativeRenderer::release()
+{
+    running.store(false);
+    wake.notify_all();
+
+    for (auto& worker : workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+
+    workers.clear();
+
+    std::lock_guard<std::mutex> lock(scheduleMutex);
+    freeRetiredTracks();
+}
+
+AnticipativeRenderer::TrackId AnticipativeRenderer::addTrack(int numChannels, RenderFunction render,
+                                                             ResetFunction reset)
+{
+    if (!render || numChannels <= 0 || numChannels > maxChannels)
+        return invalidTrack;
+
+    auto track = std::make_unique<Track>();
+    track->numChannels = numChannels;
+    track->render = std::move(render);
+    track->reset = std::move(reset);
+    track->scratch.setSize(numChannels, maxBlockSize);
+    track->pieceMidi.ensureSize(2048);
+
+    if (ringLength > 0)
+    {
+        track->ring.setSize(numChannels, ringLength);
+        track->ring.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(scheduleMutex);
+    freeRetiredTracks();
+
+    for (int id = 0; id < maxTracks; ++id)
+    {
+        if (!tracks[static_cast<size_t>(id)])
+        {
+            tracks[static_cast<size_t>(id)] = std::move(track);
+            return id;
+        }
+    }
+
+    return invalidTrack;
+}
+
+void AnticipativeRenderer::removeTrack(TrackId id)
+{
+    if (id < 0 || id >= maxTracks)
+        return;
+
+    std::lock_guard<std::mutex> lock(scheduleMutex);
+
+    auto& track = tracks[static_cast<size_t>(id)];
+    if (!track)
+        return;
+
+    // Workers only pick tracks from the table, so one rendering this track
+    // now is the last; it is freed once that chunk is done
+    retiredTracks.push_back(std::move(track));
+    freeRetiredTracks();
+}
+
+void AnticipativeRenderer::freeRetiredTracks()
+{
+    retiredTracks.erase(std::remove_if(retiredTracks.begin(), retiredTracks.end(),
+                                       [this](const auto& track) { return tryLock(*track); }),
+                        retiredTracks.end());
+}
+
+int AnticipativeRenderer::getNumTracks() const
+{
+    std::lock_guard<std::mutex> lock(scheduleMutex);
+    return static_cast<int>(std::count_if(tracks.begin(), tracks.end(),
+                                          [](const auto& track) { return track != nullptr; }));
+}
+
+//==============================================================================
+// CONTROL
+//==============================================================================
+
+void AnticipativeRenderer::setLive(TrackId id, bool isLive)
+{
+    // Switching needs no drop here: live blocks empty the ring at the
+    // playhead, and the workers restart from there once the track is back
+    if (auto* track = getTrack(id))
+        track->live.store(isLive, std::memory_order_release);
+}
+
+bool AnticipativeRenderer::isLive(TrackId id) const
+{
+    auto* track = getTrack(id);
+    return track != nullptr && track->live.load(std::memory_order_relaxed);
+}
+
+void AnticipativeRenderer::invalidate(TrackId id)
+{
+    if (auto* track = getTrack(id))
+        track->invalidateRequests.fetch_add(1, std::memory_order_release);
+}
+
+void AnticipativeRenderer::invalidateAll()
+{
+    for (auto& track : tracks)
+    {
+        if (track)
+            track->invalidateRequests.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void AnticipativeRenderer::setLoop(juce::int64 start, juce::int64 end)
+{
+    if (end <= start)
+        start = end = 0;
+
+    if (start == loopStart.load(std::memory_order_relaxed) && end == loopEnd.load(std::memory_order_relaxed))
+        return;
+
+    // The callback re-anchors every track at its next block
+    const auto revision = loopRevision.load(std::memory_order_relaxed);
+    loopRevision.store(revision + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    loopStart.store(start, std::memory_order_relaxed);
+    loopEnd.store(end, std::memory_order_relaxed);
+    loopRevision.store(revision + 2, std::memory_order_release);
+}
+
+//==============================================================================
+// PLAYBACK
+//==============================================================================
+
+bool AnticipativeRenderer::process(TrackId id, juce::AudioBuffer<float>& output, juce::int64 playhead,
+                                   int numSamples, juce::MidiBuffer& liveMidi) noexcept
+{
+    auto* track = getTrack(id);
+    if (track == nullptr || numSamples <= 0)
+        return true;
+
+    followTransport(*track, playhead);
+
+    const juce::int64 start = track->readCount.load(std::memory_order_relaxed);
+    const juce::int64 end = start + numSamples;
+    juce::int64 count = start;
+    bool complete = true;
+
+    if (track->live.load(std::memory_order_acquire))
+    {
+        if (tryLock(*track))
+        {
+            serviceRequests(*track);
+            renderInCallback(*track, output, start, numSamples, 0, liveMidi);
+
+            // Nothing rendered ahead survives a live block
+            track->writeCount.store(end, std::memory_order_release);
+            unlock(*track);
+        }
+        else
+        {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            complete = false;
+        }
+
+        track->readCount.store(end, std::memory_order_release);
+        return complete;
+    }
+
+    // After a jump the ring is not read again until the busy holder has reset it
+    if (ringLength > 0 && track->seekServed.load(std::memory_order_acquire)
+                              == track->seekRequests.load(std::memory_order_relaxed))
+    {
+        const juce::int64 available = track->writeCount.load(std::memory_order_acquire) - start;
+
+        if (available > 0)
+        {
+            const int copied = static_cast<int>(std::min<juce::int64>(available, numSamples));
+            const int index = ringIndex(start, ringLength);
+            const int first = std::min(copied, ringLength - index);
+            const int channels = std::min(track->numChannels, output.getNumChannels());
+
+            for (int channel = 0; channel < channels; ++channel)
+            {
+                const float* ring = track->ring.getReadPointer(channel);
+                float* destination = output.getWritePointer(channel);
+
+                juce::FloatVectorOperations::add(destination, ring + index, first);
+                if (copied > first)
+                    juce::FloatVectorOperations::add(destination + first, ring, copied - first);
+            }
+
+            count += copied;
+        }
+    }
+
+    if (count < end)
+    {
+        // The rest of the block (all of it after a jump) is rendered here
+        if (tryLock(*track))
+        {
+            serviceRequests(*track);
+
+            juce::MidiBuffer noMidi;
+            renderInCallback(*track, output, count, static_cast<int>(end - count),
+                             static_cast<int>(count - start), noMidi);
+            unlock(*track);
+        }
+        else
+        {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            complete = false;
+        }
+    }
+
+    track->readCount.store(end, std::memory_order_release);
+    return complete;
+}
+
+void AnticipativeRenderer::followTransport(Track& track, juce::int64 playhead) noexcept
+{
+    // Take a loop change only once setLoop() has finished writing it
+    const auto revision = loopRevision.load(std::memory_order_acquire);
+    bool loopChanged = false;
+    juce::int64 newLoopStart = 0, newLoopEnd = 0;
+
+    if (revision != track.loopRevision && (revision & 1) == 0)
+    {
+        newLoopStart = loopStart.load(std::memory_order_relaxed);
+        newLoopEnd = loopEnd.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        loopChanged = loopRevision.load(std::memory_order_relaxed) == revision;
+    }
+
+    const juce::int64 count = track.readCount.load(std::memory_order_relaxed);
+    if (!loopChanged && playhead == positionAt(track, count))
+        return;
+
+    track.anchorCount.store(count, std::memory_order_relaxed);
+    track.anchorPosition.store(playhead, std::memory_order_relaxed);
+
+    if (loopChanged)
+    {
+        track.loopStart.store(newLoopStart, std::memory_order_relaxed);
+        track.loopEnd.store(newLoopEnd, std::memory_order_relaxed);
+        track.loopRevision = revision;
+    }
+
+    // Publishes the anchor to whoever services the request
+    track.seekRequests.fetch_add(1, std::memory_order_release);
+}
+
+juce::int64 AnticipativeRenderer::positionAt(const Track& track, juce::int64 count) noexcept
+{
+    const juce::int64 anchorPosition = track.anchorPosition.load(std::memory_order_relaxed);
+    const juce::int64 offset = count - track.anchorCount.load(std::memory_order_relaxed);
+    const juce::int64 start = track.loopStart.load(std::memory_order_relaxed);
+    const juce::int64 end = track.loopEnd.load(std::memory_order_relaxed);
+
+    // Playback that starts past the loop end plays straight on
+    if (end <= start || anchorPosition >= end || offset < end - anchorPosition)
+        return anchorPosition + offset;
+
+    return start + (offset - (end - anchorPosition)) % (end - start);
+}
+
+void AnticipativeRenderer::renderStream(Track& track, juce::AudioBuffer<float>& buffer, juce::int64 start,
+                                        const juce::MidiBuffer& midi, int midiOffset)
+{
+    if (start != track.renderedTo && track.reset)
+        track.reset(positionAt(track, start));
+
+    const juce::int64 loopStart = track.loopStart.load(std::memory_order_relaxed);
+    const juce::int64 loopEnd = track.loopEnd.load(std::memory_order_relaxed);
+    const int numSamples = buffer.getNumSamples();
+    int done = 0;
+
+    // One render call per pass through the loop, each with its own MIDI
+    while (done < numSamples)
+    {
+        const juce::int64 position = positionAt(track, start + done);
+        int count = numSamples - done;
+
+        if (loopEnd > loopStart && position < loopEnd)
+            count = static_cast<int>(std::min<juce::int64>(count, loopEnd - position));
+
+        track.pieceMidi.clear();
+        track.pieceMidi.addEvents(midi, midiOffset + done, count, -(midiOffset + done));
+
+        juce::AudioBuffer<float> piece(buffer.getArrayOfWritePointers(), track.numChannels, done, count);
+        track.render(piece, track.pieceMidi, position);
+        done += count;
+    }
+
+    track.renderedTo = start + numSamples;
+}
+
+void AnticipativeRenderer::renderInCallback(Track& track, juce::AudioBuffer<float>& output, juce::int64 start,
+                                            int numSamples, int outputOffset, juce::MidiBuffer& midi) noexcept
+{
+    const int channels = std::min(track.numChannels, output.getNumChannels());
+    const int capacity = std::max(1, track.scratch.getNumSamples());
+    int done = 0;
+
+    // Blocks longer than prepare() promised are rendered in pieces
+    while (done < numSamples)
+    {
+        const int count = std::min(capacity, numSamples - done);
+
+        juce::AudioBuffer<float> piece(track.scratch.getArrayOfWritePointers(), track.numChannels, count);
+        piece.clear();
+        renderStream(track, piece, start + done, midi, done);
+
+        for (int channel = 0; channel < channels; ++channel)
+            output.addFrom(channel, outputOffset + done, piece, channel, 0, count);
+
+        done += count;
+    }
+
+    callbackRenders.fetch_add(1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+// WORKERS
+//==============================================================================
+
+void AnticipativeRenderer::serviceRequests(Track& track) noexcept
+{
+    const auto seeks = track.seekRequests.load(std::memory_order_acquire);
+    if (seeks != track.seekServed.load(std::memory_order_relaxed))
+    {
+        // Nothing in the ring belongs to the new position, nor does the
+        // track's state
+        track.writeCount.store(track.readCount.load(std::memory_order_acquire), std::memory_order_release);
+        track.renderedTo = -1;
+        track.seekServed.store(seeks, std::memory_order_release);
+    }
+
+    const auto invalidations = track.invalidateRequests.load(std::memory_order_acquire);
+    if (invalidations != track.invalidateServed.load(std::memory_order_relaxed))
+    {
+        // Keep only the block the callback may be copying right now
+        const juce::int64 keep = track.readCount.load(std::memory_order_acquire) + maxBlockSize;
+        if (track.writeCount.load(std::memory_order_relaxed) > keep)
+            track.writeCount.store(keep, std::memory_order_release);
+
+        track.invalidateServed.store(invalidations, std::memory_order_release);
+    }
+}
+
+juce::int64 AnticipativeRenderer::nextChunkStart(const Track& track) const noexcept
+{
+    const juce::int64 readCount = track.readCount.load(std::memory_order_acquire);
+    const juce::int64 start = std::max(track.writeCount.load(std::memory_order_relaxed), readCount);
+
+    return start + settings.chunkSize - readCount <= ringLength ? start : -1;
+}
+
+AnticipativeRenderer::Track* AnticipativeRenderer::takeNeediestTrack()
+{
+    Track* neediest = nullptr;
+    juce::int64 neediestAhead = 0;
+
+    for (auto& track : tracks)
+    {
+        if (!track || track->live.load(std::memory_order_relaxed) || track->busy.load(std::memory_order_relaxed))
+            continue;
+
+        const bool pending = track->seekRequests.load() != track->seekServed.load()
+                          || track->invalidateRequests.load() != track->invalidateServed.load();
+
+        if (!pending && nextChunkStart(*track) < 0)
+            continue;
+
+        // Pending drops first, then the ring closest to running dry
+        const juce::int64 ahead = pending ? -1 : track->writeCount.load() - track->readCount.load();
+
+        if (neediest == nullptr || ahead < neediestAhead)
+        {
+            neediest = track.get();
+            neediestAhead = ahead;
+        }
+    }
+
+    // The callback may have taken it in the meantime; try again next round
+    if (neediest != nullptr && !tryLock(*neediest))
+        return nullptr;
+
+    return neediest;
+}
+
+void AnticipativeRenderer::renderChunk(Track& track, juce::AudioBuffer<float>& chunk, juce::MidiBuffer& midi)
+{
+    serviceRequests(track);
+
+    if (track.live.load(std::memory_order_acquire))
+        return;
+
+    const juce::int64 start = nextChunkStart(track);
+    if (start < 0)
+        return;
+
+    const int count = settings.chunkSize;
+    chunk.setSize(track.numChannels, count, false, false, true);
+    chunk.clear();
+    midi.clear();
+
+    try
+    {
+        renderStream(track, chunk, start, midi, 0);
+    }
+    catch (...)
+    {
+        chunk.clear();
+    }
+
+    // The callback only reads below writeCount, and the room check keeps this
+    // span clear of anything it can still read. A jump during the render
+    // makes the chunk useless, but the next service drops it anyway.
+    const int first = std::min(count, ringLength - ringIndex(start, ringLength));
+
+    for (int channel = 0; channel < track.numChannels; ++channel)
+    {
+        track.ring.copyFrom(channel, ringIndex(start, ringLength), chunk, channel, 0, first);
+        if (count > first)
+            track.ring.copyFrom(channel, 0, chunk, channel, first, count - first);
+    }
+
+    track.writeCount.store(start + count, std::memory_order_release);
+    chunksRendered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AnticipativeRenderer::workerLoop()
+{
+    juce::ScopedNoDenormals noDenormals;
+    juce::MidiBuffer midi;
+    juce::AudioBuffer<float> chunk(maxChannels, settings.chunkSize);
+
+    while (running.load())
+    {
+        Track* track = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(scheduleMutex);
+            track = takeNeediestTrack();
+
+            if (track == nullptr)
+            {
+                wake.wait_for(lock, workerInterval);
+                continue;
+            }
+        }
+
+        renderChunk(*track, chunk, midi);
+        unlock(*track);
+    }
+}
+
+//==============================================================================
+// MONITORING
+//==============================================================================
+
+int AnticipativeRenderer::getSamplesAhead(TrackId id) const
+{
+    auto* track = getTrack(id);
+    if (track == nullptr || track->seekServed.load() != track->seekRequests.load())
+        return 0;
+
+    const juce::int64 ahead = track->writeCount.load() - track->readCount.load();
+    return static_cast<int>(juce::jlimit<juce::int64>(0, ringLength, ahead));
+}
+
+AnticipativeRenderer::Track* AnticipativeRenderer::getTrack(TrackId id) const
+{
+    if (id < 0 || id >= maxTracks)
+        return nullptr;
+
+    return tracks[static_cast<size_t>(id)].get();
+}
+
+} // namespace SchillingerEcosystem::Routing
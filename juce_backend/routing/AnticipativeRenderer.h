@@ -0,0 +1,248 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SchillingerEcosystem::Routing {
+
+/**
+ * @brief Render-ahead for tracks that do not depend on live input
+ *
+ * Tracks that only play sequenced or projected material are rendered ahead
+ * of the playhead by worker threads, in chunks much larger than the device
+ * block, into a ring per track. Such a track must be able to render from
+ * any position it is given: its output is a function of the position, or
+ * it passes a reset that rewinds its state to one. The device callback then only copies from
+ * the rings, so its cost no longer grows with how heavy those tracks are,
+ * and a small device buffer (live monitoring) does not force every track
+ * to run at that size.
+ *
+ * Live tracks (monitored input, live MIDI) are rendered in the callback at
+ * the device block size as before. Workers render the transport as it will
+ * play, wrapping at the loop set with setLoop(), so loop passes are
+ * seamless. Rendered audio is dropped when:
+ * - the playhead jumps anywhere else (seek) or the loop changes: the ring
+ *   restarts at the new position
+ * - invalidate(): parameters changed, so everything beyond the block the
+ *   callback may be reading is rendered again
+ * - setLive(): the track switches between the callback and the workers
+ *
+ * Whenever the ring does not cover a block (right after a jump, or when the
+ * workers fall behind), the callback renders the rest of the block itself,
+ * unless a worker is in the middle of a chunk for that track: then the
+ * block is silent and counts an underrun. A track's render calls never
+ * overlap, whichever thread makes them.
+ *
+ * Threading: prepare(), addTrack() and removeTrack() are message-thread
+ * calls and must not overlap process() (the routing engine holds its graph
+ * lock for both). None of them waits for a worker: a track removed while a
+ * worker renders it is freed by a later call. setLive(), invalidate() and setLoop() may be called from
+ * any thread (setLoop() from one at a time).
+ * process() is the audio thread's: lock-free and allocation-free.
+ */
+class AnticipativeRenderer
+{
+public:
+    using TrackId = int;
+    static constexpr TrackId invalidTrack = -1;
+    static constexpr int maxTracks = 256;
+    static constexpr int maxChannels = 16;
+
+    /**
+     * Renders buffer.getNumSamples() samples from startSample into a
+     * cleared buffer. startSample continues where the last call ended, or
+     * at the loop start after a wrap. midi holds the live MIDI that falls
+     * in this call, relative to its start; worker calls get none.
+     */
+    using RenderFunction = std::function<void(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi,
+                                              juce::int64 startSample)>;
+
+    /**
+     * Called before a render that does not continue the last one (a jump,
+     * an invalidation, a block nobody rendered): rewind or flush whatever
+     * the track carries from its previous output, so that it renders from
+     * position. Runs on whichever thread renders next, the callback's
+     * included.
+     */
+    using ResetFunction = std::function<void(juce::int64 position)>;
+
+    struct Settings
+    {
+        int chunkSize = 2048;           // Samples per worker render call
+        int aheadSamples = 16384;       // Ring length: how far ahead a track can get
+        int numThreads = 0;             // 0: hardware threads less one for the callback
+    };
+
+    AnticipativeRenderer() = default;
+    ~AnticipativeRenderer();
+
+    //==============================================================================
+    // CONFIGURATION (message thread)
+    //==============================================================================
+
+    /**
+     * Size the rings and start the workers; every track restarts empty.
+     * The ring is at least chunkSize + maxBlockSize long.
+     */
+    void prepare(double sampleRate, int maxBlockSize, const Settings& settings);
+
+    /** Stop the workers (also done by prepare() and the destructor) */
+    void release();
+
+    bool isPrepared() const { return !workers.empty(); }
+    const Settings& getSettings() const { return settings; }
+
+    TrackId addTrack(int numChannels, RenderFunction render, ResetFunction reset = {});
+    void removeTrack(TrackId track);
+    int getNumTracks() const;
+
+    //==============================================================================
+    // CONTROL (any thread)
+    //==============================================================================
+
+    /** Live tracks render in the callback; others are rendered ahead */
+    void setLive(TrackId track, bool isLive);
+    bool isLive(TrackId track) const;
+
+    /** Parameters changed: re-render what is ahead of the playhead */
+    void invalidate(TrackId track);
+    void invalidateAll();
+
+    /**
+     * Transport loop: playback that reaches end continues at start. A
+     * change drops what every track has rendered ahead. end <= start
+     * (clearLoop()) plays straight on.
+     */
+    void setLoop(juce::int64 start, juce::int64 end);
+    void clearLoop() { setLoop(0, 0); }
+
+    //==============================================================================
+    // PLAYBACK (audio thread)
+    //==============================================================================
+
+    /**
+     * Add numSamples of the track from playhead into output (channel c of
+     * the track into channel c); a block that reaches the loop end carries
+     * on from the loop start. A playhead other than where the last block
+     * ended (after any wrap) is a jump.
+     * @return false if any of the block was an underrun (played silent)
+     */
+    bool process(TrackId track, juce::AudioBuffer<float>& output, juce::int64 playhead, int numSamples,
+                 juce::MidiBuffer& liveMidi) noexcept;
+
+    //==============================================================================
+    // MONITORING (any thread)
+    //==============================================================================
+
+    /** Samples rendered ahead of the playhead */
+    int getSamplesAhead(TrackId track) const;
+
+    uint32_t getNumUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+    uint32_t getNumChunksRendered() const { return chunksRendered.load(std::memory_order_relaxed); }
+
+    /** Blocks (or parts of blocks) the callback had to render itself */
+    uint32_t getNumCallbackRenders() const { return callbackRenders.load(std::memory_order_relaxed); }
+
+private:
+    struct Track
+    {
+        int numChannels = 2;
+        RenderFunction render;
+        ResetFunction reset;
+        juce::AudioBuffer<float> ring;              // numChannels x ringLength, indexed by stream sample % ringLength
+        juce::AudioBuffer<float> scratch;           // Callback renders, maxBlockSize
+        juce::MidiBuffer pieceMidi;                 // The MIDI of one render call
+        juce::int64 renderedTo = -1;                // Stream sample after the last render; -1 after a jump
+
+        std::atomic<bool> busy { false };           // Held for any render call or ring reset
+        std::atomic<bool> live { false };
+
+        // Samples of the track's output stream. The ring holds
+        // [readCount, writeCount) once seekServed == seekRequests.
+        std::atomic<juce::int64> readCount { 0 };   // Written by the callback only
+        std::atomic<juce::int64> writeCount { 0 };  // Written by the busy holder only
+        std::atomic<uint32_t> seekRequests { 0 };   // Callback: playhead jumped
+        std::atomic<uint32_t> seekServed { 0 };
+        std::atomic<uint32_t> invalidateRequests { 0 };
+        std::atomic<uint32_t> invalidateServed { 0 };
+
+        // Where the stream is on the transport: sample anchorCount plays at
+        // anchorPosition and the transport runs on from there, wrapping at
+        // loopEnd when loopEnd > loopStart. Set by the callback at each jump.
+        std::atomic<juce::int64> anchorCount { 0 };
+        std::atomic<juce::int64> anchorPosition { 0 };
+        std::atomic<juce::int64> loopStart { 0 };
+        std::atomic<juce::int64> loopEnd { 0 };
+        uint32_t loopRevision = 0;                  // Callback only
+    };
+
+    /** Transport position of a stream sample */
+    static juce::int64 positionAt(const Track& track, juce::int64 count) noexcept;
+
+    /**
+     * Render stream samples [start, start + buffer length) into buffer, split
+     * at loop wraps; the buffer's MIDI is midi's from midiOffset on
+     */
+    static void renderStream(Track& track, juce::AudioBuffer<float>& buffer, juce::int64 start,
+                             const juce::MidiBuffer& midi, int midiOffset);
+
+    bool tryLock(Track& track) noexcept { return !track.busy.exchange(true, std::memory_order_acquire); }
+    void unlock(Track& track) noexcept { track.busy.store(false, std::memory_order_release); }
+
+    /** Apply pending jumps and invalidations; busy must be held */
+    void serviceRequests(Track& track) noexcept;
+
+    /** The next chunk's start, or -1 if the ring has no room */
+    juce::int64 nextChunkStart(const Track& track) const noexcept;
+
+    /** Track most in need of a chunk, locked; null if none */
+    Track* takeNeediestTrack();
+
+    void renderChunk(Track& track, juce::AudioBuffer<float>& chunk, juce::MidiBuffer& midi);
+    void renderInCallback(Track& track, juce::AudioBuffer<float>& output, juce::int64 start, int numSamples,
+                          int outputOffset, juce::MidiBuffer& midi) noexcept;
+
+    /** Re-anchor the track at playhead if it jumped or the loop changed; callback only */
+    void followTransport(Track& track, juce::int64 playhead) noexcept;
+
+    /** Free removed tracks no worker holds any more; scheduleMutex must be held */
+    void freeRetiredTracks();
+
+    void workerLoop();
+    Track* getTrack(TrackId track) const;
+
+    Settings settings;
+    double sampleRate = 44100.0;
+    int maxBlockSize = 512;
+    int ringLength = 0;
+
+    std::array<std::unique_ptr<Track>, maxTracks> tracks;
+    std::vector<std::unique_ptr<Track>> retiredTracks;     // Removed while a worker may hold them
+
+    // Transport loop, published seqlock style (odd revision: being written)
+    std::atomic<uint32_t> loopRevision { 0 };
+    std::atomic<juce::int64> loopStart { 0 };
+    std::atomic<juce::int64> loopEnd { 0 };
+
+    // Workers
+    mutable std::mutex scheduleMutex;               // Picking tracks, adding and removing them
+    std::condition_variable wake;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running { false };
+
+    std::atomic<uint32_t> underruns { 0 };
+    std::atomic<uint32_t> chunksRendered { 0 };
+    std::atomic<uint32_t> callbackRenders { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnticipativeRenderer)
+};
+
+} // namespace SchillingerEcosystem::Routing
@@ -1,5 +1,6 @@
 #include "AudioRoutingEngine.h"
 #include "../instrument/InstrumentInstance.h"
+#include "../include/dsp/RealtimeLog.h"
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
@@ -8,6 +9,44 @@
 
 namespace SchillingerEcosystem::Routing {
 
+namespace
+{
+    /** What an instrument's renderer track plays; its render calls never overlap */
+    struct InstrumentFeed
+    {
+        std::shared_ptr<InstrumentInstance> instrument;
+        AudioRoutingEngine::SequenceFunction sequence;
+        int pieceSize = 512;
+        juce::MidiBuffer blockMidi;     // Live MIDI and the sequence's events
+        juce::MidiBuffer pieceMidi;
+    };
+
+    // Instruments are prepared for their block size; longer spans (render
+    // ahead chunks) are rendered in pieces of it, each with its own MIDI
+    void renderFeed(InstrumentFeed& feed, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi,
+                    juce::int64 startSample)
+    {
+        const int numSamples = buffer.getNumSamples();
+        const int pieceSize = std::max(1, feed.pieceSize);
+
+        feed.blockMidi.clear();
+        feed.blockMidi.addEvents(midi, 0, numSamples, 0);
+        if (feed.sequence)
+            feed.sequence(feed.blockMidi, startSample, numSamples);
+
+        for (int done = 0; done < numSamples; done += pieceSize)
+        {
+            const int count = std::min(pieceSize, numSamples - done);
+
+            feed.pieceMidi.clear();
+            feed.pieceMidi.addEvents(feed.blockMidi, done, count, -done);
+
+            juce::AudioBuffer<float> piece(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), done, count);
+            feed.instrument->processBlock(piece, feed.pieceMidi);
+        }
+    }
+}
+
 //==============================================================================
 // EffectsChain Implementation
 //==============================================================================
@@ -217,12 +256,85 @@ void EffectsChain::setWetDryMix(float newWetLevel, float newDryLevel)
 //==============================================================================
 
 MixerBus::MixerBus(const juce::String& identifier, Type type, int channels)
-    : identifier(identifier), busType(type), numChannels(channels)
+    : MixerBus(identifier, type, DSP::ChannelLayout::fromChannelCount(channels))
+{
+}
+
+MixerBus::MixerBus(const juce::String& identifier, Type type, const DSP::ChannelLayout& busLayout)
+    : identifier(identifier), busType(type), layout(busLayout), numChannels(busLayout.getNumChannels())
 {
-    effectsChain = std::make_unique<EffectsChain>(identifier + "_effects", channels);
-    mixBuffer.setSize(channels, 512);
+    effectsChain = std::make_unique<EffectsChain>(identifier + "_effects", numChannels);
+    mixBuffer.setSize(numChannels, 512);
 
-    juce::Logger::writeToLog("Created mixer bus: " + identifier + " (" + juce::String(channels) + " channels)");
+    juce::Logger::writeToLog("Created mixer bus: " + identifier + " (" + layout.getName() + ", " +
+                             juce::String(numChannels) + " channels)");
+}
+
+void MixerBus::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    mixBuffer.setSize(numChannels, samplesPerBlock);
+
+    if (effectsChain)
+        effectsChain->prepareToPlay(sampleRate, samplesPerBlock);
+
+    reset();
+}
+
+void MixerBus::reset()
+{
+    mixBuffer.clear();
+
+    if (effectsChain)
+        effectsChain->reset();
+
+    // Next block starts at the current control values instead of ramping
+    gainsInitialised = false;
+
+    for (int channel = 0; channel < maxMeterChannels; ++channel)
+    {
+        peakLevels[channel].store(0.0f, std::memory_order_relaxed);
+        rmsLevels[channel].store(0.0f, std::memory_order_relaxed);
+    }
+    clippingMask.store(0, std::memory_order_relaxed);
+    programLevel.store(0.0f, std::memory_order_relaxed);
+}
+
+void MixerBus::updateTargetGains(float gainDb, float panValue, bool isMuted)
+{
+    const float linearGain = isMuted ? 0.0f : RoutingUtils::dBToLinear(gainDb);
+
+    for (int channel = 0; channel < maxMeterChannels; ++channel)
+        targetGains[channel] = linearGain;
+
+    if (numChannels >= 2 && layout.isSpeakerLayout())
+    {
+        // Balance every left speaker against every right one; centre-line
+        // speakers and the LFE keep the bus gain
+        auto [leftGain, rightGain] = RoutingUtils::panToStereoGains(panValue);
+
+        for (int channel = 0; channel < std::min(numChannels, maxMeterChannels); ++channel)
+        {
+            const auto& speaker = layout.getSpeaker(channel);
+            if (speaker.isLFE)
+                continue;
+
+            if (speaker.azimuth > 0.0f && speaker.azimuth < 180.0f)
+                targetGains[channel] = linearGain * leftGain;
+            else if (speaker.azimuth < 0.0f && speaker.azimuth > -180.0f)
+                targetGains[channel] = linearGain * rightGain;
+        }
+    }
+    else if (numChannels >= 2 && !layout.isAmbisonic())
+    {
+        // Discrete buses pan their first two channels
+        auto [leftGain, rightGain] = RoutingUtils::panToStereoGains(panValue);
+        targetGains[0] = linearGain * leftGain;
+        targetGains[1] = linearGain * rightGain;
+    }
+
+    lastGainDb = gainDb;
+    lastPan = panValue;
+    lastMuted = isMuted;
 }
 
 void MixerBus::processAudio(juce::AudioBuffer<float>& buffer)
@@ -230,103 +342,154 @@ void MixerBus::processAudio(juce::AudioBuffer<float>& buffer)
     if (buffer.getNumChannels() < numChannels)
         return;
 
-    std::lock_guard<std::mutex> lock(stateMutex);
+    const int numSamples = buffer.getNumSamples();
+
+    // Snapshot the controls once for the whole block
+    const float gainDb = gain.load(std::memory_order_relaxed);
+    const float panValue = pan.load(std::memory_order_relaxed);
+    const bool isMuted = muted.load(std::memory_order_relaxed);
+    const bool isBypassed = bypassed.load(std::memory_order_relaxed);
 
     // Clear mix buffer
     mixBuffer.clear();
 
-    // Apply gain
-    float linearGain = RoutingUtils::dBToLinear(gain);
-    buffer.applyGain(linearGain);
+    // Inserts follow gain and pan; when there are none, the fader pass
+    // meters the bus output directly
+    const bool insertsActive = !isBypassed && effectsChain != nullptr;
 
-    // Apply pan (if stereo)
-    if (numChannels >= 2)
+    if (!gainsInitialised || gainDb != lastGainDb || panValue != lastPan || isMuted != lastMuted)
     {
-        auto [leftGain, rightGain] = RoutingUtils::panToStereoGains(pan);
+        updateTargetGains(gainDb, panValue, isMuted);
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        if (!gainsInitialised)
         {
-            buffer.setSample(0, sample, buffer.getSample(0, sample) * leftGain);
-            buffer.setSample(1, sample, buffer.getSample(1, sample) * rightGain);
+            std::copy(std::begin(targetGains), std::end(targetGains), std::begin(currentGains));
+            gainsInitialised = true;
         }
     }
 
-    // Apply effects if not bypassed
-    if (!bypassed && effectsChain)
+    // Gain, pan and metering in a single pass per channel
+    float peaks[maxMeterChannels] = {};
+    float sumsOfSquares[maxMeterChannels] = {};
+
+    for (int channel = 0; channel < numChannels; ++channel)
     {
-        juce::MidiBuffer emptyMidi;
-        effectsChain->processBlock(buffer, emptyMidi);
+        const int gainIndex = std::min(channel, maxMeterChannels - 1);
+        float peak = 0.0f;
+        float sumOfSquares = 0.0f;
+        RoutingUtils::applyGainRampAndMeasure(buffer.getWritePointer(channel), numSamples,
+                                              currentGains[gainIndex], targetGains[gainIndex],
+                                              peak, sumOfSquares);
+
+        if (channel < maxMeterChannels)
+        {
+            peaks[channel] = peak;
+            sumsOfSquares[channel] = sumOfSquares;
+        }
     }
 
-    // Update monitoring
-    for (int channel = 0; channel < numChannels && channel < 16; ++channel)
+    // Apply effects if not bypassed, then meter what they produced
+    if (insertsActive)
     {
-        float peak = 0.0f;
-        float rms = 0.0f;
+        effectsChain->processBlock(buffer, emptyMidi);
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        for (int channel = 0; channel < std::min(numChannels, (int)maxMeterChannels); ++channel)
         {
-            float sampleValue = std::abs(buffer.getSample(channel, sample));
-            peak = std::max(peak, sampleValue);
-            rms += sampleValue * sampleValue;
+            peaks[channel] = 0.0f;
+            sumsOfSquares[channel] = 0.0f;
+            RoutingUtils::measurePeakAndPower(buffer.getReadPointer(channel), numSamples,
+                                              peaks[channel], sumsOfSquares[channel]);
         }
+    }
+
+    uint32_t clipping = 0;
+    float program = 0.0f;
+
+    for (int channel = 0; channel < std::min(numChannels, (int)maxMeterChannels); ++channel)
+    {
+        const float peak = peaks[channel];
+        const float rms = numSamples > 0 ? std::sqrt(sumsOfSquares[channel] / (float)numSamples) : 0.0f;
 
-        rms = std::sqrt(rms / buffer.getNumSamples());
+        peakLevels[channel].store(peak, std::memory_order_relaxed);
+        rmsLevels[channel].store(rms, std::memory_order_relaxed);
+        program += DSP::LayoutMeter::getChannelWeight(layout, channel) * rms * rms;
 
-        currentState.peakLevel[channel] = peak;
-        currentState.rmsLevel[channel] = rms;
-        currentState.clipping[channel] = peak > 1.0f;
+        if (peak > 1.0f)
+            clipping |= (1u << channel);
     }
+
+    clippingMask.store(clipping, std::memory_order_relaxed);
+    programLevel.store(std::sqrt(program), std::memory_order_relaxed);
+
+    if (numSamples > 0)
+        std::copy(std::begin(targetGains), std::end(targetGains), std::begin(currentGains));
 }
 
 void MixerBus::addInput(const juce::AudioBuffer<float>& input, float inputGain)
 {
-    std::lock_guard<std::mutex> lock(stateMutex);
-
     int channelsToMix = std::min(input.getNumChannels(), mixBuffer.getNumChannels());
     int samplesToMix = std::min(input.getNumSamples(), mixBuffer.getNumSamples());
 
     for (int channel = 0; channel < channelsToMix; ++channel)
     {
-        auto* destData = mixBuffer.getWritePointer(channel);
-        const auto* srcData = input.getReadPointer(channel);
+        mixBuffer.addFrom(channel, 0, input, channel, 0, samplesToMix, inputGain);
+    }
 
-        for (int sample = 0; sample < samplesToMix; ++sample)
-        {
-            destData[sample] += srcData[sample] * inputGain;
-        }
+    activeInputs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MixerBus::addInput(const juce::AudioBuffer<float>& input, float inputGain, const DSP::MixMatrix& matrix)
+{
+    if (matrix.isIdentity())
+    {
+        addInput(input, inputGain);
+        return;
     }
 
-    currentState.activeInputs++;
+    const int samplesToMix = std::min(input.getNumSamples(), mixBuffer.getNumSamples());
+
+    // Channels either side lacks read as silence / are skipped by the kernel
+    const float* inputs[DSP::ChannelLayout::maxChannels] = {};
+    float* outputs[DSP::ChannelLayout::maxChannels] = {};
+
+    for (int channel = 0; channel < std::min(matrix.getNumInputs(), input.getNumChannels()); ++channel)
+        inputs[channel] = input.getReadPointer(channel);
+
+    for (int channel = 0; channel < std::min(matrix.getNumOutputs(), mixBuffer.getNumChannels()); ++channel)
+        outputs[channel] = mixBuffer.getWritePointer(channel);
+
+    matrix.process(inputs, outputs, samplesToMix, true, inputGain);
+
+    activeInputs.fetch_add(1, std::memory_order_relaxed);
 }
 
 void MixerBus::setGain(float gainDb)
 {
-    gain = gainDb;
+    gain.store(gainDb, std::memory_order_relaxed);
     juce::Logger::writeToLog("Bus " + identifier + " gain: " + juce::String(gainDb, 1) + "dB");
 }
 
 void MixerBus::setPan(float panValue)
 {
-    pan = juce::jlimit(-1.0f, 1.0f, panValue);
+    pan.store(juce::jlimit(-1.0f, 1.0f, panValue), std::memory_order_relaxed);
 }
 
 void MixerBus::setMute(bool newMuted)
 {
-    muted = newMuted;
-    juce::Logger::writeToLog("Bus " + identifier + " muted: " + juce::String(muted));
+    muted.store(newMuted, std::memory_order_relaxed);
+    juce::Logger::writeToLog("Bus " + identifier + " muted: " + juce::String(newMuted));
 }
 
 void MixerBus::setSolo(bool newSoloed)
 {
-    soloed = newSoloed;
-    juce::Logger::writeToLog("Bus " + identifier + " soloed: " + juce::String(soloed));
+    soloed.store(newSoloed, std::memory_order_relaxed);
+    juce::Logger::writeToLog("Bus " + identifier + " soloed: " + juce::String(newSoloed));
 }
 
 void MixerBus::setBypass(bool newBypassed)
 {
-    bypassed = newBypassed;
-    juce::Logger::writeToLog("Bus " + identifier + " bypassed: " + juce::String(bypassed));
+    bypassed.store(newBypassed, std::memory_order_relaxed);
+    juce::Logger::writeToLog("Bus " + identifier + " bypassed: " + juce::String(newBypassed));
 }
 
 void MixerBus::addSend(const juce::String& busIdentifier, float sendLevel)
@@ -354,25 +517,41 @@ float MixerBus::getSendLevel(const juce::String& busIdentifier) const
 
 float MixerBus::getPeakLevel(int channel) const
 {
-    if (channel >= 0 && channel < 16)
-        return currentState.peakLevel[channel];
+    if (channel >= 0 && channel < maxMeterChannels)
+        return peakLevels[channel].load(std::memory_order_relaxed);
     return 0.0f;
 }
 
 float MixerBus::getRMSLevel(int channel) const
 {
-    if (channel >= 0 && channel < 16)
-        return currentState.rmsLevel[channel];
+    if (channel >= 0 && channel < maxMeterChannels)
+        return rmsLevels[channel].load(std::memory_order_relaxed);
     return 0.0f;
 }
 
 bool MixerBus::isClipping(int channel) const
 {
-    if (channel >= 0 && channel < 16)
-        return currentState.clipping[channel];
+    if (channel >= 0 && channel < maxMeterChannels)
+        return (clippingMask.load(std::memory_order_relaxed) >> channel) & 1u;
     return false;
 }
 
+MixerBus::BusState MixerBus::getState() const
+{
+    BusState state;
+    const uint32_t clipping = clippingMask.load(std::memory_order_relaxed);
+
+    for (int channel = 0; channel < maxMeterChannels; ++channel)
+    {
+        state.peakLevel[channel] = peakLevels[channel].load(std::memory_order_relaxed);
+        state.rmsLevel[channel] = rmsLevels[channel].load(std::memory_order_relaxed);
+        state.clipping[channel] = (clipping >> channel) & 1u;
+    }
+
+    state.activeInputs = activeInputs.load(std::memory_order_relaxed);
+    return state;
+}
+
 //==============================================================================
 // AudioRoutingEngine Implementation
 //==============================================================================
@@ -418,11 +597,14 @@ bool AudioRoutingEngine::registerInstrument(const juce::String& identifier, std:
     auto format = instrument->getAudioFormat();
     node->numInputChannels = format.numInputChannels;
     node->numOutputChannels = format.numOutputChannels;
+    node->inputLayout = DSP::ChannelLayout::fromChannelCount(format.numInputChannels);
+    node->outputLayout = DSP::ChannelLayout::fromChannelCount(format.numOutputChannels);
     node->sampleRate = format.sampleRate;
     node->blockSize = format.preferredBlockSize;
 
     instrumentNodes[identifier] = instrument;
     nodes[identifier] = std::move(node);
+    addInstrumentTrack(identifier, instrument);
 
     buildProcessingGraph();
 
@@ -448,6 +630,8 @@ bool AudioRoutingEngine::createNode(const juce::String& identifier, AudioNode::T
     node->state = AudioNode::State::Inactive;
     node->numInputChannels = channels;
     node->numOutputChannels = channels;
+    node->inputLayout = DSP::ChannelLayout::fromChannelCount(channels);
+    node->outputLayout = node->inputLayout;
     node->sampleRate = currentSampleRate;
     node->blockSize = currentBlockSize;
 
@@ -458,6 +642,37 @@ bool AudioRoutingEngine::createNode(const juce::String& identifier, AudioNode::T
     return true;
 }
 
+bool AudioRoutingEngine::setNodeLayout(const juce::String& identifier,
+                                       const DSP::ChannelLayout& inputLayout,
+                                       const DSP::ChannelLayout& outputLayout)
+{
+    std::lock_guard<std::mutex> lock(routingMutex);
+
+    auto it = nodes.find(identifier);
+    if (it == nodes.end())
+        return false;
+
+    auto& node = *it->second;
+    node.inputLayout = inputLayout;
+    node.outputLayout = outputLayout;
+    node.numInputChannels = inputLayout.getNumChannels();
+    node.numOutputChannels = outputLayout.getNumChannels();
+
+    for (auto& [routeId, route] : routes)
+    {
+        if (route->sourceNodeId == identifier || route->destinationNodeId == identifier)
+            negotiateRoute(*route);
+    }
+
+    auto track = instrumentTracks.find(identifier);
+    if (track != instrumentTracks.end())
+        renderer.invalidate(track->second);
+
+    juce::Logger::writeToLog("Node " + identifier + " layout: " + inputLayout.getName() +
+                             " in, " + outputLayout.getName() + " out");
+    return true;
+}
+
 bool AudioRoutingEngine::registerEffectNode(const juce::String& identifier, std::unique_ptr<juce::AudioProcessor> processor)
 {
     if (identifier.isEmpty() || !processor)
@@ -479,6 +694,8 @@ bool AudioRoutingEngine::registerEffectNode(const juce::String& identifier, std:
         node->processor->prepareToPlay(currentSampleRate, currentBlockSize);
         node->numInputChannels = node->processor->getTotalNumInputChannels();
         node->numOutputChannels = node->processor->getTotalNumOutputChannels();
+        node->inputLayout = DSP::ChannelLayout::fromChannelCount(node->numInputChannels);
+        node->outputLayout = DSP::ChannelLayout::fromChannelCount(node->numOutputChannels);
     }
 
     nodes[identifier] = std::move(node);
@@ -509,6 +726,9 @@ bool AudioRoutingEngine::removeNode(const juce::String& identifier)
     }
 
     // Remove node
+    removeInstrumentTrack(identifier);
+    instrumentSequences.erase(identifier);
+    liveNodes.erase(identifier);
     nodes.erase(identifier);
     instrumentNodes.erase(identifier);
 
@@ -624,6 +844,7 @@ juce::String AudioRoutingEngine::createRoute(const juce::String& sourceNode, con
     route->destinationNodeId = destNode;
     route->sourceChannel = sourceChannel;
     route->destinationChannel = destChannel;
+    negotiateRoute(*route);
 
     routes[routeId] = std::move(route);
     buildProcessingGraph();
@@ -777,6 +998,27 @@ MixerBus* AudioRoutingEngine::createBus(const juce::String& identifier, MixerBus
     return busPtr;
 }
 
+MixerBus* AudioRoutingEngine::createBus(const juce::String& identifier, MixerBus::Type type,
+                                        const DSP::ChannelLayout& layout)
+{
+    if (identifier.isEmpty())
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(routingMutex);
+
+    if (buses.find(identifier) != buses.end())
+        return nullptr;
+
+    auto bus = std::make_unique<MixerBus>(identifier, type, layout);
+    bus->prepareToPlay(currentSampleRate, currentBlockSize);
+
+    MixerBus* busPtr = bus.get();
+    buses[identifier] = std::move(bus);
+
+    juce::Logger::writeToLog("Created mixer bus: " + identifier + " (" + layout.getName() + ")");
+    return busPtr;
+}
+
 MixerBus* AudioRoutingEngine::getBus(const juce::String& identifier)
 {
     std::lock_guard<std::mutex> lock(routingMutex);
@@ -845,6 +1087,10 @@ void AudioRoutingEngine::prepareToPlay(double sampleRate, int samplesPerBlock)
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
 
+    // Join the workers before taking the graph lock; until prepare() below
+    // the callback renders what they would have
+    renderer.release();
+
     std::lock_guard<std::mutex> lock(routingMutex);
 
     // Prepare all nodes
@@ -867,6 +1113,11 @@ void AudioRoutingEngine::prepareToPlay(double sampleRate, int samplesPerBlock)
     // Prepare master buffer
     masterBuffer.setSize(2, samplesPerBlock);
 
+    // Rings restart empty at the new size, and so does the transport
+    if (anticipativeEnabled)
+        renderer.prepare(sampleRate, samplesPerBlock, anticipativeSettings);
+    nextPlayhead = 0;
+
     // Prepare temporary buffers
     tempBuffers.clear();
     for (int i = 0; i < 16; ++i)
@@ -880,6 +1131,12 @@ void AudioRoutingEngine::prepareToPlay(double sampleRate, int samplesPerBlock)
 }
 
 void AudioRoutingEngine::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlock(buffer, midiMessages, nextPlayhead);
+}
+
+void AudioRoutingEngine::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
+                                      juce::int64 playhead)
 {
     auto startTime = std::chrono::high_resolution_clock::now();
 
@@ -888,8 +1145,18 @@ void AudioRoutingEngine::processBlock(juce::AudioBuffer<float>& buffer, juce::Mi
     // Clear master buffer
     masterBuffer.clear();
 
+    const int numSamples = std::min(buffer.getNumSamples(), masterBuffer.getNumSamples());
+
+    // The transport runs on, wrapping at the loop end
+    nextPlayhead = playhead + buffer.getNumSamples();
+    if (loopEnd > loopStart && playhead < loopEnd && nextPlayhead >= loopEnd)
+        nextPlayhead = loopStart + (nextPlayhead - loopEnd) % (loopEnd - loopStart);
+
     try
     {
+        // Instruments, from the render-ahead rings or rendered now
+        renderInstruments(midiMessages, playhead, numSamples);
+
         // Process audio through the routing graph
         processGraph();
 
@@ -902,7 +1169,7 @@ void AudioRoutingEngine::processBlock(juce::AudioBuffer<float>& buffer, juce::Mi
     }
     catch (const std::exception& e)
     {
-        juce::Logger::writeToLog("Audio routing error: " + juce::String(e.what()));
+        DSP_LOG_ERROR("Audio routing error: %s", e.what());
         buffer.clear();
     }
 
@@ -936,6 +1203,9 @@ void AudioRoutingEngine::reset()
     for (auto& tempBuffer : tempBuffers)
         tempBuffer.clear();
 
+    // Nothing rendered ahead of the reset is valid
+    renderer.invalidateAll();
+
     juce::Logger::writeToLog("Audio routing engine reset");
 }
 
@@ -955,6 +1225,92 @@ std::pair<double, int> AudioRoutingEngine::getAudioConfiguration() const
     return {currentSampleRate, currentBlockSize};
 }
 
+//==============================================================================
+// ANTICIPATIVE PROCESSING
+//==============================================================================
+
+void AudioRoutingEngine::setAnticipativeProcessing(bool enabled, const AnticipativeRenderer::Settings& settings)
+{
+    // Every track renders in the callback while the workers stop, so they
+    // are joined without the graph lock that processBlock() needs
+    {
+        std::lock_guard<std::mutex> lock(routingMutex);
+        anticipativeEnabled = false;
+        anticipativeSettings = settings;
+        updateLiveTracks();
+    }
+
+    renderer.release();
+
+    if (enabled)
+    {
+        std::lock_guard<std::mutex> lock(routingMutex);
+        renderer.prepare(currentSampleRate, currentBlockSize, anticipativeSettings);
+        anticipativeEnabled = true;
+        updateLiveTracks();
+    }
+
+    juce::Logger::writeToLog("Anticipative processing " + juce::String(enabled ? "enabled" : "disabled"));
+}
+
+void AudioRoutingEngine::setNodeLive(const juce::String& identifier, bool live)
+{
+    std::lock_guard<std::mutex> lock(routingMutex);
+
+    if (live)
+        liveNodes.insert(identifier);
+    else
+        liveNodes.erase(identifier);
+
+    updateLiveTracks();
+}
+
+bool AudioRoutingEngine::setNodeSequence(const juce::String& identifier, SequenceFunction sequence)
+{
+    std::lock_guard<std::mutex> lock(routingMutex);
+
+    auto instrument = instrumentNodes.find(identifier);
+    if (instrument == instrumentNodes.end())
+        return false;
+
+    if (sequence)
+        instrumentSequences[identifier] = std::move(sequence);
+    else
+        instrumentSequences.erase(identifier);
+
+    // A fresh track, so nothing rendered from the old material plays
+    addInstrumentTrack(identifier, instrument->second);
+    updateLiveTracks();
+    return true;
+}
+
+bool AudioRoutingEngine::isNodeLive(const juce::String& identifier) const
+{
+    std::lock_guard<std::mutex> lock(routingMutex);
+
+    // Only instruments render ahead; every other node runs in the callback
+    auto track = instrumentTracks.find(identifier);
+    return track == instrumentTracks.end() || renderer.isLive(track->second);
+}
+
+void AudioRoutingEngine::invalidateNode(const juce::String& identifier)
+{
+    std::lock_guard<std::mutex> lock(routingMutex);
+
+    auto track = instrumentTracks.find(identifier);
+    if (track != instrumentTracks.end())
+        renderer.invalidate(track->second);
+}
+
+void AudioRoutingEngine::setLoop(juce::int64 start, juce::int64 end)
+{
+    std::lock_guard<std::mutex> lock(routingMutex);
+
+    loopStart = end > start ? start : 0;
+    loopEnd = end > start ? end : 0;
+    renderer.setLoop(loopStart, loopEnd);
+}
+
 //==============================================================================
 // MONITORING AND DIAGNOSTICS
 //==============================================================================
@@ -1030,6 +1386,9 @@ juce::String AudioRoutingEngine::getDiagnosticInfo() const
     info += "Memory Usage: " + juce::String((int)stats.memoryUsage) + " bytes\n";
     info += "Clipping Detections: " + juce::String(stats.clippingDetections) + "\n";
     info += "Realtime Routing: " + juce::String(realtimeRoutingEnabled ? "Enabled" : "Disabled") + "\n";
+    info += "Anticipative Processing: " + juce::String(anticipativeEnabled ? "Enabled" : "Disabled") + "\n";
+    if (anticipativeEnabled)
+        info += "Render-Ahead Underruns: " + juce::String((int)renderer.getNumUnderruns()) + "\n";
 
     return info;
 }
@@ -1237,6 +1596,12 @@ void AudioRoutingEngine::mixOutputs(juce::AudioBuffer<float>& finalOutput)
 
     finalOutput.clear();
 
+    // Instruments rendered this block
+    const int numSamples = std::min(finalOutput.getNumSamples(), masterBuffer.getNumSamples());
+    const int numChannels = std::min(finalOutput.getNumChannels(), masterBuffer.getNumChannels());
+    for (int channel = 0; channel < numChannels; ++channel)
+        finalOutput.addFrom(channel, 0, masterBuffer, channel, 0, numSamples);
+
     // Mix from master bus
     if (masterBus)
     {
@@ -1275,6 +1640,38 @@ void AudioRoutingEngine::validateRoute(const AudioRoute& route)
         return;
 }
 
+void AudioRoutingEngine::negotiateRoute(AudioRoute& route)
+{
+    auto source = nodes.find(route.sourceNodeId);
+    auto destination = nodes.find(route.destinationNodeId);
+    if (source == nodes.end() || destination == nodes.end())
+        return;
+
+    const auto& sourceLayout = source->second->outputLayout;
+    const auto& destinationLayout = destination->second->inputLayout;
+
+    if (route.sourceChannel < 0 && route.destinationChannel < 0)
+    {
+        route.matrix = DSP::MixMatrix::negotiate(sourceLayout, destinationLayout);
+        return;
+    }
+
+    // Channel routes patch one channel (or all of one side) directly
+    route.matrix = DSP::MixMatrix(sourceLayout.getNumChannels(), destinationLayout.getNumChannels());
+
+    for (int input = 0; input < route.matrix.getNumInputs(); ++input)
+    {
+        if (route.sourceChannel >= 0 && input != route.sourceChannel)
+            continue;
+
+        for (int output = 0; output < route.matrix.getNumOutputs(); ++output)
+        {
+            if (route.destinationChannel >= 0 ? output == route.destinationChannel : output == input)
+                route.matrix.setGain(input, output, 1.0f);
+        }
+    }
+}
+
 void AudioRoutingEngine::updateNodeStates()
 {
     for (const auto& [id, node] : nodes)
@@ -1359,6 +1756,87 @@ void AudioRoutingEngine::buildProcessingGraph()
             visit(node.get());
         }
     }
+
+    // Routes changed: instruments fed from an input node render in the callback
+    updateLiveTracks();
+}
+
+void AudioRoutingEngine::addInstrumentTrack(const juce::String& identifier,
+                                            std::shared_ptr<InstrumentInstance> instrument)
+{
+    removeInstrumentTrack(identifier);
+
+    const auto& node = *nodes.at(identifier);
+    const int numChannels = juce::jlimit(1, AnticipativeRenderer::maxChannels, node.numOutputChannels);
+
+    auto feed = std::make_shared<InstrumentFeed>();
+    feed->instrument = instrument;
+    feed->pieceSize = node.blockSize;
+    feed->blockMidi.ensureSize(4096);
+    feed->pieceMidi.ensureSize(4096);
+
+    auto sequence = instrumentSequences.find(identifier);
+    if (sequence != instrumentSequences.end())
+        feed->sequence = sequence->second;
+
+    // An instrument cannot be rewound: when what was rendered ahead is
+    // dropped, its voices are stopped before it renders from the new position
+    const auto track = renderer.addTrack(numChannels,
+        [feed](juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi, juce::int64 startSample)
+        {
+            renderFeed(*feed, buffer, midi, startSample);
+        },
+        [instrument](juce::int64)
+        {
+            instrument->allNotesOff();
+        });
+
+    if (track != AnticipativeRenderer::invalidTrack)
+        instrumentTracks[identifier] = track;
+}
+
+void AudioRoutingEngine::removeInstrumentTrack(const juce::String& identifier)
+{
+    auto track = instrumentTracks.find(identifier);
+    if (track == instrumentTracks.end())
+        return;
+
+    renderer.removeTrack(track->second);
+    instrumentTracks.erase(track);
+}
+
+void AudioRoutingEngine::updateLiveTracks()
+{
+    for (const auto& [identifier, track] : instrumentTracks)
+    {
+        // Only a sequence can be rendered ahead; an instrument without one
+        // plays the callback's MIDI as it arrives
+        bool live = !anticipativeEnabled
+                 || liveNodes.count(identifier) > 0
+                 || instrumentSequences.count(identifier) == 0;
+
+        for (const auto& [routeId, route] : routes)
+        {
+            if (live)
+                break;
+
+            if (route->enabled && route->destinationNodeId == identifier)
+            {
+                auto source = nodes.find(route->sourceNodeId);
+                live = source != nodes.end() && source->second->type == AudioNode::Type::Input;
+            }
+        }
+
+        renderer.setLive(track, live);
+    }
+}
+
+void AudioRoutingEngine::renderInstruments(juce::MidiBuffer& midiMessages, juce::int64 playhead, int numSamples)
+{
+    // Live tracks (all of them with anticipative processing off) render
+    // here with the callback's MIDI; the rest play from their rings
+    for (const auto& [identifier, track] : instrumentTracks)
+        renderer.process(track, masterBuffer, playhead, numSamples, midiMessages);
 }
 
 void AudioRoutingEngine::processGraph()
@@ -1409,6 +1887,98 @@ float dBToLinear(float dB)
     return std::pow(10.0f, dB / 20.0f);
 }
 
+void measurePeakAndPower(const float* data, int numSamples, float& peak, float& sumOfSquares) noexcept
+{
+    constexpr int lanes = 4;
+
+    float lanePeak[lanes] = {};
+    float laneSum[lanes] = {};
+
+    const int vectorSamples = std::max(0, numSamples - (numSamples % lanes));
+
+    for (int i = 0; i < vectorSamples; i += lanes)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const float value = data[i + lane];
+            lanePeak[lane] = std::max(lanePeak[lane], std::abs(value));
+            laneSum[lane] += value * value;
+        }
+    }
+
+    for (int i = vectorSamples; i < numSamples; ++i)
+    {
+        lanePeak[0] = std::max(lanePeak[0], std::abs(data[i]));
+        laneSum[0] += data[i] * data[i];
+    }
+
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        peak = std::max(peak, lanePeak[lane]);
+        sumOfSquares += laneSum[lane];
+    }
+}
+
+void applyGainRampAndMeasure(float* data, int numSamples, float startGain, float endGain,
+                             float& peak, float& sumOfSquares) noexcept
+{
+    constexpr int lanes = 4;
+
+    // Independent per-lane accumulators keep the loop free of serial
+    // dependencies so the compiler can vectorise it
+    float lanePeak[lanes] = {};
+    float laneSum[lanes] = {};
+
+    if (numSamples <= 0)
+        return;
+
+    const float step = (endGain - startGain) / (float)numSamples;
+    const int vectorSamples = numSamples - (numSamples % lanes);
+
+    if (step == 0.0f)
+    {
+        for (int i = 0; i < vectorSamples; i += lanes)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                const float value = data[i + lane] * startGain;
+                data[i + lane] = value;
+                lanePeak[lane] = std::max(lanePeak[lane], std::abs(value));
+                laneSum[lane] += value * value;
+            }
+        }
+    }
+    else
+    {
+        // Sample i gets startGain + (i + 1) * step, so the block ends exactly
+        // on endGain and the next block continues from there
+        for (int i = 0; i < vectorSamples; i += lanes)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                const float value = data[i + lane] * (startGain + (float)(i + lane + 1) * step);
+                data[i + lane] = value;
+                lanePeak[lane] = std::max(lanePeak[lane], std::abs(value));
+                laneSum[lane] += value * value;
+            }
+        }
+    }
+
+    for (int i = vectorSamples; i < numSamples; ++i)
+    {
+        const float value = data[i] * (startGain + (float)(i + 1) * step);
+        data[i] = value;
+        lanePeak[0] = std::max(lanePeak[0], std::abs(value));
+        laneSum[0] += value * value;
+    }
+
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        peak = std::max(peak, lanePeak[lane]);
+        sumOfSquares += laneSum[lane];
+    }
+}
+
 float linearToDB(float gain)
 {
     return 20.0f * std::log10(std::max(gain, 1e-6f));
@@ -3,9 +3,13 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include "dsp/ChannelLayout.h"
+#include "AnticipativeRenderer.h"
+#include <functional>
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <atomic>
 #include <mutex>
 
@@ -53,6 +57,8 @@ struct AudioNode
     State state = State::Inactive;  // Current state
     int numInputChannels = 2;      // Input channels
     int numOutputChannels = 2;     // Output channels
+    DSP::ChannelLayout inputLayout;   // Input format (numInputChannels wide)
+    DSP::ChannelLayout outputLayout;  // Output format (numOutputChannels wide)
     double sampleRate = 44100.0;   // Sample rate
     int blockSize = 512;           // Buffer size
 
@@ -92,6 +98,10 @@ struct AudioRoute
     bool phaseInvert = false;            // Phase inversion
     bool monoToStereo = false;           // Mono to stereo conversion
 
+    // Source output layout into destination input layout, negotiated when
+    // the route is created and whenever either node changes format
+    DSP::MixMatrix matrix;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioRoute)
 };
 
@@ -184,10 +194,17 @@ private:
 
 /**
  * @brief Mixer bus for grouping channels
+ *
+ * Controls (gain, pan, mute, solo, bypass) are atomics written from any
+ * thread; processAudio() snapshots them once per block without locking.
+ * Gain and pan changes are applied as per-block linear ramps, and peak/RMS
+ * meters are computed in the same pass and published through atomics.
  */
 class MixerBus
 {
 public:
+    static constexpr int maxMeterChannels = 16;
+
     enum class Type
     {
         Audio,          // Audio bus
@@ -197,7 +214,9 @@ public:
         Monitor         // Monitor bus
     };
 
+    /** Channel count picks the usual layout (6 = 5.1, 12 = 7.1.4, ...) */
     MixerBus(const juce::String& identifier, Type type = Type::Audio, int channels = 2);
+    MixerBus(const juce::String& identifier, Type type, const DSP::ChannelLayout& layout);
     ~MixerBus() = default;
 
     /**
@@ -206,30 +225,40 @@ public:
     const juce::String& getIdentifier() const { return identifier; }
     Type getType() const { return busType; }
     int getNumChannels() const { return numChannels; }
+    const DSP::ChannelLayout& getLayout() const { return layout; }
 
     /**
-     * Audio processing
+     * Audio processing (audio thread)
      */
+    void prepareToPlay(double sampleRate, int samplesPerBlock);
+    void reset();
     void processAudio(juce::AudioBuffer<float>& buffer);
     void addInput(const juce::AudioBuffer<float>& input, float gain = 1.0f);
 
+    /** Mix an input in another layout through its negotiated matrix */
+    void addInput(const juce::AudioBuffer<float>& input, float gain, const DSP::MixMatrix& matrix);
+
     /**
      * Bus controls
      */
     void setGain(float gainDb);
-    float getGain() const { return gain; }
+    float getGain() const { return gain.load(std::memory_order_relaxed); }
 
-    void setPan(float panValue); // -1.0 to 1.0
-    float getPan() const { return pan; }
+    /**
+     * -1.0 to 1.0. Balances left against right speakers on surround
+     * layouts (centre, LFE and Ambisonic buses are not panned).
+     */
+    void setPan(float panValue);
+    float getPan() const { return pan.load(std::memory_order_relaxed); }
 
     void setMute(bool muted);
-    bool isMuted() const { return muted; }
+    bool isMuted() const { return muted.load(std::memory_order_relaxed); }
 
     void setSolo(bool soloed);
-    bool isSoloed() const { return soloed; }
+    bool isSoloed() const { return soloed.load(std::memory_order_relaxed); }
 
     void setBypass(bool bypassed);
-    bool isBypassed() const { return bypassed; }
+    bool isBypassed() const { return bypassed.load(std::memory_order_relaxed); }
 
     /**
      * Bus effects
@@ -245,42 +274,64 @@ public:
     float getSendLevel(const juce::String& busIdentifier) const;
 
     /**
-     * Bus monitoring
+     * Bus monitoring (lock-free, any thread; updated once per block)
      */
     float getPeakLevel(int channel = 0) const;
     float getRMSLevel(int channel = 0) const;
     bool isClipping(int channel = 0) const;
 
+    /** BS.1770 channel-weighted RMS of the whole bus, linear */
+    float getProgramLevel() const { return programLevel.load(std::memory_order_relaxed); }
+
     /**
      * Bus state
      */
     struct BusState
     {
-        float peakLevel[16] = {0.0f};  // Peak levels per channel
-        float rmsLevel[16] = {0.0f};   // RMS levels per channel
-        bool clipping[16] = {false};   // Clipping detection
+        float peakLevel[maxMeterChannels] = {0.0f};  // Peak levels per channel
+        float rmsLevel[maxMeterChannels] = {0.0f};   // RMS levels per channel
+        bool clipping[maxMeterChannels] = {false};   // Clipping detection
         double cpuUsage = 0.0;         // CPU usage
         int activeInputs = 0;           // Number of active inputs
     };
 
-    BusState getState() const { return currentState; }
+    BusState getState() const;
 
 private:
+    /** Per-channel linear gains the block ramps towards */
+    void updateTargetGains(float gainDb, float panValue, bool isMuted);
+
     juce::String identifier;
     Type busType;
+    DSP::ChannelLayout layout;
     int numChannels;
-    float gain = 0.0f;         // dB
-    float pan = 0.0f;           // -1.0 to 1.0
-    bool muted = false;
-    bool soloed = false;
-    bool bypassed = false;
+    std::atomic<float> gain { 0.0f };    // dB
+    std::atomic<float> pan { 0.0f };     // -1.0 to 1.0
+    std::atomic<bool> muted { false };
+    std::atomic<bool> soloed { false };
+    std::atomic<bool> bypassed { false };
 
     std::unique_ptr<EffectsChain> effectsChain;
     std::unordered_map<juce::String, float> sends;
 
     juce::AudioBuffer<float> mixBuffer;
-    BusState currentState;
-    mutable std::mutex stateMutex;
+    juce::MidiBuffer emptyMidi;
+
+    // Audio-thread ramp state. Targets are only recomputed when the control
+    // snapshot changes, so a static fader costs no transcendental math.
+    float currentGains[maxMeterChannels] = {};
+    float targetGains[maxMeterChannels] = {};
+    float lastGainDb = 0.0f;
+    float lastPan = 0.0f;
+    bool lastMuted = false;
+    bool gainsInitialised = false;
+
+    // Published meters
+    std::atomic<float> peakLevels[maxMeterChannels] = {};
+    std::atomic<float> rmsLevels[maxMeterChannels] = {};
+    std::atomic<uint32_t> clippingMask { 0 };
+    std::atomic<float> programLevel { 0.0f };
+    std::atomic<int> activeInputs { 0 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerBus)
 };
@@ -308,6 +359,14 @@ public:
      */
     bool createNode(const juce::String& identifier, AudioNode::Type type, int channels = 2);
 
+    /**
+     * Change a node's formats; every route into or out of the node is
+     * renegotiated (upmix, fold-down or Ambisonic encode/decode matrix)
+     */
+    bool setNodeLayout(const juce::String& identifier,
+                       const DSP::ChannelLayout& inputLayout,
+                       const DSP::ChannelLayout& outputLayout);
+
     /**
      * Register an existing audio processor as a node
      */
@@ -383,6 +442,7 @@ public:
      * Create mixer bus
      */
     MixerBus* createBus(const juce::String& identifier, MixerBus::Type type = MixerBus::Type::Audio, int channels = 2);
+    MixerBus* createBus(const juce::String& identifier, MixerBus::Type type, const DSP::ChannelLayout& layout);
 
     /**
      * Get bus by identifier
@@ -412,9 +472,18 @@ public:
 
     /**
      * Process audio through entire routing system
+     *
+     * The transport is assumed to run on from the previous block; hosts
+     * that seek or loop pass the playhead instead.
      */
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
 
+    /**
+     * Process with the transport position of the block's first sample.
+     * Callback MIDI goes to live nodes only.
+     */
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, juce::int64 playhead);
+
     /**
      * Reset all audio processing
      */
@@ -449,6 +518,58 @@ public:
      */
     void setMaxChannelsPerNode(int maxChannels) { maxChannelsPerNode = maxChannels; }
 
+    //==============================================================================
+    // ANTICIPATIVE PROCESSING
+    //==============================================================================
+
+    /**
+     * Render instruments that play sequenced material (setNodeSequence())
+     * ahead of the playhead on worker threads (see AnticipativeRenderer).
+     * Instruments that play the callback's MIDI, are fed from an input
+     * node or are set live keep rendering in the callback, as every
+     * instrument does with this off. The workers are stopped without
+     * holding up processBlock().
+     */
+    void setAnticipativeProcessing(bool enabled,
+                                   const AnticipativeRenderer::Settings& settings = AnticipativeRenderer::Settings());
+    bool isAnticipativeProcessingEnabled() const { return anticipativeEnabled; }
+
+    /**
+     * Sequenced material for an instrument: adds to midi the events in
+     * [startSample, startSample + numSamples) of the timeline, relative to
+     * startSample. It may be asked for any position, ahead of the playhead,
+     * on a worker thread, so it must depend on the position only.
+     */
+    using SequenceFunction = std::function<void(juce::MidiBuffer& midi, juce::int64 startSample, int numSamples)>;
+
+    /**
+     * Play an instrument from a sequence, which lets it render ahead; an
+     * empty function puts it back on the callback's MIDI
+     * @return false if there is no such instrument
+     */
+    bool setNodeSequence(const juce::String& identifier, SequenceFunction sequence);
+
+    /**
+     * Force a node to render in the callback (armed for live MIDI, say);
+     * nodes fed from an input node are live regardless
+     */
+    void setNodeLive(const juce::String& identifier, bool live);
+    bool isNodeLive(const juce::String& identifier) const;
+
+    /**
+     * A node's sound changed (parameters, program): drop what was rendered
+     * ahead for it
+     */
+    void invalidateNode(const juce::String& identifier);
+
+    /**
+     * Transport loop, so that rendering ahead carries on across the wrap;
+     * end <= start clears it
+     */
+    void setLoop(juce::int64 start, juce::int64 end);
+
+    const AnticipativeRenderer& getAnticipativeRenderer() const { return renderer; }
+
     //==============================================================================
     // MONITORING AND DIAGNOSTICS
     //==============================================================================
@@ -508,6 +629,7 @@ private:
     void mixOutputs(juce::AudioBuffer<float>& finalOutput);
 
     void validateRoute(const AudioRoute& route);
+    void negotiateRoute(AudioRoute& route);
     void updateNodeStates();
     void updateBusStates();
 
@@ -525,6 +647,12 @@ private:
     void buildProcessingGraph();
     void processGraph();
 
+    // Anticipative processing
+    void addInstrumentTrack(const juce::String& identifier, std::shared_ptr<InstrumentInstance> instrument);
+    void removeInstrumentTrack(const juce::String& identifier);
+    void updateLiveTracks();
+    void renderInstruments(juce::MidiBuffer& midiMessages, juce::int64 playhead, int numSamples);
+
     //==============================================================================
     // MEMBER VARIABLES
     //==============================================================================
@@ -554,6 +682,17 @@ private:
     std::vector<juce::AudioBuffer<float>> tempBuffers;
     juce::AudioBuffer<float> masterBuffer;
 
+    // Anticipative processing: a renderer track per instrument node
+    AnticipativeRenderer renderer;
+    AnticipativeRenderer::Settings anticipativeSettings;
+    bool anticipativeEnabled = false;
+    std::unordered_map<juce::String, AnticipativeRenderer::TrackId> instrumentTracks;
+    std::unordered_map<juce::String, SequenceFunction> instrumentSequences;
+    std::unordered_set<juce::String> liveNodes;      // Set live by setNodeLive()
+    juce::int64 nextPlayhead = 0;                     // Where the next block starts
+    juce::int64 loopStart = 0;
+    juce::int64 loopEnd = 0;
+
     // Statistics and monitoring
     mutable EngineStats cachedStats;
     mutable juce::Time lastStatsUpdate;
@@ -577,6 +716,20 @@ namespace RoutingUtils
      */
     float dBToLinear(float dB);
 
+    /**
+     * Bus kernel: multiply by a linear gain ramp (startGain at the first
+     * sample, reaching endGain after the last) and accumulate the peak and
+     * sum of squares of the result in the same pass
+     */
+    void applyGainRampAndMeasure(float* data, int numSamples, float startGain, float endGain,
+                                 float& peak, float& sumOfSquares) noexcept;
+
+    /**
+     * Accumulate the peak and sum of squares of a block (metering after
+     * inserts)
+     */
+    void measurePeakAndPower(const float* data, int numSamples, float& peak, float& sumOfSquares) noexcept;
+
     /**
      * Convert linear gain to dB
      */
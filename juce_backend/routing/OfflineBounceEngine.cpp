@@ -0,0 +1,394 @@
+#include "OfflineBounceEngine.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace SchillingerEcosystem::Routing {
+
+//==============================================================================
+// GRAPH
+//==============================================================================
+
+OfflineBounceEngine::NodeId OfflineBounceEngine::addNode(const juce::String& name, int numChannels, bool isBus,
+                                                         RenderFunction render, PrepareFunction prepare)
+{
+    if (numChannels <= 0)
+        return invalidNode;
+
+    auto node = std::make_unique<Node>();
+    node->name = name;
+    node->numChannels = numChannels;
+    node->isBus = isBus;
+    node->render = std::move(render);
+    node->prepare = std::move(prepare);
+
+    nodes.push_back(std::move(node));
+    return static_cast<NodeId>(nodes.size()) - 1;
+}
+
+OfflineBounceEngine::NodeId OfflineBounceEngine::addTrack(const juce::String& name, int numChannels,
+                                                          RenderFunction render, PrepareFunction prepare)
+{
+    if (!render)
+        return invalidNode;
+
+    return addNode(name, numChannels, false, std::move(render), std::move(prepare));
+}
+
+OfflineBounceEngine::NodeId OfflineBounceEngine::addBus(const juce::String& name, int numChannels,
+                                                        RenderFunction process, PrepareFunction prepare)
+{
+    return addNode(name, numChannels, true, std::move(process), std::move(prepare));
+}
+
+OfflineBounceEngine::NodeId OfflineBounceEngine::addProcessor(const juce::String& name, juce::AudioProcessor& processor,
+                                                              int numChannels, bool isBus)
+{
+    auto* target = &processor;
+
+    auto render = [target](juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi, juce::int64)
+    {
+        target->processBlock(buffer, midi);
+    };
+
+    auto prepare = [target, numChannels](double sampleRate, int blockSize)
+    {
+        target->setNonRealtime(true);
+        target->setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        target->prepareToPlay(sampleRate, blockSize);
+    };
+
+    return addNode(name, numChannels, isBus, std::move(render), std::move(prepare));
+}
+
+bool OfflineBounceEngine::connect(NodeId source, NodeId destination, float gain)
+{
+    const auto numNodes = getNumNodes();
+    if (source < 0 || source >= numNodes || destination < 0 || destination >= numNodes || source == destination)
+        return false;
+
+    auto& target = *nodes[static_cast<size_t>(destination)];
+    if (!target.isBus)
+        return false;   // Tracks generate; only buses take inputs
+
+    // Keep the graph acyclic so every bounce can be scheduled
+    if (hasPath(destination, source))
+        return false;
+
+    target.inputs.push_back({ source, gain });
+    nodes[static_cast<size_t>(source)]->consumers.push_back(destination);
+    return true;
+}
+
+bool OfflineBounceEngine::hasPath(NodeId from, NodeId to) const
+{
+    std::vector<NodeId> pending { from };
+    std::vector<bool> seen(nodes.size(), false);
+
+    while (!pending.empty())
+    {
+        const auto current = pending.back();
+        pending.pop_back();
+
+        if (current == to)
+            return true;
+
+        if (seen[static_cast<size_t>(current)])
+            continue;
+
+        seen[static_cast<size_t>(current)] = true;
+        for (auto consumer : nodes[static_cast<size_t>(current)]->consumers)
+            pending.push_back(consumer);
+    }
+
+    return false;
+}
+
+bool OfflineBounceEngine::addOutput(NodeId node, OutputFunction output)
+{
+    if (node < 0 || node >= getNumNodes() || !output)
+        return false;
+
+    nodes[static_cast<size_t>(node)]->outputs.push_back(std::move(output));
+    return true;
+}
+
+OfflineBounceEngine::OutputFunction OfflineBounceEngine::writeTo(juce::AudioFormatWriter& writer)
+{
+    return [&writer](const juce::AudioBuffer<float>& block, juce::int64)
+    {
+        writer.writeFromAudioSampleBuffer(block, 0, block.getNumSamples());
+    };
+}
+
+void OfflineBounceEngine::clear()
+{
+    nodes.clear();
+    progress.store(0.0);
+}
+
+//==============================================================================
+// RENDERING
+//==============================================================================
+
+/**
+ * Hands out (node, block) tasks. A node's next block is ready once every
+ * input has finished that block and every consumer has finished the block
+ * that last used the slot it is about to overwrite. The ready task with the
+ * lowest block wins (ties: lowest node id), which keeps the pipeline
+ * draining towards the outputs; the order affects timing only, never the
+ * samples.
+ */
+class OfflineBounceEngine::Scheduler
+{
+public:
+    Scheduler(std::vector<std::unique_ptr<Node>>& graphNodes, int totalBlocks, int slotsPerNode)
+        : nodes(graphNodes), numBlocks(totalBlocks), numSlots(slotsPerNode),
+          remaining(static_cast<juce::int64>(graphNodes.size()) * totalBlocks)
+    {
+    }
+
+    /** Called with the lock held */
+    Node* takeReadyTask()
+    {
+        Node* best = nullptr;
+
+        for (auto& candidate : nodes)
+        {
+            auto& node = *candidate;
+            if (node.running || node.nextBlock >= numBlocks)
+                continue;
+
+            if (best != nullptr && best->nextBlock <= node.nextBlock)
+                continue;
+
+            if (isReady(node))
+                best = &node;
+        }
+
+        if (best != nullptr)
+            best->running = true;
+
+        return best;
+    }
+
+    /** Called with the lock held */
+    void finishTask(Node& node)
+    {
+        node.running = false;
+        ++node.nextBlock;
+        ++node.completedBlocks;
+        --remaining;
+    }
+
+    bool isFinished() const { return remaining == 0; }
+    double getProgress(juce::int64 totalTasks) const
+    {
+        return totalTasks > 0 ? 1.0 - static_cast<double>(remaining) / static_cast<double>(totalTasks) : 1.0;
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool aborted = false;
+    juce::String error;
+
+private:
+    bool isReady(const Node& node) const
+    {
+        const int block = node.nextBlock;
+
+        for (const auto& input : node.inputs)
+        {
+            if (nodes[static_cast<size_t>(input.source)]->completedBlocks <= block)
+                return false;
+        }
+
+        // The slot for this block last held block - numSlots
+        for (auto consumer : node.consumers)
+        {
+            if (nodes[static_cast<size_t>(consumer)]->completedBlocks < block - numSlots + 1)
+                return false;
+        }
+
+        return true;
+    }
+
+    std::vector<std::unique_ptr<Node>>& nodes;
+    const int numBlocks;
+    const int numSlots;
+    juce::int64 remaining;
+};
+
+OfflineBounceEngine::Result OfflineBounceEngine::render(const Settings& settings)
+{
+    Result result;
+
+    if (nodes.empty() || settings.lengthInSamples <= 0 || settings.blockSize <= 0 || settings.sampleRate <= 0.0)
+    {
+        result.error = "Nothing to render";
+        return result;
+    }
+
+    const auto blockSize = settings.blockSize;
+    const auto length = settings.lengthInSamples;
+    const auto numBlocks = static_cast<int>((length + blockSize - 1) / blockSize);
+    const auto numSlots = std::max(1, settings.blocksInFlight);
+    const auto totalTasks = static_cast<juce::int64>(nodes.size()) * numBlocks;
+
+    for (auto& node : nodes)
+    {
+        if (node->prepare)
+            node->prepare(settings.sampleRate, blockSize);
+
+        node->slots.resize(static_cast<size_t>(numSlots));
+        for (auto& slot : node->slots)
+            slot.setSize(node->numChannels, blockSize);
+
+        node->nextBlock = 0;
+        node->completedBlocks = 0;
+        node->running = false;
+    }
+
+    cancelRequested.store(false);
+    progress.store(0.0);
+
+    Scheduler scheduler(nodes, numBlocks, numSlots);
+
+    auto renderTask = [&](Node& node, int block, juce::MidiBuffer& midi)
+    {
+        const auto startSample = static_cast<juce::int64>(block) * blockSize;
+        const auto numSamples = static_cast<int>(std::min<juce::int64>(blockSize, length - startSample));
+        auto& slot = node.slots[static_cast<size_t>(block % numSlots)];
+
+        // View of the slot at this block's length; no allocation
+        juce::AudioBuffer<float> buffer(slot.getArrayOfWritePointers(), node.numChannels, numSamples);
+        buffer.clear();
+
+        // Fixed connection order keeps the sums identical run to run
+        for (const auto& input : node.inputs)
+        {
+            const auto& source = *nodes[static_cast<size_t>(input.source)];
+            const auto& sourceSlot = source.slots[static_cast<size_t>(block % numSlots)];
+
+            for (int channel = 0; channel < node.numChannels; ++channel)
+            {
+                const int sourceChannel = source.numChannels == 1 ? 0 : channel;
+                if (sourceChannel >= source.numChannels)
+                    continue;
+
+                juce::FloatVectorOperations::addWithMultiply(buffer.getWritePointer(channel),
+                                                             sourceSlot.getReadPointer(sourceChannel),
+                                                             input.gain, numSamples);
+            }
+        }
+
+        midi.clear();
+        if (node.render)
+            node.render(buffer, midi, startSample);
+
+        for (auto& output : node.outputs)
+            output(buffer, startSample);
+    };
+
+    auto worker = [&]
+    {
+        // Same floating-point mode on every thread, or output would depend on placement
+        juce::ScopedNoDenormals noDenormals;
+        juce::MidiBuffer midi;
+
+        std::unique_lock<std::mutex> lock(scheduler.mutex);
+
+        while (!scheduler.isFinished() && !scheduler.aborted)
+        {
+            if (cancelRequested.load())
+            {
+                scheduler.aborted = true;
+                scheduler.error = "Cancelled";
+                break;
+            }
+
+            auto* node = scheduler.takeReadyTask();
+            if (node == nullptr)
+            {
+                scheduler.wake.wait_for(lock, std::chrono::milliseconds(50));
+                continue;
+            }
+
+            const int block = node->nextBlock;
+            lock.unlock();
+
+            juce::String failure;
+            try
+            {
+                renderTask(*node, block, midi);
+            }
+            catch (const std::exception& e)
+            {
+                failure = node->name + ": " + e.what();
+            }
+            catch (...)
+            {
+                failure = node->name + ": unknown exception";
+            }
+
+            lock.lock();
+            scheduler.finishTask(*node);
+
+            if (failure.isNotEmpty() && !scheduler.aborted)
+            {
+                scheduler.aborted = true;
+                scheduler.error = failure;
+            }
+
+            progress.store(scheduler.getProgress(totalTasks));
+            scheduler.wake.notify_all();
+        }
+
+        scheduler.wake.notify_all();
+    };
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int numThreads = std::clamp(settings.numThreads > 0 ? settings.numThreads : hardwareThreads, 1,
+                                      static_cast<int>(std::min<juce::int64>(totalTasks, 256)));
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < numThreads; ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (auto& thread : workers)
+        thread.join();
+
+    const auto endTime = std::chrono::steady_clock::now();
+
+    for (auto& node : nodes)
+        node->slots.clear();
+
+    result.renderSeconds = std::chrono::duration<double>(endTime - startTime).count();
+    result.completed = scheduler.isFinished() && !scheduler.aborted;
+    result.error = scheduler.error;
+
+    // Every node renders the full length, so samples rendered is the shortest node timeline
+    int blocksDone = numBlocks;
+    for (const auto& node : nodes)
+        blocksDone = std::min(blocksDone, node->completedBlocks);
+
+    result.samplesRendered = std::min<juce::int64>(static_cast<juce::int64>(blocksDone) * blockSize, length);
+    if (result.renderSeconds > 0.0)
+        result.realtimeFactor = static_cast<double>(result.samplesRendered) / settings.sampleRate / result.renderSeconds;
+
+    juce::Logger::writeToLog("Offline bounce " + juce::String(result.completed ? "finished" : "stopped") + ": "
+                             + juce::String(result.samplesRendered) + " samples, "
+                             + juce::String(numThreads) + " threads, "
+                             + juce::String(result.realtimeFactor, 1) + "x realtime");
+
+    return result;
+}
+
+} // namespace SchillingerEcosystem::Routing
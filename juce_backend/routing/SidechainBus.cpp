@@ -0,0 +1,401 @@
+#include "SidechainBus.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace SchillingerEcosystem::Routing {
+
+using schill::dynamics::SlidingWindowDetector;
+
+//==============================================================================
+// DETECTOR SETTINGS
+//==============================================================================
+
+bool SidechainBus::DetectorSpec::operator== (const DetectorSpec& other) const noexcept
+{
+    return mode == other.mode && windowMs == other.windowMs
+        && truePeak == other.truePeak && highPassHz == other.highPassHz;
+}
+
+SidechainBus::DetectorSpec SidechainBus::DetectorSpec::peak(float highPassHz)
+{
+    return { SlidingWindowDetector::Mode::Peak, 1.0f, false, highPassHz };
+}
+
+SidechainBus::DetectorSpec SidechainBus::DetectorSpec::rms(float highPassHz)
+{
+    return { SlidingWindowDetector::Mode::RMS, 10.0f, false, highPassHz };
+}
+
+SidechainBus::DetectorSpec SidechainBus::DetectorSpec::vu(float highPassHz)
+{
+    return { SlidingWindowDetector::Mode::RMS, 300.0f, false, highPassHz };
+}
+
+SidechainBus::DetectorSpec SidechainBus::DetectorSpec::forCompressor(const schill::dynamics::CompressorCore& compressor,
+                                                                    float highPassHz)
+{
+    return { compressor.getDetectionMode(), compressor.getDetectionWindowMs(),
+             compressor.usesTruePeakDetection(), highPassHz };
+}
+
+//==============================================================================
+// CONFIGURATION
+//==============================================================================
+
+/**
+ * Serialises edits and waits out publishes already running. Publishers
+ * register before checking the flag, so once it is set and the count has
+ * drained no publish can touch the slots until the edit ends.
+ */
+class SidechainBus::ScopedEdit
+{
+public:
+    explicit ScopedEdit(SidechainBus& busToEdit)
+        : bus(busToEdit), lock(busToEdit.configLock)
+    {
+        bus.editing.store(true);
+        while (bus.activePublishers.load() != 0)
+            std::this_thread::yield();
+    }
+
+    ~ScopedEdit() { bus.editing.store(false); }
+
+private:
+    SidechainBus& bus;
+    std::lock_guard<std::mutex> lock;
+};
+
+void SidechainBus::prepare(double newSampleRate, int newMaxBlockSize)
+{
+    ScopedEdit edit(*this);
+
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 48000.0;
+    maxBlockSize = std::max(1, newMaxBlockSize);
+
+    for (auto& detector : detectors)
+    {
+        if (detector.active)
+            prepareDetector(detector);
+    }
+
+    freeRetired();
+}
+
+void SidechainBus::reset()
+{
+    ScopedEdit edit(*this);
+
+    for (auto& detector : detectors)
+    {
+        if (!detector.active)
+            continue;
+
+        for (auto& window : detector.windows)
+            window.reset();
+
+        std::fill(std::begin(detector.previousInput), std::end(detector.previousInput), 0.0f);
+        std::fill(std::begin(detector.z1), std::end(detector.z1), 0.0f);
+        std::fill(std::begin(detector.z2), std::end(detector.z2), 0.0f);
+    }
+}
+
+SidechainBus::KeyId SidechainBus::addKey(const juce::String& name)
+{
+    if (const auto existing = findKey(name); existing != invalidId)
+        return existing;
+
+    ScopedEdit edit(*this);
+
+    for (KeyId id = 0; id < maxKeys; ++id)
+    {
+        auto& key = keys[id];
+        if (key.active)
+            continue;
+
+        key.active = true;
+        key.name = name;
+        key.publishedBlock.store(0);
+        return id;
+    }
+
+    juce::Logger::writeToLog("SidechainBus: no free key slot for " + name);
+    return invalidId;
+}
+
+void SidechainBus::removeKey(KeyId id)
+{
+    ScopedEdit edit(*this);
+
+    if (!isKey(id))
+        return;
+
+    // Subscriptions die with their key
+    for (auto& detector : detectors)
+    {
+        if (detector.active && detector.key == id)
+        {
+            detector.active = false;
+            detector.subscribers = 0;
+            detector.publishedBlock.store(0);
+        }
+    }
+
+    keys[id].active = false;
+    keys[id].publishedBlock.store(0);
+
+    freeRetired();
+}
+
+SidechainBus::KeyId SidechainBus::findKey(const juce::String& name) const
+{
+    std::lock_guard<std::mutex> lock(configLock);
+
+    for (KeyId id = 0; id < maxKeys; ++id)
+    {
+        if (keys[id].active && keys[id].name == name)
+            return id;
+    }
+
+    return invalidId;
+}
+
+SidechainBus::DetectorId SidechainBus::subscribe(KeyId key, const DetectorSpec& spec)
+{
+    ScopedEdit edit(*this);
+
+    if (!isKey(key))
+        return invalidId;
+
+    for (DetectorId id = 0; id < maxDetectors; ++id)
+    {
+        auto& detector = detectors[id];
+        if (detector.active && detector.key == key && detector.spec == spec)
+        {
+            ++detector.subscribers;
+            return id;
+        }
+    }
+
+    for (DetectorId id = 0; id < maxDetectors; ++id)
+    {
+        auto& detector = detectors[id];
+        if (detector.active)
+            continue;
+
+        detector.key = key;
+        detector.spec = spec;
+        detector.subscribers = 1;
+        detector.publishedBlock.store(0);
+        prepareDetector(detector);
+        detector.active = true;
+        freeRetired();
+        return id;
+    }
+
+    juce::Logger::writeToLog("SidechainBus: no free detector slot for " + keys[key].name);
+    return invalidId;
+}
+
+void SidechainBus::unsubscribe(DetectorId id)
+{
+    ScopedEdit edit(*this);
+
+    if (id < 0 || id >= maxDetectors || !detectors[id].active)
+        return;
+
+    auto& detector = detectors[id];
+    if (--detector.subscribers <= 0)
+    {
+        detector.active = false;
+        detector.subscribers = 0;
+        detector.publishedBlock.store(0);
+    }
+
+    freeRetired();
+}
+
+SidechainBus::KeyId SidechainBus::getKeyOf(DetectorId id) const
+{
+    std::lock_guard<std::mutex> lock(configLock);
+
+    if (id < 0 || id >= maxDetectors || !detectors[id].active)
+        return invalidId;
+
+    return detectors[id].key;
+}
+
+int SidechainBus::getNumKeys() const
+{
+    std::lock_guard<std::mutex> lock(configLock);
+    return static_cast<int>(std::count_if(std::begin(keys), std::end(keys),
+                                          [](const Key& key) { return key.active; }));
+}
+
+int SidechainBus::getNumDetectors(KeyId key) const
+{
+    std::lock_guard<std::mutex> lock(configLock);
+    return static_cast<int>(std::count_if(std::begin(detectors), std::end(detectors),
+                                          [key](const Detector& detector) { return detector.active && detector.key == key; }));
+}
+
+void SidechainBus::collectGarbage()
+{
+    std::lock_guard<std::mutex> lock(configLock);
+    freeRetired();
+}
+
+void SidechainBus::freeRetired()
+{
+    // A span is valid until the next beginBlock, so storage retired during
+    // an earlier block has no readers left
+    const auto block = currentBlock.load();
+    retiredPower.erase(std::remove_if(retiredPower.begin(), retiredPower.end(),
+                                      [block](const RetiredPower& retired) { return retired.retiredBlock < block; }),
+                       retiredPower.end());
+}
+
+void SidechainBus::prepareDetector(Detector& detector)
+{
+    const auto& spec = detector.spec;
+
+    // Same window length rounding as CompressorCore, so shared and private
+    // detection agree sample for sample
+    const int windowLength = std::max(1, static_cast<int>(std::lround(spec.windowMs * 0.001 * sampleRate)));
+    for (auto& window : detector.windows)
+    {
+        window.setMode(spec.mode);
+        window.prepare(windowLength);
+        window.setWindowLength(windowLength);
+    }
+
+    std::fill(std::begin(detector.previousInput), std::end(detector.previousInput), 0.0f);
+    std::fill(std::begin(detector.z1), std::end(detector.z1), 0.0f);
+    std::fill(std::begin(detector.z2), std::end(detector.z2), 0.0f);
+
+    detector.filtered = spec.highPassHz > 0.0f && spec.highPassHz < 0.45f * static_cast<float>(sampleRate);
+    if (detector.filtered)
+    {
+        const double w0 = juce::MathConstants<double>::twoPi * spec.highPassHz / sampleRate;
+        const double cosW0 = std::cos(w0);
+        const double alpha = std::sin(w0) / juce::MathConstants<double>::sqrt2;   // Q = 1 / sqrt2
+        const double a0 = 1.0 + alpha;
+
+        detector.b0 = static_cast<float>((1.0 + cosW0) * 0.5 / a0);
+        detector.b1 = static_cast<float>(-(1.0 + cosW0) / a0);
+        detector.b2 = detector.b0;
+        detector.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+        detector.a2 = static_cast<float>((1.0 - alpha) / a0);
+    }
+
+    // Fresh storage: a getter may still be reading the old buffer, even
+    // when this slot was just unsubscribed and is being reused
+    if (detector.power != nullptr)
+        retiredPower.push_back({ std::move(detector.power), currentBlock.load() });
+
+    detector.power = std::make_unique<float[]>(static_cast<size_t>(std::max(1, maxBlockSize)));
+}
+
+//==============================================================================
+// PER BLOCK
+//==============================================================================
+
+void SidechainBus::publish(KeyId id, const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    activePublishers.fetch_add(1);
+
+    if (editing.load() || !isKey(id) || channels == nullptr || numChannels <= 0 || numSamples <= 0)
+    {
+        activePublishers.fetch_sub(1);
+        return;
+    }
+
+    const auto block = currentBlock.load();
+    auto& key = keys[id];
+    key.span = { channels, numChannels, numSamples };
+
+    // Blocks beyond the prepared size still publish the key; detectors sit out
+    jassert(numSamples <= maxBlockSize);
+    if (numSamples <= maxBlockSize)
+    {
+        for (auto& detector : detectors)
+        {
+            if (detector.active && detector.key == id)
+            {
+                runDetector(detector, channels, numChannels, numSamples);
+                detector.span = { detector.power.get(), numSamples };
+                detector.publishedBlock.store(block);
+            }
+        }
+    }
+
+    key.publishedBlock.store(block);
+    activePublishers.fetch_sub(1);
+}
+
+void SidechainBus::publish(KeyId key, const juce::AudioBuffer<float>& buffer) noexcept
+{
+    publish(key, buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+}
+
+void SidechainBus::runDetector(Detector& detector, const float* const* channels,
+                               int numChannels, int numSamples) noexcept
+{
+    const int numDetected = std::min(numChannels, maxKeyChannels);
+    const bool truePeak = detector.spec.truePeak;
+    float* power = detector.power.get();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float maxPower = 0.0f;
+
+        for (int ch = 0; ch < numDetected; ++ch)
+        {
+            float x = channels[ch][i];
+
+            if (detector.filtered)
+            {
+                const float y = detector.b0 * x + detector.z1[ch];
+                detector.z1[ch] = detector.b1 * x - detector.a1 * y + detector.z2[ch];
+                detector.z2[ch] = detector.b2 * x - detector.a2 * y;
+                x = y;
+            }
+
+            float squared = x * x;
+
+            if (truePeak)
+            {
+                // Midpoint estimate of the inter-sample peak
+                const float midpoint = 0.5f * (x + detector.previousInput[ch]);
+                squared = std::max(squared, midpoint * midpoint);
+                detector.previousInput[ch] = x;
+            }
+
+            maxPower = std::max(maxPower, detector.windows[ch].process(squared));
+        }
+
+        power[i] = maxPower;
+    }
+}
+
+SidechainBus::KeySpan SidechainBus::getKey(KeyId id) const noexcept
+{
+    if (id < 0 || id >= maxKeys || keys[id].publishedBlock.load() != currentBlock.load())
+        return {};
+
+    return keys[id].span;
+}
+
+SidechainBus::DetectorSpan SidechainBus::getDetector(DetectorId id) const noexcept
+{
+    if (id < 0 || id >= maxDetectors)
+        return {};
+
+    const auto& detector = detectors[id];
+    if (detector.publishedBlock.load() != currentBlock.load())
+        return {};
+
+    return detector.span;
+}
+
+} // namespace SchillingerEcosystem::Routing
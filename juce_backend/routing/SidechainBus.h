@@ -0,0 +1,185 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../include/dynamics/CompressorCore.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SchillingerEcosystem::Routing {
+
+/**
+ * @brief Shared sidechain key bus
+ *
+ * A key source (kick, vocal, bus) is published once per block and every
+ * ducking compressor or gate reads it in place instead of copying it.
+ * Consumers that only need a level subscribe to a detector: a key filter
+ * plus a windowed peak/RMS detector whose output (power, fully linked
+ * across key channels) is computed once per block and shared by every
+ * subscriber with the same settings. Ten tracks ducking off one kick cost
+ * one detector, not ten.
+ *
+ * Keys and subscriptions are edited on the message thread; beginBlock,
+ * publish and the getters run on audio threads and never lock or
+ * allocate. Different keys may be published from different threads. A
+ * publish that overlaps an edit is skipped, so consumers see no key for
+ * that block and fall back to their own input. Edits never write what a
+ * getter hands out: detector storage an edit replaces is retired and only
+ * freed once a later block has begun, when no span can still point at it.
+ */
+class SidechainBus
+{
+public:
+    using KeyId = int;
+    using DetectorId = int;
+    static constexpr int invalidId = -1;
+    static constexpr int maxKeyChannels = 8;
+
+    /** Detector settings; subscriptions with equal settings share one detector */
+    struct DetectorSpec
+    {
+        schill::dynamics::SlidingWindowDetector::Mode mode = schill::dynamics::SlidingWindowDetector::Mode::RMS;
+        float windowMs = 10.0f;
+        bool truePeak = false;          // Midpoint inter-sample peak estimate
+        float highPassHz = 0.0f;        // Key filter, 0 = off
+
+        bool operator== (const DetectorSpec& other) const noexcept;
+
+        // Standard time constants, matching the compressor modes
+        static DetectorSpec peak(float highPassHz = 0.0f);          // 1 ms window
+        static DetectorSpec rms(float highPassHz = 0.0f);           // 10 ms
+        static DetectorSpec vu(float highPassHz = 0.0f);            // 300 ms
+
+        /** What CompressorCore::processWithKeyPower expects for its current settings */
+        static DetectorSpec forCompressor(const schill::dynamics::CompressorCore& compressor,
+                                          float highPassHz = 0.0f);
+    };
+
+    /** Read-only view of a published key, valid until the next beginBlock */
+    struct KeySpan
+    {
+        const float* const* channels = nullptr;
+        int numChannels = 0;
+        int numSamples = 0;
+
+        bool isValid() const noexcept { return channels != nullptr; }
+    };
+
+    /** Detector output for the current block: power (squared level) per sample */
+    struct DetectorSpan
+    {
+        const float* power = nullptr;
+        int numSamples = 0;
+
+        bool isValid() const noexcept { return power != nullptr; }
+    };
+
+    SidechainBus() = default;
+    ~SidechainBus() = default;
+
+    //==============================================================================
+    // CONFIGURATION (message thread)
+    //==============================================================================
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    KeyId addKey(const juce::String& name);
+    void removeKey(KeyId key);
+    KeyId findKey(const juce::String& name) const;
+
+    /** Share (or create) the detector for spec on key; released by unsubscribe */
+    DetectorId subscribe(KeyId key, const DetectorSpec& spec);
+    void unsubscribe(DetectorId detector);
+
+    /** Key a subscription listens to, so a consumer can also read the key itself */
+    KeyId getKeyOf(DetectorId detector) const;
+
+    int getNumKeys() const;
+    int getNumDetectors(KeyId key) const;
+
+    /** Free detector storage retired before the current block (also done by every edit) */
+    void collectGarbage();
+
+    //==============================================================================
+    // PER BLOCK (audio thread)
+    //==============================================================================
+
+    /** Start a block; spans from the previous block become invalid */
+    void beginBlock() noexcept { currentBlock.fetch_add(1); }
+
+    /** Publish a key by reference and run its detectors once */
+    void publish(KeyId key, const float* const* channels, int numChannels, int numSamples) noexcept;
+    void publish(KeyId key, const juce::AudioBuffer<float>& buffer) noexcept;
+
+    KeySpan getKey(KeyId key) const noexcept;
+    DetectorSpan getDetector(DetectorId detector) const noexcept;
+
+private:
+    static constexpr int maxKeys = 32;
+    static constexpr int maxDetectors = 128;
+
+    struct Key
+    {
+        bool active = false;
+        juce::String name;
+        KeySpan span;                   // Written by its publisher only
+        std::atomic<juce::uint64> publishedBlock { 0 };
+    };
+
+    struct Detector
+    {
+        bool active = false;
+        KeyId key = invalidId;
+        DetectorSpec spec;
+        int subscribers = 0;
+
+        schill::dynamics::SlidingWindowDetector windows[maxKeyChannels];
+        float previousInput[maxKeyChannels] = {};
+
+        // Key filter: second-order Butterworth high-pass, per channel state
+        bool filtered = false;
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float z1[maxKeyChannels] = {};
+        float z2[maxKeyChannels] = {};
+
+        std::unique_ptr<float[]> power;     // maxBlockSize samples, replaced by prepareDetector
+        DetectorSpan span;                  // Written by the key's publisher only
+        std::atomic<juce::uint64> publishedBlock { 0 };
+    };
+
+    /** Detector storage a getter may still be reading until the block after retiredBlock */
+    struct RetiredPower
+    {
+        std::unique_ptr<float[]> power;
+        juce::uint64 retiredBlock = 0;
+    };
+
+    /** Holds publishers off while the message thread edits keys or detectors */
+    class ScopedEdit;
+
+    void prepareDetector(Detector& detector);
+    void freeRetired();
+    void runDetector(Detector& detector, const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    bool isKey(KeyId key) const noexcept { return key >= 0 && key < maxKeys && keys[key].active; }
+
+    double sampleRate = 48000.0;
+    int maxBlockSize = 0;
+
+    // Fixed slots, so the audio thread never sees a container move
+    Key keys[maxKeys];
+    Detector detectors[maxDetectors];
+
+    std::vector<RetiredPower> retiredPower;     // Message thread, under configLock
+
+    mutable std::mutex configLock;
+    std::atomic<bool> editing { false };
+    std::atomic<int> activePublishers { 0 };
+    std::atomic<juce::uint64> currentBlock { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SidechainBus)
+};
+
+} // namespace SchillingerEcosystem::Routing
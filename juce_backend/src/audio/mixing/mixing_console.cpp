@@ -63,33 +63,47 @@ ChannelStrip* MixingConsoleProcessor::getMasterBus() {
 void MixingConsoleProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     currentSampleRate = sampleRate;
 
-    // Prepare mix buffer (stereo)
-    mixBuffer.setSize(2, samplesPerBlock);
-    channelBuffer.setSize(2, samplesPerBlock);
+    // Prepare mix buffers in the console layout
+    mixBuffer.setSize(layout.getNumChannels(), samplesPerBlock);
+    channelBuffer.setSize(layout.getNumChannels(), samplesPerBlock);
+}
+
+void MixingConsoleProcessor::setChannelLayout(const DSP::ChannelLayout& newLayout) {
+    layout = newLayout;
+
+    mixBuffer.setSize(layout.getNumChannels(), mixBuffer.getNumSamples());
+    channelBuffer.setSize(layout.getNumChannels(), channelBuffer.getNumSamples());
+    reset();
 }
 
 void MixingConsoleProcessor::reset() {
     mixBuffer.clear();
     channelBuffer.clear();
 
+    auto resetMeters = [](ChannelStrip& strip) {
+        strip.levelL = -60.0f;
+        strip.levelR = -60.0f;
+        strip.peakL = -60.0f;
+        strip.peakR = -60.0f;
+        std::fill(std::begin(strip.levels), std::end(strip.levels), -60.0f);
+        std::fill(std::begin(strip.peaks), std::end(strip.peaks), -60.0f);
+    };
+
     for (auto& channel : channels) {
-        channel->levelL = -60.0f;
-        channel->levelR = -60.0f;
-        channel->peakL = -60.0f;
-        channel->peakR = -60.0f;
+        resetMeters(*channel);
     }
 
-    masterBus->levelL = -60.0f;
-    masterBus->levelR = -60.0f;
-    masterBus->peakL = -60.0f;
-    masterBus->peakR = -60.0f;
+    resetMeters(*masterBus);
 }
 
 void MixingConsoleProcessor::processBlock(juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+
+    // Channels of the layout the host buffer carries
+    const int numChannels = juce::jmin(buffer.getNumChannels(), layout.getNumChannels());
 
     // Clear mix buffer
+    mixBuffer.setSize(numChannels, numSamples, false, false, true);
     mixBuffer.clear();
 
     // Process each channel
@@ -98,23 +112,24 @@ void MixingConsoleProcessor::processBlock(juce::AudioBuffer<float>& buffer) {
             // Muted channel - clear levels
             channel->levelL = -60.0f;
             channel->levelR = -60.0f;
+            std::fill(std::begin(channel->levels), std::end(channel->levels), -60.0f);
             continue;
         }
 
         // Copy channel data to temp buffer
-        channelBuffer.setSize(buffer.getNumChannels(), numSamples, false, false, true);
-        channelBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
+        channelBuffer.setSize(numChannels, numSamples, false, false, true);
 
-        if (buffer.getNumChannels() >= 2) {
-            channelBuffer.copyFrom(1, 0, buffer, 1, 0, numSamples);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            channelBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
         }
 
         // Apply volume and pan
         applyVolumePan(*channel, channelBuffer);
 
         // Add to mix buffer
-        mixBuffer.addFrom(0, 0, channelBuffer, 0, 0, numSamples);
-        mixBuffer.addFrom(1, 0, channelBuffer, 1, 0, numSamples);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            mixBuffer.addFrom(ch, 0, channelBuffer, ch, 0, numSamples);
+        }
 
         // Update metering
         updateMetering(*channel, channelBuffer);
@@ -124,9 +139,8 @@ void MixingConsoleProcessor::processBlock(juce::AudioBuffer<float>& buffer) {
     applyVolumePan(*masterBus, mixBuffer);
 
     // Copy mix buffer to output
-    buffer.copyFrom(0, 0, mixBuffer, 0, 0, numSamples);
-    if (numChannels >= 2) {
-        buffer.copyFrom(1, 0, mixBuffer, 1, 0, numSamples);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        buffer.copyFrom(ch, 0, mixBuffer, ch, 0, numSamples);
     }
 
     // Update master metering
@@ -193,6 +207,18 @@ float MixingConsoleProcessor::getPeakR(int channelId) const {
     return channel ? channel->peakR : -60.0f;
 }
 
+float MixingConsoleProcessor::getLevel(int channelId, int layoutChannel) const {
+    const ChannelStrip* channel = const_cast<MixingConsoleProcessor*>(this)->getChannel(channelId);
+    if (!channel || layoutChannel < 0 || layoutChannel >= DSP::ChannelLayout::maxChannels) return -60.0f;
+    return channel->levels[layoutChannel];
+}
+
+float MixingConsoleProcessor::getPeak(int channelId, int layoutChannel) const {
+    const ChannelStrip* channel = const_cast<MixingConsoleProcessor*>(this)->getChannel(channelId);
+    if (!channel || layoutChannel < 0 || layoutChannel >= DSP::ChannelLayout::maxChannels) return -60.0f;
+    return channel->peaks[layoutChannel];
+}
+
 std::map<int, std::pair<float, float>> MixingConsoleProcessor::getAllMeterData() const {
     std::map<int, std::pair<float, float>> meterData;
 
@@ -233,13 +259,31 @@ void MixingConsoleProcessor::applyVolumePan(ChannelStrip& channel, juce::AudioBu
         panR = 1.0f;
     }
 
-    // Apply volume and pan
-    float volL = channel.volume * panL;
-    float volR = channel.volume * panR;
+    // Apply volume and pan: surround layouts balance every left speaker
+    // against every right one, centre and LFE keep the volume, Ambisonic
+    // mixes are not panned
+    const int numChannels = buffer.getNumChannels();
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float gain = channel.volume;
 
-    buffer.applyGain(0, 0, numSamples, volL);
-    if (buffer.getNumChannels() >= 2) {
-        buffer.applyGain(1, 0, numSamples, volR);
+        if (layout.isSpeakerLayout() && numChannels >= 2) {
+            const auto& speaker = layout.getSpeaker(ch);
+
+            if (!speaker.isLFE && speaker.azimuth > 0.0f && speaker.azimuth < 180.0f) {
+                gain *= panL;
+            } else if (!speaker.isLFE && speaker.azimuth < 0.0f && speaker.azimuth > -180.0f) {
+                gain *= panR;
+            }
+        } else if (!layout.isAmbisonic()) {
+            if (ch == 0) {
+                gain *= panL;
+            } else if (ch == 1) {
+                gain *= panR;
+            }
+        }
+
+        buffer.applyGain(ch, 0, numSamples, gain);
     }
 }
 
@@ -256,42 +300,32 @@ bool MixingConsoleProcessor::shouldPlayChannel(const ChannelStrip& channel) cons
 
 void MixingConsoleProcessor::updateMetering(ChannelStrip& channel, const juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
+    const float smoothing = 0.2f;
+
+    // Every channel of the layout; channels the buffer lacks meter as silence
+    for (int ch = 0; ch < layout.getNumChannels(); ++ch) {
+        // Find RMS and peak levels
+        float peak = 0.0f;
+        float sumOfSquares = 0.0f;
 
-    // Find RMS and peak levels
-    float rmsL = 0.0f;
-    float rmsR = 0.0f;
-    float peakL = 0.0f;
-    float peakR = 0.0f;
-
-    for (int i = 0; i < numSamples; ++i) {
-        float sampleL = std::abs(buffer.getSample(0, i));
-        peakL = juce::jmax(peakL, sampleL);
-        rmsL += sampleL * sampleL;
-
-        if (buffer.getNumChannels() >= 2) {
-            float sampleR = std::abs(buffer.getSample(1, i));
-            peakR = juce::jmax(peakR, sampleR);
-            rmsR += sampleR * sampleR;
+        if (ch < buffer.getNumChannels() && numSamples > 0) {
+            DSP::LayoutMeter::measure(buffer.getReadPointer(ch), numSamples, peak, sumOfSquares);
         }
-    }
 
-    rmsL = std::sqrt(rmsL / numSamples);
-    rmsR = std::sqrt(rmsR / numSamples);
+        const float rms = numSamples > 0 ? std::sqrt(sumOfSquares / numSamples) : 0.0f;
 
-    // Convert to dB
-    float levelL_new = linearToDecibels(rmsL);
-    float levelR_new = linearToDecibels(rmsR);
-    float peakL_new = linearToDecibels(peakL);
-    float peakR_new = linearToDecibels(peakR);
+        // Smooth metering
+        channel.levels[ch] = channel.levels[ch] * (1.0f - smoothing) + linearToDecibels(rms) * smoothing;
 
-    // Smooth metering
-    float smoothing = 0.2f;
-    channel.levelL = channel.levelL * (1.0f - smoothing) + levelL_new * smoothing;
-    channel.levelR = channel.levelR * (1.0f - smoothing) + levelR_new * smoothing;
+        // Peak hold (instant attack, slow decay)
+        channel.peaks[ch] = juce::jmax(channel.peaks[ch] - 0.5f, linearToDecibels(peak));
+    }
 
-    // Peak hold (instant attack, slow decay)
-    channel.peakL = juce::jmax(channel.peakL - 0.5f, peakL_new);
-    channel.peakR = juce::jmax(channel.peakR - 0.5f, peakR_new);
+    // Front pair for the stereo meters
+    channel.levelL = channel.levels[0];
+    channel.peakL = channel.peaks[0];
+    channel.levelR = layout.getNumChannels() >= 2 ? channel.levels[1] : -60.0f;
+    channel.peakR = layout.getNumChannels() >= 2 ? channel.peaks[1] : -60.0f;
 }
 
 float MixingConsoleProcessor::linearToDecibels(float linear) {
@@ -9,6 +9,9 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "dsp/ChannelLayout.h"
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <memory>
 #include <map>
@@ -33,10 +36,12 @@ struct ChannelStrip {
     bool isSolo;
 
     // Metering
-    float levelL; // Current level in dB
+    float levelL; // Current level in dB (front pair of the layout)
     float levelR;
     float peakL;
     float peakR;
+    float levels[DSP::ChannelLayout::maxChannels]; // Every channel of the layout, dB
+    float peaks[DSP::ChannelLayout::maxChannels];
 
     // Routing
     juce::String outputBus;
@@ -54,7 +59,10 @@ struct ChannelStrip {
         , peakL(-60.0f)
         , peakR(-60.0f)
         , outputBus("master")
-    {}
+    {
+        std::fill(std::begin(levels), std::end(levels), -60.0f);
+        std::fill(std::begin(peaks), std::end(peaks), -60.0f);
+    }
 };
 
 /**
@@ -110,6 +118,14 @@ public:
      */
     void reset();
 
+    /**
+     * Set the console's bus format (stereo by default). Every strip and the
+     * master carry this many channels; pan balances left speakers against
+     * right ones. Call before prepareToPlay.
+     */
+    void setChannelLayout(const DSP::ChannelLayout& layout);
+    const DSP::ChannelLayout& getChannelLayout() const { return layout; }
+
     // ========== Level Controls ==========
 
     /**
@@ -146,6 +162,12 @@ public:
     float getPeakL(int channelId) const;
     float getPeakR(int channelId) const;
 
+    /**
+     * Get level / peak for one channel of the layout (dB)
+     */
+    float getLevel(int channelId, int layoutChannel) const;
+    float getPeak(int channelId, int layoutChannel) const;
+
     /**
      * Get all meter data
      */
@@ -164,6 +186,7 @@ private:
 
     double currentSampleRate = 44100.0;
     int peekIndex = 0;
+    DSP::ChannelLayout layout;
 
     // Temporary buffers for processing
     juce::AudioBuffer<float> mixBuffer;
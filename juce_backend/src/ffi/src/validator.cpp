@@ -2,63 +2,49 @@
  * White Room FFI - JSON Schema Validation
  *
  * Validates JSON data against JSON schemas.
- * This file will be expanded with full schema validation support.
  *
- * NOTE: Full JSON Schema validation (using nlohmann/json_schema) is deferred
- * to future implementation. Current implementation validates JSON syntax only.
+ * Uses the compiled-schema streaming validator shared with SchemaValidator
+ * (validation/StreamingSchemaValidator.h).
  */
 
 #include "ffi_server.h"
-#include <nlohmann/json.hpp>
-#include <fstream>
-#include <sstream>
+#include "validation/StreamingSchemaValidator.h"
 
 namespace white_room {
 namespace ffi {
 
-/**
- * Load JSON schema from file
- * TODO: Implement actual schema loading from files
- */
-static std::optional<nlohmann::json> loadSchema(const std::string& schemaName) {
-  // For now, just check if schema name is recognized
-  // Recognized schemas: SchillingerSong_v1, SongModel_v1, ReconciliationReport_v1
-  if (schemaName == "SchillingerSong_v1" ||
-      schemaName == "SongModel_v1" ||
-      schemaName == "ReconciliationReport_v1") {
-    // Return empty schema for now (schema validation not implemented)
-    return nlohmann::json::object();
-  }
-  return std::nullopt;
-}
-
 /**
  * Validate JSON against schema
- * TODO: Implement actual schema validation
+ *
+ * Model schemas (SchillingerSong_v1, SongModel_v1, PerformanceState_v1) are
+ * compiled once and checked in a single streaming pass. Other recognised
+ * schemas currently get a syntax check only. All violations are reported,
+ * one per line, as "<json pointer>: <message>".
  */
 bool validateJsonSchema(const std::string& jsonStr, const std::string& schemaName, std::string& outError) {
-  try {
-    // Parse JSON (validates syntax)
-    nlohmann::json json = nlohmann::json::parse(jsonStr);
-
-    // Check if schema is recognized
-    auto schemaOpt = loadSchema(schemaName);
-    if (!schemaOpt) {
-      outError = "Schema not found: " + schemaName;
-      return false;
-    }
+  using namespace white_room::validation;
+
+  const CompiledSchema* schema = nullptr;
+  if (auto model = modelSchemaFromName(schemaName)) {
+    schema = &getCompiledSchema(*model);
+  } else if (schemaName == "ReconciliationReport_v1") {
+    schema = &getPermissiveSchema();
+  } else {
+    outError = "Schema not found: " + schemaName;
+    return false;
+  }
 
-    // TODO: Implement actual JSON Schema validation
-    // For now, just check that JSON is valid syntax
+  thread_local StreamingValidator validator;
+  if (validator.validate(jsonStr, *schema)) {
     return true;
+  }
 
-  } catch (const nlohmann::json::parse_error& e) {
-    outError = "JSON parse error: " + std::string(e.what());
-    return false;
-  } catch (const std::exception& e) {
-    outError = "Validation error: " + std::string(e.what());
-    return false;
+  outError.clear();
+  for (const auto& error : validator.getErrors()) {
+    if (!outError.empty()) outError += "\n";
+    outError += error.fieldPath + ": " + error.message;
   }
+  return false;
 }
 
 } // namespace ffi
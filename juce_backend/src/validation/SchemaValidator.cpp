@@ -12,6 +12,7 @@
 */
 
 #include "validation/SchemaValidator.h"
+#include "validation/StreamingSchemaValidator.h"
 #include <regex>
 #include <sstream>
 #include <algorithm>
@@ -277,303 +278,33 @@ bool validateIntegerField(int64_t value,
 }
 
 // =============================================================================
-// SchillingerSong_v1 Validation
+// Model Validation
 // =============================================================================
+//
+// The model validators run on the compiled schemas from
+// StreamingSchemaValidator.cpp: one pass over the document, no per-field
+// regex scans. The rules themselves live in the schema builders there.
 
-ValidationResult<std::string> validateSchillingerSong(const std::string& json) {
-    ValidationErrors errors;
-
-    // Check if valid JSON
-    if (!JsonHelper::isValidJson(json)) {
-        return ValidationResult<std::string>::error("root", "Invalid JSON format");
-    }
-
-    // Version (const: "1.0")
-    auto version = JsonHelper::getString(json, "version");
-    if (!version.has_value() || !validateVersion(version.value(), "1.0")) {
-        errors.add("version", "Version must be \"1.0\"", version.value_or(""));
-    }
-
-    // ID (UUID)
-    auto id = JsonHelper::getString(json, "id");
-    if (!id.has_value()) {
-        errors.add("id", "ID is required");
-    } else if (!validateUUIDField(id.value(), "id", errors)) {
-        // Error already added
-    }
-
-    // createdAt (Unix timestamp, >= 0)
-    auto createdAt = JsonHelper::getNumber(json, "createdAt");
-    if (!createdAt.has_value()) {
-        errors.add("createdAt", "createdAt is required");
-    } else if (createdAt.value() < 0) {
-        errors.add("createdAt", "createdAt must be a non-negative number",
-                   std::to_string(createdAt.value()));
-    }
-
-    // modifiedAt (Unix timestamp, >= 0)
-    auto modifiedAt = JsonHelper::getNumber(json, "modifiedAt");
-    if (!modifiedAt.has_value()) {
-        errors.add("modifiedAt", "modifiedAt is required");
-    } else if (modifiedAt.value() < 0) {
-        errors.add("modifiedAt", "modifiedAt must be a non-negative number",
-                   std::to_string(modifiedAt.value()));
-    }
-
-    // author (string)
-    auto author = JsonHelper::getString(json, "author");
-    if (!author.has_value() || author.value().empty()) {
-        errors.add("author", "author must be a non-empty string");
-    }
-
-    // name (string, minLength: 1, maxLength: 256)
-    auto name = JsonHelper::getString(json, "name");
-    if (!name.has_value()) {
-        errors.add("name", "name is required");
-    } else if (!validateStringField(name.value(), 1, 256, "name", &errors)) {
-        // Error already added
-    }
-
-    // seed (integer, min: 0, max: 4294967295)
-    auto seed = JsonHelper::getNumber(json, "seed");
-    if (!seed.has_value()) {
-        errors.add("seed", "seed is required");
-    } else if (!validateIntegerField(static_cast<int64_t>(seed.value()),
-                                      0, 4294967295, "seed", &errors)) {
-        // Error already added
-    }
-
-    // Check required objects
-    if (!JsonHelper::hasField(json, "ensemble")) {
-        errors.add("ensemble", "ensemble is required");
-    }
-
-    if (!JsonHelper::hasField(json, "bindings")) {
-        errors.add("bindings", "bindings is required");
-    }
-
-    if (!JsonHelper::hasField(json, "constraints")) {
-        errors.add("constraints", "constraints is required");
-    }
+namespace {
 
-    if (!JsonHelper::hasField(json, "console")) {
-        errors.add("console", "console is required");
-    }
+ValidationResult<std::string> validateModel(const std::string& json, ModelSchema model) {
+    thread_local StreamingValidator validator;
+    validator.validate(json, getCompiledSchema(model));
+    return validator.toResult(json);
+}
 
-    // book4 is required (FormSystem)
-    if (!JsonHelper::hasField(json, "book4")) {
-        errors.add("book4", "book4 is required");
-    }
+} // namespace
 
-    return errors.toResult(json);
+ValidationResult<std::string> validateSchillingerSong(const std::string& json) {
+    return validateModel(json, ModelSchema::SchillingerSong_v1);
 }
 
-// =============================================================================
-// SongModel_v1 Validation
-// =============================================================================
-
 ValidationResult<std::string> validateSongModel(const std::string& json) {
-    ValidationErrors errors;
-
-    // Check if valid JSON
-    if (!JsonHelper::isValidJson(json)) {
-        return ValidationResult<std::string>::error("root", "Invalid JSON format");
-    }
-
-    // Version (const: "1.0")
-    auto version = JsonHelper::getString(json, "version");
-    if (!version.has_value() || !validateVersion(version.value(), "1.0")) {
-        errors.add("version", "Version must be \"1.0\"", version.value_or(""));
-    }
-
-    // ID (UUID)
-    auto id = JsonHelper::getString(json, "id");
-    if (!id.has_value()) {
-        errors.add("id", "ID is required");
-    } else if (!validateUUIDField(id.value(), "id", errors)) {
-        // Error already added
-    }
-
-    // sourceSongId (UUID)
-    auto sourceSongId = JsonHelper::getString(json, "sourceSongId");
-    if (!sourceSongId.has_value()) {
-        errors.add("sourceSongId", "sourceSongId is required");
-    } else if (!validateUUIDField(sourceSongId.value(), "sourceSongId", errors)) {
-        // Error already added
-    }
-
-    // derivationId (UUID)
-    auto derivationId = JsonHelper::getString(json, "derivationId");
-    if (!derivationId.has_value()) {
-        errors.add("derivationId", "derivationId is required");
-    } else if (!validateUUIDField(derivationId.value(), "derivationId", errors)) {
-        // Error already added
-    }
-
-    // duration (integer, min: 0)
-    auto duration = JsonHelper::getNumber(json, "duration");
-    if (!duration.has_value()) {
-        errors.add("duration", "duration is required");
-    } else if (duration.value() < 0) {
-        errors.add("duration", "duration must be a non-negative number",
-                   std::to_string(duration.value()));
-    }
-
-    // tempo (number, exclusiveMin: 0, max: 500)
-    auto tempo = JsonHelper::getNumber(json, "tempo");
-    if (!tempo.has_value()) {
-        errors.add("tempo", "tempo is required");
-    } else if (!validateNumberField(tempo.value(), 0.0, 500.0, false, true,
-                                   "tempo", &errors)) {
-        // Error already added
-    }
-
-    // sampleRate (enum: 44100, 48000, 96000)
-    auto sampleRate = JsonHelper::getNumber(json, "sampleRate");
-    if (!sampleRate.has_value()) {
-        errors.add("sampleRate", "sampleRate is required");
-    } else {
-        int sr = static_cast<int>(sampleRate.value());
-        if (sr != 44100 && sr != 48000 && sr != 96000) {
-            errors.add("sampleRate", "sampleRate must be 44100, 48000, or 96000",
-                       std::to_string(sr));
-        }
-    }
-
-    // Check required objects
-    if (!JsonHelper::hasField(json, "timeline")) {
-        errors.add("timeline", "timeline is required");
-    }
-
-    if (!JsonHelper::hasField(json, "notes")) {
-        errors.add("notes", "notes array is required");
-    }
-
-    if (!JsonHelper::hasField(json, "voiceAssignments")) {
-        errors.add("voiceAssignments", "voiceAssignments array is required");
-    }
-
-    if (!JsonHelper::hasField(json, "console")) {
-        errors.add("console", "console is required");
-    }
-
-    // derivedAt (integer, min: 0)
-    auto derivedAt = JsonHelper::getNumber(json, "derivedAt");
-    if (!derivedAt.has_value()) {
-        errors.add("derivedAt", "derivedAt is required");
-    } else if (derivedAt.value() < 0) {
-        errors.add("derivedAt", "derivedAt must be a non-negative number",
-                   std::to_string(derivedAt.value()));
-    }
-
-    // Optional activePerformanceId (UUID)
-    auto activePerformanceId = JsonHelper::getString(json, "activePerformanceId");
-    if (activePerformanceId.has_value() && !isValidUUID(activePerformanceId.value())) {
-        errors.add("activePerformanceId", "activePerformanceId must be a valid UUID",
-                   activePerformanceId.value());
-    }
-
-    return errors.toResult(json);
+    return validateModel(json, ModelSchema::SongModel_v1);
 }
 
-// =============================================================================
-// PerformanceState_v1 Validation
-// =============================================================================
-
 ValidationResult<std::string> validatePerformanceState(const std::string& json) {
-    ValidationErrors errors;
-
-    // Check if valid JSON
-    if (!JsonHelper::isValidJson(json)) {
-        return ValidationResult<std::string>::error("root", "Invalid JSON format");
-    }
-
-    // version (const: "1")
-    auto version = JsonHelper::getString(json, "version");
-    if (!version.has_value() || version.value() != "1") {
-        errors.add("version", "Version must be \"1\"", version.value_or(""));
-    }
-
-    // id (UUID)
-    auto id = JsonHelper::getString(json, "id");
-    if (!id.has_value()) {
-        errors.add("id", "ID is required");
-    } else if (!validateUUIDField(id.value(), "id", errors)) {
-        // Error already added
-    }
-
-    // name (string, minLength: 1, maxLength: 256)
-    auto name = JsonHelper::getString(json, "name");
-    if (!name.has_value()) {
-        errors.add("name", "name is required");
-    } else if (!validateStringField(name.value(), 1, 256, "name", &errors)) {
-        // Error already added
-    }
-
-    // arrangementStyle (enum)
-    auto arrangementStyle = JsonHelper::getString(json, "arrangementStyle");
-    if (!arrangementStyle.has_value()) {
-        errors.add("arrangementStyle", "arrangementStyle is required");
-    } else {
-        const std::vector<std::string> validStyles = {
-            "SOLO_PIANO", "SATB", "CHAMBER_ENSEMBLE", "FULL_ORCHESTRA",
-            "JAZZ_COMBO", "JAZZ_TRIO", "ROCK_BAND", "AMBIENT_TECHNO",
-            "ELECTRONIC", "ACAPPELLA", "STRING_QUARTET", "CUSTOM"
-        };
-
-        bool isValid = std::find(validStyles.begin(), validStyles.end(),
-                                arrangementStyle.value()) != validStyles.end();
-
-        if (!isValid) {
-            std::string validList;
-            for (const auto& style : validStyles) {
-                if (!validList.empty()) validList += ", ";
-                validList += style;
-            }
-            errors.add("arrangementStyle",
-                       "arrangementStyle must be one of: " + validList,
-                       arrangementStyle.value());
-        }
-    }
-
-    // Optional density (number, min: 0, max: 1)
-    auto density = JsonHelper::getNumber(json, "density");
-    if (density.has_value()) {
-        if (!validateNumberField(density.value(), 0.0, 1.0, true, true,
-                                "density", &errors)) {
-            // Error already added
-        }
-    }
-
-    // Optional grooveProfileId (string)
-    auto grooveProfileId = JsonHelper::getString(json, "grooveProfileId");
-    if (grooveProfileId.has_value() && grooveProfileId.value().empty()) {
-        errors.add("grooveProfileId", "grooveProfileId must be a non-empty string",
-                   grooveProfileId.value());
-    }
-
-    // Optional consoleXProfileId (string)
-    auto consoleXProfileId = JsonHelper::getString(json, "consoleXProfileId");
-    if (consoleXProfileId.has_value() && consoleXProfileId.value().empty()) {
-        errors.add("consoleXProfileId", "consoleXProfileId must be a non-empty string",
-                   consoleXProfileId.value());
-    }
-
-    // Optional createdAt (ISO 8601)
-    auto createdAt = JsonHelper::getString(json, "createdAt");
-    if (createdAt.has_value() && !isValidISO8601(createdAt.value())) {
-        errors.add("createdAt", "createdAt must be a valid ISO 8601 date-time string",
-                   createdAt.value());
-    }
-
-    // Optional modifiedAt (ISO 8601)
-    auto modifiedAt = JsonHelper::getString(json, "modifiedAt");
-    if (modifiedAt.has_value() && !isValidISO8601(modifiedAt.value())) {
-        errors.add("modifiedAt", "modifiedAt must be a valid ISO 8601 date-time string",
-                   modifiedAt.value());
-    }
-
-    return errors.toResult(json);
+    return validateModel(json, ModelSchema::PerformanceState_v1);
 }
 
 } // namespace validation
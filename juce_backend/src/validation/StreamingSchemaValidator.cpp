@@ -0,0 +1,885 @@
+/*
+  StreamingSchemaValidator.cpp - Compiled-schema, single-pass JSON validation
+
+  See StreamingSchemaValidator.h for the design. The tokenizer is iterative
+  (explicit frame stack) so deeply nested documents cannot overflow the
+  native stack, and it never materialises values: strings are only decoded
+  when they contain escapes and a constraint needs their content.
+*/
+
+#include "validation/StreamingSchemaValidator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace white_room {
+namespace validation {
+
+namespace {
+
+bool isHexDigit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Same grammar as isValidUUID(), without the regex engine
+bool isUUIDFast(std::string_view v) {
+    if (v.size() != 36) return false;
+    for (size_t i = 0; i < 36; ++i) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (v[i] != '-') return false;
+        } else if (!isHexDigit(v[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool digitsAt(std::string_view v, size_t at, size_t count) {
+    if (at + count > v.size()) return false;
+    for (size_t i = at; i < at + count; ++i) {
+        if (!isDigit(v[i])) return false;
+    }
+    return true;
+}
+
+// Same grammar as isValidISO8601(), without the regex engine
+bool isDateTimeFast(std::string_view v) {
+    // YYYY-MM-DDTHH:MM:SS
+    if (!digitsAt(v, 0, 4) || v.size() < 19 || v[4] != '-' || !digitsAt(v, 5, 2) ||
+        v[7] != '-' || !digitsAt(v, 8, 2) || v[10] != 'T' || !digitsAt(v, 11, 2) ||
+        v[13] != ':' || !digitsAt(v, 14, 2) || v[16] != ':' || !digitsAt(v, 17, 2)) {
+        return false;
+    }
+
+    size_t i = 19;
+    if (i < v.size() && v[i] == '.') {
+        ++i;
+        const size_t fractionStart = i;
+        while (i < v.size() && isDigit(v[i])) ++i;
+        if (i == fractionStart) return false;
+    }
+
+    if (i == v.size()) return true;
+    if (v[i] == 'Z') return i + 1 == v.size();
+    if (v[i] == '+' || v[i] == '-') {
+        return i + 6 == v.size() && digitsAt(v, i + 1, 2) && v[i + 3] == ':' &&
+               digitsAt(v, i + 4, 2);
+    }
+    return false;
+}
+
+std::string formatNumber(double value) {
+    std::ostringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+} // namespace
+
+// =============================================================================
+// SchemaSpec
+// =============================================================================
+
+SchemaSpec SchemaSpec::array(SchemaSpec itemSpec) {
+    SchemaSpec spec = ofType(kJsonArray);
+    spec.items = std::make_shared<SchemaSpec>(std::move(itemSpec));
+    return spec;
+}
+
+SchemaSpec& SchemaSpec::property(const std::string& name, SchemaSpec spec, bool isRequired) {
+    properties.emplace_back(name, std::move(spec));
+    if (isRequired) {
+        required.push_back(name);
+    }
+    return *this;
+}
+
+SchemaSpec& SchemaSpec::range(double min, double max, bool minInclusive, bool maxInclusive) {
+    minimum = min;
+    maximum = max;
+    exclusiveMinimum = !minInclusive;
+    exclusiveMaximum = !maxInclusive;
+    return *this;
+}
+
+SchemaSpec& SchemaSpec::atLeast(double min, bool inclusive) {
+    minimum = min;
+    exclusiveMinimum = !inclusive;
+    return *this;
+}
+
+SchemaSpec& SchemaSpec::length(size_t minLen, size_t maxLen) {
+    minLength = minLen;
+    maxLength = maxLen;
+    return *this;
+}
+
+// =============================================================================
+// CompiledSchema
+// =============================================================================
+
+std::shared_ptr<const CompiledSchema> CompiledSchema::compile(const SchemaSpec& spec) {
+    std::shared_ptr<CompiledSchema> schema(new CompiledSchema());
+    schema->states.emplace_back();  // kAnyState
+    schema->root = schema->compileNode(spec);
+    return schema;
+}
+
+uint32_t CompiledSchema::compileNode(const SchemaSpec& spec) {
+    const auto index = static_cast<uint32_t>(states.size());
+    states.emplace_back();
+
+    {
+        State& s = states[index];
+        s.types = spec.types;
+        s.hasMinimum = spec.minimum.has_value();
+        s.hasMaximum = spec.maximum.has_value();
+        s.minimum = spec.minimum.value_or(0.0);
+        s.maximum = spec.maximum.value_or(0.0);
+        s.exclusiveMinimum = spec.exclusiveMinimum;
+        s.exclusiveMaximum = spec.exclusiveMaximum;
+        s.minLength = spec.minLength;
+        s.maxLength = spec.maxLength;
+        s.format = spec.format;
+        s.additionalProperties = spec.additionalProperties;
+        s.minItems = spec.minItems;
+        s.maxItems = spec.maxItems;
+        s.message = spec.message;
+
+        if (!spec.stringEnum.empty()) {
+            s.firstEnum = static_cast<uint32_t>(stringEnums.size());
+            s.enumCount = static_cast<uint32_t>(spec.stringEnum.size());
+            stringEnums.insert(stringEnums.end(), spec.stringEnum.begin(), spec.stringEnum.end());
+        } else if (!spec.numberEnum.empty()) {
+            s.firstEnum = static_cast<uint32_t>(numberEnums.size());
+            s.enumCount = static_cast<uint32_t>(spec.numberEnum.size());
+            numberEnums.insert(numberEnums.end(), spec.numberEnum.begin(), spec.numberEnum.end());
+        }
+    }
+
+    // Children are compiled first; "states" may reallocate, so the parent is
+    // re-fetched by index afterwards.
+    std::vector<Transition> edges;
+    edges.reserve(spec.properties.size() + spec.required.size());
+    for (const auto& [name, child] : spec.properties) {
+        Transition t;
+        t.key = name;
+        t.target = compileNode(child);
+        edges.push_back(std::move(t));
+    }
+
+    if (spec.required.size() > 64) {
+        throw std::invalid_argument("CompiledSchema: more than 64 required properties");
+    }
+
+    uint64_t requiredMask = 0;
+    for (size_t bit = 0; bit < spec.required.size(); ++bit) {
+        const auto& name = spec.required[bit];
+        auto it = std::find_if(edges.begin(), edges.end(),
+                               [&](const Transition& t) { return t.key == name; });
+        if (it == edges.end()) {
+            // Required but otherwise unconstrained
+            Transition t;
+            t.key = name;
+            edges.push_back(std::move(t));
+            it = edges.end() - 1;
+        }
+        it->requiredBit = static_cast<uint8_t>(bit);
+        requiredMask |= (uint64_t{1} << bit);
+    }
+
+    std::sort(edges.begin(), edges.end(),
+              [](const Transition& a, const Transition& b) { return a.key < b.key; });
+
+    const uint32_t itemState = spec.items ? compileNode(*spec.items) : kAnyState;
+
+    State& s = states[index];
+    s.firstTransition = static_cast<uint32_t>(transitions.size());
+    s.transitionCount = static_cast<uint32_t>(edges.size());
+    s.requiredMask = requiredMask;
+    s.itemState = itemState;
+    transitions.insert(transitions.end(),
+                       std::make_move_iterator(edges.begin()),
+                       std::make_move_iterator(edges.end()));
+    return index;
+}
+
+const CompiledSchema::Transition* CompiledSchema::findTransition(const State& objectState,
+                                                                 std::string_view key) const {
+    const auto first = transitions.begin() + objectState.firstTransition;
+    const auto last = first + objectState.transitionCount;
+    auto it = std::lower_bound(first, last, key,
+                               [](const Transition& t, std::string_view k) { return t.key < k; });
+    if (it != last && it->key == key) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+const std::string& CompiledSchema::requiredName(const State& objectState, uint8_t bit) const {
+    for (uint32_t i = 0; i < objectState.transitionCount; ++i) {
+        const auto& t = transitions[objectState.firstTransition + i];
+        if (t.requiredBit == bit) {
+            return t.key;
+        }
+    }
+    static const std::string unknown;
+    return unknown;
+}
+
+bool CompiledSchema::matchesStringEnum(const State& s, std::string_view value) const {
+    for (uint32_t i = 0; i < s.enumCount; ++i) {
+        if (stringEnums[s.firstEnum + i] == value) return true;
+    }
+    return false;
+}
+
+bool CompiledSchema::matchesNumberEnum(const State& s, double value) const {
+    for (uint32_t i = 0; i < s.enumCount; ++i) {
+        if (numberEnums[s.firstEnum + i] == value) return true;
+    }
+    return false;
+}
+
+// =============================================================================
+// JSON Pointer
+// =============================================================================
+
+void appendJsonPointerToken(std::string& pointer, std::string_view token) {
+    pointer += '/';
+    for (char c : token) {
+        if (c == '~') pointer += "~0";
+        else if (c == '/') pointer += "~1";
+        else pointer += c;
+    }
+}
+
+// =============================================================================
+// StreamingValidator - Reporting
+// =============================================================================
+
+std::string StreamingValidator::currentPointer(bool includeLastToken) const {
+    std::string pointer;
+    const size_t depth = includeLastToken ? stack.size() : (stack.empty() ? 0 : stack.size() - 1);
+    for (size_t i = 0; i < depth; ++i) {
+        const Frame& f = stack[i];
+        if (f.isArray) {
+            appendJsonPointerToken(pointer, std::to_string(f.index));
+        } else {
+            // Keys are kept raw; decoding is only needed for the rare escaped key
+            std::string key;
+            for (size_t k = 0; k < f.key.size(); ++k) {
+                if (f.key[k] == '\\' && k + 1 < f.key.size()) {
+                    ++k;
+                }
+                key += f.key[k];
+            }
+            appendJsonPointerToken(pointer, key);
+        }
+    }
+    return pointer;
+}
+
+void StreamingValidator::report(const std::string& message, std::string_view value) {
+    if (limitReached) return;
+    std::optional<std::string> v;
+    if (!value.empty()) {
+        v = std::string(value);
+    }
+    errors.emplace_back(currentPointer(), message, v);
+    if (errors.size() >= options.maxErrors) {
+        limitReached = true;
+    }
+}
+
+void StreamingValidator::reportMissing(const CompiledSchema::State& objectState, uint64_t missing,
+                                       const CompiledSchema& schema) {
+    for (uint8_t bit = 0; bit < 64 && missing != 0 && !limitReached; ++bit) {
+        if ((missing & (uint64_t{1} << bit)) == 0) continue;
+        missing &= ~(uint64_t{1} << bit);
+
+        const std::string& name = schema.requiredName(objectState, bit);
+        std::string pointer = currentPointer(false);
+        appendJsonPointerToken(pointer, name);
+        errors.emplace_back(pointer, name + " is required");
+        if (errors.size() >= options.maxErrors) {
+            limitReached = true;
+        }
+    }
+}
+
+bool StreamingValidator::fail(const std::string& message) {
+    syntaxError = true;
+    std::string pointer = currentPointer();
+    errors.emplace_back(pointer.empty() ? "root" : pointer,
+                        "Invalid JSON format: " + message + " at offset " + std::to_string(pos));
+    return false;
+}
+
+ValidationResult<std::string> StreamingValidator::toResult(const std::string& json) const {
+    if (errors.empty()) {
+        return ValidationResult<std::string>::success(json);
+    }
+    const auto& first = errors.front();
+    return ValidationResult<std::string>::error(first.fieldPath, first.message, first.value);
+}
+
+// =============================================================================
+// StreamingValidator - Tokenizer
+// =============================================================================
+
+void StreamingValidator::skipWhitespace() {
+    while (pos < text.size()) {
+        const char c = text[pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+        ++pos;
+    }
+}
+
+bool StreamingValidator::scanString(std::string_view& raw, bool& hasEscapes, size_t& codePoints) {
+    // Precondition: text[pos] == '"'
+    const size_t start = ++pos;
+    hasEscapes = false;
+    codePoints = 0;
+
+    while (pos < text.size()) {
+        const auto c = static_cast<unsigned char>(text[pos]);
+        if (c == '"') {
+            raw = text.substr(start, pos - start);
+            ++pos;
+            return true;
+        }
+        if (c < 0x20) {
+            return fail("control character in string");
+        }
+        if (c == '\\') {
+            hasEscapes = true;
+            if (++pos >= text.size()) break;
+            const char e = text[pos];
+            if (e == 'u') {
+                if (pos + 4 >= text.size() || !isHexDigit(text[pos + 1]) || !isHexDigit(text[pos + 2]) ||
+                    !isHexDigit(text[pos + 3]) || !isHexDigit(text[pos + 4])) {
+                    return fail("invalid unicode escape");
+                }
+                pos += 4;
+            } else if (e != '"' && e != '\\' && e != '/' && e != 'b' && e != 'f' &&
+                       e != 'n' && e != 'r' && e != 't') {
+                return fail("invalid escape sequence");
+            }
+            ++codePoints;
+            ++pos;
+            continue;
+        }
+        // Count UTF-8 lead bytes only
+        if ((c & 0xC0) != 0x80) {
+            ++codePoints;
+        }
+        ++pos;
+    }
+    return fail("unterminated string");
+}
+
+std::string_view StreamingValidator::decodeString(std::string_view raw, bool hasEscapes) {
+    if (!hasEscapes) {
+        return raw;
+    }
+
+    scratch.clear();
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] != '\\') {
+            scratch += raw[i];
+            continue;
+        }
+        const char e = raw[++i];
+        switch (e) {
+            case 'b': scratch += '\b'; break;
+            case 'f': scratch += '\f'; break;
+            case 'n': scratch += '\n'; break;
+            case 'r': scratch += '\r'; break;
+            case 't': scratch += '\t'; break;
+            case 'u': {
+                const unsigned long cp = std::strtoul(std::string(raw.substr(i + 1, 4)).c_str(), nullptr, 16);
+                i += 4;
+                // Encode BMP code point as UTF-8 (surrogates are kept as-is)
+                if (cp < 0x80) {
+                    scratch += static_cast<char>(cp);
+                } else if (cp < 0x800) {
+                    scratch += static_cast<char>(0xC0 | (cp >> 6));
+                    scratch += static_cast<char>(0x80 | (cp & 0x3F));
+                } else {
+                    scratch += static_cast<char>(0xE0 | (cp >> 12));
+                    scratch += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    scratch += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+                break;
+            }
+            default: scratch += e; break;
+        }
+    }
+    return scratch;
+}
+
+bool StreamingValidator::scanNumber(std::string_view& token, bool& isInteger) {
+    const size_t start = pos;
+    isInteger = true;
+
+    if (text[pos] == '-') ++pos;
+    if (pos >= text.size()) return fail("invalid number");
+
+    if (text[pos] == '0') {
+        ++pos;
+    } else if (isDigit(text[pos])) {
+        while (pos < text.size() && isDigit(text[pos])) ++pos;
+    } else {
+        return fail("invalid number");
+    }
+
+    if (pos < text.size() && text[pos] == '.') {
+        isInteger = false;
+        ++pos;
+        if (pos >= text.size() || !isDigit(text[pos])) return fail("invalid number");
+        while (pos < text.size() && isDigit(text[pos])) ++pos;
+    }
+
+    if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        isInteger = false;
+        ++pos;
+        if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) ++pos;
+        if (pos >= text.size() || !isDigit(text[pos])) return fail("invalid number");
+        while (pos < text.size() && isDigit(text[pos])) ++pos;
+    }
+
+    token = text.substr(start, pos - start);
+    return true;
+}
+
+// =============================================================================
+// StreamingValidator - Constraint Checks
+// =============================================================================
+
+void StreamingValidator::validateType(const CompiledSchema::State& s, uint8_t actualType,
+                                      std::string_view value) {
+    if ((s.types & actualType) != 0) return;
+
+    if (!s.message.empty()) {
+        report(s.message, value);
+        return;
+    }
+
+    static const char* names[] = { "null", "boolean", "integer", "number", "string", "array", "object" };
+    std::string expected;
+    for (int bit = 0; bit < 7; ++bit) {
+        if ((s.types & (1 << bit)) == 0) continue;
+        if (bit == 2 && (s.types & kJsonNumber)) continue;   // "number" already covers integer
+        if (!expected.empty()) expected += " or ";
+        expected += names[bit];
+    }
+    report("Expected " + expected, value);
+}
+
+void StreamingValidator::validateString(const CompiledSchema& schema, const CompiledSchema::State& s,
+                                        std::string_view raw, bool hasEscapes, size_t codePoints) {
+    if ((s.types & kJsonString) == 0) {
+        validateType(s, kJsonString, raw);
+        return;
+    }
+
+    const auto& msg = s.message;
+    if (codePoints < s.minLength) {
+        report(msg.empty() ? "String must be at least " + std::to_string(s.minLength) + " characters" : msg, raw);
+        return;
+    }
+    if (codePoints > s.maxLength) {
+        report(msg.empty() ? "String must be at most " + std::to_string(s.maxLength) + " characters" : msg, raw);
+        return;
+    }
+
+    if (s.format == StringFormat::None && s.enumCount == 0) {
+        return;
+    }
+
+    const std::string_view value = decodeString(raw, hasEscapes);
+
+    if (s.format == StringFormat::UUID && !isUUIDFast(value)) {
+        report(msg.empty() ? "Must be a valid UUID" : msg, value);
+        return;
+    }
+    if (s.format == StringFormat::DateTime && !isDateTimeFast(value)) {
+        report(msg.empty() ? "Must be a valid ISO 8601 date-time string" : msg, value);
+        return;
+    }
+    if (s.enumCount > 0 && !schema.matchesStringEnum(s, value)) {
+        report(msg.empty() ? "Value is not one of the allowed values" : msg, value);
+    }
+}
+
+void StreamingValidator::validateNumber(const CompiledSchema& schema, const CompiledSchema::State& s,
+                                        std::string_view token, bool isInteger) {
+    if ((s.types & (kJsonNumber | kJsonInteger)) == 0) {
+        validateType(s, kJsonNumber, token);
+        return;
+    }
+
+    char buffer[64];
+    double value = 0.0;
+    if (token.size() < sizeof(buffer)) {
+        std::copy(token.begin(), token.end(), buffer);
+        buffer[token.size()] = '\0';
+        value = std::strtod(buffer, nullptr);
+    } else {
+        value = std::strtod(std::string(token).c_str(), nullptr);
+    }
+
+    // JSON Schema treats 2.0 as an integer
+    if (!isInteger && std::isfinite(value) && std::floor(value) == value) {
+        isInteger = true;
+    }
+
+    if (!isInteger && (s.types & kJsonNumber) == 0) {
+        validateType(s, kJsonNumber, token);
+        return;
+    }
+
+    bool valid = true;
+    if (s.hasMinimum) {
+        valid = s.exclusiveMinimum ? value > s.minimum : value >= s.minimum;
+    }
+    if (valid && s.hasMaximum) {
+        valid = s.exclusiveMaximum ? value < s.maximum : value <= s.maximum;
+    }
+
+    if (!valid) {
+        if (!s.message.empty()) {
+            report(s.message, token);
+        } else if (s.hasMinimum && s.hasMaximum) {
+            std::string m = "Number must be between " + formatNumber(s.minimum) +
+                            " and " + formatNumber(s.maximum);
+            if (s.exclusiveMinimum) m += " (exclusive minimum)";
+            if (s.exclusiveMaximum) m += " (exclusive maximum)";
+            report(m, token);
+        } else if (s.hasMinimum) {
+            report(std::string("Number must be ") + (s.exclusiveMinimum ? "greater than " : "at least ") +
+                   formatNumber(s.minimum), token);
+        } else {
+            report(std::string("Number must be ") + (s.exclusiveMaximum ? "less than " : "at most ") +
+                   formatNumber(s.maximum), token);
+        }
+        return;
+    }
+
+    if (s.enumCount > 0 && !schema.matchesNumberEnum(s, value)) {
+        report(s.message.empty() ? "Value is not one of the allowed values" : s.message, token);
+    }
+}
+
+// =============================================================================
+// StreamingValidator - Driver
+// =============================================================================
+
+bool StreamingValidator::beginObjectMember(const CompiledSchema& schema, uint32_t& nextState) {
+    skipWhitespace();
+    if (pos >= text.size() || text[pos] != '"') {
+        return fail("expected property name");
+    }
+
+    std::string_view rawKey;
+    bool hasEscapes = false;
+    size_t codePoints = 0;
+    if (!scanString(rawKey, hasEscapes, codePoints)) {
+        return false;
+    }
+
+    skipWhitespace();
+    if (pos >= text.size() || text[pos] != ':') {
+        return fail("expected ':'");
+    }
+    ++pos;
+
+    Frame& frame = stack.back();
+    frame.key = rawKey;
+
+    const auto& objectState = schema.state(frame.state);
+    const auto* transition = schema.findTransition(objectState, decodeString(rawKey, hasEscapes));
+    if (transition != nullptr) {
+        nextState = transition->target;
+        if (transition->requiredBit != CompiledSchema::kNoRequiredBit) {
+            frame.seenRequired |= (uint64_t{1} << transition->requiredBit);
+        }
+    } else {
+        nextState = CompiledSchema::kAnyState;
+        if (!objectState.additionalProperties) {
+            report("Unexpected property");
+        }
+    }
+    return true;
+}
+
+bool StreamingValidator::validate(std::string_view json, const CompiledSchema& schema) {
+    text = json;
+    pos = 0;
+    syntaxError = false;
+    limitReached = false;
+    stack.clear();
+    errors.clear();
+
+    uint32_t pending = schema.rootState();
+    bool expectValue = true;
+
+    while (true) {
+        if (expectValue) {
+            skipWhitespace();
+            if (pos >= text.size()) {
+                return fail("unexpected end of input");
+            }
+
+            const auto& s = schema.state(pending);
+            const char c = text[pos];
+
+            if (c == '{' || c == '[') {
+                const bool isArray = (c == '[');
+                validateType(s, isArray ? kJsonArray : kJsonObject, {});
+                if (stack.size() >= options.maxDepth) {
+                    return fail("maximum nesting depth exceeded");
+                }
+
+                Frame frame;
+                // On a type mismatch the contents are still parsed, but not validated
+                const bool typeOk = (s.types & (isArray ? kJsonArray : kJsonObject)) != 0;
+                frame.state = typeOk ? pending : CompiledSchema::kAnyState;
+                frame.isArray = isArray;
+                stack.push_back(frame);
+                ++pos;
+
+                skipWhitespace();
+                if (pos < text.size() && text[pos] == (isArray ? ']' : '}')) {
+                    // Empty container: close immediately
+                    expectValue = false;
+                    continue;
+                }
+
+                if (isArray) {
+                    stack.back().hasElements = true;
+                    pending = schema.state(stack.back().state).itemState;
+                } else if (!beginObjectMember(schema, pending)) {
+                    return false;
+                }
+                continue;
+            }
+
+            if (c == '"') {
+                std::string_view raw;
+                bool hasEscapes = false;
+                size_t codePoints = 0;
+                if (!scanString(raw, hasEscapes, codePoints)) return false;
+                validateString(schema, s, raw, hasEscapes, codePoints);
+            } else if (c == '-' || isDigit(c)) {
+                std::string_view token;
+                bool isInteger = false;
+                if (!scanNumber(token, isInteger)) return false;
+                validateNumber(schema, s, token, isInteger);
+            } else if (text.substr(pos, 4) == "true" || text.substr(pos, 5) == "false") {
+                const size_t len = (c == 't') ? 4 : 5;
+                validateType(s, kJsonBoolean, text.substr(pos, len));
+                pos += len;
+            } else if (text.substr(pos, 4) == "null") {
+                validateType(s, kJsonNull, "null");
+                pos += 4;
+            } else {
+                return fail("unexpected character");
+            }
+
+            expectValue = false;
+        }
+
+        // After a complete value
+        if (stack.empty()) {
+            skipWhitespace();
+            if (pos != text.size()) {
+                return fail("unexpected trailing characters");
+            }
+            break;
+        }
+
+        skipWhitespace();
+        if (pos >= text.size()) {
+            return fail("unexpected end of input");
+        }
+
+        Frame& frame = stack.back();
+        const char c = text[pos];
+
+        if (c == ',') {
+            ++pos;
+            if (frame.isArray) {
+                ++frame.index;
+                pending = schema.state(frame.state).itemState;
+            } else if (!beginObjectMember(schema, pending)) {
+                return false;
+            }
+            expectValue = true;
+            continue;
+        }
+
+        if (c == (frame.isArray ? ']' : '}')) {
+            ++pos;
+            const auto& s = schema.state(frame.state);
+            if (frame.isArray) {
+                const size_t count = frame.hasElements ? frame.index + 1 : 0;
+                if (count < s.minItems || count > s.maxItems) {
+                    // Report against the array itself, not its last element
+                    stack.pop_back();
+                    report(s.message.empty() ? "Array must contain between " + std::to_string(s.minItems) +
+                                                   " and " + std::to_string(s.maxItems) + " items"
+                                             : s.message);
+                    continue;
+                }
+            } else {
+                const uint64_t missing = s.requiredMask & ~frame.seenRequired;
+                if (missing != 0) {
+                    reportMissing(s, missing, schema);
+                }
+            }
+            stack.pop_back();
+            continue;
+        }
+
+        return fail(frame.isArray ? "expected ',' or ']'" : "expected ',' or '}'");
+    }
+
+    return errors.empty();
+}
+
+// =============================================================================
+// Model Schemas
+// =============================================================================
+
+namespace {
+
+SchemaSpec uuid() {
+    return SchemaSpec::string().withFormat(StringFormat::UUID).withMessage("ID must be a valid UUID");
+}
+
+SchemaSpec timestamp(const std::string& field) {
+    return SchemaSpec::number().atLeast(0.0).withMessage(field + " must be a non-negative number");
+}
+
+SchemaSpec version(const std::string& expected) {
+    // validateVersion() also accepts the major-only form ("1" for "1.0")
+    std::vector<std::string> accepted { expected };
+    const auto major = expected.substr(0, expected.find_first_of('.'));
+    if (major != expected) accepted.push_back(major);
+    return SchemaSpec::string().oneOf(accepted).withMessage("Version must be \"" + expected + "\"");
+}
+
+SchemaSpec buildSchillingerSongSpec() {
+    return SchemaSpec::object()
+        .property("version", version("1.0"), true)
+        .property("id", uuid(), true)
+        .property("createdAt", timestamp("createdAt"), true)
+        .property("modifiedAt", timestamp("modifiedAt"), true)
+        .property("author", SchemaSpec::string().length(1, std::numeric_limits<size_t>::max())
+                                .withMessage("author must be a non-empty string"), true)
+        .property("name", SchemaSpec::string().length(1, 256), true)
+        .property("seed", SchemaSpec::integer().range(0.0, 4294967295.0), true)
+        .property("ensemble", SchemaSpec::object(), true)
+        .property("bindings", SchemaSpec::object(), true)
+        .property("constraints", SchemaSpec::object(), true)
+        .property("console", SchemaSpec::object(), true)
+        .property("book4", SchemaSpec::object(), true);
+}
+
+SchemaSpec buildSongModelSpec() {
+    return SchemaSpec::object()
+        .property("version", version("1.0"), true)
+        .property("id", uuid(), true)
+        .property("sourceSongId", uuid(), true)
+        .property("derivationId", uuid(), true)
+        .property("duration", timestamp("duration"), true)
+        .property("tempo", SchemaSpec::number().range(0.0, 500.0, false, true), true)
+        .property("timeSignature", SchemaSpec::array(SchemaSpec::number()))
+        .property("sampleRate", SchemaSpec::number().oneOf(std::vector<double>{ 44100.0, 48000.0, 96000.0 })
+                                    .withMessage("sampleRate must be 44100, 48000, or 96000"), true)
+        .property("timeline", SchemaSpec::object(), true)
+        .property("notes", SchemaSpec::array(), true)
+        .property("voiceAssignments", SchemaSpec::array(), true)
+        .property("console", SchemaSpec::object(), true)
+        .property("derivedAt", timestamp("derivedAt"), true)
+        .property("activePerformanceId", SchemaSpec::string().withFormat(StringFormat::UUID)
+                                             .withMessage("activePerformanceId must be a valid UUID"));
+}
+
+SchemaSpec buildPerformanceStateSpec() {
+    const std::vector<std::string> styles = {
+        "SOLO_PIANO", "SATB", "CHAMBER_ENSEMBLE", "FULL_ORCHESTRA",
+        "JAZZ_COMBO", "JAZZ_TRIO", "ROCK_BAND", "AMBIENT_TECHNO",
+        "ELECTRONIC", "ACAPPELLA", "STRING_QUARTET", "CUSTOM"
+    };
+
+    std::string styleList;
+    for (const auto& style : styles) {
+        if (!styleList.empty()) styleList += ", ";
+        styleList += style;
+    }
+
+    const auto nonEmpty = [](const std::string& field) {
+        return SchemaSpec::string().length(1, std::numeric_limits<size_t>::max())
+            .withMessage(field + " must be a non-empty string");
+    };
+    const auto dateTime = [](const std::string& field) {
+        return SchemaSpec::string().withFormat(StringFormat::DateTime)
+            .withMessage(field + " must be a valid ISO 8601 date-time string");
+    };
+
+    return SchemaSpec::object()
+        .property("version", SchemaSpec::string().oneOf(std::vector<std::string>{ "1" })
+                                 .withMessage("Version must be \"1\""), true)
+        .property("id", uuid(), true)
+        .property("name", SchemaSpec::string().length(1, 256), true)
+        .property("arrangementStyle", SchemaSpec::string().oneOf(styles)
+                                          .withMessage("arrangementStyle must be one of: " + styleList), true)
+        .property("density", SchemaSpec::number().range(0.0, 1.0))
+        .property("grooveProfileId", nonEmpty("grooveProfileId"))
+        .property("consoleXProfileId", nonEmpty("consoleXProfileId"))
+        .property("instrumentationMap", SchemaSpec::object())
+        .property("mixTargets", SchemaSpec::object())
+        .property("createdAt", dateTime("createdAt"))
+        .property("modifiedAt", dateTime("modifiedAt"));
+}
+
+} // namespace
+
+const CompiledSchema& getCompiledSchema(ModelSchema model) {
+    // Compiled exactly once; function-local statics are thread-safe to initialise
+    static const auto song = CompiledSchema::compile(buildSchillingerSongSpec());
+    static const auto songModel = CompiledSchema::compile(buildSongModelSpec());
+    static const auto performance = CompiledSchema::compile(buildPerformanceStateSpec());
+
+    switch (model) {
+        case ModelSchema::SchillingerSong_v1:  return *song;
+        case ModelSchema::SongModel_v1:        return *songModel;
+        case ModelSchema::PerformanceState_v1: return *performance;
+    }
+    return *song;
+}
+
+std::optional<ModelSchema> modelSchemaFromName(std::string_view name) {
+    if (name == "SchillingerSong_v1") return ModelSchema::SchillingerSong_v1;
+    if (name == "SongModel_v1") return ModelSchema::SongModel_v1;
+    if (name == "PerformanceState_v1") return ModelSchema::PerformanceState_v1;
+    return std::nullopt;
+}
+
+const CompiledSchema& getPermissiveSchema() {
+    static const auto permissive = CompiledSchema::compile(SchemaSpec::any());
+    return *permissive;
+}
+
+} // namespace validation
+} // namespace white_room
@@ -0,0 +1,344 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "../../routing/AnticipativeRenderer.h"
+
+using namespace SchillingerEcosystem::Routing;
+
+class AnticipativeRendererTest : public ::testing::Test {
+protected:
+    static constexpr int blockSize = 64;
+
+    // Output is a function of the timeline position, so any misplaced,
+    // stale or repeated sample shows up against the reference
+    static float expected(int track, juce::int64 position, int channel, float gain) {
+        return gain * std::sin(0.013f * static_cast<float>(position) * static_cast<float>(track + 1))
+             + 0.001f * static_cast<float>(channel);
+    }
+
+    struct TrackProbe {
+        std::atomic<float> gain { 1.0f };
+        std::atomic<int> inFlight { 0 };
+        std::atomic<int> overlaps { 0 };
+        std::atomic<int> liveMidiCalls { 0 };
+    };
+
+    static AnticipativeRenderer::RenderFunction makeTrack(int index, TrackProbe& probe) {
+        return [index, &probe](juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi, juce::int64 start) {
+            if (probe.inFlight.fetch_add(1) != 0)
+                probe.overlaps.fetch_add(1);
+
+            const float gain = probe.gain.load();
+            for (int c = 0; c < buffer.getNumChannels(); ++c)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.getWritePointer(c)[i] = expected(index, start + i, c, gain);
+
+            if (midi.getNumEvents() > 0)
+                probe.liveMidiCalls.fetch_add(1);
+
+            probe.inFlight.fetch_sub(1);
+        };
+    }
+
+    // Like a realtime callback that the workers keep up with
+    static void waitForAhead(AnticipativeRenderer& renderer, AnticipativeRenderer::TrackId track, int samples) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (renderer.getSamplesAhead(track) < samples && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    static bool blockMatches(const juce::AudioBuffer<float>& block, int track, juce::int64 start, float gain) {
+        for (int c = 0; c < block.getNumChannels(); ++c)
+            for (int i = 0; i < block.getNumSamples(); ++i)
+                if (std::abs(block.getReadPointer(c)[i] - expected(track, start + i, c, gain)) > 1.0e-6f)
+                    return false;
+        return true;
+    }
+};
+
+TEST_F(AnticipativeRendererTest, RendersAheadInChunksAndCallbackOnlyCopies) {
+    TrackProbe probe;   // Outlives the renderer's workers
+    AnticipativeRenderer renderer;
+    const auto track = renderer.addTrack(2, makeTrack(0, probe));
+    ASSERT_NE(track, AnticipativeRenderer::invalidTrack);
+
+    renderer.prepare(48000.0, blockSize, { 1024, 8192, 1 });
+
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+
+    for (juce::int64 position = 0; position < 48000; position += blockSize) {
+        waitForAhead(renderer, track, blockSize);
+        block.clear();
+        ASSERT_TRUE(renderer.process(track, block, position, blockSize, midi));
+        ASSERT_TRUE(blockMatches(block, 0, position, 1.0f)) << "block at " << position;
+    }
+
+    EXPECT_EQ(renderer.getNumUnderruns(), 0u);
+    EXPECT_GE(renderer.getNumChunksRendered(), 48000u / 1024u - 1u);
+    EXPECT_LE(renderer.getNumCallbackRenders(), 1u);   // Only the very first block, before any chunk
+    EXPECT_EQ(probe.overlaps.load(), 0);
+}
+
+TEST_F(AnticipativeRendererTest, JumpsRestartTheRingAtTheNewPosition) {
+    TrackProbe probe;
+    AnticipativeRenderer renderer;
+    const auto track = renderer.addTrack(1, makeTrack(1, probe));
+    renderer.prepare(48000.0, blockSize, { 512, 4096, 1 });
+
+    juce::AudioBuffer<float> block(1, blockSize);
+    juce::MidiBuffer midi;
+    const juce::int64 jumps[] = { 0, 100000, 3000, 3000 + 37, 250 };
+    int blocksChecked = 0;
+
+    for (auto jump : jumps) {
+        for (int b = 0; b < 40; ++b) {
+            const juce::int64 position = jump + b * blockSize;
+            block.clear();
+            if (renderer.process(track, block, position, blockSize, midi)) {
+                ASSERT_TRUE(blockMatches(block, 1, position, 1.0f)) << "block at " << position;
+                ++blocksChecked;
+            }
+            waitForAhead(renderer, track, blockSize);
+        }
+    }
+
+    // Only the first block from each position can be silent: a worker was
+    // still busy with the track
+    EXPECT_LE(renderer.getNumUnderruns(), 5u);
+    EXPECT_GE(blocksChecked, 200 - 5);
+    EXPECT_EQ(probe.overlaps.load(), 0);
+}
+
+TEST_F(AnticipativeRendererTest, LoopPassesPlayFromTheRing) {
+    TrackProbe probe;
+    AnticipativeRenderer renderer;
+    const auto track = renderer.addTrack(2, makeTrack(4, probe));
+    renderer.prepare(48000.0, blockSize, { 512, 8192, 1 });
+
+    // Not a multiple of the block size, so blocks straddle the wrap
+    const juce::int64 loopStart = 1000, loopEnd = 1000 + 40 * blockSize + 17;
+    renderer.setLoop(loopStart, loopEnd);
+
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+    juce::int64 playhead = 0;
+
+    for (int b = 0; b < 400; ++b) {
+        if (b > 0)
+            waitForAhead(renderer, track, blockSize);
+
+        // The first block takes the loop: a jump like any other
+        block.clear();
+        const bool complete = renderer.process(track, block, playhead, blockSize, midi);
+        ASSERT_TRUE(complete || b == 0);
+
+        for (int i = 0; complete && i < blockSize; ++i) {
+            juce::int64 position = playhead + i;
+            if (position >= loopEnd)
+                position -= loopEnd - loopStart;
+            ASSERT_NEAR(block.getReadPointer(1)[i], expected(4, position, 1, 1.0f), 1.0e-6f) << "block " << b;
+        }
+
+        playhead += blockSize;
+        if (playhead >= loopEnd)
+            playhead -= loopEnd - loopStart;
+    }
+
+    // Loop passes never fall back to the callback
+    EXPECT_LE(renderer.getNumCallbackRenders() + renderer.getNumUnderruns(), 1u);
+    EXPECT_EQ(probe.overlaps.load(), 0);
+}
+
+TEST_F(AnticipativeRendererTest, InvalidateRerendersWhatIsAhead) {
+    TrackProbe probe;
+    AnticipativeRenderer renderer;
+    const auto track = renderer.addTrack(2, makeTrack(2, probe));
+    renderer.prepare(48000.0, blockSize, { 256, 8192, 1 });
+
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+    juce::int64 position = 0;
+
+    // Fill the ring completely at the old gain
+    for (; position < 4096; position += blockSize) {
+        waitForAhead(renderer, track, blockSize);
+        block.clear();
+        renderer.process(track, block, position, blockSize, midi);
+    }
+    waitForAhead(renderer, track, 8192 - 256);
+
+    probe.gain.store(0.25f);
+    renderer.invalidate(track);
+
+    // One block in flight may still be old; after that the new gain plays
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    block.clear();
+    renderer.process(track, block, position, blockSize, midi);
+    position += blockSize;
+
+    for (int b = 0; b < 100; ++b, position += blockSize) {
+        waitForAhead(renderer, track, blockSize);
+        block.clear();
+        ASSERT_TRUE(renderer.process(track, block, position, blockSize, midi));
+        ASSERT_TRUE(blockMatches(block, 2, position, 0.25f)) << "block at " << position;
+    }
+
+    EXPECT_EQ(probe.overlaps.load(), 0);
+}
+
+// Like an instrument: the output follows the track's own state, not the
+// position it is asked for, so only the reset keeps it in time
+TEST_F(AnticipativeRendererTest, StatefulTracksAreResetToWhereRenderingRestarts) {
+    struct Oscillator {
+        juce::int64 next = 0;
+        std::atomic<int> resets { 0 };
+    } oscillator;
+
+    AnticipativeRenderer renderer;
+    const auto track = renderer.addTrack(1,
+        [&oscillator](juce::AudioBuffer<float>& buffer, juce::MidiBuffer&, juce::int64) {
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.getWritePointer(0)[i] = expected(5, oscillator.next + i, 0, 1.0f);
+            oscillator.next += buffer.getNumSamples();
+        },
+        [&oscillator](juce::int64 position) {
+            oscillator.next = position;
+            oscillator.resets.fetch_add(1);
+        });
+    renderer.prepare(48000.0, blockSize, { 512, 4096, 1 });
+
+    juce::AudioBuffer<float> block(1, blockSize);
+    juce::MidiBuffer midi;
+    juce::int64 position = 0;
+
+    const auto play = [&](int numBlocks) {
+        for (int b = 0; b < numBlocks; ++b, position += blockSize) {
+            waitForAhead(renderer, track, blockSize);
+            block.clear();
+            if (renderer.process(track, block, position, blockSize, midi))
+                ASSERT_TRUE(blockMatches(block, 5, position, 1.0f)) << "block at " << position;
+        }
+    };
+
+    play(100);
+    waitForAhead(renderer, track, 4096 - 512);
+
+    // The state is thousands of samples ahead of the playhead here
+    position = 200000;
+    play(100);
+
+    renderer.invalidate(track);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    play(100);
+
+    EXPECT_GE(oscillator.resets.load(), 3);
+}
+
+TEST_F(AnticipativeRendererTest, RemovingATrackDoesNotWaitForItsChunk) {
+    std::atomic<bool> rendering { false };
+    std::atomic<bool> release { false };
+
+    AnticipativeRenderer renderer;
+    const auto track = renderer.addTrack(1,
+        [&](juce::AudioBuffer<float>&, juce::MidiBuffer&, juce::int64) {
+            rendering.store(true);
+            while (!release.load())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+    renderer.prepare(48000.0, blockSize, { 512, 4096, 1 });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!rendering.load() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_TRUE(rendering.load());
+
+    // The worker is stuck in the chunk; removal returns regardless
+    renderer.removeTrack(track);
+    EXPECT_EQ(renderer.getNumTracks(), 0);
+
+    release.store(true);
+    renderer.release();
+}
+
+TEST_F(AnticipativeRendererTest, LiveTracksRenderInTheCallbackWithLiveMidi) {
+    TrackProbe probe;
+    AnticipativeRenderer renderer;
+    const auto track = renderer.addTrack(2, makeTrack(3, probe));
+    renderer.setLive(track, true);
+    EXPECT_TRUE(renderer.isLive(track));
+    renderer.prepare(48000.0, blockSize, { 1024, 8192, 1 });
+
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0);
+
+    const auto chunksBefore = renderer.getNumChunksRendered();
+    for (juce::int64 position = 0; position < 64 * blockSize; position += blockSize) {
+        block.clear();
+        ASSERT_TRUE(renderer.process(track, block, position, blockSize, midi));
+        ASSERT_TRUE(blockMatches(block, 3, position, 1.0f));
+    }
+
+    EXPECT_EQ(probe.liveMidiCalls.load(), 64);
+    EXPECT_EQ(renderer.getNumChunksRendered(), chunksBefore);
+    EXPECT_EQ(renderer.getSamplesAhead(track), 0);
+
+    // Back to render-ahead from where the live blocks stopped
+    renderer.setLive(track, false);
+    juce::MidiBuffer noMidi;
+    for (juce::int64 position = 64 * blockSize; position < 256 * blockSize; position += blockSize) {
+        waitForAhead(renderer, track, blockSize);
+        block.clear();
+        ASSERT_TRUE(renderer.process(track, block, position, blockSize, noMidi));
+        ASSERT_TRUE(blockMatches(block, 3, position, 1.0f));
+    }
+
+    EXPECT_GT(renderer.getNumChunksRendered(), chunksBefore);
+    EXPECT_EQ(probe.overlaps.load(), 0);
+}
+
+TEST_F(AnticipativeRendererTest, ManyTracksShareTheWorkers) {
+    constexpr int numTracks = 12;
+    std::vector<std::unique_ptr<TrackProbe>> probes;
+    AnticipativeRenderer renderer;
+    std::vector<AnticipativeRenderer::TrackId> ids;
+
+    for (int t = 0; t < numTracks; ++t) {
+        probes.push_back(std::make_unique<TrackProbe>());
+        ids.push_back(renderer.addTrack(2, makeTrack(t, *probes.back())));
+    }
+    EXPECT_EQ(renderer.getNumTracks(), numTracks);
+
+    renderer.prepare(48000.0, blockSize, { 1024, 8192, 3 });
+
+    juce::AudioBuffer<float> mix(2, blockSize);
+    juce::MidiBuffer midi;
+
+    for (juce::int64 position = 0; position < 24000; position += blockSize) {
+        for (auto id : ids)
+            waitForAhead(renderer, id, blockSize);
+
+        mix.clear();
+        for (auto id : ids)
+            ASSERT_TRUE(renderer.process(id, mix, position, blockSize, midi));
+
+        for (int c = 0; c < 2; ++c) {
+            for (int i = 0; i < blockSize; ++i) {
+                float sum = 0.0f;
+                for (int t = 0; t < numTracks; ++t)
+                    sum += expected(t, position + i, c, 1.0f);
+                ASSERT_NEAR(mix.getReadPointer(c)[i], sum, 1.0e-4f);
+            }
+        }
+    }
+
+    renderer.removeTrack(ids[5]);
+    EXPECT_EQ(renderer.getNumTracks(), numTracks - 1);
+
+    for (auto& probe : probes)
+        EXPECT_EQ(probe->overlaps.load(), 0);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "../../engine/automation/AutomationEngine.h"
+
+class AutomationEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        engine.setSampleRate(sampleRate);
+        cutoff = engine.registerParameter(1, "cutoff");
+    }
+
+    // Render totalSamples through blocks of the given sizes (cycled)
+    std::vector<float> render(const std::vector<int>& blockSizes, int64_t totalSamples,
+                              bool looping = false, int64_t loopStart = 0, int64_t loopEnd = 0) {
+        std::vector<float> output;
+        std::vector<float> block(4096);
+        int64_t position = 0;
+        size_t blockIndex = 0;
+
+        while (static_cast<int64_t>(output.size()) < totalSamples) {
+            const int numSamples = static_cast<int>(std::min<int64_t>(
+                blockSizes[blockIndex++ % blockSizes.size()], totalSamples - static_cast<int64_t>(output.size())));
+
+            const AutomationTransport transport { position, numSamples, looping, loopStart, loopEnd };
+            engine.beginBlock(transport);
+            EXPECT_TRUE(engine.renderValues(cutoff, block.data()));
+            engine.endBlock();
+
+            output.insert(output.end(), block.begin(), block.begin() + numSamples);
+            position = transport.getNextPosition();
+        }
+
+        return output;
+    }
+
+    static constexpr double sampleRate = 48000.0;
+    AutomationEngine engine;
+    AutomationParameterId cutoff = AutomationEngine::invalidId;
+};
+
+TEST_F(AutomationEngineTest, ParameterIdsAreStable) {
+    EXPECT_EQ(engine.registerParameter(1, "cutoff"), cutoff);
+    EXPECT_EQ(engine.findParameter(1, "cutoff"), cutoff);
+    EXPECT_EQ(engine.findParameter(2, "cutoff"), AutomationEngine::invalidId);
+    EXPECT_NE(engine.registerParameter(1, "resonance"), cutoff);
+}
+
+TEST_F(AutomationEngineTest, CurvesHitTheirMidpoints) {
+    engine.setLane(cutoff, { { 0.0, 0.1f, AutomationCurve::Exponential },
+                             { 1.0, 1.0f, AutomationCurve::SCurve },
+                             { 2.0, 0.0f, AutomationCurve::Step },
+                             { 3.0, 0.5f, AutomationCurve::Linear },
+                             { 4.0, 1.0f, AutomationCurve::Linear } });
+
+    EXPECT_NEAR(engine.getValueAt(cutoff, 24000), 0.316228f, 1.0e-5f);  // Geometric mean
+    EXPECT_NEAR(engine.getValueAt(cutoff, 72000), 0.5f, 1.0e-5f);
+    EXPECT_FLOAT_EQ(engine.getValueAt(cutoff, 143999), 0.0f);
+    EXPECT_NEAR(engine.getValueAt(cutoff, 168000), 0.75f, 1.0e-5f);
+    EXPECT_FLOAT_EQ(engine.getValueAt(cutoff, 480000), 1.0f);             // Holds the last value
+}
+
+TEST_F(AutomationEngineTest, BlockSizeDoesNotChangeTheRender) {
+    std::vector<AutomationPoint> points;
+    for (int i = 0; i < 2000; ++i) {
+        points.push_back({ i * 0.0031, static_cast<float>(i % 5) / 5.0f + 0.1f, static_cast<AutomationCurve>(i % 4) });
+    }
+    engine.setLane(cutoff, points, 4.0);
+
+    const int64_t total = static_cast<int64_t>(sampleRate) * 10;
+    const auto reference = render({ 512 }, total, true, 48000, 150017);
+    EXPECT_EQ(render({ 1, 7, 333, 4096, 64 }, total, true, 48000, 150017), reference);
+    EXPECT_EQ(render({ 37 }, total, true, 48000, 150017), reference);
+
+    // Rendering matches point evaluation, including across loop wraps
+    int64_t position = 0;
+    for (size_t i = 0; i < reference.size(); i += 101) {
+        position = (i < 150017) ? static_cast<int64_t>(i)
+                                : 48000 + static_cast<int64_t>(i - 150017) % (150017 - 48000);
+        EXPECT_EQ(engine.getValueAt(cutoff, position), reference[i]);
+    }
+}
+
+TEST_F(AutomationEngineTest, LaneSwapTakesEffectOnTheNextBlock) {
+    engine.setLane(cutoff, { { 0.0, 0.25f } });
+    EXPECT_FLOAT_EQ(render({ 256 }, 256).back(), 0.25f);
+
+    engine.setLane(cutoff, { { 0.0, 0.75f } });
+    EXPECT_FLOAT_EQ(render({ 256 }, 256).front(), 0.75f);
+
+    engine.clearLane(cutoff);
+    EXPECT_FALSE(engine.hasLane(cutoff));
+    EXPECT_EQ(engine.collectRetired(), 0u);
+}
+
+TEST_F(AutomationEngineTest, EventsFollowBreakpointsAndGrid) {
+    engine.setLane(cutoff, { { 0.0, 0.0f, AutomationCurve::Step },
+                             { 0.001, 1.0f, AutomationCurve::Linear },
+                             { 0.002, 0.0f, AutomationCurve::Linear } });
+
+    AutomationEvent events[64];
+    engine.beginBlock({ 0, 256, false, 0, 0 });
+    const int numEvents = engine.renderEvents(cutoff, events, 64, 16);
+    engine.endBlock();
+
+    ASSERT_GT(numEvents, 2);
+    EXPECT_EQ(events[0].sampleOffset, 0);
+    EXPECT_FLOAT_EQ(events[0].value, 0.0f);
+    EXPECT_EQ(events[1].sampleOffset, 48);   // Step ends at the first breakpoint
+    EXPECT_FLOAT_EQ(events[1].value, 1.0f);
+    EXPECT_EQ(events[2].sampleOffset, 64);   // Then the 16-sample grid inside the ramp
+    EXPECT_FLOAT_EQ(events[numEvents - 1].value, 0.0f);
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "../../engine/timeline/ClipPlaybackEngine.h"
+
+using SchillingerEcosystem::Timeline::AudioClip;
+using SchillingerEcosystem::Timeline::Core::TimeRange;
+
+class ClipPlaybackEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        engine.prepare(sampleRate, 4096);
+        track = engine.addTrack();
+    }
+
+    static std::shared_ptr<juce::AudioBuffer<float>> constant(float value, int numSamples) {
+        auto buffer = std::make_shared<juce::AudioBuffer<float>>(1, numSamples);
+        std::fill(buffer->getWritePointer(0), buffer->getWritePointer(0) + numSamples, value);
+        return buffer;
+    }
+
+    static std::shared_ptr<juce::AudioBuffer<float>> sine(double frequency, double rate, int numSamples, int numChannels = 1) {
+        auto buffer = std::make_shared<juce::AudioBuffer<float>>(numChannels, numSamples);
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer->getWritePointer(channel)[i] = static_cast<float>(
+                    std::sin(juce::MathConstants<double>::twoPi * frequency * i / rate + channel));
+        return buffer;
+    }
+
+    static AudioClip clipAt(const std::shared_ptr<juce::AudioBuffer<float>>& buffer, double rate, double start) {
+        AudioClip clip("clip", buffer, rate);
+        clip.setPosition(TimeRange(start, start + buffer->getNumSamples() / rate));
+        return clip;
+    }
+
+    // Render one channel of the track through blocks of the given sizes (cycled)
+    std::vector<float> render(const std::vector<int>& blockSizes, int64_t totalSamples, int64_t startSample = 0,
+                              bool looping = false, int64_t loopStart = 0, int64_t loopEnd = 0,
+                              std::chrono::microseconds pace = std::chrono::microseconds(0)) {
+        std::vector<float> output;
+        std::vector<float> left(4096), right(4096);
+        int64_t position = startSample;
+        size_t blockIndex = 0;
+
+        while (static_cast<int64_t>(output.size()) < totalSamples) {
+            const int numSamples = static_cast<int>(std::min<int64_t>(
+                blockSizes[blockIndex++ % blockSizes.size()], totalSamples - static_cast<int64_t>(output.size())));
+
+            std::fill(left.begin(), left.end(), 0.0f);
+            std::fill(right.begin(), right.end(), 0.0f);
+            float* channels[] = { left.data(), right.data() };
+
+            const AutomationTransport transport { position, numSamples, looping, loopStart, loopEnd };
+            engine.beginBlock(transport);
+            engine.renderTrack(track, channels, 2);
+            engine.endBlock();
+
+            output.insert(output.end(), left.begin(), left.begin() + numSamples);
+            position = transport.getNextPosition();
+
+            if (pace.count() > 0)
+                std::this_thread::sleep_for(pace);
+        }
+
+        return output;
+    }
+
+    static constexpr double sampleRate = 48000.0;
+    ClipPlaybackEngine engine;
+    ClipPlaybackEngine::TrackId track = ClipPlaybackEngine::invalidId;
+};
+
+TEST_F(ClipPlaybackEngineTest, ClipsStartAndEndOnTheirSample) {
+    auto clip = clipAt(constant(0.5f, 4800), sampleRate, 0.5);
+    clip.setGain(2.0f);
+    ASSERT_TRUE(engine.setClips(track, { clip }));
+
+    const auto output = render({ 61, 512, 7 }, 48000);
+    EXPECT_FLOAT_EQ(output[23999], 0.0f);
+    EXPECT_FLOAT_EQ(output[24000], 1.0f);
+    EXPECT_FLOAT_EQ(output[28799], 1.0f);
+    EXPECT_FLOAT_EQ(output[28800], 0.0f);
+}
+
+TEST_F(ClipPlaybackEngineTest, SourceRangeTrimsTheClip) {
+    auto buffer = std::make_shared<juce::AudioBuffer<float>>(1, 48000);
+    for (int i = 0; i < 48000; ++i)
+        buffer->getWritePointer(0)[i] = static_cast<float>(i);
+
+    // Source 0.25 s to 0.5 s, placed at 0.1 s for a whole second: plays 0.25 s, then stops
+    AudioClip clip("trimmed", buffer, sampleRate);
+    clip.setSourceRange(TimeRange(0.25, 0.5));
+    clip.setPosition(TimeRange(0.1, 1.1));
+    ASSERT_TRUE(engine.setClips(track, { clip }));
+
+    const auto output = render({ 256 }, 48000);
+    EXPECT_FLOAT_EQ(output[4800], 12000.0f);
+    EXPECT_FLOAT_EQ(output[4800 + 11999], 23999.0f);
+    EXPECT_FLOAT_EQ(output[4800 + 12000], 0.0f);
+}
+
+TEST_F(ClipPlaybackEngineTest, FadesAndOverlapsCrossfadeWithEqualPower) {
+    auto first = clipAt(constant(1.0f, 48000), sampleRate, 0.0);
+    auto second = clipAt(constant(1.0f, 48000), sampleRate, 0.75);
+    first.setFadeIn(0.1, AudioClip::FadeCurve::Linear);
+
+    ASSERT_TRUE(engine.setClips(track, { second, first }));     // Sorted by the engine
+    const auto both = render({ 512 }, 96000);
+
+    // Silencing one clip keeps the fades, so each side of the crossfade can be measured
+    auto silentFirst = first;
+    auto silentSecond = second;
+    silentFirst.setGain(0.0f);
+    silentSecond.setGain(0.0f);
+    engine.setClips(track, { first, silentSecond });
+    const auto a = render({ 512 }, 96000);
+    engine.setClips(track, { silentFirst, second });
+    const auto b = render({ 512 }, 96000);
+
+    EXPECT_FLOAT_EQ(both[0], 0.0f);
+    EXPECT_NEAR(both[2400], 0.5f, 1.0e-6f);
+    EXPECT_FLOAT_EQ(both[4800], 1.0f);
+
+    EXPECT_FLOAT_EQ(a[35999], 1.0f);
+    EXPECT_FLOAT_EQ(b[36000], 0.0f);
+    for (size_t i = 36000; i < 48000; i += 97) {
+        EXPECT_NEAR(a[i] * a[i] + b[i] * b[i], 1.0f, 1.0e-5f) << "at sample " << i;
+        EXPECT_FLOAT_EQ(both[i], a[i] + b[i]);
+    }
+    EXPECT_FLOAT_EQ(a[48000], 0.0f);
+    EXPECT_FLOAT_EQ(both[48000], 1.0f);
+}
+
+TEST_F(ClipPlaybackEngineTest, OtherSampleRatesAreResampled) {
+    // 441 Hz at 44.1 kHz, played at 48 kHz, keeps its pitch and length
+    const double sourceRate = 44100.0;
+    ASSERT_TRUE(engine.setClips(track, { clipAt(sine(441.0, sourceRate, 44100), sourceRate, 0.0) }));
+
+    const auto output = render({ 333 }, 49000);
+    float error = 0.0f;
+    for (int i = 0; i < 48000; ++i)
+        error = std::max(error, std::abs(output[static_cast<size_t>(i)]
+                                         - static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 441.0 * i / sampleRate))));
+
+    EXPECT_LT(error, 1.0e-3f);
+    EXPECT_FLOAT_EQ(output[48500], 0.0f);
+}
+
+TEST_F(ClipPlaybackEngineTest, OutputDoesNotDependOnBlockSize) {
+    std::vector<AudioClip> clips;
+    for (int i = 0; i < 200; ++i) {
+        auto clip = clipAt(sine(100.0 + i, 44100.0, 3000 + 37 * i, 2), 44100.0, i * 0.031);
+        clip.setFadeOut(0.01);
+        clips.push_back(clip);
+    }
+    ASSERT_TRUE(engine.setClips(track, clips));
+    EXPECT_EQ(engine.getNumClips(track), 200);
+
+    const auto reference = render({ 64 }, 6 * 48000, 0, true, 48000, 5 * 48000);
+    EXPECT_EQ(render({ 1, 4096, 333, 17 }, 6 * 48000, 0, true, 48000, 5 * 48000), reference);
+}
+
+TEST_F(ClipPlaybackEngineTest, StreamedClipMatchesInMemoryClip) {
+    const auto buffer = sine(220.0, 44100.0, 3 * 44100, 2);
+
+    juce::TemporaryFile temp(".wav");
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wav.createWriterFor(new juce::FileOutputStream(temp.getFile()), 44100.0, 2, 32, {}, 0));
+        ASSERT_TRUE(writer != nullptr);
+        writer->writeFromAudioSampleBuffer(*buffer, 0, buffer->getNumSamples());
+    }
+
+    AudioClip streamed("streamed", temp.getFile());
+    AudioClip inMemory("memory", buffer, 44100.0);
+    for (auto* clip : { &streamed, &inMemory }) {
+        clip->setSourceRange(TimeRange(0.5, 3.0));
+        clip->setPosition(TimeRange(0.2, 2.7));
+    }
+
+    ASSERT_TRUE(engine.setClips(track, { inMemory }));
+    const auto reference = render({ 512 }, 3 * 48000, 0, true, 24000, 120000);
+
+    ASSERT_TRUE(engine.setClips(track, { streamed }));
+    EXPECT_FALSE(engine.setClips(engine.addTrack(), { AudioClip("missing", juce::File("/nonexistent/missing.wav")) }));
+
+    // Offline: rings are filled on the calling thread, so nothing is missed
+    engine.setNonRealtime(true);
+    EXPECT_EQ(render({ 512 }, 3 * 48000, 0, true, 24000, 120000), reference);
+    EXPECT_EQ(engine.getNumUnderruns(), 0u);
+
+    // Realtime: after a pre-roll the streamer keeps ahead of a paced transport
+    engine.setNonRealtime(false);
+    engine.beginBlock({ 0, 0, true, 24000, 120000 });
+    engine.endBlock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    EXPECT_EQ(render({ 512 }, 3 * 48000, 0, true, 24000, 120000, std::chrono::microseconds(5000)), reference);
+    EXPECT_EQ(engine.getNumUnderruns(), 0u);
+}
+
+TEST_F(ClipPlaybackEngineTest, EditsRetireOldLists) {
+    ASSERT_TRUE(engine.setClips(track, { clipAt(constant(1.0f, 480), sampleRate, 0.0) }));
+
+    engine.beginBlock({ 0, 64 });
+    ASSERT_TRUE(engine.setClips(track, { clipAt(constant(0.5f, 480), sampleRate, 0.0) }));
+    EXPECT_EQ(engine.collectRetired(), 1u);     // The pinned block may still read it
+
+    float left[64] = {}, right[64] = {};
+    float* channels[] = { left, right };
+    engine.renderTrack(track, channels, 2);
+    engine.endBlock();
+    EXPECT_FLOAT_EQ(left[10], 0.5f);            // Loaded after the swap
+
+    // The streamer pins lists too; give a pass in flight time to finish
+    for (int attempt = 0; attempt < 100 && engine.collectRetired() != 0; ++attempt)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(engine.collectRetired(), 0u);
+    engine.clearTrack(track);
+    EXPECT_EQ(engine.getNumClips(track), 0);
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "../../routing/AudioRoutingEngine.h"
+
+using namespace SchillingerEcosystem::Routing;
+
+class MixerBusTest : public ::testing::Test {
+protected:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    // Hard clipper insert: its output level shows whether it ran before or
+    // after the fader
+    class ClipperEffect : public juce::AudioProcessor {
+    public:
+        explicit ClipperEffect(float ceiling) : ceiling(ceiling) {}
+
+        const juce::String getName() const override { return "Clipper"; }
+        void prepareToPlay(double, int) override {}
+        void releaseResources() override {}
+
+        void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+                auto* data = buffer.getWritePointer(channel);
+                for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                    data[i] = juce::jlimit(-ceiling, ceiling, data[i]);
+                }
+            }
+        }
+
+        double getTailLengthSeconds() const override { return 0.0; }
+        bool acceptsMidi() const override { return false; }
+        bool producesMidi() const override { return false; }
+        juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+        bool hasEditor() const override { return false; }
+        int getNumPrograms() override { return 1; }
+        int getCurrentProgram() override { return 0; }
+        void setCurrentProgram(int) override {}
+        const juce::String getProgramName(int) override { return {}; }
+        void changeProgramName(int, const juce::String&) override {}
+        void getStateInformation(juce::MemoryBlock&) override {}
+        void setStateInformation(const void*, int) override {}
+
+    private:
+        float ceiling;
+    };
+
+    static void fill(juce::AudioBuffer<float>& buffer, float value) {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(channel), value, buffer.getNumSamples());
+        }
+    }
+
+    // Reference for the bus kernel: gain at sample i is start + (i + 1) * step
+    static void referenceRamp(std::vector<float>& data, float startGain, float endGain,
+                              float& peak, float& sumOfSquares) {
+        const float step = (endGain - startGain) / static_cast<float>(data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] *= startGain + static_cast<float>(i + 1) * step;
+            peak = std::max(peak, std::abs(data[i]));
+            sumOfSquares += data[i] * data[i];
+        }
+    }
+
+    static std::vector<float> testSignal(int numSamples) {
+        std::vector<float> data(static_cast<size_t>(numSamples));
+        for (int i = 0; i < numSamples; ++i) {
+            data[static_cast<size_t>(i)] = std::sin(0.05f * static_cast<float>(i)) * (i % 7 == 3 ? -1.3f : 0.8f);
+        }
+        return data;
+    }
+};
+
+TEST_F(MixerBusTest, GainRampMatchesReferenceForAnyLength) {
+    // Lengths around the four-lane boundary exercise the scalar tail
+    for (int numSamples : { 1, 3, 4, 5, 63, 64, 257 }) {
+        for (auto [startGain, endGain] : { std::pair { 0.7f, 0.7f }, std::pair { 0.2f, 1.5f }, std::pair { 1.0f, 0.0f } }) {
+            auto data = testSignal(numSamples);
+            auto expected = data;
+
+            float peak = 0.0f, sumOfSquares = 0.0f;
+            float expectedPeak = 0.0f, expectedSum = 0.0f;
+            RoutingUtils::applyGainRampAndMeasure(data.data(), numSamples, startGain, endGain, peak, sumOfSquares);
+            referenceRamp(expected, startGain, endGain, expectedPeak, expectedSum);
+
+            for (int i = 0; i < numSamples; ++i) {
+                ASSERT_NEAR(data[static_cast<size_t>(i)], expected[static_cast<size_t>(i)], 1e-5f)
+                    << "length " << numSamples << ", sample " << i;
+            }
+            EXPECT_NEAR(peak, expectedPeak, 1e-5f);
+            EXPECT_NEAR(sumOfSquares, expectedSum, 1e-3f * std::max(1.0f, expectedSum));
+        }
+    }
+}
+
+TEST_F(MixerBusTest, GainRampEndsOnTargetAndAccumulates) {
+    std::vector<float> ones(100, 1.0f);
+
+    float peak = 2.0f, sumOfSquares = 10.0f;
+    RoutingUtils::applyGainRampAndMeasure(ones.data(), 100, 0.0f, 1.0f, peak, sumOfSquares);
+
+    EXPECT_NEAR(ones.front(), 0.01f, 1e-6f);
+    EXPECT_NEAR(ones.back(), 1.0f, 1e-6f);
+
+    // Measurements add to what the caller passed in
+    EXPECT_FLOAT_EQ(peak, 2.0f);
+    EXPECT_GT(sumOfSquares, 10.0f);
+
+    float untouchedPeak = 0.0f, untouchedSum = 0.0f;
+    RoutingUtils::applyGainRampAndMeasure(ones.data(), 0, 0.0f, 1.0f, untouchedPeak, untouchedSum);
+    EXPECT_EQ(untouchedPeak, 0.0f);
+    EXPECT_EQ(untouchedSum, 0.0f);
+}
+
+TEST_F(MixerBusTest, MeasureMatchesUnityRamp) {
+    for (int numSamples : { 1, 6, 128, 131 }) {
+        auto data = testSignal(numSamples);
+        auto ramped = data;
+
+        float peak = 0.0f, sumOfSquares = 0.0f;
+        float rampPeak = 0.0f, rampSum = 0.0f;
+        RoutingUtils::measurePeakAndPower(data.data(), numSamples, peak, sumOfSquares);
+        RoutingUtils::applyGainRampAndMeasure(ramped.data(), numSamples, 1.0f, 1.0f, rampPeak, rampSum);
+
+        EXPECT_EQ(data, ramped) << "measuring must not change the block";
+        EXPECT_FLOAT_EQ(peak, rampPeak);
+        EXPECT_NEAR(sumOfSquares, rampSum, 1e-4f * std::max(1.0f, rampSum));
+    }
+}
+
+TEST_F(MixerBusTest, MetersFollowGainAndPan) {
+    MixerBus bus("bus", MixerBus::Type::Audio, 2);
+    bus.prepareToPlay(sampleRate, blockSize);
+    bus.setGain(6.0f);
+    bus.setPan(0.5f);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    fill(buffer, 0.25f);
+    bus.processAudio(buffer);
+
+    // The first block after prepare starts on the control values
+    const auto [left, right] = RoutingUtils::panToStereoGains(0.5f);
+    const float linear = RoutingUtils::dBToLinear(6.0f);
+
+    EXPECT_NEAR(buffer.getSample(0, 0), 0.25f * linear * left, 1e-5f);
+    EXPECT_NEAR(buffer.getSample(1, blockSize - 1), 0.25f * linear * right, 1e-5f);
+    EXPECT_LT(left, right);
+
+    // DC input: peak and RMS are the output level
+    EXPECT_NEAR(bus.getPeakLevel(0), 0.25f * linear * left, 1e-5f);
+    EXPECT_NEAR(bus.getRMSLevel(1), 0.25f * linear * right, 1e-5f);
+    EXPECT_FALSE(bus.isClipping(0));
+    EXPECT_FALSE(bus.isClipping(1));
+    EXPECT_GT(bus.getProgramLevel(), 0.0f);
+}
+
+TEST_F(MixerBusTest, GainChangesRampAcrossOneBlock) {
+    MixerBus bus("bus", MixerBus::Type::Audio, 2);
+    bus.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    fill(buffer, 1.0f);
+    bus.processAudio(buffer);
+    const float before = buffer.getSample(0, blockSize - 1);
+
+    bus.setGain(-12.0f);
+    fill(buffer, 1.0f);
+    bus.processAudio(buffer);
+
+    const float after = before * RoutingUtils::dBToLinear(-12.0f);
+    EXPECT_LT(buffer.getSample(0, 0), before);
+    EXPECT_GT(buffer.getSample(0, 0), after);
+    EXPECT_NEAR(buffer.getSample(0, blockSize - 1), after, 1e-5f);
+    EXPECT_NEAR(bus.getPeakLevel(0), buffer.getSample(0, 0), 1e-6f);
+
+    // Steady from the next block on
+    fill(buffer, 1.0f);
+    bus.processAudio(buffer);
+    EXPECT_NEAR(buffer.getSample(0, 0), after, 1e-5f);
+    EXPECT_NEAR(bus.getRMSLevel(0), after, 1e-5f);
+}
+
+TEST_F(MixerBusTest, ClippingAndMute) {
+    MixerBus bus("bus", MixerBus::Type::Audio, 2);
+    bus.prepareToPlay(sampleRate, blockSize);
+    bus.setGain(12.0f);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    fill(buffer, 0.9f);
+    bus.processAudio(buffer);
+    EXPECT_TRUE(bus.isClipping(0));
+    EXPECT_TRUE(bus.isClipping(1));
+
+    bus.setMute(true);
+    fill(buffer, 0.9f);
+    bus.processAudio(buffer);   // ramps down
+    fill(buffer, 0.9f);
+    bus.processAudio(buffer);
+
+    EXPECT_EQ(buffer.getMagnitude(0, blockSize), 0.0f);
+    EXPECT_EQ(bus.getPeakLevel(0), 0.0f);
+    EXPECT_EQ(bus.getRMSLevel(1), 0.0f);
+    EXPECT_FALSE(bus.isClipping(0));
+}
+
+TEST_F(MixerBusTest, InsertsRunPostFaderAndAreMetered) {
+    MixerBus bus("bus", MixerBus::Type::Audio, 2);
+    ASSERT_TRUE(bus.getEffectsChain()->addEffect(std::make_unique<ClipperEffect>(0.5f), "Clipper"));
+    bus.prepareToPlay(sampleRate, blockSize);
+    bus.setGain(-12.0f);
+
+    // Pre-fader the clipper would cut 0.8 to 0.5 before the fader; post-fader
+    // it sees the already attenuated signal and leaves it alone
+    const float left = RoutingUtils::panToStereoGains(0.0f).first;
+    const float faded = 0.8f * RoutingUtils::dBToLinear(-12.0f) * left;
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    fill(buffer, 0.8f);
+    bus.processAudio(buffer);
+    EXPECT_NEAR(buffer.getSample(0, 0), faded, 1e-5f);
+
+    // With gain up, the insert's output is what the meters show
+    bus.setGain(12.0f);
+    for (int block = 0; block < 2; ++block) {
+        fill(buffer, 0.8f);
+        bus.processAudio(buffer);
+    }
+
+    EXPECT_NEAR(buffer.getSample(0, blockSize - 1), 0.5f, 1e-6f);
+    EXPECT_NEAR(bus.getPeakLevel(0), 0.5f, 1e-6f);
+    EXPECT_NEAR(bus.getRMSLevel(1), 0.5f, 1e-6f);
+    EXPECT_FALSE(bus.isClipping(0));
+
+    // Bypassing the bus skips the inserts; the fader output is metered
+    bus.setBypass(true);
+    fill(buffer, 0.8f);
+    bus.processAudio(buffer);
+    const float hot = 0.8f * RoutingUtils::dBToLinear(12.0f) * left;
+    EXPECT_NEAR(bus.getPeakLevel(0), hot, 1e-5f);
+    EXPECT_TRUE(bus.isClipping(0));
+}
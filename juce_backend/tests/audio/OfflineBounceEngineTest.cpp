@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "../../routing/OfflineBounceEngine.h"
+
+using namespace SchillingerEcosystem::Routing;
+
+class OfflineBounceEngineTest : public ::testing::Test {
+protected:
+    using Captured = std::map<OfflineBounceEngine::NodeId, std::vector<std::vector<float>>>;
+
+    // Stateful generators and buses, so any block reordering or shared
+    // state between threads would show up in the output
+    struct TrackState {
+        uint32_t seed = 0;
+        float lowpass = 0.0f;
+    };
+
+    struct BusState {
+        float lowpass[2] = {};
+    };
+
+    void buildProject(OfflineBounceEngine& engine, Captured& captured, std::mutex& captureLock,
+                      int numTracks, int numGroups) {
+        trackStates.assign(static_cast<size_t>(numTracks), {});
+        busStates.assign(static_cast<size_t>(numGroups + 1), {});
+
+        const auto master = engine.addBus("Master", 2, makeBus(numGroups));
+        std::vector<OfflineBounceEngine::NodeId> groups;
+        for (int g = 0; g < numGroups; ++g) {
+            groups.push_back(engine.addBus("Group " + juce::String(g), 2, makeBus(g)));
+            ASSERT_TRUE(engine.connect(groups.back(), master, 0.8f));
+        }
+
+        for (int t = 0; t < numTracks; ++t) {
+            const int channels = (t % 3 == 0) ? 1 : 2;
+            auto render = [this, t, channels](juce::AudioBuffer<float>& buffer, juce::MidiBuffer&, juce::int64 start) {
+                auto& state = trackStates[static_cast<size_t>(t)];
+                for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                    state.seed = state.seed * 1664525u + 1013904223u;
+                    const float noise = static_cast<float>(state.seed >> 8) / 16777216.0f - 0.5f;
+                    const float tone = std::sin(static_cast<float>(start + i) * 0.001f * static_cast<float>(t + 1));
+                    state.lowpass += 0.05f * (noise - state.lowpass);
+                    for (int c = 0; c < channels; ++c) {
+                        buffer.getWritePointer(c)[i] = 0.3f * tone + state.lowpass * static_cast<float>(c + 1);
+                    }
+                }
+            };
+            auto prepare = [this, t](double, int) { trackStates[static_cast<size_t>(t)] = { static_cast<uint32_t>(t * 7919 + 1), 0.0f }; };
+
+            const auto track = engine.addTrack("Track " + juce::String(t), channels, render, prepare);
+            ASSERT_TRUE(engine.connect(track, groups[static_cast<size_t>(t % numGroups)], 0.5f + 0.01f * static_cast<float>(t)));
+            tap(engine, track, captured, captureLock);
+        }
+
+        tap(engine, master, captured, captureLock);
+        for (auto group : groups) {
+            tap(engine, group, captured, captureLock);
+        }
+    }
+
+    OfflineBounceEngine::RenderFunction makeBus(int index) {
+        return [this, index](juce::AudioBuffer<float>& buffer, juce::MidiBuffer&, juce::int64) {
+            auto& state = busStates[static_cast<size_t>(index)];
+            for (int c = 0; c < buffer.getNumChannels(); ++c) {
+                auto* data = buffer.getWritePointer(c);
+                for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                    state.lowpass[c] += 0.2f * (data[i] - state.lowpass[c]);
+                    data[i] = std::tanh(state.lowpass[c]);
+                }
+            }
+        };
+    }
+
+    static void tap(OfflineBounceEngine& engine, OfflineBounceEngine::NodeId node, Captured& captured, std::mutex& captureLock) {
+        engine.addOutput(node, [node, &captured, &captureLock](const juce::AudioBuffer<float>& block, juce::int64 start) {
+            std::lock_guard<std::mutex> lock(captureLock);
+            auto& channels = captured[node];
+            channels.resize(static_cast<size_t>(block.getNumChannels()));
+            for (int c = 0; c < block.getNumChannels(); ++c) {
+                ASSERT_EQ(static_cast<juce::int64>(channels[static_cast<size_t>(c)].size()), start);   // Blocks arrive in order
+                channels[static_cast<size_t>(c)].insert(channels[static_cast<size_t>(c)].end(), block.getReadPointer(c),
+                                                        block.getReadPointer(c) + block.getNumSamples());
+            }
+        });
+    }
+
+    Captured bounce(int numThreads, int blocksInFlight, int blockSize = 4096) {
+        OfflineBounceEngine engine;
+        Captured captured;
+        std::mutex captureLock;
+        buildProject(engine, captured, captureLock, 24, 4);
+
+        OfflineBounceEngine::Settings settings;
+        settings.blockSize = blockSize;
+        settings.lengthInSamples = 48000 * 3 + 123;   // Partial last block
+        settings.numThreads = numThreads;
+        settings.blocksInFlight = blocksInFlight;
+
+        const auto result = engine.render(settings);
+        EXPECT_TRUE(result.completed) << result.error;
+        EXPECT_EQ(result.samplesRendered, settings.lengthInSamples);
+        return captured;
+    }
+
+    std::vector<TrackState> trackStates;
+    std::vector<BusState> busStates;
+};
+
+TEST_F(OfflineBounceEngineTest, OutputIsBitIdenticalForAnyThreadCount) {
+    const auto reference = bounce(1, 1);
+    ASSERT_EQ(reference.size(), 29u);     // Master, 4 groups, 24 stems
+    ASSERT_EQ(reference.at(0)[0].size(), static_cast<size_t>(48000 * 3 + 123));
+
+    for (int threads : { 2, 3, 8, 16 }) {
+        for (int inFlight : { 1, 4 }) {
+            const auto captured = bounce(threads, inFlight);
+            ASSERT_EQ(captured.size(), reference.size());
+            for (const auto& [node, channels] : reference) {
+                const auto& other = captured.at(node);
+                ASSERT_EQ(other.size(), channels.size());
+                for (size_t c = 0; c < channels.size(); ++c) {
+                    ASSERT_EQ(std::memcmp(other[c].data(), channels[c].data(), channels[c].size() * sizeof(float)), 0)
+                        << "node " << node << " channel " << c << " threads " << threads << " in flight " << inFlight;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(OfflineBounceEngineTest, MonoSourcesSpreadAndGainsApply) {
+    OfflineBounceEngine engine;
+    const auto bus = engine.addBus("Bus", 2);
+    const auto mono = engine.addTrack("Mono", 1, [](juce::AudioBuffer<float>& buffer, juce::MidiBuffer&, juce::int64) {
+        std::fill(buffer.getWritePointer(0), buffer.getWritePointer(0) + buffer.getNumSamples(), 1.0f);
+    });
+    ASSERT_TRUE(engine.connect(mono, bus, 0.25f));
+
+    std::vector<float> left, right;
+    engine.addOutput(bus, [&](const juce::AudioBuffer<float>& block, juce::int64) {
+        left.insert(left.end(), block.getReadPointer(0), block.getReadPointer(0) + block.getNumSamples());
+        right.insert(right.end(), block.getReadPointer(1), block.getReadPointer(1) + block.getNumSamples());
+    });
+
+    OfflineBounceEngine::Settings settings;
+    settings.lengthInSamples = 1000;
+    settings.blockSize = 256;
+    ASSERT_TRUE(engine.render(settings).completed);
+
+    ASSERT_EQ(left.size(), 1000u);
+    EXPECT_FLOAT_EQ(left.front(), 0.25f);
+    EXPECT_FLOAT_EQ(right.back(), 0.25f);
+}
+
+TEST_F(OfflineBounceEngineTest, CyclesAndTrackInputsAreRejected) {
+    OfflineBounceEngine engine;
+    auto silent = [](juce::AudioBuffer<float>&, juce::MidiBuffer&, juce::int64) {};
+    const auto track = engine.addTrack("Track", 2, silent);
+    const auto a = engine.addBus("A", 2);
+    const auto b = engine.addBus("B", 2);
+
+    EXPECT_TRUE(engine.connect(track, a));
+    EXPECT_TRUE(engine.connect(a, b));
+    EXPECT_FALSE(engine.connect(b, a));
+    EXPECT_FALSE(engine.connect(a, a));
+    EXPECT_FALSE(engine.connect(a, track));
+}
+
+TEST_F(OfflineBounceEngineTest, FailingNodeStopsTheBounce) {
+    OfflineBounceEngine engine;
+    const auto bus = engine.addBus("Bus", 2);
+    const auto track = engine.addTrack("Broken", 2, [](juce::AudioBuffer<float>&, juce::MidiBuffer&, juce::int64 start) {
+        if (start > 10000)
+            throw std::runtime_error("render failed");
+    });
+    ASSERT_TRUE(engine.connect(track, bus));
+
+    OfflineBounceEngine::Settings settings;
+    settings.lengthInSamples = 100000;
+    settings.blockSize = 1024;
+    settings.numThreads = 4;
+
+    const auto result = engine.render(settings);
+    EXPECT_FALSE(result.completed);
+    EXPECT_TRUE(result.error.contains("render failed"));
+    EXPECT_LT(result.samplesRendered, settings.lengthInSamples);
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "../../engine/hosting/OutOfProcessPluginHost.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace SchillingerEcosystem::Audio;
+
+// This binary doubles as the plugin host child: instead of loading plugins
+// it halves the signal, and misbehaves on request so the watchdog has
+// something to catch. Note 1 stalls the child, note 2 crashes it.
+namespace {
+
+constexpr int stallNote = 1;
+constexpr int crashNote = 2;
+
+int runTestChild() {
+    auto* region = PluginHostChild::mapRegion();
+    if (region == nullptr) {
+        return 2;
+    }
+
+    return PluginHostChild::serve(*region, [](float* const* channels, int numChannels, int numSamples,
+                                              juce::MidiBuffer& midi) {
+        for (const auto metadata : midi) {
+            const auto message = metadata.getMessage();
+            if (message.isNoteOn() && message.getNoteNumber() == stallNote) {
+                for (;;) {
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
+                }
+            }
+            if (message.isNoteOn() && message.getNoteNumber() == crashNote) {
+                std::abort();
+            }
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            for (int i = 0; i < numSamples; ++i) {
+                channels[ch][i] *= 0.5f;
+            }
+        }
+    });
+}
+
+std::string thisExecutable() {
+    char path[4096];
+    const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    return length > 0 ? std::string(path, static_cast<size_t>(length)) : std::string();
+}
+
+} // namespace
+
+class OutOfProcessPluginHostTest : public ::testing::Test {
+protected:
+    static constexpr int blockSize = 256;
+
+    void SetUp() override {
+        OutOfProcessPluginHost::Config config;
+        config.pluginPaths = { "test-plugin" };
+        config.executable = thisExecutable();
+        config.hangTimeout = std::chrono::milliseconds(200);
+        host = std::make_unique<OutOfProcessPluginHost>(config);
+
+        left.resize(blockSize);
+        right.resize(blockSize);
+    }
+
+    void TearDown() override {
+        host->stop();
+    }
+
+    // One callback of constant input, spaced well beyond what the child needs
+    void processBlock(float input, int note = 0) {
+        std::fill(left.begin(), left.end(), input);
+        std::fill(right.begin(), right.end(), input);
+        float* channels[] = { left.data(), right.data() };
+
+        juce::MidiBuffer midi;
+        if (note > 0) {
+            midi.addEvent(juce::MidiMessage::noteOn(1, note, 1.0f), 0);
+        }
+        host->process(channels, 2, blockSize, midi);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    bool outputIs(float value) const {
+        for (int i = 0; i < blockSize; ++i) {
+            if (left[static_cast<size_t>(i)] != value || right[static_cast<size_t>(i)] != value) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Keep the audio path running until the watchdog has a child serving again
+    bool processUntilRunning(std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            processBlock(1.0f);
+            if (host->isRunning() && host->getStatistics().restarts > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // After a restart the first callback still plays a block given up on
+    bool recovers() {
+        processBlock(1.0f);
+        for (int block = 0; block < 20; ++block) {
+            processBlock(1.0f);
+            if (outputIs(0.5f)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::unique_ptr<OutOfProcessPluginHost> host;
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+TEST_F(OutOfProcessPluginHostTest, DefaultExecutableIsTheHelperNotThisBinary) {
+    const auto executable = OutOfProcessPluginHost::getDefaultExecutable();
+    EXPECT_NE(executable, thisExecutable());
+    if (!executable.empty()) {
+        EXPECT_EQ(juce::File(executable).getFileName(), juce::String(PluginHostChild::helperExecutableName));
+    }
+}
+
+TEST_F(OutOfProcessPluginHostTest, BlocksRoundTripThroughTheSharedRegion) {
+    ASSERT_TRUE(host->start(48000.0, blockSize));
+    EXPECT_EQ(host->getLatencySamples(), blockSize);
+
+    // The first callback plays the priming silence
+    processBlock(1.0f);
+    EXPECT_TRUE(outputIs(0.0f));
+
+    for (int block = 0; block < 50; ++block) {
+        processBlock(1.0f);
+        EXPECT_TRUE(outputIs(0.5f)) << "block " << block;
+    }
+
+    const auto stats = host->getStatistics();
+    EXPECT_EQ(stats.blocksSubmitted, 51u);
+    EXPECT_EQ(stats.blocksMissed, 0u);
+    EXPECT_EQ(stats.restarts, 0u);
+}
+
+TEST_F(OutOfProcessPluginHostTest, StalledChildIsSilencedKilledAndRestarted) {
+    ASSERT_TRUE(host->start(48000.0, blockSize));
+    for (int block = 0; block < 5; ++block) {
+        processBlock(1.0f);
+    }
+    ASSERT_TRUE(outputIs(0.5f));
+
+    // The stalling block misses its deadline and is played as silence
+    processBlock(1.0f, stallNote);
+    EXPECT_TRUE(outputIs(0.5f));
+    processBlock(1.0f);
+    EXPECT_TRUE(outputIs(0.0f));
+    EXPECT_GE(host->getStatistics().blocksMissed, 1u);
+
+    ASSERT_TRUE(processUntilRunning(std::chrono::seconds(5)));
+    const auto stats = host->getStatistics();
+    EXPECT_EQ(stats.hangs, 1u);
+    EXPECT_EQ(stats.crashes, 0u);
+    EXPECT_EQ(stats.restarts, 1u);
+
+    EXPECT_TRUE(recovers());
+}
+
+TEST_F(OutOfProcessPluginHostTest, CrashedChildIsSilencedAndRestarted) {
+    ASSERT_TRUE(host->start(48000.0, blockSize));
+    for (int block = 0; block < 5; ++block) {
+        processBlock(1.0f);
+    }
+    ASSERT_TRUE(outputIs(0.5f));
+
+    processBlock(1.0f, crashNote);
+    processBlock(1.0f);
+    EXPECT_TRUE(outputIs(0.0f));
+
+    ASSERT_TRUE(processUntilRunning(std::chrono::seconds(5)));
+    const auto stats = host->getStatistics();
+    EXPECT_EQ(stats.crashes, 1u);
+    EXPECT_EQ(stats.hangs, 0u);
+    EXPECT_EQ(stats.restarts, 1u);
+
+    EXPECT_TRUE(recovers());
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], PluginHostChild::commandLineFlag) == 0) {
+        return runTestChild();
+    }
+
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "../../engine/hosting/PluginScanner.h"
+
+using namespace SchillingerEcosystem::Audio;
+
+class PluginScanCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                        .getNonexistentChildFile("PluginScanCacheTest", "", false);
+        directory.createDirectory();
+        plugin = directory.getChildFile("Synth.so");
+        plugin.replaceWithText("plugin binary v1");
+        cacheFile = directory.getChildFile("cache.xml");
+    }
+
+    void TearDown() override {
+        directory.deleteRecursively();
+    }
+
+    PluginScanCache::Entry scannedEntry() const {
+        const auto print = PluginScanCache::fingerprint(plugin);
+
+        PluginScanCache::Entry entry;
+        entry.path = plugin.getFullPathName();
+        entry.size = print.size;
+        entry.modificationTime = print.modificationTime;
+        entry.contentHash = PluginScanCache::hashContents(plugin);
+        entry.status = PluginScanCache::Status::Scanned;
+
+        juce::PluginDescription description;
+        description.name = "Synth";
+        description.pluginFormatName = "VST3";
+        description.fileOrIdentifier = plugin.getFullPathName();
+        entry.descriptions.push_back(description);
+        return entry;
+    }
+
+    juce::File directory;
+    juce::File plugin;
+    juce::File cacheFile;
+};
+
+TEST_F(PluginScanCacheTest, UnchangedFileIsAnsweredWithoutHashing) {
+    PluginScanCache cache(cacheFile);
+    cache.store(scannedEntry());
+
+    juce::String hash;
+    const auto entry = cache.lookup(plugin, &hash);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->descriptions.size(), 1u);
+    EXPECT_TRUE(hash.isEmpty());
+    EXPECT_EQ(cache.getCachedHash(plugin), PluginScanCache::hashContents(plugin));
+}
+
+TEST_F(PluginScanCacheTest, TouchedFileIsRevalidatedByContent) {
+    PluginScanCache cache(cacheFile);
+    cache.store(scannedEntry());
+
+    plugin.setLastModificationTime(juce::Time(plugin.getLastModificationTime().toMilliseconds() + 10000));
+    EXPECT_TRUE(cache.getCachedHash(plugin).isEmpty());
+
+    juce::String hash;
+    EXPECT_TRUE(cache.lookup(plugin, &hash).has_value());
+    EXPECT_FALSE(hash.isEmpty());
+    EXPECT_FALSE(cache.getCachedHash(plugin).isEmpty());    // Stamp refreshed
+}
+
+TEST_F(PluginScanCacheTest, ChangedFileMisses) {
+    PluginScanCache cache(cacheFile);
+    cache.store(scannedEntry());
+
+    plugin.replaceWithText("plugin binary v2, rebuilt");
+
+    juce::String hash;
+    EXPECT_FALSE(cache.lookup(plugin, &hash).has_value());
+    EXPECT_EQ(hash, PluginScanCache::hashContents(plugin));  // Handed on so the scan does not rehash
+}
+
+TEST_F(PluginScanCacheTest, EntriesSurviveSaveAndLoad) {
+    const auto broken = directory.getChildFile("Broken.so");
+    broken.replaceWithText("crashes on load");
+
+    {
+        PluginScanCache cache(cacheFile);
+        cache.store(scannedEntry());
+
+        PluginScanCache::Entry crashed;
+        crashed.path = broken.getFullPathName();
+        const auto print = PluginScanCache::fingerprint(broken);
+        crashed.size = print.size;
+        crashed.modificationTime = print.modificationTime;
+        crashed.status = PluginScanCache::Status::Crashed;
+        crashed.error = "scanner died with signal 11";
+        cache.store(crashed);
+
+        ASSERT_TRUE(cache.save());
+    }
+
+    PluginScanCache reloaded(cacheFile);
+    ASSERT_TRUE(reloaded.load());
+    EXPECT_EQ(reloaded.size(), 2u);
+
+    const auto entry = reloaded.lookup(plugin);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->status, PluginScanCache::Status::Scanned);
+    ASSERT_EQ(entry->descriptions.size(), 1u);
+    EXPECT_EQ(entry->descriptions[0].name, juce::String("Synth"));
+
+    // Failures are remembered so a crashing plugin is not retried every start
+    const auto failure = reloaded.lookup(broken);
+    ASSERT_TRUE(failure.has_value());
+    EXPECT_EQ(failure->status, PluginScanCache::Status::Crashed);
+    EXPECT_EQ(failure->error, juce::String("scanner died with signal 11"));
+}
+
+TEST_F(PluginScanCacheTest, MissingFilesArePruned) {
+    PluginScanCache cache(cacheFile);
+    cache.store(scannedEntry());
+
+    plugin.deleteFile();
+    EXPECT_FALSE(cache.lookup(plugin).has_value());
+
+    cache.removeMissing();
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+#if JUCE_LINUX
+TEST_F(PluginScanCacheTest, ScannerThatCannotStartCachesNothing) {
+    PluginScanCache cache(cacheFile);
+
+    PluginScanner::Options options;
+    options.executable = directory.getChildFile("missing-helper").getFullPathName().toStdString();
+    PluginScanner scanner(cache, options);
+
+    const auto results = scanner.scanFiles({ plugin.getFullPathName() });
+    ASSERT_EQ(results.entries.size(), 1u);
+    EXPECT_EQ(results.entries[0].status, PluginScanCache::Status::NotScanned);
+    EXPECT_EQ(results.filesFailed, 1);
+
+    // The plugin is scanned for real once the helper is there
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_FALSE(cache.lookup(plugin).has_value());
+}
+#endif
+
+TEST_F(PluginScanCacheTest, BundleHashCoversEveryFile) {
+    const auto bundle = directory.getChildFile("Synth.vst3");
+    const auto binary = bundle.getChildFile("Contents").getChildFile("x86_64-linux").getChildFile("Synth.so");
+    binary.getParentDirectory().createDirectory();
+    binary.replaceWithText("binary");
+    bundle.getChildFile("Contents").getChildFile("moduleinfo.json").replaceWithText("{}");
+
+    const auto before = PluginScanCache::hashContents(bundle);
+    binary.replaceWithText("binary, patched");
+
+    EXPECT_FALSE(before.isEmpty());
+    EXPECT_NE(PluginScanCache::hashContents(bundle), before);
+}
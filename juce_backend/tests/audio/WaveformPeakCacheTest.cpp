@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "../../engine/timeline/WaveformPeakCache.h"
+
+class WaveformPeakCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                        .getChildFile("WaveformPeakCacheTest_" + juce::String::toHexString(juce::Random::getSystemRandom().nextInt64()));
+        ASSERT_TRUE(directory.createDirectory());
+    }
+
+    void TearDown() override {
+        directory.deleteRecursively();
+    }
+
+    // Decaying noise with a loud burst, so every bucket differs
+    static juce::AudioBuffer<float> testSignal(int numChannels, int numSamples, uint32_t seed = 1) {
+        juce::AudioBuffer<float> buffer(numChannels, numSamples);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            uint32_t state = seed + static_cast<uint32_t>(channel) * 7919u;
+            for (int i = 0; i < numSamples; ++i) {
+                state = state * 1664525u + 1013904223u;
+                const float noise = static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+                const float envelope = (i / 10000) % 7 == 3 ? 0.9f : 0.9f * std::exp(-static_cast<float>(i % 50000) / 20000.0f);
+                buffer.getWritePointer(channel)[i] = noise * envelope;
+            }
+        }
+        return buffer;
+    }
+
+    static WaveformPeak bruteForce(const juce::AudioBuffer<float>& buffer, int channel, int64_t from, int64_t to) {
+        WaveformPeak peak { buffer.getSample(channel, static_cast<int>(from)), buffer.getSample(channel, static_cast<int>(from)), 0.0f };
+        double squares = 0.0;
+        for (int64_t i = from; i < to; ++i) {
+            const float sample = buffer.getSample(channel, static_cast<int>(i));
+            peak.min = std::min(peak.min, sample);
+            peak.max = std::max(peak.max, sample);
+            squares += static_cast<double>(sample) * sample;
+        }
+        peak.rms = static_cast<float>(std::sqrt(squares / static_cast<double>(to - from)));
+        return peak;
+    }
+
+    juce::File writeAudio(const juce::String& name, const juce::AudioBuffer<float>& buffer) {
+        auto file = directory.getChildFile(name);
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wav.createWriterFor(new juce::FileOutputStream(file), sampleRate,
+                                static_cast<unsigned int>(buffer.getNumChannels()), 32, {}, 0));
+        EXPECT_TRUE(writer != nullptr);
+        writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+        return file;
+    }
+
+    static void expectSamePeaks(const WaveformPeaks& a, const WaveformPeaks& b) {
+        ASSERT_EQ(a.getNumSamples(), b.getNumSamples());
+        for (const double samplesPerPixel : { 256.0, 4096.0, 65536.0 }) {
+            const int numPixels = static_cast<int>(a.getNumSamples() / samplesPerPixel) + 1;
+            std::vector<WaveformPeak> first(static_cast<size_t>(numPixels)), second(static_cast<size_t>(numPixels));
+            a.getPeaks(0, 0, samplesPerPixel, first.data(), numPixels);
+            b.getPeaks(0, 0, samplesPerPixel, second.data(), numPixels);
+            for (int p = 0; p < numPixels; ++p) {
+                EXPECT_EQ(first[static_cast<size_t>(p)].min, second[static_cast<size_t>(p)].min);
+                EXPECT_EQ(first[static_cast<size_t>(p)].max, second[static_cast<size_t>(p)].max);
+                EXPECT_EQ(first[static_cast<size_t>(p)].rms, second[static_cast<size_t>(p)].rms);
+            }
+        }
+    }
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr float tolerance = 1.0e-4f;     // 16-bit buckets
+    juce::File directory;
+};
+
+TEST_F(WaveformPeakCacheTest, EveryLevelMatchesTheAudio) {
+    const auto buffer = testSignal(2, 300000);
+    const auto peaks = WaveformPeaks::fromBuffer(buffer, sampleRate);
+    ASSERT_TRUE(peaks->isComplete());
+    EXPECT_EQ(peaks->getNumSamples(), 300000);
+
+    // Bucket-aligned pixels at each level, including the short last bucket
+    for (const int samplesPerPixel : { 256, 4096, 65536 }) {
+        const int numPixels = (300000 + samplesPerPixel - 1) / samplesPerPixel;
+        std::vector<WaveformPeak> pixels(static_cast<size_t>(numPixels + 3));
+        EXPECT_EQ(peaks->getPeaks(1, 0, samplesPerPixel, pixels.data(), numPixels + 3), numPixels);
+
+        for (int p = 0; p < numPixels; ++p) {
+            const auto expected = bruteForce(buffer, 1, static_cast<int64_t>(p) * samplesPerPixel,
+                                             std::min<int64_t>(300000, static_cast<int64_t>(p + 1) * samplesPerPixel));
+            EXPECT_NEAR(pixels[static_cast<size_t>(p)].min, expected.min, tolerance);
+            EXPECT_NEAR(pixels[static_cast<size_t>(p)].max, expected.max, tolerance);
+            EXPECT_NEAR(pixels[static_cast<size_t>(p)].rms, expected.rms, tolerance);
+        }
+        EXPECT_EQ(pixels[static_cast<size_t>(numPixels)].max, 0.0f);
+    }
+}
+
+TEST_F(WaveformPeakCacheTest, UnalignedPixelsNeverHidePeaks) {
+    const auto buffer = testSignal(1, 200000);
+    const auto peaks = WaveformPeaks::fromBuffer(buffer, sampleRate);
+
+    // Pixels cover whole buckets, so a pixel's range is at least what its samples reach
+    for (const double samplesPerPixel : { 100.0, 777.7, 9000.0, 100000.0 }) {
+        std::vector<WaveformPeak> pixels(64);
+        const int64_t start = 1234;
+        const int drawn = peaks->getPeaks(0, start, samplesPerPixel, pixels.data(), 64);
+        ASSERT_GT(drawn, 0);
+
+        for (int p = 0; p < drawn; ++p) {
+            const int64_t from = start + static_cast<int64_t>(std::floor(p * samplesPerPixel));
+            const int64_t to = std::min<int64_t>(200000, start + static_cast<int64_t>(std::floor((p + 1) * samplesPerPixel)));
+            if (to <= from)
+                continue;
+            const auto expected = bruteForce(buffer, 0, from, to);
+            EXPECT_LE(pixels[static_cast<size_t>(p)].min, expected.min + tolerance);
+            EXPECT_GE(pixels[static_cast<size_t>(p)].max, expected.max - tolerance);
+        }
+    }
+}
+
+TEST_F(WaveformPeakCacheTest, RecordingIsSummarisedAsItArrives) {
+    const auto buffer = testSignal(1, 400000);
+    WaveformPeaks peaks(1, sampleRate);
+
+    // Coarse pixels whose coarse bucket is still open are answered from the finer levels
+    int64_t written = 0;
+    std::vector<WaveformPeak> pixels(8);
+    while (written < 400000) {
+        const int count = static_cast<int>(std::min<int64_t>(5003, 400000 - written));
+        const float* channel = buffer.getReadPointer(0) + written;
+        peaks.append(&channel, count);
+        written += count;
+
+        const int64_t covered = (written / 256) * 256;
+        const int drawn = peaks.getPeaks(0, 0, 65536.0, pixels.data(), 8);
+        ASSERT_EQ(drawn, static_cast<int>((covered + 65535) / 65536));
+
+        const int last = drawn - 1;
+        const auto expected = bruteForce(buffer, 0, static_cast<int64_t>(last) * 65536, covered);
+        EXPECT_NEAR(pixels[static_cast<size_t>(last)].max, expected.max, tolerance);
+        EXPECT_NEAR(pixels[static_cast<size_t>(last)].rms, expected.rms, tolerance);
+    }
+
+    peaks.finish();
+    EXPECT_EQ(peaks.getPeaks(0, 0, 65536.0, pixels.data(), 8), 7);
+    expectSamePeaks(peaks, *WaveformPeaks::fromBuffer(buffer, sampleRate));
+}
+
+TEST_F(WaveformPeakCacheTest, ReadersRunAlongsideTheWriter) {
+    const auto buffer = testSignal(2, 1 << 20);
+    WaveformPeaks peaks(2, sampleRate);
+
+    std::thread writer([&] {
+        for (int offset = 0; offset < buffer.getNumSamples(); offset += 512) {
+            const float* channels[] = { buffer.getReadPointer(0) + offset, buffer.getReadPointer(1) + offset };
+            peaks.append(channels, 512);
+        }
+        peaks.finish();
+    });
+
+    std::vector<WaveformPeak> pixels(1024);
+    while (! peaks.isComplete())
+        for (int p = 0, drawn = peaks.getPeaks(1, 0, 1024.0, pixels.data(), 1024); p < drawn; ++p)
+            ASSERT_LE(pixels[static_cast<size_t>(p)].min, pixels[static_cast<size_t>(p)].max);
+
+    writer.join();
+    EXPECT_EQ(peaks.getPeaks(1, 0, 1024.0, pixels.data(), 1024), 1024);
+}
+
+TEST_F(WaveformPeakCacheTest, PeakFilesAreReusedUntilTheAudioChanges) {
+    const auto buffer = testSignal(2, 250000);
+    const auto audio = writeAudio("take.wav", buffer);
+
+    std::shared_ptr<const WaveformPeaks> built;
+    {
+        WaveformPeakCache cache;
+        built = cache.getPeaks(audio);
+        ASSERT_TRUE(built != nullptr);
+        EXPECT_EQ(cache.getPeaks(audio), built);            // One build per file
+        cache.waitUntilIdle();
+
+        EXPECT_TRUE(built->isComplete());
+        EXPECT_EQ(cache.getNumFilesBuilt(), 1);
+        EXPECT_EQ(cache.getPeakFile(audio), directory.getChildFile("take.wav.peaks"));
+        EXPECT_TRUE(cache.getPeakFile(audio).existsAsFile());
+        EXPECT_EQ(cache.getPeaks(directory.getChildFile("missing.wav")), nullptr);
+    }
+
+    // A new session loads the peak file, also after the audio was touched
+    audio.setLastModificationTime(audio.getLastModificationTime() + juce::RelativeTime::seconds(60.0));
+    {
+        WaveformPeakCache cache;
+        const auto loaded = cache.getPeaks(audio);
+        cache.waitUntilIdle();
+        EXPECT_EQ(cache.getNumFilesBuilt(), 0);
+        expectSamePeaks(*built, *loaded);
+    }
+
+    // New content, same length: rebuilt
+    writeAudio("take.wav", testSignal(2, 250000, 99));
+    {
+        WaveformPeakCache cache;
+        const auto rebuilt = cache.getPeaks(audio);
+        cache.waitUntilIdle();
+        EXPECT_EQ(cache.getNumFilesBuilt(), 1);
+        expectSamePeaks(*rebuilt, *WaveformPeaks::fromBuffer(testSignal(2, 250000, 99), sampleRate));
+    }
+}
+
+TEST_F(WaveformPeakCacheTest, FinishedRecordingsSaveTheirPeaks) {
+    const auto buffer = testSignal(1, 100000);
+    const auto audio = directory.getChildFile("recording.wav");
+
+    WaveformPeakCache cache;
+    auto recording = cache.startRecording(audio, 1, sampleRate);
+    const float* channel = buffer.getReadPointer(0);
+    recording->append(&channel, buffer.getNumSamples());
+    EXPECT_EQ(cache.getPeaks(audio), recording);            // Shown while recording
+
+    writeAudio("recording.wav", buffer);
+    cache.finishRecording(audio);
+    cache.waitUntilIdle();
+    ASSERT_TRUE(cache.getPeakFile(audio).existsAsFile());
+
+    recording.reset();
+    WaveformPeakCache reopened;
+    const auto loaded = reopened.getPeaks(audio);
+    reopened.waitUntilIdle();
+    EXPECT_EQ(reopened.getNumFilesBuilt(), 0);
+    expectSamePeaks(*loaded, *WaveformPeaks::fromBuffer(buffer, sampleRate));
+}
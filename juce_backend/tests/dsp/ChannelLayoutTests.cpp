@@ -0,0 +1,384 @@
+/*
+  ==============================================================================
+
+    ChannelLayoutTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Tests for channel layouts, layout negotiation, panning and metering
+    Checks the ITU fold-downs, VBAP gains, Ambisonic encode / decode
+    localisation, the block kernels and their cost
+
+  ==============================================================================
+*/
+
+#include "../include/dsp/ChannelLayout.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace DSP;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static bool near(float a, float b, float tolerance = 1.0e-3f)
+{
+    return std::abs(a - b) <= tolerance;
+}
+
+static float gainOf(const MixMatrix& matrix, const ChannelLayout& source, const char* from,
+                    const ChannelLayout& destination, const char* to)
+{
+    return matrix.getGain(source.findChannel(from), destination.findChannel(to));
+}
+
+static float power(const float* gains, int count)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < count; ++i)
+        sum += gains[i] * gains[i];
+    return sum;
+}
+
+/** Direction of the energy vector of speaker gains, degrees */
+static float energyAzimuth(const ChannelLayout& layout, const float* gains)
+{
+    double x = 0.0, y = 0.0;
+    for (int channel = 0; channel < layout.getNumChannels(); ++channel)
+    {
+        const auto& speaker = layout.getSpeaker(channel);
+        if (speaker.isLFE)
+            continue;
+        const double energy = static_cast<double>(gains[channel]) * gains[channel];
+        x += energy * std::cos(speaker.azimuth * 3.14159265358979323846 / 180.0);
+        y += energy * std::sin(speaker.azimuth * 3.14159265358979323846 / 180.0);
+    }
+    return static_cast<float>(std::atan2(y, x) * 180.0 / 3.14159265358979323846);
+}
+
+//==============================================================================
+// Layouts
+//==============================================================================
+
+static void testLayouts()
+{
+    std::cout << "\n=== Layouts ===" << std::endl;
+
+    check(ChannelLayout(ChannelLayout::Type::Surround51).getNumChannels() == 6, "5.1 has 6 channels");
+    check(ChannelLayout(ChannelLayout::Type::Surround714).getNumChannels() == 12, "7.1.4 has 12 channels");
+    check(ChannelLayout(ChannelLayout::Type::Surround512).getNumChannels() == 8, "5.1.2 has 8 channels");
+    check(ChannelLayout(ChannelLayout::Type::Ambisonic3).getNumChannels() == 16, "3rd order Ambisonics has 16 channels");
+
+    const ChannelLayout surround714(ChannelLayout::Type::Surround714);
+    check(surround714.getLFEChannel() == 3, "7.1.4 LFE is channel 3");
+    check(surround714.findChannel("Ltf") == 8 && surround714.findChannel("Rtr") == 11, "7.1.4 heights follow the bed");
+    check(surround714.hasHeightChannels() && !ChannelLayout(ChannelLayout::Type::Surround71).hasHeightChannels(),
+          "Height detection");
+
+    check(ChannelLayout().findChannel("R") == 1, "Default layout is stereo");
+    check(ChannelLayout::fromChannelCount(6).getType() == ChannelLayout::Type::Surround51, "6 channels default to 5.1");
+    check(ChannelLayout::fromChannelCount(7).getType() == ChannelLayout::Type::Surround70, "7 channels default to 7.0");
+    check(ChannelLayout::fromChannelCount(11).isDiscrete(), "11 channels are discrete");
+}
+
+//==============================================================================
+// Negotiation
+//==============================================================================
+
+static void testDownmixes()
+{
+    std::cout << "\n=== Negotiation ===" << std::endl;
+
+    const ChannelLayout mono(ChannelLayout::Type::Mono);
+    const ChannelLayout stereo(ChannelLayout::Type::Stereo);
+    const ChannelLayout surround51(ChannelLayout::Type::Surround51);
+    const ChannelLayout surround71(ChannelLayout::Type::Surround71);
+    const ChannelLayout surround714(ChannelLayout::Type::Surround714);
+    const ChannelLayout surround514(ChannelLayout::Type::Surround514);
+
+    check(MixMatrix::negotiate(surround51, surround51).isIdentity(), "Same layout is identity");
+
+    // ITU-R BS.775 stereo fold-down
+    const auto toStereo = MixMatrix::negotiate(surround51, stereo);
+    check(near(gainOf(toStereo, surround51, "L", stereo, "L"), 1.0f)
+          && near(gainOf(toStereo, surround51, "L", stereo, "R"), 0.0f), "5.1 -> 2.0: L passes");
+    check(near(gainOf(toStereo, surround51, "C", stereo, "L"), 0.7071f)
+          && near(gainOf(toStereo, surround51, "C", stereo, "R"), 0.7071f), "5.1 -> 2.0: C at -3 dB");
+    check(near(gainOf(toStereo, surround51, "Ls", stereo, "L"), 0.7071f)
+          && near(gainOf(toStereo, surround51, "Ls", stereo, "R"), 0.0f), "5.1 -> 2.0: Ls at -3 dB into L");
+    check(near(toStereo.getGain(3, 0), 0.0f) && near(toStereo.getGain(3, 1), 0.0f), "5.1 -> 2.0: LFE dropped");
+
+    const auto toMono = MixMatrix::negotiate(stereo, mono);
+    check(near(toMono.getGain(0, 0), 0.7071f) && near(toMono.getGain(1, 0), 0.7071f), "2.0 -> 1.0 at -3 dB");
+
+    const auto monoUp = MixMatrix::negotiate(mono, stereo);
+    check(near(monoUp.getGain(0, 0), 0.7071f) && near(monoUp.getGain(0, 1), 0.7071f), "1.0 -> 2.0 pans centre");
+
+    const auto fold71 = MixMatrix::negotiate(surround71, surround51);
+    check(near(gainOf(fold71, surround71, "Lss", surround51, "Ls"), 0.7071f)
+          && near(gainOf(fold71, surround71, "Lrs", surround51, "Ls"), 0.7071f), "7.1 -> 5.1: sides and rears share Ls");
+    check(near(gainOf(fold71, surround71, "LFE", surround51, "LFE"), 1.0f), "7.1 -> 5.1: LFE passes");
+
+    const auto fold714 = MixMatrix::negotiate(surround714, surround71);
+    check(near(gainOf(fold714, surround714, "Ltf", surround71, "L"), 0.7071f)
+          && near(gainOf(fold714, surround714, "Ltr", surround71, "Lrs"), 0.7071f), "7.1.4 -> 7.1: heights fold at -3 dB");
+
+    const auto bed714 = MixMatrix::negotiate(surround714, surround514);
+    check(near(gainOf(bed714, surround714, "Ltf", surround514, "Ltf"), 1.0f), "7.1.4 -> 5.1.4: heights pass");
+
+    const auto upmix = MixMatrix::negotiate(stereo, surround51);
+    float upmixPower = 0.0f;
+    for (int output = 0; output < 6; ++output)
+        upmixPower += upmix.getGain(0, output) * upmix.getGain(0, output);
+    check(near(upmix.getGain(0, 0), 1.0f) && near(upmixPower, 1.0f), "2.0 -> 5.1: L stays on L only");
+
+    const auto bedUp = MixMatrix::negotiate(surround51, surround71);
+    check(bedUp.getGain(4, surround71.findChannel("Lss")) > 0.3f
+          && bedUp.getGain(4, surround71.findChannel("Lrs")) > 0.3f, "5.1 -> 7.1: Ls spreads over side and rear");
+}
+
+//==============================================================================
+// VBAP
+//==============================================================================
+
+static void testVBAP()
+{
+    std::cout << "\n=== VBAP ===" << std::endl;
+
+    const ChannelLayout surround51(ChannelLayout::Type::Surround51);
+    const ChannelLayout surround714(ChannelLayout::Type::Surround714);
+    float gains[ChannelLayout::maxChannels];
+
+    surround51.getPanGains(0.0f, 0.0f, gains);
+    check(near(gains[2], 1.0f) && near(power(gains, 6), 1.0f), "Front centre hits C only");
+
+    surround51.getPanGains(15.0f, 0.0f, gains);
+    check(near(gains[0], gains[2]) && near(power(gains, 6), 1.0f), "Half way L-C is equal power");
+
+    surround51.getPanGains(180.0f, 0.0f, gains);
+    check(near(gains[4], gains[5]) && near(power(gains, 6), 1.0f), "Behind splits Ls/Rs");
+
+    bool unitPower = true;
+    bool continuous = true;
+    float previous[ChannelLayout::maxChannels];
+    surround714.getPanGains(-180.0f, 20.0f, previous);
+    for (float azimuth = -179.0f; azimuth <= 180.0f; azimuth += 1.0f)
+    {
+        surround714.getPanGains(azimuth, 20.0f, gains);
+        unitPower = unitPower && near(power(gains, 12), 1.0f, 1.0e-3f);
+        for (int channel = 0; channel < 12; ++channel)
+            continuous = continuous && std::abs(gains[channel] - previous[channel]) < 0.1f;
+        std::copy(gains, gains + 12, previous);
+    }
+    check(unitPower, "7.1.4 sweep keeps unit power");
+    check(continuous, "7.1.4 sweep is continuous");
+
+    surround714.getPanGains(45.0f, 45.0f, gains);
+    check(near(gains[8], 1.0f), "Up-front-left hits Ltf only");
+
+    surround714.getPanGains(90.0f, 22.5f, gains);
+    check(near(gains[4] * gains[4] + gains[8] * gains[8] + gains[10] * gains[10], 1.0f)
+          && gains[4] > 0.5f && gains[8] > 0.3f, "Half elevation blends the rings");
+
+    check(surround714.getLFEChannel() == 3 && gains[3] == 0.0f, "LFE never panned");
+
+    const ChannelLayout stereo(ChannelLayout::Type::Stereo);
+    stereo.getPanGains(110.0f, 0.0f, gains);
+    check(near(gains[0], 0.7071f) && near(gains[1], 0.0f), "Outside the stereo arc folds to L at -3 dB");
+    stereo.getPanGains(180.0f, 0.0f, gains);
+    check(near(gains[0], gains[1]), "Directly behind a stereo pair splits evenly");
+}
+
+//==============================================================================
+// Ambisonics
+//==============================================================================
+
+static void testAmbisonics()
+{
+    std::cout << "\n=== Ambisonics ===" << std::endl;
+
+    const ChannelLayout ambisonic1(ChannelLayout::Type::Ambisonic1);
+    const ChannelLayout ambisonic3(ChannelLayout::Type::Ambisonic3);
+    float gains[ChannelLayout::maxChannels];
+
+    ambisonic1.getPanGains(90.0f, 0.0f, gains);
+    check(near(gains[0], 1.0f) && near(gains[1], 1.0f) && near(gains[2], 0.0f) && near(gains[3], 0.0f),
+          "FOA encode of hard left (ACN/SN3D)");
+
+    // SN3D: the sum of squares within each degree is 1 for any direction
+    ambisonic3.getPanGains(37.0f, 21.0f, gains);
+    bool sn3d = true;
+    for (int degree = 0; degree <= 3; ++degree)
+    {
+        float sum = 0.0f;
+        for (int acn = degree * degree; acn < (degree + 1) * (degree + 1); ++acn)
+            sum += gains[acn] * gains[acn];
+        sn3d = sn3d && near(sum, 1.0f, 1.0e-4f);
+    }
+    check(sn3d, "Third order harmonics are SN3D");
+
+    // Encode a direction, decode to 7.1.4: the energy vector points back at it
+    const ChannelLayout surround714(ChannelLayout::Type::Surround714);
+    const auto decoder = MixMatrix::negotiate(ambisonic3, surround714);
+    float worstError = 0.0f;
+
+    for (float azimuth = -150.0f; azimuth <= 180.0f; azimuth += 30.0f)
+    {
+        ambisonic3.getPanGains(azimuth, 0.0f, gains);
+        float speakerGains[ChannelLayout::maxChannels] = {};
+        for (int output = 0; output < 12; ++output)
+            for (int acn = 0; acn < 16; ++acn)
+                speakerGains[output] += decoder.getGain(acn, output) * gains[acn];
+
+        float error = std::abs(energyAzimuth(surround714, speakerGains) - azimuth);
+        error = std::min(error, 360.0f - error);
+        worstError = std::max(worstError, error);
+    }
+    std::cout << "  3rd order -> 7.1.4 worst localisation error: " << worstError << " deg" << std::endl;
+    check(worstError < 15.0f, "3rd order decode localises within 15 degrees");
+
+    const auto encoder = MixMatrix::negotiate(ChannelLayout(ChannelLayout::Type::Surround51), ambisonic1);
+    check(near(encoder.getGain(0, 0), 1.0f) && encoder.getGain(0, 1) > 0.0f
+          && near(encoder.getGain(3, 0), 0.0f), "5.1 -> FOA encodes speakers, drops LFE");
+
+    const auto truncate = MixMatrix::negotiate(ambisonic3, ambisonic1);
+    check(truncate.getNumOutputs() == 4 && near(truncate.getGain(3, 3), 1.0f), "3rd -> 1st order keeps shared harmonics");
+}
+
+//==============================================================================
+// Kernels
+//==============================================================================
+
+static void testKernels()
+{
+    std::cout << "\n=== Kernels ===" << std::endl;
+
+    const ChannelLayout surround714(ChannelLayout::Type::Surround714);
+    const ChannelLayout surround51(ChannelLayout::Type::Surround51);
+    const auto matrix = MixMatrix::negotiate(surround714, surround51);
+    constexpr int numSamples = 257;
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    std::vector<std::vector<float>> input(12, std::vector<float>(numSamples));
+    for (auto& channel : input)
+        for (auto& sample : channel)
+            sample = noise(random);
+
+    std::vector<std::vector<float>> output(6, std::vector<float>(numSamples, 5.0f));
+    const float* inputs[12];
+    float* outputs[6];
+    for (int i = 0; i < 12; ++i) inputs[i] = input[static_cast<size_t>(i)].data();
+    for (int i = 0; i < 6; ++i) outputs[i] = output[static_cast<size_t>(i)].data();
+
+    matrix.process(inputs, outputs, numSamples);
+
+    float worst = 0.0f;
+    for (int o = 0; o < 6; ++o)
+        for (int n = 0; n < numSamples; ++n)
+        {
+            float expected = 0.0f;
+            for (int i = 0; i < 12; ++i)
+                expected += matrix.getGain(i, o) * input[static_cast<size_t>(i)][static_cast<size_t>(n)];
+            worst = std::max(worst, std::abs(expected - output[static_cast<size_t>(o)][static_cast<size_t>(n)]));
+        }
+    check(worst < 1.0e-5f, "Matrix kernel matches the reference");
+    check(output[3][10] == input[3][10], "LFE routed one to one");
+
+    // Panner ramps from the old gains and lands on the new ones
+    SpatialPanner panner(surround51);
+    panner.setDirection(30.0f);
+    std::vector<float> ones(numSamples, 1.0f);
+    panner.process(ones.data(), outputs, numSamples);
+    panner.setDirection(-30.0f);
+    panner.process(ones.data(), outputs, numSamples);
+    check(near(output[0][0], 1.0f, 0.01f) && near(output[0][numSamples - 1], 0.0f)
+          && near(output[1][numSamples - 1], 1.0f), "Panner ramps L -> R across the block");
+
+    panner.process(ones.data(), outputs, numSamples, true);
+    check(near(output[1][numSamples - 1], 2.0f), "Panner accumulates");
+
+    // Meter: LFE excluded from the program level, surrounds weighted
+    LayoutMeter meter(surround51);
+    std::vector<float> silence(numSamples, 0.0f);
+    std::vector<float> full(numSamples, 0.5f);
+    const float* meterInput[6] = { silence.data(), silence.data(), silence.data(), full.data(), silence.data(), silence.data() };
+    meter.process(meterInput, numSamples);
+    check(near(meter.getPeak(3), 0.5f) && near(meter.getProgramLevel(), 0.0f), "LFE metered, not in program level");
+
+    meterInput[3] = silence.data();
+    meterInput[4] = full.data();
+    meter.process(meterInput, numSamples);
+    check(near(meter.getProgramLevel(), 0.5f * std::sqrt(1.41f)), "Surrounds weighted +1.5 dB");
+}
+
+//==============================================================================
+// Cost
+//==============================================================================
+
+static void testCost()
+{
+    std::cout << "\n=== Cost ===" << std::endl;
+
+    const ChannelLayout surround714(ChannelLayout::Type::Surround714);
+    constexpr int numSources = 64;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 400;
+
+    std::vector<SpatialPanner> panners(numSources, SpatialPanner(surround714));
+    std::vector<float> source(blockSize, 0.25f);
+    std::vector<std::vector<float>> bus(12, std::vector<float>(blockSize));
+    float* outputs[12];
+    for (int i = 0; i < 12; ++i) outputs[i] = bus[static_cast<size_t>(i)].data();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        for (auto& channel : bus)
+            std::fill(channel.begin(), channel.end(), 0.0f);
+
+        for (int s = 0; s < numSources; ++s)
+        {
+            panners[static_cast<size_t>(s)].setDirection(static_cast<float>((block * 3 + s * 17) % 360 - 180), 10.0f);
+            panners[static_cast<size_t>(s)].process(source.data(), outputs, blockSize, true);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double audioSeconds = static_cast<double>(numBlocks) * blockSize / 48000.0;
+    const double load = seconds / audioSeconds * 100.0;
+
+    std::cout << "  " << numSources << " moving sources into 7.1.4: " << std::fixed << std::setprecision(2)
+              << load << "% of one core" << std::endl;
+    check(load < 25.0, "64 moving sources into 7.1.4 under a quarter core");
+}
+
+int main()
+{
+    std::cout << "Channel Layout Tests" << std::endl;
+
+    testLayouts();
+    testDownmixes();
+    testVBAP();
+    testAmbisonics();
+    testKernels();
+    testCost();
+
+    std::cout << "\n" << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,409 @@
+/*
+  ==============================================================================
+
+    CompressorCoreTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Tests for the block-based compressor core
+    Checks the sliding window detector against brute force, the fast log
+    math, the static curve, steady-state reduction, linking, sidechain and
+    precomputed key streams, and block size independence
+
+  ==============================================================================
+*/
+
+#include "dynamics/CompressorCore.h"
+#include "dynamics/DynamicsConfig.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace schill::dynamics;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static constexpr double sampleRate = 48000.0;
+static constexpr double pi = 3.14159265358979323846;
+
+static std::vector<float> sine(int numSamples, float amplitude, double hz = 1000.0)
+{
+    std::vector<float> data((size_t) numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        data[(size_t) i] = amplitude * (float) std::sin(2.0 * pi * hz * i / sampleRate);
+    return data;
+}
+
+static float rmsDb(const std::vector<float>& data, int start, int end)
+{
+    double sum = 0.0;
+    for (int i = start; i < end; ++i)
+        sum += (double) data[(size_t) i] * data[(size_t) i];
+    return (float) (10.0 * std::log10(std::max(sum / (end - start), 1.0e-20)));
+}
+
+static CompressorConfig makeConfig(float threshold, float ratio, CompressorMode mode = CompressorMode::RMS)
+{
+    CompressorConfig config;
+    config.threshold = threshold;
+    config.ratio = ratio;
+    config.kneeWidth = 0.0f;
+    config.attackTime = 1.0f;
+    config.releaseTime = 50.0f;
+    config.makeupGain = 0.0f;
+    config.mode = mode;
+    return config;
+}
+
+/** Runs a stereo pair through the core in blocks of blockSize */
+static void run(CompressorCore& core, std::vector<float>& left, std::vector<float>& right, int blockSize,
+                const std::vector<float>* key = nullptr)
+{
+    for (size_t start = 0; start < left.size(); start += (size_t) blockSize)
+    {
+        const int n = (int) std::min((size_t) blockSize, left.size() - start);
+        float* channels[] = { left.data() + start, right.data() + start };
+
+        if (key != nullptr)
+        {
+            const float* sidechain[] = { key->data() + start };
+            core.process(channels, 2, n, sidechain, 1);
+        }
+        else
+        {
+            core.process(channels, 2, n);
+        }
+    }
+}
+
+//==============================================================================
+// Sliding Window Detector
+//==============================================================================
+
+static void testSlidingWindow()
+{
+    std::cout << "\n=== Sliding Window Detector ===" << std::endl;
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<float> input(5000);
+    for (auto& value : input)
+        value = uniform(random) * uniform(random);
+
+    bool peakExact = true, rmsClose = true;
+    for (int window : { 1, 2, 17, 480 })
+    {
+        SlidingWindowDetector peak, rms;
+        peak.prepare(512);
+        rms.prepare(512);
+        peak.setMode(SlidingWindowDetector::Mode::Peak);
+        rms.setMode(SlidingWindowDetector::Mode::RMS);
+        peak.setWindowLength(window);
+        rms.setWindowLength(window);
+
+        for (int i = 0; i < (int) input.size(); ++i)
+        {
+            float maximum = 0.0f;
+            double sum = 0.0;
+            for (int j = std::max(0, i - window + 1); j <= i; ++j)
+            {
+                maximum = std::max(maximum, input[(size_t) j]);
+                sum += input[(size_t) j];
+            }
+
+            peakExact = peakExact && peak.process(input[(size_t) i]) == maximum;
+            rmsClose = rmsClose && std::abs(rms.process(input[(size_t) i]) - (float) (sum / window)) < 1.0e-5f;
+        }
+    }
+
+    check(peakExact, "Peak mode is the exact window maximum");
+    check(rmsClose, "RMS mode is the window mean (zeros before the window fills)");
+
+    SlidingWindowDetector clamped;
+    clamped.prepare(64);
+    clamped.setWindowLength(1000);
+    check(clamped.getWindowLength() == 64, "Window length is clamped to the prepared capacity");
+}
+
+//==============================================================================
+// Fast Math
+//==============================================================================
+
+static void testFastMath()
+{
+    std::cout << "\n=== Fast Math ===" << std::endl;
+
+    float worstLevel = 0.0f, worstGain = 0.0f;
+    for (float db = -120.0f; db <= 24.0f; db += 0.37f)
+    {
+        const float power = std::pow(10.0f, db * 0.1f);
+        worstLevel = std::max(worstLevel, std::abs(FastMath::powerToDecibels(power) - db));
+
+        const float gain = FastMath::decibelsToGain(db);
+        worstGain = std::max(worstGain, std::abs(20.0f * std::log10(gain) - db));
+    }
+
+    std::cout << "Worst level error " << worstLevel << " dB, gain error " << worstGain << " dB" << std::endl;
+    check(worstLevel < 0.01f, "powerToDecibels is within 0.01 dB");
+    check(worstGain < 0.01f, "decibelsToGain is within 0.01 dB");
+    check(FastMath::decibelsToGain(0.0f) == 1.0f, "0 dB is exactly unity gain");
+}
+
+//==============================================================================
+// Static Curve
+//==============================================================================
+
+static void testStaticCurve()
+{
+    std::cout << "\n=== Static Curve ===" << std::endl;
+
+    CompressorCore core;
+    core.prepare(sampleRate, 256);
+
+    auto config = makeConfig(-20.0f, 4.0f);
+    config.kneeWidth = 6.0f;
+    config.range = 20.0f;
+    core.setParameters(config);
+
+    check(core.computeGainReductionDb(-30.0f) == 0.0f, "No reduction below the knee");
+    check(std::abs(core.computeGainReductionDb(-10.0f) - 7.5f) < 1.0e-4f, "Above the knee: (1 - 1/ratio) of the overshoot");
+    check(std::abs(core.computeGainReductionDb(-20.0f) - 0.75f * 6.0f / 8.0f) < 1.0e-4f, "Soft knee at the threshold");
+
+    const float below = core.computeGainReductionDb(-23.0001f), above = core.computeGainReductionDb(-16.9999f);
+    check(below < 1.0e-3f && std::abs(above - 0.75f * 3.0f) < 1.0e-3f, "The knee joins both lines");
+    check(core.computeGainReductionDb(40.0f) == 20.0f, "Range caps the reduction");
+}
+
+//==============================================================================
+// Steady State
+//==============================================================================
+
+static void testSteadyState()
+{
+    std::cout << "\n=== Steady State ===" << std::endl;
+
+    CompressorCore core;
+    core.prepare(sampleRate, 512);
+    core.setParameters(makeConfig(-20.0f, 4.0f));
+
+    // -6 dBFS sine: RMS -9.03 dB, 10.97 dB over, 8.23 dB of reduction
+    auto left = sine(48000, 0.5f), right = left;
+    const float inputDb = rmsDb(left, 24000, 48000);
+    run(core, left, right, 512);
+
+    const float reduction = inputDb - rmsDb(left, 24000, 48000);
+    std::cout << "Reduction " << reduction << " dB (expected 8.23)" << std::endl;
+    check(std::abs(reduction - 8.23f) < 0.3f, "RMS detection settles on the static curve");
+    check(std::abs(core.getGainReductionDb() - 8.23f) < 0.5f, "Gain reduction is reported");
+
+    auto quiet = sine(4800, 0.01f), quietRight = quiet;
+    const auto original = quiet;
+    CompressorCore idle;
+    idle.prepare(sampleRate, 512);
+    idle.setParameters(makeConfig(-20.0f, 4.0f));
+    run(idle, quiet, quietRight, 512);
+    check(quiet == original && idle.getGainReductionDb() == 0.0f, "Signals below the threshold pass untouched");
+
+    auto makeup = makeConfig(-20.0f, 4.0f);
+    makeup.makeupGain = 6.0f;
+    CompressorCore boosted;
+    boosted.prepare(sampleRate, 512);
+    boosted.setParameters(makeup);
+    auto boostedLeft = sine(48000, 0.5f), boostedRight = boostedLeft;
+    run(boosted, boostedLeft, boostedRight, 512);
+    check(std::abs(rmsDb(boostedLeft, 24000, 48000) - rmsDb(left, 24000, 48000) - 6.0f) < 0.05f,
+          "Makeup gain is added after the reduction");
+}
+
+//==============================================================================
+// Linking and Sidechain
+//==============================================================================
+
+static void testLinking()
+{
+    std::cout << "\n=== Linking ===" << std::endl;
+
+    auto config = makeConfig(-20.0f, 8.0f);
+
+    for (float linkRatio : { 1.0f, 0.0f })
+    {
+        config.stereoLinkRatio = linkRatio;
+        CompressorCore core;
+        core.prepare(sampleRate, 256);
+        core.setParameters(config);
+
+        auto left = sine(24000, 0.8f), right = sine(24000, 0.05f);
+        const float rightIn = rmsDb(right, 12000, 24000);
+        run(core, left, right, 256);
+        const float rightReduction = rightIn - rmsDb(right, 12000, 24000);
+
+        if (linkRatio == 1.0f)
+            check(rightReduction > 10.0f, "Linked: the quiet channel follows the loud one");
+        else
+            check(std::abs(rightReduction) < 0.01f, "Unlinked: the quiet channel is left alone");
+    }
+}
+
+static void testSidechain()
+{
+    std::cout << "\n=== Sidechain ===" << std::endl;
+
+    auto config = makeConfig(-30.0f, 10.0f);
+    const auto key = sine(24000, 0.7f, 80.0);
+
+    CompressorCore keyed;
+    keyed.prepare(sampleRate, 256);
+    keyed.setParameters(config);
+    auto left = sine(24000, 0.05f), right = left;
+    const float inputDb = rmsDb(left, 12000, 24000);
+    run(keyed, left, right, 256, &key);
+    check(inputDb - rmsDb(left, 12000, 24000) > 15.0f, "A loud key ducks a quiet signal");
+
+    // A precomputed key stream from a matching detector sounds the same
+    CompressorCore streamed;
+    streamed.prepare(sampleRate, 256);
+    streamed.setParameters(config);
+
+    SlidingWindowDetector detector;
+    detector.prepare(48000);
+    detector.setMode(streamed.getDetectionMode());
+    detector.setWindowLength((int) std::lround(streamed.getDetectionWindowMs() * 0.001 * sampleRate));
+
+    std::vector<float> keyPower(key.size());
+    for (size_t i = 0; i < key.size(); ++i)
+        keyPower[i] = detector.process(key[i] * key[i]);
+
+    auto streamLeft = sine(24000, 0.05f), streamRight = streamLeft;
+    for (size_t start = 0; start < streamLeft.size(); start += 256)
+    {
+        const int n = (int) std::min((size_t) 256, streamLeft.size() - start);
+        float* channels[] = { streamLeft.data() + start, streamRight.data() + start };
+        streamed.processWithKeyPower(channels, 2, n, keyPower.data() + start);
+    }
+
+    float difference = 0.0f;
+    for (size_t i = 0; i < left.size(); ++i)
+        difference = std::max(difference, std::abs(left[i] - streamLeft[i]));
+    check(difference < 1.0e-5f, "processWithKeyPower matches process with the key as sidechain");
+}
+
+//==============================================================================
+// Block Sizes
+//==============================================================================
+
+static void testBlockSizes()
+{
+    std::cout << "\n=== Block Sizes ===" << std::endl;
+
+    auto config = makeConfig(-24.0f, 4.0f, CompressorMode::Peak);
+    config.stereoLinkRatio = 0.5f;
+
+    auto reference = sine(9000, 0.9f, 440.0), referenceRight = sine(9000, 0.3f, 660.0);
+    auto chunked = reference, chunkedRight = referenceRight;
+
+    CompressorCore small, large;
+    small.prepare(sampleRate, 64);
+    large.prepare(sampleRate, 64);
+    small.setParameters(config);
+    large.setParameters(config);
+
+    run(small, reference, referenceRight, 37);
+    run(large, chunked, chunkedRight, 1000);   // Longer than prepared: processed in chunks
+
+    bool identical = true;
+    for (size_t i = 0; i < reference.size(); ++i)
+        identical = identical && reference[i] == chunked[i] && referenceRight[i] == chunkedRight[i];
+    check(identical, "Output does not depend on the host block size");
+}
+
+//==============================================================================
+// Parameter Changes
+//==============================================================================
+
+static void testParameterChanges()
+{
+    std::cout << "\n=== Parameter Changes ===" << std::endl;
+
+    // Below the threshold the gain is just the makeup, so every block shows
+    // which snapshot it ran with; another thread keeps swapping them
+    auto unity = makeConfig(0.0f, 4.0f), cut = makeConfig(0.0f, 4.0f);
+    cut.makeupGain = -6.0f;
+
+    CompressorCore core;
+    core.prepare(sampleRate, 128);
+    core.setParameters(unity);
+
+    std::atomic<bool> running { true };
+    std::thread writer([&] {
+        for (int i = 0; running.load(); ++i)
+            core.setParameters((i & 1) ? cut : unity);
+    });
+
+    const auto input = sine(128, 0.1f);
+    bool wholeBlocks = true;
+    for (int block = 0; block < 2000; ++block)
+    {
+        auto left = input, right = input;
+        float* channels[] = { left.data(), right.data() };
+        core.process(channels, 2, 128);
+
+        const float gain = left[1] / input[1];
+        for (size_t i = 1; i < input.size(); ++i)
+            wholeBlocks = wholeBlocks && std::abs(left[i] - gain * input[i]) < 1.0e-6f;
+        wholeBlocks = wholeBlocks && (std::abs(gain - 1.0f) < 1.0e-3f || std::abs(gain - 0.5012f) < 1.0e-3f);
+    }
+
+    running = false;
+    writer.join();
+    check(wholeBlocks, "Each block runs with one complete snapshot");
+
+    core.setParameters(cut);
+    core.setParameters(unity);
+    auto left = input, right = input;
+    float* channels[] = { left.data(), right.data() };
+    core.process(channels, 2, 128);
+    check(std::abs(left[1] - input[1]) < 1.0e-6f, "The newest settings win");
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main()
+{
+    std::cout << "\n";
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Compressor Core Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    testSlidingWindow();
+    testFastMath();
+    testStaticCurve();
+    testSteadyState();
+    testLinking();
+    testSidechain();
+    testBlockSizes();
+    testParameterChanges();
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  " << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
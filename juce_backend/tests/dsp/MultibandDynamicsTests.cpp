@@ -0,0 +1,297 @@
+/*
+  ==============================================================================
+
+    MultibandDynamicsTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Tests for the Linkwitz-Riley multiband dynamics engine
+    Checks that the bands sum flat, the -6 dB crossover points, per-band
+    gain and compression, sidechain keying and block size independence
+
+  ==============================================================================
+*/
+
+#include "dynamics/MultibandDynamics.h"
+#include "dynamics/DynamicsConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace schill::dynamics;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static constexpr double sampleRate = 48000.0;
+static constexpr double pi = 3.14159265358979323846;
+static constexpr int numSamples = 48000;
+
+static std::vector<float> sine(double hz, float amplitude)
+{
+    std::vector<float> data(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        data[(size_t) i] = amplitude * (float) std::sin(2.0 * pi * hz * i / sampleRate);
+    return data;
+}
+
+/** Level of the second half (after the filters have settled), dB */
+static float levelDb(const std::vector<float>& data)
+{
+    double sum = 0.0;
+    for (int i = numSamples / 2; i < numSamples; ++i)
+        sum += (double) data[(size_t) i] * data[(size_t) i];
+    return (float) (10.0 * std::log10(std::max(sum / (numSamples / 2), 1.0e-20)));
+}
+
+/** A band that never compresses, with a fixed gain */
+static CompressorConfig fixedGain(float gainDb)
+{
+    CompressorConfig config;
+    config.threshold = 0.0f;
+    config.ratio = 1.0f;
+    config.makeupGain = gainDb;
+    return config;
+}
+
+static CompressorConfig compressing(float threshold, float ratio)
+{
+    CompressorConfig config;
+    config.threshold = threshold;
+    config.ratio = ratio;
+    config.kneeWidth = 0.0f;
+    config.attackTime = 1.0f;
+    config.releaseTime = 50.0f;
+    config.makeupGain = 0.0f;
+    return config;
+}
+
+/** Three splits, four bands: 200 Hz, 1 kHz, 5 kHz */
+static void prepareFourBands(MultibandDynamics& dynamics, int blockSize = 256)
+{
+    dynamics.prepare(sampleRate, blockSize);
+    dynamics.setCrossoverFrequencies({ 5000.0f, 200.0f, 1000.0f });
+    for (int band = 0; band < dynamics.getNumBands(); ++band)
+        dynamics.setBandParameters(band, fixedGain(0.0f));
+}
+
+static void run(MultibandDynamics& dynamics, std::vector<float>& left, std::vector<float>& right, int blockSize,
+                const std::vector<float>* key = nullptr)
+{
+    for (size_t start = 0; start < left.size(); start += (size_t) blockSize)
+    {
+        const int n = (int) std::min((size_t) blockSize, left.size() - start);
+        float* channels[] = { left.data() + start, right.data() + start };
+
+        if (key != nullptr)
+        {
+            const float* sidechain[] = { key->data() + start };
+            dynamics.process(channels, 2, n, sidechain, 1);
+        }
+        else
+        {
+            dynamics.process(channels, 2, n);
+        }
+    }
+}
+
+/** Output level change for a sine through the engine, dB */
+static float responseDb(MultibandDynamics& dynamics, double hz, float amplitude = 0.1f)
+{
+    dynamics.reset();
+    auto left = sine(hz, amplitude), right = left;
+    const float input = levelDb(left);
+    run(dynamics, left, right, 256);
+    return levelDb(left) - input;
+}
+
+//==============================================================================
+// Band Summing
+//==============================================================================
+
+static void testFlatSum()
+{
+    std::cout << "\n=== Band Summing ===" << std::endl;
+
+    MultibandDynamics dynamics;
+    prepareFourBands(dynamics);
+    check(dynamics.getNumBands() == 4, "Three crossovers make four bands");
+
+    // Crossover frequencies themselves and points inside every band
+    float worst = 0.0f;
+    for (double hz : { 40.0, 120.0, 200.0, 450.0, 1000.0, 2200.0, 5000.0, 9000.0, 16000.0 })
+        worst = std::max(worst, std::abs(responseDb(dynamics, hz)));
+
+    std::cout << "Largest deviation " << worst << " dB" << std::endl;
+    check(worst < 0.05f, "Unity bands sum to a flat magnitude response");
+
+    MultibandDynamics single;
+    single.prepare(sampleRate, 256);
+    single.setCrossoverFrequencies({});
+    single.setBandParameters(0, fixedGain(0.0f));
+    check(single.getNumBands() == 1 && std::abs(responseDb(single, 1000.0)) < 1.0e-3f,
+          "A single band passes the signal unchanged");
+}
+
+static void testCrossoverPoints()
+{
+    std::cout << "\n=== Crossover Points ===" << std::endl;
+
+    MultibandDynamics dynamics;
+    prepareFourBands(dynamics);
+
+    // Mute every band but one: at its edges LR4 bands are 6 dB down
+    for (int band = 0; band < 4; ++band)
+        dynamics.setBandParameters(band, fixedGain(band == 1 ? 0.0f : -120.0f));
+
+    const float lowEdge = responseDb(dynamics, 200.0), highEdge = responseDb(dynamics, 1000.0);
+    const float centre = responseDb(dynamics, 450.0);
+    std::cout << "Band 1 at 200 Hz " << lowEdge << " dB, 450 Hz " << centre << " dB, 1 kHz " << highEdge << " dB" << std::endl;
+
+    check(std::abs(lowEdge + 6.02f) < 0.2f && std::abs(highEdge + 6.02f) < 0.2f, "Linkwitz-Riley bands cross at -6 dB");
+    check(centre > -1.0f, "The band passes its middle");
+    check(responseDb(dynamics, 40.0) < -30.0f && responseDb(dynamics, 9000.0) < -30.0f,
+          "Fourth-order slopes reject the neighbouring bands");
+}
+
+//==============================================================================
+// Per-Band Gain and Compression
+//==============================================================================
+
+static void testBandGain()
+{
+    std::cout << "\n=== Per-Band Gain ===" << std::endl;
+
+    MultibandDynamics dynamics;
+    prepareFourBands(dynamics);
+    dynamics.setBandParameters(2, fixedGain(-12.0f));
+
+    // The neighbouring bands' skirts still overlap at the band's centre, so
+    // a little of the signal passes at unity
+    const float inside = responseDb(dynamics, 2200.0);
+    std::cout << "Band 2 at -12 dB: " << inside << " dB at 2.2 kHz" << std::endl;
+    check(inside < -9.0f && inside > -12.5f, "Band gain applies inside the band");
+    check(std::abs(responseDb(dynamics, 60.0)) < 0.05f && std::abs(responseDb(dynamics, 16000.0)) < 0.05f,
+          "Other bands are untouched");
+}
+
+static void testBandCompression()
+{
+    std::cout << "\n=== Per-Band Compression ===" << std::endl;
+
+    MultibandDynamics dynamics;
+    prepareFourBands(dynamics);
+    dynamics.setBandParameters(0, compressing(-30.0f, 10.0f));
+    dynamics.setBandParameters(2, compressing(-30.0f, 10.0f));
+
+    // Loud bass, quiet mids: only the bass band works
+    auto bass = sine(60.0, 0.7f), mids = sine(2200.0, 0.01f);
+    std::vector<float> left(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        left[(size_t) i] = bass[(size_t) i] + mids[(size_t) i];
+    auto right = left;
+
+    run(dynamics, left, right, 256);
+
+    std::cout << "Band 0 reduction " << dynamics.getBandGainReductionDb(0) << " dB, band 2 "
+              << dynamics.getBandGainReductionDb(2) << " dB" << std::endl;
+    check(dynamics.getBandGainReductionDb(0) > 15.0f, "The loud band is compressed");
+    check(dynamics.getBandGainReductionDb(2) == 0.0f, "The quiet band is not");
+    check(dynamics.getGainReductionDb() == dynamics.getBandGainReductionDb(0), "Overall reduction is the largest band's");
+
+    // With a 10:1 ratio the bass comes out close to the threshold
+    auto bassOnly = sine(60.0, 0.7f), bassRight = bassOnly;
+    dynamics.reset();
+    run(dynamics, bassOnly, bassRight, 256);
+    const float expected = -30.0f + (levelDb(sine(60.0, 0.7f)) + 30.0f) / 10.0f;
+    check(std::abs(levelDb(bassOnly) - expected) < 1.5f, "The band settles near its static curve");
+}
+
+static void testSidechain()
+{
+    std::cout << "\n=== Sidechain ===" << std::endl;
+
+    MultibandDynamics dynamics;
+    prepareFourBands(dynamics);
+
+    auto keyed = compressing(-40.0f, 20.0f);
+    keyed.externalSidechain = true;
+    dynamics.setBandParameters(0, keyed);
+
+    // A kick in the key ducks the bass band of a quiet programme
+    const auto key = sine(60.0, 0.8f);
+    auto left = sine(60.0, 0.005f), right = left;
+    const float input = levelDb(left);
+    run(dynamics, left, right, 256, &key);
+    check(input - levelDb(left) > 20.0f, "An external key ducks its band");
+
+    auto unkeyed = sine(60.0, 0.005f), unkeyedRight = unkeyed;
+    dynamics.reset();
+    run(dynamics, unkeyed, unkeyedRight, 256);
+    check(std::abs(levelDb(unkeyed) - input) < 0.05f, "Without a sidechain the band keys from itself");
+}
+
+//==============================================================================
+// Block Sizes
+//==============================================================================
+
+static void testBlockSizes()
+{
+    std::cout << "\n=== Block Sizes ===" << std::endl;
+
+    MultibandDynamics small, large;
+    prepareFourBands(small, 64);
+    prepareFourBands(large, 64);
+    for (auto* dynamics : { &small, &large })
+    {
+        dynamics->setBandParameters(0, compressing(-20.0f, 4.0f));
+        dynamics->setBandParameters(3, compressing(-30.0f, 8.0f));
+    }
+
+    auto a = sine(80.0, 0.8f), b = sine(12000.0, 0.3f);
+    auto c = a, d = b;
+    run(small, a, b, 41);
+    run(large, c, d, 1000);   // Longer than prepared: processed in chunks
+
+    bool identical = true;
+    for (size_t i = 0; i < a.size(); ++i)
+        identical = identical && a[i] == c[i] && b[i] == d[i];
+    check(identical, "Output does not depend on the host block size");
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main()
+{
+    std::cout << "\n";
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Multiband Dynamics Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    testFlatSum();
+    testCrossoverPoints();
+    testBandGain();
+    testBandCompression();
+    testSidechain();
+    testBlockSizes();
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  " << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
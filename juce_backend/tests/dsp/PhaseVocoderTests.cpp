@@ -0,0 +1,324 @@
+/*
+  ==============================================================================
+
+    PhaseVocoderTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Quality and cost tests for the phase vocoder
+    Checks reconstruction, pitch, stretch length, transient sharpness and
+    the real-time cost of the low-latency mode
+
+  ==============================================================================
+*/
+
+#include "../include/dsp/PhaseVocoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace DSP;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static constexpr double sampleRate = 48000.0;
+static constexpr double pi = 3.14159265358979323846;
+
+static std::vector<float> sine(size_t length, double frequency, float amplitude = 0.5f)
+{
+    std::vector<float> signal(length);
+    for (size_t i = 0; i < length; ++i)
+        signal[i] = amplitude * static_cast<float>(std::sin(2.0 * pi * frequency * static_cast<double>(i) / sampleRate));
+    return signal;
+}
+
+static float rms(const std::vector<float>& signal, size_t from, size_t to)
+{
+    double sum = 0.0;
+    for (size_t i = from; i < to; ++i)
+        sum += static_cast<double>(signal[i]) * signal[i];
+    return static_cast<float>(std::sqrt(sum / static_cast<double>(to - from)));
+}
+
+/** Frequency from the mean period between rising zero crossings */
+static double measureFrequency(const std::vector<float>& signal, size_t from, size_t to)
+{
+    double first = -1.0, last = -1.0;
+    int crossings = 0;
+    for (size_t i = from + 1; i < to; ++i)
+    {
+        if (signal[i - 1] < 0.0f && signal[i] >= 0.0f)
+        {
+            const double position = static_cast<double>(i - 1) + signal[i - 1] / (signal[i - 1] - signal[i]);
+            if (first < 0.0)
+                first = position;
+            last = position;
+            ++crossings;
+        }
+    }
+    return crossings < 2 ? 0.0 : sampleRate * (crossings - 1) / (last - first);
+}
+
+//==============================================================================
+// Tests
+//==============================================================================
+
+void testSharedPlans()
+{
+    std::cout << "\n--- Shared FFT plans ---" << std::endl;
+
+    RealFFT a(10), b(10), c(11);
+    check(a.getPlan() == b.getPlan(), "Same size shares one plan");
+    check(a.getPlan() != c.getPlan(), "Different sizes have their own plans");
+
+    PhaseVocoder first(PhaseVocoder::Mode::LowLatency, sampleRate, 2, 512);
+    PhaseVocoder second(PhaseVocoder::Mode::LowLatency, sampleRate, 2, 512);
+    check(first.getFrameSize() == 1024 && second.getFrameSize() == 1024, "Low-latency frame is 1024 at 48 kHz");
+}
+
+void testIdentity()
+{
+    std::cout << "\n--- Unity ratios ---" << std::endl;
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> blockSizes(1, 700);
+
+    // A chord, so several peaks share the spectrum
+    auto input = sine(48000, 220.0, 0.3f);
+    const auto third = sine(input.size(), 277.18, 0.2f);
+    const auto fifth = sine(input.size(), 329.63, 0.2f);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] += third[i] + fifth[i];
+
+    for (auto mode : { PhaseVocoder::Mode::LowLatency, PhaseVocoder::Mode::HighQuality })
+    {
+        PhaseVocoder vocoder(mode, sampleRate, 1, 700);
+        const int latency = vocoder.getLatency();
+
+        auto output = input;
+        for (size_t position = 0; position < output.size();)
+        {
+            const int count = std::min(blockSizes(rng), static_cast<int>(output.size() - position));
+            float* io = output.data() + position;
+            vocoder.processBlock(&io, &io, count);
+            position += static_cast<size_t>(count);
+        }
+
+        // Compare away from the start-up frames
+        float error = 0.0f;
+        for (size_t i = static_cast<size_t>(2 * latency); i < output.size(); ++i)
+            error = std::max(error, std::abs(output[i] - input[i - static_cast<size_t>(latency)]));
+
+        std::cout << (mode == PhaseVocoder::Mode::LowLatency ? "Low latency " : "High quality")
+                  << " - Max error: " << std::scientific << error << std::defaultfloat;
+        check(error < 1.0e-2f, "");
+    }
+}
+
+void testPitchShift()
+{
+    std::cout << "\n--- Pitch shift ---" << std::endl;
+    const auto input = sine(96000, 440.0);
+
+    for (double ratio : { 2.0, 0.5, 1.5 })
+    {
+        // Live, through processBlock
+        PhaseVocoder vocoder(PhaseVocoder::Mode::LowLatency, sampleRate, 1, 256);
+        vocoder.setPitchRatio(ratio);
+        auto live = input;
+        for (size_t position = 0; position < live.size(); position += 256)
+        {
+            float* io = live.data() + position;
+            vocoder.processBlock(&io, &io, 256);
+        }
+
+        // Offline
+        const auto offline = PhaseVocoder::process(input.data(), static_cast<int>(input.size()), sampleRate, 1.0, ratio);
+
+        const double liveFrequency = measureFrequency(live, 8192, live.size());
+        const double offlineFrequency = measureFrequency(offline, 8192, offline.size() - 8192);
+        const double expected = 440.0 * ratio;
+
+        std::cout << "Ratio " << ratio << " - live " << std::fixed << std::setprecision(1) << liveFrequency
+                  << " Hz, offline " << offlineFrequency << " Hz, RMS " << std::setprecision(3)
+                  << rms(offline, 8192, offline.size() - 8192) << std::defaultfloat;
+        check(std::abs(liveFrequency - expected) < expected * 0.005
+              && std::abs(offlineFrequency - expected) < expected * 0.005
+              && offline.size() == input.size()
+              && std::abs(rms(offline, 8192, offline.size() - 8192) - rms(input, 0, input.size())) < 0.05f, "");
+    }
+}
+
+void testTimeStretch()
+{
+    std::cout << "\n--- Time stretch ---" << std::endl;
+    const auto input = sine(48000, 440.0);
+    const float inputLevel = rms(input, 0, input.size());
+
+    for (double ratio : { 1.5, 0.5, 3.0 })
+    {
+        const auto output = PhaseVocoder::process(input.data(), static_cast<int>(input.size()), sampleRate, ratio, 1.0);
+        const size_t expectedLength = static_cast<size_t>(std::lround(static_cast<double>(input.size()) * ratio));
+
+        // Level should hold steady across the stretched body
+        float lowest = 1.0f, highest = 0.0f;
+        for (size_t from = 4096; from + 2048 < output.size() - 4096; from += 2048)
+        {
+            const float level = rms(output, from, from + 2048);
+            lowest = std::min(lowest, level);
+            highest = std::max(highest, level);
+        }
+
+        const double frequency = measureFrequency(output, 4096, output.size() - 4096);
+        std::cout << "Ratio " << ratio << " - " << output.size() << " samples, " << std::fixed << std::setprecision(1)
+                  << frequency << " Hz, level " << std::setprecision(3) << lowest << ".." << highest << std::defaultfloat;
+        check(output.size() == expectedLength
+              && std::abs(frequency - 440.0) < 2.0
+              && lowest > inputLevel * 0.9f && highest < inputLevel * 1.1f, "");
+    }
+}
+
+void testTransients()
+{
+    std::cout << "\n--- Transient preservation ---" << std::endl;
+
+    // Decaying clicks every 250 ms over a quiet tone
+    auto input = sine(96000, 200.0, 0.05f);
+    std::vector<size_t> clicks;
+    for (size_t onset = 6000; onset + 12000 < input.size(); onset += 12000)
+    {
+        clicks.push_back(onset);
+        for (size_t i = 0; i < 2000; ++i)
+            input[onset + i] += 0.8f * std::exp(-static_cast<float>(i) / 200.0f)
+                              * static_cast<float>(std::sin(2.0 * pi * 3000.0 * static_cast<double>(i) / sampleRate));
+    }
+
+    const double ratio = 2.0;
+    auto stretch = [&](bool detect, int& transients) {
+        PhaseVocoder vocoder(PhaseVocoder::Mode::HighQuality, sampleRate, 1, 4096);
+        vocoder.setTimeRatio(ratio);
+        vocoder.setTransientDetection(detect);
+
+        std::vector<float> output;
+        std::vector<float> chunk(4096);
+        size_t position = 0;
+        while (position < input.size())
+        {
+            const float* in = input.data() + position;
+            position += static_cast<size_t>(vocoder.write(&in, static_cast<int>(std::min<size_t>(4096, input.size() - position))));
+
+            float* out = chunk.data();
+            while (const int count = vocoder.read(&out, 4096))
+                output.insert(output.end(), chunk.begin(), chunk.begin() + count);
+        }
+        transients = vocoder.getNumTransients();
+        return output;
+    };
+
+    // Energy in the 20 ms before each stretched attack, against the attack
+    // itself. The attack is the loudest sample near where a frame centre
+    // maps the onset, (x - frame/2) * ratio + frame/2
+    auto preEcho = [&](const std::vector<float>& output, int frame) {
+        double before = 0.0, after = 0.0;
+        for (size_t onset : clicks)
+        {
+            const auto expected = static_cast<size_t>((static_cast<double>(onset) - frame / 2) * ratio + frame / 2);
+            if (expected + static_cast<size_t>(frame) + 960 > output.size())
+                continue;
+
+            size_t at = expected - static_cast<size_t>(frame);
+            for (size_t i = at; i < expected + static_cast<size_t>(frame); ++i)
+                if (std::abs(output[i]) > std::abs(output[at]))
+                    at = i;
+
+            before += rms(output, at - 960, at - 96);
+            after += rms(output, at, at + 960);
+        }
+        return before / after;
+    };
+
+    int withCount = 0, withoutCount = 0;
+    const auto with = stretch(true, withCount);
+    const auto without = stretch(false, withoutCount);
+
+    const int frame = PhaseVocoder(PhaseVocoder::Mode::HighQuality, sampleRate, 1, 1).getFrameSize();
+    const double withSmear = preEcho(with, frame);
+    const double withoutSmear = preEcho(without, frame);
+
+    std::cout << "Transients found: " << withCount << " of " << clicks.size() << std::endl;
+    std::cout << "Pre-echo with detection " << std::fixed << std::setprecision(3) << withSmear
+              << ", without " << withoutSmear << std::defaultfloat << std::endl;
+    check(withCount >= static_cast<int>(clicks.size()) && withCount <= static_cast<int>(clicks.size()) * 2,
+          "Every click detected, the tone is not");
+    check(withoutCount == 0, "Detection off resets nothing");
+    check(withSmear < withoutSmear * 0.8, "Phase reset reduces smearing before attacks");
+}
+
+void testLiveCost()
+{
+    std::cout << "\n--- Low-latency stereo octave, 128-sample blocks ---" << std::endl;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    PhaseVocoder vocoder(PhaseVocoder::Mode::LowLatency, sampleRate, 2, 128);
+    vocoder.setPitchRatio(2.0);
+
+    std::vector<float> left(128), right(128);
+    const int blocks = 48000 * 10 / 128;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (int block = 0; block < blocks; ++block)
+    {
+        for (int i = 0; i < 128; ++i)
+        {
+            left[static_cast<size_t>(i)] = dist(rng);
+            right[static_cast<size_t>(i)] = dist(rng);
+        }
+        float* io[2] = { left.data(), right.data() };
+        vocoder.processBlock(io, io, 128);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "10 s of audio in " << std::fixed << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(1) << seconds * 10.0 << "% of one core)" << std::defaultfloat << std::endl;
+    check(seconds < 1.0, "Well under 10% of a core");
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main()
+{
+    std::cout << "\n";
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Phase Vocoder Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    testSharedPlans();
+    testIdentity();
+    testPitchShift();
+    testTimeStretch();
+    testTransients();
+    testLiveCost();
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  " << (failures == 0 ? "All tests passed" : "Some tests FAILED") << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
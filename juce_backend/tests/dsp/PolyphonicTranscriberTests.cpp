@@ -0,0 +1,333 @@
+/*
+  ==============================================================================
+
+    PolyphonicTranscriberTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Accuracy and cost tests for the constant-Q transform and the
+    polyphonic transcriber
+    Checks bin levels, chord detection, silence and noise, offline note
+    timing, the threaded real-time front end and analysis cost
+
+  ==============================================================================
+*/
+
+#include "../include/dsp/ConstantQ.h"
+#include "../include/dsp/PolyphonicTranscriber.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace DSP;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static constexpr double sampleRate = 48000.0;
+static constexpr double pi = 3.14159265358979323846;
+
+static double noteFrequency(int note)
+{
+    return 440.0 * std::pow(2.0, (note - 69) / 12.0);
+}
+
+/** Adds a harmonic tone (partials falling as 1/h) with 5 ms ramps */
+static void addNote(std::vector<float>& signal, int note, double start, double duration, float amplitude)
+{
+    const auto from = static_cast<size_t>(start * sampleRate);
+    const auto to = std::min(signal.size(), static_cast<size_t>((start + duration) * sampleRate));
+    const double ramp = 0.005 * sampleRate;
+
+    for (size_t i = from; i < to; ++i)
+    {
+        const double t = static_cast<double>(i - from) / sampleRate;
+        const double envelope = std::min(1.0, static_cast<double>(i - from) / ramp)
+                              * std::min(1.0, static_cast<double>(to - i) / ramp);
+
+        for (int h = 1; h <= 8; ++h)
+        {
+            const double frequency = noteFrequency(note) * h;
+            if (frequency > 0.45 * sampleRate)
+                break;
+            signal[i] += static_cast<float>(amplitude / h * envelope * std::sin(2.0 * pi * frequency * t + h));
+        }
+    }
+}
+
+static std::vector<int> sortedNotes(const std::vector<PitchEstimate>& estimates)
+{
+    std::vector<int> notes;
+    for (const auto& estimate : estimates)
+        notes.push_back(estimate.note);
+    std::sort(notes.begin(), notes.end());
+    return notes;
+}
+
+/** Pitches of the last frame of a held chord */
+static std::vector<int> detect(PolyphonicTranscriber::Mode mode, std::vector<int> chord)
+{
+    std::vector<float> signal(static_cast<size_t>(sampleRate));
+    for (const int note : chord)
+        addNote(signal, note, 0.0, 1.0, 0.2f);
+
+    PolyphonicTranscriber transcriber(mode, sampleRate);
+    std::vector<NoteEvent> events;
+    transcriber.process(signal.data(), static_cast<int>(signal.size()), events);
+    return sortedNotes(transcriber.getLastEstimates());
+}
+
+//==============================================================================
+// Tests
+//==============================================================================
+
+static void testConstantQ()
+{
+    std::cout << "\n=== Constant-Q Transform ===" << std::endl;
+
+    ConstantQ cq(sampleRate, 13, 80.0, 4000.0, 36);
+    std::vector<float> magnitudes(static_cast<size_t>(cq.getNumBins()));
+
+    check(cq.getNumBins() == 204 && std::abs(cq.getFrequency(36) - 160.0) < 1.0e-6,
+          "Bins are log spaced, 36 per octave");
+    check(cq.getKernelLength(0) == cq.getFrameSize() && cq.getKernelLength(180) < cq.getFrameSize() / 8,
+          "Low kernels are cut to the frame; high ones are short");
+
+    const int bin = 100;
+    std::vector<float> frame(static_cast<size_t>(cq.getFrameSize()));
+    for (size_t i = 0; i < frame.size(); ++i)
+        frame[i] = 0.5f * static_cast<float>(std::sin(2.0 * pi * cq.getFrequency(bin) * static_cast<double>(i) / sampleRate));
+
+    cq.process(frame.data(), magnitudes.data());
+
+    const auto peak = std::max_element(magnitudes.begin(), magnitudes.end()) - magnitudes.begin();
+    check(peak == bin, "A sinusoid peaks in its own bin");
+    check(std::abs(magnitudes[bin] - 0.5f) < 0.01f, "The bin reads the sinusoid's amplitude");
+    check(magnitudes[bin + 2 * cq.getPeakWidth(bin)] < 0.01f, "Energy stays within the main lobe");
+}
+
+static void testChords()
+{
+    std::cout << "\n=== Chord Detection ===" << std::endl;
+
+    for (const auto mode : { PolyphonicTranscriber::Mode::RealTime, PolyphonicTranscriber::Mode::Offline })
+    {
+        const bool realTime = mode == PolyphonicTranscriber::Mode::RealTime;
+        std::cout << (realTime ? "  real-time mode" : "  offline mode") << std::endl;
+
+        check(detect(mode, { 57 }) == std::vector<int> { 57 }, "Single note");
+        check(detect(mode, { 40 }) == std::vector<int> { 40 }, "Lowest note of the range");
+        check(detect(mode, { 60, 64, 67 }) == std::vector<int> { 60, 64, 67 }, "Triad");
+        check(detect(mode, { 48, 60 }) == std::vector<int> { 48, 60 }, "Octave: the upper note is not a harmonic");
+        check(detect(mode, { 48, 52, 55, 60 }) == std::vector<int> { 48, 52, 55, 60 }, "Close voicing with a doubled root");
+        check(detect(mode, { 60, 64, 67, 71 }) == std::vector<int> { 60, 64, 67, 71 }, "Major seventh");
+        check(detect(mode, { 84, 88 }) == std::vector<int> { 84, 88 }, "High notes");
+    }
+
+    std::vector<float> signal(static_cast<size_t>(sampleRate));
+    addNote(signal, 69, 0.0, 1.0, 0.2f);
+    PolyphonicTranscriber transcriber(PolyphonicTranscriber::Mode::RealTime, sampleRate);
+    std::vector<NoteEvent> events;
+    transcriber.process(signal.data(), static_cast<int>(signal.size()), events);
+
+    const auto& estimates = transcriber.getLastEstimates();
+    check(estimates.size() == 1 && std::abs(estimates[0].cents) < 5.0f && estimates[0].confidence > 0.9f,
+          "A clean tone is in tune and confident");
+    check(transcriber.isNoteActive(69) && events.size() == 1 && events[0].type == NoteEvent::Type::NoteOn,
+          "A held note is announced once");
+}
+
+static void testSilenceAndNoise()
+{
+    std::cout << "\n=== Silence and Noise ===" << std::endl;
+
+    PolyphonicTranscriber transcriber(PolyphonicTranscriber::Mode::RealTime, sampleRate);
+    std::vector<NoteEvent> events;
+
+    std::vector<float> signal(static_cast<size_t>(sampleRate));
+    transcriber.process(signal.data(), static_cast<int>(signal.size()), events);
+    check(events.empty() && transcriber.getLastEstimates().empty(), "Silence has no pitch");
+
+    std::mt19937 random(1);
+    std::normal_distribution<float> gaussian(0.0f, 0.05f);
+    for (auto& sample : signal)
+        sample = gaussian(random);
+
+    transcriber.reset();
+    transcriber.process(signal.data(), static_cast<int>(signal.size()), events);
+    check(events.empty(), "White noise produces no notes");
+}
+
+static void testOfflineTiming()
+{
+    std::cout << "\n=== Offline Transcription ===" << std::endl;
+
+    struct Expected { int note; double start, end; };
+    const std::vector<Expected> expected = {
+        { 60, 0.2, 0.7 }, { 64, 0.2, 0.7 }, { 67, 0.9, 1.3 },
+        { 48, 1.5, 2.5 }, { 72, 1.6, 1.9 }, { 72, 2.0, 2.3 }  // Re-struck over the bass
+    };
+
+    std::vector<float> signal(static_cast<size_t>(3.0 * sampleRate));
+    for (const auto& note : expected)
+        addNote(signal, note.note, note.start, note.end - note.start, note.note == 48 ? 0.3f : 0.2f);
+
+    const auto notes = PolyphonicTranscriber::transcribe(signal.data(), static_cast<int>(signal.size()), sampleRate);
+
+    bool allFound = notes.size() == expected.size();
+    double worstStart = 0.0, worstEnd = 0.0;
+
+    for (const auto& want : expected)
+    {
+        const TranscribedNote* match = nullptr;
+        for (const auto& note : notes)
+            if (note.note == want.note && std::abs(note.start / sampleRate - want.start) < 0.1)
+                match = &note;
+
+        if (match == nullptr)
+        {
+            allFound = false;
+            continue;
+        }
+
+        worstStart = std::max(worstStart, std::abs(match->start / sampleRate - want.start));
+        worstEnd = std::max(worstEnd, std::abs(match->end / sampleRate - want.end));
+    }
+
+    std::cout << "  worst onset error " << std::fixed << std::setprecision(1) << worstStart * 1000.0
+              << " ms, offset error " << worstEnd * 1000.0 << " ms" << std::endl;
+
+    check(allFound, "Every note is found once, re-strikes separately");
+    check(worstStart < 0.015, "Onsets within 15 ms");
+    check(worstEnd < 0.05, "Offsets within 50 ms");
+
+    bool sorted = true;
+    for (size_t i = 1; i < notes.size(); ++i)
+        sorted = sorted && notes[i - 1].start <= notes[i].start;
+    check(sorted, "Notes come back in onset order");
+}
+
+static void testRealtimeTranscriber()
+{
+    std::cout << "\n=== Threaded Real-Time Transcription ===" << std::endl;
+
+    RealtimeTranscriber transcriber(sampleRate);
+    const int latency = transcriber.getLatency();
+
+    // Stereo input at the audio callback's pace
+    constexpr int blockSize = 512;
+    std::vector<float> left(static_cast<size_t>(1.5 * sampleRate));
+    addNote(left, 48, 0.2, 1.0, 0.2f);
+    addNote(left, 55, 0.2, 1.0, 0.2f);
+    addNote(left, 64, 0.2, 1.0, 0.2f);
+    std::vector<float> right = left;
+
+    transcriber.start();
+
+    std::vector<NoteEvent> events;
+    NoteEvent buffer[64];
+    int64_t worstDelay = 0;
+    int soundingMid = 0;
+    int soundingNotes[8] = {};
+
+    const auto blockTime = std::chrono::duration<double>(blockSize / sampleRate);
+    auto next = std::chrono::steady_clock::now();
+
+    for (size_t at = 0; at + blockSize <= left.size(); at += blockSize)
+    {
+        const float* channels[] = { left.data() + at, right.data() + at };
+        transcriber.pushAudio(channels, 2, blockSize);
+
+        const int count = transcriber.readEvents(buffer, 64);
+        for (int i = 0; i < count; ++i)
+        {
+            events.push_back(buffer[i]);
+            if (buffer[i].type == NoteEvent::Type::NoteOn)
+                worstDelay = std::max(worstDelay, static_cast<int64_t>(at + blockSize) - static_cast<int64_t>(0.2 * sampleRate));
+        }
+
+        if (at == static_cast<size_t>(1.0 * sampleRate) / blockSize * blockSize)
+            soundingMid = transcriber.getSoundingNotes(soundingNotes, 8);
+
+        next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(blockTime);
+        std::this_thread::sleep_until(next);
+    }
+
+    transcriber.stop();
+    const int count = transcriber.readEvents(buffer, 64);
+    events.insert(events.end(), buffer, buffer + count);
+
+    int numOn = 0, numOff = 0;
+    for (const auto& event : events)
+        (event.type == NoteEvent::Type::NoteOn ? numOn : numOff) += 1;
+
+    std::cout << "  latency bound " << latency * 1000.0 / sampleRate << " ms, slowest note-on seen after "
+              << worstDelay * 1000.0 / sampleRate << " ms" << std::endl;
+
+    check(numOn == 3 && numOff == 3, "Each chord note starts and stops once");
+    check(worstDelay <= latency + 2 * blockSize, "Note-ons arrive within the reported latency");
+    check(soundingMid == 3 && soundingNotes[0] == 48 && soundingNotes[1] == 55 && soundingNotes[2] == 64,
+          "The sounding-notes snapshot holds the chord, lowest first");
+    check(!transcriber.isNoteSounding(48) && !transcriber.isRunning(), "Stopping ends every note");
+    check(transcriber.getNumDroppedSamples() == 0 && transcriber.getNumSkippedSamples() == 0
+              && transcriber.getNumDroppedEvents() == 0,
+          "Nothing is dropped at real-time pace");
+}
+
+static void testCost()
+{
+    std::cout << "\n=== Cost ===" << std::endl;
+
+    std::vector<float> signal(static_cast<size_t>(2.0 * sampleRate));
+    for (const int note : { 48, 55, 60, 64, 67, 71 })
+        addNote(signal, note, 0.0, 2.0, 0.1f);
+
+    for (const auto mode : { PolyphonicTranscriber::Mode::RealTime, PolyphonicTranscriber::Mode::Offline })
+    {
+        PolyphonicTranscriber transcriber(mode, sampleRate);
+        std::vector<NoteEvent> events;
+
+        const auto start = std::chrono::steady_clock::now();
+        transcriber.process(signal.data(), static_cast<int>(signal.size()), events);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double speed = 2.0 / seconds;
+
+        const bool realTime = mode == PolyphonicTranscriber::Mode::RealTime;
+        std::cout << (realTime ? "  real-time mode: " : "  offline mode: ") << std::setprecision(1) << speed
+                  << "x real time, " << transcriber.getHopSize() << " sample hop" << std::endl;
+
+        check(speed > (realTime ? 20.0 : 2.0), realTime ? "Real-time mode leaves the CPU mostly idle"
+                                                        : "Offline mode runs faster than real time");
+    }
+}
+
+int main()
+{
+    std::cout << "Polyphonic Transcriber Tests" << std::endl;
+
+    testConstantQ();
+    testChords();
+    testSilenceAndNoise();
+    testOfflineTiming();
+    testRealtimeTranscriber();
+    testCost();
+
+    std::cout << "\n" << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+/*
+  ==============================================================================
+
+    RealtimeLogTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Tests for the deferred realtime logger
+    Checks record formatting, severity filters, rate limiting, ring
+    overflow, many producer threads and the cost of a call
+
+  ==============================================================================
+*/
+
+#include "../include/dsp/RealtimeLog.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace DSP;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+/** Collects what the writer hands to the sink */
+struct Capture
+{
+    std::mutex mutex;
+    std::vector<std::string> lines;
+
+    Capture()
+    {
+        RealtimeLog::instance().setSink([this](LogLevel, const char* line)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lines.push_back(line);
+        });
+    }
+
+    ~Capture() { RealtimeLog::instance().setSink({}); }
+
+    std::vector<std::string> take()
+    {
+        RealtimeLog::instance().flush();
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::move(lines);
+    }
+};
+
+static bool endsWith(const std::string& line, const std::string& tail)
+{
+    return line.size() >= tail.size() && line.compare(line.size() - tail.size(), tail.size(), tail) == 0;
+}
+
+static int countContaining(const std::vector<std::string>& lines, const std::string& text)
+{
+    int count = 0;
+    for (const auto& line : lines)
+        count += line.find(text) != std::string::npos ? 1 : 0;
+    return count;
+}
+
+static int sideEffects = 0;
+
+static int touch()
+{
+    return ++sideEffects;
+}
+
+//==============================================================================
+// Tests
+//==============================================================================
+
+static void testFormatting()
+{
+    std::cout << "\n=== Formatting ===" << std::endl;
+
+    static LogSite site { LogLevel::Info, "%s: %d of %u at %.2f (%5.1f%%) %lld %zu %x [%s]", __FILE__, __LINE__ };
+
+    LogRecord record;
+    record.site = &site;
+    record.add("cutoff");
+    record.add(-3);
+    record.add(7u);
+    record.add(0.5f);
+    record.add(12.25);
+    record.add(static_cast<long long>(1) << 40);
+
+    check(RealtimeLog::formatMessage(record) == "cutoff: -3 of 7 at 0.50 ( 12.2%) 1099511627776 <?> <?> [<?>]",
+          "Arguments format with their own conversions; missing ones are marked");
+
+    static LogSite textSite { LogLevel::Info, "%s|%s|%s", __FILE__, __LINE__ };
+    LogRecord texts;
+    texts.site = &textSite;
+    texts.add("a parameter name longer than the text area of one record");
+    texts.add("second");
+    texts.add(static_cast<const char*>(nullptr));
+
+    const auto message = RealtimeLog::formatMessage(texts);
+    check(message.rfind("a parameter name longer than the text a|", 0) == 0 && endsWith(message, "||"),
+          "C strings are copied, truncated to the record");
+
+    static LogSite mixedSite { LogLevel::Info, "%d %.1f %c", __FILE__, __LINE__ };
+    LogRecord mixed;
+    mixed.site = &mixedSite;
+    mixed.add(2.9);
+    mixed.add(3);
+    mixed.add('A');
+    check(RealtimeLog::formatMessage(mixed) == "2 3.0 A", "Numbers convert to the conversion asked for");
+}
+
+static void testDeferredWrite()
+{
+    std::cout << "\n=== Deferred Write ===" << std::endl;
+
+    Capture capture;
+    auto& log = RealtimeLog::instance();
+    log.setLevel(LogLevel::Info);
+    log.setRateLimit(0);
+
+    std::thread audio([]
+    {
+        for (int i = 0; i < 10; ++i)
+            DSP_LOG_INFO("block %d rendered in %.1f us", i, 10.0 + i);
+    });
+    audio.join();
+
+    const auto lines = capture.take();
+    bool inOrder = lines.size() == 10;
+    for (size_t i = 0; inOrder && i < lines.size(); ++i)
+        inOrder = endsWith(lines[i], "[INFO] block " + std::to_string(i) + " rendered in "
+                                   + std::to_string(10 + i) + ".0 us");
+
+    check(inOrder, "Records from another thread are written in order");
+    check(!lines.empty() && lines[0][0] == '[' && lines[0].find("] [INFO] ") != std::string::npos,
+          "Lines carry a timestamp and level");
+}
+
+static void testFilters()
+{
+    std::cout << "\n=== Severity Filters ===" << std::endl;
+
+    Capture capture;
+    auto& log = RealtimeLog::instance();
+    log.setRateLimit(0);
+
+    log.setLevel(LogLevel::Warning);
+    DSP_LOG_INFO("filtered at run time %d", 1);
+    DSP_LOG_WARNING("warning passes %d", 2);
+    DSP_LOG_ERROR("error passes %d", 3);
+
+    auto lines = capture.take();
+    check(lines.size() == 2 && countContaining(lines, "passes") == 2, "Run-time level filters at the call");
+
+    // DSP_LOG_MIN_LEVEL is info in this build: debug calls do not exist
+    log.setLevel(LogLevel::Debug);
+    sideEffects = 0;
+    DSP_LOG_DEBUG("compiled out %d", touch());
+
+    lines = capture.take();
+    check(lines.empty() && sideEffects == 0, "Compile-time level removes the call and its arguments");
+
+    log.setLevel(LogLevel::Off);
+    DSP_LOG_ERROR("nothing when off");
+    check(capture.take().empty(), "Off silences everything");
+    log.setLevel(LogLevel::Info);
+}
+
+static void testRateLimit()
+{
+    std::cout << "\n=== Rate Limiting ===" << std::endl;
+
+    Capture capture;
+    auto& log = RealtimeLog::instance();
+    log.setRateLimit(5);
+
+    const auto suppressedBefore = log.getNumSuppressed();
+
+    // Only flush() writes, so nothing reports the repeats behind our back
+    log.setFlushInterval(std::chrono::seconds(10));
+
+    auto flood = []
+    {
+        for (int i = 0; i < 1000; ++i)
+            DSP_LOG_WARNING("denormal storm in voice %d", i);
+    };
+
+    flood();
+    auto lines = capture.take();
+    check(lines.size() == 5, "A flooding site writes its limit per second");
+
+    // After the window, the next record reports what was held back
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    DSP_LOG_WARNING("other site %d", 1);
+    flood();
+    lines = capture.take();
+
+    check(countContaining(lines, "(995 similar suppressed)") == 1, "Next record of the site counts the repeats");
+    check(countContaining(lines, "other site") == 1, "Limits are per site");
+
+    // A site that goes quiet gets a summary line instead
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    lines = capture.take();
+    check(countContaining(lines, "995 more like \"denormal storm in voice %d\" suppressed") == 1,
+          "Quiet sites report their suppressed repeats");
+    check(log.getNumSuppressed() - suppressedBefore == 1990, "Suppressed records are counted");
+
+    log.setRateLimit(0);
+    log.setFlushInterval(std::chrono::milliseconds(20));
+}
+
+static void testOverflow()
+{
+    std::cout << "\n=== Ring Overflow ===" << std::endl;
+
+    Capture capture;
+    auto& log = RealtimeLog::instance();
+    log.setRateLimit(0);
+
+    // Let the writer sleep while one thread overfills its ring
+    log.setFlushInterval(std::chrono::seconds(10));
+
+    const auto droppedBefore = log.getNumDropped();
+
+    std::thread audio([]
+    {
+        for (int i = 0; i < RealtimeLog::recordsPerThread + 44; ++i)
+            DSP_LOG_INFO("record %d", i);
+    });
+    audio.join();
+
+    const auto lines = capture.take();
+    log.setFlushInterval(std::chrono::milliseconds(20));
+
+    check(log.getNumDropped() - droppedBefore == 44, "A full ring drops and counts");
+    check(countContaining(lines, "record ") == RealtimeLog::recordsPerThread, "What fitted is written");
+    check(countContaining(lines, "44 log records dropped") == 1, "Drops are reported");
+}
+
+static void testManyThreads()
+{
+    std::cout << "\n=== Many Threads ===" << std::endl;
+
+    Capture capture;
+    auto& log = RealtimeLog::instance();
+    log.setRateLimit(0);
+
+    // 16 threads alive at once, each on its own ring, and more threads over
+    // the rounds than there are rings: exiting threads must give theirs back
+    bool allWritten = true;
+
+    for (int round = 0; round < 3; ++round)
+    {
+        std::atomic<int> finished { 0 };
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < 16; ++t)
+        {
+            threads.emplace_back([t, &finished]
+            {
+                for (int i = 0; i < 100; ++i)
+                    DSP_LOG_INFO("thread %d record %d", t, i);
+
+                finished.fetch_add(1);
+                while (finished.load() < 16)
+                    std::this_thread::yield();
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        const auto lines = capture.take();
+        allWritten = allWritten && lines.size() == 16 * 100;
+
+        for (int t = 0; t < 16 && allWritten; ++t)
+        {
+            // Each thread's records stay in order
+            int next = 0;
+            const std::string tag = "thread " + std::to_string(t) + " record ";
+            for (const auto& line : lines)
+            {
+                const auto at = line.find(tag);
+                if (at != std::string::npos && std::stoi(line.substr(at + tag.size())) == next)
+                    ++next;
+            }
+            allWritten = next == 100;
+        }
+    }
+
+    check(allWritten, "48 threads in 3 rounds through 32 rings, each in order");
+}
+
+static void testCost()
+{
+    std::cout << "\n=== Cost ===" << std::endl;
+
+    Capture capture;
+    auto& log = RealtimeLog::instance();
+    log.setRateLimit(0);
+
+    constexpr int numCalls = 200;
+    double worst = 0.0, total = 0.0;
+
+    for (int i = 0; i < numCalls; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        DSP_LOG_INFO("voice %d gain %.3f name %s", i, 0.5 * i, "lead");
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        worst = std::max(worst, ns);
+        total += ns;
+    }
+
+    capture.take();
+
+    std::cout << "  log call: " << std::fixed << std::setprecision(0) << total / numCalls << " ns mean, "
+              << worst << " ns worst" << std::endl;
+    check(total / numCalls < 2000.0, "A log call costs well under a microsecond or two");
+}
+
+int main()
+{
+    std::cout << "Realtime Log Tests" << std::endl;
+
+    RealtimeLog::instance();
+
+    testFormatting();
+    testDeferredWrite();
+    testFilters();
+    testRateLimit();
+    testOverflow();
+    testManyThreads();
+    testCost();
+
+    std::cout << "\n" << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,382 @@
+/*
+  ==============================================================================
+
+    SegmentEnvelopeBankTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Tests for the segment envelope bank against the reference ADSREnvelope
+    Checks that linear stages match the reference sample for sample, stage
+    timing and levels with curves, velocity and accent, sample-accurate gate
+    events, retriggers, many voices at once and block size independence
+
+  ==============================================================================
+*/
+
+#include "ADSREnvelope.h"
+#include "SegmentEnvelopeBank.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int numSamples = 12000;
+static constexpr float attackStep = 1.0f / 480.0f;     // One sample of a 10 ms attack
+
+using Stage = ADSREnvelope::EnvelopeStage;
+
+struct Gate
+{
+    int voice;
+    int time;           // Samples from the start of the render
+    bool on;
+    float velocity = 1.0f;
+    bool accent = false;
+};
+
+static ADSREnvelope::ADSRParams linearParams()
+{
+    ADSREnvelope::ADSRParams params;
+    params.attack = 0.01f;
+    params.decay = 0.05f;
+    params.sustain = 0.6f;
+    params.release = 0.08f;
+    params.attackCurve = 0.0f;
+    params.decayCurve = 0.0f;
+    params.releaseCurve = 0.0f;
+    params.velocitySensitivity = false;
+    return params;
+}
+
+/** One note through the reference envelope, gates applied before their sample */
+static std::vector<float> renderReference(const ADSREnvelope::ADSRParams& params, int onTime, int offTime,
+                                          float velocity = 1.0f, bool accent = false)
+{
+    ADSREnvelope envelope;
+    envelope.setSampleRate(sampleRate);
+    envelope.setParams(params);
+
+    std::vector<float> output(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (i == onTime)
+            envelope.noteOn(60, velocity, accent);
+        if (i == offTime)
+            envelope.noteOff();
+        output[(size_t) i] = envelope.getNextValue();
+    }
+    return output;
+}
+
+/** Every voice of the bank, with gates split into the blocks they land in */
+static std::vector<std::vector<float>> renderBank(const ADSREnvelope::ADSRParams& params, int numVoices,
+                                                  const std::vector<Gate>& gates, int blockSize)
+{
+    SegmentEnvelopeBank bank;
+    bank.prepare(sampleRate, blockSize, numVoices);
+    bank.setParams(params);
+
+    std::vector<std::vector<float>> output((size_t) numVoices, std::vector<float>(numSamples));
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        const int n = std::min(blockSize, numSamples - start);
+
+        for (const auto& gate : gates)
+        {
+            if (gate.time < start || gate.time >= start + n)
+                continue;
+            if (gate.on)
+                bank.noteOn(gate.voice, gate.time - start, gate.velocity, gate.accent);
+            else
+                bank.noteOff(gate.voice, gate.time - start);
+        }
+
+        bank.process(n);
+        for (int voice = 0; voice < numVoices; ++voice)
+            bank.copyVoice(voice, output[(size_t) voice].data() + start, n);
+    }
+    return output;
+}
+
+static float maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+{
+    float difference = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i)
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+    return difference;
+}
+
+/** First sample at or after from where the envelope reaches value */
+static int firstAt(const std::vector<float>& data, float value, int from = 0, float tolerance = 1.0e-5f)
+{
+    for (int i = from; i < (int) data.size(); ++i)
+        if (std::abs(data[(size_t) i] - value) <= tolerance)
+            return i;
+    return -1;
+}
+
+//==============================================================================
+// Reference Comparison
+//==============================================================================
+
+static void testLinearMatchesReference()
+{
+    std::cout << "\n=== Linear Stages ===" << std::endl;
+
+    const auto params = linearParams();
+    const auto reference = renderReference(params, 0, 6000);
+    const auto bank = renderBank(params, 1, { { 0, 0, true }, { 0, 6000, false } }, 512)[0];
+
+    const float difference = maxDifference(reference, bank);
+    std::cout << "Largest difference from ADSREnvelope " << difference << std::endl;
+    check(difference < 1.0e-4f, "Linear attack, decay, sustain and release match the reference");
+
+    // 10 ms attack, 50 ms decay, 80 ms release at 48 kHz
+    check(firstAt(bank, 1.0f) == 479, "The peak lands after the attack time");
+    check(firstAt(bank, 0.6f, 480) == 479 + 2400, "Decay lands on sustain after the decay time");
+    check(firstAt(bank, 0.0f, 6000) == 6000 + 3839, "Release reaches zero after the release time");
+    check(bank[4000] == 0.6f && bank.back() == 0.0f, "Sustain and idle hold their levels exactly");
+
+    // A note released during the attack releases from where it is
+    const auto early = renderReference(params, 0, 200);
+    const auto earlyBank = renderBank(params, 1, { { 0, 0, true }, { 0, 200, false } }, 512)[0];
+    check(maxDifference(early, earlyBank) < 1.0e-4f, "An early release matches the reference");
+}
+
+static void testVelocityAndAccent()
+{
+    std::cout << "\n=== Velocity and Accent ===" << std::endl;
+
+    auto params = linearParams();
+    params.velocitySensitivity = true;
+    params.velocityAmount = 0.5f;
+    params.accentAmount = 1.5f;
+
+    float worst = 0.0f;
+    for (float velocity : { 0.2f, 0.6f, 1.0f })
+    {
+        for (bool accent : { false, true })
+        {
+            const auto reference = renderReference(params, 100, 7000, velocity, accent);
+            const auto bank = renderBank(params, 1, { { 0, 100, true, velocity, accent }, { 0, 7000, false } }, 256)[0];
+            worst = std::max(worst, maxDifference(reference, bank));
+        }
+    }
+
+    // Velocity makes the attack a fractional number of samples long; the
+    // bank rounds it to whole samples, so the ramps differ by under a step
+    std::cout << "Largest difference from ADSREnvelope " << worst << std::endl;
+    check(worst < attackStep, "Velocity scales peak, sustain and attack time like the reference");
+
+    // Velocity 0.6 at amount 0.5: factor 0.51, attack 1.147x longer
+    const auto bank = renderBank(params, 1, { { 0, 0, true, 0.6f } }, 256)[0];
+    check(firstAt(bank, 0.51f) == (int) std::lround(0.01 * 1.147 * sampleRate) - 1, "Soft notes attack more slowly");
+    check(std::abs(bank[5000] - 0.6f * 0.51f) < 1.0e-6f, "Sustain scales with velocity");
+}
+
+static void testCurvedStages()
+{
+    std::cout << "\n=== Curved Stages ===" << std::endl;
+
+    // The bank's curves are geometric, the reference's quadratic: the shapes
+    // differ, the stage times and levels do not
+    auto params = linearParams();
+    params.attackCurve = 0.5f;
+    params.decayCurve = 0.8f;
+    params.releaseCurve = 0.3f;
+
+    const auto reference = renderReference(params, 0, 6000);
+    const auto bank = renderBank(params, 1, { { 0, 0, true }, { 0, 6000, false } }, 512)[0];
+
+    // Geometric stages come very close to their end early, so look for the
+    // exact end values. The reference sums its progress in float and can
+    // land a sample late on long stages.
+    const auto sameTime = [&](float value, int from) {
+        const int time = firstAt(bank, value, from, 0.0f), expected = firstAt(reference, value, from, 0.0f);
+        return time > 0 && std::abs(time - expected) <= 1;
+    };
+    check(sameTime(1.0f, 0), "Curved attack peaks when the reference does");
+    check(sameTime(0.6f, 480), "Curved decay reaches sustain when the reference does");
+    check(sameTime(0.0f, 6000), "Curved release ends when the reference does");
+
+    bool monotonic = true;
+    for (int i = 1; i < numSamples; ++i)
+    {
+        const float step = bank[(size_t) i] - bank[(size_t) i - 1];
+        if (i < 480)
+            monotonic = monotonic && step > 0.0f;
+        else
+            monotonic = monotonic && step <= 0.0f;
+    }
+    check(monotonic, "Curved stages move steadily toward their end values");
+}
+
+//==============================================================================
+// Gate Events
+//==============================================================================
+
+static void testSampleAccurateGates()
+{
+    std::cout << "\n=== Sample-Accurate Gates ===" << std::endl;
+
+    const auto params = linearParams();
+    const auto reference = renderReference(params, 0, 3000);
+
+    // The same note starting at several offsets inside a block is the
+    // reference delayed by exactly that many samples
+    bool shifted = true;
+    for (int onTime : { 1, 100, 255, 256, 777 })
+    {
+        const auto bank = renderBank(params, 1, { { 0, onTime, true }, { 0, onTime + 3000, false } }, 256)[0];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float expected = (i < onTime) ? 0.0f : reference[(size_t) (i - onTime)];
+            shifted = shifted && std::abs(bank[(size_t) i] - expected) < 1.0e-4f;
+        }
+    }
+    check(shifted, "Gate events apply at their sample offset");
+
+    SegmentEnvelopeBank bank;
+    bank.prepare(sampleRate, 128, 1);
+    bank.setParams(params);
+    bank.noteOn(0, 64);
+    bank.process(128);
+    check(bank.getVoiceOutput(0)[63 * bank.getStride()] == 0.0f && bank.getVoiceOutput(0)[64 * bank.getStride()] > 0.0f,
+          "Nothing sounds before the note's sample");
+    check(bank.getVoiceStage(0) == Stage::Attack && bank.isVoiceActive(0), "The voice reports its stage");
+}
+
+static void testRetrigger()
+{
+    std::cout << "\n=== Retrigger ===" << std::endl;
+
+    const auto params = linearParams();
+    const auto bank = renderBank(params, 1, { { 0, 0, true }, { 0, 3000, false }, { 0, 4000, true } }, 512)[0];
+
+    // Unlike the reference, which restarts from zero, the bank attacks from
+    // where the release had got to and only covers the remaining distance
+    const float before = bank[3999];
+    check(bank[4000] > before && bank[4000] - before < 2.0f / 480.0f, "A retrigger attacks from the current value");
+
+    const int expectedLength = (int) std::lround(0.01 * sampleRate * (1.0 - before));
+    check(firstAt(bank, 1.0f, 4000) == 4000 + expectedLength - 1, "The attack time scales with the distance left");
+    check(std::abs(bank[9000] - 0.6f) < 1.0e-6f, "The retriggered note decays to sustain");
+}
+
+//==============================================================================
+// Voices and Block Sizes
+//==============================================================================
+
+static void testManyVoices()
+{
+    std::cout << "\n=== Many Voices ===" << std::endl;
+
+    auto params = linearParams();
+    params.velocitySensitivity = true;
+
+    // Every voice gets its own note; each must match a reference of its own
+    std::vector<Gate> gates;
+    for (int voice = 0; voice < SegmentEnvelopeBank::maxVoices; ++voice)
+    {
+        const int onTime = voice * 37;
+        gates.push_back({ voice, onTime, true, 0.2f + 0.8f * (float) (voice % 5) / 4.0f, voice % 7 == 0 });
+        gates.push_back({ voice, onTime + 2500 + voice * 11, false });
+    }
+
+    const auto voices = renderBank(params, SegmentEnvelopeBank::maxVoices, gates, 512);
+
+    float worst = 0.0f;
+    for (int voice = 0; voice < SegmentEnvelopeBank::maxVoices; ++voice)
+    {
+        const auto& on = gates[(size_t) voice * 2];
+        const auto reference = renderReference(params, on.time, gates[(size_t) voice * 2 + 1].time, on.velocity, on.accent);
+        worst = std::max(worst, maxDifference(reference, voices[(size_t) voice]));
+    }
+
+    std::cout << "Largest difference over 64 voices " << worst << std::endl;
+    check(worst < attackStep, "Every voice matches its own reference envelope");
+
+    // Odd voice counts still use whole SIMD lanes
+    SegmentEnvelopeBank bank;
+    bank.prepare(sampleRate, 64, 5);
+    check(bank.getStride() == SegmentEnvelopeBank::laneCount, "The stride rounds up to the lane width");
+    check(!bank.isVoiceActive(5) && bank.getCurrentValue(-1) == 0.0f, "Voices outside the bank are idle");
+}
+
+static void testBlockSizes()
+{
+    std::cout << "\n=== Block Sizes ===" << std::endl;
+
+    auto params = linearParams();
+    params.attackCurve = 0.7f;
+    params.releaseCurve = 0.4f;
+
+    std::vector<Gate> gates;
+    for (int voice = 0; voice < 12; ++voice)
+    {
+        gates.push_back({ voice, 50 + voice * 301, true, 0.9f });
+        gates.push_back({ voice, 2000 + voice * 97, false });
+    }
+
+    const auto small = renderBank(params, 12, gates, 29);
+    const auto large = renderBank(params, 12, gates, 1024);
+    check(small == large, "Output does not depend on the host block size");
+
+    // applyToVoice multiplies the audio by the voice's envelope
+    SegmentEnvelopeBank bank;
+    bank.prepare(sampleRate, 256, 2);
+    bank.setParams(params);
+    bank.noteOn(1, 0);
+    bank.process(256);
+
+    std::vector<float> audio(256, 0.5f), envelope(256);
+    bank.applyToVoice(1, audio.data(), 256);
+    bank.copyVoice(1, envelope.data(), 256);
+
+    bool applied = true;
+    for (int i = 0; i < 256; ++i)
+        applied = applied && audio[(size_t) i] == 0.5f * envelope[(size_t) i];
+    check(applied, "applyToVoice scales audio by the envelope");
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main()
+{
+    std::cout << "\n";
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Segment Envelope Bank Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    testLinearMatchesReference();
+    testVelocityAndAccent();
+    testCurvedStages();
+    testSampleAccurateGates();
+    testRetrigger();
+    testManyVoices();
+    testBlockSizes();
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  " << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
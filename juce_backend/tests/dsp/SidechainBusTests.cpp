@@ -0,0 +1,427 @@
+/*
+  ==============================================================================
+
+    SidechainBusTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Tests for the shared sidechain key bus
+    Checks key publishing by reference, block validity, detector sharing and
+    reference counting, the detector streams against a direct computation,
+    that compressors keyed from a shared stream match private detection, and
+    that detector storage replaced by an edit outlives the block reading it
+
+  ==============================================================================
+*/
+
+#include "routing/SidechainBus.h"
+#include "dynamics/DynamicsConfig.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace SchillingerEcosystem::Routing;
+using namespace schill::dynamics;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static constexpr double sampleRate = 48000.0;
+static constexpr double pi = 3.14159265358979323846;
+static constexpr int blockSize = 256;
+
+/** Kick-like key: decaying 55 Hz bursts every 250 ms */
+static std::vector<float> kick(int numSamples, float gain = 0.9f)
+{
+    std::vector<float> data((size_t) numSamples);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int phase = i % 12000;
+        data[(size_t) i] = gain * std::exp(-phase / 2400.0f) * (float) std::sin(2.0 * pi * 55.0 * phase / sampleRate);
+    }
+    return data;
+}
+
+static std::vector<float> sine(int numSamples, double hz, float amplitude)
+{
+    std::vector<float> data((size_t) numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        data[(size_t) i] = amplitude * (float) std::sin(2.0 * pi * hz * i / sampleRate);
+    return data;
+}
+
+/** Power of the last window samples ending at i, as the detector defines it */
+static float windowPower(const std::vector<float>& data, int i, int window, bool peak)
+{
+    double result = 0.0;
+    for (int n = std::max(0, i - window + 1); n <= i; ++n)
+    {
+        const double squared = (double) data[(size_t) n] * data[(size_t) n];
+        result = peak ? std::max(result, squared) : result + squared;
+    }
+    return (float) (peak ? result : result / window);
+}
+
+//==============================================================================
+// Keys
+//==============================================================================
+
+static void testKeys()
+{
+    std::cout << "\n=== Keys ===" << std::endl;
+
+    SidechainBus bus;
+    bus.prepare(sampleRate, blockSize);
+
+    const auto kickKey = bus.addKey("kick");
+    const auto vocalKey = bus.addKey("vocal");
+    check(kickKey != SidechainBus::invalidId && vocalKey != kickKey, "Keys get their own ids");
+    check(bus.addKey("kick") == kickKey && bus.findKey("vocal") == vocalKey && bus.getNumKeys() == 2,
+          "Keys are found by name");
+    check(bus.findKey("bass") == SidechainBus::invalidId, "Unknown names are not keys");
+
+    auto left = kick(blockSize), right = kick(blockSize, 0.5f);
+    const float* channels[] = { left.data(), right.data() };
+
+    bus.beginBlock();
+    check(!bus.getKey(kickKey).isValid(), "An unpublished key has no view");
+
+    bus.publish(kickKey, channels, 2, blockSize);
+    const auto span = bus.getKey(kickKey);
+    check(span.isValid() && span.channels == channels && span.numChannels == 2 && span.numSamples == blockSize,
+          "Publishing hands out the caller's channels, not a copy");
+    check(!bus.getKey(vocalKey).isValid(), "Other keys stay unpublished");
+
+    bus.beginBlock();
+    check(!bus.getKey(kickKey).isValid(), "Views expire at the next block");
+
+    bus.removeKey(kickKey);
+    bus.beginBlock();
+    bus.publish(kickKey, channels, 2, blockSize);
+    check(!bus.getKey(kickKey).isValid() && bus.getNumKeys() == 1, "Removed keys are not published");
+}
+
+//==============================================================================
+// Detector Sharing
+//==============================================================================
+
+static void testSharing()
+{
+    std::cout << "\n=== Detector Sharing ===" << std::endl;
+
+    SidechainBus bus;
+    bus.prepare(sampleRate, blockSize);
+    const auto key = bus.addKey("kick");
+    const auto other = bus.addKey("bus");
+
+    const auto first = bus.subscribe(key, SidechainBus::DetectorSpec::rms());
+    const auto second = bus.subscribe(key, SidechainBus::DetectorSpec::rms());
+    const auto filtered = bus.subscribe(key, SidechainBus::DetectorSpec::rms(100.0f));
+    const auto peak = bus.subscribe(key, SidechainBus::DetectorSpec::peak());
+    const auto elsewhere = bus.subscribe(other, SidechainBus::DetectorSpec::rms());
+
+    check(first == second, "Equal settings share one detector");
+    check(filtered != first && peak != first && elsewhere != first, "Different settings or keys get their own");
+    check(bus.getNumDetectors(key) == 3 && bus.getNumDetectors(other) == 1, "Detectors are counted per key");
+    check(bus.getKeyOf(first) == key && bus.getKeyOf(elsewhere) == other, "A subscription knows its key");
+    check(bus.subscribe(SidechainBus::invalidId, SidechainBus::DetectorSpec::rms()) == SidechainBus::invalidId,
+          "Subscribing to no key fails");
+
+    bus.unsubscribe(first);
+    check(bus.getNumDetectors(key) == 3, "A shared detector lives while anyone listens");
+    bus.unsubscribe(second);
+    check(bus.getNumDetectors(key) == 2 && bus.getKeyOf(first) == SidechainBus::invalidId,
+          "The last unsubscribe releases it");
+
+    bus.removeKey(key);
+    check(bus.getNumDetectors(key) == 0 && bus.getNumDetectors(other) == 1, "Subscriptions die with their key");
+
+    // Ten consumers of one kick cost one detector
+    SidechainBus shared;
+    shared.prepare(sampleRate, blockSize);
+    const auto kickKey = shared.addKey("kick");
+    for (int track = 0; track < 10; ++track)
+        shared.subscribe(kickKey, SidechainBus::DetectorSpec::rms());
+    check(shared.getNumDetectors(kickKey) == 1, "Ten subscribers with one setting share one detector");
+}
+
+//==============================================================================
+// Detector Streams
+//==============================================================================
+
+static void testDetectorStreams()
+{
+    std::cout << "\n=== Detector Streams ===" << std::endl;
+
+    SidechainBus bus;
+    bus.prepare(sampleRate, blockSize);
+    const auto key = bus.addKey("kick");
+    const auto rms = bus.subscribe(key, SidechainBus::DetectorSpec::rms());
+    const auto peak = bus.subscribe(key, SidechainBus::DetectorSpec::peak());
+
+    const int numSamples = blockSize * 40;
+    const auto left = kick(numSamples), right = sine(numSamples, 300.0, 0.3f);
+
+    float rmsError = 0.0f, peakError = 0.0f;
+    bool everyBlock = true;
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        const float* channels[] = { left.data() + start, right.data() + start };
+        bus.beginBlock();
+        bus.publish(key, channels, 2, blockSize);
+
+        const auto rmsSpan = bus.getDetector(rms), peakSpan = bus.getDetector(peak);
+        everyBlock = everyBlock && rmsSpan.isValid() && peakSpan.isValid() && rmsSpan.numSamples == blockSize;
+        if (!everyBlock)
+            break;
+
+        // Fully linked: the louder channel's window power
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const int n = start + i;
+            const float expectedRms = std::max(windowPower(left, n, 480, false), windowPower(right, n, 480, false));
+            const float expectedPeak = std::max(windowPower(left, n, 48, true), windowPower(right, n, 48, true));
+            rmsError = std::max(rmsError, std::abs(rmsSpan.power[i] - expectedRms));
+            peakError = std::max(peakError, std::abs(peakSpan.power[i] - expectedPeak));
+        }
+    }
+
+    std::cout << "RMS error " << rmsError << ", peak error " << peakError << std::endl;
+    check(everyBlock, "Detectors publish with their key every block");
+    check(rmsError < 1.0e-5f, "The RMS stream is the 10 ms mean square of the louder channel");
+    check(peakError < 1.0e-7f, "The peak stream is the 1 ms peak power of the louder channel");
+
+    bus.beginBlock();
+    check(!bus.getDetector(rms).isValid(), "Detector streams expire with the block");
+}
+
+static void testKeyFilter()
+{
+    std::cout << "\n=== Key Filter ===" << std::endl;
+
+    SidechainBus bus;
+    bus.prepare(sampleRate, blockSize);
+    const auto key = bus.addKey("bus");
+    const auto plain = bus.subscribe(key, SidechainBus::DetectorSpec::rms());
+    const auto filtered = bus.subscribe(key, SidechainBus::DetectorSpec::rms(200.0f));
+
+    // A 40 Hz rumble under a 2 kHz tone: the filter keys only from the tone
+    const int numSamples = (int) sampleRate / 2;
+    auto rumble = sine(numSamples, 40.0, 0.5f);
+    const auto tone = sine(numSamples, 2000.0, 0.05f);
+    for (int i = 0; i < numSamples; ++i)
+        rumble[(size_t) i] += tone[(size_t) i];
+
+    float plainPower = 0.0f, filteredPower = 0.0f;
+    for (int start = 0; start + blockSize <= numSamples; start += blockSize)
+    {
+        const float* channels[] = { rumble.data() + start };
+        bus.beginBlock();
+        bus.publish(key, channels, 1, blockSize);
+        plainPower = bus.getDetector(plain).power[blockSize - 1];
+        filteredPower = bus.getDetector(filtered).power[blockSize - 1];
+    }
+
+    const float plainDb = 10.0f * std::log10(plainPower), filteredDb = 10.0f * std::log10(filteredPower);
+    const float toneDb = 20.0f * std::log10(0.05f / std::sqrt(2.0f));
+    std::cout << "Unfiltered " << plainDb << " dB, filtered " << filteredDb << " dB, tone " << toneDb << " dB" << std::endl;
+    check(plainDb > toneDb + 15.0f, "Without the filter the rumble dominates");
+    check(std::abs(filteredDb - toneDb) < 1.0f, "The high-pass keys from the tone alone");
+}
+
+//==============================================================================
+// Compressors on a Shared Stream
+//==============================================================================
+
+static void testCompressorEquivalence()
+{
+    std::cout << "\n=== Compressors on a Shared Stream ===" << std::endl;
+
+    const int numSamples = blockSize * 60;
+    const auto keyLeft = kick(numSamples), keyRight = kick(numSamples, 0.6f);
+
+    bool identical = true;
+    for (auto mode : { CompressorMode::Peak, CompressorMode::RMS, CompressorMode::TruePeak, CompressorMode::RMS_VU })
+    {
+        CompressorConfig config;
+        config.threshold = -30.0f;
+        config.ratio = 8.0f;
+        config.attackTime = 1.0f;
+        config.releaseTime = 80.0f;
+        config.mode = mode;
+        config.stereoLinkRatio = 1.0f;
+
+        // Two tracks ducking off the key, plus one with private detection
+        CompressorCore bass, pad, reference;
+        for (auto* compressor : { &bass, &pad, &reference })
+        {
+            compressor->prepare(sampleRate, blockSize);
+            compressor->setParameters(config);
+        }
+
+        SidechainBus bus;
+        bus.prepare(sampleRate, blockSize);
+        const auto key = bus.addKey("kick");
+        const auto bassDetector = bus.subscribe(key, SidechainBus::DetectorSpec::forCompressor(bass));
+        const auto padDetector = bus.subscribe(key, SidechainBus::DetectorSpec::forCompressor(pad));
+        identical = identical && bassDetector == padDetector;
+
+        auto bassLeft = sine(numSamples, 80.0, 0.5f), bassRight = bassLeft;
+        auto padLeft = sine(numSamples, 440.0, 0.3f), padRight = padLeft;
+        auto referenceLeft = bassLeft, referenceRight = bassRight;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const float* keyChannels[] = { keyLeft.data() + start, keyRight.data() + start };
+            bus.beginBlock();
+            bus.publish(key, keyChannels, 2, blockSize);
+
+            const auto stream = bus.getDetector(bassDetector);
+            float* bassChannels[] = { bassLeft.data() + start, bassRight.data() + start };
+            float* padChannels[] = { padLeft.data() + start, padRight.data() + start };
+            float* referenceChannels[] = { referenceLeft.data() + start, referenceRight.data() + start };
+
+            bass.processWithKeyPower(bassChannels, 2, blockSize, stream.power);
+            pad.processWithKeyPower(padChannels, 2, blockSize, bus.getDetector(padDetector).power);
+            reference.process(referenceChannels, 2, blockSize, keyChannels, 2);
+        }
+
+        identical = identical && bassLeft == referenceLeft && bassRight == referenceRight;
+        identical = identical && bass.getGainReductionDb() == reference.getGainReductionDb();
+    }
+
+    check(identical, "A shared stream compresses exactly like private detection, in every mode");
+
+    CompressorCore compressor;
+    CompressorConfig config;
+    config.mode = CompressorMode::TruePeak;
+    compressor.setParameters(config);
+    const auto spec = SidechainBus::DetectorSpec::forCompressor(compressor, 120.0f);
+    check(spec.mode == SlidingWindowDetector::Mode::Peak && spec.windowMs == 1.0f && spec.truePeak
+              && spec.highPassHz == 120.0f,
+          "forCompressor picks the compressor's detector settings");
+    check(SidechainBus::DetectorSpec::vu().windowMs == 300.0f && SidechainBus::DetectorSpec::rms().windowMs == 10.0f,
+          "Presets match the compressor's time constants");
+}
+
+//==============================================================================
+// Detector storage
+//==============================================================================
+
+static void testStorageOutlivesReaders()
+{
+    std::cout << "\n=== Detector Storage ===" << std::endl;
+
+    SidechainBus bus;
+    bus.prepare(sampleRate, blockSize);
+    const auto key = bus.addKey("kick");
+    const auto detector = bus.subscribe(key, SidechainBus::DetectorSpec::rms());
+
+    const auto data = kick(4 * blockSize);
+    const float* channels[] = { data.data() };
+
+    bus.beginBlock();
+    bus.publish(key, channels, 1, blockSize);
+    const auto span = bus.getDetector(detector);
+    const float last = span.power[blockSize - 1];
+
+    // Larger blocks replace the storage while a consumer still holds the span
+    bus.prepare(sampleRate, 4 * blockSize);
+    bus.unsubscribe(bus.subscribe(key, SidechainBus::DetectorSpec::peak()));
+    check(span.power[blockSize - 1] == last && bus.getDetector(detector).power == span.power,
+          "A span stays readable to the end of its block across edits");
+
+    bus.beginBlock();
+    bus.collectGarbage();
+    bus.publish(key, channels, 1, 4 * blockSize);
+    const auto larger = bus.getDetector(detector);
+    check(larger.isValid() && larger.numSamples == 4 * blockSize, "The next block uses the new storage");
+}
+
+//==============================================================================
+// Threads
+//==============================================================================
+
+static void testConcurrentPublishing()
+{
+    std::cout << "\n=== Threads ===" << std::endl;
+
+    SidechainBus bus;
+    bus.prepare(sampleRate, blockSize);
+    const auto kickKey = bus.addKey("kick");
+    const auto snareKey = bus.addKey("snare");
+    const auto kickDetector = bus.subscribe(kickKey, SidechainBus::DetectorSpec::peak());
+
+    // Two audio threads publish their keys while the message thread edits
+    const auto data = kick(blockSize);
+    std::atomic<bool> running { true };
+    std::atomic<int> published { 0 };
+
+    auto publisher = [&](SidechainBus::KeyId key) {
+        const float* channels[] = { data.data() };
+        while (running.load())
+        {
+            bus.publish(key, channels, 1, blockSize);
+            published.fetch_add(1);
+        }
+    };
+
+    std::thread kickThread(publisher, kickKey), snareThread(publisher, snareKey);
+    for (int edit = 0; edit < 200; ++edit)
+    {
+        const auto detector = bus.subscribe(snareKey, SidechainBus::DetectorSpec::rms(50.0f + (float) edit));
+        bus.beginBlock();
+        bus.unsubscribe(detector);
+    }
+    running.store(false);
+    kickThread.join();
+    snareThread.join();
+
+    check(published.load() > 0, "Keys publish from several threads alongside edits");
+    check(bus.getNumDetectors(snareKey) == 0 && bus.getNumDetectors(kickKey) == 1, "Edits land intact");
+
+    bus.beginBlock();
+    const float* channels[] = { data.data() };
+    bus.publish(kickKey, channels, 1, blockSize);
+    check(bus.getDetector(kickDetector).isValid(), "Publishing works after the edits");
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main()
+{
+    std::cout << "\n";
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Sidechain Bus Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    testKeys();
+    testSharing();
+    testDetectorStreams();
+    testKeyFilter();
+    testCompressorEquivalence();
+    testStorageOutlivesReaders();
+    testConcurrentPublishing();
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  " << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
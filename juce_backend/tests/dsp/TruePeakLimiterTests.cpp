@@ -0,0 +1,342 @@
+/*
+  ==============================================================================
+
+    TruePeakLimiterTests.cpp
+    Created: October 18, 2026
+    Author: Bret Bouchard
+
+    Tests for the true-peak lookahead limiter
+    Checks that hot material stays under the ceiling as measured by an
+    independent oversampling meter, that the reported latency is the actual
+    delay, release back to unity and block size independence
+
+  ==============================================================================
+*/
+
+#include "dynamics/TruePeakLimiter.h"
+#include "dynamics/DynamicsConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace schill::dynamics;
+
+//==============================================================================
+// Test Utilities
+//==============================================================================
+
+static int failures = 0;
+
+static void check(bool passed, const char* name)
+{
+    std::cout << name << " (" << (passed ? "PASS" : "FAIL") << ")" << std::endl;
+    if (!passed)
+        ++failures;
+}
+
+static constexpr double sampleRate = 48000.0;
+static constexpr double pi = 3.14159265358979323846;
+
+static LimiterConfig makeConfig(float ceiling, float lookaheadMs, bool truePeak)
+{
+    LimiterConfig config;
+    config.ceiling = ceiling;
+    config.lookaheadTime = lookaheadMs;
+    config.releaseTime = 50.0f;
+    config.truePeakMode = truePeak;
+    return config;
+}
+
+/** Hot, dense test material: detuned partials plus noise, well over 0 dBFS */
+static std::vector<float> hotSignal(int numSamples, float gain, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+
+    std::vector<float> data((size_t) numSamples);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double t = i / sampleRate;
+        const double tone = std::sin(2.0 * pi * 997.0 * t) + 0.7 * std::sin(2.0 * pi * 11025.3 * t)
+                          + 0.5 * std::sin(2.0 * pi * 17999.0 * t + 1.0);
+        data[(size_t) i] = gain * ((float) tone * 0.5f + noise(random));
+    }
+    return data;
+}
+
+/**
+ * Reference true-peak meter, independent of the limiter: 32x oversampling
+ * with a long Blackman-windowed sinc, far finer than the BS.1770 4x meter
+ */
+static float truePeakDb(const std::vector<float>& data, int start, int end)
+{
+    constexpr int factor = 32;
+    constexpr int halfTaps = 32;
+
+    float peak = 0.0f;
+    for (int n = std::max(start, halfTaps); n < std::min(end, (int) data.size() - halfTaps); ++n)
+    {
+        peak = std::max(peak, std::abs(data[(size_t) n]));
+
+        for (int phase = 1; phase < factor; ++phase)
+        {
+            const double fraction = phase / (double) factor;
+            double sum = 0.0;
+
+            for (int k = -halfTaps + 1; k <= halfTaps; ++k)
+            {
+                const double t = k - fraction;
+                const double sinc = std::sin(pi * t) / (pi * t);
+                const double w = 0.42 + 0.5 * std::cos(pi * t / halfTaps) + 0.08 * std::cos(2.0 * pi * t / halfTaps);
+                sum += data[(size_t) (n + k)] * sinc * w;
+            }
+
+            peak = std::max(peak, (float) std::abs(sum));
+        }
+    }
+
+    return 20.0f * std::log10(std::max(peak, 1.0e-9f));
+}
+
+static void run(TruePeakLimiter& limiter, std::vector<float>& left, std::vector<float>& right, int blockSize)
+{
+    for (size_t start = 0; start < left.size(); start += (size_t) blockSize)
+    {
+        const int n = (int) std::min((size_t) blockSize, left.size() - start);
+        float* channels[] = { left.data() + start, right.data() + start };
+        limiter.process(channels, 2, n);
+    }
+}
+
+//==============================================================================
+// Ceiling
+//==============================================================================
+
+static void testCeiling()
+{
+    std::cout << "\n=== Ceiling ===" << std::endl;
+
+    TruePeakLimiter limiter;
+    limiter.prepare(sampleRate, 512);
+    limiter.setParameters(makeConfig(-1.0f, 1.5f, true));
+
+    auto left = hotSignal(48000, 2.0f, 1), right = hotSignal(48000, 1.5f, 2);
+    const float inputPeak = truePeakDb(left, 4800, 48000);
+    run(limiter, left, right, 512);
+
+    // Skip the first lookahead's worth: the output there is the delay line
+    const float outputPeak = std::max(truePeakDb(left, 4800, 48000), truePeakDb(right, 4800, 48000));
+    std::cout << "Input " << inputPeak << " dBTP, output " << outputPeak << " dBTP" << std::endl;
+
+    check(inputPeak > 6.0f, "The test signal is driven hard");
+    check(outputPeak <= -1.0f, "A hot signal stays under -1 dBTP");
+    check(outputPeak > -2.0f, "The limiter does not over-attenuate");
+    check(limiter.getGainReductionDb() > 6.0f, "Gain reduction is reported");
+
+    // Sample-peak mode: every sample is under the ceiling
+    TruePeakLimiter samplePeak;
+    samplePeak.prepare(sampleRate, 512);
+    samplePeak.setParameters(makeConfig(-1.0f, 1.5f, false));
+
+    auto sampleLeft = hotSignal(48000, 2.0f, 3), sampleRight = hotSignal(48000, 2.0f, 4);
+    run(samplePeak, sampleLeft, sampleRight, 512);
+
+    float maximum = 0.0f;
+    for (size_t i = 0; i < sampleLeft.size(); ++i)
+        maximum = std::max({ maximum, std::abs(sampleLeft[i]), std::abs(sampleRight[i]) });
+    check(maximum <= std::pow(10.0f, -1.0f / 20.0f) * 1.0001f, "Sample-peak mode holds every sample at the ceiling");
+}
+
+//==============================================================================
+// Latency
+//==============================================================================
+
+static void testLatency()
+{
+    std::cout << "\n=== Latency ===" << std::endl;
+
+    for (bool truePeak : { true, false })
+    {
+        for (float lookahead : { 0.0f, 1.5f, 5.0f })
+        {
+            TruePeakLimiter limiter;
+            limiter.prepare(sampleRate, 256);
+            limiter.setParameters(makeConfig(-1.0f, lookahead, truePeak));
+            const int latency = limiter.getLatencySamples();
+
+            // Below the ceiling the limiter is a pure delay
+            std::mt19937 random(11);
+            std::uniform_real_distribution<float> uniform(-0.3f, 0.3f);
+            std::vector<float> input(4000);
+            for (auto& value : input)
+                value = uniform(random);
+
+            auto left = input, right = input;
+            run(limiter, left, right, 256);
+
+            bool delayed = true;
+            for (int i = 0; i < (int) input.size(); ++i)
+            {
+                const float expected = (i >= latency) ? input[(size_t) (i - latency)] : 0.0f;
+                delayed = delayed && std::abs(left[(size_t) i] - expected) < 1.0e-6f;
+            }
+
+            std::cout << (truePeak ? "True peak, " : "Sample peak, ") << lookahead << " ms: "
+                      << latency << " samples" << std::endl;
+            check(delayed, "getLatencySamples() is the actual delay");
+        }
+    }
+
+    // An isolated peak is caught on time: the limited output never passes
+    // the ceiling when the peak comes out of the delay line
+    TruePeakLimiter limiter;
+    limiter.prepare(sampleRate, 256);
+    limiter.setParameters(makeConfig(-3.0f, 2.0f, false));
+
+    std::vector<float> left(2048, 0.1f), right(2048, 0.1f);
+    left[1000] = 1.0f;
+    run(limiter, left, right, 256);
+
+    const int latency = limiter.getLatencySamples();
+    check(std::abs(left[(size_t) (1000 + latency)]) <= std::pow(10.0f, -3.0f / 20.0f) * 1.0001f,
+          "A single-sample peak is at the ceiling when it leaves the delay");
+    check(std::abs(left[(size_t) (1000 + latency - 1)] - 0.1f) > 1.0e-4f,
+          "Gain comes down before the peak, not after");
+}
+
+//==============================================================================
+// Release and Block Sizes
+//==============================================================================
+
+static void testRelease()
+{
+    std::cout << "\n=== Release ===" << std::endl;
+
+    TruePeakLimiter limiter;
+    limiter.prepare(sampleRate, 512);
+    limiter.setParameters(makeConfig(-6.0f, 1.5f, true));
+
+    auto burst = hotSignal(9600, 2.0f, 5);
+    std::vector<float> left(48000, 0.0f);
+    std::copy(burst.begin(), burst.end(), left.begin());
+    for (size_t i = burst.size(); i < left.size(); ++i)
+        left[i] = 0.2f * (float) std::sin(2.0 * pi * 440.0 * (double) i / sampleRate);
+    auto right = left;
+    const auto input = left;
+
+    run(limiter, left, right, 512);
+
+    // 50 ms release: well within a second the quiet tail is back at unity
+    const int latency = limiter.getLatencySamples();
+    float error = 0.0f;
+    for (int i = 40000; i < 48000; ++i)
+        error = std::max(error, std::abs(left[(size_t) i] - input[(size_t) (i - latency)]));
+    check(error < 1.0e-4f, "Gain recovers to unity after the burst");
+    check(limiter.getGainReductionDb() < 0.01f, "Reported reduction returns to zero");
+}
+
+static void testBlockSizes()
+{
+    std::cout << "\n=== Block Sizes ===" << std::endl;
+
+    TruePeakLimiter small, large;
+    small.prepare(sampleRate, 64);
+    large.prepare(sampleRate, 64);
+    small.setParameters(makeConfig(-1.0f, 3.0f, true));
+    large.setParameters(makeConfig(-1.0f, 3.0f, true));
+
+    auto a = hotSignal(10000, 1.5f, 6), b = hotSignal(10000, 1.2f, 7);
+    auto c = a, d = b;
+    run(small, a, b, 29);
+    run(large, c, d, 1000);   // Longer than prepared: processed in chunks
+
+    bool identical = true;
+    for (size_t i = 0; i < a.size(); ++i)
+        identical = identical && a[i] == c[i] && b[i] == d[i];
+    check(identical, "Output does not depend on the host block size");
+
+    // Ceiling changes do not restart the delay line
+    TruePeakLimiter limiter;
+    limiter.prepare(sampleRate, 256);
+    limiter.setParameters(makeConfig(-1.0f, 1.5f, true));
+    const int latency = limiter.getLatencySamples();
+    limiter.setParameters(makeConfig(-3.0f, 1.5f, true));
+    check(limiter.getLatencySamples() == latency, "Latency depends only on lookahead and detector");
+}
+
+//==============================================================================
+// Layout and Parameter Changes
+//==============================================================================
+
+static void testLayout()
+{
+    std::cout << "\n=== Layout ===" << std::endl;
+
+    // Every prepared channel is delayed; one beyond the layout is silenced
+    // instead of coming out ahead of the others
+    TruePeakLimiter limiter;
+    limiter.prepare(sampleRate, 256, 2);
+    limiter.setParameters(makeConfig(-1.0f, 1.5f, true));
+    const int latency = limiter.getLatencySamples();
+
+    std::vector<float> input(1024);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = 0.3f * (float) std::sin(2.0 * pi * 440.0 * (double) i / sampleRate);
+
+    std::vector<std::vector<float>> buffers(3, input);
+    for (int start = 0; start < (int) input.size(); start += 256)
+    {
+        float* channels[] = { buffers[0].data() + start, buffers[1].data() + start, buffers[2].data() + start };
+        limiter.process(channels, 3, 256);
+    }
+
+    bool delayed = true, silent = true;
+    for (int i = latency; i < (int) input.size(); ++i)
+        delayed = delayed && std::abs(buffers[1][(size_t) i] - input[(size_t) (i - latency)]) < 1.0e-6f;
+    for (float value : buffers[2])
+        silent = silent && value == 0.0f;
+    check(delayed, "Prepared channels are delayed by the latency");
+    check(silent, "Channels beyond the prepared layout are silenced");
+
+    // A lookahead change is reported at once and applied from the next block
+    limiter.setParameters(makeConfig(-1.0f, 5.0f, true));
+    const int longer = limiter.getLatencySamples();
+    auto left = input, right = input;
+    run(limiter, left, right, 256);
+
+    bool restarted = true;
+    for (int i = 0; i < (int) input.size(); ++i)
+    {
+        const float expected = (i >= longer) ? input[(size_t) (i - longer)] : 0.0f;
+        restarted = restarted && std::abs(left[(size_t) i] - expected) < 1.0e-6f;
+    }
+    check(longer > latency, "The new latency is reported before processing");
+    check(restarted, "The new delay takes effect at the next block");
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main()
+{
+    std::cout << "\n";
+    std::cout << "========================================" << std::endl;
+    std::cout << "  True Peak Limiter Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    testCeiling();
+    testLatency();
+    testRelease();
+    testBlockSizes();
+    testLayout();
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  " << (failures == 0 ? "All tests passed" : "Some tests FAILED")
+              << " (" << failures << " failures)" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#!/bin/bash
+# Build script for ChannelLayoutTests
+
+echo "Building ChannelLayoutTests..."
+
+# Compile the test
+g++ -O3 -march=native \
+    -I../../include \
+    -std=c++17 \
+    ChannelLayoutTests.cpp \
+    ../../include/dsp/ChannelLayout.cpp \
+    -o ChannelLayoutTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./ChannelLayoutTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,20 @@
+#!/bin/bash
+# Build script for CompressorCoreTests
+
+echo "Building CompressorCoreTests..."
+
+# Compile the test
+g++ -O3 -march=native \
+    -I../../include \
+    -std=c++17 \
+    CompressorCoreTests.cpp \
+    ../../include/dynamics/CompressorCore.cpp \
+    -o CompressorCoreTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./CompressorCoreTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
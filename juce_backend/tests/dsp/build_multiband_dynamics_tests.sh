@@ -0,0 +1,21 @@
+#!/bin/bash
+# Build script for MultibandDynamicsTests
+
+echo "Building MultibandDynamicsTests..."
+
+# Compile the test
+g++ -O3 -march=native \
+    -I../../include \
+    -std=c++17 \
+    MultibandDynamicsTests.cpp \
+    ../../include/dynamics/MultibandDynamics.cpp \
+    ../../include/dynamics/CompressorCore.cpp \
+    -o MultibandDynamicsTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./MultibandDynamicsTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,21 @@
+#!/bin/bash
+# Build script for PartitionedConvolutionTests
+
+echo "Building PartitionedConvolutionTests..."
+
+# Compile the test
+g++ -O3 -march=native \
+    -I../../include \
+    -std=c++17 \
+    PartitionedConvolutionTests.cpp \
+    ../../include/dsp/PartitionedConvolution.cpp \
+    ../../include/dsp/RealFFT.cpp \
+    -o PartitionedConvolutionTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./PartitionedConvolutionTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,21 @@
+#!/bin/bash
+# Build script for PhaseVocoderTests
+
+echo "Building PhaseVocoderTests..."
+
+# Compile the test
+g++ -O3 -march=native \
+    -I../../include \
+    -std=c++17 \
+    PhaseVocoderTests.cpp \
+    ../../include/dsp/PhaseVocoder.cpp \
+    ../../include/dsp/RealFFT.cpp \
+    -o PhaseVocoderTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./PhaseVocoderTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Build script for PolyphonicTranscriberTests
+
+echo "Building PolyphonicTranscriberTests..."
+
+# Compile the test
+g++ -O3 -march=native \
+    -I../../include \
+    -std=c++17 \
+    PolyphonicTranscriberTests.cpp \
+    ../../include/dsp/ConstantQ.cpp \
+    ../../include/dsp/PolyphonicTranscriber.cpp \
+    ../../include/dsp/RealFFT.cpp \
+    -o PolyphonicTranscriberTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./PolyphonicTranscriberTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,19 @@
+#!/bin/bash
+# Build script for RealtimeLogTests
+
+echo "Building RealtimeLogTests..."
+
+# Compile the test
+g++ -O3 -march=native \
+    -I../../include \
+    -std=c++17 \
+    RealtimeLogTests.cpp \
+    -o RealtimeLogTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./RealtimeLogTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
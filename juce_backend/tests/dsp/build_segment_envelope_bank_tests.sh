@@ -0,0 +1,38 @@
+#!/bin/bash
+
+# Build script for SegmentEnvelopeBankTests
+# Links the envelope sources against the JUCE core and audio basics modules
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/../.." && pwd)"
+JUCE_MODULES="$PROJECT_ROOT/external/JUCE/modules"
+
+echo "Building SegmentEnvelopeBankTests..."
+
+if [ "$(uname)" = "Darwin" ]; then
+    PLATFORM_LIBS="-framework Foundation -framework CoreAudio -framework CoreMIDI -framework Accelerate"
+    JUCE_SUFFIX="mm"
+    LANGUAGE="-x objective-c++"
+else
+    PLATFORM_LIBS="-lpthread -ldl"
+    JUCE_SUFFIX="cpp"
+    LANGUAGE=""
+fi
+
+# Compile the test
+g++ -O3 -std=c++17 \
+    -DJUCE_GLOBAL_MODULE_SETTINGS_INCLUDED=1 \
+    -DJUCE_STANDALONE_APPLICATION=1 \
+    -I"$JUCE_MODULES" \
+    -I"$PROJECT_ROOT/engine/audio/primitives" \
+    "$SCRIPT_DIR/SegmentEnvelopeBankTests.cpp" \
+    "$PROJECT_ROOT/engine/audio/primitives/ADSREnvelope.cpp" \
+    "$PROJECT_ROOT/engine/audio/primitives/SegmentEnvelopeBank.cpp" \
+    $LANGUAGE "$JUCE_MODULES/juce_core/juce_core.$JUCE_SUFFIX" \
+    "$JUCE_MODULES/juce_audio_basics/juce_audio_basics.$JUCE_SUFFIX" \
+    -o "$SCRIPT_DIR/SegmentEnvelopeBankTests" \
+    $PLATFORM_LIBS
+
+echo "Build successful! Run with: $SCRIPT_DIR/SegmentEnvelopeBankTests"
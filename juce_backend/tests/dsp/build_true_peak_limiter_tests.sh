@@ -0,0 +1,21 @@
+#!/bin/bash
+# Build script for TruePeakLimiterTests
+
+echo "Building TruePeakLimiterTests..."
+
+# Compile the test
+g++ -O3 -march=native \
+    -I../../include \
+    -std=c++17 \
+    TruePeakLimiterTests.cpp \
+    ../../include/dynamics/TruePeakLimiter.cpp \
+    ../../include/dynamics/CompressorCore.cpp \
+    -o TruePeakLimiterTests \
+    -lm -lpthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Run with: ./TruePeakLimiterTests"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include "../../engine/instruments/InstrumentRegistry.h"
+#include "../../engine/instruments/InstrumentInstance.h"
+#include "../../engine/instruments/CustomInstrumentBase.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using namespace SchillingerEcosystem::Instrument;
+
+// Test fixture for InstrumentRegistry tests
+class InstrumentRegistryTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        registry = std::make_unique<InstrumentRegistry>();
+        registry->setAudioConfiguration(44100.0, 512);
+    }
+
+    void TearDown() override
+    {
+        registry.reset();
+    }
+
+    static InstrumentInfo makeInfo(const juce::String& identifier, const juce::String& category)
+    {
+        InstrumentInfo info;
+        info.identifier = identifier;
+        info.name = identifier + " Synth";
+        info.category = category;
+        info.type = InstrumentType::BuiltInSynthesizer;
+        info.isInstrument = true;
+        info.supportsMIDI = true;
+        info.tags = { "Warm", "Pad" };
+        return info;
+    }
+
+    static InstrumentRegistry::Factory makeFactory(const juce::String& identifier)
+    {
+        return [identifier]() -> std::unique_ptr<InstrumentInstance> {
+            auto synth = std::make_unique<CustomInstrumentBase>(identifier, identifier + " Test");
+            synth->initialize(44100.0, 512);
+            return synth;
+        };
+    }
+
+    std::unique_ptr<InstrumentRegistry> registry;
+};
+
+// Test: Registration and identifier resolution
+TEST_F(InstrumentRegistryTest, RegisterAndResolve)
+{
+    auto handle = registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex"));
+    ASSERT_TRUE(handle.isValid());
+
+    EXPECT_EQ(registry->resolve("nex"), handle);
+    EXPECT_FALSE(registry->resolve("missing").isValid());
+    EXPECT_TRUE(registry->isAvailable(handle));
+
+    // Duplicate identifiers are rejected
+    EXPECT_FALSE(registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex")).isValid());
+
+    // Raw round trip for the FFI
+    EXPECT_EQ(InstrumentHandle::fromRaw(handle.toRaw()), handle);
+}
+
+// Test: Precomputed indices
+TEST_F(InstrumentRegistryTest, SnapshotIndices)
+{
+    registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex"));
+    registry->registerInstrument(makeInfo("sam", "Sampler"), makeFactory("sam"));
+    registry->registerInstrument(makeInfo("gal", "synthesizer"), makeFactory("gal"));
+
+    auto snapshot = registry->getSnapshot();
+    EXPECT_EQ(snapshot->category("SYNTHESIZER").size(), 2u);
+    EXPECT_EQ(snapshot->category("Sampler").size(), 1u);
+    EXPECT_EQ(snapshot->category("Drums").size(), 0u);
+    EXPECT_EQ(snapshot->tag("warm").size(), 3u);
+    EXPECT_EQ(snapshot->type(InstrumentType::BuiltInSynthesizer).size(), 3u);
+
+    EXPECT_EQ(registry->search("SAM").size(), 1u);
+    EXPECT_EQ(registry->search("pad").size(), 3u);
+    EXPECT_TRUE(registry->search("").empty());
+}
+
+// Test: Stale handles after unregister
+TEST_F(InstrumentRegistryTest, UnregisterInvalidatesHandles)
+{
+    auto handle = registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex"));
+    ASSERT_TRUE(registry->unregisterInstrument(handle));
+
+    EXPECT_FALSE(registry->isAvailable(handle));
+    EXPECT_EQ(registry->getRecord(handle), nullptr);
+    EXPECT_FALSE(registry->claimInstance(handle).isValid());
+
+    // Slot reuse gets a new generation
+    auto reused = registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex"));
+    ASSERT_TRUE(reused.isValid());
+    EXPECT_NE(reused, handle);
+    EXPECT_FALSE(registry->isAvailable(handle));
+}
+
+// Test: Releasing an instance of an unregistered instrument after its slot
+// could have been reused
+TEST_F(InstrumentRegistryTest, ReleaseAfterUnregisterDoesNotTouchNewInstrument)
+{
+    auto handle = registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex"));
+    registry->prewarm(handle, 2);
+    auto old = registry->claimInstance(handle);
+    ASSERT_TRUE(old.isValid());
+
+    ASSERT_TRUE(registry->unregisterInstrument(handle));
+    EXPECT_NE(registry->getInstance(old), nullptr);
+
+    // The slot stays retired while the old instance is claimed
+    auto sam = registry->registerInstrument(makeInfo("sam", "Sampler"), makeFactory("sam"));
+    ASSERT_TRUE(sam.isValid());
+    EXPECT_NE(sam.index, handle.index);
+    registry->prewarm(sam, 2);
+    auto claimed = registry->claimInstance(sam);
+    ASSERT_TRUE(claimed.isValid());
+
+    EXPECT_TRUE(registry->releaseInstance(old));
+    EXPECT_EQ(registry->getInstanceCount(sam), 1);
+    EXPECT_EQ(registry->getPooledCount(sam), 1);
+
+    // The old instance is destroyed, not pooled as a sampler
+    registry->maintainPool();
+    EXPECT_EQ(registry->getInstanceCount(sam), 1);
+    EXPECT_EQ(registry->getPooledCount(sam), 2);
+
+    // Now the slot is free again, and reusing it leaves the new owner alone
+    auto gal = registry->registerInstrument(makeInfo("gal", "Synthesizer"), makeFactory("gal"));
+    ASSERT_TRUE(gal.isValid());
+    EXPECT_EQ(gal.index, handle.index);
+    EXPECT_FALSE(registry->releaseInstance(old));
+    EXPECT_EQ(registry->getInstanceCount(gal), 0);
+    EXPECT_EQ(registry->getPooledCount(gal), 0);
+
+    EXPECT_TRUE(registry->releaseInstance(claimed));
+}
+
+// Test: Claiming prepared instances
+TEST_F(InstrumentRegistryTest, ClaimAndReleasePooledInstances)
+{
+    auto handle = registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex"), 2);
+    EXPECT_EQ(registry->prewarm(handle, 4), 4);
+
+    auto first = registry->claimInstance(handle);
+    auto second = registry->claimInstance(handle);
+    ASSERT_TRUE(first.isValid());
+    ASSERT_TRUE(second.isValid());
+
+    // Instance limit of 2
+    EXPECT_FALSE(registry->claimInstance(handle).isValid());
+    EXPECT_EQ(registry->getInstanceCount(handle), 2);
+
+    auto* instance = registry->getInstance(first);
+    ASSERT_NE(instance, nullptr);
+    EXPECT_TRUE(instance->isInitialized());
+
+    EXPECT_TRUE(registry->releaseInstance(first));
+    EXPECT_EQ(registry->getInstance(first), nullptr);
+    EXPECT_FALSE(registry->releaseInstance(first));
+    EXPECT_EQ(registry->getInstanceCount(handle), 1);
+
+    // Recycled back into the pool
+    registry->maintainPool();
+    EXPECT_EQ(registry->getPooledCount(handle), 4);
+
+    EXPECT_TRUE(registry->releaseInstance(second));
+}
+
+// Test: Empty pool
+TEST_F(InstrumentRegistryTest, ClaimWithoutPrewarmFails)
+{
+    auto handle = registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex"));
+    EXPECT_FALSE(registry->claimInstance(handle).isValid());
+    EXPECT_EQ(registry->getInstanceCount(handle), 0);
+}
+
+// Test: Concurrent claims while the message thread maintains the pool
+TEST_F(InstrumentRegistryTest, ConcurrentClaimRelease)
+{
+    auto handle = registry->registerInstrument(makeInfo("nex", "Synthesizer"), makeFactory("nex"));
+    registry->prewarm(handle, InstrumentRegistry::maxPooledPerInstrument);
+
+    std::atomic<bool> running { true };
+    std::atomic<int> claims { 0 };
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([&]() {
+            while (running.load())
+            {
+                auto instance = registry->claimInstance(handle);
+                if (instance.isValid())
+                {
+                    EXPECT_NE(registry->getInstance(instance), nullptr);
+                    registry->releaseInstance(instance);
+                    ++claims;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 500; ++i)
+        registry->maintainPool();
+
+    running = false;
+    for (auto& worker : workers)
+        worker.join();
+
+    registry->maintainPool();
+    EXPECT_GT(claims.load(), 0);
+    EXPECT_EQ(registry->getInstanceCount(handle), 0);
+    EXPECT_EQ(registry->getPooledCount(handle), InstrumentRegistry::maxPooledPerInstrument);
+}
@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+    LockFreeAudioGraphStressTest.cpp
+
+    Tests for the wait-free MemorySafeAudioGraph render path: routing through
+    published topology versions, deferred retirement of removed nodes, and a
+    stress run that restructures the graph at a high rate while rendering.
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio/MemorySafeAudioGraph.h"
+
+using namespace SchillingerEcosystem::Audio;
+
+namespace {
+
+constexpr int kBlockSize = 128;
+
+std::unique_ptr<MemorySafeAudioNode> makeGainNode(const std::string& nodeId, float gain) {
+    return AudioGraphNodeFactory::createProcessorNode(nodeId,
+        [gain](const float* const* input, int numInputs, int samples,
+               float* const* output, int numOutputs) {
+            for (int ch = 0; ch < std::min(numInputs, numOutputs); ++ch) {
+                for (int s = 0; s < samples; ++s) {
+                    output[ch][s] = input[ch][s] * gain;
+                }
+            }
+        },
+        1, 256, 48000.0);
+}
+
+struct MonoBlock {
+    std::vector<float> input = std::vector<float>(kBlockSize, 1.0f);
+    std::vector<float> output = std::vector<float>(kBlockSize, 0.0f);
+    const float* inputPointers[1] = { input.data() };
+    float* outputPointers[1] = { output.data() };
+
+    bool render(MemorySafeAudioGraph& graph) {
+        return graph.processAudio(inputPointers, 1, kBlockSize, outputPointers, 1);
+    }
+};
+
+} // namespace
+
+//==============================================================================
+// Routing
+
+TEST(LockFreeAudioGraphTest, RoutesChainsAndSumsSinks) {
+    MemorySafeAudioGraph graph;
+    ASSERT_TRUE(graph.addNode(makeGainNode("a", 2.0f)));
+    ASSERT_TRUE(graph.addNode(makeGainNode("b", 3.0f)));
+    ASSERT_TRUE(graph.addNode(makeGainNode("c", 0.5f)));
+    ASSERT_TRUE(graph.connectNodes("a", "b"));
+
+    // a -> b is one path (6x), c reads the graph input on its own (0.5x)
+    MonoBlock block;
+    ASSERT_TRUE(block.render(graph));
+    EXPECT_FLOAT_EQ(block.output[0], 6.5f);
+    EXPECT_FLOAT_EQ(block.output[kBlockSize - 1], 6.5f);
+
+    // Fan-in: both a and c feed b
+    ASSERT_TRUE(graph.connectNodes("c", "b"));
+    ASSERT_TRUE(block.render(graph));
+    EXPECT_FLOAT_EQ(block.output[0], 7.5f);
+}
+
+TEST(LockFreeAudioGraphTest, RejectsCyclesAndDuplicates) {
+    MemorySafeAudioGraph graph;
+    ASSERT_TRUE(graph.addNode(makeGainNode("a", 1.0f)));
+    ASSERT_TRUE(graph.addNode(makeGainNode("b", 1.0f)));
+    ASSERT_TRUE(graph.addNode(makeGainNode("c", 1.0f)));
+
+    EXPECT_TRUE(graph.connectNodes("a", "b"));
+    EXPECT_TRUE(graph.connectNodes("b", "c"));
+    EXPECT_FALSE(graph.connectNodes("a", "b"));
+    EXPECT_FALSE(graph.connectNodes("c", "a"));
+    EXPECT_FALSE(graph.connectNodes("a", "a"));
+    EXPECT_TRUE(graph.validateGraphIntegrity());
+
+    EXPECT_TRUE(graph.disconnectNodes("b", "c"));
+    EXPECT_TRUE(graph.connectNodes("c", "a"));
+}
+
+TEST(LockFreeAudioGraphTest, EachChangePublishesNewVersion) {
+    MemorySafeAudioGraph graph;
+    EXPECT_EQ(graph.getTopologyVersion(), 0u);
+
+    ASSERT_TRUE(graph.addNode(makeGainNode("a", 1.0f)));
+    const auto first = graph.getTopologyVersion();
+    ASSERT_TRUE(graph.addNode(makeGainNode("b", 1.0f)));
+    ASSERT_TRUE(graph.connectNodes("a", "b"));
+    EXPECT_EQ(graph.getTopologyVersion(), first + 2);
+
+    // Nothing was rendering, so every replaced version is already freed
+    EXPECT_EQ(graph.getStats().pendingRetirements, 0u);
+}
+
+//==============================================================================
+// Deferred retirement
+
+TEST(LockFreeAudioGraphTest, RemovedNodeOutlivesInFlightRender) {
+    MemorySafeAudioGraph graph;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+
+    auto slow = AudioGraphNodeFactory::createProcessorNode("slow",
+        [&](const float* const*, int, int, float* const*, int) {
+            entered.store(true);
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        },
+        1, 256, 48000.0);
+    ASSERT_TRUE(graph.addNode(std::move(slow)));
+    auto weakSlow = graph.getNode("slow");
+
+    MonoBlock block;
+    std::thread audioThread([&] { block.render(graph); });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    // A second render is rejected rather than blocked
+    MonoBlock other;
+    EXPECT_FALSE(other.render(graph));
+
+    // Removal returns immediately while the render is still inside the node
+    EXPECT_TRUE(graph.removeNode("slow"));
+    EXPECT_FALSE(graph.hasNode("slow"));
+    EXPECT_FALSE(weakSlow.expired());
+    EXPECT_GE(graph.collectRetired(), 1u);
+
+    if (auto node = weakSlow.lock()) {
+        EXPECT_TRUE(node->isProcessing());
+        EXPECT_NE(node->getState(), MemorySafeAudioNode::NodeState::Shutdown);
+    }
+
+    release.store(true);
+    audioThread.join();
+
+    EXPECT_EQ(graph.collectRetired(), 0u);
+    EXPECT_TRUE(weakSlow.expired());
+    EXPECT_EQ(graph.getStats().rejectedRenders, 1u);
+}
+
+//==============================================================================
+// Stress
+
+TEST(LockFreeAudioGraphTest, MutatesAtHighRateWhileRendering) {
+    constexpr int mutations = 10000;
+
+    MemorySafeAudioGraph graph;
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(graph.addNode(makeGainNode("base_" + std::to_string(i), 1.0f)));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> renders{0};
+    std::atomic<int> failedRenders{0};
+    std::atomic<int> tornBlocks{0};
+    std::atomic<int64_t> worstRenderMicros{0};
+
+    // Unity-gain nodes on a constant input: every sample of a block equals
+    // the number of input-to-sink paths of the version that rendered it, so
+    // a block that mixes two versions shows up as a non-constant block
+    std::thread audioThread([&] {
+        MonoBlock block;
+        while (!stop.load()) {
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = block.render(graph);
+            const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+            if (micros > worstRenderMicros.load()) {
+                worstRenderMicros.store(micros);
+            }
+            if (!ok) {
+                failedRenders.fetch_add(1);
+            }
+            for (int s = 1; s < kBlockSize; ++s) {
+                if (block.output[s] != block.output[0] || !std::isfinite(block.output[s])) {
+                    tornBlocks.fetch_add(1);
+                    break;
+                }
+            }
+            renders.fetch_add(1);
+        }
+    });
+
+    std::thread reclaimThread([&] {
+        while (!stop.load()) {
+            graph.collectRetired();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> action(0, 3);
+    int nextId = 0;
+
+    for (int i = 0; i < mutations; ++i) {
+        auto ids = graph.getNodeIds();
+        std::uniform_int_distribution<size_t> pick(0, ids.empty() ? 0 : ids.size() - 1);
+
+        switch (action(rng)) {
+            case 0:
+                if (ids.size() < 48) {
+                    graph.addNode(makeGainNode("dyn_" + std::to_string(nextId++), 1.0f));
+                }
+                break;
+            case 1:
+                if (ids.size() > 4) {
+                    graph.removeNode(ids[pick(rng)]);
+                }
+                break;
+            case 2:
+                if (ids.size() >= 2) {
+                    graph.connectNodes(ids[pick(rng)], ids[pick(rng)]);
+                }
+                break;
+            case 3:
+                if (ids.size() >= 2) {
+                    graph.disconnectNodes(ids[pick(rng)], ids[pick(rng)]);
+                }
+                break;
+        }
+    }
+
+    // Let the audio thread render the final version at least once
+    const int rendered = renders.load();
+    while (renders.load() < rendered + 2) {
+        std::this_thread::yield();
+    }
+
+    stop.store(true);
+    audioThread.join();
+    reclaimThread.join();
+
+    std::cout << "Renders: " << renders.load()
+              << ", worst render: " << worstRenderMicros.load() << " us" << std::endl;
+
+    EXPECT_GT(renders.load(), 0);
+    EXPECT_EQ(failedRenders.load(), 0);
+    EXPECT_EQ(tornBlocks.load(), 0);
+    EXPECT_TRUE(graph.validateGraphIntegrity());
+    EXPECT_EQ(graph.collectRetired(), 0u);
+
+    auto stats = graph.getStats();
+    EXPECT_EQ(stats.totalErrors, 0u);
+    EXPECT_GT(stats.publishedVersions, 8u);
+    EXPECT_FALSE(stats.isCurrentlyProcessing);
+}
@@ -0,0 +1,189 @@
+/*
+  StreamingSchemaValidatorTest.cpp - Unit tests for compiled-schema validation
+
+  Covers the single-pass validator: JSON pointer reporting, collection of
+  every violation, syntax errors, nested schemas and the compiled model
+  schemas used by SchemaValidator and the FFI.
+*/
+
+#include <gtest/gtest.h>
+#include "validation/StreamingSchemaValidator.h"
+
+using namespace white_room::validation;
+
+namespace {
+
+const char* kValidPerformance = R"({
+    "version": "1",
+    "id": "550e8400-e29b-41d4-a716-446655440000",
+    "name": "Test Performance",
+    "arrangementStyle": "SOLO_PIANO",
+    "density": 0.5,
+    "createdAt": "2021-01-01T00:00:00Z"
+})";
+
+bool hasErrorAt(const StreamingValidator& v, const std::string& pointer) {
+    for (const auto& e : v.getErrors()) {
+        if (e.fieldPath == pointer) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+// =============================================================================
+// Model Schemas
+// =============================================================================
+
+TEST(StreamingSchemaValidatorTest, ValidPerformanceState_Passes) {
+    StreamingValidator validator;
+    EXPECT_TRUE(validator.validate(kValidPerformance,
+                                   getCompiledSchema(ModelSchema::PerformanceState_v1)));
+    EXPECT_TRUE(validator.getErrors().empty());
+}
+
+TEST(StreamingSchemaValidatorTest, ReportsAllViolationsWithPointers) {
+    const char* json = R"({
+        "version": "2",
+        "id": "not-a-uuid",
+        "name": "",
+        "arrangementStyle": "POLKA",
+        "density": 1.5
+    })";
+
+    StreamingValidator validator;
+    EXPECT_FALSE(validator.validate(json, getCompiledSchema(ModelSchema::PerformanceState_v1)));
+    EXPECT_FALSE(validator.hadSyntaxError());
+    EXPECT_EQ(validator.getErrors().size(), 5u);
+    EXPECT_TRUE(hasErrorAt(validator, "/version"));
+    EXPECT_TRUE(hasErrorAt(validator, "/id"));
+    EXPECT_TRUE(hasErrorAt(validator, "/name"));
+    EXPECT_TRUE(hasErrorAt(validator, "/arrangementStyle"));
+    EXPECT_TRUE(hasErrorAt(validator, "/density"));
+}
+
+TEST(StreamingSchemaValidatorTest, MissingRequiredFields_Reported) {
+    StreamingValidator validator;
+    EXPECT_FALSE(validator.validate(R"({"version": "1.0"})",
+                                    getCompiledSchema(ModelSchema::SchillingerSong_v1)));
+    EXPECT_TRUE(hasErrorAt(validator, "/ensemble"));
+    EXPECT_TRUE(hasErrorAt(validator, "/book4"));
+    EXPECT_FALSE(hasErrorAt(validator, "/version"));
+}
+
+TEST(StreamingSchemaValidatorTest, LegacyEntryPoint_UsesCompiledSchema) {
+    auto result = validatePerformanceState(kValidPerformance);
+    EXPECT_TRUE(result.isSuccess());
+
+    auto failure = validatePerformanceState(R"({"version": "1"})");
+    ASSERT_TRUE(failure.isError());
+    EXPECT_EQ(failure.getError().fieldPath[0], '/');
+}
+
+// =============================================================================
+// Nested Schemas
+// =============================================================================
+
+TEST(StreamingSchemaValidatorTest, NestedArrayItems_PointerIncludesIndex) {
+    auto voice = SchemaSpec::object()
+        .property("id", SchemaSpec::string().withFormat(StringFormat::UUID), true)
+        .property("gain", SchemaSpec::number().range(-96.0, 12.0));
+    auto spec = SchemaSpec::object()
+        .property("ensemble", SchemaSpec::object()
+            .property("voices", SchemaSpec::array(voice), true), true);
+    auto schema = CompiledSchema::compile(spec);
+
+    const char* json = R"({"ensemble": {"voices": [
+        {"id": "550e8400-e29b-41d4-a716-446655440000", "gain": 0},
+        {"id": "bad", "gain": 20},
+        {"gain": -3}
+    ]}})";
+
+    StreamingValidator validator;
+    EXPECT_FALSE(validator.validate(json, *schema));
+    EXPECT_TRUE(hasErrorAt(validator, "/ensemble/voices/1/id"));
+    EXPECT_TRUE(hasErrorAt(validator, "/ensemble/voices/1/gain"));
+    EXPECT_TRUE(hasErrorAt(validator, "/ensemble/voices/2/id"));
+    EXPECT_EQ(validator.getErrors().size(), 3u);
+}
+
+TEST(StreamingSchemaValidatorTest, ClosedObject_RejectsUnknownProperty) {
+    auto schema = CompiledSchema::compile(
+        SchemaSpec::object().property("a", SchemaSpec::integer()).closed());
+
+    StreamingValidator validator;
+    EXPECT_TRUE(validator.validate(R"({"a": 2.0})", *schema));
+    EXPECT_FALSE(validator.validate(R"({"a": 1, "a/b": true})", *schema));
+    EXPECT_TRUE(hasErrorAt(validator, "/a~1b"));
+}
+
+TEST(StreamingSchemaValidatorTest, ArrayItemCount_ReportedOnArray) {
+    auto spec = SchemaSpec::object().property("sig", [] {
+        auto a = SchemaSpec::array(SchemaSpec::integer());
+        a.minItems = 2;
+        a.maxItems = 2;
+        return a;
+    }());
+    auto schema = CompiledSchema::compile(spec);
+
+    StreamingValidator validator;
+    EXPECT_TRUE(validator.validate(R"({"sig": [4, 4]})", *schema));
+    EXPECT_FALSE(validator.validate(R"({"sig": []})", *schema));
+    EXPECT_TRUE(hasErrorAt(validator, "/sig"));
+    EXPECT_FALSE(validator.validate(R"({"sig": [3, 4, 4]})", *schema));
+    EXPECT_TRUE(hasErrorAt(validator, "/sig"));
+}
+
+TEST(StreamingSchemaValidatorTest, EscapedStrings_DecodedForConstraints) {
+    auto schema = CompiledSchema::compile(
+        SchemaSpec::object().property("k", SchemaSpec::string().oneOf(std::vector<std::string>{ "a\"b" })));
+
+    StreamingValidator validator;
+    EXPECT_TRUE(validator.validate(R"({"k": "a\"b"})", *schema));
+    EXPECT_FALSE(validator.validate(R"({"k": "a\\b"})", *schema));
+}
+
+// =============================================================================
+// Syntax
+// =============================================================================
+
+TEST(StreamingSchemaValidatorTest, MalformedJson_ReportsSyntaxError) {
+    StreamingValidator validator;
+    const auto& permissive = getPermissiveSchema();
+
+    EXPECT_TRUE(validator.validate(R"([1, {"a": [true, null, "x"]}, -2.5e3])", permissive));
+    EXPECT_FALSE(validator.validate(R"({"a": 1,})", permissive));
+    EXPECT_TRUE(validator.hadSyntaxError());
+    EXPECT_FALSE(validator.validate(R"({"a": [1, 2})", permissive));
+    EXPECT_FALSE(validator.validate(R"({"a": 01})", permissive));
+    EXPECT_FALSE(validator.validate(R"({"a": 1} x)", permissive));
+    EXPECT_FALSE(validator.validate("", permissive));
+}
+
+TEST(StreamingSchemaValidatorTest, DepthLimit_Enforced) {
+    StreamingValidator::Options options;
+    options.maxDepth = 8;
+    StreamingValidator validator(options);
+
+    EXPECT_TRUE(validator.validate("[[[[[[[[]]]]]]]]", getPermissiveSchema()));
+    EXPECT_FALSE(validator.validate("[[[[[[[[[]]]]]]]]]", getPermissiveSchema()));
+}
+
+TEST(StreamingSchemaValidatorTest, MaxErrors_StopsCollecting) {
+    StreamingValidator::Options options;
+    options.maxErrors = 2;
+    StreamingValidator validator(options);
+
+    auto schema = CompiledSchema::compile(SchemaSpec::array(SchemaSpec::string()));
+    EXPECT_FALSE(validator.validate("[1, 2, 3, 4, 5]", *schema));
+    EXPECT_EQ(validator.getErrors().size(), 2u);
+}
+
+TEST(StreamingSchemaValidatorTest, ValidatorIsReusable) {
+    StreamingValidator validator;
+    const auto& schema = getCompiledSchema(ModelSchema::PerformanceState_v1);
+
+    EXPECT_FALSE(validator.validate("{}", schema));
+    EXPECT_TRUE(validator.validate(kValidPerformance, schema));
+    EXPECT_TRUE(validator.getErrors().empty());
+}
@@ -82,6 +82,377 @@ namespace Schillinger
         }
     }
 
+    //==============================================================================
+    // RealtimeBeatTracker implementation
+    void RealtimeBeatTracker::prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+
+        // ~23 ms window and ~5.8 ms hop at any sample rate
+        const int fftOrder = 10 + (sampleRate > 64000.0 ? 1 : 0) + (sampleRate > 128000.0 ? 1 : 0);
+        fftSize = 1 << fftOrder;
+        hopSize = fftSize / 4;
+        fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+        // Flux peaks while a new onset crosses the rising edge of the window
+        frameLatency = 0.3 * fftSize;
+
+        window.resize(static_cast<size_t>(fftSize));
+        for (int i = 0; i < fftSize; ++i)
+            window[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * static_cast<float>(i) / static_cast<float>(fftSize));
+
+        inputRing.assign(static_cast<size_t>(fftSize), 0.0f);
+        fftData.assign(static_cast<size_t>(fftSize) * 2, 0.0f);
+        previousSpectrum.assign(static_cast<size_t>(fftSize) / 2 + 1, 0.0f);
+        onsetHistory.assign(historySize, 0.0f);
+
+        // Beat periods between maximumTempo and minimumTempo, in frames
+        const double hopRate = sampleRate / hopSize;
+        minLag = std::max(2, static_cast<int>(std::floor(60.0 * hopRate / maximumTempo)));
+        maxLag = static_cast<int>(std::ceil(60.0 * hopRate / minimumTempo));
+        jassert(numHarmonics * (maxLag + 1) < historySize);
+
+        autocorrelation.assign(static_cast<size_t>(numHarmonics * (maxLag + 1)), 0.0);
+        combScores.assign(static_cast<size_t>(maxLag + 2), 0.0);
+        autocorrelationDecay = std::exp(-1.0 / (3.0 * hopRate));    // ~3 s memory
+
+        reset();
+    }
+
+    void RealtimeBeatTracker::reset() noexcept
+    {
+        std::fill(inputRing.begin(), inputRing.end(), 0.0f);
+        std::fill(previousSpectrum.begin(), previousSpectrum.end(), 0.0f);
+        std::fill(onsetHistory.begin(), onsetHistory.end(), 0.0f);
+        std::fill(autocorrelation.begin(), autocorrelation.end(), 0.0);
+        std::fill(std::begin(fluxWindow), std::end(fluxWindow), 0.0f);
+
+        inputWritePos = 0;
+        samplesUntilHop = hopSize;
+        samplePosition = 0;
+        lastHopSample = 0.0;
+        onsetWritePos = 0;
+        framesAnalysed = 0;
+        fluxSum = 0.0f;
+        fluxWindowPos = 0;
+        onsetMean = 0.0;
+        onsetVariance = 0.0;
+        hopsUntilTempoUpdate = tempoUpdateInterval;
+        tempoPeriod = 0.0;
+        candidatePeriod = 0.0;
+        candidateVotes = 0;
+        tempoSalience = 0.0;
+        beatPeriod = 0.5 * sampleRate;
+        lastBeat = -1.0;
+        nextBeat = -1.0;
+        pendingBeat = -1.0;
+        lockStrength = 0.0;
+        beatOffsetInBlock = -1;
+    }
+
+    bool RealtimeBeatTracker::process(const float* samples, int numSamples) noexcept
+    {
+        beatOffsetInBlock = -1;
+
+        if (fft == nullptr || samples == nullptr)
+            return false;
+
+        const auto blockStart = samplePosition;
+        int done = 0;
+
+        while (done < numSamples)
+        {
+            const int chunk = std::min(numSamples - done, samplesUntilHop);
+
+            for (int i = 0; i < chunk; ++i)
+            {
+                inputRing[static_cast<size_t>(inputWritePos)] = samples[done + i];
+                inputWritePos = (inputWritePos + 1) & (fftSize - 1);
+            }
+
+            // Predicted beats in this chunk are reported at their exact sample
+            const auto chunkEnd = static_cast<double>(samplePosition + chunk);
+            while (nextBeat >= 0.0 && nextBeat < chunkEnd)
+            {
+                beatOffsetInBlock = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples - 1,
+                                                     static_cast<juce::int64>(nextBeat) - blockStart));
+                lastBeat = nextBeat;
+                pendingBeat = nextBeat;
+                nextBeat += beatPeriod;         // Provisional until correctPhase
+            }
+
+            samplePosition += chunk;
+            samplesUntilHop -= chunk;
+            done += chunk;
+
+            if (samplesUntilHop == 0)
+            {
+                samplesUntilHop = hopSize;
+                processHop();
+            }
+        }
+
+        return beatOffsetInBlock >= 0;
+    }
+
+    double RealtimeBeatTracker::getBeatPhase() const noexcept
+    {
+        if (lastBeat < 0.0 || nextBeat <= lastBeat)
+            return 0.0;
+
+        const double phase = (static_cast<double>(samplePosition) - lastBeat) / (nextBeat - lastBeat);
+        return juce::jlimit(0.0, 0.999999, phase);
+    }
+
+    void RealtimeBeatTracker::processHop() noexcept
+    {
+        lastHopSample = static_cast<double>(samplePosition);
+
+        // Windowed frame, oldest sample first
+        for (int i = 0; i < fftSize; ++i)
+            fftData[static_cast<size_t>(i)] = inputRing[static_cast<size_t>((inputWritePos + i) & (fftSize - 1))] * window[static_cast<size_t>(i)];
+
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+        fft->performFrequencyOnlyForwardTransform(fftData.data());
+
+        // Spectral flux of log-compressed magnitudes
+        const float magnitudeScale = 1000.0f / static_cast<float>(fftSize);
+        float flux = 0.0f;
+        for (int bin = 1; bin <= fftSize / 2; ++bin)
+        {
+            const float magnitude = std::log1p(magnitudeScale * fftData[static_cast<size_t>(bin)]);
+            const float rise = magnitude - previousSpectrum[static_cast<size_t>(bin)];
+            if (rise > 0.0f)
+                flux += rise;
+            previousSpectrum[static_cast<size_t>(bin)] = magnitude;
+        }
+
+        // Adaptive threshold: running mean of recent flux
+        fluxSum += flux - fluxWindow[fluxWindowPos];
+        fluxWindow[fluxWindowPos] = flux;
+        fluxWindowPos = (fluxWindowPos + 1) % fluxMeanLength;
+
+        const float onset = std::max(0.0f, flux - fluxSum / static_cast<float>(fluxMeanLength));
+        onsetHistory[static_cast<size_t>(onsetWritePos)] = onset;
+        onsetWritePos = (onsetWritePos + 1) & (historySize - 1);
+        ++framesAnalysed;
+
+        // Incremental statistics: onset mean/variance and the leaky autocorrelation
+        const double delta = onset - onsetMean;
+        onsetMean += 0.01 * delta;
+        onsetVariance = 0.99 * (onsetVariance + 0.01 * delta * delta);
+
+        const int numLags = static_cast<int>(autocorrelation.size());
+        for (int lag = 0; lag < numLags; ++lag)
+            autocorrelation[static_cast<size_t>(lag)] = autocorrelationDecay * autocorrelation[static_cast<size_t>(lag)]
+                                                        + static_cast<double>(onset) * getOnset(lag);
+
+        if (--hopsUntilTempoUpdate <= 0)
+        {
+            hopsUntilTempoUpdate = tempoUpdateInterval;
+            updateTempoEstimate();
+        }
+
+        // Once the search window after a reported beat is in, correct the grid
+        if (pendingBeat >= 0.0 && getFrameTime(0) >= pendingBeat + 0.25 * beatPeriod)
+            correctPhase();
+        else if (nextBeat < 0.0 && tempoPeriod > 0.0)
+        {
+            beatPeriod = tempoPeriod;
+            acquirePhase();
+        }
+    }
+
+    void RealtimeBeatTracker::updateTempoEstimate() noexcept
+    {
+        if (autocorrelation[0] <= 1.0e-9)
+            return;
+
+        // Comb filter bank: each candidate period collects the autocorrelation
+        // at its multiples, with wider teeth for the later ones
+        const double hopRate = sampleRate / hopSize;
+        const double preferredLag = 60.0 * hopRate / preferredTempo;
+        double best = 0.0, total = 0.0;
+        int bestLag = 0;
+
+        for (int lag = minLag; lag <= maxLag; ++lag)
+        {
+            double score = 0.0;
+            for (int k = 1; k <= numHarmonics; ++k)
+            {
+                double tooth = 0.0;
+                for (int j = 1 - k; j <= k - 1; ++j)
+                    tooth += autocorrelation[static_cast<size_t>(k * lag + j)];
+                score += tooth / (2 * k - 1);
+            }
+
+            // Mild preference around the preferred tempo against octave errors
+            const double octaves = std::log2(lag / preferredLag);
+            score *= std::exp(-0.5 * octaves * octaves);
+
+            combScores[static_cast<size_t>(lag)] = score;
+            total += score;
+            if (score > best)
+            {
+                best = score;
+                bestLag = lag;
+            }
+        }
+
+        if (bestLag == 0)
+            return;
+
+        // Salience of the winning period, discounted while the history fills
+        const double filled = std::min(1.0, static_cast<double>(framesAnalysed) / static_cast<double>(autocorrelation.size()));
+        tempoSalience = filled * juce::jlimit(0.0, 1.0, 1.0 - (total / (maxLag - minLag + 1)) / best);
+
+        // Parabolic refinement to a fractional lag
+        double lag = bestLag;
+        if (bestLag > minLag && bestLag < maxLag)
+        {
+            const double left = combScores[static_cast<size_t>(bestLag - 1)];
+            const double right = combScores[static_cast<size_t>(bestLag + 1)];
+            const double curvature = left - 2.0 * best + right;
+            if (curvature < 0.0)
+                lag += 0.5 * (left - right) / curvature;
+        }
+
+        const double period = lag * hopSize;
+
+        // Small moves are smoothed; a new tempo must win several updates in a row
+        if (tempoPeriod <= 0.0)
+        {
+            tempoPeriod = period;
+        }
+        else if (std::abs(period / tempoPeriod - 1.0) < 0.04)
+        {
+            tempoPeriod += 0.2 * (period - tempoPeriod);
+            candidateVotes = 0;
+        }
+        else if (candidateVotes > 0 && std::abs(period / candidatePeriod - 1.0) < 0.04)
+        {
+            if (++candidateVotes >= 4)
+            {
+                tempoPeriod = period;
+                candidateVotes = 0;
+            }
+        }
+        else
+        {
+            candidatePeriod = period;
+            candidateVotes = 1;
+        }
+    }
+
+    void RealtimeBeatTracker::correctPhase() noexcept
+    {
+        // Strongest onset within a quarter beat of the reported beat
+        const double radius = 0.25 * beatPeriod;
+        float peak = 0.0f;
+        int peakAgo = -1;
+
+        for (int ago = 0; ago < historySize - 1; ++ago)
+        {
+            const double time = getFrameTime(ago);
+            if (time < pendingBeat - radius)
+                break;
+
+            if (time <= pendingBeat + radius && getOnset(ago) > peak)
+            {
+                peak = getOnset(ago);
+                peakAgo = ago;
+            }
+        }
+
+        const double threshold = onsetMean + std::sqrt(onsetVariance);
+        double error = 0.0;
+
+        if (peakAgo >= 0 && peak > threshold)
+        {
+            // Parabolic refinement of the peak between frames (older frames sit earlier)
+            double offset = 0.0;
+            if (peakAgo > 0 && peakAgo < historySize - 2)
+            {
+                const double later = getOnset(peakAgo - 1);
+                const double earlier = getOnset(peakAgo + 1);
+                const double curvature = earlier - 2.0 * peak + later;
+                if (curvature < 0.0)
+                    offset = 0.5 * (earlier - later) / curvature;
+            }
+
+            error = getFrameTime(peakAgo) + offset * hopSize - pendingBeat;
+            lockStrength += 0.2 * (1.0 - lockStrength);
+        }
+        else
+        {
+            lockStrength *= 0.8;
+        }
+
+        // Second-order loop: phase and period both follow the error; the
+        // period is also pulled toward the tempo estimate
+        if (tempoPeriod > 0.0 && std::abs(tempoPeriod / beatPeriod - 1.0) > 0.15)
+        {
+            beatPeriod = tempoPeriod;
+            pendingBeat = -1.0;
+            acquirePhase();
+            return;
+        }
+
+        beatPeriod += 0.1 * error;
+        if (tempoPeriod > 0.0)
+            beatPeriod += 0.1 * (tempoPeriod - beatPeriod);
+
+        const double minPeriod = 60.0 * sampleRate / maximumTempo;
+        const double maxPeriod = 60.0 * sampleRate / minimumTempo;
+        beatPeriod = juce::jlimit(minPeriod, maxPeriod, beatPeriod);
+
+        nextBeat = pendingBeat + beatPeriod + 0.5 * error;
+        pendingBeat = -1.0;
+
+        // Lost the pulse: search for the phase again
+        if (lockStrength < 0.1 && framesAnalysed > 4 * maxLag)
+            acquirePhase();
+    }
+
+    void RealtimeBeatTracker::acquirePhase() noexcept
+    {
+        // Beat phase whose grid collects the most onset energy over the last few beats
+        const double periodFrames = beatPeriod / hopSize;
+        const int beats = static_cast<int>(std::min<juce::int64>(4, framesAnalysed / static_cast<juce::int64>(std::ceil(periodFrames))));
+        if (beats < 2)
+            return;
+
+        double bestScore = 0.0;
+        int bestAgo = -1;
+        for (int ago = 0; ago < static_cast<int>(periodFrames); ++ago)
+        {
+            double score = 0.0;
+            for (int k = 0; k < beats; ++k)
+            {
+                const int frame = ago + static_cast<int>(std::lround(k * periodFrames));
+                if (frame < historySize)
+                    score += getOnset(frame);
+            }
+
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestAgo = ago;
+            }
+        }
+
+        if (bestAgo < 0)
+            return;
+
+        // Project the grid past the present
+        double beat = getFrameTime(bestAgo);
+        while (beat < static_cast<double>(samplePosition))
+            beat += beatPeriod;
+
+        nextBeat = beat;
+        lockStrength = std::max(lockStrength, 0.5);
+    }
+
     //==============================================================================
     // RealtimeAudioAnalyzer implementation
     RealtimeAudioAnalyzer::RealtimeAudioAnalyzer()
@@ -105,9 +476,9 @@ namespace Schillinger
         
         processingChain.prepare(spec);
         
-        // Initialize onset buffer
-        onsetBuffer.clearQuick();
-        onsetBuffer.resize(static_cast<int>(spec.maximumBlockSize));
+        // Beat tracker and its channel mix buffer
+        beatTracker.prepare(sampleRate);
+        monoBuffer.allocate(static_cast<size_t>(juce::jmax(1, blockSize)), true);
         
         reset();
     }
@@ -120,74 +491,68 @@ namespace Schillinger
         // Update RMS
         updateRMS(audioBlock);
         
-        // Detect onsets for tempo estimation
-        detectOnsets(audioBlock);
+        // Track tempo and beats in sample time
+        trackBeats(audioBlock);
     }
 
     void RealtimeAudioAnalyzer::reset() noexcept
     {
         processingChain.reset();
+        beatTracker.reset();
         currentTempo.store(120.0);
         currentBeatPhase.store(0.0);
         beatDetected.store(false);
         currentRMS.store(0.0f);
-        lastBeatTime = 0.0;
+        tempoConfidence.store(0.0);
+        nextBeatSample.store(-1);
+        beatOffset.store(-1);
         rmsBufferIndex = 0;
+        rmsSum = 0.0;
         std::fill(std::begin(rmsBuffer), std::end(rmsBuffer), 0.0f);
     }
 
-    void RealtimeAudioAnalyzer::updateTempo(double newTempo) noexcept
+    void RealtimeAudioAnalyzer::trackBeats(const juce::dsp::AudioBlock<const float>& audioBlock) noexcept
     {
-        // Simple tempo smoothing
-        double smoothedTempo = currentTempo.load() * 0.9 + newTempo * 0.1;
-        currentTempo.store(juce::jlimit(60.0, 200.0, smoothedTempo));
-        beatInterval = 60.0 / currentTempo.load();
-    }
-
-    void RealtimeAudioAnalyzer::detectOnsets(const juce::dsp::AudioBlock<const float>& audioBlock) noexcept
-    {
-        // Simple onset detection using energy differences
-        float blockEnergy = 0.0f;
+        const int numChannels = static_cast<int>(audioBlock.getNumChannels());
+        const int numSamples = static_cast<int>(audioBlock.getNumSamples());
+        if (numChannels == 0 || monoBuffer.get() == nullptr)
+            return;
         
-        for (size_t channel = 0; channel < audioBlock.getNumChannels(); ++channel)
+        const float channelScale = 1.0f / static_cast<float>(numChannels);
+        bool beat = false;
+        int offset = -1;
+        
+        // Blocks larger than prepared are tracked in prepared-size pieces
+        for (int start = 0; start < numSamples; start += blockSize)
         {
-            auto* channelData = audioBlock.getChannelPointer(channel);
-            for (size_t sample = 0; sample < audioBlock.getNumSamples(); ++sample)
+            const int count = juce::jmin(blockSize, numSamples - start);
+            
+            for (int i = 0; i < count; ++i)
+                monoBuffer[i] = audioBlock.getChannelPointer(0)[start + i];
+            
+            for (int channel = 1; channel < numChannels; ++channel)
             {
-                blockEnergy += channelData[sample] * channelData[sample];
+                auto* channelData = audioBlock.getChannelPointer(static_cast<size_t>(channel));
+                for (int i = 0; i < count; ++i)
+                    monoBuffer[i] += channelData[start + i];
             }
-        }
-        
-        blockEnergy /= static_cast<float>(audioBlock.getNumChannels() * audioBlock.getNumSamples());
-        
-        // Simple beat detection threshold
-        const float threshold = currentRMS.load() * 1.5f;
-        
-        if (blockEnergy > threshold)
-        {
-            double currentTime = juce::Time::getMillisecondCounterHiRes() / 1000.0;
             
-            if (currentTime - lastBeatTime > 0.2) // Minimum 200ms between beats
+            for (int i = 0; i < count; ++i)
+                monoBuffer[i] *= channelScale;
+            
+            if (beatTracker.process(monoBuffer, count))
             {
-                double interval = currentTime - lastBeatTime;
-                if (lastBeatTime > 0.0 && interval > 0.3 && interval < 2.0) // Valid tempo range
-                {
-                    double detectedTempo = 60.0 / interval;
-                    updateTempo(detectedTempo);
-                }
-                
-                lastBeatTime = currentTime;
-                beatDetected.store(true);
-                
-                // Update beat phase
-                double phase = std::fmod(currentTime, beatInterval) / beatInterval;
-                currentBeatPhase.store(phase);
+                beat = true;
+                offset = start + beatTracker.getBeatOffsetInBlock();
             }
         }
-        else
-        {
-            beatDetected.store(false);
-        }
+        
+        currentTempo.store(beatTracker.getTempo());
+        currentBeatPhase.store(beatTracker.getBeatPhase());
+        tempoConfidence.store(beatTracker.getConfidence());
+        nextBeatSample.store(beatTracker.getNextBeatSample());
+        beatOffset.store(offset);
+        beatDetected.store(beat);
     }
 
     void RealtimeAudioAnalyzer::updateRMS(const juce::dsp::AudioBlock<const float>& audioBlock) noexcept
@@ -205,17 +570,12 @@ namespace Schillinger
         
         blockRMS = std::sqrt(blockRMS / (audioBlock.getNumChannels() * audioBlock.getNumSamples()));
         
-        // Update circular buffer
+        // Update circular buffer and the running sum in step
+        rmsSum += static_cast<double>(blockRMS) - rmsBuffer[rmsBufferIndex];
         rmsBuffer[rmsBufferIndex] = blockRMS;
         rmsBufferIndex = (rmsBufferIndex + 1) % 1024;
         
-        // Calculate running average
-        float avgRMS = 0.0f;
-        for (int i = 0; i < 1024; ++i)
-            avgRMS += rmsBuffer[i];
-        avgRMS /= 1024.0f;
-        
-        currentRMS.store(avgRMS);
+        currentRMS.store(static_cast<float>(juce::jmax(0.0, rmsSum / 1024.0)));
     }
 
     //==============================================================================
@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+
+    BeatTrackerTests.cpp
+    Created: 18 Oct 2026
+    Author:  White Room Project
+
+    Unit tests for RealtimeBeatTracker on synthetic click tracks:
+    - Tempo at several BPMs and sample rates
+    - Beat placement, beat phase and confidence
+    - Silence, tempo changes, reset and block size independence
+
+  ==============================================================================
+*/
+
+#include "RealtimeAudioAPI.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Schillinger::Realtime::Tests
+{
+
+    //==============================================================================
+    // Test Utilities
+    //==============================================================================
+
+    /** Simple test result tracker */
+    class TestRunner
+    {
+    public:
+        int passed = 0;
+        int failed = 0;
+
+        void assertTrue(bool condition, const std::string& testName)
+        {
+            if (condition)
+            {
+                passed++;
+                std::cout << "[PASS] " << testName << std::endl;
+            }
+            else
+            {
+                failed++;
+                std::cout << "[FAIL] " << testName << std::endl;
+            }
+        }
+
+        void printSummary() const
+        {
+            std::cout << "\n=== Test Summary ===" << std::endl;
+            std::cout << "Passed: " << passed << std::endl;
+            std::cout << "Failed: " << failed << std::endl;
+            std::cout << "Total:  " << (passed + failed) << std::endl;
+            std::cout << "===================" << std::endl;
+        }
+
+        bool allPassed() const noexcept { return failed == 0; }
+    };
+
+    /** Click track: a short decaying noise burst on every beat */
+    struct ClickTrack
+    {
+        std::vector<float> samples;
+        std::vector<double> clicks;     // Onset of each click, in samples
+    };
+
+    ClickTrack makeClickTrack(double sampleRate, double seconds, double startBpm, double endBpm = 0.0)
+    {
+        if (endBpm <= 0.0)
+            endBpm = startBpm;
+
+        ClickTrack track;
+        track.samples.assign(static_cast<size_t>(seconds * sampleRate), 0.0f);
+
+        // Tempo ramps linearly between the two BPMs over the track
+        double time = 0.25 * sampleRate;
+        while (time < static_cast<double>(track.samples.size()))
+        {
+            track.clicks.push_back(time);
+            const double bpm = startBpm + (endBpm - startBpm) * time / static_cast<double>(track.samples.size());
+            time += 60.0 * sampleRate / bpm;
+        }
+
+        std::uint32_t noise = 12345;
+        const int clickLength = static_cast<int>(0.01 * sampleRate);
+        for (const double click : track.clicks)
+        {
+            const auto start = static_cast<size_t>(click);
+            for (int i = 0; i < clickLength && start + static_cast<size_t>(i) < track.samples.size(); ++i)
+            {
+                noise = noise * 1664525u + 1013904223u;
+                const float white = static_cast<float>(noise >> 8) / 8388608.0f - 1.0f;
+                track.samples[start + static_cast<size_t>(i)] += 0.8f * white * std::exp(-5.0f * i / clickLength);
+            }
+        }
+
+        return track;
+    }
+
+    /** Beats reported while feeding the track block by block */
+    std::vector<juce::int64> runTracker(RealtimeBeatTracker& tracker, const std::vector<float>& samples, int blockSize,
+                                        bool& offsetsMatch)
+    {
+        std::vector<juce::int64> beats;
+        offsetsMatch = true;
+
+        for (size_t start = 0; start < samples.size(); start += static_cast<size_t>(blockSize))
+        {
+            const int n = static_cast<int>(std::min(static_cast<size_t>(blockSize), samples.size() - start));
+            if (tracker.process(samples.data() + start, n))
+            {
+                beats.push_back(tracker.getLastBeatSample());
+                offsetsMatch = offsetsMatch
+                    && tracker.getBeatOffsetInBlock() == static_cast<int>(tracker.getLastBeatSample() - static_cast<juce::int64>(start));
+            }
+        }
+
+        return beats;
+    }
+
+    /** Mean distance in ms from the beats after fromSample to the nearest click */
+    double meanBeatError(const std::vector<juce::int64>& beats, const ClickTrack& track, double sampleRate, double fromSample)
+    {
+        double sum = 0.0;
+        int count = 0;
+
+        for (const auto beat : beats)
+        {
+            if (static_cast<double>(beat) < fromSample)
+                continue;
+
+            double nearest = 1.0e12;
+            for (const double click : track.clicks)
+                nearest = std::min(nearest, std::abs(static_cast<double>(beat) - click));
+
+            sum += nearest;
+            ++count;
+        }
+
+        return count > 0 ? 1000.0 * sum / count / sampleRate : 1.0e9;
+    }
+
+    //==============================================================================
+    // Tempo
+    //==============================================================================
+
+    void testTempo_ClickTracks(TestRunner& runner)
+    {
+        const double sampleRate = 44100.0;
+
+        for (const double bpm : { 90.0, 120.0, 140.0 })
+        {
+            RealtimeBeatTracker tracker;
+            tracker.prepare(sampleRate);
+
+            const auto track = makeClickTrack(sampleRate, 12.0, bpm);
+            bool offsetsMatch = false;
+            runTracker(tracker, track.samples, 512, offsetsMatch);
+
+            const auto name = "BeatTracker: " + std::to_string(static_cast<int>(bpm)) + " BPM click track";
+            std::cout << name << " -> " << tracker.getTempo() << " BPM, confidence " << tracker.getConfidence() << std::endl;
+            runner.assertTrue(std::abs(tracker.getTempo() - bpm) < 1.0, name + " tempo within 1 BPM");
+        }
+    }
+
+    void testTempo_SampleRates(TestRunner& runner)
+    {
+        for (const double sampleRate : { 48000.0, 96000.0 })
+        {
+            RealtimeBeatTracker tracker;
+            tracker.prepare(sampleRate);
+
+            const auto track = makeClickTrack(sampleRate, 10.0, 128.0);
+            bool offsetsMatch = false;
+            const auto beats = runTracker(tracker, track.samples, 480, offsetsMatch);
+
+            const auto name = "BeatTracker: " + std::to_string(static_cast<int>(sampleRate)) + " Hz";
+            runner.assertTrue(std::abs(tracker.getTempo() - 128.0) < 1.0, name + " tempo within 1 BPM");
+            runner.assertTrue(meanBeatError(beats, track, sampleRate, 6.0 * sampleRate) < 15.0, name + " beats land on the clicks");
+        }
+    }
+
+    void testTempo_Change(TestRunner& runner)
+    {
+        const double sampleRate = 44100.0;
+        RealtimeBeatTracker tracker;
+        tracker.prepare(sampleRate);
+
+        // 100 BPM for 10 s, then 112 BPM: the tracker follows within a few seconds
+        auto first = makeClickTrack(sampleRate, 10.0, 100.0);
+        auto second = makeClickTrack(sampleRate, 10.0, 112.0);
+
+        bool offsetsMatch = false;
+        runTracker(tracker, first.samples, 512, offsetsMatch);
+        runner.assertTrue(std::abs(tracker.getTempo() - 100.0) < 1.0, "BeatTracker: Holds 100 BPM");
+
+        runTracker(tracker, second.samples, 512, offsetsMatch);
+        std::cout << "BeatTracker: after the change -> " << tracker.getTempo() << " BPM" << std::endl;
+        runner.assertTrue(std::abs(tracker.getTempo() - 112.0) < 1.0, "BeatTracker: Follows a change to 112 BPM");
+    }
+
+    //==============================================================================
+    // Beats, Phase and Confidence
+    //==============================================================================
+
+    void testBeats_Placement(TestRunner& runner)
+    {
+        const double sampleRate = 44100.0;
+        RealtimeBeatTracker tracker;
+        tracker.prepare(sampleRate);
+
+        const auto track = makeClickTrack(sampleRate, 12.0, 120.0);
+        bool offsetsMatch = false;
+        const auto beats = runTracker(tracker, track.samples, 512, offsetsMatch);
+
+        const double error = meanBeatError(beats, track, sampleRate, 6.0 * sampleRate);
+        std::cout << "BeatTracker: " << beats.size() << " beats, mean error " << error << " ms" << std::endl;
+
+        runner.assertTrue(beats.size() >= 16, "BeatTracker: Reports beats once locked");
+        runner.assertTrue(error < 10.0, "BeatTracker: Beats land within 10 ms of the clicks");
+        runner.assertTrue(offsetsMatch, "BeatTracker: Beat offset in block is the beat's sample");
+
+        // Once locked, consecutive beats are one period apart
+        bool steady = true;
+        for (size_t i = 1; i < beats.size(); ++i)
+        {
+            if (static_cast<double>(beats[i - 1]) >= 6.0 * sampleRate)
+                steady = steady && std::abs(static_cast<double>(beats[i] - beats[i - 1]) - 0.5 * sampleRate) < 0.01 * sampleRate;
+        }
+        runner.assertTrue(steady, "BeatTracker: Beats are evenly spaced");
+
+        runner.assertTrue(tracker.getNextBeatSample() > tracker.getSamplePosition()
+                              && tracker.getNextBeatSample() - tracker.getLastBeatSample() > static_cast<juce::int64>(0.45 * sampleRate),
+                          "BeatTracker: Next beat is predicted one period ahead");
+    }
+
+    void testBeats_PhaseAndConfidence(TestRunner& runner)
+    {
+        const double sampleRate = 44100.0;
+        RealtimeBeatTracker tracker;
+        tracker.prepare(sampleRate);
+
+        const auto track = makeClickTrack(sampleRate, 12.0, 120.0);
+        bool offsetsMatch = false;
+
+        // Phase after each block against the position between clicks
+        const int blockSize = 256;
+        double worstPhaseError = 0.0;
+        bool phaseInRange = true;
+        for (size_t start = 0; start < track.samples.size(); start += blockSize)
+        {
+            const int n = static_cast<int>(std::min(static_cast<size_t>(blockSize), track.samples.size() - start));
+            tracker.process(track.samples.data() + start, n);
+
+            const double phase = tracker.getBeatPhase();
+            phaseInRange = phaseInRange && phase >= 0.0 && phase < 1.0;
+
+            const double position = static_cast<double>(start + static_cast<size_t>(n));
+            if (position < 8.0 * sampleRate)
+                continue;
+
+            const auto next = std::upper_bound(track.clicks.begin(), track.clicks.end(), position);
+            if (next == track.clicks.begin() || next == track.clicks.end())
+                continue;
+
+            const double expected = (position - *(next - 1)) / (*next - *(next - 1));
+            double difference = std::abs(phase - expected);
+            difference = std::min(difference, 1.0 - difference);    // Phase wraps
+            worstPhaseError = std::max(worstPhaseError, difference);
+        }
+
+        std::cout << "BeatTracker: worst phase error " << worstPhaseError << ", confidence " << tracker.getConfidence() << std::endl;
+        runner.assertTrue(phaseInRange, "BeatTracker: Phase stays in [0, 1)");
+        runner.assertTrue(worstPhaseError < 0.05, "BeatTracker: Phase follows the position between clicks");
+        runner.assertTrue(tracker.getConfidence() > 0.5, "BeatTracker: Confident on a steady click track");
+
+        // The same amount of silence: no beats, no confidence
+        RealtimeBeatTracker silent;
+        silent.prepare(sampleRate);
+        const std::vector<float> silence(track.samples.size(), 0.0f);
+        const auto beats = runTracker(silent, silence, 512, offsetsMatch);
+
+        runner.assertTrue(beats.empty() && silent.getNextBeatSample() < 0, "BeatTracker: Silence has no beats");
+        runner.assertTrue(silent.getConfidence() < 0.1, "BeatTracker: Silence has no confidence");
+        runner.assertTrue(std::abs(silent.getTempo() - 120.0) < 1.0e-9, "BeatTracker: Tempo defaults to 120 BPM");
+    }
+
+    //==============================================================================
+    // State
+    //==============================================================================
+
+    void testState_BlockSizeAndReset(TestRunner& runner)
+    {
+        const double sampleRate = 44100.0;
+        const auto track = makeClickTrack(sampleRate, 8.0, 132.0);
+
+        RealtimeBeatTracker small, large;
+        small.prepare(sampleRate);
+        large.prepare(sampleRate);
+
+        bool offsetsMatch = false;
+        const auto smallBeats = runTracker(small, track.samples, 64, offsetsMatch);
+        const auto largeBeats = runTracker(large, track.samples, 4096, offsetsMatch);
+
+        runner.assertTrue(smallBeats == largeBeats && small.getTempo() == large.getTempo()
+                              && small.getNextBeatSample() == large.getNextBeatSample(),
+                          "BeatTracker: Results do not depend on the block size");
+
+        large.reset();
+        runner.assertTrue(large.getSamplePosition() == 0 && large.getLastBeatSample() < 0 && large.getNextBeatSample() < 0
+                              && large.getConfidence() == 0.0 && large.getBeatPhase() == 0.0,
+                          "BeatTracker: Reset forgets tempo, grid and position");
+
+        // After a reset the same input gives the same beats
+        const auto again = runTracker(large, track.samples, 4096, offsetsMatch);
+        runner.assertTrue(again == largeBeats, "BeatTracker: Tracking after reset repeats exactly");
+    }
+
+    //==============================================================================
+    // Main Test Runner
+    //==============================================================================
+
+    int runAllTests()
+    {
+        std::cout << "\n=== Realtime Beat Tracker Unit Tests ===" << std::endl;
+        std::cout << "Testing tempo, beat phase and confidence on click tracks\n" << std::endl;
+
+        TestRunner runner;
+
+        std::cout << "\n--- Tempo Tests ---" << std::endl;
+        testTempo_ClickTracks(runner);
+        testTempo_SampleRates(runner);
+        testTempo_Change(runner);
+
+        std::cout << "\n--- Beat Tests ---" << std::endl;
+        testBeats_Placement(runner);
+        testBeats_PhaseAndConfidence(runner);
+
+        std::cout << "\n--- State Tests ---" << std::endl;
+        testState_BlockSizeAndReset(runner);
+
+        runner.printSummary();
+
+        return runner.allPassed() ? 0 : 1;
+    }
+
+} // namespace Schillinger::Realtime::Tests
+
+//==============================================================================
+// Main Entry Point
+//==============================================================================
+
+int main()
+{
+    return Schillinger::Realtime::Tests::runAllTests();
+}
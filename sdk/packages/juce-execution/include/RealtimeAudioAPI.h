@@ -16,6 +16,8 @@
 #include <memory>
 #include <functional>
 #include <atomic>
+#include <cmath>
+#include <vector>
 
 namespace Schillinger
 {
@@ -107,6 +109,122 @@ namespace Schillinger
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeMidiProcessor)
     };
 
+    //==============================================================================
+    /**
+        Beat tracker for live input, running in sample time.
+
+        Each hop adds one value to a spectral-flux onset envelope. Tempo comes
+        from a leaky autocorrelation of that envelope, updated incrementally
+        every hop and scored through a comb filter bank. A phase-locked loop
+        keeps a predicted beat grid on the onsets, so beats are reported at
+        exact sample positions as they happen rather than after they are
+        detected. Buffers are allocated in prepare(); process() is real-time
+        safe.
+    */
+    class RealtimeBeatTracker
+    {
+    public:
+        static constexpr double minimumTempo = 60.0;
+        static constexpr double maximumTempo = 200.0;
+
+        RealtimeBeatTracker() = default;
+        ~RealtimeBeatTracker() = default;
+
+        /** Allocate the analysis buffers for a sample rate */
+        void prepare(double newSampleRate);
+
+        /** Forget tempo, beat grid and onset history */
+        void reset() noexcept;
+
+        /**
+            Centre of the tempo preference used to pick between metrical
+            levels (72 vs 144 BPM, for example); 120 by default
+        */
+        void setPreferredTempo(double bpm) noexcept { preferredTempo = juce::jlimit(minimumTempo, maximumTempo, bpm); }
+
+        /** Feed mono input; returns true if a beat falls inside this block */
+        bool process(const float* samples, int numSamples) noexcept;
+
+        /** Tempo in BPM (120 until a pulse has been found) */
+        double getTempo() const noexcept { return 60.0 * sampleRate / beatPeriod; }
+
+        /** Position within the current beat (0.0 to 1.0) at the end of the last block */
+        double getBeatPhase() const noexcept;
+
+        /** 0.0 (no pulse) to 1.0 (clear tempo, predicted beats landing on onsets) */
+        double getConfidence() const noexcept { return tempoSalience * lockStrength; }
+
+        /** Samples consumed since reset */
+        juce::int64 getSamplePosition() const noexcept { return samplePosition; }
+
+        /** Last reported and next predicted beat, in samples since reset (-1 before lock) */
+        juce::int64 getLastBeatSample() const noexcept { return static_cast<juce::int64>(std::floor(lastBeat)); }
+        juce::int64 getNextBeatSample() const noexcept { return static_cast<juce::int64>(std::floor(nextBeat)); }
+
+        /** Offset of the beat inside the last block, or -1 */
+        int getBeatOffsetInBlock() const noexcept { return beatOffsetInBlock; }
+
+    private:
+        static constexpr int historySize = 1024;        // Onset envelope frames, ~5.5 s
+        static constexpr int numHarmonics = 4;          // Comb filter teeth
+        static constexpr int fluxMeanLength = 16;       // Frames in the adaptive threshold
+        static constexpr int tempoUpdateInterval = 8;   // Hops between tempo estimates
+
+        void processHop() noexcept;
+        void updateTempoEstimate() noexcept;
+        void correctPhase() noexcept;
+        void acquirePhase() noexcept;
+
+        float getOnset(int framesAgo) const noexcept { return onsetHistory[static_cast<size_t>((onsetWritePos - 1 - framesAgo) & (historySize - 1))]; }
+        double getFrameTime(int framesAgo) const noexcept { return lastHopSample - frameLatency - static_cast<double>(framesAgo) * hopSize; }
+
+        double sampleRate = 44100.0;
+        int fftSize = 1024;
+        int hopSize = 256;
+        double frameLatency = 0.0;                      // Onset position relative to the frame end
+
+        // Spectral flux
+        std::unique_ptr<juce::dsp::FFT> fft;
+        std::vector<float> window, inputRing, fftData, previousSpectrum;
+        int inputWritePos = 0;
+        int samplesUntilHop = 0;
+        juce::int64 samplePosition = 0;
+        double lastHopSample = 0.0;
+
+        // Onset envelope and its running statistics
+        std::vector<float> onsetHistory;
+        int onsetWritePos = 0;
+        juce::int64 framesAnalysed = 0;
+        float fluxWindow[fluxMeanLength] = {};
+        float fluxSum = 0.0f;
+        int fluxWindowPos = 0;
+        double onsetMean = 0.0;
+        double onsetVariance = 0.0;
+
+        // Tempo: leaky autocorrelation of the onset envelope, in frames
+        std::vector<double> autocorrelation;
+        std::vector<double> combScores;
+        double autocorrelationDecay = 0.999;
+        int minLag = 1;
+        int maxLag = 2;
+        int hopsUntilTempoUpdate = tempoUpdateInterval;
+        double preferredTempo = 120.0;
+        double tempoPeriod = 0.0;                       // Samples, 0 until estimated
+        double candidatePeriod = 0.0;
+        int candidateVotes = 0;
+        double tempoSalience = 0.0;
+
+        // Beat grid (sample time)
+        double beatPeriod = 22050.0;
+        double lastBeat = -1.0;
+        double nextBeat = -1.0;
+        double pendingBeat = -1.0;                      // Reported, awaiting phase correction
+        double lockStrength = 0.0;
+        int beatOffsetInBlock = -1;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeBeatTracker)
+    };
+
     //==============================================================================
     /** Audio analysis tools using JUCE DSP for real-time processing */
     class RealtimeAudioAnalyzer
@@ -133,6 +251,15 @@ namespace Schillinger
         /** Get the current RMS level */
         float getCurrentRMS() const noexcept { return currentRMS.load(); }
         
+        /** How sure the beat tracker is of tempo and phase (0.0 to 1.0) */
+        double getTempoConfidence() const noexcept { return tempoConfidence.load(); }
+        
+        /** Next predicted beat, in samples since reset (-1 before lock) */
+        juce::int64 getNextBeatSample() const noexcept { return nextBeatSample.load(); }
+        
+        /** Offset of the detected beat inside the last analysed block, or -1 */
+        int getBeatOffsetInLastBlock() const noexcept { return beatOffset.load(); }
+        
         /** Reset the analyzer state */
         void reset() noexcept;
         
@@ -146,22 +273,24 @@ namespace Schillinger
         std::atomic<double> currentBeatPhase{0.0};
         std::atomic<bool> beatDetected{false};
         std::atomic<float> currentRMS{0.0f};
+        std::atomic<double> tempoConfidence{0.0};
+        std::atomic<juce::int64> nextBeatSample{-1};
+        std::atomic<int> beatOffset{-1};
         
         // Internal processing variables
         double sampleRate = 44100.0;
         int blockSize = 512;
         
-        // Beat detection
-        juce::Array<float> onsetBuffer;
-        double lastBeatTime = 0.0;
-        double beatInterval = 0.5; // 120 BPM default
+        // Beat tracking on the channel mix
+        RealtimeBeatTracker beatTracker;
+        juce::HeapBlock<float> monoBuffer;
         
-        // RMS calculation
+        // RMS calculation (running sum over the last 1024 blocks)
         float rmsBuffer[1024];
         int rmsBufferIndex = 0;
+        double rmsSum = 0.0;
         
-        void updateTempo(double newTempo) noexcept;
-        void detectOnsets(const juce::dsp::AudioBlock<const float>& audioBlock) noexcept;
+        void trackBeats(const juce::dsp::AudioBlock<const float>& audioBlock) noexcept;
         void updateRMS(const juce::dsp::AudioBlock<const float>& audioBlock) noexcept;
         
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeAudioAnalyzer)